@@ -0,0 +1,667 @@
+// Platform independent animation scheduler
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwcore_config.h"
+
+#include "xwanimationscheduler.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// maximum number of commands not yet processed by scheduler
+#define XWUI_ANIMATION_SCHEDULER_COMMAND_QUEUE  1024
+
+/////////////////////////////////////////////////////////////////////
+// XWAnimationScheduler - animation scheduler
+
+// NOTE: value is written by scheduler and read by producer thread
+struct XWAnimationScheduler::ValueSlot
+{
+    std::atomic<float>  value;
+
+    // constructors
+    ValueSlot(float initValue) : value(initValue) {}
+};
+
+/////////////////////////////////////////////////////////////////////
+// construction/destruction
+/////////////////////////////////////////////////////////////////////
+XWAnimationScheduler::XWAnimationScheduler(IXWAnimationClock* clock, IXWAnimationSink* sink) :
+    m_commandsSent(0),
+    m_commandQueueFull(0),
+    m_wakeLockWaits(0),
+    m_threadRunning(false),
+    m_nextScheduleSeq(1),
+    m_pClock(clock),
+    m_pSink(sink),
+    m_commands(XWUI_ANIMATION_SCHEDULER_COMMAND_QUEUE),
+    m_threadSleeping(false),
+    m_wakePending(false),
+    m_exitPending(false)
+{
+    XWASSERT(m_pClock);
+    XWASSERT(m_pSink);
+
+    // reset statistics
+    memset(&m_stats, 0, sizeof(XSchedulerStats));
+}
+
+XWAnimationScheduler::~XWAnimationScheduler()
+{
+    // stop thread if any
+    stopThread();
+
+    _Command command;
+
+    // delete data of commands not processed yet
+    while(m_commands.pop(command))
+    {
+        delete command.data;
+        delete command.valueSlot;
+    }
+
+    // NOTE: value slots of running animations are owned by producer
+    m_animationData.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// scheduler thread
+/////////////////////////////////////////////////////////////////////
+bool XWAnimationScheduler::startThread()
+{
+    // ignore if already started
+    if(m_threadRunning) return true;
+
+    // reset flags
+    m_threadSleeping = false;
+    m_wakePending = false;
+    m_exitPending = false;
+
+    // start thread
+    try
+    {
+        m_thread = std::thread(&XWAnimationScheduler::_threadProc, this);
+    }
+    catch(const std::system_error&)
+    {
+        XWTRACE("XWAnimationScheduler: failed to start scheduler thread");
+        return false;
+    }
+
+    m_threadRunning = true;
+
+    return true;
+}
+
+void XWAnimationScheduler::stopThread()
+{
+    // ignore if not started
+    if(!m_threadRunning) return;
+
+    // ask thread to exit
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_exitPending = true;
+    }
+
+    m_wakeCondition.notify_one();
+
+    // wait for thread to stop
+    m_thread.join();
+
+    m_threadRunning = false;
+}
+
+/////////////////////////////////////////////////////////////////////
+// processing
+/////////////////////////////////////////////////////////////////////
+long long XWAnimationScheduler::processDue()
+{
+    // process commands first so that their time is not mixed with events
+    _processCommands();
+
+    // current time
+    long long timeNow = m_pClock->timeMs();
+
+    // NOTE: list keeps allocated memory between frames
+    m_expiredItems.clear();
+
+    // collect expired items only (earliest deadline is always on top)
+    while(!m_deadlines.empty() && m_deadlines.top().deadline <= timeNow)
+    {
+        _AnimationDeadline entry = m_deadlines.top();
+        m_deadlines.pop();
+
+        // ignore stopped, paused or rescheduled items
+        _AnimationData* item = _findScheduledItem(entry);
+        if(item == 0) continue;
+
+        _ExpiredItem expiredItem;
+
+        // fill entry
+        expiredItem.id = entry.id;
+        expiredItem.item = item;
+        expiredItem.deadline = entry.deadline;
+
+        // add to list
+        m_expiredItems.push_back(expiredItem);
+    }
+
+    // compute values of all expired items at once
+    _evaluateValues(timeNow);
+
+    // NOTE: statistics are collected locally so that stats lock is not held while sink works
+    unsigned long missedTicks = 0;
+    long long maxLateness = 0;
+    long long totalLateness = 0;
+
+    // start delivery
+    if(m_expiredItems.size()) m_pSink->beginDelivery();
+
+    // fire expired items
+    for(size_t idx = 0; idx < m_expiredItems.size(); ++idx)
+    {
+        const _ExpiredItem& expired = m_expiredItems[idx];
+        _AnimationData* item = expired.item;
+
+        // lateness
+        long long lateness = timeNow - expired.deadline;
+        totalLateness += lateness;
+        if(lateness > maxLateness) maxLateness = lateness;
+
+        AnimationEvent animationEvent;
+
+        // fill event
+        animationEvent.id = expired.id;
+        animationEvent.type = item->isValue ? eAnimationValueEvent : eAnimationTimerEvent;
+
+        // update value
+        if(item->isValue)
+        {
+            _updateValue(*item);
+
+            // publish value to producer thread
+            item->valueSlot->value.store(item->value, std::memory_order_release);
+        }
+
+        animationEvent.value = item->value;
+
+        // fire item event
+        m_pSink->deliverEvent(animationEvent, item->target, item->sinkData);
+
+        // remove item if single instance or last event sent
+        if(item->singleTime || item->completed)
+        {
+            // inform that animation has completed
+            animationEvent.type = eAnimationCompletedEvent;
+            m_pSink->deliverEvent(animationEvent, item->target, item->sinkData);
+
+            // remove animation (value slot is released by producer)
+            m_animationData.erase(expired.id);
+
+        } else
+        {
+            // NOTE: next deadline is counted from previous one, not from current time,
+            //       so that timing doesn't drift if thread wakes up late
+            item->deadline += item->interval;
+
+            // skip ticks missed completely (e.g. if system was busy)
+            if(item->deadline <= timeNow)
+            {
+                long long missed = (timeNow - item->deadline) / item->interval + 1;
+
+                item->deadline += missed * item->interval;
+                missedTicks += (unsigned long)missed;
+            }
+
+            // schedule next event
+            _scheduleItem(expired.id, *item);
+        }
+    }
+
+    // end delivery
+    if(m_expiredItems.size()) m_pSink->endDelivery();
+
+    // update stats
+    _lockStats();
+
+    m_stats.wakeups++;
+    m_stats.events += (unsigned long)m_expiredItems.size();
+    m_stats.missedTicks += missedTicks;
+    m_stats.totalLatenessMs += totalLateness;
+    if(maxLateness > m_stats.maxLatenessMs) m_stats.maxLatenessMs = maxLateness;
+
+    _unlockStats();
+
+    // drop outdated entries so that thread doesn't wake up without need
+    while(!m_deadlines.empty() && _findScheduledItem(m_deadlines.top()) == 0)
+    {
+        m_deadlines.pop();
+    }
+
+    // time till next deadline
+    if(m_deadlines.empty()) return -1;
+
+    return m_deadlines.top().deadline - timeNow;
+}
+
+/////////////////////////////////////////////////////////////////////
+// animations
+/////////////////////////////////////////////////////////////////////
+XWAnimationScheduler::ValueSlot* XWAnimationScheduler::startAnimation(unsigned long id, bool valueAnimation, unsigned int intervalMs,
+                                                                      const ValueAnimation* value, bool singleTime, void* target)
+{
+    // check input
+    XWASSERT(intervalMs >= 10);
+    if(intervalMs < 10) return 0;
+
+    // NOTE: data is owned by scheduler once command is sent
+    _AnimationData* animationData = new _AnimationData();
+
+    // fill entry
+    animationData->isValue = valueAnimation;
+    animationData->interval = _roundInterval(intervalMs);
+    animationData->startTime = m_pClock->timeMs();
+    animationData->deadline = animationData->startTime + animationData->interval;
+    animationData->target = target;
+
+    // NOTE: value that can't change over time is completed with first processing
+    if(valueAnimation && value && _isInstantValue(*value)) animationData->deadline = animationData->startTime;
+    animationData->singleTime = singleTime;
+
+    // value
+    if(value)
+    {
+        animationData->valueAnimation = *value;
+        animationData->value = value->keyframes.isEmpty() ? value->fromValue : value->keyframes.firstValue();
+    }
+
+    // value shared with producer thread
+    ValueSlot* valueSlot = new ValueSlot(animationData->value);
+    animationData->valueSlot = valueSlot;
+
+    _Command command = {eCommandStart, id, animationData->startTime, animationData, 0};
+
+    // pass to scheduler
+    _sendCommand(command);
+
+    return valueSlot;
+}
+
+void XWAnimationScheduler::pauseAnimation(unsigned long id)
+{
+    _Command command = {eCommandPause, id, m_pClock->timeMs(), 0, 0};
+
+    // pass to scheduler
+    _sendCommand(command);
+}
+
+void XWAnimationScheduler::resumeAnimation(unsigned long id)
+{
+    _Command command = {eCommandResume, id, m_pClock->timeMs(), 0, 0};
+
+    // pass to scheduler
+    _sendCommand(command);
+}
+
+void XWAnimationScheduler::stopAnimation(unsigned long id, ValueSlot* valueSlot)
+{
+    // NOTE: scheduler may still write value, so it deletes value slot
+    _Command command = {eCommandStop, id, m_pClock->timeMs(), 0, valueSlot};
+
+    // pass to scheduler
+    _sendCommand(command);
+}
+
+/////////////////////////////////////////////////////////////////////
+// value slots
+/////////////////////////////////////////////////////////////////////
+float XWAnimationScheduler::readValue(const ValueSlot* valueSlot)
+{
+    XWASSERT(valueSlot);
+    if(valueSlot == 0) return 0.0f;
+
+    // NOTE: value is published by scheduler, no lock is needed to read it
+    return valueSlot->value.load(std::memory_order_acquire);
+}
+
+void XWAnimationScheduler::releaseValueSlot(ValueSlot* valueSlot)
+{
+    delete valueSlot;
+}
+
+/////////////////////////////////////////////////////////////////////
+// statistics
+/////////////////////////////////////////////////////////////////////
+void XWAnimationScheduler::getStats(XSchedulerStats& statsOut)
+{
+    // enter stats protection
+    _lockStats();
+
+    statsOut = m_stats;
+
+    // leave stats protection
+    _unlockStats();
+
+    // producer thread counters
+    statsOut.commands = m_commandsSent;
+    statsOut.commandQueueFull = m_commandQueueFull;
+    statsOut.lockWaits += m_wakeLockWaits;
+}
+
+void XWAnimationScheduler::resetStats()
+{
+    // enter stats protection
+    _lockStats();
+
+    memset(&m_stats, 0, sizeof(XSchedulerStats));
+
+    // leave stats protection
+    _unlockStats();
+
+    // producer thread counters
+    m_commandsSent = 0;
+    m_commandQueueFull = 0;
+    m_wakeLockWaits = 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// scheduler methods
+/////////////////////////////////////////////////////////////////////
+void XWAnimationScheduler::_threadProc()
+{
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+
+    // process until exit is requested
+    while(!m_exitPending)
+    {
+        // reset flag before processing, commands sent later will set it again
+        m_wakePending = false;
+
+        lock.unlock();
+
+        // process commands and expired items
+        long long waitMs = processDue();
+
+        lock.lock();
+
+        // check if anything has been sent while processing
+        if(m_exitPending || m_wakePending) continue;
+
+        // NOTE: producer signals only sleeping thread, so flag is set before queue is
+        //       checked for last time (fences pair with the one in _wakeThread)
+        m_threadSleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // NOTE: spurious wake up only causes extra processing pass
+        if(m_commands.isEmpty())
+        {
+            if(waitMs < 0)
+                m_wakeCondition.wait(lock);
+            else
+                m_wakeCondition.wait_for(lock, std::chrono::milliseconds(waitMs));
+        }
+
+        m_threadSleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void XWAnimationScheduler::_processCommands()
+{
+    _Command command;
+
+    // process all commands sent by producer thread
+    while(m_commands.pop(command))
+    {
+        _processCommand(command);
+    }
+}
+
+void XWAnimationScheduler::_processCommand(const _Command& command)
+{
+    // check command
+    if(command.type == eCommandStart)
+    {
+        // add animation
+        _AnimationDataT::iterator it = m_animationData.insert(_AnimationDataT::value_type(command.id, *command.data)).first;
+        delete command.data;
+
+        // schedule first event
+        _scheduleItem(command.id, it->second);
+
+    } else if(command.type == eCommandStop)
+    {
+        // NOTE: animation may be already completed and removed
+        m_animationData.erase(command.id);
+
+        // producer doesn't use value slot anymore
+        delete command.valueSlot;
+
+    } else
+    {
+        // check if item exsists
+        _AnimationDataT::iterator fit = m_animationData.find(command.id);
+        if(fit == m_animationData.end()) return;
+
+        _AnimationData& item = fit->second;
+
+        // NOTE: use time of producer call, not time when command is processed
+        if(command.type == eCommandPause && !item.paused)
+        {
+            // keep time left till next event and elapsed animation time
+            long long timeLeft = item.deadline - command.time;
+            item.pausedTimeLeft = (timeLeft > 0) ? timeLeft : 0;
+            item.pausedElapsed = command.time - item.startTime;
+
+            // mark as paused (scheduled deadline is ignored from now)
+            item.paused = true;
+
+        } else if(command.type == eCommandResume && item.paused)
+        {
+            // reset flag
+            item.paused = false;
+
+            // continue from where it has been paused
+            item.deadline = command.time + item.pausedTimeLeft;
+            item.startTime = command.time - item.pausedElapsed;
+            _scheduleItem(command.id, item);
+        }
+    }
+}
+
+void XWAnimationScheduler::_evaluateValues(long long timeNow)
+{
+    // NOTE: values of time based animations are computed in one pass before any event
+    //       is sent, loop only reads animation data and writes value and completed flag
+    for(size_t idx = 0; idx < m_expiredItems.size(); ++idx)
+    {
+        _AnimationData& item = *(m_expiredItems[idx].item);
+
+        // ignore timers and step based animations
+        if(!item.isValue || item.valueAnimation.durationMs == 0) continue;
+
+        const ValueAnimation& animation = item.valueAnimation;
+        long long elapsed = timeNow - item.startTime;
+        float progress;
+
+        // animation progress
+        if(animation.periodic)
+        {
+            // start over after each period
+            progress = (float)(elapsed % animation.durationMs) / (float)animation.durationMs;
+
+        } else if(elapsed >= (long long)animation.durationMs)
+        {
+            // last value
+            progress = 1.0f;
+
+            // mark item as completed
+            item.completed = true;
+
+        } else
+        {
+            progress = (float)elapsed / (float)animation.durationMs;
+        }
+
+        // value for progress
+        if(animation.keyframes.isEmpty())
+            item.value = animation.fromValue + (animation.toValue - animation.fromValue) * animation.easing.valueAt(progress);
+        else
+            item.value = animation.keyframes.valueAt(progress);
+    }
+}
+
+void XWAnimationScheduler::_updateValue(_AnimationData& item)
+{
+    // NOTE: time based values are already computed by _evaluateValues
+    if(item.valueAnimation.durationMs != 0) return;
+
+    // value which can't change over time jumps to the end right away
+    if(_isInstantValue(item.valueAnimation))
+    {
+        item.value = item.valueAnimation.keyframes.isEmpty() ? 
+            item.valueAnimation.toValue : item.valueAnimation.keyframes.lastValue();
+
+        // mark item as completed
+        item.completed = true;
+        return;
+    }
+
+    // update value
+    item.value += item.valueAnimation.step;
+
+    // check value limits
+    if(item.value > item.valueAnimation.toValue)
+    {
+        // check if value is periodic
+        if(item.valueAnimation.periodic)
+        {
+            // jump to interval start
+            item.value = item.valueAnimation.fromValue;
+
+        } else
+        {
+            // jump to interval end
+            item.value = item.valueAnimation.toValue;
+
+            // mark item as completed
+            item.completed = true;
+        }
+    }
+}
+
+bool XWAnimationScheduler::_isInstantValue(const ValueAnimation& animation)
+{
+    // NOTE: keyframes and values without duration or positive step would never complete
+    return (animation.durationMs == 0 && (!animation.keyframes.isEmpty() || animation.step <= 0.0f));
+}
+
+void XWAnimationScheduler::_scheduleItem(unsigned long id, _AnimationData& item)
+{
+    _AnimationDeadline entry;
+
+    // NOTE: new sequence makes any previous heap entry of this item outdated
+    item.scheduleSeq = m_nextScheduleSeq++;
+
+    // fill entry
+    entry.deadline = item.deadline;
+    entry.id = id;
+    entry.scheduleSeq = item.scheduleSeq;
+
+    // add to heap
+    m_deadlines.push(entry);
+}
+
+XWAnimationScheduler::_AnimationData* XWAnimationScheduler::_findScheduledItem(const _AnimationDeadline& entry)
+{
+    // check if item exsists
+    _AnimationDataT::iterator fit = m_animationData.find(entry.id);
+    if(fit == m_animationData.end()) return 0;
+
+    // ignore completed and paused
+    if(fit->second.completed || fit->second.paused) return 0;
+
+    // check if entry is still valid
+    if(fit->second.scheduleSeq != entry.scheduleSeq) return 0;
+
+    return &(fit->second);
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XWAnimationScheduler::_sendCommand(const _Command& command)
+{
+    // NOTE: queue is full only if scheduler doesn't run for long time, wait for it
+    //       instead of losing command
+    while(!m_commands.push(command))
+    {
+        m_commandQueueFull++;
+
+        if(m_threadRunning)
+        {
+            // let scheduler thread process commands
+            _wakeThread();
+            std::this_thread::yield();
+
+        } else
+        {
+            // NOTE: without thread producer is the only consumer too
+            _processCommands();
+        }
+    }
+
+    m_commandsSent++;
+
+    // signal thread
+    if(m_threadRunning) _wakeThread();
+}
+
+void XWAnimationScheduler::_wakeThread()
+{
+    // NOTE: thread that is not sleeping checks command queue before it sleeps, so
+    //       wake lock is taken only if thread waits (fence pairs with _threadProc)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(!m_threadSleeping.load(std::memory_order_relaxed)) return;
+
+    // set flag (count waits for lock held by scheduler thread)
+    if(!m_wakeMutex.try_lock())
+    {
+        m_wakeMutex.lock();
+
+        m_wakeLockWaits++;
+    }
+
+    m_wakePending = true;
+
+    m_wakeMutex.unlock();
+
+    // wake thread
+    m_wakeCondition.notify_one();
+}
+
+void XWAnimationScheduler::_lockStats()
+{
+    // count waits for lock held by other thread
+    if(!m_statsMutex.try_lock())
+    {
+        m_statsMutex.lock();
+
+        m_stats.lockWaits++;
+    }
+}
+
+void XWAnimationScheduler::_unlockStats()
+{
+    m_statsMutex.unlock();
+}
+
+unsigned int XWAnimationScheduler::_roundInterval(unsigned int interval)
+{
+    // round to tens of milliseconds
+    return interval - (interval % 10);
+}
+
+// XWAnimationScheduler
+/////////////////////////////////////////////////////////////////////
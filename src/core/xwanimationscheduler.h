@@ -0,0 +1,276 @@
+// Platform independent animation scheduler
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWANIMATIONSCHEDULER_H_
+#define _XWANIMATIONSCHEDULER_H_
+
+// NOTE: scheduler keeps animation deadlines, pause/resume state and values, it doesn't
+//       depend on platform API. Time is read from clock interface and events are passed
+//       to sink interface, so scheduler may run with virtual clock by calling processDue
+//       directly instead of starting scheduler thread.
+
+// NOTE: animation methods may be called only from one (producer) thread, events are
+//       delivered from scheduler thread. If scheduler thread is not started, processDue
+//       must be called from producer thread.
+
+// NOTE: value slot is owned by producer while animation is running. It is passed back
+//       to scheduler with stop call or must be released by producer once completed
+//       event is received, scheduler doesn't use it after completed event.
+
+/////////////////////////////////////////////////////////////////////
+// IXWAnimationClock - animation clock interface
+
+class IXWAnimationClock
+{
+public: // construction/destruction
+    IXWAnimationClock() {}
+    virtual ~IXWAnimationClock() {}
+
+public: // time (monotonic, must be thread safe)
+    virtual long long   timeMs() = 0;
+};
+
+// IXWAnimationClock
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XWAnimationScheduler - animation scheduler
+
+class IXWAnimationSink;
+
+class XWAnimationScheduler
+{
+public: // construction/destruction
+    XWAnimationScheduler(IXWAnimationClock* clock, IXWAnimationSink* sink);
+    ~XWAnimationScheduler();
+
+public: // types
+
+    // NOTE: if duration is set, value is computed from time elapsed since animation start,
+    //       so animation takes the same time even if some ticks are skipped. Otherwise
+    //       step is added to value on each tick. Keyframes replace from and to values.
+
+    // value animation data
+    struct ValueAnimation
+    {
+        float   fromValue;
+        float   toValue;
+        float   step;
+        bool    periodic;
+
+        unsigned int    durationMs;
+        XWEasingCurve   easing;
+        XWKeyframeTrack keyframes;
+
+        // constructors
+        ValueAnimation() :
+                fromValue(0.0f), toValue(0.0f), step(0.0f), periodic(false), durationMs(0) {}
+        ValueAnimation(float from, float to, float step, bool repeat) :
+                fromValue(from), toValue(to), step(step), periodic(repeat), durationMs(0) {}
+        ValueAnimation(float from, float to, unsigned int duration, const XWEasingCurve& curve, bool repeat) :
+                fromValue(from), toValue(to), step(0.0f), periodic(repeat), durationMs(duration), easing(curve) {}
+        ValueAnimation(const XWKeyframeTrack& track, unsigned int duration, bool repeat) :
+                fromValue(track.firstValue()), toValue(track.lastValue()), step(0.0f), periodic(repeat),
+                durationMs(duration), keyframes(track) {}
+    };
+
+    // animation event types
+    enum TAnimationEvent
+    {
+        eAnimationTimerEvent,
+        eAnimationValueEvent,
+        eAnimationCompletedEvent
+    };
+
+    // animation event data
+    struct AnimationEvent
+    {
+        unsigned long   id;
+        TAnimationEvent type;
+        float           value;
+    };
+
+    // scheduler statistics (lateness is time between deadline and event)
+    struct XSchedulerStats
+    {
+        unsigned long   wakeups;
+        unsigned long   events;
+        unsigned long   missedTicks;
+        long long       maxLatenessMs;
+        long long       totalLatenessMs;
+        unsigned long   commands;
+        unsigned long   commandQueueFull;
+        unsigned long   lockWaits;
+    };
+
+    // value shared between scheduler and producer thread
+    struct ValueSlot;
+
+public: // scheduler thread
+    bool    startThread();
+    void    stopThread();
+    bool    isThreadRunning() const { return m_threadRunning; }
+
+public: // processing (called by scheduler thread or directly if thread is not running)
+    long long   processDue();
+
+public: // animations (producer thread)
+    ValueSlot*  startAnimation(unsigned long id, bool valueAnimation, unsigned int intervalMs,
+                               const ValueAnimation* value, bool singleTime, void* target);
+    void    pauseAnimation(unsigned long id);
+    void    resumeAnimation(unsigned long id);
+    void    stopAnimation(unsigned long id, ValueSlot* valueSlot);
+
+public: // value slots (producer thread)
+    static float    readValue(const ValueSlot* valueSlot);
+    static void     releaseValueSlot(ValueSlot* valueSlot);
+
+public: // statistics (producer thread)
+    void    getStats(XSchedulerStats& statsOut);
+    void    resetStats();
+
+private: // types
+    struct _AnimationData
+    {
+        bool            isValue;
+
+        ValueAnimation  valueAnimation;
+        float           value;
+
+        unsigned int    interval;
+        long long       deadline;
+        long long       startTime;
+        long long       pausedTimeLeft;
+        long long       pausedElapsed;
+        unsigned long   scheduleSeq;
+        size_t          sinkData;
+        bool            singleTime;
+        bool            completed;
+        bool            paused;
+
+        void*           target;
+        ValueSlot*      valueSlot;
+
+        // constructors
+        _AnimationData() :
+                isValue(false), value(0.0f), interval(0), deadline(0), startTime(0),
+                pausedTimeLeft(0), pausedElapsed(0), scheduleSeq(0), sinkData(0),
+                singleTime(false), completed(false), paused(false), target(0), valueSlot(0) {}
+    };
+
+    // NOTE: deadline entry is not removed from heap if animation is stopped, paused or
+    //       rescheduled, instead it is ignored when popped as its sequence doesn't match
+    struct _AnimationDeadline
+    {
+        long long       deadline;
+        unsigned long   id;
+        unsigned long   scheduleSeq;
+
+        // order
+        bool operator>(const _AnimationDeadline& other) const { return deadline > other.deadline; }
+    };
+
+    enum _CommandType
+    {
+        eCommandStart,
+        eCommandPause,
+        eCommandResume,
+        eCommandStop
+    };
+
+    // command sent from producer thread to scheduler thread
+    struct _Command
+    {
+        _CommandType    type;
+        unsigned long   id;
+        long long       time;
+        _AnimationData* data;           // start only, scheduler takes ownership
+        ValueSlot*      valueSlot;      // stop only, scheduler deletes it
+    };
+
+    struct _ExpiredItem
+    {
+        unsigned long   id;
+        _AnimationData* item;
+        long long       deadline;
+    };
+
+    typedef std::map<unsigned long, _AnimationData>     _AnimationDataT;
+    typedef std::priority_queue<_AnimationDeadline, std::vector<_AnimationDeadline>,
+                                std::greater<_AnimationDeadline> > _AnimationDeadlineT;
+
+private: // hide copy
+    XWAnimationScheduler(const XWAnimationScheduler&);
+    XWAnimationScheduler& operator=(const XWAnimationScheduler&);
+
+private: // scheduler methods
+    void    _threadProc();
+    void    _processCommands();
+    void    _processCommand(const _Command& command);
+    void    _evaluateValues(long long timeNow);
+    static bool _isInstantValue(const ValueAnimation& animation);
+    void    _updateValue(_AnimationData& item);
+    void    _scheduleItem(unsigned long id, _AnimationData& item);
+    _AnimationData* _findScheduledItem(const _AnimationDeadline& entry);
+
+private: // worker methods
+    void    _sendCommand(const _Command& command);
+    void    _wakeThread();
+    void    _lockStats();
+    void    _unlockStats();
+    unsigned int    _roundInterval(unsigned int interval);
+
+private: // producer thread data
+    unsigned long       m_commandsSent;
+    unsigned long       m_commandQueueFull;
+    unsigned long       m_wakeLockWaits;
+    bool                m_threadRunning;
+
+private: // scheduler thread data
+    _AnimationDataT     m_animationData;
+    _AnimationDeadlineT m_deadlines;
+    std::vector<_ExpiredItem>   m_expiredItems;
+    unsigned long       m_nextScheduleSeq;
+
+private: // shared data
+    IXWAnimationClock*      m_pClock;
+    IXWAnimationSink*       m_pSink;
+    XWSpscQueue<_Command>   m_commands;
+    XSchedulerStats         m_stats;            // protected by stats mutex
+    std::mutex              m_statsMutex;
+
+private: // thread
+    std::thread             m_thread;
+    std::mutex              m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<bool>       m_threadSleeping;   // thread waits (or is about to wait) for wake up
+    bool                    m_wakePending;      // protected by wake mutex
+    bool                    m_exitPending;      // protected by wake mutex
+};
+
+// XWAnimationScheduler
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// IXWAnimationSink - animation events sink interface
+
+class IXWAnimationSink
+{
+public: // construction/destruction
+    IXWAnimationSink() {}
+    virtual ~IXWAnimationSink() {}
+
+public: // events (called from scheduler thread)
+
+    // NOTE: events due at the same time are delivered between begin and end calls,
+    //       sink data is kept per animation for sink own use (initially zero)
+    virtual void    beginDelivery() {}
+    virtual void    deliverEvent(const XWAnimationScheduler::AnimationEvent& animationEvent, void* target, size_t& sinkData) = 0;
+    virtual void    endDelivery() {}
+};
+
+// IXWAnimationSink
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWANIMATIONSCHEDULER_H_
@@ -92,9 +92,7 @@ bool XWAnimationTimer::startTimerAnimation(unsigned int intervalMs, IXWAnimation
     if(intervalMs < 10 || callback == 0) return false;
 
     // add data
-    _addAnimationData(eTimerAnimation, intervalMs, 0, false, callback, 0, idOut);
-
-    return true;
+    return _addAnimationData(false, intervalMs, 0, false, callback, 0, idOut);
 }
 
 bool XWAnimationTimer::startTimerAnimation(unsigned int intervalMs, HWND callback, DWORD& idOut)
@@ -105,9 +103,7 @@ bool XWAnimationTimer::startTimerAnimation(unsigned int intervalMs, HWND callbac
     if(intervalMs < 10 || callback == 0) return false;
 
     // add data
-    _addAnimationData(eTimerAnimation, intervalMs, 0, false, 0, callback, idOut);
-
-    return true;
+    return _addAnimationData(false, intervalMs, 0, false, 0, callback, idOut);
 }
 
 bool XWAnimationTimer::startSingleAnimation(unsigned int intervalMs, IXWAnimationTimerCallback* callback, DWORD& idOut)
@@ -118,9 +114,7 @@ bool XWAnimationTimer::startSingleAnimation(unsigned int intervalMs, IXWAnimatio
     if(intervalMs < 10 || callback == 0) return false;
 
     // add data
-    _addAnimationData(eTimerAnimation, intervalMs, 0, true, callback, 0, idOut);
-
-    return true;
+    return _addAnimationData(false, intervalMs, 0, true, callback, 0, idOut);
 }
 
 bool XWAnimationTimer::startSingleAnimation(unsigned int intervalMs, HWND callback, DWORD& idOut)
@@ -131,9 +125,7 @@ bool XWAnimationTimer::startSingleAnimation(unsigned int intervalMs, HWND callba
     if(intervalMs < 10 || callback == 0) return false;
 
     // add data
-    _addAnimationData(eTimerAnimation, intervalMs, 0, true, 0, callback, idOut);
-
-    return true;
+    return _addAnimationData(false, intervalMs, 0, true, 0, callback, idOut);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -147,9 +139,7 @@ bool XWAnimationTimer::startValueAnimation(unsigned int intervalMs, const ValueA
     if(intervalMs < 10 || callback == 0) return false;
 
     // add data
-    _addAnimationData(eValueAnimation, intervalMs, &animation, false, callback, 0, idOut);
-
-    return true;
+    return _addAnimationData(true, intervalMs, &animation, false, callback, 0, idOut);
 }
 
 bool XWAnimationTimer::startValueAnimation(unsigned int intervalMs, const ValueAnimation& animation, HWND callback, DWORD& idOut)
@@ -160,33 +150,22 @@ bool XWAnimationTimer::startValueAnimation(unsigned int intervalMs, const ValueA
     if(intervalMs < 10 || callback == 0) return false;
 
     // add data
-    _addAnimationData(eValueAnimation, intervalMs, &animation, false, 0, callback, idOut);
-
-    return true;
+    return _addAnimationData(true, intervalMs, &animation, false, 0, callback, idOut);
 }
 
 bool XWAnimationTimer::getAnimationValue(DWORD id, float& valueOut)
 {
-    bool ret = false;
-
     // reset output
     valueOut = 0.0f;
 
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
-
     // check if item exsists
-    _AnimationDataT::const_iterator fit = m_animationData.find(id);
-    if(fit != m_animationData.end())
-    {
-        valueOut = fit->second.value;
-        ret = true;
-    }
+    _UiAnimationT::const_iterator fit = m_uiAnimations.find(id);
+    if(fit == m_uiAnimations.end()) return false;
 
-    // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
+    // NOTE: value is published by timer thread, no lock is needed to read it
+    valueOut = XWAnimationScheduler::readValue(fit->second.valueSlot);
 
-    return ret;
+    return true;
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -194,75 +173,197 @@ bool XWAnimationTimer::getAnimationValue(DWORD id, float& valueOut)
 /////////////////////////////////////////////////////////////////////
 bool XWAnimationTimer::hasAnimation(DWORD id)
 {
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
+    return (m_uiAnimations.count(id) != 0);
+}
 
-    bool ret = (m_animationData.count(id) != 0);
+void XWAnimationTimer::pauseAnimation(DWORD id)
+{
+    XWASSERT(::GetCurrentThreadId() == m_uiThreadId);
 
-    // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
+    // ignore unknown animation
+    if(m_uiAnimations.count(id) == 0) return;
 
-    return ret;
+    // pass to scheduler
+    m_pScheduler->pauseAnimation(id);
 }
 
-void XWAnimationTimer::pauseAnimation(DWORD id)
+void XWAnimationTimer::resumeAnimation(DWORD id)
 {
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
+    XWASSERT(::GetCurrentThreadId() == m_uiThreadId);
+
+    // ignore unknown animation
+    if(m_uiAnimations.count(id) == 0) return;
+
+    // pass to scheduler
+    m_pScheduler->resumeAnimation(id);
+}
+
+void XWAnimationTimer::stopAnimation(DWORD id)
+{
+    XWASSERT(::GetCurrentThreadId() == m_uiThreadId);
 
     // check if item exsists
-    _AnimationDataT::iterator fit = m_animationData.find(id);
-    if(fit != m_animationData.end())
+    _UiAnimationT::iterator fit = m_uiAnimations.find(id);
+    if(fit == m_uiAnimations.end()) return;
+
+    // NOTE: timer thread may still write value, so scheduler deletes value slot
+    XWAnimationScheduler::ValueSlot* valueSlot = fit->second.valueSlot;
+
+    // remove animation
+    m_uiAnimations.erase(fit);
+
+    // pass to scheduler
+    m_pScheduler->stopAnimation(id, valueSlot);
+}
+
+/////////////////////////////////////////////////////////////////////
+// frame delivery
+/////////////////////////////////////////////////////////////////////
+void XWAnimationTimer::enableFrameDelivery(HWND hwnd, bool bEnable)
+{
+    XWASSERT(hwnd);
+    if(hwnd == 0) return;
+
+    // enter data protection
+    _lockData();
+
+    if(bEnable)
     {
-        // mark as paused
-        fit->second.paused = true;
+        // add window event list if not yet
+        m_frameEvents[hwnd];
 
-        // signal thread
-        _sendThreadTask(eThreadItemsChanged);
+    } else
+    {
+        // remove window with events not taken yet
+        m_frameEvents.erase(hwnd);
     }
 
     // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
+    _unlockData();
 }
 
-void XWAnimationTimer::resumeAnimation(DWORD id)
+bool XWAnimationTimer::takeFrameEvents(HWND hwnd, std::vector<AnimationEvent>& eventsOut)
 {
+    // reset output
+    eventsOut.clear();
+
     // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
+    _lockData();
 
-    // check if item exsists
-    _AnimationDataT::iterator fit = m_animationData.find(id);
-    if(fit != m_animationData.end())
+    // NOTE: swap lists so that both keep allocated memory between frames
+    _FrameEventsT::iterator fit = m_frameEvents.find(hwnd);
+    if(fit != m_frameEvents.end())
     {
-        // reset flag
-        fit->second.paused = false;
-
-        // signal thread
-        _sendThreadTask(eThreadItemsChanged);
+        fit->second.swap(eventsOut);
     }
 
     // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
+    _unlockData();
+
+    return (eventsOut.size() != 0);
 }
 
-void XWAnimationTimer::stopAnimation(DWORD id)
+/////////////////////////////////////////////////////////////////////
+// statistics
+/////////////////////////////////////////////////////////////////////
+void XWAnimationTimer::getTimerStats(XTimerStats& statsOut)
 {
+    // scheduler statistics
+    m_pScheduler->getStats(statsOut);
+
     // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
+    _lockData();
 
-    // check if item exsists
-    _AnimationDataT::iterator fit = m_animationData.find(id);
-    if(fit != m_animationData.end())
+    // add waits for frame events lock
+    statsOut.lockWaits += m_lockWaits;
+
+    // leave data protection
+    _unlockData();
+}
+
+void XWAnimationTimer::resetTimerStats()
+{
+    // scheduler statistics
+    m_pScheduler->resetStats();
+
+    // enter data protection
+    _lockData();
+
+    m_lockWaits = 0;
+
+    // leave data protection
+    _unlockData();
+}
+
+/////////////////////////////////////////////////////////////////////
+// IXWAnimationClock
+/////////////////////////////////////////////////////////////////////
+long long XWAnimationTimer::timeMs()
+{
+    LARGE_INTEGER counter;
+
+    // NOTE: use monotonic clock, system time may jump if changed by user or synchronized
+    if(m_perfFrequency == 0 || !::QueryPerformanceCounter(&counter))
     {
-        // remove animation
-        m_animationData.erase(fit);
+        return (LONGLONG)::GetTickCount64();
+    }
 
-        // signal thread
-        _sendThreadTask(eThreadItemsChanged);
+    // convert to milliseconds (split to avoid overflow)
+    return (counter.QuadPart / m_perfFrequency) * 1000 + 
+           (counter.QuadPart % m_perfFrequency) * 1000 / m_perfFrequency;
+}
+
+/////////////////////////////////////////////////////////////////////
+// IXWAnimationSink
+/////////////////////////////////////////////////////////////////////
+void XWAnimationTimer::beginDelivery()
+{
+    // NOTE: messages are collected while lock is held and posted after it is released,
+    //       so that UI thread taking frame events doesn't wait for PostMessage calls
+    m_pendingPosts.clear();
+
+    // NOTE: lock is needed only for frame events
+    _lockData();
+}
+
+void XWAnimationTimer::deliverEvent(const AnimationEvent& animationEvent, void* target, size_t& sinkData)
+{
+    HWND hwndCallback = (HWND)target;
+
+    // NOTE: sink data keeps index of animation event in window frame list
+    if(hwndCallback)
+    {
+        // pass to window
+        _postWindowEvent(hwndCallback, animationEvent, sinkData);
+
+    } else if(animationEvent.type == XWAnimationScheduler::eAnimationTimerEvent)
+    {
+        // pass to callback in UI thread
+        _addPendingPost(m_eventWindow, WM_XWUI_ANIMATION_TIMER_EVENT, animationEvent.id);
+
+    } else if(animationEvent.type == XWAnimationScheduler::eAnimationValueEvent)
+    {
+        // pass to callback in UI thread
+        _addPendingPost(m_eventWindow, WM_XWUI_ANIMATION_VALUE_EVENT, animationEvent.id);
+    }
+
+    // NOTE: even if callback is window handle we still send event so that any previous
+    //       message (e.g. value update) will be delivered properly and client can read final
+    //       value while processing them. Message handle in event window will remove animation 
+    //       from list.
+    if(animationEvent.type == XWAnimationScheduler::eAnimationCompletedEvent)
+    {
+        _addPendingPost(m_eventWindow, WM_XWUI_ANIMATION_COMPLETED, animationEvent.id);
     }
+}
 
+void XWAnimationTimer::endDelivery()
+{
     // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
+    _unlockData();
+
+    // post collected messages
+    _flushPendingPosts();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -270,10 +371,11 @@ void XWAnimationTimer::stopAnimation(DWORD id)
 /////////////////////////////////////////////////////////////////////
 XWAnimationTimer::XWAnimationTimer() :
     m_nextId(1),
-    m_waitInterval(INFINITE),
-    m_eventWindow(0),
-    m_syncEvent(0),
-    m_timerThread(0)
+    m_uiThreadId(0),
+    m_pScheduler(0),
+    m_lockWaits(0),
+    m_perfFrequency(0),
+    m_eventWindow(0)
 {
     // init
     _init();
@@ -305,6 +407,15 @@ LRESULT CALLBACK XWAnimationTimer::_windowProc(HWND hwnd, UINT uMsg, WPARAM wPar
     }
 
     // process messages
+    if(uMsg == WM_XWUI_ANIMATION_TIMER_EVENT || uMsg == WM_XWUI_ANIMATION_VALUE_EVENT || uMsg == WM_XWUI_ANIMATION_COMPLETED)
+    {
+        // queue latency (if profiler enabled)
+        XWPROFILE_QUEUE_LATENCY(uMsg, lParam);
+    }
+
+    // profile message processing (if profiler enabled)
+    XWPROFILE_MESSAGE(uMsg);
+
     if(uMsg == WM_XWUI_ANIMATION_TIMER_EVENT)
     {
         // pass to event listener
@@ -365,245 +476,132 @@ bool XWAnimationTimer::_registerWindowClass()
 
 void XWAnimationTimer::_processAnimationTimer(DWORD id)
 {
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
-
     // check if item exsists
-    _AnimationDataT::iterator fit = m_animationData.find(id);
-    if(fit != m_animationData.end())
+    _UiAnimationT::iterator fit = m_uiAnimations.find(id);
+    if(fit != m_uiAnimations.end())
     {
         // pass to callback
         XWASSERT(fit->second.callback);
         if(fit->second.callback)
             fit->second.callback->onAnimationTimer(id);
     }
-
-    // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
 }
 
 void XWAnimationTimer::_processAnimationValue(DWORD id)
 {
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
-
     // check if item exsists
-    _AnimationDataT::iterator fit = m_animationData.find(id);
-    if(fit != m_animationData.end())
+    _UiAnimationT::iterator fit = m_uiAnimations.find(id);
+    if(fit != m_uiAnimations.end())
     {
         // pass to callback
         XWASSERT(fit->second.callback);
         if(fit->second.callback)
-            fit->second.callback->onAnimationValue(id, fit->second.value);
+            fit->second.callback->onAnimationValue(id, XWAnimationScheduler::readValue(fit->second.valueSlot));
     }
-
-    // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
 }
 
 void XWAnimationTimer::_processAnimationCompleted(DWORD id)
 {
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
+    // NOTE: animation may be already stopped by UI thread
+    _UiAnimationT::iterator fit = m_uiAnimations.find(id);
+    if(fit == m_uiAnimations.end()) return;
 
-    // check if item exsists
-    _AnimationDataT::iterator fit = m_animationData.find(id);
-    if(fit != m_animationData.end())
-    {
-        // pass to callback
-        if(fit->second.callback)
-            fit->second.callback->onAnimationCompleted(id);
+    // copy callback
+    IXWAnimationTimerCallback* callback = fit->second.callback;
 
-        // remove animation
-        XWASSERT(fit->second.completed);
-        m_animationData.erase(fit);
-    }
+    // NOTE: timer thread doesn't use completed animation anymore, so value slot 
+    //       is deleted here. Remove animation before callback as it may start new one.
+    XWAnimationScheduler::releaseValueSlot(fit->second.valueSlot);
+    m_uiAnimations.erase(fit);
 
-    // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
+    // pass to callback
+    if(callback)
+        callback->onAnimationCompleted(id);
 }
 
 /////////////////////////////////////////////////////////////////////
-// thread methods
+// delivery methods (timer thread)
 /////////////////////////////////////////////////////////////////////
-DWORD WINAPI XWAnimationTimer::_threadProcFunc(LPVOID threadParameter)
+void XWAnimationTimer::_postWindowEvent(HWND hwnd, const AnimationEvent& animationEvent, size_t& frameEventIdx)
 {
-    // check input
-    XWASSERT(threadParameter);
-    if(threadParameter == 0) return 0;
+    DWORD id = animationEvent.id;
 
-    return ((XWAnimationTimer*)threadParameter)->_threadProc();
-}
-
-DWORD XWAnimationTimer::_threadProc()
-{
-    // process tasks
-    while(m_threadTask != eThreadExit)
+    // check if frame delivery is enabled for window
+    _FrameEventsT::iterator fit = m_frameEvents.find(hwnd);
+    if(fit == m_frameEvents.end())
     {
-        // copy timestamp
-        LONGLONG waitstart = _getTimeMs();
-
-        // wait for timeout or task
-        DWORD ret = ::WaitForSingleObject(m_syncEvent, m_waitInterval);
-        if(ret == WAIT_OBJECT_0)
-        {
-            // process task
-            if(!_processThreadTask()) break;
-
-            // process timeouts
-            _processItemTimeouts(_roundInterval((DWORD)(_getTimeMs() - waitstart)));
-
-        } else if(ret == WAIT_TIMEOUT)
-        {
-            // process timeouts
-            _processItemTimeouts(m_waitInterval);
-
-        } else
-        {
-            // wait failed
-            XWTRACE_WERR_LAST("XWAnimationTimer: WaitForSingleObject failed");
+        // post event message
+        if(animationEvent.type == XWAnimationScheduler::eAnimationTimerEvent)
+            _addPendingPost(hwnd, WM_XWUI_ANIMATION_TIMER_EVENT, id);
+        else if(animationEvent.type == XWAnimationScheduler::eAnimationValueEvent)
+            _addPendingPost(hwnd, WM_XWUI_ANIMATION_VALUE_EVENT, id);
+        else
+            _addPendingPost(hwnd, WM_XWUI_ANIMATION_COMPLETED, id);
 
-            // small delay to avoid eating all CPU time
-            ::Sleep(100);
-        }
+        return;
     }
 
-    return 0;
-}
+    std::vector<AnimationEvent>& frameEvents = fit->second;
 
-bool XWAnimationTimer::_processThreadTask()
-{
-    bool ret = true;
-
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
-
-    // check task
-    if(m_threadTask == eThreadExit)
+    // update event not taken yet by window instead of adding new one
+    if(animationEvent.type != XWAnimationScheduler::eAnimationCompletedEvent && frameEventIdx < frameEvents.size() &&
+       frameEvents[frameEventIdx].id == id && frameEvents[frameEventIdx].type == animationEvent.type)
     {
-        // return false to stop thread
-        ret = false;
+        frameEvents[frameEventIdx].value = animationEvent.value;
+        return;
     }
 
-    // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
+    // NOTE: window is informed only about first event in frame, it takes all of them at once
+    bool postFrame = (frameEvents.size() == 0);
+
+    // add event
+    frameEventIdx = frameEvents.size();
+    frameEvents.push_back(animationEvent);
 
-    return ret;
+    // inform window
+    if(postFrame) _addPendingPost(hwnd, WM_XWUI_ANIMATION_FRAME, 0);
 }
 
-void XWAnimationTimer::_processItemTimeouts(DWORD timeout)
+void XWAnimationTimer::_addPendingPost(HWND hwnd, UINT uMsg, WPARAM wParam)
 {
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
+    _PendingPost pendingPost;
 
-    // loop over all items
-    for(_AnimationDataT::iterator it = m_animationData.begin(); 
-        it != m_animationData.end(); ++it)
-    {
-        // ignore completed and paused
-        if(it->second.completed || it->second.paused) continue;
-
-        // check if item has expired
-        if(it->second.intervalLeft <= timeout)
-        {
-            // fire item event
-            _sendItemEvent(it->first, it->second);
-
-            // remove item if single instance or last event sent
-            if(it->second.singleTime || it->second.completed)
-            {
-                // inform that animation has completed
-                if(it->second.hwndCallback)
-                    ::PostMessageW(it->second.hwndCallback, WM_XWUI_ANIMATION_COMPLETED, it->first, 0);
-
-                // NOTE: even if callback is window handle we still send event so that any previous
-                //       message (e.g. value update) will be delivered properly and client can read final
-                //       value while processing them. Message handle in event window will remove animation 
-                //       from list.
-                ::PostMessageW(m_eventWindow, WM_XWUI_ANIMATION_COMPLETED, it->first, 0);
-
-                // mark as completed
-                it->second.completed = true;
-
-            } else
-            {
-                // reset wait interval
-                it->second.intervalLeft = it->second.interval;
-            }
-
-        } else
-        {
-            // substract timeout
-            it->second.intervalLeft -= timeout;
-        }
-    }
+    // fill entry
+    pendingPost.hwnd = hwnd;
+    pendingPost.uMsg = uMsg;
+    pendingPost.wParam = wParam;
 
-    m_waitInterval = 0;
+    // NOTE: list keeps allocated memory between deliveries
+    m_pendingPosts.push_back(pendingPost);
+}
 
-    // select minimum time to wait
-    for(_AnimationDataT::iterator it = m_animationData.begin(); 
-        it != m_animationData.end(); ++it)
+void XWAnimationTimer::_flushPendingPosts()
+{
+    // post in the same order as events have been delivered
+    for(size_t idx = 0; idx < m_pendingPosts.size(); ++idx)
     {
-        // ignore completed and paused
-        if(it->second.completed || it->second.paused) continue;
+        const _PendingPost& pendingPost = m_pendingPosts[idx];
 
-        // update minimum
-        if(m_waitInterval > it->second.intervalLeft || m_waitInterval == 0)
-            m_waitInterval = it->second.intervalLeft;
-    }
+        // post message
+        if(::PostMessageW(pendingPost.hwnd, pendingPost.uMsg, pendingPost.wParam, XWPROFILE_POST_STAMP())) continue;
 
-    // check if there is any interval
-    if(m_waitInterval == 0)
-    {
-        // ignore timeout
-        m_waitInterval = INFINITE;
-    }
+        // check if window will miss its frame events
+        if(pendingPost.uMsg != WM_XWUI_ANIMATION_FRAME) continue;
 
-    // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
-}
+        XWTRACE_WERR_LAST("XWAnimationTimer: failed to post frame message");
 
-void XWAnimationTimer::_sendItemEvent(DWORD id, _AnimationData& item)
-{
-    // check type
-    if(item.type == eTimerAnimation)
-    {
-        // send message
-        if(item.hwndCallback)
-            ::PostMessageW(item.hwndCallback, WM_XWUI_ANIMATION_TIMER_EVENT, id, 0);
-        else
-            ::PostMessageW(m_eventWindow, WM_XWUI_ANIMATION_TIMER_EVENT, id, 0);
-
-    } else if(item.type == eValueAnimation)
-    {
-        // update value
-        item.value += item.valueAnimation.step;
+        // enter data protection
+        _lockData();
 
-        // check value limits
-        if(item.value > item.valueAnimation.toValue)
-        {
-            // check if value is periodic
-            if(item.valueAnimation.periodic)
-            {
-                // jump to interval start
-                item.value = item.valueAnimation.fromValue;
-
-            } else
-            {
-                // jump to interval end
-                item.value = item.valueAnimation.toValue;
-
-                // mark item as completed
-                item.completed = true;
-            }
-        }
+        // drop events, window will not read them
+        _FrameEventsT::iterator fit = m_frameEvents.find(pendingPost.hwnd);
+        if(fit != m_frameEvents.end()) fit->second.clear();
 
-        // report value
-        if(item.hwndCallback)
-            ::PostMessageW(item.hwndCallback, WM_XWUI_ANIMATION_VALUE_EVENT, id, 0);
-        else
-            ::PostMessageW(m_eventWindow, WM_XWUI_ANIMATION_VALUE_EVENT, id, 0);
+        // leave data protection
+        _unlockData();
     }
+
+    m_pendingPosts.clear();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -611,17 +609,23 @@ void XWAnimationTimer::_sendItemEvent(DWORD id, _AnimationData& item)
 /////////////////////////////////////////////////////////////////////
 void XWAnimationTimer::_init()
 {
-    // init critical section
-    ::InitializeCriticalSection(&m_criticalSection);
+    LARGE_INTEGER frequency;
 
-    // create event
-    m_syncEvent = ::CreateEvent(0, FALSE, FALSE, 0);
-    if(m_syncEvent == 0)
+    // NOTE: UI thread is the only one that sends commands
+    m_uiThreadId = ::GetCurrentThreadId();
+
+    // monotonic clock frequency
+    if(::QueryPerformanceFrequency(&frequency) && frequency.QuadPart > 0)
     {
-        XWTRACE_WERR_LAST("XWAnimationTimer: failed to create sync event, animation will not work");
-        return;
+        m_perfFrequency = frequency.QuadPart;
     }
 
+    // init critical section
+    ::InitializeCriticalSection(&m_criticalSection);
+
+    // scheduler uses timer as clock and events sink
+    m_pScheduler = new XWAnimationScheduler(this, this);
+
     // register class
     if(_registerWindowClass()) 
     {
@@ -650,17 +654,17 @@ void XWAnimationTimer::_init()
     }
 
     // start thread
-    m_timerThread = ::CreateThread(0, 0, _threadProcFunc, this, 0, 0);
-    if(m_timerThread == 0)
+    if(!m_pScheduler->startThread())
     {
-        XWTRACE_WERR_LAST("XWAnimationTimer: failed to start timer thread, animation will not work");
+        XWTRACE("XWAnimationTimer: failed to start timer thread, animation will not work");
     }
 }
 
 void XWAnimationTimer::_close()
 {
-    // stop thread
-    _sendThreadTask(eThreadExit);
+    // NOTE: scheduler stops its thread and deletes data of commands not processed yet
+    delete m_pScheduler;
+    m_pScheduler = 0;
 
     // destroy window if any
     if(m_eventWindow)
@@ -675,96 +679,70 @@ void XWAnimationTimer::_close()
         m_eventWindow = 0;
     }
 
-    // wait for thread to stop
-    DWORD result = ::WaitForSingleObject(m_timerThread, 500);
-    if(result != WAIT_OBJECT_0)
+    // delete value slots
+    for(_UiAnimationT::iterator it = m_uiAnimations.begin(); it != m_uiAnimations.end(); ++it)
     {
-        XWTRACE("XWAnimationTimer: timer thread is still running, closing it");
-
-        ::TerminateThread(m_timerThread, 0);
+        XWAnimationScheduler::releaseValueSlot(it->second.valueSlot);
     }
 
-    // destroy thread handle
-    ::CloseHandle(m_timerThread);
-
-    // destroy sync event
-    ::CloseHandle(m_syncEvent);
+    m_uiAnimations.clear();
 
     // destroy critical section
     ::DeleteCriticalSection(&m_criticalSection);
 }
 
-void XWAnimationTimer::_sendThreadTask(_ThreadTask task)
+void XWAnimationTimer::_lockData()
 {
-    // set thread task
-    m_threadTask = task;
+    // count waits for lock held by other thread
+    if(!::TryEnterCriticalSection(&m_criticalSection))
+    {
+        ::EnterCriticalSection(&m_criticalSection);
 
-    // singal event
-    ::SetEvent(m_syncEvent);
+        m_lockWaits++;
+    }
 }
 
-void XWAnimationTimer::_addAnimationData(_AnimationType type, unsigned int intervalMs, const ValueAnimation* value, bool singleTime, 
+void XWAnimationTimer::_unlockData()
+{
+    ::LeaveCriticalSection(&m_criticalSection);
+}
+
+bool XWAnimationTimer::_addAnimationData(bool valueAnimation, unsigned int intervalMs, const ValueAnimation* value, bool singleTime, 
                                   IXWAnimationTimerCallback* callbackPtr, HWND callbackHwnd, DWORD& idOut)
 {
-    // enter data protection
-    ::EnterCriticalSection(&m_criticalSection);
+    XWASSERT(::GetCurrentThreadId() == m_uiThreadId);
 
-    _AnimationData animationData;
-
-    // fill entry
-    animationData.type = type;
-    animationData.interval = _roundInterval(intervalMs);
-    animationData.intervalLeft = animationData.interval;
-    animationData.callback = callbackPtr;
-    animationData.hwndCallback = callbackHwnd;
-    animationData.singleTime = singleTime;
-
-    // value
-    if(value)
-    {
-        animationData.valueAnimation = *value;
-        animationData.value = value->fromValue;
-    }
+    // check if thread is running
+    if(m_pScheduler == 0 || !m_pScheduler->isThreadRunning()) return false;
 
     // new item id
     idOut = _getNextItemId();
 
-    // insert
-    m_animationData.insert(_AnimationDataT::value_type(idOut, animationData));
+    // pass to scheduler (value is shared with UI thread)
+    XWAnimationScheduler::ValueSlot* valueSlot = m_pScheduler->startAnimation(idOut, valueAnimation, intervalMs, value, singleTime, callbackHwnd);
+    if(valueSlot == 0) return false;
 
-    // signal thread
-    _sendThreadTask(eThreadItemsChanged);
+    _UiAnimation uiAnimation;
 
-    // leave data protection
-    ::LeaveCriticalSection(&m_criticalSection);
+    // fill UI part
+    uiAnimation.callback = callbackPtr;
+    uiAnimation.valueSlot = valueSlot;
+
+    // insert
+    m_uiAnimations.insert(_UiAnimationT::value_type(idOut, uiAnimation));
+
+    return true;
 }
 
 DWORD XWAnimationTimer::_getNextItemId()
 {
-    // select not used id
-    while(m_nextId == 0 || m_animationData.count(m_nextId) != 0)
+    // NOTE: don't reuse id of just stopped animation, its messages may still be in queue
+    while(m_nextId == 0 || m_uiAnimations.count(m_nextId) != 0)
     {
         ++m_nextId;
     }
 
-    return m_nextId;
-}
-
-LONGLONG XWAnimationTimer::_getTimeMs()
-{
-    FILETIME ft;
-
-    // get file time
-    ::GetSystemTimeAsFileTime(&ft);
-
-    // convert to milliseconds
-    return (((ULONGLONG) ft.dwHighDateTime) << 32) + ft.dwLowDateTime;
-}
-
-DWORD XWAnimationTimer::_roundInterval(DWORD interval)
-{
-    // round to tens of milliseconds
-    return interval - (interval % 10);
+    return m_nextId++;
 }
 
 // XWAnimationTimer
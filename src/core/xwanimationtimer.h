@@ -12,10 +12,22 @@
 //        - WM_XWUI_ANIMATION_TIMER_EVENT
 //        - WM_XWUI_ANIMATION_VALUE_EVENT
 //        - WM_XWUI_ANIMATION_COMPLETED
+//       or only WM_XWUI_ANIMATION_FRAME if frame delivery is enabled for window.
 
 // NOTE: callback methods will be called from UI thread (thread that creates animation
 //       timer). A message queue must be running in this thread.
 
+// NOTE: all methods except takeFrameEvents must be called from UI thread, they don't
+//       block on timer thread. Commands are passed to timer thread with lock-free
+//       queue and animation values are published with atomic writes.
+
+// NOTE: animation events are scheduled by absolute deadline of monotonic clock, each
+//       next deadline is counted from previous one so that events don't drift if timer
+//       thread wakes up late. Ticks missed completely are skipped, not delivered later.
+
+// NOTE: scheduling is done by XWAnimationScheduler, timer provides it with Windows
+//       clock and delivers its events to windows and callbacks in UI thread.
+
 /////////////////////////////////////////////////////////////////////
 // IXWAnimationTimerCallback - animation timer callback
 
@@ -37,7 +49,8 @@ public: // events
 /////////////////////////////////////////////////////////////////////
 // XWAnimationTimer - animation timer
 
-class XWAnimationTimer
+class XWAnimationTimer : public IXWAnimationClock,
+                         public IXWAnimationSink
 {
 public: // destruction
     ~XWAnimationTimer();
@@ -53,21 +66,7 @@ public: // timers
     bool    startSingleAnimation(unsigned int intervalMs, HWND callback, DWORD& idOut);
 
 public: // values
-
-    // value animation data
-    struct ValueAnimation
-    {
-        float   fromValue;
-        float   toValue;
-        float   step;
-        bool    periodic;
-
-        // constructors
-        ValueAnimation() : 
-                fromValue(0.0f), toValue(0.0f), step(0.0f), periodic(false) {}
-        ValueAnimation(float from, float to, float step, bool repeat) : 
-                fromValue(from), toValue(to), step(step), periodic(repeat) {}
-    };
+    typedef XWAnimationScheduler::ValueAnimation    ValueAnimation;
 
     bool    startValueAnimation(unsigned int intervalMs, const ValueAnimation& animation, IXWAnimationTimerCallback* callback, DWORD& idOut);
     bool    startValueAnimation(unsigned int intervalMs, const ValueAnimation& animation, HWND callback, DWORD& idOut);
@@ -79,43 +78,52 @@ public: // manage animations
     void    resumeAnimation(DWORD id);
     void    stopAnimation(DWORD id);
 
-private: // types
-    enum _AnimationType
-    {
-        eTimerAnimation,
-        eValueAnimation
-    };
+public: // frame delivery
 
-    struct _AnimationData
-    {
-        _AnimationType  type;
+    // animation event data
+    typedef XWAnimationScheduler::AnimationEvent    AnimationEvent;
+
+    // NOTE: if frame delivery is enabled, all events for window that are due in the
+    //       same frame are collected and window gets single WM_XWUI_ANIMATION_FRAME
+    //       message. Events not taken yet are updated in place, not added again.
+    void    enableFrameDelivery(HWND hwnd, bool bEnable);
+    bool    takeFrameEvents(HWND hwnd, std::vector<AnimationEvent>& eventsOut);
+
+public: // statistics
 
-        ValueAnimation  valueAnimation;
-        float           value;
+    // timer statistics (lateness is time between deadline and event)
+    typedef XWAnimationScheduler::XSchedulerStats   XTimerStats;
 
-        unsigned int    interval;
-        unsigned int    intervalLeft;
-        bool            singleTime;
-        bool            completed;
-        bool            paused;
+    void    getTimerStats(XTimerStats& statsOut);
+    void    resetTimerStats();
 
-        IXWAnimationTimerCallback*      callback;
-        HWND                            hwndCallback;
+public: // IXWAnimationClock
+    long long   timeMs();
 
-        // constructors
-        _AnimationData() : 
-                type(eTimerAnimation), value(0.0f), interval(0), intervalLeft(0), 
-                singleTime(false), completed(false), paused(false), callback(0), hwndCallback(0) {}
+public: // IXWAnimationSink
+    void    beginDelivery();
+    void    deliverEvent(const AnimationEvent& animationEvent, void* target, size_t& sinkData);
+    void    endDelivery();
+
+private: // types
+
+    // UI thread part of animation
+    struct _UiAnimation
+    {
+        IXWAnimationTimerCallback*          callback;
+        XWAnimationScheduler::ValueSlot*    valueSlot;
     };
 
-    enum _ThreadTask
+    // message collected during delivery (posted once data lock is released)
+    struct _PendingPost
     {
-        eThreadTaskNone,
-        eThreadItemsChanged,
-        eThreadExit
+        HWND            hwnd;
+        UINT            uMsg;
+        WPARAM          wParam;
     };
 
-    typedef std::map<DWORD, _AnimationData>     _AnimationDataT;
+    typedef std::map<DWORD, _UiAnimation>       _UiAnimationT;
+    typedef std::map<HWND, std::vector<AnimationEvent> >    _FrameEventsT;
 
 private: // hide constructor (only single instance allowed)
     XWAnimationTimer();
@@ -127,31 +135,34 @@ private: // window methods
     void                    _processAnimationValue(DWORD id);
     void                    _processAnimationCompleted(DWORD id);
 
-private: // thread methods
-    static DWORD WINAPI     _threadProcFunc(LPVOID threadParameter);
-    DWORD                   _threadProc();
-    bool                    _processThreadTask();
-    void                    _processItemTimeouts(DWORD timeout);
-    void                    _sendItemEvent(DWORD id, _AnimationData& item);
+private: // delivery methods (timer thread)
+    void                    _postWindowEvent(HWND hwnd, const AnimationEvent& animationEvent, size_t& frameEventIdx);
+    void                    _addPendingPost(HWND hwnd, UINT uMsg, WPARAM wParam);
+    void                    _flushPendingPosts();
 
 private: // worker methods
     void        _init();
     void        _close();
-    void        _sendThreadTask(_ThreadTask task);
-    void        _addAnimationData(_AnimationType type, unsigned int intervalMs, const ValueAnimation* value, bool singleTime,
+    void        _lockData();
+    void        _unlockData();
+    bool        _addAnimationData(bool valueAnimation, unsigned int intervalMs, const ValueAnimation* value, bool singleTime, 
                                   IXWAnimationTimerCallback* callbackPtr, HWND callbackHwnd, DWORD& idOut);
     DWORD       _getNextItemId();
-    LONGLONG    _getTimeMs();
-    DWORD       _roundInterval(DWORD interval);
 
-private: // data
-    _AnimationDataT     m_animationData;
+private: // UI thread data
+    _UiAnimationT       m_uiAnimations;
     DWORD               m_nextId;
-    DWORD               m_waitInterval;
-    _ThreadTask         m_threadTask;
+    DWORD               m_uiThreadId;
+
+private: // timer thread data
+    std::vector<_PendingPost>   m_pendingPosts;
+
+private: // shared data
+    XWAnimationScheduler*   m_pScheduler;
+    _FrameEventsT       m_frameEvents;      // protected by critical section
+    unsigned long       m_lockWaits;        // protected by critical section
+    LONGLONG            m_perfFrequency;
     HWND                m_eventWindow;
-    HANDLE              m_syncEvent;
-    HANDLE              m_timerThread;
     CRITICAL_SECTION    m_criticalSection;
 };
 
@@ -0,0 +1,53 @@
+// Configuration and include files of platform independent core
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWCORE_CONFIG_H_
+#define _XWCORE_CONFIG_H_
+
+// NOTE: headers included here must not depend on Windows headers, so that object
+//       model, layouts, scroll logic and animation scheduler can be built without
+//       platform API (see tests/build.sh). Platform dependent parts are reached
+//       through interfaces only (e.g. IXWAnimationClock and IXWAnimationSink).
+
+/////////////////////////////////////////////////////////////////////
+// C runtime
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+/////////////////////////////////////////////////////////////////////
+// standard library
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <queue>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <set>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/////////////////////////////////////////////////////////////////////
+// platform independent core
+#include "xwdebug.h"
+#include "xwobjectpool.h"
+#include "xwobjecteventmap.h"
+#include "xwobject.h"
+#include "xwscrollable.h"
+#include "xwscrollviewlogic.h"
+#include "xwfenwicktree.h"
+#include "xwliveresize.h"
+#include "xweasingcurve.h"
+#include "xwspscqueue.h"
+#include "xwanimationscheduler.h"
+
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWCORE_CONFIG_H_
+
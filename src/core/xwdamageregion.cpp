@@ -0,0 +1,240 @@
+// Damaged area accumulator
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "../xwui_config.h"
+
+#include "xwdamageregion.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// default maximum number of rectangles
+#define XWUI_DAMAGE_REGION_MAX_RECTS        8
+
+// default wasted area allowed for merge (percent of covered area)
+#define XWUI_DAMAGE_REGION_MAX_WASTE        50
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static inline LONGLONG _rectArea(const RECT& rect)
+{
+    return (LONGLONG)(rect.right - rect.left) * (LONGLONG)(rect.bottom - rect.top);
+}
+
+static inline void _rectUnion(const RECT& rect1, const RECT& rect2, RECT& rectOut)
+{
+    rectOut.left = (rect1.left < rect2.left) ? rect1.left : rect2.left;
+    rectOut.top = (rect1.top < rect2.top) ? rect1.top : rect2.top;
+    rectOut.right = (rect1.right > rect2.right) ? rect1.right : rect2.right;
+    rectOut.bottom = (rect1.bottom > rect2.bottom) ? rect1.bottom : rect2.bottom;
+}
+
+/////////////////////////////////////////////////////////////////////
+// XWDamageRegion - damaged area accumulator
+
+XWDamageRegion::XWDamageRegion() :
+    m_maxRectCount(XWUI_DAMAGE_REGION_MAX_RECTS),
+    m_maxWastedArea(XWUI_DAMAGE_REGION_MAX_WASTE)
+{
+}
+
+XWDamageRegion::~XWDamageRegion()
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// damaged area
+/////////////////////////////////////////////////////////////////////
+void XWDamageRegion::addRect(const RECT& rect)
+{
+    // ignore empty rectangles
+    if(rect.right <= rect.left || rect.bottom <= rect.top) return;
+
+    // copy rectangle as it may grow while merging
+    RECT rcDamage = rect;
+
+    // merge with existing rectangles while possible
+    while(_mergeRect(rcDamage));
+
+    // add rectangle
+    m_rects.push_back(rcDamage);
+
+    // keep number of rectangles limited
+    _reduceRectCount();
+}
+
+void XWDamageRegion::validateRect(const RECT& rect)
+{
+    // remove rectangles that are fully covered (e.g. painted by WM_PAINT)
+    for(std::vector<RECT>::iterator it = m_rects.begin(); it != m_rects.end();)
+    {
+        if(it->left >= rect.left && it->top >= rect.top && 
+           it->right <= rect.right && it->bottom <= rect.bottom)
+        {
+            // remove
+            it = m_rects.erase(it);
+
+        } else
+        {
+            // next
+            ++it;
+        }
+    }
+}
+
+void XWDamageRegion::scrollRect(const RECT& rcScroll, int offsetX, int offsetY)
+{
+    // ignore if empty
+    if(m_rects.size() == 0) return;
+
+    std::vector<RECT> scrolledRects;
+
+    // NOTE: content inside scrolled area moves together with its damage, original
+    //       rectangle is kept as part of it may be outside of scrolled area
+    for(size_t idx = 0; idx < m_rects.size(); ++idx)
+    {
+        RECT rcDamage;
+
+        // ignore rectangles outside of scrolled area
+        if(!::IntersectRect(&rcDamage, &m_rects[idx], &rcScroll)) continue;
+
+        // move damage and clip it to scrolled area
+        ::OffsetRect(&rcDamage, offsetX, offsetY);
+        if(::IntersectRect(&rcDamage, &rcDamage, &rcScroll))
+        {
+            scrolledRects.push_back(rcDamage);
+        }
+    }
+
+    // add moved damage
+    for(size_t idx = 0; idx < scrolledRects.size(); ++idx)
+    {
+        addRect(scrolledRects[idx]);
+    }
+}
+
+void XWDamageRegion::clear()
+{
+    // NOTE: keep allocated memory as region is reused every frame
+    m_rects.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// properties
+/////////////////////////////////////////////////////////////////////
+void XWDamageRegion::boundingRect(RECT& rectOut) const
+{
+    // reset output
+    ::SetRectEmpty(&rectOut);
+
+    // ignore if empty
+    if(m_rects.size() == 0) return;
+
+    // combine all rectangles
+    rectOut = m_rects.front();
+    for(size_t idx = 1; idx < m_rects.size(); ++idx)
+    {
+        _rectUnion(rectOut, m_rects[idx], rectOut);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// merge options
+/////////////////////////////////////////////////////////////////////
+void XWDamageRegion::setMaxRectCount(int maxCount)
+{
+    XWASSERT(maxCount > 0);
+    if(maxCount <= 0) return;
+
+    m_maxRectCount = maxCount;
+
+    // apply new limit
+    _reduceRectCount();
+}
+
+void XWDamageRegion::setMaxWastedArea(int areaPercent)
+{
+    XWASSERT(areaPercent >= 0);
+    if(areaPercent < 0) return;
+
+    m_maxWastedArea = areaPercent;
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+bool XWDamageRegion::_mergeRect(RECT& rect)
+{
+    for(std::vector<RECT>::iterator it = m_rects.begin(); it != m_rects.end(); ++it)
+    {
+        // area covered by both rectangles
+        RECT rcIntersect;
+        LONGLONG intersectArea = ::IntersectRect(&rcIntersect, &rect, &(*it)) ? _rectArea(rcIntersect) : 0;
+        LONGLONG coveredArea = _rectArea(rect) + _rectArea(*it) - intersectArea;
+
+        // check if bounding box doesn't waste too much area
+        if(_wastedArea(rect, *it) * 100 <= coveredArea * m_maxWastedArea)
+        {
+            // merge
+            _rectUnion(rect, *it, rect);
+
+            // remove merged rectangle
+            m_rects.erase(it);
+
+            // merged rectangle may now overlap with others
+            return true;
+        }
+    }
+
+    // nothing to merge
+    return false;
+}
+
+void XWDamageRegion::_reduceRectCount()
+{
+    // merge rectangles with least wasted area until limit is reached
+    while((int)m_rects.size() > m_maxRectCount)
+    {
+        size_t mergeIdx1 = 0;
+        size_t mergeIdx2 = 1;
+        LONGLONG minWaste = -1;
+
+        // find best pair
+        for(size_t idx1 = 0; idx1 < m_rects.size(); ++idx1)
+        {
+            for(size_t idx2 = idx1 + 1; idx2 < m_rects.size(); ++idx2)
+            {
+                LONGLONG waste = _wastedArea(m_rects[idx1], m_rects[idx2]);
+                if(minWaste < 0 || waste < minWaste)
+                {
+                    minWaste = waste;
+                    mergeIdx1 = idx1;
+                    mergeIdx2 = idx2;
+                }
+            }
+        }
+
+        // merge pair
+        _rectUnion(m_rects[mergeIdx1], m_rects[mergeIdx2], m_rects[mergeIdx1]);
+        m_rects.erase(m_rects.begin() + mergeIdx2);
+    }
+}
+
+LONGLONG XWDamageRegion::_wastedArea(const RECT& rect1, const RECT& rect2) const
+{
+    // bounding box
+    RECT rcUnion;
+    _rectUnion(rect1, rect2, rcUnion);
+
+    // area covered by both rectangles
+    RECT rcIntersect;
+    LONGLONG intersectArea = ::IntersectRect(&rcIntersect, &rect1, &rect2) ? _rectArea(rcIntersect) : 0;
+
+    // area painted without need
+    return _rectArea(rcUnion) - (_rectArea(rect1) + _rectArea(rect2) - intersectArea);
+}
+
+// XWDamageRegion
+/////////////////////////////////////////////////////////////////////
@@ -0,0 +1,53 @@
+// Damaged area accumulator
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWDAMAGEREGION_H_
+#define _XWDAMAGEREGION_H_
+
+// NOTE: damage region collects dirty rectangles reported during one frame and
+//       keeps them merged into a small number of rectangles. Two rectangles are
+//       merged if their bounding box does not waste much more area than they
+//       cover together, so painting merged rectangles never costs much more than
+//       painting original ones while item traversal is done only few times.
+
+/////////////////////////////////////////////////////////////////////
+// XWDamageRegion - damaged area accumulator
+
+class XWDamageRegion
+{
+public: // construction/destruction
+    XWDamageRegion();
+    ~XWDamageRegion();
+
+public: // damaged area
+    void    addRect(const RECT& rect);
+    void    validateRect(const RECT& rect);
+    void    scrollRect(const RECT& rcScroll, int offsetX, int offsetY);
+    void    clear();
+
+public: // properties
+    bool    isEmpty() const     { return m_rects.size() == 0; }
+    int     rectCount() const   { return (int)m_rects.size(); }
+    const RECT& rectAt(int idx) const { return m_rects.at(idx); }
+    void    boundingRect(RECT& rectOut) const;
+
+public: // merge options
+    void    setMaxRectCount(int maxCount);
+    void    setMaxWastedArea(int areaPercent);
+
+private: // worker methods
+    bool    _mergeRect(RECT& rect);
+    void    _reduceRectCount();
+    LONGLONG _wastedArea(const RECT& rect1, const RECT& rect2) const;
+
+private: // data
+    std::vector<RECT>   m_rects;
+    int                 m_maxRectCount;
+    int                 m_maxWastedArea;
+};
+
+// XWDamageRegion
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWDAMAGEREGION_H_
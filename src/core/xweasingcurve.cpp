@@ -0,0 +1,343 @@
+// Easing curves and keyframe tracks for value animations
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwcore_config.h"
+
+#include "xweasingcurve.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// precision used to find cubic-bezier parameter
+#define XWUI_EASING_BEZIER_EPSILON      1e-6f
+
+// maximum number of Newton iterations for cubic-bezier
+#define XWUI_EASING_BEZIER_ITERATIONS   8
+
+// spring is treated as settled when its amplitude drops below 0.1% (ln(1000))
+#define XWUI_EASING_SPRING_SETTLE_LOG   6.9078f
+
+// critically damped spring settles later because of linear term
+#define XWUI_EASING_SPRING_SETTLE_CRIT  9.2334f
+
+/////////////////////////////////////////////////////////////////////
+// XWEasingCurve - easing curve
+
+XWEasingCurve::XWEasingCurve() :
+    m_curveType(eCurveLinear),
+    m_ax(0.0f), m_bx(0.0f), m_cx(0.0f),
+    m_ay(0.0f), m_by(0.0f), m_cy(0.0f),
+    m_springOmega(0.0f),
+    m_springZeta(0.0f),
+    m_springTime(0.0f),
+    m_stepCount(1),
+    m_stepJumpStart(false)
+{
+}
+
+XWEasingCurve::~XWEasingCurve()
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// predefined curves
+/////////////////////////////////////////////////////////////////////
+XWEasingCurve XWEasingCurve::linear()
+{
+    return XWEasingCurve();
+}
+
+XWEasingCurve XWEasingCurve::cubicBezier(float x1, float y1, float x2, float y2)
+{
+    XWEasingCurve curve;
+
+    // NOTE: x must be in 0.0 - 1.0 range so that curve is a function of progress
+    XWASSERT(x1 >= 0.0f && x1 <= 1.0f && x2 >= 0.0f && x2 <= 1.0f);
+    if(x1 < 0.0f || x1 > 1.0f || x2 < 0.0f || x2 > 1.0f) return curve;
+
+    curve.m_curveType = eCurveCubicBezier;
+
+    // polynomial coefficients (end points are fixed at 0,0 and 1,1)
+    curve.m_cx = 3.0f * x1;
+    curve.m_bx = 3.0f * (x2 - x1) - curve.m_cx;
+    curve.m_ax = 1.0f - curve.m_cx - curve.m_bx;
+
+    curve.m_cy = 3.0f * y1;
+    curve.m_by = 3.0f * (y2 - y1) - curve.m_cy;
+    curve.m_ay = 1.0f - curve.m_cy - curve.m_by;
+
+    return curve;
+}
+
+XWEasingCurve XWEasingCurve::ease()
+{
+    return cubicBezier(0.25f, 0.1f, 0.25f, 1.0f);
+}
+
+XWEasingCurve XWEasingCurve::easeIn()
+{
+    return cubicBezier(0.42f, 0.0f, 1.0f, 1.0f);
+}
+
+XWEasingCurve XWEasingCurve::easeOut()
+{
+    return cubicBezier(0.0f, 0.0f, 0.58f, 1.0f);
+}
+
+XWEasingCurve XWEasingCurve::easeInOut()
+{
+    return cubicBezier(0.42f, 0.0f, 0.58f, 1.0f);
+}
+
+XWEasingCurve XWEasingCurve::spring(float stiffness, float damping, float mass)
+{
+    XWEasingCurve curve;
+
+    // NOTE: spring without damping never settles
+    XWASSERT(stiffness > 0.0f && damping > 0.0f && mass > 0.0f);
+    if(stiffness <= 0.0f || damping <= 0.0f || mass <= 0.0f) return curve;
+
+    curve.m_curveType = eCurveSpring;
+
+    // natural frequency and damping ratio
+    curve.m_springOmega = sqrtf(stiffness / mass);
+    curve.m_springZeta = damping / (2.0f * sqrtf(stiffness * mass));
+
+    // time needed for spring to settle
+    if(curve.m_springZeta < 1.0f - 1e-3f)
+    {
+        // under-damped, amplitude decays with zeta * omega
+        curve.m_springTime = XWUI_EASING_SPRING_SETTLE_LOG / (curve.m_springZeta * curve.m_springOmega);
+
+    } else if(curve.m_springZeta > 1.0f + 1e-3f)
+    {
+        // over-damped, slow root decides
+        float slowRoot = curve.m_springOmega * (curve.m_springZeta - sqrtf(curve.m_springZeta * curve.m_springZeta - 1.0f));
+        curve.m_springTime = XWUI_EASING_SPRING_SETTLE_LOG / slowRoot;
+
+    } else
+    {
+        // critically damped
+        curve.m_springZeta = 1.0f;
+        curve.m_springTime = XWUI_EASING_SPRING_SETTLE_CRIT / curve.m_springOmega;
+    }
+
+    return curve;
+}
+
+XWEasingCurve XWEasingCurve::steps(int count, bool jumpStart)
+{
+    XWEasingCurve curve;
+
+    XWASSERT(count > 0);
+    if(count <= 0) return curve;
+
+    curve.m_curveType = eCurveSteps;
+    curve.m_stepCount = count;
+    curve.m_stepJumpStart = jumpStart;
+
+    return curve;
+}
+
+/////////////////////////////////////////////////////////////////////
+// evaluation
+/////////////////////////////////////////////////////////////////////
+float XWEasingCurve::valueAt(float progress) const
+{
+    // curve end points are fixed
+    if(progress <= 0.0f) return (m_curveType == eCurveSteps && m_stepJumpStart) ? _stepsValueAt(0.0f) : 0.0f;
+    if(progress >= 1.0f) return 1.0f;
+
+    // check type
+    if(m_curveType == eCurveCubicBezier)
+        return _bezierValueAt(progress);
+    else if(m_curveType == eCurveSpring)
+        return _springValueAt(progress);
+    else if(m_curveType == eCurveSteps)
+        return _stepsValueAt(progress);
+
+    // linear
+    return progress;
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+float XWEasingCurve::_bezierValueAt(float progress) const
+{
+    float t = progress;
+
+    // find curve parameter for progress with Newton method first
+    for(int idx = 0; idx < XWUI_EASING_BEZIER_ITERATIONS; ++idx)
+    {
+        float x = ((m_ax * t + m_bx) * t + m_cx) * t - progress;
+        if(fabsf(x) < XWUI_EASING_BEZIER_EPSILON) break;
+
+        float dx = (3.0f * m_ax * t + 2.0f * m_bx) * t + m_cx;
+        if(fabsf(dx) < XWUI_EASING_BEZIER_EPSILON)
+        {
+            // NOTE: curve is flat here, use bisection instead
+            t = -1.0f;
+            break;
+        }
+
+        t -= x / dx;
+    }
+
+    // fall back to bisection if Newton method failed
+    if(t < 0.0f || t > 1.0f || fabsf(((m_ax * t + m_bx) * t + m_cx) * t - progress) >= XWUI_EASING_BEZIER_EPSILON)
+    {
+        float t0 = 0.0f;
+        float t1 = 1.0f;
+
+        t = progress;
+        while(t1 - t0 > XWUI_EASING_BEZIER_EPSILON)
+        {
+            float x = ((m_ax * t + m_bx) * t + m_cx) * t;
+            if(fabsf(x - progress) < XWUI_EASING_BEZIER_EPSILON) break;
+
+            // select half
+            if(x < progress)
+                t0 = t;
+            else
+                t1 = t;
+
+            t = (t0 + t1) * 0.5f;
+        }
+    }
+
+    // value for found parameter
+    return ((m_ay * t + m_by) * t + m_cy) * t;
+}
+
+float XWEasingCurve::_springValueAt(float progress) const
+{
+    // spring time
+    float t = progress * m_springTime;
+
+    // NOTE: spring starts at 0 without velocity and settles at 1
+    if(m_springZeta < 1.0f)
+    {
+        // under-damped
+        float omegaD = m_springOmega * sqrtf(1.0f - m_springZeta * m_springZeta);
+        float decay = expf(-m_springZeta * m_springOmega * t);
+
+        return 1.0f - decay * (cosf(omegaD * t) + (m_springZeta * m_springOmega / omegaD) * sinf(omegaD * t));
+
+    } else if(m_springZeta > 1.0f)
+    {
+        // over-damped
+        float root = m_springOmega * sqrtf(m_springZeta * m_springZeta - 1.0f);
+        float r1 = -m_springZeta * m_springOmega + root;
+        float r2 = -m_springZeta * m_springOmega - root;
+
+        return 1.0f - (r2 * expf(r1 * t) - r1 * expf(r2 * t)) / (r2 - r1);
+    }
+
+    // critically damped
+    return 1.0f - expf(-m_springOmega * t) * (1.0f + m_springOmega * t);
+}
+
+float XWEasingCurve::_stepsValueAt(float progress) const
+{
+    // current step
+    int step = (int)floorf(progress * m_stepCount);
+
+    // jump at interval start if needed
+    if(m_stepJumpStart) ++step;
+
+    // keep in range
+    if(step > m_stepCount) step = m_stepCount;
+
+    return (float)step / (float)m_stepCount;
+}
+
+// XWEasingCurve
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XWKeyframeTrack - value keyframes
+
+XWKeyframeTrack::XWKeyframeTrack()
+{
+}
+
+XWKeyframeTrack::~XWKeyframeTrack()
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// keyframes
+/////////////////////////////////////////////////////////////////////
+void XWKeyframeTrack::addKeyframe(float offset, float value, const XWEasingCurve& easing)
+{
+    XWASSERT(offset >= 0.0f && offset <= 1.0f);
+    if(offset < 0.0f || offset > 1.0f) return;
+
+    _Keyframe keyframe;
+
+    // fill keyframe
+    keyframe.offset = offset;
+    keyframe.value = value;
+    keyframe.easing = easing;
+
+    // NOTE: keep keyframes sorted by offset, keyframes with same offset keep insert order
+    std::vector<_Keyframe>::iterator it = m_keyframes.begin();
+    while(it != m_keyframes.end() && it->offset <= offset) ++it;
+
+    m_keyframes.insert(it, keyframe);
+}
+
+void XWKeyframeTrack::clear()
+{
+    m_keyframes.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// evaluation
+/////////////////////////////////////////////////////////////////////
+float XWKeyframeTrack::valueAt(float progress) const
+{
+    // ignore if empty
+    if(m_keyframes.size() == 0) return 0.0f;
+
+    // keep values outside of keyframes
+    if(progress <= m_keyframes.front().offset) return m_keyframes.front().value;
+    if(progress >= m_keyframes.back().offset) return m_keyframes.back().value;
+
+    // find segment end (first keyframe after progress) with binary search
+    size_t first = 0;
+    size_t last = m_keyframes.size() - 1;
+    while(first < last)
+    {
+        size_t middle = (first + last) / 2;
+
+        if(m_keyframes[middle].offset <= progress)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    const _Keyframe& fromKeyframe = m_keyframes[first - 1];
+    const _Keyframe& toKeyframe = m_keyframes[first];
+
+    // segment progress
+    float segmentProgress = (progress - fromKeyframe.offset) / (toKeyframe.offset - fromKeyframe.offset);
+
+    // value for segment
+    return fromKeyframe.value + (toKeyframe.value - fromKeyframe.value) * toKeyframe.easing.valueAt(segmentProgress);
+}
+
+float XWKeyframeTrack::firstValue() const
+{
+    return (m_keyframes.size() != 0) ? m_keyframes.front().value : 0.0f;
+}
+
+float XWKeyframeTrack::lastValue() const
+{
+    return (m_keyframes.size() != 0) ? m_keyframes.back().value : 0.0f;
+}
+
+// XWKeyframeTrack
+/////////////////////////////////////////////////////////////////////
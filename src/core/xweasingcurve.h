@@ -0,0 +1,105 @@
+// Easing curves and keyframe tracks for value animations
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWEASINGCURVE_H_
+#define _XWEASINGCURVE_H_
+
+// NOTE: easing curve maps animation progress (0.0 - 1.0) to value progress. Curve
+//       coefficients are computed once when curve is created, so evaluation cost
+//       doesn't depend on curve parameters. Value progress may go outside of 0.0 - 1.0
+//       range for overshooting curves (e.g. spring or cubic-bezier with y > 1).
+
+/////////////////////////////////////////////////////////////////////
+// XWEasingCurve - easing curve
+
+class XWEasingCurve
+{
+public: // construction/destruction
+    XWEasingCurve();
+    ~XWEasingCurve();
+
+public: // curve types
+    enum TCurveType
+    {
+        eCurveLinear,
+        eCurveCubicBezier,
+        eCurveSpring,
+        eCurveSteps
+    };
+
+public: // predefined curves
+    static XWEasingCurve linear();
+    static XWEasingCurve cubicBezier(float x1, float y1, float x2, float y2);
+    static XWEasingCurve ease();
+    static XWEasingCurve easeIn();
+    static XWEasingCurve easeOut();
+    static XWEasingCurve easeInOut();
+    static XWEasingCurve spring(float stiffness, float damping, float mass = 1.0f);
+    static XWEasingCurve steps(int count, bool jumpStart = false);
+
+public: // evaluation
+    float   valueAt(float progress) const;
+    TCurveType  curveType() const { return m_curveType; }
+
+private: // worker methods
+    float   _bezierValueAt(float progress) const;
+    float   _springValueAt(float progress) const;
+    float   _stepsValueAt(float progress) const;
+
+private: // data
+    TCurveType      m_curveType;
+
+    // cubic-bezier polynomial coefficients
+    float           m_ax, m_bx, m_cx;
+    float           m_ay, m_by, m_cy;
+
+    // spring parameters (time is scaled so that spring settles at 1.0)
+    float           m_springOmega;
+    float           m_springZeta;
+    float           m_springTime;
+
+    // steps parameters
+    int             m_stepCount;
+    bool            m_stepJumpStart;
+};
+
+// XWEasingCurve
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XWKeyframeTrack - value keyframes
+
+class XWKeyframeTrack
+{
+public: // construction/destruction
+    XWKeyframeTrack();
+    ~XWKeyframeTrack();
+
+public: // keyframes (easing is used for segment that ends at keyframe)
+    void    addKeyframe(float offset, float value, const XWEasingCurve& easing = XWEasingCurve::linear());
+    void    clear();
+    bool    isEmpty() const     { return m_keyframes.size() == 0; }
+    int     keyframeCount() const { return (int)m_keyframes.size(); }
+
+public: // evaluation
+    float   valueAt(float progress) const;
+    float   firstValue() const;
+    float   lastValue() const;
+
+private: // types
+    struct _Keyframe
+    {
+        float           offset;
+        float           value;
+        XWEasingCurve   easing;
+    };
+
+private: // data
+    std::vector<_Keyframe>  m_keyframes;
+};
+
+// XWKeyframeTrack
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWEASINGCURVE_H_
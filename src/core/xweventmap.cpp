@@ -166,7 +166,9 @@ bool XWEventMask::sMatchEvent(const XWEvent& xwEvent, const XWEventMask& mask)
 
 /////////////////////////////////////////////////////////////////////
 // XWEventMap - event map
-XWEventMap::XWEventMap()
+XWEventMap::XWEventMap() :
+    m_bDispatchDirty(false),
+    m_nDispatchDepth(0)
 {
 }
 
@@ -184,48 +186,73 @@ void XWEventMap::addEventHandler(const XWEventMask& mask, const XWEventDelegate&
     ref.xwEventMask = mask;
     ref.xwEventHandler = handler;
 
-    // check if we have this handler already
-    std::map<UINT, _HandlerRefVect>::iterator it = m_vEventHandlers.find(mask.m_uMsg);
-    if(it != m_vEventHandlers.end())
-    {
-        // add one more handler
-        it->second.push_back(ref);
-
-    } else
-    {
-        // add new vector
-        _HandlerRefVect vect;
-        vect.push_back(ref);
+    // add handler
+    m_vEventHandlers.push_back(ref);
 
-        // add to map
-        m_vEventHandlers.insert(std::map<UINT, _HandlerRefVect>::value_type(mask.m_uMsg, vect));
-    }
+    // mark dispatch table as outdated
+    m_bDispatchDirty = true;
 }
 
 void XWEventMap::removeEventHandlers(const XWEventMask& mask)
 {
-    // check if we have this handler at all
-    std::map<UINT, _HandlerRefVect>::iterator it = m_vEventHandlers.find(mask.m_uMsg);
-    if(it != m_vEventHandlers.end())
+    // loop over all handlers
+    _HandlerRefVect::iterator href = m_vEventHandlers.begin();
+    while(href != m_vEventHandlers.end())
     {
-        // loop over all handlers
-        _HandlerRefVect::iterator href = it->second.begin();
-        while(href != it->second.end())
+        // compare masks
+        if(href->xwEventMask == mask)
         {
-            // compare masks
-            if(href->xwEventMask == mask)
-            {
-                // remove handler
-                href = it->second.erase(href);
+            // remove handler
+            href = m_vEventHandlers.erase(href);
 
-            } else
-            {
-                ++href;
-            }
+            // mark dispatch table as outdated
+            m_bDispatchDirty = true;
+
+        } else
+        {
+            ++href;
         }
     }
 }
 
+/////////////////////////////////////////////////////////////////////
+// dispatch events
+/////////////////////////////////////////////////////////////////////
+LRESULT XWEventMap::dispatchEvent(const XWEvent& xwEvent, const bool& bHandled)
+{
+    // NOTE: table is not changed while any dispatch is running, as handlers are called in place
+    if(m_bDispatchDirty && m_nDispatchDepth == 0) _rebuildDispatchTable();
+
+    // check if we have any handlers for this message
+    const _MessageRange* range = _findRange(xwEvent.uMsg);
+    if(range == 0) return 0;
+
+    // mark dispatch (nested dispatch will not rebuild table)
+    ++m_nDispatchDepth;
+
+    // process all handlers
+    LRESULT retVal = 0;
+    for(unsigned int idx = range->first; idx < range->first + range->count; ++idx)
+    {
+        const _DispatchEntry& entry = m_vDispatchEntries[idx];
+
+        // match event with mask
+        if(!_matchEntry(entry, xwEvent)) continue;
+
+        // call handler
+        retVal = entry.xwEventHandler(xwEvent);
+
+        // block other handlers if message has been processed
+        if(bHandled) break;
+    }
+
+    // dispatch done
+    --m_nDispatchDepth;
+
+    // if message is not marked as processed return value will be ignored anyway
+    return bHandled ? retVal : 0;
+}
+
 /////////////////////////////////////////////////////////////////////
 // find handlers for events
 /////////////////////////////////////////////////////////////////////
@@ -233,27 +260,150 @@ std::vector<XWEventDelegate> XWEventMap::findHandlers(const XWEvent& xwEvent)
 {
     std::vector<XWEventDelegate> result;
 
-    // check if we have this handler at all
-    std::map<UINT, _HandlerRefVect>::iterator it = m_vEventHandlers.find(xwEvent.uMsg);
-    if(it != m_vEventHandlers.end())
+    // NOTE: table can't be rebuilt while dispatch is running, handlers list is 
+    //       scanned then, so handlers added by running handler are found too
+    if(m_bDispatchDirty && m_nDispatchDepth != 0)
     {
-        // get handlers
-        _HandlerRefVect& handlers = it->second;
-
-        // loop over all handlers
-        for(unsigned int idx = 0; idx < handlers.size(); ++idx)
+        for(unsigned int idx = 0; idx < m_vEventHandlers.size(); ++idx)
         {
-            // math event with mask
-            if(handlers.at(idx).xwEventMask.matchEvent(xwEvent))
+            const _HandlerRef& ref = m_vEventHandlers[idx];
+
+            // match event with mask
+            if(ref.xwEventMask.m_uMsg == xwEvent.uMsg && XWEventMask::sMatchEvent(xwEvent, ref.xwEventMask))
             {
                 // add handler
-                result.push_back(handlers.at(idx).xwEventHandler);
+                result.push_back(ref.xwEventHandler);
             }
         }
+
+        return result;
+    }
+
+    // update table if needed
+    if(m_bDispatchDirty) _rebuildDispatchTable();
+
+    // check if we have any handlers for this message
+    const _MessageRange* range = _findRange(xwEvent.uMsg);
+    if(range == 0) return result;
+
+    // collect matching handlers from message range only
+    for(unsigned int idx = range->first; idx < range->first + range->count; ++idx)
+    {
+        const _DispatchEntry& entry = m_vDispatchEntries[idx];
+
+        if(_matchEntry(entry, xwEvent)) result.push_back(entry.xwEventHandler);
     }
 
     return result;
 }
 
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XWEventMap::_rebuildDispatchTable()
+{
+    // NOTE: vectors keep allocated memory
+    m_vDispatchEntries.clear();
+    m_vDispatchRanges.clear();
+
+    std::vector<UINT> messages;
+
+    // collect messages with handlers
+    for(unsigned int idx = 0; idx < m_vEventHandlers.size(); ++idx)
+    {
+        // ignore empty masks, they never match
+        if(m_vEventHandlers[idx].xwEventMask.m_uFlags == 0) continue;
+
+        messages.push_back(m_vEventHandlers[idx].xwEventMask.m_uMsg);
+    }
+
+    // sort messages and remove duplicates
+    std::sort(messages.begin(), messages.end());
+    messages.erase(std::unique(messages.begin(), messages.end()), messages.end());
+
+    // fill entries message by message, keeping order handlers have been added
+    for(unsigned int msgIdx = 0; msgIdx < messages.size(); ++msgIdx)
+    {
+        _MessageRange range;
+        range.uMsg = messages[msgIdx];
+        range.first = (unsigned int)m_vDispatchEntries.size();
+
+        for(unsigned int idx = 0; idx < m_vEventHandlers.size(); ++idx)
+        {
+            const _HandlerRef& ref = m_vEventHandlers[idx];
+            const XWEventMask& mask = ref.xwEventMask;
+
+            // check message
+            if(mask.m_uFlags == 0 || mask.m_uMsg != range.uMsg) continue;
+
+            _DispatchEntry entry;
+
+            // handler
+            entry.xwEventHandler = ref.xwEventHandler;
+
+            // window
+            entry.bCheckWindow = ((mask.m_uFlags & XWEventMask::eWindowHandle) != 0);
+            entry.hWnd = entry.bCheckWindow ? mask.m_hWnd : 0;
+
+            // convert parameter words to bit masks
+            entry.wParamBits = 0;
+            entry.lParamBits = 0;
+            if(mask.m_uFlags & XWEventMask::eLoWordWParam) entry.wParamBits |= (WPARAM)0x0000FFFF;
+            if(mask.m_uFlags & XWEventMask::eHiWordWParam) entry.wParamBits |= (WPARAM)0xFFFF0000;
+            if(mask.m_uFlags & XWEventMask::eLoWordLParam) entry.lParamBits |= (LPARAM)0x0000FFFF;
+            if(mask.m_uFlags & XWEventMask::eHiWordLParam) entry.lParamBits |= (LPARAM)0xFFFF0000;
+
+            entry.wParamValue = mask.m_wParam & entry.wParamBits;
+            entry.lParamValue = mask.m_lParam & entry.lParamBits;
+            entry.bCheckParams = (entry.wParamBits != 0 || entry.lParamBits != 0);
+
+            // NOTE: message is not checked, range is found by message id already
+            m_vDispatchEntries.push_back(entry);
+        }
+
+        range.count = (unsigned int)m_vDispatchEntries.size() - range.first;
+
+        // add range
+        m_vDispatchRanges.push_back(range);
+    }
+
+    // reset flag
+    m_bDispatchDirty = false;
+}
+
+const XWEventMap::_MessageRange* XWEventMap::_findRange(UINT uMsg) const
+{
+    // binary search
+    size_t first = 0;
+    size_t last = m_vDispatchRanges.size();
+    while(first < last)
+    {
+        size_t middle = (first + last) / 2;
+
+        if(m_vDispatchRanges[middle].uMsg < uMsg)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    // check if found
+    if(first == m_vDispatchRanges.size() || m_vDispatchRanges[first].uMsg != uMsg) return 0;
+
+    return &m_vDispatchRanges[first];
+}
+
+bool XWEventMap::_matchEntry(const _DispatchEntry& entry, const XWEvent& xwEvent)
+{
+    // window
+    if(entry.bCheckWindow && entry.hWnd != xwEvent.hWnd) return false;
+
+    // parameters
+    if(entry.bCheckParams &&
+       ((xwEvent.wParam & entry.wParamBits) != entry.wParamValue ||
+        (xwEvent.lParam & entry.lParamBits) != entry.lParamValue)) return false;
+
+    return true;
+}
+
 // XWEventMap
 /////////////////////////////////////////////////////////////////////
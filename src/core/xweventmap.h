@@ -144,6 +144,15 @@ private: // data
 /////////////////////////////////////////////////////////////////////
 // XWEventMap - event map
 
+// NOTE: handlers are dispatched from flat table sorted by message id, table is
+//       rebuilt only when handlers change. Handlers for message are called in place 
+//       in order they have been added, without copying. Mask values are converted to 
+//       bit masks when table is built, so matching doesn't check each flag separately.
+
+// NOTE: handlers may be added or removed while event is dispatched, table is rebuilt
+//       once no dispatch is running. Dispatch that is already running calls the same
+//       handlers it has started with.
+
 class XWEventMap
 {
 public: // construction/destruction
@@ -154,6 +163,9 @@ public: // add handlers
     void    addEventHandler(const XWEventMask& mask, const XWEventDelegate& handler);
     void    removeEventHandlers(const XWEventMask& mask);
 
+public: // dispatch events (stops once handled flag is set by handler)
+    LRESULT dispatchEvent(const XWEvent& xwEvent, const bool& bHandled);
+
 public: // find handlers for events
     std::vector<XWEventDelegate>    findHandlers(const XWEvent& xwEvent);
 
@@ -164,11 +176,43 @@ private: // handler data
         XWEventDelegate xwEventHandler;
     };
 
+    // handler with precomputed mask
+    struct _DispatchEntry
+    {
+        XWEventDelegate xwEventHandler;
+        HWND            hWnd;
+        WPARAM          wParamBits;
+        WPARAM          wParamValue;
+        LPARAM          lParamBits;
+        LPARAM          lParamValue;
+        bool            bCheckWindow;
+        bool            bCheckParams;
+    };
+
+    // handlers of single message in dispatch table
+    struct _MessageRange
+    {
+        UINT            uMsg;
+        unsigned int    first;
+        unsigned int    count;
+    };
+
 private: // types
     typedef std::vector<_HandlerRef>            _HandlerRefVect;
+    typedef std::vector<_DispatchEntry>         _DispatchEntryVect;
+    typedef std::vector<_MessageRange>          _MessageRangeVect;
+
+private: // worker methods
+    void                    _rebuildDispatchTable();
+    const _MessageRange*    _findRange(UINT uMsg) const;
+    static bool             _matchEntry(const _DispatchEntry& entry, const XWEvent& xwEvent);
 
 private: // data
-    std::map<UINT, _HandlerRefVect>              m_vEventHandlers;
+    _HandlerRefVect             m_vEventHandlers;
+    _DispatchEntryVect          m_vDispatchEntries;
+    _MessageRangeVect           m_vDispatchRanges;
+    bool                        m_bDispatchDirty;
+    int                         m_nDispatchDepth;
 };
 
 // XWEventMap
@@ -0,0 +1,194 @@
+// Prefix sum tree for item offsets
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwcore_config.h"
+
+#include "xwfenwicktree.h"
+
+/////////////////////////////////////////////////////////////////////
+// XWFenwickTree - prefix sum tree
+
+XWFenwickTree::XWFenwickTree() :
+    m_topStep(0)
+{
+}
+
+XWFenwickTree::~XWFenwickTree()
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// values
+/////////////////////////////////////////////////////////////////////
+void XWFenwickTree::reset(int count, int value)
+{
+    // check input
+    XWASSERT(count >= 0);
+    XWASSERT(value >= 0);
+    if(count < 0 || value < 0) return;
+
+    // copy values
+    m_values.assign(count, value);
+
+    // build tree
+    _buildTree();
+}
+
+void XWFenwickTree::assign(const std::vector<int>& values)
+{
+    // copy values
+    m_values = values;
+
+    // build tree
+    _buildTree();
+}
+
+void XWFenwickTree::clear()
+{
+    // reset data
+    m_values.clear();
+    m_tree.clear();
+    m_topStep = 0;
+}
+
+void XWFenwickTree::setValue(int idx, int value)
+{
+    // check input
+    XWASSERT(idx >= 0 && idx < count());
+    XWASSERT(value >= 0);
+    if(idx < 0 || idx >= count() || value < 0) return;
+
+    // difference
+    int delta = value - m_values[idx];
+    if(delta == 0) return;
+
+    // copy value
+    m_values[idx] = value;
+
+    // update tree
+    for(int treeIdx = idx + 1; treeIdx <= count(); treeIdx += (treeIdx & (-treeIdx)))
+    {
+        m_tree[treeIdx] += delta;
+    }
+}
+
+void XWFenwickTree::appendValue(int value)
+{
+    // check input
+    XWASSERT(value >= 0);
+    if(value < 0) return;
+
+    // NOTE: new tree node keeps sum of values in its range, which ends with new value
+    int treeIdx = count() + 1;
+    int treeValue = value + prefixSum(count()) - prefixSum(treeIdx - (treeIdx & (-treeIdx)));
+
+    // copy value
+    m_values.push_back(value);
+
+    // add tree node (element 0 is not used)
+    if(m_tree.empty()) m_tree.push_back(0);
+    m_tree.push_back(treeValue);
+
+    // update search step
+    if(m_topStep == 0)
+        m_topStep = 1;
+    else if((m_topStep << 1) <= count())
+        m_topStep <<= 1;
+}
+
+void XWFenwickTree::removeLastValue()
+{
+    // check if there is value to remove
+    XWASSERT(count() > 0);
+    if(count() == 0) return;
+
+    // NOTE: last tree node is the only one which covers last value
+    m_values.pop_back();
+    m_tree.pop_back();
+
+    // update search step
+    if(count() == 0)
+    {
+        m_tree.clear();
+        m_topStep = 0;
+
+    } else if(m_topStep > count())
+    {
+        m_topStep >>= 1;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// sums
+/////////////////////////////////////////////////////////////////////
+int XWFenwickTree::prefixSum(int idx) const
+{
+    // NOTE: returns sum of values before idx
+
+    // check input
+    XWASSERT(idx >= 0 && idx <= count());
+    if(idx <= 0) return 0;
+    if(idx > count()) idx = count();
+
+    int sum = 0;
+
+    // sum tree nodes
+    for(int treeIdx = idx; treeIdx > 0; treeIdx -= (treeIdx & (-treeIdx)))
+    {
+        sum += m_tree[treeIdx];
+    }
+
+    return sum;
+}
+
+int XWFenwickTree::findIndex(int offset) const
+{
+    // NOTE: returns index of value covering offset, which is number of values 
+    //       with prefix sum not above offset (count() if offset is after the end)
+
+    // ignore negative offsets
+    if(offset < 0) return 0;
+
+    int idx = 0;
+
+    // descend tree
+    for(int step = m_topStep; step > 0; step >>= 1)
+    {
+        if(idx + step <= count() && m_tree[idx + step] <= offset)
+        {
+            idx += step;
+            offset -= m_tree[idx];
+        }
+    }
+
+    return idx;
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XWFenwickTree::_buildTree()
+{
+    int count = (int)m_values.size();
+
+    // NOTE: tree is 1-based, element 0 is not used
+    m_tree.assign(count + 1, 0);
+
+    // build tree in linear time
+    for(int idx = 1; idx <= count; ++idx)
+    {
+        XWASSERT(m_values[idx - 1] >= 0);
+        m_tree[idx] += m_values[idx - 1];
+
+        int parentIdx = idx + (idx & (-idx));
+        if(parentIdx <= count) m_tree[parentIdx] += m_tree[idx];
+    }
+
+    // largest power of two not above count (used for search)
+    for(m_topStep = 1; (m_topStep << 1) <= count; m_topStep <<= 1);
+    if(count == 0) m_topStep = 0;
+}
+
+// XWFenwickTree
+/////////////////////////////////////////////////////////////////////
@@ -0,0 +1,48 @@
+// Prefix sum tree for item offsets
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWFENWICKTREE_H_
+#define _XWFENWICKTREE_H_
+
+// NOTE: Fenwick (binary indexed) tree keeps prefix sums of item sizes, so item 
+//       offset and item at offset can be found in O(log n) even if single item
+//       size changes. Values must not be negative.
+
+/////////////////////////////////////////////////////////////////////
+// XWFenwickTree - prefix sum tree
+
+class XWFenwickTree
+{
+public: // construction/destruction
+    XWFenwickTree();
+    ~XWFenwickTree();
+
+public: // values
+    void    reset(int count, int value);
+    void    assign(const std::vector<int>& values);
+    void    clear();
+    void    setValue(int idx, int value);
+    void    appendValue(int value);
+    void    removeLastValue();
+    int     value(int idx) const    { return m_values.at(idx); }
+    int     count() const           { return (int)m_values.size(); }
+
+public: // sums
+    int     prefixSum(int idx) const;
+    int     totalSum() const        { return prefixSum(count()); }
+    int     findIndex(int offset) const;
+
+private: // worker methods
+    void    _buildTree();
+
+private: // data
+    std::vector<int>    m_values;
+    std::vector<int>    m_tree;
+    int                 m_topStep;
+};
+
+// XWFenwickTree
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWFENWICKTREE_H_
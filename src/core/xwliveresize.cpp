@@ -0,0 +1,175 @@
+// Live resize state and frame throttle for interactive resizing
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwcore_config.h"
+
+#include "xwliveresize.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// timer tick may come earlier than frame interval (system timer resolution)
+#define XWUI_FRAME_THROTTLE_SLACK_MS    4
+
+/////////////////////////////////////////////////////////////////////
+// XWLiveResizeState - live resize snapshot state of window
+
+XWLiveResizeState::XWLiveResizeState() :
+    m_active(false),
+    m_resizePending(false),
+    m_deferredResizes(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// live resize
+/////////////////////////////////////////////////////////////////////
+bool XWLiveResizeState::begin(bool snapshotReady)
+{
+    // ignore if active already
+    if(m_active) return false;
+
+    // NOTE: window is resized as usual if there is no snapshot to show
+    if(!snapshotReady) return false;
+
+    m_active = true;
+    m_resizePending = false;
+
+    return true;
+}
+
+bool XWLiveResizeState::end()
+{
+    // ignore if not active
+    if(!m_active) return false;
+
+    m_active = false;
+
+    // delayed resize has to be done now
+    bool resizePending = m_resizePending;
+    m_resizePending = false;
+
+    return resizePending;
+}
+
+void XWLiveResizeState::reset()
+{
+    m_active = false;
+    m_resizePending = false;
+}
+
+/////////////////////////////////////////////////////////////////////
+// window resize
+/////////////////////////////////////////////////////////////////////
+bool XWLiveResizeState::deferResize()
+{
+    // resize as usual if snapshot is not shown
+    if(!m_active) return false;
+
+    m_resizePending = true;
+    m_deferredResizes++;
+
+    return true;
+}
+
+// XWLiveResizeState
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XWFrameThrottle - coalesces values to frames
+
+XWFrameThrottle::XWFrameThrottle(unsigned int frameMs) :
+    m_frameMs(frameMs),
+    m_lastFrameMs(0),
+    m_value(0),
+    m_appliedValue(0),
+    m_active(false),
+    m_updates(0),
+    m_frames(0)
+{
+    XWASSERT(frameMs > 0);
+}
+
+/////////////////////////////////////////////////////////////////////
+// session
+/////////////////////////////////////////////////////////////////////
+void XWFrameThrottle::begin(int value, long long nowMs)
+{
+    m_active = true;
+
+    // start from current value, first update is applied at once
+    m_value = value;
+    m_appliedValue = value;
+    m_lastFrameMs = nowMs - m_frameMs;
+
+    // reset statistics
+    m_updates = 0;
+    m_frames = 0;
+}
+
+bool XWFrameThrottle::end(int& valueOut)
+{
+    // ignore if not active
+    if(!m_active) return false;
+
+    m_active = false;
+
+    // apply last value if not done yet
+    valueOut = m_value;
+    if(m_value == m_appliedValue) return false;
+
+    m_appliedValue = m_value;
+    m_frames++;
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// values
+/////////////////////////////////////////////////////////////////////
+bool XWFrameThrottle::update(int value, long long nowMs, int& valueOut)
+{
+    // ignore if not active
+    if(!m_active) return false;
+
+    m_value = value;
+    m_updates++;
+
+    // NOTE: value is applied at once only if whole frame has passed, otherwise by next frame
+    if(!_isFrameDue(nowMs, 0)) return false;
+
+    return _takeValue(nowMs, valueOut);
+}
+
+bool XWFrameThrottle::frame(long long nowMs, int& valueOut)
+{
+    // ignore if not active or frame is not due yet (timer tick may come a bit early)
+    if(!m_active || !_isFrameDue(nowMs, XWUI_FRAME_THROTTLE_SLACK_MS)) return false;
+
+    return _takeValue(nowMs, valueOut);
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+bool XWFrameThrottle::_isFrameDue(long long nowMs, unsigned int slackMs) const
+{
+    return (nowMs - m_lastFrameMs + slackMs >= (long long)m_frameMs);
+}
+
+bool XWFrameThrottle::_takeValue(long long nowMs, int& valueOut)
+{
+    // ignore if there are no changes since last frame
+    if(m_value == m_appliedValue) return false;
+
+    m_appliedValue = m_value;
+    m_lastFrameMs = nowMs;
+    m_frames++;
+
+    valueOut = m_value;
+    return true;
+}
+
+// XWFrameThrottle
+/////////////////////////////////////////////////////////////////////
@@ -0,0 +1,90 @@
+// Live resize state and frame throttle for interactive resizing
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWLIVERESIZE_H_
+#define _XWLIVERESIZE_H_
+
+// NOTE: window in live resize shows snapshot of its content and delays content
+//       resize until live resize ends. If snapshot could not be captured window is
+//       resized as usual (fallback). Window defines how snapshot is captured and
+//       shown, only state is kept here (see XWindow::beginLiveResizeSnapshot).
+
+// NOTE: frame throttle coalesces values (e.g. splitter position from mouse moves)
+//       and lets them be applied once per frame. First value after idle frame is
+//       applied at once, following values are applied by frame timer or by first
+//       value after frame interval. Timer ticks are accepted with small slack as
+//       system timer resolution is about 15 ms.
+
+/////////////////////////////////////////////////////////////////////
+// XWLiveResizeState - live resize snapshot state of window
+
+class XWLiveResizeState
+{
+public: // construction/destruction
+    XWLiveResizeState();
+
+public: // live resize (begin returns false if snapshot is not ready, resize as usual then)
+    bool    begin(bool snapshotReady);
+    bool    end();
+    void    reset();
+    bool    isActive() const        { return m_active; }
+
+public: // window resize (returns true if content resize is delayed)
+    bool    deferResize();
+
+public: // statistics
+    unsigned long   deferredResizes() const { return m_deferredResizes; }
+
+private: // data
+    bool            m_active;
+    bool            m_resizePending;
+    unsigned long   m_deferredResizes;
+};
+
+// XWLiveResizeState
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XWFrameThrottle - coalesces values to frames
+
+class XWFrameThrottle
+{
+public: // construction/destruction
+    XWFrameThrottle(unsigned int frameMs);
+
+public: // session (end returns true if last value has not been applied yet)
+    void    begin(int value, long long nowMs);
+    bool    end(int& valueOut);
+    bool    isActive() const        { return m_active; }
+
+public: // values (methods return true if value has to be applied now)
+    bool    update(int value, long long nowMs, int& valueOut);
+    bool    frame(long long nowMs, int& valueOut);
+
+public: // properties
+    unsigned int    frameMs() const { return m_frameMs; }
+    int             value() const   { return m_value; }
+
+public: // statistics
+    unsigned long   updates() const { return m_updates; }
+    unsigned long   frames() const  { return m_frames; }
+
+private: // worker methods
+    bool    _isFrameDue(long long nowMs, unsigned int slackMs) const;
+    bool    _takeValue(long long nowMs, int& valueOut);
+
+private: // data
+    unsigned int    m_frameMs;
+    long long       m_lastFrameMs;
+    int             m_value;
+    int             m_appliedValue;
+    bool            m_active;
+    unsigned long   m_updates;
+    unsigned long   m_frames;
+};
+
+// XWFrameThrottle
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWLIVERESIZE_H_
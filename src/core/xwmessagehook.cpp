@@ -7,12 +7,253 @@
 #include "xwmessagehook.h"
 
 /////////////////////////////////////////////////////////////////////
-// message hooks
-static std::list<IXWMessageHook*>*      s_pXWMessageHooks = 0;
+// constants
+
+// NOTE: message ids above 0xFFFF are reserved by system, such messages are
+//       passed only to hooks for all messages and are not counted
+#define XWUI_MESSAGE_HOOK_MAX_MESSAGE       0xFFFF
+
+// hook list for messages outside of filter ranges
+#define XWUI_MESSAGE_HOOK_DEFAULT_LIST      0
+
+/////////////////////////////////////////////////////////////////////
+// message hook registry
+
+// registered hook
+struct _XWMessageHookEntry
+{
+    IXWMessageHook*         hook;           // reset if hook has been removed while dispatching
+    unsigned long           hookId;
+    XWMessageHookFilter     filter;
+};
+
+// hooks called for message (indexes in list items)
+struct _XWMessageHookList
+{
+    size_t  first;
+    size_t  count;
+};
+
+// message counters
+struct _XWMessageHookCounter
+{
+    unsigned long   invocations;
+    unsigned long   consumed;
+};
+
+struct _XWMessageHookRegistry
+{
+    // registered hooks in order they have been added
+    std::vector<_XWMessageHookEntry>    entries;
+
+    // hook lists (list items are indexes in entries, last added hook first)
+    std::vector<_XWMessageHookList>     lists;
+    std::vector<size_t>                 listItems;
+
+    // hook list index by message id
+    std::vector<unsigned short>         messageTable;
+
+    // counters by message id
+    std::vector<_XWMessageHookCounter>  counters;
+
+    // state
+    bool                                dirty;
+    unsigned int                        dispatchDepth;
+
+    // constructor
+    _XWMessageHookRegistry() : dirty(true), dispatchDepth(0) {}
+};
+
+static _XWMessageHookRegistry*      s_pXWMessageHooks = 0;
+
+/////////////////////////////////////////////////////////////////////
+// XWMessageHookFilter - messages hook is called for
+/////////////////////////////////////////////////////////////////////
+void XWMessageHookFilter::addRange(UINT firstMessage, UINT lastMessage)
+{
+    XWASSERT(firstMessage <= lastMessage);
+    if(firstMessage > lastMessage) return;
+
+    // ignore messages reserved by system
+    if(firstMessage > XWUI_MESSAGE_HOOK_MAX_MESSAGE) return;
+    if(lastMessage > XWUI_MESSAGE_HOOK_MAX_MESSAGE) lastMessage = XWUI_MESSAGE_HOOK_MAX_MESSAGE;
+
+    XWMessageRange range;
+    range.firstMessage = firstMessage;
+    range.lastMessage = lastMessage;
+
+    m_vRanges.push_back(range);
+}
+
+bool XWMessageHookFilter::hasMessage(UINT message) const
+{
+    if(m_bAllMessages) return true;
+
+    // check ranges
+    for(size_t idx = 0; idx < m_vRanges.size(); ++idx)
+    {
+        if(message >= m_vRanges[idx].firstMessage && message <= m_vRanges[idx].lastMessage) return true;
+    }
+
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////
+// registry worker methods
+/////////////////////////////////////////////////////////////////////
+static bool _xwmessagehookSameList(const _XWMessageHookRegistry& registry, size_t listIdx, const std::vector<size_t>& items)
+{
+    const _XWMessageHookList& hookList = registry.lists[listIdx];
+
+    // compare hooks
+    if(hookList.count != items.size()) return false;
+
+    for(size_t idx = 0; idx < items.size(); ++idx)
+    {
+        if(registry.listItems[hookList.first + idx] != items[idx]) return false;
+    }
+
+    return true;
+}
+
+static unsigned short _xwmessagehookAddList(_XWMessageHookRegistry& registry, UINT message, bool defaultList)
+{
+    std::vector<size_t> items;
+
+    // collect hooks for message, last added hook first
+    for(size_t idx = registry.entries.size(); idx > 0; --idx)
+    {
+        const XWMessageHookFilter& filter = registry.entries[idx - 1].filter;
+
+        if(defaultList ? filter.isAllMessages() : filter.hasMessage(message)) items.push_back(idx - 1);
+    }
+
+    // reuse default or last list if the same
+    if(!registry.lists.empty())
+    {
+        if(_xwmessagehookSameList(registry, XWUI_MESSAGE_HOOK_DEFAULT_LIST, items)) return XWUI_MESSAGE_HOOK_DEFAULT_LIST;
+        if(_xwmessagehookSameList(registry, registry.lists.size() - 1, items)) return (unsigned short)(registry.lists.size() - 1);
+    }
+
+    // NOTE: each range adds at most two lists, so table index never overflows in practice
+    XWASSERT(registry.lists.size() < USHRT_MAX);
+
+    // add list
+    _XWMessageHookList hookList;
+    hookList.first = registry.listItems.size();
+    hookList.count = items.size();
+
+    registry.listItems.insert(registry.listItems.end(), items.begin(), items.end());
+    registry.lists.push_back(hookList);
+
+    return (unsigned short)(registry.lists.size() - 1);
+}
+
+static void _xwmessagehookRebuild(_XWMessageHookRegistry& registry)
+{
+    // remove hooks deleted while dispatching
+    size_t entryCount = 0;
+    for(size_t idx = 0; idx < registry.entries.size(); ++idx)
+    {
+        if(registry.entries[idx].hook == 0) continue;
+
+        if(entryCount != idx) registry.entries[entryCount] = registry.entries[idx];
+        entryCount++;
+    }
+
+    registry.entries.resize(entryCount);
+
+    // NOTE: hook list doesn't change between range boundaries, so lists are built
+    //       only once per boundary and table entries are filled for whole segment
+    std::vector<UINT> boundaries;
+    size_t tableSize = 0;
+
+    for(size_t idx = 0; idx < registry.entries.size(); ++idx)
+    {
+        const XWMessageHookFilter& filter = registry.entries[idx].filter;
+        if(filter.isAllMessages()) continue;
+
+        for(size_t rangeIdx = 0; rangeIdx < filter.ranges().size(); ++rangeIdx)
+        {
+            const XWMessageHookFilter::XWMessageRange& range = filter.ranges()[rangeIdx];
+
+            boundaries.push_back(range.firstMessage);
+            boundaries.push_back(range.lastMessage + 1);
+
+            if(range.lastMessage + 1 > tableSize) tableSize = range.lastMessage + 1;
+        }
+    }
+
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    // reset lists
+    registry.lists.clear();
+    registry.listItems.clear();
+    registry.messageTable.assign(tableSize, XWUI_MESSAGE_HOOK_DEFAULT_LIST);
+
+    // list for messages without ranges
+    _xwmessagehookAddList(registry, 0, true);
+
+    // fill table segments
+    for(size_t idx = 0; idx + 1 < boundaries.size(); ++idx)
+    {
+        unsigned short listIdx = _xwmessagehookAddList(registry, boundaries[idx], false);
+
+        for(UINT message = boundaries[idx]; message < boundaries[idx + 1]; ++message)
+        {
+            registry.messageTable[message] = listIdx;
+        }
+    }
+
+    registry.dirty = false;
+}
+
+static void _xwmessagehookFreeIfEmpty()
+{
+    // NOTE: registry is in use while dispatching, it is freed once dispatch ends
+    if(s_pXWMessageHooks == 0 || s_pXWMessageHooks->dispatchDepth > 0) return;
+
+    // check for hooks not removed yet
+    for(size_t idx = 0; idx < s_pXWMessageHooks->entries.size(); ++idx)
+    {
+        if(s_pXWMessageHooks->entries[idx].hook) return;
+    }
+
+    delete s_pXWMessageHooks;
+    s_pXWMessageHooks = 0;
+}
+
+static void _xwmessagehookCount(_XWMessageHookRegistry& registry, UINT message, unsigned long invocations, bool consumed)
+{
+    // ignore messages reserved by system
+    if(message > XWUI_MESSAGE_HOOK_MAX_MESSAGE) return;
+
+    // add counters if needed
+    if(message >= registry.counters.size())
+    {
+        _XWMessageHookCounter counter = {0, 0};
+        registry.counters.resize(message + 1, counter);
+    }
+
+    // update counters
+    registry.counters[message].invocations += invocations;
+    if(consumed) registry.counters[message].consumed++;
+}
 
 /////////////////////////////////////////////////////////////////////
 // message hooks
+/////////////////////////////////////////////////////////////////////
 void sXWUIAddMessageHook(IXWMessageHook* messageHook)
+{
+    // hook all messages
+    XWMessageHookFilter filter;
+    filter.setAllMessages();
+
+    sXWUIAddMessageHook(messageHook, filter);
+}
+
+void sXWUIAddMessageHook(IXWMessageHook* messageHook, const XWMessageHookFilter& filter)
 {
     XWASSERT(messageHook);
     if(messageHook == 0) return;
@@ -23,14 +264,20 @@ void sXWUIAddMessageHook(IXWMessageHook* messageHook)
     // allocate hooks if needed
     if(s_pXWMessageHooks == 0)
     {
-        s_pXWMessageHooks = new std::list<IXWMessageHook*>();
+        s_pXWMessageHooks = new _XWMessageHookRegistry();
 
         XWASSERT(s_pXWMessageHooks);
         if(s_pXWMessageHooks == 0) return;
     }
 
-    // insert hook in front
-    s_pXWMessageHooks->push_front(messageHook);
+    // add hook (hook lists are rebuilt before next message)
+    _XWMessageHookEntry entry;
+    entry.hook = messageHook;
+    entry.hookId = messageHook->messageHookId();
+    entry.filter = filter;
+
+    s_pXWMessageHooks->entries.push_back(entry);
+    s_pXWMessageHooks->dirty = true;
 }
 
 void sXWUIRemoveMessageHook(unsigned long hookId)
@@ -38,30 +285,20 @@ void sXWUIRemoveMessageHook(unsigned long hookId)
     // remove hook by id
     if(s_pXWMessageHooks)
     {
-        std::list<IXWMessageHook*>::iterator it = s_pXWMessageHooks->begin();
-
-        // remove all hooks with the same id
-        while(it != s_pXWMessageHooks->end())
+        // NOTE: hook lists may be in use while dispatching, so hooks are only marked
+        //       as removed here and deleted when lists are rebuilt
+        for(size_t idx = 0; idx < s_pXWMessageHooks->entries.size(); ++idx)
         {
             // check id
-            if((*it)->messageHookId() == hookId)
+            if(s_pXWMessageHooks->entries[idx].hook && s_pXWMessageHooks->entries[idx].hookId == hookId)
             {
-                // remove 
-                it = s_pXWMessageHooks->erase(it);
-
-            } else
-            {
-                // next
-                ++it;
+                s_pXWMessageHooks->entries[idx].hook = 0;
+                s_pXWMessageHooks->dirty = true;
             }
         }
 
-        // delete hooks if empty
-        if(s_pXWMessageHooks->size() == 0)
-        {
-            delete s_pXWMessageHooks;
-            s_pXWMessageHooks = 0;
-        }
+        // free registry with last hook
+        _xwmessagehookFreeIfEmpty();
     }
 }
 
@@ -69,6 +306,19 @@ void sXWUIClearMessageHooks()
 {
     if(s_pXWMessageHooks)
     {
+        // NOTE: can't delete registry while dispatching, remove hooks instead
+        //       (registry is freed when outer dispatch ends)
+        if(s_pXWMessageHooks->dispatchDepth > 0)
+        {
+            for(size_t idx = 0; idx < s_pXWMessageHooks->entries.size(); ++idx)
+            {
+                s_pXWMessageHooks->entries[idx].hook = 0;
+            }
+
+            s_pXWMessageHooks->dirty = true;
+            return;
+        }
+
         delete s_pXWMessageHooks;
         s_pXWMessageHooks = 0;
     }
@@ -80,21 +330,81 @@ bool sXWUIProcessMessageHooks(MSG* pmsg)
     if(pmsg == 0) return false;
 
     // check if there are any hooks
-    if(s_pXWMessageHooks)
+    if(s_pXWMessageHooks == 0) return false;
+
+    _XWMessageHookRegistry& registry = *s_pXWMessageHooks;
+
+    // rebuild hook lists if needed
+    if(registry.dirty && registry.dispatchDepth == 0) _xwmessagehookRebuild(registry);
+
+    // find hooks for message
+    UINT message = pmsg->message;
+    const _XWMessageHookList& hookList = registry.lists[message < registry.messageTable.size() ?
+                                                        registry.messageTable[message] : XWUI_MESSAGE_HOOK_DEFAULT_LIST];
+
+    if(hookList.count == 0) return false;
+
+    // call hooks
+    unsigned long invocations = 0;
+    bool consumed = false;
+
+    registry.dispatchDepth++;
+
+    for(size_t idx = 0; idx < hookList.count; ++idx)
     {
-        for(std::list<IXWMessageHook*>::iterator it = s_pXWMessageHooks->begin(); 
-                                                 it != s_pXWMessageHooks->end(); ++it)
+        // skip hooks removed while dispatching
+        IXWMessageHook* messageHook = registry.entries[registry.listItems[hookList.first + idx]].hook;
+        if(messageHook == 0) continue;
+
+        invocations++;
+
+        // process message
+        if(messageHook->processHookMessage(pmsg))
         {
-            // process message
-            if((*it)->processHookMessage(pmsg))
-            {
-                // message has been consumed, stop other processing
-                return true;
-            }
+            // message has been consumed, stop other processing
+            consumed = true;
+            break;
         }
     }
 
-    return false;
+    registry.dispatchDepth--;
+
+    // update counters
+    _xwmessagehookCount(registry, message, invocations, consumed);
+
+    // free registry if all hooks have been removed while dispatching
+    if(registry.dirty) _xwmessagehookFreeIfEmpty();
+
+    return consumed;
+}
+
+/////////////////////////////////////////////////////////////////////
+// message hook statistics
+/////////////////////////////////////////////////////////////////////
+void sXWUIGetMessageHookStats(std::vector<XWMessageHookStats>& statsOut)
+{
+    statsOut.clear();
+
+    if(s_pXWMessageHooks == 0) return;
+
+    // copy counters for messages hooks have been called for
+    for(size_t message = 0; message < s_pXWMessageHooks->counters.size(); ++message)
+    {
+        const _XWMessageHookCounter& counter = s_pXWMessageHooks->counters[message];
+        if(counter.invocations == 0) continue;
+
+        XWMessageHookStats stats;
+        stats.message = (UINT)message;
+        stats.invocations = counter.invocations;
+        stats.consumed = counter.consumed;
+
+        statsOut.push_back(stats);
+    }
+}
+
+void sXWUIResetMessageHookStats()
+{
+    if(s_pXWMessageHooks) s_pXWMessageHooks->counters.clear();
 }
 
 /////////////////////////////////////////////////////////////////////
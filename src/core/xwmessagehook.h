@@ -5,6 +5,11 @@
 #ifndef _XWMESSAGEHOOK_H_
 #define _XWMESSAGEHOOK_H_
 
+// NOTE: hooks are registered with message filter, messages are mapped to hook lists
+//       with dense table indexed by message id, so that messages without hooks cost
+//       only table lookup. Hooks added without filter receive all messages.
+//       Registry (with statistics) is freed once last hook is removed.
+
 /////////////////////////////////////////////////////////////////////
 // IXWMessageHook - message hook interface
 
@@ -18,14 +23,62 @@ public: // interface
 // IXWMessageHook
 /////////////////////////////////////////////////////////////////////
 
+/////////////////////////////////////////////////////////////////////
+// XWMessageHookFilter - messages hook is called for
+
+class XWMessageHookFilter
+{
+public: // construction/destruction
+    XWMessageHookFilter() : m_bAllMessages(false) {}
+    XWMessageHookFilter(UINT firstMessage, UINT lastMessage) : m_bAllMessages(false) { addRange(firstMessage, lastMessage); }
+
+public: // types
+    struct XWMessageRange
+    {
+        UINT    firstMessage;
+        UINT    lastMessage;
+    };
+
+public: // messages (ranges include last message)
+    void    addMessage(UINT message) { addRange(message, message); }
+    void    addRange(UINT firstMessage, UINT lastMessage);
+    void    setAllMessages() { m_bAllMessages = true; }
+
+public: // properties
+    bool    isAllMessages() const { return m_bAllMessages; }
+    bool    hasMessage(UINT message) const;
+    const std::vector<XWMessageRange>& ranges() const { return m_vRanges; }
+
+private: // data
+    std::vector<XWMessageRange>     m_vRanges;
+    bool                            m_bAllMessages;
+};
+
+// XWMessageHookFilter
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// message hook statistics (hook calls per message id)
+struct XWMessageHookStats
+{
+    UINT            message;
+    unsigned long   invocations;
+    unsigned long   consumed;
+};
+
 /////////////////////////////////////////////////////////////////////
 // message hooks
 void    sXWUIAddMessageHook(IXWMessageHook* messageHook);
+void    sXWUIAddMessageHook(IXWMessageHook* messageHook, const XWMessageHookFilter& filter);
 void    sXWUIRemoveMessageHook(unsigned long hookId);
 void    sXWUIClearMessageHooks();
 bool    sXWUIProcessMessageHooks(MSG* pmsg);
 
 /////////////////////////////////////////////////////////////////////
+// message hook statistics
+void    sXWUIGetMessageHookStats(std::vector<XWMessageHookStats>& statsOut);
+void    sXWUIResetMessageHookStats();
 
-#endif // _XWMESSAGEHOOK_H_
+/////////////////////////////////////////////////////////////////////
 
+#endif // _XWMESSAGEHOOK_H_
@@ -24,17 +24,22 @@ enum XWUI_MESSAGES
     WM_XWUI_CALLBACK_EVENT_REQUEST,
 
     // Description: Inform animation timer callback that timer has expired
-    // Agruments:   animation id is sent as WPARAM
+    // Agruments:   animation id is sent as WPARAM, post time as LPARAM if profiler is enabled
     WM_XWUI_ANIMATION_TIMER_EVENT,
 
     // Description: Inform animation value callback that value has changed
-    // Agruments:   animation id is sent as WPARAM
+    // Agruments:   animation id is sent as WPARAM, post time as LPARAM if profiler is enabled
     WM_XWUI_ANIMATION_VALUE_EVENT,
 
     // Description: Inform animation callback that animation has completed
-    // Agruments:   animation id is sent as WPARAM
+    // Agruments:   animation id is sent as WPARAM, post time as LPARAM if profiler is enabled
     WM_XWUI_ANIMATION_COMPLETED,
 
+    // Description: Inform window that animation events of current frame are ready, window
+    //              should read them with XWAnimationTimer::takeFrameEvents
+    // Agruments:   post time as LPARAM if profiler is enabled
+    WM_XWUI_ANIMATION_FRAME,
+
     // Description: Inform content loading callback that download has completed
     // Agruments:   content id is sent as WPARAM, path to file is sent as LPARAM
     WM_XWUI_URL_CONTENT_LOADED,
@@ -82,6 +87,24 @@ enum XWUI_MESSAGES
     // Arguments: graphics item id is sent as WPARAM, menu position is sent as LPARAM
     WM_XWUI_GITEM_SHOW_CONTEXT_MENU,
 
+    // Description: add graphics item area to window damage region, area will be
+    //              repainted once per frame together with other damaged areas
+    // Arguments: pointer to RECT is sent as LPARAM, if WPARAM is TRUE damage region
+    //            is repainted before message returns (immediate repaint)
+    // Returns: TRUE if area has been accepted or FALSE otherwise
+    WM_XWUI_GITEM_REPAINT,
+
+    // Description: repaint window damage region collected during current frame
+    // Agruments:   none
+    WM_XWUI_GITEM_FLUSH_DAMAGE,
+
+    // Description: move already painted content of graphics item area, only exposed
+    //              part of the area is added to damage region
+    // Arguments: scroll offsets are sent as WPARAM (signed LOWORD for X, signed HIWORD
+    //            for Y), pointer to RECT with scrolled area is sent as LPARAM
+    // Returns: TRUE if content has been moved or FALSE if area must be repainted
+    WM_XWUI_GITEM_SCROLL_RECT,
+
     WM_XWUI_MESSAGES_LAST      // must be the last
 };
 
@@ -2,13 +2,13 @@
 //
 /////////////////////////////////////////////////////////////////////
 
-#include "../xwui_config.h"
+#include "xwcore_config.h"
 
 #include "xwobject.h"
 
 /////////////////////////////////////////////////////////////////////
 // unique id counter
-static unsigned long    g_ulXWObjectUniqueId = 0;
+static std::atomic<unsigned long>   g_ulXWObjectUniqueId(0);
 
 /////////////////////////////////////////////////////////////////////
 // XWObject - object interface
@@ -16,10 +16,12 @@ static unsigned long    g_ulXWObjectUniqueId = 0;
 XWObject::XWObject(XWObject* parent) :
     m_parentObject(0),
     m_proxyObject(0),
-    m_oid(0)
+    m_childObjects(XWPoolAllocator<XWObject*>(XWObjectPool::current())),
+    m_oid(0),
+    m_connectedObjects(std::less<unsigned long>(), XWPoolAllocator<XWObject*>(XWObjectPool::current()))
 {
     // init id
-    m_oid = ::InterlockedIncrement(&g_ulXWObjectUniqueId);
+    m_oid = ++g_ulXWObjectUniqueId;
 
     // set parent object
     setParentObject(parent);
@@ -27,6 +29,11 @@ XWObject::XWObject(XWObject* parent) :
 
 XWObject::~XWObject()
 {
+    // NOTE: remove handlers of other objects and own handlers in other objects first,
+    //       so that no event is sent to or from object being deleted
+    m_eventHandlers.clear();
+    m_eventHandlers.removeSubscriptions();
+
     // inform connected object about removal
     for(XWConnectionMap::iterator it = m_connectedObjects.begin(); it != m_connectedObjects.end(); ++it)
     {
@@ -40,7 +47,7 @@ XWObject::~XWObject()
     if(m_parentObject) m_parentObject->_removeChildObject(this);
 
     // remove child items
-    for(std::list<XWObject*>::iterator listIt = m_childObjects.begin();
+    for(XWObjectList::iterator listIt = m_childObjects.begin();
         listIt != m_childObjects.end(); ++listIt)
     {
         // reset parent to avoid it calling _removeChildObject
@@ -51,6 +58,21 @@ XWObject::~XWObject()
     }
 }
 
+/////////////////////////////////////////////////////////////////////
+// pooled allocation
+/////////////////////////////////////////////////////////////////////
+void* XWObject::operator new(size_t size)
+{
+    // NOTE: current pool is used if any, otherwise heap
+    return XWObjectPool::allocateObject(size);
+}
+
+void XWObject::operator delete(void* ptr)
+{
+    // release to pool object has been allocated from
+    XWObjectPool::deallocateObject(ptr);
+}
+
 /////////////////////////////////////////////////////////////////////
 // event listeners
 /////////////////////////////////////////////////////////////////////
@@ -60,16 +82,9 @@ unsigned long XWObject::addEventHandler(unsigned long eventId, const XWObjectEve
     XWASSERT(handler.xwobject());
     if(handler.xwobject() == 0) return 0;
 
-    // check if object is the same
-    if(xwoid() != handler.xwobject()->xwoid())
-    {
-        // add each other to connected object list
-        addConnectedObject(handler.xwobject());
-        handler.xwobject()->addConnectedObject(this);
-    }
-
-    // pass to event map
-    return m_eventHandlers.addEventHandler(eventId, handler);
+    // NOTE: handler is added to listener subscriptions, so it is removed once either
+    //       of objects is deleted without connecting objects to each other
+    return m_eventHandlers.addEventHandler(eventId, handler, &handler.xwobject()->m_eventHandlers);
 }
 
 void XWObject::removeEventHandler(unsigned long handlerId)
@@ -129,7 +144,7 @@ void XWObject::removeObjectEventHandler(unsigned long eventId, XWObject* obj)
     if(obj == 0) return;
 
     // remove object event handlers
-    m_eventHandlers.removeObjectEventHandler(eventId, obj);
+    m_eventHandlers.removeObjectEventHandler(eventId, &obj->m_eventHandlers);
 }
 
 void XWObject::removeAllObjectHandlers(XWObject* obj)
@@ -138,7 +153,7 @@ void XWObject::removeAllObjectHandlers(XWObject* obj)
     if(obj == 0) return;
 
     // remove all object event handlers
-    m_eventHandlers.removeAllObjectHandlers(obj);
+    m_eventHandlers.removeAllObjectHandlers(&obj->m_eventHandlers);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -166,7 +181,7 @@ void XWObject::setParentObject(XWObject* parent, bool transferChildren)
     if(transferChildren && parent)
     {
         // replace parent
-        for(std::list<XWObject*>::iterator listIt = m_childObjects.begin();
+        for(XWObjectList::iterator listIt = m_childObjects.begin();
             listIt != m_childObjects.end(); ++listIt)
         {
             // replace parent object
@@ -231,7 +246,7 @@ void XWObject::onConnectedObjectRemoved(XWObject* obj)
     if(obj == 0) return;
 
     // remove object from event listeners
-    m_eventHandlers.removeAllObjectHandlers(obj);
+    m_eventHandlers.removeAllObjectHandlers(&obj->m_eventHandlers);
 
     // remove object from map
     XWConnectionMap::iterator it = m_connectedObjects.find(obj->xwoid());
@@ -259,7 +274,7 @@ void XWObject::_removeChildObject(XWObject* child)
     if(child == 0) return;
 
     // find child
-    for(std::list<XWObject*>::iterator listIt = m_childObjects.begin();
+    for(XWObjectList::iterator listIt = m_childObjects.begin();
         listIt != m_childObjects.end(); ++listIt)
     {
         // check if we found this object
@@ -17,6 +17,10 @@ public: // construction/destruction
 public: // unique object id
     unsigned long   xwoid() const { return m_oid; }
 
+public: // pooled allocation (see XWObjectPool)
+    static void*    operator new(size_t size);
+    static void     operator delete(void* ptr);
+
 public: // event listeners
     unsigned long addEventHandler(unsigned long eventId, const XWObjectEventDelegate& handler);
     void    removeEventHandler(unsigned long handlerId);
@@ -55,13 +59,15 @@ private: // helper methods
     void    _removeChildObject(XWObject* child);
     void    _addConnectedObject(XWObject* obj);
 
-protected: // connections map
-    typedef std::map<unsigned long, XWObject*>  XWConnectionMap;
+protected: // child list and connections map (nodes use pool of object if any)
+    typedef std::list<XWObject*, XWPoolAllocator<XWObject*> >   XWObjectList;
+    typedef std::map<unsigned long, XWObject*, std::less<unsigned long>, 
+                     XWPoolAllocator<std::pair<const unsigned long, XWObject*> > >  XWConnectionMap;
 
 protected: // data
     XWObject*               m_parentObject;
     XWObject*               m_proxyObject;
-    std::list<XWObject*>    m_childObjects;
+    XWObjectList            m_childObjects;
     XWObjectEventMap        m_eventHandlers;
     unsigned long           m_oid;
     XWConnectionMap         m_connectedObjects;
@@ -2,20 +2,41 @@
 //
 /////////////////////////////////////////////////////////////////////
 
-#include "../xwui_config.h"
+#include "xwcore_config.h"
 
 #include "xwobjecteventmap.h"
 
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// no slot index
+#define XWOBJECT_EVENT_NO_SLOT          0xFFFFFFFF
+
+// handler id keeps slot index in low bits and slot generation in high bits
+#define XWOBJECT_EVENT_SLOT_BITS        20
+#define XWOBJECT_EVENT_SLOT_MASK        0x000FFFFF
+#define XWOBJECT_EVENT_MAX_GENERATION   0x00000FFF
+
 /////////////////////////////////////////////////////////////////////
 // XWObjectEventMap - object event handling
 
 XWObjectEventMap::XWObjectEventMap() :
-    m_lNextHandlerId(0)
+    m_nFreeSlot(XWOBJECT_EVENT_NO_SLOT),
+    m_nSendDepth(0),
+    m_bEmptyChains(false)
 {
+    // empty subscription list
+    m_firstSubscription.eventMap = 0;
+    m_firstSubscription.slotIdx = XWOBJECT_EVENT_NO_SLOT;
 }
 
 XWObjectEventMap::~XWObjectEventMap()
 {
+    // unlink handlers from listeners
+    clear();
+
+    // remove own handlers from other maps
+    removeSubscriptions();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -23,61 +44,100 @@ XWObjectEventMap::~XWObjectEventMap()
 /////////////////////////////////////////////////////////////////////
 void XWObjectEventMap::clear()
 {
-    // clear all listeners
-    m_vEventHandlers.clear();
+    // NOTE: slots are not deleted, as their generations must be kept for ids of removed
+    //       handlers to stay invalid
+
+    // remove handlers one by one (unlinks them from listener subscription lists)
+    for(unsigned int slotIdx = 0; slotIdx < m_vHandlerSlots.size(); ++slotIdx)
+    {
+        if(m_vHandlerSlots[slotIdx].used) _removeSlot(slotIdx);
+    }
+}
+
+void XWObjectEventMap::removeSubscriptions()
+{
+    // remove handlers from other maps one by one (each removal unlinks list head)
+    while(m_firstSubscription.eventMap)
+    {
+        XWObjectSlotRef ref = m_firstSubscription;
+
+        // remove handler
+        ref.eventMap->_removeSlot(ref.slotIdx);
+    }
 }
 
 /////////////////////////////////////////////////////////////////////
 // add handlers
 /////////////////////////////////////////////////////////////////////
-unsigned long XWObjectEventMap::addEventHandler(unsigned long eventId, const XWObjectEventDelegate& handler)
+unsigned long XWObjectEventMap::addEventHandler(unsigned long eventId, const XWObjectEventDelegate& handler, XWObjectEventMap* listenerMap)
 {
-    // listener reference
-    XWObjectHandlerRef ref;
-    ref.eventHandler = handler;
-    ref.handlerId = ++m_lNextHandlerId;
+    unsigned int slotIdx;
 
-    // check if we have this handler already
-    XWObjectHandlersMap::iterator it = m_vEventHandlers.find(eventId);
-    if(it != m_vEventHandlers.end())
+    // reuse free slot if any
+    if(m_nFreeSlot != XWOBJECT_EVENT_NO_SLOT)
     {
-        // add one more handler
-        it->second.push_back(ref);
+        slotIdx = m_nFreeSlot;
+        m_nFreeSlot = m_vHandlerSlots[slotIdx].nextInEvent;
 
     } else
     {
-        // add new vector
-        XWObjectHandlerRefVect vect;
-        vect.push_back(ref);
+        // check if there is space for new slot
+        XWASSERT(m_vHandlerSlots.size() < XWOBJECT_EVENT_SLOT_MASK);
+        if(m_vHandlerSlots.size() >= XWOBJECT_EVENT_SLOT_MASK) return 0;
 
-        // add to map
-        m_vEventHandlers.insert(XWObjectHandlersMap::value_type(eventId, vect));
+        XWObjectHandlerSlot slot;
+        slot.generation = 1;
+
+        // add new slot
+        slotIdx = (unsigned int)m_vHandlerSlots.size();
+        m_vHandlerSlots.push_back(slot);
     }
 
+    XWObjectHandlerSlot& slot = m_vHandlerSlots[slotIdx];
+
+    // fill slot
+    slot.eventHandler = handler;
+    slot.eventId = eventId;
+    slot.used = true;
+    slot.listenerMap = listenerMap;
+
+    // find or add event chain
+    XWObjectEventChainMap::iterator it = m_vEventChains.find(eventId);
+    if(it == m_vEventChains.end())
+    {
+        XWObjectEventChain chain;
+        chain.first = XWOBJECT_EVENT_NO_SLOT;
+        chain.last = XWOBJECT_EVENT_NO_SLOT;
+
+        it = m_vEventChains.insert(XWObjectEventChainMap::value_type(eventId, chain)).first;
+    }
+
+    // append to event chain
+    slot.prevInEvent = it->second.last;
+    slot.nextInEvent = XWOBJECT_EVENT_NO_SLOT;
+
+    if(it->second.last != XWOBJECT_EVENT_NO_SLOT)
+        m_vHandlerSlots[it->second.last].nextInEvent = slotIdx;
+    else
+        it->second.first = slotIdx;
+
+    it->second.last = slotIdx;
+
+    // add to listener subscriptions
+    _linkSubscription(slotIdx);
+
     // return handler id
-    return ref.handlerId;
+    return _handlerId(slotIdx);
 }
 
 void XWObjectEventMap::removeEventHandler(unsigned long handlerId)
 {
-    // loop over all items
-    for(XWObjectHandlersMap::iterator it = m_vEventHandlers.begin(); it != m_vEventHandlers.end(); ++it)
-    {
-        XWObjectHandlerRefVect::iterator href = it->second.begin();
-        while(href != it->second.end())
-        {
-            // check if handler id matches
-            if(href->handlerId == handlerId)
-            {
-                // remove handler
-                href = it->second.erase(href);
-
-            } else
-            {
-                ++href;
-            }
-        }
-    }
+    // NOTE: id of already removed handler doesn't match any slot
+    unsigned int slotIdx = _findSlot(handlerId);
+    if(slotIdx == XWOBJECT_EVENT_NO_SLOT) return;
+
+    // remove handler
+    _removeSlot(slotIdx);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -86,79 +146,90 @@ void XWObjectEventMap::removeEventHandler(unsigned long handlerId)
 void XWObjectEventMap::sendEvent(unsigned long eventId, XWObject* sender)
 {
     // check if we have this handler
-    XWObjectHandlersMap::iterator it = m_vEventHandlers.find(eventId);
-    if(it != m_vEventHandlers.end())
+    XWObjectEventChainMap::iterator it = m_vEventChains.find(eventId);
+    if(it == m_vEventChains.end()) return;
+
+    // chains emptied by handlers are kept until sending is done
+    ++m_nSendDepth;
+
+    // NOTE: handlers may be added or removed by handler, so slots are accessed by index
+    //       and removal of current or next handler is detected with slot generation
+    unsigned int slotIdx = it->second.first;
+    while(slotIdx != XWOBJECT_EVENT_NO_SLOT)
     {
-        XWObjectHandlerRefVect& handlers = it->second;
+        // remember current and next handler
+        unsigned long handlerId = _handlerId(slotIdx);
+        unsigned int nextIdx = m_vHandlerSlots[slotIdx].nextInEvent;
+        unsigned long nextId = (nextIdx != XWOBJECT_EVENT_NO_SLOT) ? _handlerId(nextIdx) : 0;
 
-        // loop over all handlers
-        for(XWObjectHandlerRefVect::iterator href = handlers.begin(); href != handlers.end(); ++href)
+        // pass to handler (copy delegate as slots may be reallocated)
+        XWObjectEventDelegate eventHandler = m_vHandlerSlots[slotIdx].eventHandler;
+        if(eventHandler(eventId, sender)) 
         {
-            // pass to handler
-            if(href->eventHandler(eventId, sender)) 
-            {
-                // stop other processing if handler returns true
-                return;
-            }
+            // stop other processing if handler returns true
+            break;
         }
+
+        // continue from current handler if it is still there, it knows its next handler
+        if(_findSlot(handlerId) == slotIdx)
+            slotIdx = m_vHandlerSlots[slotIdx].nextInEvent;
+        else if(nextId && _findSlot(nextId) == nextIdx && m_vHandlerSlots[nextIdx].eventId == eventId)
+            slotIdx = nextIdx;
+        else
+            slotIdx = XWOBJECT_EVENT_NO_SLOT;
     }
+
+    // erase chains emptied while sending
+    --m_nSendDepth;
+    if(m_nSendDepth == 0 && m_bEmptyChains) _eraseEmptyChains();
 }
 
 /////////////////////////////////////////////////////////////////////
-// remove object event handlers from map
+// remove listener event handlers from map
 /////////////////////////////////////////////////////////////////////
-void XWObjectEventMap::removeObjectEventHandler(unsigned long eventId, XWObject* obj)
+void XWObjectEventMap::removeObjectEventHandler(unsigned long eventId, XWObjectEventMap* listenerMap)
 {
-    XWASSERT(obj);
-    if(obj == 0) return;
+    XWASSERT(listenerMap);
+    if(listenerMap == 0) return;
 
-    // check if we have this event
-    XWObjectHandlersMap::iterator it = m_vEventHandlers.find(eventId);
-    if(it != m_vEventHandlers.end())
+    // loop over listener subscriptions
+    XWObjectSlotRef ref = listenerMap->m_firstSubscription;
+    while(ref.eventMap)
     {
-        XWObjectHandlerRefVect& handlers = it->second;
+        // next subscription (current may be removed)
+        XWObjectSlotRef nextRef = _refSlot(ref).nextSubscription;
 
-        // loop over all handlers
-        for(XWObjectHandlerRefVect::iterator href = handlers.begin(); href != handlers.end(); )
+        // check if handler is for requested event in this map
+        if(ref.eventMap == this && m_vHandlerSlots[ref.slotIdx].eventId == eventId)
         {
-            // check if handler is from requested object
-            if(href->eventHandler.xwobject()->xwoid() == obj->xwoid())
-            {
-                // remove handler
-                href = handlers.erase(href);
-
-            } else
-            {
-                // next
-                ++href;
-            }
+            // remove handler
+            _removeSlot(ref.slotIdx);
         }
+
+        ref = nextRef;
     }
 }
 
-void XWObjectEventMap::removeAllObjectHandlers(XWObject* obj)
+void XWObjectEventMap::removeAllObjectHandlers(XWObjectEventMap* listenerMap)
 {
-    XWASSERT(obj);
-    if(obj == 0) return;
+    XWASSERT(listenerMap);
+    if(listenerMap == 0) return;
 
-    // loop over all items
-    for(XWObjectHandlersMap::iterator it = m_vEventHandlers.begin(); it != m_vEventHandlers.end(); ++it)
+    // loop over listener subscriptions
+    XWObjectSlotRef ref = listenerMap->m_firstSubscription;
+    while(ref.eventMap)
     {
-        // loop over all handlers
-        for(XWObjectHandlerRefVect::iterator href = it->second.begin(); href != it->second.end(); )
+        // next subscription (current may be removed)
+        XWObjectSlotRef nextRef = _refSlot(ref).nextSubscription;
+
+        // check if handler is in this map
+        if(ref.eventMap == this)
         {
-            // check if handler is from removed object
-            if(href->eventHandler.xwobject()->xwoid() == obj->xwoid())
-            {
-                // remove handler
-                href = it->second.erase(href);
-
-            } else
-            {
-                // next
-                ++href;
-            }
+            // remove handler
+            _removeSlot(ref.slotIdx);
         }
+
+        ref = nextRef;
     }
 }
 
@@ -170,7 +241,7 @@ unsigned long XWObjectEventMap::unusedEventId() const
     unsigned long eventId = 1;
 
     // find unused event id from map
-    while(m_vEventHandlers.count(eventId) != 0)
+    while(m_vEventChains.count(eventId) != 0)
     {
         // try next
         ++eventId;
@@ -179,5 +250,143 @@ unsigned long XWObjectEventMap::unusedEventId() const
     return eventId;
 }
 
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+unsigned int XWObjectEventMap::_findSlot(unsigned long handlerId) const
+{
+    // decode handler id
+    unsigned long slotNum = handlerId & XWOBJECT_EVENT_SLOT_MASK;
+    unsigned long generation = handlerId >> XWOBJECT_EVENT_SLOT_BITS;
+
+    // check slot
+    if(slotNum == 0 || slotNum > m_vHandlerSlots.size()) return XWOBJECT_EVENT_NO_SLOT;
+
+    const XWObjectHandlerSlot& slot = m_vHandlerSlots[slotNum - 1];
+    if(!slot.used || slot.generation != generation) return XWOBJECT_EVENT_NO_SLOT;
+
+    return (unsigned int)(slotNum - 1);
+}
+
+unsigned long XWObjectEventMap::_handlerId(unsigned int slotIdx) const
+{
+    // NOTE: slot number starts from 1 so that handler id is never 0
+    return (m_vHandlerSlots[slotIdx].generation << XWOBJECT_EVENT_SLOT_BITS) | (slotIdx + 1);
+}
+
+void XWObjectEventMap::_removeSlot(unsigned int slotIdx)
+{
+    XWObjectHandlerSlot& slot = m_vHandlerSlots[slotIdx];
+    XWASSERT(slot.used);
+
+    // remove from event chain
+    XWObjectEventChainMap::iterator it = m_vEventChains.find(slot.eventId);
+    XWASSERT(it != m_vEventChains.end());
+    XWObjectEventChain& chain = it->second;
+
+    if(slot.prevInEvent != XWOBJECT_EVENT_NO_SLOT)
+        m_vHandlerSlots[slot.prevInEvent].nextInEvent = slot.nextInEvent;
+    else
+        chain.first = slot.nextInEvent;
+
+    if(slot.nextInEvent != XWOBJECT_EVENT_NO_SLOT)
+        m_vHandlerSlots[slot.nextInEvent].prevInEvent = slot.prevInEvent;
+    else
+        chain.last = slot.prevInEvent;
+
+    // erase empty chain (later if event is being sent)
+    if(chain.first == XWOBJECT_EVENT_NO_SLOT)
+    {
+        if(m_nSendDepth == 0)
+            m_vEventChains.erase(it);
+        else
+            m_bEmptyChains = true;
+    }
+
+    // remove from listener subscriptions
+    _unlinkSubscription(slotIdx);
+
+    // reset slot
+    slot.used = false;
+    slot.eventHandler = XWObjectEventDelegate();
+    slot.nextInEvent = XWOBJECT_EVENT_NO_SLOT;
+
+    // retire slot if generation can't be increased anymore (stays unused)
+    if(slot.generation >= XWOBJECT_EVENT_MAX_GENERATION) return;
+
+    // NOTE: new generation makes handler id of removed handler invalid
+    slot.generation++;
+
+    // add to free list
+    slot.nextInEvent = m_nFreeSlot;
+    m_nFreeSlot = slotIdx;
+}
+
+void XWObjectEventMap::_eraseEmptyChains()
+{
+    // reset flag
+    m_bEmptyChains = false;
+
+    // erase chains without handlers
+    XWObjectEventChainMap::iterator it = m_vEventChains.begin();
+    while(it != m_vEventChains.end())
+    {
+        if(it->second.first == XWOBJECT_EVENT_NO_SLOT)
+            m_vEventChains.erase(it++);
+        else
+            ++it;
+    }
+}
+
+void XWObjectEventMap::_linkSubscription(unsigned int slotIdx)
+{
+    XWObjectHandlerSlot& slot = m_vHandlerSlots[slotIdx];
+
+    // reset links
+    slot.prevSubscription.eventMap = 0;
+    slot.prevSubscription.slotIdx = XWOBJECT_EVENT_NO_SLOT;
+    slot.nextSubscription.eventMap = 0;
+    slot.nextSubscription.slotIdx = XWOBJECT_EVENT_NO_SLOT;
+
+    // ignore if listener is not tracked
+    if(slot.listenerMap == 0) return;
+
+    XWObjectSlotRef ref;
+    ref.eventMap = this;
+    ref.slotIdx = slotIdx;
+
+    // add to listener subscriptions head
+    slot.nextSubscription = slot.listenerMap->m_firstSubscription;
+    if(slot.nextSubscription.eventMap) _refSlot(slot.nextSubscription).prevSubscription = ref;
+
+    slot.listenerMap->m_firstSubscription = ref;
+}
+
+void XWObjectEventMap::_unlinkSubscription(unsigned int slotIdx)
+{
+    XWObjectHandlerSlot& slot = m_vHandlerSlots[slotIdx];
+
+    // ignore if listener is not tracked
+    if(slot.listenerMap == 0) return;
+
+    // unlink from previous subscription or list head
+    if(slot.prevSubscription.eventMap)
+        _refSlot(slot.prevSubscription).nextSubscription = slot.nextSubscription;
+    else
+        slot.listenerMap->m_firstSubscription = slot.nextSubscription;
+
+    // unlink from next subscription
+    if(slot.nextSubscription.eventMap)
+        _refSlot(slot.nextSubscription).prevSubscription = slot.prevSubscription;
+
+    // reset listener
+    slot.listenerMap = 0;
+}
+
+XWObjectEventMap::XWObjectHandlerSlot& XWObjectEventMap::_refSlot(const XWObjectSlotRef& ref)
+{
+    return ref.eventMap->m_vHandlerSlots[ref.slotIdx];
+}
+
 // XWObjectEventMap
 /////////////////////////////////////////////////////////////////////
@@ -79,6 +79,20 @@ private: // data
 /////////////////////////////////////////////////////////////////////
 // XWObjectEventMap - object event handling
 
+// NOTE: handlers are kept in slot map, handler id contains slot index and slot
+//       generation so that id of removed handler never matches handler that reuses
+//       its slot. Handlers of the same event are linked in order they have been added.
+//       Slot whose generation is exhausted is retired (never reused), so removed handler
+//       id can't match new handler even after many reuses of the same slot.
+
+// NOTE: event chain is erased once its last handler is removed, if this happens while 
+//       event is sent, empty chains are erased after outermost sendEvent returns.
+
+// NOTE: each handler is linked to subscription list of listener object event map as
+//       well, so that handlers of listener in other maps are removed in O(listener
+//       handlers) once listener is deleted, and listener subscriptions are unlinked 
+//       once map itself is deleted.
+
 class XWObjectEventMap
 {
 public: // construction/destruction
@@ -87,35 +101,79 @@ public: // construction/destruction
 
 public: // interface
     void    clear();
+    void    removeSubscriptions();
 
-public: // event handlers
-    unsigned long   addEventHandler(unsigned long eventId, const XWObjectEventDelegate& handler);
+public: // event handlers (listener map may be 0 if handler is not tracked)
+    unsigned long   addEventHandler(unsigned long eventId, const XWObjectEventDelegate& handler, XWObjectEventMap* listenerMap);
     void            removeEventHandler(unsigned long handlerId);
 
 public: // send event
     void    sendEvent(unsigned long eventId, XWObject* sender);
 
-public: // remove object event handlers from map
-    void    removeObjectEventHandler(unsigned long eventId, XWObject* obj);
-    void    removeAllObjectHandlers(XWObject* obj);
+public: // remove listener event handlers from map
+    void    removeObjectEventHandler(unsigned long eventId, XWObjectEventMap* listenerMap);
+    void    removeAllObjectHandlers(XWObjectEventMap* listenerMap);
 
 public: // get unused event id
     unsigned long   unusedEventId() const;
 
-private: // handler data
-    struct XWObjectHandlerRef
+private: // types
+
+    // reference to handler slot in other (or the same) map
+    struct XWObjectSlotRef
+    {
+        XWObjectEventMap*       eventMap;
+        unsigned int            slotIdx;
+    };
+
+    // handler slot
+    struct XWObjectHandlerSlot
     {
-        unsigned long           handlerId;
         XWObjectEventDelegate   eventHandler;
+        unsigned long           eventId;
+        unsigned long           generation;
+        bool                    used;
+
+        // handlers of the same event (or next free slot)
+        unsigned int            prevInEvent;
+        unsigned int            nextInEvent;
+
+        // listener subscription list
+        XWObjectEventMap*       listenerMap;
+        XWObjectSlotRef         prevSubscription;
+        XWObjectSlotRef         nextSubscription;
+    };
+
+    // first and last handler of event
+    struct XWObjectEventChain
+    {
+        unsigned int            first;
+        unsigned int            last;
     };
 
-    // types
-    typedef std::vector<XWObjectHandlerRef>     XWObjectHandlerRefVect;
-    typedef std::map<unsigned long, XWObjectHandlerRefVect> XWObjectHandlersMap;
+    typedef std::vector<XWObjectHandlerSlot>            XWObjectHandlerSlotVect;
+    typedef std::map<unsigned long, XWObjectEventChain> XWObjectEventChainMap;
+
+private: // hide copy
+    XWObjectEventMap(const XWObjectEventMap&);
+    XWObjectEventMap& operator=(const XWObjectEventMap&);
+
+private: // worker methods
+    unsigned int    _findSlot(unsigned long handlerId) const;
+    unsigned long   _handlerId(unsigned int slotIdx) const;
+    void            _removeSlot(unsigned int slotIdx);
+    void            _eraseEmptyChains();
+    void            _linkSubscription(unsigned int slotIdx);
+    void            _unlinkSubscription(unsigned int slotIdx);
+    XWObjectHandlerSlot&    _refSlot(const XWObjectSlotRef& ref);
 
 private: // data
-    XWObjectHandlersMap     m_vEventHandlers;
-    unsigned long           m_lNextHandlerId;
+    XWObjectHandlerSlotVect m_vHandlerSlots;
+    XWObjectEventChainMap   m_vEventChains;
+    unsigned int            m_nFreeSlot;
+    unsigned int            m_nSendDepth;
+    bool                    m_bEmptyChains;
+    XWObjectSlotRef         m_firstSubscription;
 };
 
 // XWObjectEventMap
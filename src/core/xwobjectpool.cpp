@@ -0,0 +1,250 @@
+// Size-class memory pool for objects and their bookkeeping nodes
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwcore_config.h"
+
+#include "xwobjectpool.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// size class step (keeps blocks aligned)
+#define XWUI_OBJECT_POOL_CLASS_STEP     16
+
+// largest size served by pool
+#define XWUI_OBJECT_POOL_MAX_SIZE       2048
+
+// size of memory chunk allocated from system
+#define XWUI_OBJECT_POOL_CHUNK_SIZE     65536
+
+// size class index for size
+#define XWUI_OBJECT_POOL_CLASS(_size)   (((_size) + XWUI_OBJECT_POOL_CLASS_STEP - 1) / XWUI_OBJECT_POOL_CLASS_STEP)
+
+/////////////////////////////////////////////////////////////////////
+// static data
+thread_local XWObjectPool*  XWObjectPool::s_pCurrentPool = 0;
+XWObjectPool::XPoolStats    XWObjectPool::s_heapStats = {0, 0, 0, 0, 0, 0, 0};
+
+/////////////////////////////////////////////////////////////////////
+// XWObjectPool - size-class memory pool
+
+XWObjectPool::XWObjectPool() :
+    m_freeLists(XWUI_OBJECT_POOL_CLASS(XWUI_OBJECT_POOL_MAX_SIZE) + 1, (_FreeBlock*)0),
+    m_refCount(1),
+    m_heapBlocksInUse(0)
+{
+    // reset statistics
+    memset(&m_stats, 0, sizeof(XPoolStats));
+}
+
+XWObjectPool::~XWObjectPool()
+{
+    XWASSERT1(m_stats.blocksInUse == 0 && m_heapBlocksInUse == 0, "XWObjectPool: pool deleted while blocks are still in use");
+
+    // reset current pool if needed
+    if(s_pCurrentPool == this) s_pCurrentPool = 0;
+
+    // release all chunks at once
+    for(size_t idx = 0; idx < m_chunks.size(); ++idx)
+    {
+        ::operator delete(m_chunks[idx]);
+    }
+
+    m_chunks.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// reference counting
+/////////////////////////////////////////////////////////////////////
+void XWObjectPool::addRef()
+{
+    m_refCount++;
+}
+
+void XWObjectPool::release()
+{
+    XWASSERT(m_refCount > 0);
+    if(m_refCount == 0) return;
+
+    m_refCount--;
+
+    // NOTE: pool is kept until last block is freed
+    _releaseIfUnused();
+}
+
+/////////////////////////////////////////////////////////////////////
+// memory
+/////////////////////////////////////////////////////////////////////
+void* XWObjectPool::allocate(size_t size)
+{
+    // use heap for large blocks
+    if(size == 0 || size > XWUI_OBJECT_POOL_MAX_SIZE)
+    {
+        m_stats.heapAllocations++;
+        m_heapBlocksInUse++;
+
+        return ::operator new(size ? size : 1);
+    }
+
+    size_t sizeClass = XWUI_OBJECT_POOL_CLASS(size);
+
+    // add chunk if there are no free blocks
+    if(m_freeLists[sizeClass] == 0) _addChunk(sizeClass);
+
+    // take first free block
+    _FreeBlock* block = m_freeLists[sizeClass];
+    m_freeLists[sizeClass] = block->next;
+
+    // update stats
+    m_stats.allocations++;
+    m_stats.blocksInUse++;
+    if(m_stats.blocksInUse > m_stats.peakBlocksInUse) m_stats.peakBlocksInUse = m_stats.blocksInUse;
+
+    return block;
+}
+
+void XWObjectPool::deallocate(void* ptr, size_t size)
+{
+    // ignore empty pointer
+    if(ptr == 0) return;
+
+    // NOTE: blocks that didn't fit into pool has been allocated from heap
+    if(size == 0 || size > XWUI_OBJECT_POOL_MAX_SIZE)
+    {
+        ::operator delete(ptr);
+
+        // delete pool if it has been released already
+        m_heapBlocksInUse--;
+        _releaseIfUnused();
+        return;
+    }
+
+    size_t sizeClass = XWUI_OBJECT_POOL_CLASS(size);
+
+    // return block to free list
+    _FreeBlock* block = (_FreeBlock*)ptr;
+    block->next = m_freeLists[sizeClass];
+    m_freeLists[sizeClass] = block;
+
+    // update stats
+    m_stats.frees++;
+    m_stats.blocksInUse--;
+
+    // delete pool if it has been released already
+    _releaseIfUnused();
+}
+
+/////////////////////////////////////////////////////////////////////
+// statistics
+/////////////////////////////////////////////////////////////////////
+void XWObjectPool::getStats(XPoolStats& statsOut) const
+{
+    statsOut = m_stats;
+}
+
+void XWObjectPool::getHeapStats(XPoolStats& statsOut)
+{
+    statsOut = s_heapStats;
+}
+
+/////////////////////////////////////////////////////////////////////
+// current pool
+/////////////////////////////////////////////////////////////////////
+XWObjectPool* XWObjectPool::current()
+{
+    return s_pCurrentPool;
+}
+
+void XWObjectPool::setCurrent(XWObjectPool* pool)
+{
+    s_pCurrentPool = pool;
+}
+
+/////////////////////////////////////////////////////////////////////
+// objects
+/////////////////////////////////////////////////////////////////////
+void* XWObjectPool::allocateObject(size_t size)
+{
+    // NOTE: header keeps pool so that object is released to pool it comes from
+    size_t fullSize = size + sizeof(_ObjectHeader);
+    _ObjectHeader* header;
+
+    if(s_pCurrentPool)
+    {
+        // allocate from current pool
+        header = (_ObjectHeader*)s_pCurrentPool->allocate(fullSize);
+
+    } else
+    {
+        // allocate from heap
+        header = (_ObjectHeader*)::operator new(fullSize);
+
+        s_heapStats.allocations++;
+        s_heapStats.blocksInUse++;
+        if(s_heapStats.blocksInUse > s_heapStats.peakBlocksInUse) s_heapStats.peakBlocksInUse = s_heapStats.blocksInUse;
+    }
+
+    // fill header
+    header->pool = s_pCurrentPool;
+    header->size = fullSize;
+
+    return (header + 1);
+}
+
+void XWObjectPool::deallocateObject(void* ptr)
+{
+    // ignore empty pointer
+    if(ptr == 0) return;
+
+    _ObjectHeader* header = ((_ObjectHeader*)ptr) - 1;
+
+    // release to pool
+    if(header->pool)
+    {
+        header->pool->deallocate(header, header->size);
+        return;
+    }
+
+    // release to heap
+    s_heapStats.frees++;
+    s_heapStats.blocksInUse--;
+
+    ::operator delete(header);
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XWObjectPool::_addChunk(size_t sizeClass)
+{
+    size_t blockSize = sizeClass * XWUI_OBJECT_POOL_CLASS_STEP;
+    size_t blockCount = XWUI_OBJECT_POOL_CHUNK_SIZE / blockSize;
+
+    // allocate chunk (throws if there is no memory, as operator new does)
+    char* chunk = (char*)::operator new(XWUI_OBJECT_POOL_CHUNK_SIZE);
+    m_chunks.push_back(chunk);
+
+    // split chunk to free blocks (keep address order for first allocations)
+    for(size_t idx = blockCount; idx > 0; --idx)
+    {
+        _FreeBlock* block = (_FreeBlock*)(chunk + (idx - 1) * blockSize);
+        block->next = m_freeLists[sizeClass];
+        m_freeLists[sizeClass] = block;
+    }
+
+    // update stats
+    m_stats.chunks++;
+    m_stats.bytesReserved += XWUI_OBJECT_POOL_CHUNK_SIZE;
+}
+
+void XWObjectPool::_releaseIfUnused()
+{
+    // check if pool is still referenced or used
+    if(m_refCount != 0 || m_stats.blocksInUse != 0 || m_heapBlocksInUse != 0) return;
+
+    delete this;
+}
+
+// XWObjectPool
+/////////////////////////////////////////////////////////////////////
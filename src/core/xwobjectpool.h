@@ -0,0 +1,196 @@
+// Size-class memory pool for objects and their bookkeeping nodes
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWOBJECTPOOL_H_
+#define _XWOBJECTPOOL_H_
+
+// NOTE: pool keeps free list per size class and allocates memory from system in
+//       large chunks, so that building and deleting object trees doesn't hit system
+//       heap for each object and container node. Chunks are freed at once when pool
+//       is deleted. Pool is not thread safe, it is supposed to be used from UI thread.
+
+// NOTE: XWObject based objects and their containers are allocated from current pool
+//       of calling thread if any (see XWObjectPoolScope). Objects allocated without
+//       pool use system heap as before.
+
+// NOTE: pool is reference counted and is deleted once it has been released by its
+//       owner and last block allocated from it has been freed, so that objects may
+//       outlive pool owner (e.g. child objects deleted by XWObject destructor).
+//       Container allocators (see XWPoolAllocator) keep reference to pool as well.
+
+/////////////////////////////////////////////////////////////////////
+// XWObjectPool - size-class memory pool
+
+class XWObjectPool
+{
+public: // construction
+    XWObjectPool();
+
+public: // reference counting (pool is created with one reference)
+    void    addRef();
+    void    release();
+
+public: // memory (sizes above size class limit are passed to system heap)
+    void*   allocate(size_t size);
+    void    deallocate(void* ptr, size_t size);
+
+public: // statistics
+    struct XPoolStats
+    {
+        unsigned long   allocations;
+        unsigned long   frees;
+        unsigned long   heapAllocations;
+        unsigned long   chunks;
+        unsigned long   blocksInUse;
+        unsigned long   peakBlocksInUse;
+        size_t          bytesReserved;
+    };
+
+    void    getStats(XPoolStats& statsOut) const;
+    static void getHeapStats(XPoolStats& statsOut);
+
+public: // current pool (of calling thread)
+    static XWObjectPool*    current();
+    static void             setCurrent(XWObjectPool* pool);
+
+public: // objects (used by XWObject)
+    static void*            allocateObject(size_t size);
+    static void             deallocateObject(void* ptr);
+
+private: // types
+    struct _FreeBlock
+    {
+        _FreeBlock*     next;
+    };
+
+    // object header (keeps pool and size for deallocation)
+    struct _ObjectHeader
+    {
+        XWObjectPool*   pool;
+        size_t          size;
+    };
+
+private: // destruction (see release)
+    ~XWObjectPool();
+
+private: // hide copy
+    XWObjectPool(const XWObjectPool&);
+    XWObjectPool& operator=(const XWObjectPool&);
+
+private: // worker methods
+    void    _addChunk(size_t sizeClass);
+    void    _releaseIfUnused();
+
+private: // data
+    std::vector<_FreeBlock*>    m_freeLists;
+    std::vector<char*>          m_chunks;
+    XPoolStats                  m_stats;
+    unsigned long               m_refCount;
+    unsigned long               m_heapBlocksInUse;
+
+private: // static data
+    static thread_local XWObjectPool*   s_pCurrentPool;
+    static XPoolStats                   s_heapStats;
+};
+
+// XWObjectPool
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XWObjectPoolScope - sets current pool for scope
+
+class XWObjectPoolScope
+{
+public: // construction/destruction (NOTE: scope keeps reference to pool)
+    XWObjectPoolScope(XWObjectPool* pool) : m_pPool(pool), m_pPrevPool(XWObjectPool::current()) { if(m_pPool) m_pPool->addRef(); XWObjectPool::setCurrent(pool); }
+    ~XWObjectPoolScope() { XWObjectPool::setCurrent(m_pPrevPool); if(m_pPool) m_pPool->release(); }
+
+private: // hide copy
+    XWObjectPoolScope(const XWObjectPoolScope&);
+    XWObjectPoolScope& operator=(const XWObjectPoolScope&);
+
+private: // data
+    XWObjectPool*   m_pPool;
+    XWObjectPool*   m_pPrevPool;
+};
+
+// XWObjectPoolScope
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XWPoolAllocator - standard container allocator (uses heap if pool is not set)
+
+// NOTE: allocator keeps reference to pool, so that container which outlives pool
+//       owner or XWObjectPoolScope (e.g. empty container inserting later) still
+//       allocates from live pool.
+
+template <typename _T>
+class XWPoolAllocator
+{
+public: // types
+    typedef _T      value_type;
+
+    template <typename _U>
+    struct rebind
+    {
+        typedef XWPoolAllocator<_U> other;
+    };
+
+public: // construction/destruction
+    XWPoolAllocator(XWObjectPool* pool = 0) : m_pPool(pool) { if(m_pPool) m_pPool->addRef(); }
+    XWPoolAllocator(const XWPoolAllocator& other) : m_pPool(other.m_pPool) { if(m_pPool) m_pPool->addRef(); }
+    ~XWPoolAllocator() { if(m_pPool) m_pPool->release(); }
+
+    template <typename _U>
+    XWPoolAllocator(const XWPoolAllocator<_U>& other) : m_pPool(other.pool()) { if(m_pPool) m_pPool->addRef(); }
+
+public: // assignment (reference new pool before old one is released)
+    XWPoolAllocator& operator=(const XWPoolAllocator& other)
+    {
+        if(other.m_pPool) other.m_pPool->addRef();
+        if(m_pPool) m_pPool->release();
+
+        m_pPool = other.m_pPool;
+        return *this;
+    }
+
+public: // memory
+    _T*     allocate(size_t count)
+    {
+        // use heap if there is no pool
+        if(m_pPool == 0) return static_cast<_T*>(::operator new(count * sizeof(_T)));
+
+        return static_cast<_T*>(m_pPool->allocate(count * sizeof(_T)));
+    }
+
+    void    deallocate(_T* ptr, size_t count)
+    {
+        // use heap if there is no pool
+        if(m_pPool == 0)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        m_pPool->deallocate(ptr, count * sizeof(_T));
+    }
+
+public: // pool
+    XWObjectPool*   pool() const { return m_pPool; }
+
+public: // compare (memory from one allocator may be freed by other if pools are the same)
+    template <typename _U>
+    bool operator==(const XWPoolAllocator<_U>& other) const { return m_pPool == other.pool(); }
+
+    template <typename _U>
+    bool operator!=(const XWPoolAllocator<_U>& other) const { return m_pPool != other.pool(); }
+
+private: // data
+    XWObjectPool*   m_pPool;
+};
+
+// XWPoolAllocator
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWOBJECTPOOL_H_
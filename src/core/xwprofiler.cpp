@@ -0,0 +1,400 @@
+// Event loop profiler
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "../xwui_config.h"
+
+#include <strsafe.h>
+
+#include "xwprofiler.h"
+
+///// only if profiler enabled
+#ifdef _XW_ENABLE_PROFILER
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// number of exact values and sub-buckets per power of two (as power of two)
+#define XWUI_HISTOGRAM_SUB_BITS         5
+#define XWUI_HISTOGRAM_SUB_COUNT        (1 << XWUI_HISTOGRAM_SUB_BITS)
+
+// number of buckets for 32-bit values
+#define XWUI_HISTOGRAM_BUCKETS          ((32 - XWUI_HISTOGRAM_SUB_BITS + 1) * XWUI_HISTOGRAM_SUB_COUNT)
+
+// maximum number of trace events kept (older events are overwritten)
+#define XWUI_PROFILER_MAX_TRACE_EVENTS  65536
+
+// maximum size of single trace event in JSON
+#define XWUI_PROFILER_MAX_EVENT_JSON    256
+
+/////////////////////////////////////////////////////////////////////
+// XWLatencyHistogram - log-linear latency histogram (microseconds)
+
+XWLatencyHistogram::XWLatencyHistogram() :
+    m_buckets(XWUI_HISTOGRAM_BUCKETS, 0),
+    m_count(0),
+    m_min(0),
+    m_max(0),
+    m_total(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// values
+/////////////////////////////////////////////////////////////////////
+void XWLatencyHistogram::record(unsigned long valueUs)
+{
+    // count value
+    m_buckets[_bucketIndex(valueUs)]++;
+
+    // update statistics
+    if(m_count == 0 || valueUs < m_min) m_min = valueUs;
+    if(valueUs > m_max) m_max = valueUs;
+
+    m_total += valueUs;
+    m_count++;
+}
+
+void XWLatencyHistogram::reset()
+{
+    m_buckets.assign(XWUI_HISTOGRAM_BUCKETS, 0);
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_total = 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// statistics
+/////////////////////////////////////////////////////////////////////
+unsigned long XWLatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if(m_count == 0) return 0;
+
+    // number of values at or below percentile
+    unsigned long long target = (unsigned long long)ceil(percentile * m_count / 100.0);
+    if(target == 0) target = 1;
+    if(target > m_count) target = m_count;
+
+    // find bucket
+    unsigned long long counted = 0;
+    for(size_t idx = 0; idx < m_buckets.size(); ++idx)
+    {
+        counted += m_buckets[idx];
+
+        // NOTE: bucket high value may be above maximum recorded value
+        if(counted >= target) return (std::min)(_bucketHighValue(idx), m_max);
+    }
+
+    return m_max;
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+size_t XWLatencyHistogram::_bucketIndex(unsigned long value)
+{
+    // NOTE: histogram covers 32-bit values
+    if(value > 0xFFFFFFFFUL) value = 0xFFFFFFFFUL;
+
+    // small values are kept exactly
+    if(value < XWUI_HISTOGRAM_SUB_COUNT) return value;
+
+    // find highest bit
+    unsigned int highBit = XWUI_HISTOGRAM_SUB_BITS;
+    while(highBit < 31 && (value >> (highBit + 1)) != 0) highBit++;
+
+    // power of two block and linear sub-bucket inside it
+    size_t block = highBit - XWUI_HISTOGRAM_SUB_BITS + 1;
+    size_t subBucket = (value >> (highBit - XWUI_HISTOGRAM_SUB_BITS)) - XWUI_HISTOGRAM_SUB_COUNT;
+
+    return block * XWUI_HISTOGRAM_SUB_COUNT + subBucket;
+}
+
+unsigned long XWLatencyHistogram::_bucketHighValue(size_t bucketIdx)
+{
+    // small values are kept exactly
+    if(bucketIdx < XWUI_HISTOGRAM_SUB_COUNT) return (unsigned long)bucketIdx;
+
+    size_t block = bucketIdx / XWUI_HISTOGRAM_SUB_COUNT;
+    size_t subBucket = bucketIdx % XWUI_HISTOGRAM_SUB_COUNT;
+    unsigned int shift = (unsigned int)(block - 1);
+
+    // highest value in bucket
+    unsigned long long lowValue = (unsigned long long)(XWUI_HISTOGRAM_SUB_COUNT + subBucket) << shift;
+
+    return (unsigned long)(lowValue + (1ULL << shift) - 1);
+}
+
+// XWLatencyHistogram
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// profiler data
+
+struct _XWProfileTraceEvent
+{
+    XWProfiler::TProfileEvent   eventType;
+    UINT                        message;
+    long long                   startUs;
+    long long                   durationUs;
+};
+
+struct _XWProfilerData
+{
+    std::map<UINT, XWProfiler::XMessageProfile>     messages;
+    XWLatencyHistogram                              paintDurations;
+
+    // trace events (ring buffer)
+    std::vector<_XWProfileTraceEvent>               traceEvents;
+    size_t                                          nextTraceEvent;
+
+    // constructor
+    _XWProfilerData() : nextTraceEvent(0) {}
+};
+
+static _XWProfilerData*     s_pXWProfilerData = 0;
+static long long            s_xwprofilerFrequency = 0;
+
+static _XWProfilerData& _xwprofilerData()
+{
+    // allocate on first use
+    if(s_pXWProfilerData == 0) s_pXWProfilerData = new _XWProfilerData();
+
+    return *s_pXWProfilerData;
+}
+
+static void _xwprofilerAddTraceEvent(XWProfiler::TProfileEvent eventType, UINT message, long long startUs, long long durationUs)
+{
+    _XWProfilerData& data = _xwprofilerData();
+
+    _XWProfileTraceEvent traceEvent;
+    traceEvent.eventType = eventType;
+    traceEvent.message = message;
+    traceEvent.startUs = startUs;
+    traceEvent.durationUs = durationUs;
+
+    // add event or overwrite oldest one
+    if(data.traceEvents.size() < XWUI_PROFILER_MAX_TRACE_EVENTS)
+    {
+        data.traceEvents.push_back(traceEvent);
+
+    } else
+    {
+        data.traceEvents[data.nextTraceEvent] = traceEvent;
+    }
+
+    data.nextTraceEvent = (data.nextTraceEvent + 1) % XWUI_PROFILER_MAX_TRACE_EVENTS;
+}
+
+static const char* _xwprofilerMessageName(UINT message, char* buffer, size_t bufferSize)
+{
+    // common messages
+    switch(message)
+    {
+    case WM_PAINT:                      return "WM_PAINT";
+    case WM_SIZE:                       return "WM_SIZE";
+    case WM_TIMER:                      return "WM_TIMER";
+    case WM_MOUSEMOVE:                  return "WM_MOUSEMOVE";
+    case WM_LBUTTONDOWN:                return "WM_LBUTTONDOWN";
+    case WM_LBUTTONUP:                  return "WM_LBUTTONUP";
+    case WM_MOUSEWHEEL:                 return "WM_MOUSEWHEEL";
+    case WM_KEYDOWN:                    return "WM_KEYDOWN";
+    case WM_SETCURSOR:                  return "WM_SETCURSOR";
+    case WM_NCHITTEST:                  return "WM_NCHITTEST";
+    case WM_XWUI_ANIMATION_TIMER_EVENT: return "WM_XWUI_ANIMATION_TIMER_EVENT";
+    case WM_XWUI_ANIMATION_VALUE_EVENT: return "WM_XWUI_ANIMATION_VALUE_EVENT";
+    case WM_XWUI_ANIMATION_COMPLETED:   return "WM_XWUI_ANIMATION_COMPLETED";
+    case WM_XWUI_ANIMATION_FRAME:       return "WM_XWUI_ANIMATION_FRAME";
+    }
+
+    // message id
+    StringCchPrintfA(buffer, bufferSize, "WM 0x%04X", message);
+
+    return buffer;
+}
+
+/////////////////////////////////////////////////////////////////////
+// XWProfiler - event loop profiler
+
+/////////////////////////////////////////////////////////////////////
+// time
+/////////////////////////////////////////////////////////////////////
+long long XWProfiler::timeUs()
+{
+    LARGE_INTEGER counter;
+
+    // read frequency once
+    if(s_xwprofilerFrequency == 0)
+    {
+        LARGE_INTEGER frequency;
+        if(!::QueryPerformanceFrequency(&frequency)) return (long long)::GetTickCount64() * 1000;
+
+        s_xwprofilerFrequency = frequency.QuadPart;
+    }
+
+    if(!::QueryPerformanceCounter(&counter)) return (long long)::GetTickCount64() * 1000;
+
+    // convert to microseconds (split to avoid overflow)
+    return (counter.QuadPart / s_xwprofilerFrequency) * 1000000 +
+           (counter.QuadPart % s_xwprofilerFrequency) * 1000000 / s_xwprofilerFrequency;
+}
+
+/////////////////////////////////////////////////////////////////////
+// recording (UI thread)
+/////////////////////////////////////////////////////////////////////
+void XWProfiler::recordEvent(TProfileEvent eventType, UINT message, long long startUs, long long endUs)
+{
+    long long durationUs = (endUs > startUs) ? endUs - startUs : 0;
+    _XWProfilerData& data = _xwprofilerData();
+
+    // update histogram
+    if(eventType == eProfilePaint)
+        data.paintDurations.record((unsigned long)durationUs);
+    else if(eventType == eProfileQueue)
+        data.messages[message].queueLatency.record((unsigned long)durationUs);
+    else
+        data.messages[message].handlerLatency.record((unsigned long)durationUs);
+
+    // keep trace event
+    _xwprofilerAddTraceEvent(eventType, message, startUs, durationUs);
+}
+
+/////////////////////////////////////////////////////////////////////
+// posted messages
+/////////////////////////////////////////////////////////////////////
+LPARAM XWProfiler::postStamp()
+{
+    // NOTE: may be called from any thread, only time is read
+    return (LPARAM)timeUs();
+}
+
+void XWProfiler::recordQueueLatency(UINT message, LPARAM postStamp)
+{
+    // ignore messages posted without stamp
+    if(postStamp == 0) return;
+
+    long long nowUs = timeUs();
+
+    // NOTE: LPARAM is 32-bit on x86, so only low bits of time can be compared there
+    long long latencyUs = (sizeof(LPARAM) < sizeof(long long)) ?
+                          (long long)(DWORD)((DWORD)nowUs - (DWORD)postStamp) : nowUs - (long long)postStamp;
+
+    recordEvent(eProfileQueue, message, nowUs - latencyUs, nowUs);
+}
+
+/////////////////////////////////////////////////////////////////////
+// profile data
+/////////////////////////////////////////////////////////////////////
+void XWProfiler::messages(std::vector<UINT>& messagesOut)
+{
+    messagesOut.clear();
+
+    if(s_pXWProfilerData == 0) return;
+
+    // copy recorded message ids
+    for(std::map<UINT, XMessageProfile>::const_iterator it = s_pXWProfilerData->messages.begin();
+        it != s_pXWProfilerData->messages.end(); ++it)
+    {
+        messagesOut.push_back(it->first);
+    }
+}
+
+const XWProfiler::XMessageProfile* XWProfiler::messageProfile(UINT message)
+{
+    if(s_pXWProfilerData == 0) return 0;
+
+    // find message
+    std::map<UINT, XMessageProfile>::const_iterator it = s_pXWProfilerData->messages.find(message);
+    if(it == s_pXWProfilerData->messages.end()) return 0;
+
+    return &it->second;
+}
+
+const XWLatencyHistogram& XWProfiler::paintDurations()
+{
+    return _xwprofilerData().paintDurations;
+}
+
+void XWProfiler::reset()
+{
+    if(s_pXWProfilerData)
+    {
+        delete s_pXWProfilerData;
+        s_pXWProfilerData = 0;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// Chrome trace event format
+/////////////////////////////////////////////////////////////////////
+void XWProfiler::chromeTrace(std::string& jsonOut)
+{
+    static const char* eventCategory[] = {"message", "paint", "queue"};
+
+    char eventJson[XWUI_PROFILER_MAX_EVENT_JSON];
+    char nameBuffer[32];
+
+    jsonOut = "{\"traceEvents\":[";
+
+    if(s_pXWProfilerData)
+    {
+        const std::vector<_XWProfileTraceEvent>& traceEvents = s_pXWProfilerData->traceEvents;
+
+        // NOTE: if ring buffer is full, oldest event is the next one to overwrite
+        size_t firstEvent = (traceEvents.size() < XWUI_PROFILER_MAX_TRACE_EVENTS) ? 0 : s_pXWProfilerData->nextTraceEvent;
+
+        for(size_t idx = 0; idx < traceEvents.size(); ++idx)
+        {
+            const _XWProfileTraceEvent& traceEvent = traceEvents[(firstEvent + idx) % traceEvents.size()];
+
+            // format complete event
+            StringCchPrintfA(eventJson, XWUI_PROFILER_MAX_EVENT_JSON,
+                "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":1}",
+                idx ? "," : "",
+                _xwprofilerMessageName(traceEvent.message, nameBuffer, sizeof(nameBuffer)),
+                eventCategory[traceEvent.eventType],
+                traceEvent.startUs, traceEvent.durationUs);
+
+            jsonOut += eventJson;
+        }
+    }
+
+    jsonOut += "],\"displayTimeUnit\":\"ms\"}";
+}
+
+bool XWProfiler::saveChromeTrace(const WCHAR* filePath)
+{
+    XWASSERT(filePath);
+    if(filePath == 0) return false;
+
+    std::string json;
+    chromeTrace(json);
+
+    // create file
+    HANDLE hFile = ::CreateFileW(filePath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(hFile == INVALID_HANDLE_VALUE)
+    {
+        XWTRACE_WERR_LAST("XWProfiler: failed to create trace file");
+        return false;
+    }
+
+    // write trace
+    DWORD bytesWritten = 0;
+    bool bRes = (::WriteFile(hFile, json.c_str(), (DWORD)json.size(), &bytesWritten, NULL) != FALSE) &&
+                (bytesWritten == (DWORD)json.size());
+
+    if(!bRes)
+    {
+        XWTRACE_WERR_LAST("XWProfiler: failed to write trace file");
+    }
+
+    ::CloseHandle(hFile);
+
+    return bRes;
+}
+
+// XWProfiler
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XW_ENABLE_PROFILER
@@ -0,0 +1,133 @@
+// Event loop profiler
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWPROFILER_H_
+#define _XWPROFILER_H_
+
+// NOTE: profiler is compiled only if _XW_ENABLE_PROFILER is defined, otherwise profiling
+//       macros expand to nothing. Profiler records message handler latency and paint
+//       durations per message id, and queue latency of posted animation messages (post
+//       time is passed with message as LPARAM). Data is recorded from UI thread only.
+
+#ifdef _XW_ENABLE_PROFILER
+
+    /////////////////////////////////////////////////////////////////////
+    // XWLatencyHistogram - log-linear latency histogram (microseconds)
+
+    // NOTE: values below 32 are kept exactly, larger values are kept in 32 linear
+    //       sub-buckets per power of two, so relative error is below 3%
+
+    class XWLatencyHistogram
+    {
+    public: // construction/destruction
+        XWLatencyHistogram();
+
+    public: // values
+        void    record(unsigned long valueUs);
+        void    reset();
+
+    public: // statistics
+        unsigned long   count() const { return m_count; }
+        unsigned long   minValue() const { return m_count ? m_min : 0; }
+        unsigned long   maxValue() const { return m_max; }
+        unsigned long   meanValue() const { return m_count ? (unsigned long)(m_total / m_count) : 0; }
+        unsigned long   valueAtPercentile(double percentile) const;
+
+    private: // worker methods
+        static size_t           _bucketIndex(unsigned long value);
+        static unsigned long    _bucketHighValue(size_t bucketIdx);
+
+    private: // data
+        std::vector<unsigned long>  m_buckets;
+        unsigned long               m_count;
+        unsigned long               m_min;
+        unsigned long               m_max;
+        unsigned long long          m_total;
+    };
+
+    // XWLatencyHistogram
+    /////////////////////////////////////////////////////////////////////
+
+    /////////////////////////////////////////////////////////////////////
+    // XWProfiler - event loop profiler
+
+    class XWProfiler
+    {
+    public: // types
+        enum TProfileEvent
+        {
+            eProfileMessage,
+            eProfilePaint,
+            eProfileQueue
+        };
+
+        // message profile (handler latency count is message count)
+        struct XMessageProfile
+        {
+            XWLatencyHistogram  handlerLatency;
+            XWLatencyHistogram  queueLatency;
+        };
+
+    public: // time
+        static long long    timeUs();
+
+    public: // recording (UI thread)
+        static void     recordEvent(TProfileEvent eventType, UINT message, long long startUs, long long endUs);
+
+    public: // posted messages
+        static LPARAM   postStamp();
+        static void     recordQueueLatency(UINT message, LPARAM postStamp);
+
+    public: // profile data
+        static void     messages(std::vector<UINT>& messagesOut);
+        static const XMessageProfile*   messageProfile(UINT message);
+        static const XWLatencyHistogram& paintDurations();
+        static void     reset();
+
+    public: // Chrome trace event format
+        static void     chromeTrace(std::string& jsonOut);
+        static bool     saveChromeTrace(const WCHAR* filePath);
+    };
+
+    // XWProfiler
+    /////////////////////////////////////////////////////////////////////
+
+    /////////////////////////////////////////////////////////////////////
+    // XWProfileScope - records scope duration
+
+    class XWProfileScope
+    {
+    public: // construction/destruction
+        XWProfileScope(XWProfiler::TProfileEvent eventType, UINT message) :
+                m_eventType(eventType), m_message(message), m_startUs(XWProfiler::timeUs()) {}
+        ~XWProfileScope() { XWProfiler::recordEvent(m_eventType, m_message, m_startUs, XWProfiler::timeUs()); }
+
+    private: // hide copy
+        XWProfileScope(const XWProfileScope&);
+        XWProfileScope& operator=(const XWProfileScope&);
+
+    private: // data
+        XWProfiler::TProfileEvent   m_eventType;
+        UINT                        m_message;
+        long long                   m_startUs;
+    };
+
+    // XWProfileScope
+    /////////////////////////////////////////////////////////////////////
+
+    #define XWPROFILE_MESSAGE(msg)              XWProfileScope _xwprofileMessageScope(XWProfiler::eProfileMessage, msg)
+    #define XWPROFILE_PAINT(msg)                XWProfileScope _xwprofilePaintScope(XWProfiler::eProfilePaint, msg)
+    #define XWPROFILE_POST_STAMP()              XWProfiler::postStamp()
+    #define XWPROFILE_QUEUE_LATENCY(msg, stamp) XWProfiler::recordQueueLatency(msg, stamp)
+
+#else
+
+    #define XWPROFILE_MESSAGE(msg)
+    #define XWPROFILE_PAINT(msg)
+    #define XWPROFILE_POST_STAMP()              0
+    #define XWPROFILE_QUEUE_LATENCY(msg, stamp)
+
+#endif // _XW_ENABLE_PROFILER
+
+#endif // _XWPROFILER_H_
@@ -2,7 +2,7 @@
 //
 /////////////////////////////////////////////////////////////////////
 
-#include "../xwui_config.h"
+#include "xwcore_config.h"
 
 #include "xwscrollable.h"
 
@@ -0,0 +1,88 @@
+// Lock-free single producer / single consumer queue
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWSPSCQUEUE_H_
+#define _XWSPSCQUEUE_H_
+
+// NOTE: queue is a fixed size ring buffer, push may be called only from one thread
+//       and pop only from another (or the same) thread. Neither of them blocks, push
+//       fails if queue is full. Read and write positions are kept on separate cache
+//       lines so that producer and consumer don't invalidate each other's cache.
+
+/////////////////////////////////////////////////////////////////////
+// XWSpscQueue - lock-free single producer / single consumer queue
+
+template <typename _T>
+class XWSpscQueue
+{
+public: // construction/destruction
+    XWSpscQueue(size_t capacity) :
+        m_readPos(0),
+        m_writePos(0)
+    {
+        // round capacity to power of two so that position can be masked
+        size_t size = 2;
+        while(size < capacity) size <<= 1;
+
+        m_items.resize(size);
+        m_mask = size - 1;
+    }
+
+    ~XWSpscQueue() {}
+
+public: // producer
+    bool    push(const _T& item)
+    {
+        size_t writePos = m_writePos.load(std::memory_order_relaxed);
+
+        // check if there is free space
+        if(writePos - m_readPos.load(std::memory_order_acquire) > m_mask) return false;
+
+        // copy item
+        m_items[writePos & m_mask] = item;
+
+        // publish item to consumer
+        m_writePos.store(writePos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+public: // consumer
+    bool    pop(_T& itemOut)
+    {
+        size_t readPos = m_readPos.load(std::memory_order_relaxed);
+
+        // check if there is any item
+        if(readPos == m_writePos.load(std::memory_order_acquire)) return false;
+
+        // copy item
+        itemOut = m_items[readPos & m_mask];
+
+        // release item space to producer
+        m_readPos.store(readPos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+public: // properties
+    bool    isEmpty() const     { return m_readPos.load(std::memory_order_acquire) == m_writePos.load(std::memory_order_acquire); }
+    size_t  capacity() const    { return m_mask + 1; }
+
+private: // hide copy
+    XWSpscQueue(const XWSpscQueue&);
+    XWSpscQueue& operator=(const XWSpscQueue&);
+
+private: // data
+    std::vector<_T>         m_items;
+    size_t                  m_mask;
+    char                    m_padding1[64];
+    std::atomic<size_t>     m_readPos;
+    char                    m_padding2[64];
+    std::atomic<size_t>     m_writePos;
+};
+
+// XWSpscQueue
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWSPSCQUEUE_H_
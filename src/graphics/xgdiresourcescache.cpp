@@ -58,6 +58,19 @@ void XGdiResourcesCache::close()
         m_gdiBitmapCache.clear();
     }
 
+    // release pens and brushes
+    for(XGdiPenCache::iterator it = m_gdiPenCache.begin(); it != m_gdiPenCache.end(); ++it)
+    {
+        ::DeleteObject(it->second);
+    }
+    m_gdiPenCache.clear();
+
+    for(XGdiBrushCache::iterator it = m_gdiBrushCache.begin(); it != m_gdiBrushCache.end(); ++it)
+    {
+        ::DeleteObject(it->second);
+    }
+    m_gdiBrushCache.clear();
+
     // close double buffer if any
     closeDoubleBufferDC();
 
@@ -144,6 +157,49 @@ void XGdiResourcesCache::closeDoubleBufferDC()
     }
 }
 
+/////////////////////////////////////////////////////////////////////
+// cached pens and brushes
+/////////////////////////////////////////////////////////////////////
+HPEN XGdiResourcesCache::getPen(int width, COLORREF color)
+{
+    // check if pen is in cache already
+    XGdiPenCache::iterator it = m_gdiPenCache.find(std::make_pair(width, color));
+    if(it != m_gdiPenCache.end()) return it->second;
+
+    // create pen
+    HPEN hPen = ::CreatePen(PS_SOLID, width, color);
+    if(hPen == 0)
+    {
+        XWTRACE_WERR_LAST("XGdiResourcesCache: failed to create pen");
+        return 0;
+    }
+
+    // keep in cache
+    m_gdiPenCache[std::make_pair(width, color)] = hPen;
+
+    return hPen;
+}
+
+HBRUSH XGdiResourcesCache::getBrush(COLORREF color)
+{
+    // check if brush is in cache already
+    XGdiBrushCache::iterator it = m_gdiBrushCache.find(color);
+    if(it != m_gdiBrushCache.end()) return it->second;
+
+    // create brush
+    HBRUSH hBrush = ::CreateSolidBrush(color);
+    if(hBrush == 0)
+    {
+        XWTRACE_WERR_LAST("XGdiResourcesCache: failed to create brush");
+        return 0;
+    }
+
+    // keep in cache
+    m_gdiBrushCache[color] = hBrush;
+
+    return hBrush;
+}
+
 /////////////////////////////////////////////////////////////////////
 // get cached bitmap
 /////////////////////////////////////////////////////////////////////
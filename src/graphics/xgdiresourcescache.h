@@ -39,6 +39,10 @@ public: // window double buffering
     HDC     getDoubleBufferDC(HDC hdc, int width, int height);
     void    closeDoubleBufferDC();
 
+public: // cached pens and brushes (owned by cache, released when cache is closed)
+    HPEN    getPen(int width, COLORREF color);
+    HBRUSH  getBrush(COLORREF color);
+
 public: // get cached bitmap (does not increase reference count)
     HBITMAP getBitmap(const std::wstring& bitmapHash);
 
@@ -76,10 +80,16 @@ private: // bitmap cache
 
     typedef std::map<std::wstring, XGdiBitmapCacheItem> XGdiBitmapChache;
 
+private: // pen and brush cache
+    typedef std::map<std::pair<int, COLORREF>, HPEN>    XGdiPenCache;
+    typedef std::map<COLORREF, HBRUSH>                  XGdiBrushCache;
+
 private: // data
     unsigned long       m_ulRef;
     HDC                 m_hCompatibleDC;
     XGdiBitmapChache    m_gdiBitmapCache;
+    XGdiPenCache        m_gdiPenCache;
+    XGdiBrushCache      m_gdiBrushCache;
 
 private: // double buffering
     HDC                 m_hDoubleBufferDC;
@@ -0,0 +1,920 @@
+// Grid layout engine
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "../core/xwcore_config.h"
+
+#include "xlayoutitem.h"
+#include "xlayout.h"
+#include "xlayoutsizesolver.h"
+#include "xgridlayout.h"
+
+/////////////////////////////////////////////////////////////////////
+// XGridLayout - grid layout engine
+XGridLayout::XGridLayout(XWObject* parent) :
+    XWObject(parent),
+    m_constraintsValid(false),
+    m_tracksRebuildNeeded(true),
+    m_columnSizesValid(false),
+    m_rowSizesValid(false),
+    m_nContentWidth(0),
+    m_nContentHeight(0),
+    m_rpHorizontal(eResizeAny),
+    m_rpVertical(eResizeAny),
+    m_nHorizontalSpacing(0),
+    m_nVerticalSpacing(0),
+    m_nMinWidth(0),
+    m_nMinHeight(0),
+    m_nMaxWidth(0),
+    m_nMaxHeight(0)
+{
+}
+
+XGridLayout::~XGridLayout()
+{
+    // NOTE: items may be deleted after layout
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        if(m_layoutItems[idx].item->parentLayoutItem() == this) 
+            m_layoutItems[idx].item->setParentLayoutItem(0);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// add items
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::addItem(IXLayoutItem* item, int row, int column, int rowSpan, int columnSpan, int alignment)
+{
+    // check input
+    XWASSERT(item);
+    XWASSERT(row >= 0 && column >= 0 && rowSpan > 0 && columnSpan > 0);
+    if(item == 0 || row < 0 || column < 0 || rowSpan <= 0 || columnSpan <= 0) return;
+
+    _ItemRef itemRef;
+
+    // fill item
+    itemRef.item = item;
+    itemRef.row = row;
+    itemRef.column = column;
+    itemRef.rowSpan = rowSpan;
+    itemRef.columnSpan = columnSpan;
+    itemRef.alignment = alignment;
+
+    // NOTE: constraints are queried by updateResizePolicies
+    itemRef.dirty = false;
+    itemRef.visible = false;
+    itemRef.hPolicy = eResizeAny;
+    itemRef.vPolicy = eResizeAny;
+    itemRef.minWidth = 0;
+    itemRef.maxWidth = 0;
+    itemRef.minHeight = 0;
+    itemRef.maxHeight = 0;
+
+    // add to index
+    m_layoutItems.push_back(itemRef);
+
+    // make sure item cells exist
+    _addTracks(row + rowSpan, column + columnSpan);
+
+    // NOTE: new item is placed into its tracks, so that only they are aggregated again
+    if(!m_tracksRebuildNeeded)
+    {
+        int itemIdx = (int)m_layoutItems.size() - 1;
+
+        if(rowSpan == 1) m_rows[row].items.push_back(itemIdx);
+        if(columnSpan == 1) m_columns[column].items.push_back(itemIdx);
+        if(rowSpan > 1 || columnSpan > 1) m_spanItems.push_back(itemIdx);
+    }
+
+    // item informs layout about its changes
+    item->setParentLayoutItem(this);
+
+    // update policy
+    _invalidateItem(m_layoutItems.size() - 1);
+    updateResizePolicies();
+}
+
+/////////////////////////////////////////////////////////////////////
+// track stretch factors
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::setRowStretch(int row, int stretch)
+{
+    // check input
+    XWASSERT(row >= 0 && stretch >= 0);
+    if(row < 0 || stretch < 0) return;
+
+    // make sure row exists
+    _addTracks(row + 1, 0);
+
+    // set stretch
+    m_rows[row].stretch = stretch;
+    invalidateResizePolicies();
+}
+
+void XGridLayout::setColumnStretch(int column, int stretch)
+{
+    // check input
+    XWASSERT(column >= 0 && stretch >= 0);
+    if(column < 0 || stretch < 0) return;
+
+    // make sure column exists
+    _addTracks(0, column + 1);
+
+    // set stretch
+    m_columns[column].stretch = stretch;
+    invalidateResizePolicies();
+}
+
+int XGridLayout::rowStretch(int row) const
+{
+    if(row >= 0 && row < (int)m_rows.size())
+    {
+        return m_rows[row].stretch;
+
+    } else
+    {
+        XWASSERT1(0, "XGridLayout::rowStretch index is out of range");
+        return 0;
+    }
+}
+
+int XGridLayout::columnStretch(int column) const
+{
+    if(column >= 0 && column < (int)m_columns.size())
+    {
+        return m_columns[column].stretch;
+
+    } else
+    {
+        XWASSERT1(0, "XGridLayout::columnStretch index is out of range");
+        return 0;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// track size constraints
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::setRowMinMaxHeight(int row, int minHeight, int maxHeight)
+{
+    // check input
+    XWASSERT(row >= 0);
+    if(row < 0) return;
+
+    // make sure row exists
+    _addTracks(row + 1, 0);
+
+    // set constraints (negative values reset them)
+    m_rows[row].fixedMinSize = (minHeight >= 0) ? minHeight : XGRID_LAYOUT_SIZE_NOT_SET;
+    m_rows[row].fixedMaxSize = (maxHeight >= 0) ? maxHeight : XGRID_LAYOUT_SIZE_NOT_SET;
+    invalidateResizePolicies();
+}
+
+void XGridLayout::setColumnMinMaxWidth(int column, int minWidth, int maxWidth)
+{
+    // check input
+    XWASSERT(column >= 0);
+    if(column < 0) return;
+
+    // make sure column exists
+    _addTracks(0, column + 1);
+
+    // set constraints (negative values reset them)
+    m_columns[column].fixedMinSize = (minWidth >= 0) ? minWidth : XGRID_LAYOUT_SIZE_NOT_SET;
+    m_columns[column].fixedMaxSize = (maxWidth >= 0) ? maxWidth : XGRID_LAYOUT_SIZE_NOT_SET;
+    invalidateResizePolicies();
+}
+
+/////////////////////////////////////////////////////////////////////
+// item spacing
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::setSpacing(int spacing)
+{
+    m_nHorizontalSpacing = spacing;
+    m_nVerticalSpacing = spacing;
+    invalidateResizePolicies();
+}
+
+void XGridLayout::setHorizontalSpacing(int spacing)
+{
+    m_nHorizontalSpacing = spacing;
+    invalidateResizePolicies();
+}
+
+void XGridLayout::setVerticalSpacing(int spacing)
+{
+    m_nVerticalSpacing = spacing;
+    invalidateResizePolicies();
+}
+
+/////////////////////////////////////////////////////////////////////
+// enum layout items (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+int XGridLayout::layoutItemCount() const
+{
+    return (int)m_layoutItems.size();
+}
+
+void XGridLayout::removelayoutItemAt(int idx)
+{
+    if(idx >= 0 && idx < (int) m_layoutItems.size())
+    {
+        IXLayoutItem* item = m_layoutItems[idx].item;
+
+        // remove from index
+        m_layoutItems.erase(m_layoutItems.begin() + idx);
+
+        // process item
+        _onItemRemoved(item);
+
+    } else
+    {
+        XWASSERT1(0, "XGridLayout::removelayoutItemAt index is out of range");
+    }
+}
+
+IXLayoutItem* XGridLayout::layoutItemAt(int idx) const
+{
+    if(idx >= 0 && idx < (int) m_layoutItems.size())
+    {
+        // return item
+        return m_layoutItems.at(idx).item;
+
+    } else
+    {
+        XWASSERT1(0, "XGridLayout::layoutItemAt index is out of range");
+        return 0;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// layout items by id (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::removelayoutItem(unsigned long itemId)
+{
+    // find item by id
+    for(std::vector<_ItemRef>::const_iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    {
+        if(it->item->layoutItemId() == itemId)
+        {
+            IXLayoutItem* item = it->item;
+
+            // remove item
+            m_layoutItems.erase(it);
+
+            // process item
+            _onItemRemoved(item);
+
+            // stop
+            break;
+        }
+    }
+}
+
+IXLayoutItem* XGridLayout::layoutItem(unsigned long itemId) const
+{
+    // find item by id
+    for(std::vector<_ItemRef>::const_iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    {
+        if(it->item->layoutItemId() == itemId)
+        {
+            // found
+            return it->item;
+        }
+    }
+
+    // not found
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// manipulations (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::update(int posX, int posY, int width, int height)
+{
+    // check if there are any items
+    if(m_layoutItems.size() == 0) return;
+
+    // NOTE: item visibility may be changed without notification (e.g. parent window is shown)
+    _checkItemsVisibility();
+
+    // update resize policies if some items have changed (keeps item constraints)
+    updateResizePolicies();
+
+    // size available for tracks
+    int contentWidth = width - (marginLeft() + marginRight());
+    int contentHeight = height - (marginTop() + marginBottom());
+
+    // NOTE: track sizes are kept until layout size or constraints are changed
+    if(!m_columnSizesValid || contentWidth != m_nContentWidth)
+    {
+        _updateTrackSizes(m_columns, contentWidth, m_nHorizontalSpacing);
+
+        m_nContentWidth = contentWidth;
+        m_columnSizesValid = true;
+    }
+
+    if(!m_rowSizesValid || contentHeight != m_nContentHeight)
+    {
+        _updateTrackSizes(m_rows, contentHeight, m_nVerticalSpacing);
+
+        m_nContentHeight = contentHeight;
+        m_rowSizesValid = true;
+    }
+
+    // content origin
+    posX += marginLeft();
+    posY += marginTop();
+
+    // update items
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        const _ItemRef& itemRef = m_layoutItems[idx];
+
+        // ignore not visible items
+        if(!itemRef.visible) continue;
+
+        // cell spanned by item
+        const _Track& firstColumn = m_columns[itemRef.column];
+        const _Track& lastColumn = m_columns[itemRef.column + itemRef.columnSpan - 1];
+        const _Track& firstRow = m_rows[itemRef.row];
+        const _Track& lastRow = m_rows[itemRef.row + itemRef.rowSpan - 1];
+
+        int cellWidth = lastColumn.pos + lastColumn.size - firstColumn.pos;
+        int cellHeight = lastRow.pos + lastRow.size - firstRow.pos;
+
+        // fit item into cell
+        int itemWidth = _fitItemSize(itemRef.hPolicy, itemRef.minWidth, itemRef.maxWidth, cellWidth);
+        int itemHeight = _fitItemSize(itemRef.vPolicy, itemRef.minHeight, itemRef.maxHeight, cellHeight);
+
+        // align item horizontally
+        int itemX = posX + firstColumn.pos;
+        if(itemWidth != cellWidth && (itemRef.alignment & eAlignLeft) == 0)
+        {
+            if(itemRef.alignment & eAlignRight)
+                itemX += cellWidth - itemWidth;
+            else if(itemRef.alignment & eAlignHCenter)
+                itemX += (cellWidth - itemWidth) / 2;
+        }
+
+        // align item vertically
+        int itemY = posY + firstRow.pos;
+        if(itemHeight != cellHeight && (itemRef.alignment & eAlignTop) == 0)
+        {
+            if(itemRef.alignment & eAlignBottom)
+                itemY += cellHeight - itemHeight;
+            else if(itemRef.alignment & eAlignVCenter)
+                itemY += (cellHeight - itemHeight) / 2;
+        }
+
+        itemRef.item->update(itemX, itemY, itemWidth, itemHeight);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// resize policy (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+IXLayoutItem::TResizePolicy XGridLayout::horizontalPolicy() const
+{
+    return m_rpHorizontal;
+}
+
+IXLayoutItem::TResizePolicy XGridLayout::verticalPolicy() const
+{
+    return m_rpVertical;
+}
+
+void XGridLayout::updateResizePolicies()
+{
+    // NOTE: aggregated constraints are kept until layout or any of its items is changed
+    if(m_constraintsValid) return;
+
+    if(m_tracksRebuildNeeded)
+    {
+        // query all items
+        for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+        {
+            _updateItemConstraints(m_layoutItems[idx]);
+        }
+
+        // place items into tracks and aggregate all tracks
+        _updateTrackItems();
+
+        for(size_t idx = 0; idx < m_columns.size(); ++idx)
+        {
+            _updateTrackBase(m_columns, (int)idx, true);
+        }
+
+        for(size_t idx = 0; idx < m_rows.size(); ++idx)
+        {
+            _updateTrackBase(m_rows, (int)idx, false);
+        }
+
+        m_tracksRebuildNeeded = false;
+
+    } else
+    {
+        // query changed items only
+        for(size_t idx = 0; idx < m_dirtyItems.size(); ++idx)
+        {
+            _updateItemConstraints(m_layoutItems[m_dirtyItems[idx]]);
+        }
+
+        // aggregate tracks changed items are placed in (NOTE: track may be aggregated twice)
+        for(size_t idx = 0; idx < m_dirtyItems.size(); ++idx)
+        {
+            const _ItemRef& itemRef = m_layoutItems[m_dirtyItems[idx]];
+
+            if(itemRef.columnSpan == 1) _updateTrackBase(m_columns, itemRef.column, true);
+            if(itemRef.rowSpan == 1) _updateTrackBase(m_rows, itemRef.row, false);
+        }
+    }
+
+    // reset changed items
+    for(size_t idx = 0; idx < m_dirtyItems.size(); ++idx)
+    {
+        m_layoutItems[m_dirtyItems[idx]].dirty = false;
+    }
+    m_dirtyItems.clear();
+
+    // apply items spanning several tracks
+    _updateSpannedTracks(m_columns, m_nHorizontalSpacing, true);
+    _updateSpannedTracks(m_rows, m_nVerticalSpacing, false);
+
+    // whole layout constraints
+    _updateLayoutConstraints(m_columns, m_nHorizontalSpacing, m_rpHorizontal, m_nMinWidth, m_nMaxWidth);
+    _updateLayoutConstraints(m_rows, m_nVerticalSpacing, m_rpVertical, m_nMinHeight, m_nMaxHeight);
+
+    // track sizes must be distributed again
+    m_constraintsValid = true;
+    m_columnSizesValid = false;
+    m_rowSizesValid = false;
+}
+
+/////////////////////////////////////////////////////////////////////
+// constraints change notification (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::invalidateResizePolicies()
+{
+    // layout itself has been changed, all tracks are aggregated again
+    m_tracksRebuildNeeded = true;
+
+    // NOTE: parent layouts are invalidated already if layout is not valid
+    if(!m_constraintsValid) return;
+
+    // reset flag
+    m_constraintsValid = false;
+
+    // inform parent layout
+    IXLayout::invalidateResizePolicies();
+}
+
+void XGridLayout::resetResizePolicies()
+{
+    // inform parent layout
+    invalidateResizePolicies();
+
+    // pass to items
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        m_layoutItems[idx].item->resetResizePolicies();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// size constraints (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+int XGridLayout::minWidth()  const
+{
+    return m_nMinWidth + marginLeft() + marginRight();
+}
+
+int XGridLayout::minHeight() const
+{
+    return m_nMinHeight + marginTop() + marginBottom();
+}
+
+int XGridLayout::maxWidth()  const
+{
+    return m_nMaxWidth + marginLeft() + marginRight();
+}
+
+int XGridLayout::maxHeight() const
+{
+    return m_nMaxHeight + marginTop() + marginBottom();
+}
+
+/////////////////////////////////////////////////////////////////////
+// child items (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::onLayoutItemDestroyed(IXLayoutItem* item)
+{
+    // find item
+    for(std::vector<_ItemRef>::iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    {
+        if(it->item == item)
+        {
+            // NOTE: item is being deleted, only reference is removed
+            m_layoutItems.erase(it);
+
+            // update constraints later
+            invalidateResizePolicies();
+
+            // stop
+            break;
+        }
+    }
+}
+
+void XGridLayout::onLayoutItemInvalidated(IXLayoutItem* item)
+{
+    // NOTE: all items are queried anyway if tracks are aggregated again
+    if(m_tracksRebuildNeeded)
+    {
+        invalidateResizePolicies();
+        return;
+    }
+
+    // find item
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        if(m_layoutItems[idx].item == item)
+        {
+            // query only this item
+            _invalidateItem(idx);
+            return;
+        }
+    }
+
+    // unknown item, update all
+    invalidateResizePolicies();
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::_addTracks(int rowCount, int columnCount)
+{
+    // add missing tracks with default properties
+    if(rowCount > (int)m_rows.size()) m_rows.resize(rowCount);
+    if(columnCount > (int)m_columns.size()) m_columns.resize(columnCount);
+}
+
+void XGridLayout::_onItemRemoved(IXLayoutItem* item)
+{
+    // reset parent reference
+    if(item->parentLayoutItem() == this) item->setParentLayoutItem(0);
+
+    // NOTE: item indexes are changed, items are placed into tracks again
+    invalidateResizePolicies();
+    updateResizePolicies();
+}
+
+void XGridLayout::_checkItemsVisibility()
+{
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // check if item has been shown or hidden since last update
+        if(m_layoutItems[idx].item->isVisible() != m_layoutItems[idx].visible)
+        {
+            // update item constraints
+            _invalidateItem(idx);
+        }
+    }
+}
+
+void XGridLayout::_invalidateItem(size_t idx)
+{
+    _ItemRef& itemRef = m_layoutItems[idx];
+
+    // remember changed item once
+    if(!m_tracksRebuildNeeded && !itemRef.dirty)
+    {
+        itemRef.dirty = true;
+        m_dirtyItems.push_back((int)idx);
+    }
+
+    // NOTE: parent layouts are invalidated already if layout is not valid
+    if(!m_constraintsValid) return;
+
+    // reset flag
+    m_constraintsValid = false;
+
+    // inform parent layout
+    IXLayout::invalidateResizePolicies();
+}
+
+void XGridLayout::_updateItemConstraints(_ItemRef& itemRef)
+{
+    // ignore not visible items
+    itemRef.visible = itemRef.item->isVisible();
+    if(!itemRef.visible) return;
+
+    // update policies for item first
+    itemRef.item->updateResizePolicies();
+
+    // NOTE: item constraints are kept for layout update, so that they are queried only once
+    itemRef.hPolicy = itemRef.item->horizontalPolicy();
+    itemRef.vPolicy = itemRef.item->verticalPolicy();
+    itemRef.minWidth = itemRef.item->minWidth();
+    itemRef.maxWidth = itemRef.item->maxWidth();
+    itemRef.minHeight = itemRef.item->minHeight();
+    itemRef.maxHeight = itemRef.item->maxHeight();
+}
+
+void XGridLayout::_updateTrackItems()
+{
+    // reset track items
+    for(size_t idx = 0; idx < m_columns.size(); ++idx) m_columns[idx].items.clear();
+    for(size_t idx = 0; idx < m_rows.size(); ++idx) m_rows[idx].items.clear();
+    m_spanItems.clear();
+
+    // NOTE: item spanning several tracks in one direction may be placed in one track in other one
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        const _ItemRef& itemRef = m_layoutItems[idx];
+
+        if(itemRef.columnSpan == 1) m_columns[itemRef.column].items.push_back((int)idx);
+        if(itemRef.rowSpan == 1) m_rows[itemRef.row].items.push_back((int)idx);
+        if(itemRef.columnSpan > 1 || itemRef.rowSpan > 1) m_spanItems.push_back((int)idx);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// layout methods
+/////////////////////////////////////////////////////////////////////
+void XGridLayout::_updateTrackBase(std::vector<_Track>& tracks, int trackIdx, bool horizontal)
+{
+    _Track& track = tracks[trackIdx];
+
+    // NOTE: track with stretch or size constraints is shown even without items
+    track.baseUsed = (track.stretch > 0 ||
+                      track.fixedMinSize != XGRID_LAYOUT_SIZE_NOT_SET ||
+                      track.fixedMaxSize != XGRID_LAYOUT_SIZE_NOT_SET);
+
+    track.baseHasMinSize = false;
+    track.baseHasMaxSize = true;
+    track.baseMinSize = 0;
+    track.baseMaxSize = XGRID_LAYOUT_SIZE_NOT_SET;
+
+    // 1. Items in one track
+    // if any item has min size then track has min size (maximum of those)
+    // if all items have max size then track has max size (maximum of those)
+
+    for(size_t idx = 0; idx < track.items.size(); ++idx)
+    {
+        const _ItemRef& itemRef = m_layoutItems[track.items[idx]];
+
+        // ignore not visible items
+        if(!itemRef.visible) continue;
+
+        // item constraints in this direction
+        TResizePolicy policy = horizontal ? itemRef.hPolicy : itemRef.vPolicy;
+        int minSize = horizontal ? itemRef.minWidth : itemRef.minHeight;
+        int maxSize = horizontal ? itemRef.maxWidth : itemRef.maxHeight;
+
+        track.baseUsed = true;
+
+        // minimum size
+        if(policy == eResizeMin || policy == eResizeMinMax)
+        {
+            track.baseHasMinSize = true;
+            if(minSize > track.baseMinSize) track.baseMinSize = minSize;
+        }
+
+        // maximum size
+        if(policy == eResizeMax || policy == eResizeMinMax)
+        {
+            if(maxSize > track.baseMaxSize) track.baseMaxSize = maxSize;
+
+        } else
+        {
+            track.baseHasMaxSize = false;
+        }
+    }
+
+    // 2. Track properties
+    // track size constraints override maximum size and extend minimum size
+
+    // track without items doesn't have maximum size by itself
+    if(track.baseMaxSize == XGRID_LAYOUT_SIZE_NOT_SET) track.baseHasMaxSize = false;
+
+    if(track.fixedMinSize != XGRID_LAYOUT_SIZE_NOT_SET)
+    {
+        track.baseHasMinSize = true;
+        if(track.fixedMinSize > track.baseMinSize) track.baseMinSize = track.fixedMinSize;
+    }
+
+    if(track.fixedMaxSize != XGRID_LAYOUT_SIZE_NOT_SET)
+    {
+        track.baseHasMaxSize = true;
+        track.baseMaxSize = track.fixedMaxSize;
+    }
+
+    // reset maximum size if not set
+    if(!track.baseHasMaxSize) track.baseMaxSize = 0;
+}
+
+void XGridLayout::_updateSpannedTracks(std::vector<_Track>& tracks, int spacing, bool horizontal)
+{
+    // start from constraints of tracks and their own items
+    for(size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        _Track& track = tracks[idx];
+
+        track.used = track.baseUsed;
+        track.hasMinSize = track.baseHasMinSize;
+        track.hasMaxSize = track.baseHasMaxSize;
+        track.minSize = track.baseMinSize;
+        track.maxSize = track.baseMaxSize;
+    }
+
+    // all tracks spanned by items are shown
+    for(size_t idx = 0; idx < m_spanItems.size(); ++idx)
+    {
+        const _ItemRef& itemRef = m_layoutItems[m_spanItems[idx]];
+
+        // ignore not visible items
+        if(!itemRef.visible) continue;
+
+        int trackIdx = horizontal ? itemRef.column : itemRef.row;
+        int span = horizontal ? itemRef.columnSpan : itemRef.rowSpan;
+
+        for(int spanIdx = 0; spanIdx < span; ++spanIdx)
+        {
+            tracks[trackIdx + spanIdx].used = true;
+        }
+    }
+
+    for(size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        _updateTrackPolicy(tracks[idx]);
+    }
+
+    // 3. Items spanning several tracks
+    // missing minimum size is added to spanned tracks equally
+
+    for(size_t idx = 0; idx < m_spanItems.size(); ++idx)
+    {
+        const _ItemRef& itemRef = m_layoutItems[m_spanItems[idx]];
+
+        // ignore not visible items
+        if(!itemRef.visible) continue;
+
+        // item constraints in this direction
+        int trackIdx = horizontal ? itemRef.column : itemRef.row;
+        int span = horizontal ? itemRef.columnSpan : itemRef.rowSpan;
+        TResizePolicy policy = horizontal ? itemRef.hPolicy : itemRef.vPolicy;
+        int minSize = horizontal ? itemRef.minWidth : itemRef.minHeight;
+
+        // ignore items in one track or without minimum size
+        if(span <= 1) continue;
+        if(policy != eResizeMin && policy != eResizeMinMax) continue;
+
+        // minimum size of spanned tracks (NOTE: all of them are used)
+        int spannedSize = (span - 1) * spacing;
+        for(int spanIdx = 0; spanIdx < span; ++spanIdx)
+        {
+            spannedSize += tracks[trackIdx + spanIdx].minSize;
+        }
+
+        // check if item fits
+        int sizeLeft = minSize - spannedSize;
+        if(sizeLeft <= 0) continue;
+
+        // extend tracks (rounding errors go to first tracks)
+        for(int spanIdx = 0; spanIdx < span; ++spanIdx)
+        {
+            _Track& track = tracks[trackIdx + spanIdx];
+
+            track.minSize += sizeLeft / span + ((spanIdx < sizeLeft % span) ? 1 : 0);
+            track.hasMinSize = true;
+
+            _updateTrackPolicy(track);
+        }
+    }
+}
+
+void XGridLayout::_updateTrackPolicy(_Track& track)
+{
+    // maximum size can't be less than minimum size
+    if(track.hasMaxSize && track.maxSize < track.minSize) track.maxSize = track.minSize;
+
+    // set policy
+    if(track.hasMinSize && track.hasMaxSize)
+        track.policy = eResizeMinMax;
+    else if(track.hasMinSize)
+        track.policy = eResizeMin;
+    else if(track.hasMaxSize)
+        track.policy = eResizeMax;
+    else
+        track.policy = eResizeAny;
+}
+
+void XGridLayout::_updateLayoutConstraints(const std::vector<_Track>& tracks, int spacing, TResizePolicy& policy, int& minSize, int& maxSize)
+{
+    // if any track has min size then whole layout has min size (sum of those)
+    // if all tracks have max size then whole layout has max size (sum of those)
+
+    bool hasMinSize = false;
+    bool hasMaxSize = true;
+    int usedCount = 0;
+
+    minSize = 0;
+    maxSize = 0;
+
+    for(size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        const _Track& track = tracks[idx];
+
+        // ignore collapsed tracks
+        if(!track.used) continue;
+
+        if(track.hasMinSize) hasMinSize = true;
+        if(!track.hasMaxSize) hasMaxSize = false;
+
+        minSize += track.minSize;
+        maxSize += track.maxSize;
+        ++usedCount;
+    }
+
+    // empty layout doesn't have maximum size
+    if(usedCount == 0) hasMaxSize = false;
+
+    // add spacing between tracks
+    if(usedCount > 1)
+    {
+        minSize += (usedCount - 1) * spacing;
+        maxSize += (usedCount - 1) * spacing;
+    }
+
+    // set policy
+    if(hasMinSize && hasMaxSize)
+        policy = eResizeMinMax;
+    else if(hasMinSize)
+        policy = eResizeMin;
+    else if(hasMaxSize)
+        policy = eResizeMax;
+    else
+        policy = eResizeAny;
+}
+
+void XGridLayout::_updateTrackSizes(std::vector<_Track>& tracks, int size, int spacing)
+{
+    // copy constraints of used tracks to solver
+    m_sizeSolver.clear();
+    for(size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        const _Track& track = tracks[idx];
+
+        // ignore collapsed tracks
+        if(!track.used) continue;
+
+        // NOTE: solver treats items with equal minimum and maximum size as fixed
+        m_sizeSolver.addItem(track.policy, track.minSize, track.hasMaxSize ? track.maxSize : INT_MAX, track.stretch);
+    }
+
+    // distribute size between tracks
+    int usedCount = m_sizeSolver.itemCount();
+    if(usedCount > 0) m_sizeSolver.solve(size - (usedCount - 1) * spacing);
+
+    // set track positions and sizes
+    int pos = 0;
+    int solverIdx = 0;
+    for(size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        _Track& track = tracks[idx];
+
+        // NOTE: collapsed track takes no space and no spacing
+        track.pos = pos;
+        if(!track.used)
+        {
+            track.size = 0;
+            continue;
+        }
+
+        track.size = m_sizeSolver.itemSize(solverIdx++);
+        pos += track.size + spacing;
+    }
+}
+
+int XGridLayout::_fitItemSize(TResizePolicy policy, int minSize, int maxSize, int cellSize) const
+{
+    // check if item can use full cell
+    if( (policy == eResizeAny) ||
+        (policy == eResizeMin && minSize <= cellSize) ||
+        (policy == eResizeMax && maxSize >= cellSize) ||
+        (policy == eResizeMinMax && minSize <= cellSize && maxSize >= cellSize)
+        )
+    {
+        return cellSize;
+    }
+
+    // item doesn't fit into cell
+    if((policy == eResizeMin || policy == eResizeMinMax) && minSize > cellSize) return minSize;
+
+    // item is smaller than cell
+    return maxSize;
+}
+
+// XGridLayout
+/////////////////////////////////////////////////////////////////////
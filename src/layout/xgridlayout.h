@@ -0,0 +1,209 @@
+// Grid layout engine
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XGRIDLAYOUT_H_
+#define _XGRIDLAYOUT_H_
+
+// NOTE: items are placed in cells of row and column tracks and may span several
+//       tracks. Item constraints are queried and aggregated to track constraints
+//       only after layout or any of its items has been changed. Track sizes are
+//       distributed by the same rules as in box layouts and kept until layout size
+//       or constraints are changed, so resize costs one pass over items.
+
+// NOTE: each track keeps aggregate of items placed only in it. If item reports change,
+//       only that item is queried again and only tracks it is placed in are aggregated
+//       again, items spanning several tracks are then applied to all tracks (without
+//       queries). Changes of layout properties or removed items aggregate all tracks.
+
+// NOTE: tracks without visible items, stretch or size constraints are collapsed
+//       (no size and no spacing)
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// track size constraint is not set
+#define XGRID_LAYOUT_SIZE_NOT_SET               (-1)
+
+/////////////////////////////////////////////////////////////////////
+// XGridLayout - grid layout engine
+
+class XGridLayout : public IXLayout,
+                    public XWObject
+{
+public: // construction/destruction
+    XGridLayout(XWObject* parent = 0);
+    virtual ~XGridLayout();
+
+public: // alignment in cell (flags)
+    enum TAlignment
+    {
+        eAlignLeft      = 0x0001,
+        eAlignRight     = 0x0002,
+        eAlignHCenter   = 0x0004,
+        eAlignTop       = 0x0010,
+        eAlignBottom    = 0x0020,
+        eAlignVCenter   = 0x0040,
+        eAlignCenter    = eAlignHCenter | eAlignVCenter
+    };
+
+public: // add items
+    void    addItem(IXLayoutItem* item, int row, int column, int rowSpan = 1, int columnSpan = 1, int alignment = eAlignCenter);
+
+public: // grid size
+    int     rowCount() const        { return (int)m_rows.size(); }
+    int     columnCount() const     { return (int)m_columns.size(); }
+
+public: // track stretch factors
+    void    setRowStretch(int row, int stretch);
+    void    setColumnStretch(int column, int stretch);
+    int     rowStretch(int row) const;
+    int     columnStretch(int column) const;
+
+public: // track size constraints (XGRID_LAYOUT_SIZE_NOT_SET to use item constraints only)
+    void    setRowMinMaxHeight(int row, int minHeight, int maxHeight);
+    void    setColumnMinMaxWidth(int column, int minWidth, int maxWidth);
+
+public: // item spacing
+    void    setSpacing(int spacing);
+    void    setHorizontalSpacing(int spacing);
+    void    setVerticalSpacing(int spacing);
+    int     horizontalSpacing() const   { return m_nHorizontalSpacing; }
+    int     verticalSpacing() const     { return m_nVerticalSpacing; }
+
+public: // enum layout items (from IXLayout)
+    int             layoutItemCount() const;
+    void            removelayoutItemAt(int idx);
+    IXLayoutItem*   layoutItemAt(int idx) const;
+
+public: // layout items by id (from IXLayout)
+    void            removelayoutItem(unsigned long itemId);
+    IXLayoutItem*   layoutItem(unsigned long itemId) const;
+
+public: // manipulations (from IXLayout)
+    void    update(int posX, int posY, int width, int height);
+
+public: // resize policy (from IXLayout)
+    TResizePolicy   horizontalPolicy() const;
+    TResizePolicy   verticalPolicy() const;
+    void            updateResizePolicies();
+
+public: // constraints change notification (from IXLayout)
+    void    invalidateResizePolicies();
+    void    resetResizePolicies();
+
+public: // size constraints (from IXLayout)
+    int     minWidth()  const;
+    int     minHeight() const;
+    int     maxWidth()  const;
+    int     maxHeight() const;
+
+protected: // child items (from IXLayout)
+    void    onLayoutItemDestroyed(IXLayoutItem* item);
+    void    onLayoutItemInvalidated(IXLayoutItem* item);
+
+private: // item reference
+    struct _ItemRef
+    {
+        // layout data
+        IXLayoutItem*   item;
+        int             row, column;
+        int             rowSpan, columnSpan;
+        int             alignment;
+
+        // constraints (kept by updateResizePolicies)
+        bool            dirty;
+        bool            visible;
+        TResizePolicy   hPolicy, vPolicy;
+        int             minWidth, maxWidth;
+        int             minHeight, maxHeight;
+    };
+
+private: // track
+    struct _Track
+    {
+        // properties
+        int             stretch;
+        int             fixedMinSize;
+        int             fixedMaxSize;
+
+        // items placed only in this track (indexes)
+        std::vector<int>    items;
+
+        // constraints of track and its own items (without items spanning several tracks)
+        bool            baseUsed;
+        bool            baseHasMinSize;
+        bool            baseHasMaxSize;
+        int             baseMinSize;
+        int             baseMaxSize;
+
+        // aggregated constraints
+        bool            used;
+        bool            hasMinSize;
+        bool            hasMaxSize;
+        TResizePolicy   policy;
+        int             minSize;
+        int             maxSize;
+
+        // layout cache
+        int             pos;
+        int             size;
+
+        // default values (base constraints of empty track)
+        _Track() : stretch(0), fixedMinSize(XGRID_LAYOUT_SIZE_NOT_SET), fixedMaxSize(XGRID_LAYOUT_SIZE_NOT_SET),
+                   baseUsed(false), baseHasMinSize(false), baseHasMaxSize(false), baseMinSize(0), baseMaxSize(0),
+                   used(false), hasMinSize(false), hasMaxSize(false), policy(eResizeAny), minSize(0), maxSize(0), 
+                   pos(0), size(0) {}
+    };
+
+private: // worker methods
+    void    _addTracks(int rowCount, int columnCount);
+    void    _onItemRemoved(IXLayoutItem* item);
+    void    _checkItemsVisibility();
+    void    _invalidateItem(size_t idx);
+    void    _updateItemConstraints(_ItemRef& itemRef);
+    void    _updateTrackItems();
+
+private: // layout methods
+    void    _updateTrackBase(std::vector<_Track>& tracks, int trackIdx, bool horizontal);
+    void    _updateSpannedTracks(std::vector<_Track>& tracks, int spacing, bool horizontal);
+    void    _updateTrackPolicy(_Track& track);
+    void    _updateLayoutConstraints(const std::vector<_Track>& tracks, int spacing, TResizePolicy& policy, int& minSize, int& maxSize);
+    void    _updateTrackSizes(std::vector<_Track>& tracks, int size, int spacing);
+    int     _fitItemSize(TResizePolicy policy, int minSize, int maxSize, int cellSize) const;
+
+private: // items
+    std::vector<_ItemRef>       m_layoutItems;
+    std::vector<int>            m_spanItems;
+    std::vector<int>            m_dirtyItems;
+
+private: // tracks
+    std::vector<_Track>         m_rows;
+    std::vector<_Track>         m_columns;
+    XLayoutSizeSolver           m_sizeSolver;
+
+private: // layout cache
+    bool    m_constraintsValid;
+    bool    m_tracksRebuildNeeded;
+    bool    m_columnSizesValid;
+    bool    m_rowSizesValid;
+    int     m_nContentWidth;
+    int     m_nContentHeight;
+
+private: // policy
+    TResizePolicy   m_rpHorizontal;
+    TResizePolicy   m_rpVertical;
+
+private: // data
+    int     m_nHorizontalSpacing;
+    int     m_nVerticalSpacing;
+    int     m_nMinWidth;
+    int     m_nMinHeight;
+    int     m_nMaxWidth;
+    int     m_nMaxHeight;
+};
+
+// XGridLayout
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XGRIDLAYOUT_H_
@@ -2,10 +2,11 @@
 //
 /////////////////////////////////////////////////////////////////////
 
-#include "../xwui_config.h"
+#include "../core/xwcore_config.h"
 
 #include "xlayoutitem.h"
 #include "xlayout.h"
+#include "xlayoutsizesolver.h"
 #include "xhboxlayout.h"
 
 /////////////////////////////////////////////////////////////////////
@@ -43,6 +44,7 @@ XHBoxLayout::XHBoxLayout(XWObject* parent) :
     m_visibleCount(0),
     m_rpHorizontal(eResizeAny),
     m_rpVertical(eResizeAny),
+    m_resizePoliciesValid(false),
     m_nMinWidth(0),
     m_nMinHeight(0),
     m_nMaxWidth(0),
@@ -52,6 +54,13 @@ XHBoxLayout::XHBoxLayout(XWObject* parent) :
 
 XHBoxLayout::~XHBoxLayout()
 {
+    // NOTE: items may be deleted after layout
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        if(m_layoutItems[idx].item->parentLayoutItem() == this) 
+            m_layoutItems[idx].item->setParentLayoutItem(0);
+    }
+
     // delete all space items
     for(size_t idx = 0; idx < m_spaceItems.size(); ++idx)
     {
@@ -111,6 +120,9 @@ void XHBoxLayout::addStretchItem(int stretch)
 void XHBoxLayout::setSpacing(int spacing)
 {
     m_nSpacing = spacing;
+
+    // spacing is part of layout size constraints
+    invalidateResizePolicies();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -125,9 +137,14 @@ void XHBoxLayout::removelayoutItemAt(int idx)
 {
     if(idx >= 0 && idx < (int) m_layoutItems.size())
     {
+        IXLayoutItem* item = m_layoutItems[idx].item;
+
         // remove from index
         m_layoutItems.erase(m_layoutItems.begin() + idx);
 
+        // process item
+        _onItemRemoved(item);
+
     } else
     {
         XWASSERT1(0, "XHBoxLayout::removelayoutItemAt index is out of range");
@@ -158,9 +175,14 @@ void XHBoxLayout::removelayoutItem(unsigned long itemId)
     {
         if(it->item->layoutItemId() == itemId)
         {
+            IXLayoutItem* item = it->item;
+
             // remove item
             m_layoutItems.erase(it);
 
+            // process item
+            _onItemRemoved(item);
+
             // stop
             break;
         }
@@ -191,10 +213,10 @@ void XHBoxLayout::update(int posX, int posY, int width, int height)
     // check if there are any items
     if(m_layoutItems.size() == 0) return;
 
-    // update visible items count
-    _updateVisibleCount();
+    // NOTE: item visibility may be changed without notification (e.g. parent window is shown)
+    _checkItemsVisibility();
 
-    // update resize policies in case some items have changed
+    // update resize policies if some items have changed (keeps item constraints)
     updateResizePolicies();
 
     // position items vertically
@@ -208,7 +230,7 @@ void XHBoxLayout::update(int posX, int posY, int width, int height)
     for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
     {
         // ignore not visible items
-        if(!m_layoutItems[idx].item->isVisible()) continue;
+        if(!m_layoutItems[idx].visible) continue;
 
         m_layoutItems[idx].posX = posX;
         posX += m_layoutItems[idx].width + m_nSpacing;
@@ -218,7 +240,7 @@ void XHBoxLayout::update(int posX, int posY, int width, int height)
     for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
     {
         // ignore not visible items
-        if(!m_layoutItems[idx].item->isVisible()) continue;
+        if(!m_layoutItems[idx].visible) continue;
 
         m_layoutItems[idx].item->update(m_layoutItems[idx].posX, m_layoutItems[idx].posY,
             m_layoutItems[idx].width, m_layoutItems[idx].height);
@@ -240,9 +262,10 @@ IXLayoutItem::TResizePolicy XHBoxLayout::verticalPolicy() const
 
 void XHBoxLayout::updateResizePolicies()
 {
-    // reset policy
-    m_rpHorizontal = eResizeAny;
-    m_rpVertical = eResizeAny;
+    // NOTE: aggregated constraints are kept until layout or any of its items is changed
+    if(m_resizePoliciesValid) return;
+
+    // reset sizes
     m_nMinWidth = 0;
     m_nMinHeight = 0;
     m_nMaxWidth = 0;
@@ -256,55 +279,47 @@ void XHBoxLayout::updateResizePolicies()
     // if any item has min size then whole layout has min size (maximum of those)
     // if any item has max size then whole layout has max size (maximum of those)
 
-    bool hMinSize = false;
-    bool hMaxSize = true;
-    bool vMinSize = false;
-    bool vMaxSize = false;
-    
+    // NOTE: policies of empty layout (see _addItemConstraints)
+    m_rpHorizontal = eResizeMax;
+    m_rpVertical = eResizeAny;
+
     for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
     {
-        // ignore not visible items
-        if(!m_layoutItems[idx].item->isVisible()) continue;
-
-        // update policies for item first
-        m_layoutItems.at(idx).item->updateResizePolicies();
+        _addItemConstraints(m_layoutItems[idx]);
+    }
 
-        // policies
-        TResizePolicy hPolicy = m_layoutItems.at(idx).item->horizontalPolicy();
-        TResizePolicy vPolicy = m_layoutItems.at(idx).item->verticalPolicy();
+    // update visible items count
+    _updateVisibleCount();
 
-        // horizontal
-        if(hPolicy == eResizeMin || hPolicy == eResizeMinMax) hMinSize = true;
-        if(hPolicy == eResizeAny || hPolicy == eResizeMin) hMaxSize = false;
+    // constraints are valid until changed
+    m_resizePoliciesValid = true;
+}
 
-        // vertical
-        if(vPolicy == eResizeMin || vPolicy == eResizeMinMax) vMinSize = true;
-        if(vPolicy == eResizeMax || vPolicy == eResizeMinMax) vMaxSize = true;
+/////////////////////////////////////////////////////////////////////
+// constraints change notification (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XHBoxLayout::invalidateResizePolicies()
+{
+    // NOTE: parent layouts are invalidated already if layout is not valid
+    if(!m_resizePoliciesValid) return;
 
-        // sum widths
-        m_nMinWidth += m_layoutItems.at(idx).item->minWidth();
-        m_nMaxWidth += m_layoutItems.at(idx).item->maxWidth();
+    // reset flag
+    m_resizePoliciesValid = false;
 
-        // maximum for heights
-        if(m_layoutItems.at(idx).item->minHeight() > m_nMinHeight) m_nMinHeight = m_layoutItems.at(idx).item->minHeight();
-        if(m_layoutItems.at(idx).item->maxHeight() > m_nMaxHeight) m_nMaxHeight = m_layoutItems.at(idx).item->maxHeight();
-    }
+    // inform parent layout
+    IXLayout::invalidateResizePolicies();
+}
 
-    // horizontal
-    if(hMinSize && hMaxSize)
-        m_rpHorizontal = eResizeMinMax;
-    else if(hMinSize)
-        m_rpHorizontal = eResizeMin;
-    else if(hMaxSize)
-        m_rpHorizontal = eResizeMax;
+void XHBoxLayout::resetResizePolicies()
+{
+    // inform parent layout
+    invalidateResizePolicies();
 
-    // vertical
-    if(vMinSize && vMaxSize)
-        m_rpVertical = eResizeMinMax;
-    else if(vMinSize)
-        m_rpVertical = eResizeMin;
-    else if(vMaxSize)
-        m_rpVertical = eResizeMax;
+    // pass to items
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        m_layoutItems[idx].item->resetResizePolicies();
+    }
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -336,21 +351,135 @@ int XHBoxLayout::maxHeight() const
     return m_nMaxHeight + marginTop() + marginBottom();
 }
 
+/////////////////////////////////////////////////////////////////////
+// child items (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XHBoxLayout::onLayoutItemDestroyed(IXLayoutItem* item)
+{
+    // find item
+    for(std::vector<_ItemRef>::iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    {
+        if(it->item == item)
+        {
+            // NOTE: item is being deleted, only reference is removed
+            m_layoutItems.erase(it);
+
+            // update constraints later
+            invalidateResizePolicies();
+
+            // stop
+            break;
+        }
+    }
+}
+
 /////////////////////////////////////////////////////////////////////
 // worker methods
 /////////////////////////////////////////////////////////////////////
 void XHBoxLayout::_onItemAdded(IXLayoutItem* item)
 {
+    // item informs layout about its changes
+    item->setParentLayoutItem(this);
+
+    // NOTE: new item is added to valid constraints, other items are not queried again
+    if(m_resizePoliciesValid)
+    {
+        _addItemConstraints(m_layoutItems.back());
+        if(m_layoutItems.back().visible) m_visibleCount++;
+
+        // inform parent layout
+        IXLayout::invalidateResizePolicies();
+        return;
+    }
+
     // update policy
     updateResizePolicies();
 }
 
 void XHBoxLayout::_onItemRemoved(IXLayoutItem* item)
 {
+    // reset parent reference
+    if(item->parentLayoutItem() == this) item->setParentLayoutItem(0);
+
     // update policy
+    invalidateResizePolicies();
     updateResizePolicies();
 }
 
+void XHBoxLayout::_checkItemsVisibility()
+{
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // check if item has been shown or hidden since last update
+        if(m_layoutItems[idx].item->isVisible() != m_layoutItems[idx].visible)
+        {
+            // update constraints
+            invalidateResizePolicies();
+            return;
+        }
+    }
+}
+
+void XHBoxLayout::_addItemConstraints(_ItemRef& itemRef)
+{
+    // ignore not visible items
+    itemRef.visible = itemRef.item->isVisible();
+    if(!itemRef.visible) return;
+
+    // update policies for item first
+    itemRef.item->updateResizePolicies();
+
+    // NOTE: item constraints are kept for layout update, so that they are queried only once
+    itemRef.hPolicy = itemRef.item->horizontalPolicy();
+    itemRef.vPolicy = itemRef.item->verticalPolicy();
+    itemRef.minWidth = itemRef.item->minWidth();
+    itemRef.maxWidth = itemRef.item->maxWidth();
+    itemRef.minHeight = itemRef.item->minHeight();
+    itemRef.maxHeight = itemRef.item->maxHeight();
+
+    // NOTE: policies keep aggregated flags of items added before
+    bool hMinSize = (m_rpHorizontal == eResizeMin || m_rpHorizontal == eResizeMinMax);
+    bool hMaxSize = (m_rpHorizontal == eResizeMax || m_rpHorizontal == eResizeMinMax);
+    bool vMinSize = (m_rpVertical == eResizeMin || m_rpVertical == eResizeMinMax);
+    bool vMaxSize = (m_rpVertical == eResizeMax || m_rpVertical == eResizeMinMax);
+
+    // horizontal
+    if(itemRef.hPolicy == eResizeMin || itemRef.hPolicy == eResizeMinMax) hMinSize = true;
+    if(itemRef.hPolicy == eResizeAny || itemRef.hPolicy == eResizeMin) hMaxSize = false;
+
+    // vertical
+    if(itemRef.vPolicy == eResizeMin || itemRef.vPolicy == eResizeMinMax) vMinSize = true;
+    if(itemRef.vPolicy == eResizeMax || itemRef.vPolicy == eResizeMinMax) vMaxSize = true;
+
+    // sum widths
+    m_nMinWidth += itemRef.minWidth;
+    m_nMaxWidth += itemRef.maxWidth;
+
+    // maximum for heights
+    if(itemRef.minHeight > m_nMinHeight) m_nMinHeight = itemRef.minHeight;
+    if(itemRef.maxHeight > m_nMaxHeight) m_nMaxHeight = itemRef.maxHeight;
+
+    // horizontal
+    if(hMinSize && hMaxSize)
+        m_rpHorizontal = eResizeMinMax;
+    else if(hMinSize)
+        m_rpHorizontal = eResizeMin;
+    else if(hMaxSize)
+        m_rpHorizontal = eResizeMax;
+    else
+        m_rpHorizontal = eResizeAny;
+
+    // vertical
+    if(vMinSize && vMaxSize)
+        m_rpVertical = eResizeMinMax;
+    else if(vMinSize)
+        m_rpVertical = eResizeMin;
+    else if(vMaxSize)
+        m_rpVertical = eResizeMax;
+    else
+        m_rpVertical = eResizeAny;
+}
+
 /////////////////////////////////////////////////////////////////////
 // layout methods
 /////////////////////////////////////////////////////////////////////
@@ -360,7 +489,7 @@ void XHBoxLayout::_updateVisibleCount()
     m_visibleCount = 0;
     for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
     {
-        if(m_layoutItems.at(idx).item->isVisible()) m_visibleCount++;
+        if(m_layoutItems.at(idx).visible) m_visibleCount++;
     }
 }
 
@@ -372,12 +501,12 @@ void XHBoxLayout::_updateVerticalLayout(int posY, int height)
     for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
     {
         // ignore not visible items
-        if(!m_layoutItems[idx].item->isVisible()) continue;
+        if(!m_layoutItems[idx].visible) continue;
 
         // get item resize constraints
-        IXLayoutItem::TResizePolicy policy = m_layoutItems[idx].item->verticalPolicy();
-        int minHeight = m_layoutItems[idx].item->minHeight();
-        int maxHeight = m_layoutItems[idx].item->maxHeight();
+        IXLayoutItem::TResizePolicy policy = m_layoutItems[idx].vPolicy;
+        int minHeight = m_layoutItems[idx].minHeight;
+        int maxHeight = m_layoutItems[idx].maxHeight;
 
         // check if item can use full height
         if( (policy == IXLayoutItem::eResizeAny) ||
@@ -415,130 +544,6 @@ void XHBoxLayout::_updateVerticalLayout(int posY, int height)
     }
 }
 
-void XHBoxLayout::_initLayoutCache(int& fixedSize, int& freeItems, int& totalStretch)
-{
-    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
-    {
-        // ignore not visible items
-        if(!m_layoutItems[idx].item->isVisible()) continue;
-
-        // get item
-        IXLayoutItem* item = m_layoutItems[idx].item;
-
-        // reset initial width
-        m_layoutItems[idx].width = 0;
-
-        // check if item has fixed width
-        if(item->horizontalPolicy() != IXLayoutItem::eResizeAny && 
-           item->minWidth() == item->maxWidth())
-        {
-            // set needed width
-            m_layoutItems[idx].width = item->minWidth();
-
-            // item is ready (can't resize)
-            m_layoutItems[idx].ready = true;
-
-            // decrease counter
-            --freeItems;
-
-            // update reserved space
-            fixedSize += m_layoutItems[idx].width;
-
-        } else 
-        {
-            // reset width with minimum size
-            m_layoutItems[idx].width = item->minWidth();
-
-            // reset flag
-            m_layoutItems[idx].ready = false;
-
-            // update stretch factor if any
-            totalStretch += m_layoutItems[idx].stretch;
-        }
-    }
-}
-
-void XHBoxLayout::_findItemSize(int& sizeLeft, int& itemsLeft, int& stretchItems, bool preserveMinSize)
-{
-    // init counters
-    int proposedSize = 0;
-    float stretchFactor = 0;
-    bool sizeFound = false;
-
-    // loop over all items to make sure size is preserved
-    while(sizeLeft > 0 && itemsLeft > 0 && !sizeFound)
-    {
-        // check if there are stretch items
-        if(stretchItems)
-        {
-            // only stretchable items can grow -> compute stretching multiplier
-            stretchFactor = (float)sizeLeft / (float)stretchItems;
-
-        } else
-        {
-            // no stretching rules set-> all items can get same size
-            proposedSize = sizeLeft / itemsLeft;
-        }
-        
-        // check items
-        sizeFound = true;
-        for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
-        {
-            // ignore not visible items
-            if(!m_layoutItems[idx].item->isVisible()) continue;
-
-            // ignore if ready
-            if(m_layoutItems[idx].ready) continue;
-
-            // get item
-            IXLayoutItem* item = m_layoutItems[idx].item;
-
-            // update proposed size for item if stretching is in use
-            if(stretchItems) proposedSize = (int)(m_layoutItems[idx].stretch * stretchFactor);
-
-            // check if size fits item constraints
-            if(preserveMinSize)
-            {
-                if((item->horizontalPolicy() == IXLayoutItem::eResizeMin ||
-                    item->horizontalPolicy() == IXLayoutItem::eResizeMinMax) &&
-                    proposedSize < item->minWidth())
-                {
-                    // set item size
-                    m_layoutItems[idx].width = item->minWidth();
-                    sizeFound = false;
-                }
-
-            } else 
-            {
-                if((item->horizontalPolicy() == IXLayoutItem::eResizeMax ||
-                    item->horizontalPolicy() == IXLayoutItem::eResizeMinMax) &&
-                    proposedSize > item->maxWidth())
-                {
-                    // set item size
-                    m_layoutItems[idx].width = item->maxWidth();
-                    sizeFound = false;
-                }
-            }
-
-            // check if search has to stop
-            if(!sizeFound)
-            {
-                // fix item size
-                m_layoutItems[idx].ready = true;
-
-                // reduce size
-                sizeLeft -= m_layoutItems[idx].width;
-
-                // decrease total strecth factor if any
-                stretchItems -= m_layoutItems[idx].stretch;
-
-                // size has to be iterated again
-                break;
-            }
-        }
-    }
-}
-
 void XHBoxLayout::_updateHorizontalLayout(int posX, int width)
 {
     // total margins
@@ -547,80 +552,28 @@ void XHBoxLayout::_updateHorizontalLayout(int posX, int width)
     // count spacing needed for all items
     int spacing = m_visibleCount > 0 ? (m_visibleCount - 1) * m_nSpacing : 0;
 
-    // init counters
-    int fixedSize = marginX + spacing;
-    int itemsLeft = m_visibleCount;
-    int stretchItems = 0;
-
-    // init layout cache
-    _initLayoutCache(fixedSize, itemsLeft, stretchItems);
-
-    // size left
-    int sizeLeft = width - fixedSize;
-
-    // check if there is any size left to position items
-    if(sizeLeft <= 0 || itemsLeft <= 0)
-    {
-        // NOTE: all minimum and fixed sized items where set in _initLayoutCache, 
-        //       others will have zero height
-        return;
-    }
-
-    // loop over all items to make sure minimum size is preserved
-    _findItemSize(sizeLeft, itemsLeft, stretchItems, true);
-
-    // loop over all items to make sure maximum size is preserved
-    _findItemSize(sizeLeft, itemsLeft, stretchItems, false);
-
-    // check if there is any size left to position items
-    if(sizeLeft <= 0) return;
-
-    // init counters
-    int proposedSize = 0;
-    float stretchFactor = 0;
-
-    // check if there are stretch items
-    if(stretchItems)
-    {
-        // only stretchable items can grow -> compute stretching multiplier
-        stretchFactor = (float)sizeLeft / (float)stretchItems;
-
-    } else
-    {
-        // no stretching rules set-> all items can get same size
-        proposedSize = sizeLeft / itemsLeft;
-    }
-
-    // layout items
+    // copy constraints of visible items to solver
+    m_sizeSolver.clear();
     for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
     {
         // ignore not visible items
-        if(!m_layoutItems[idx].item->isVisible()) continue;
-
-        // ignore if ready
-        if(m_layoutItems[idx].ready) continue;
+        if(!m_layoutItems[idx].visible) continue;
 
-        // set item size
-        if(stretchItems)
-            m_layoutItems[idx].width = (int) (m_layoutItems[idx].stretch * stretchFactor);
-        else
-            m_layoutItems[idx].width = proposedSize;
-
-        // update size
-        sizeLeft -= m_layoutItems[idx].width;
+        m_sizeSolver.addItem(m_layoutItems[idx].hPolicy, m_layoutItems[idx].minWidth, 
+                             m_layoutItems[idx].maxWidth, m_layoutItems[idx].stretch);
     }
 
-    // distribute rounding errors if any
-    for(int loopIdx = 0; loopIdx < (int)m_layoutItems.size() && sizeLeft > 0; ++loopIdx)
+    // distribute width between items
+    m_sizeSolver.solve(width - (marginX + spacing));
+
+    // set item widths
+    int solverIdx = 0;
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
     {
         // ignore not visible items
-        if(!m_layoutItems[loopIdx].item->isVisible()) continue;
-
-        // add one pixel to each item
-        if(!m_layoutItems[loopIdx].ready) m_layoutItems[loopIdx].width++;
+        if(!m_layoutItems[idx].visible) continue;
 
-        // reduce size
-        --sizeLeft;
+        m_layoutItems[idx].width = m_sizeSolver.itemSize(solverIdx++);
     }
 }
 
@@ -51,23 +51,18 @@ public: // resize policy (from IXLayout)
     TResizePolicy   verticalPolicy() const;
     void            updateResizePolicies();
 
+public: // constraints change notification (from IXLayout)
+    void    invalidateResizePolicies();
+    void    resetResizePolicies();
+
 public: // size constraints (from IXLayout)
     int     minWidth()  const;
     int     minHeight() const;
     int     maxWidth()  const;
     int     maxHeight() const;
 
-private: // worker methods
-    void    _onItemAdded(IXLayoutItem* item);
-    void    _onItemRemoved(IXLayoutItem* item);
-    void    _updateResizePolicy();
-
-private: // layout methods
-    void    _updateVisibleCount();
-    void    _updateVerticalLayout(int posY, int height);
-    void    _initLayoutCache(int& fixedSize, int& freeItems, int& totalStretch);
-    void    _findItemSize(int& sizeLeft, int& itemsLeft, int& stretchItems, bool preserveMinSize);
-    void    _updateHorizontalLayout(int posX, int width);
+protected: // child items (from IXLayout)
+    void    onLayoutItemDestroyed(IXLayoutItem* item);
 
 private: // item reference
     struct _ItemRef
@@ -77,20 +72,41 @@ private: // item reference
         TAlignment      alignment;
         int             stretch;
 
+        // constraints (kept by updateResizePolicies)
+        bool            visible;
+        TResizePolicy   hPolicy, vPolicy;
+        int             minWidth, maxWidth;
+        int             minHeight, maxHeight;
+
         // resizing cache
         int     posX, posY;
         int     width, height;
-        bool    ready;
     };
 
+private: // worker methods
+    void    _onItemAdded(IXLayoutItem* item);
+    void    _onItemRemoved(IXLayoutItem* item);
+    void    _updateResizePolicy();
+    void    _checkItemsVisibility();
+    void    _addItemConstraints(_ItemRef& itemRef);
+
+private: // layout methods
+    void    _updateVisibleCount();
+    void    _updateVerticalLayout(int posY, int height);
+    void    _updateHorizontalLayout(int posX, int width);
+
 private: // items
     std::vector<_ItemRef>       m_layoutItems;
     std::vector<IXLayoutItem*>  m_spaceItems;
     int                         m_visibleCount;
 
+private: // size solver
+    XLayoutSizeSolver           m_sizeSolver;
+
 private: // policy
     TResizePolicy   m_rpHorizontal;
     TResizePolicy   m_rpVertical;
+    bool            m_resizePoliciesValid;
 
 private: // data
     int     m_nSpacing;
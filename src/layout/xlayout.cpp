@@ -2,7 +2,7 @@
 //
 /////////////////////////////////////////////////////////////////////
 
-#include "../xwui_config.h"
+#include "../core/xwcore_config.h"
 
 #include "xlayoutitem.h"
 #include "xlayout.h"
@@ -31,6 +31,9 @@ void IXLayout::setContentMargins(int left, int top, int right, int bottom)
     m_nMarginTop = top;
     m_nMarginRight = right;
     m_nMarginBottom = bottom;
+
+    // margins are part of layout size constraints
+    invalidateResizePolicies();
 }
 
 // IXLayout
@@ -2,19 +2,22 @@
 //
 /////////////////////////////////////////////////////////////////////
 
-#include "../xwui_config.h"
+#include "../core/xwcore_config.h"
 
 #include "xlayoutitem.h"
 
 /////////////////////////////////////////////////////////////////////
 // IXLayoutItem - layout item interface
 /////////////////////////////////////////////////////////////////////
-IXLayoutItem::IXLayoutItem()
+IXLayoutItem::IXLayoutItem() :
+    m_pParentLayoutItem(0)
 {
 }
 
 IXLayoutItem::~IXLayoutItem()
 {
+    // NOTE: parent layout must not keep reference to deleted item
+    if(m_pParentLayoutItem) m_pParentLayoutItem->onLayoutItemDestroyed(this);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -58,6 +61,20 @@ void IXLayoutItem::updateResizePolicies()
     // do nothing in default implementation
 }
 
+/////////////////////////////////////////////////////////////////////
+// constraints change notification
+/////////////////////////////////////////////////////////////////////
+void IXLayoutItem::invalidateResizePolicies()
+{
+    // NOTE: item doesn't cache constraints by default, inform parent layout only
+    if(m_pParentLayoutItem) m_pParentLayoutItem->onLayoutItemInvalidated(this);
+}
+
+void IXLayoutItem::resetResizePolicies()
+{
+    // do nothing in default implementation
+}
+
 /////////////////////////////////////////////////////////////////////
 // size constraints (default implementation)
 /////////////////////////////////////////////////////////////////////
@@ -81,6 +98,20 @@ int IXLayoutItem::maxHeight()  const
     return 0;
 }
 
+/////////////////////////////////////////////////////////////////////
+// child items
+/////////////////////////////////////////////////////////////////////
+void IXLayoutItem::onLayoutItemDestroyed(IXLayoutItem* item)
+{
+    // do nothing in default implementation
+}
+
+void IXLayoutItem::onLayoutItemInvalidated(IXLayoutItem* item)
+{
+    // constraints of whole item depend on child item by default
+    invalidateResizePolicies();
+}
+
 // IXLayoutItem
 /////////////////////////////////////////////////////////////////////
 
@@ -5,6 +5,13 @@
 #ifndef _XLAYOUTITEM_H_
 #define _XLAYOUTITEM_H_
 
+// NOTE: layouts cache constraints of their items and aggregated constraints between
+//       updates. Item must call invalidateResizePolicies when its size constraints or
+//       visibility are changed, so that parent layouts (set by layout when item is
+//       added) query it again. resetResizePolicies drops cached constraints of whole
+//       item subtree (used when content is changed without notification). Parent gets
+//       changed item in onLayoutItemInvalidated, so it may query only that item again.
+
 /////////////////////////////////////////////////////////////////////
 // IXLayoutItem - layout item interface
 
@@ -34,11 +41,26 @@ public: // resize policy
     virtual TResizePolicy   verticalPolicy() const;
     virtual void            updateResizePolicies();
 
+public: // constraints change notification
+    virtual void            invalidateResizePolicies();
+    virtual void            resetResizePolicies();
+
+public: // parent layout item (set by layouts)
+    void            setParentLayoutItem(IXLayoutItem* parent)   { m_pParentLayoutItem = parent; }
+    IXLayoutItem*   parentLayoutItem() const                    { return m_pParentLayoutItem; }
+
 public: // size constraints
     virtual int minWidth()  const;
     virtual int minHeight() const;
     virtual int maxWidth()  const;
     virtual int maxHeight() const;
+
+protected: // child items
+    virtual void    onLayoutItemDestroyed(IXLayoutItem* item);
+    virtual void    onLayoutItemInvalidated(IXLayoutItem* item);
+
+private: // parent layout item
+    IXLayoutItem*   m_pParentLayoutItem;
 };
 
 // IXLayoutItem
@@ -0,0 +1,421 @@
+// Layout size distribution solver
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "../core/xwcore_config.h"
+
+#include "xlayoutitem.h"
+#include "xlayoutsizesolver.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// upper limit used to move float threshold up
+#define XLAYOUT_SOLVER_THRESHOLD_UP         ((float)INT_MAX)
+
+/////////////////////////////////////////////////////////////////////
+// XLayoutSizeSolver - layout size distribution solver
+
+XLayoutSizeSolver::XLayoutSizeSolver()
+{
+}
+
+XLayoutSizeSolver::~XLayoutSizeSolver()
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// items
+/////////////////////////////////////////////////////////////////////
+void XLayoutSizeSolver::clear()
+{
+    // NOTE: memory is kept for next layout update
+    m_items.clear();
+}
+
+void XLayoutSizeSolver::addItem(IXLayoutItem::TResizePolicy policy, int minSize, int maxSize, int stretch)
+{
+    XWASSERT1(minSize >= 0 && maxSize >= 0, "XLayoutSizeSolver: size must not be negative");
+    XWASSERT1(stretch >= 0, "XLayoutSizeSolver: stretch factor must not be negative");
+
+    _Item item;
+
+    // fill item
+    item.policy = policy;
+    item.minSize = minSize;
+    item.maxSize = maxSize;
+    item.stretch = (stretch > 0) ? stretch : 0;
+    item.size = 0;
+    item.ready = false;
+
+    // add to list
+    m_items.push_back(item);
+}
+
+/////////////////////////////////////////////////////////////////////
+// distribute size between items
+/////////////////////////////////////////////////////////////////////
+void XLayoutSizeSolver::solve(int size)
+{
+    // init counters
+    int sizeLeft = size;
+    int itemsLeft = (int)m_items.size();
+    int stretchLeft = 0;
+
+    for(size_t idx = 0; idx < m_items.size(); ++idx)
+    {
+        _Item& item = m_items[idx];
+
+        // all items start from minimum size
+        item.size = item.minSize;
+
+        // check if item has fixed size
+        if(item.policy != IXLayoutItem::eResizeAny && item.minSize == item.maxSize)
+        {
+            // item is ready (can't resize)
+            item.ready = true;
+
+            // decrease counter
+            --itemsLeft;
+
+            // update size left
+            sizeLeft -= item.size;
+
+        } else
+        {
+            // reset flag
+            item.ready = false;
+
+            // update stretch factor if any
+            stretchLeft += item.stretch;
+        }
+    }
+
+    // check if there is any size left to position items
+    if(sizeLeft <= 0 || itemsLeft <= 0)
+    {
+        // NOTE: fixed items and items with minimum size are set above, others will have zero size
+        return;
+    }
+
+    // make sure minimum size is preserved
+    _clampItems(sizeLeft, itemsLeft, stretchLeft, true);
+
+    // make sure maximum size is preserved
+    _clampItems(sizeLeft, itemsLeft, stretchLeft, false);
+
+    // check if there is any size left to position items
+    if(sizeLeft <= 0) return;
+
+    // init counters
+    int proposedSize = 0;
+    float stretchFactor = 0;
+
+    // check if there are stretch items
+    if(stretchLeft)
+    {
+        // only stretchable items can grow -> compute stretching multiplier
+        stretchFactor = (float)sizeLeft / (float)stretchLeft;
+
+    } else
+    {
+        // no stretching rules set-> all items can get same size
+        proposedSize = sizeLeft / itemsLeft;
+    }
+
+    // set size of items left
+    for(size_t idx = 0; idx < m_items.size(); ++idx)
+    {
+        _Item& item = m_items[idx];
+
+        // ignore if ready
+        if(item.ready) continue;
+
+        // set item size
+        if(stretchLeft)
+            item.size = (int) (item.stretch * stretchFactor);
+        else
+            item.size = proposedSize;
+
+        // update size
+        sizeLeft -= item.size;
+    }
+
+    // distribute rounding errors if any
+    for(size_t idx = 0; idx < m_items.size() && sizeLeft > 0; ++idx)
+    {
+        // add one pixel to each item
+        if(!m_items[idx].ready) m_items[idx].size++;
+
+        // NOTE: size is reduced for ready items too (same as before)
+        --sizeLeft;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XLayoutSizeSolver::_clampItems(int& sizeLeft, int itemsLeft, int& stretchLeft, bool preserveMinSize)
+{
+    // check if there is any size to distribute
+    if(sizeLeft <= 0 || itemsLeft <= 0) return;
+
+    // check if there are stretch items
+    if(stretchLeft)
+    {
+        // items sorted by stretch factor at which they stop to fit
+        _initStretchCandidates(sizeLeft, preserveMinSize);
+
+        size_t nextCandidate = 0;
+        while(sizeLeft > 0 && stretchLeft)
+        {
+            // stretching multiplier for size left
+            float stretchFactor = (float)sizeLeft / (float)stretchLeft;
+
+            // add items which don't fit anymore
+            while(nextCandidate < m_candidates.size() &&
+                  _violatesStretch(m_items[m_candidates[nextCandidate].idx], stretchFactor, preserveMinSize))
+            {
+                _pushViolator(m_candidates[nextCandidate].idx);
+                ++nextCandidate;
+            }
+
+            // find first item which doesn't fit
+            int itemIdx = -1;
+            while(!m_violators.empty())
+            {
+                int violatorIdx = _popViolator();
+
+                if(_violatesStretch(m_items[violatorIdx], stretchFactor, preserveMinSize))
+                {
+                    itemIdx = violatorIdx;
+                    break;
+                }
+
+                // NOTE: may happen due to float rounding only, item is checked again later
+                m_skipped.push_back(violatorIdx);
+            }
+
+            // return skipped items
+            for(size_t idx = 0; idx < m_skipped.size(); ++idx)
+            {
+                _pushViolator(m_skipped[idx]);
+            }
+
+            m_skipped.clear();
+
+            // size is found if all items fit
+            if(itemIdx < 0) return;
+
+            // fix size of first item
+            _clampItem(itemIdx, preserveMinSize, sizeLeft, stretchLeft);
+        }
+
+        // check if there is size left
+        if(sizeLeft <= 0) return;
+    }
+
+    // NOTE: if all stretch items have been clamped, items left get the same size. Items
+    //       counter is not decreased (same as before), so proposed size only decreases.
+
+    // items sorted by size constraint
+    _initEqualCandidates(preserveMinSize);
+
+    size_t nextCandidate = 0;
+    while(sizeLeft > 0)
+    {
+        // all items get same size
+        int proposedSize = sizeLeft / itemsLeft;
+
+        // add items which don't fit anymore
+        while(nextCandidate < m_candidates.size())
+        {
+            const _Item& item = m_items[m_candidates[nextCandidate].idx];
+            if(preserveMinSize ? (proposedSize >= item.minSize) : (proposedSize <= item.maxSize)) break;
+
+            _pushViolator(m_candidates[nextCandidate].idx);
+            ++nextCandidate;
+        }
+
+        // find first item which doesn't fit
+        int itemIdx = -1;
+        while(!m_violators.empty())
+        {
+            int violatorIdx = _popViolator();
+            const _Item& item = m_items[violatorIdx];
+
+            // NOTE: items which fit below maximum size will fit from now on
+            if(preserveMinSize ? (proposedSize < item.minSize) : (proposedSize > item.maxSize))
+            {
+                itemIdx = violatorIdx;
+                break;
+            }
+        }
+
+        // size is found if all items fit
+        if(itemIdx < 0) return;
+
+        // fix size of first item
+        _clampItem(itemIdx, preserveMinSize, sizeLeft, stretchLeft);
+    }
+}
+
+void XLayoutSizeSolver::_clampItem(int idx, bool preserveMinSize, int& sizeLeft, int& stretchLeft)
+{
+    _Item& item = m_items[idx];
+
+    // set item size
+    item.size = preserveMinSize ? item.minSize : item.maxSize;
+
+    // fix item size
+    item.ready = true;
+
+    // reduce size
+    sizeLeft -= item.size;
+
+    // decrease total stretch factor if any
+    stretchLeft -= item.stretch;
+}
+
+void XLayoutSizeSolver::_initStretchCandidates(int sizeLeft, bool preserveMinSize)
+{
+    // reset lists
+    m_candidates.clear();
+    m_violators.clear();
+
+    for(size_t idx = 0; idx < m_items.size(); ++idx)
+    {
+        const _Item& item = m_items[idx];
+
+        // ignore items without constraint
+        if(!_isCandidate(item, preserveMinSize)) continue;
+
+        // NOTE: items without stretch get zero size, check them once
+        if(item.stretch == 0)
+        {
+            if(_violatesStretch(item, 0, preserveMinSize)) _pushViolator((int)idx);
+            continue;
+        }
+
+        // NOTE: stretched size is not negative and doesn't exceed size left
+        if(preserveMinSize && item.minSize <= 0) continue;
+        if(!preserveMinSize && (item.maxSize < 0 || item.maxSize >= sizeLeft)) 
+        {
+            if(item.maxSize < 0) _pushViolator((int)idx);
+            continue;
+        }
+
+        _Candidate candidate;
+        candidate.idx = (int)idx;
+
+        // NOTE: stretch factor decreases while items are clamped to minimum size,
+        //       items with higher threshold stop to fit first
+        float threshold = _stretchThreshold(item, preserveMinSize);
+        candidate.threshold = preserveMinSize ? -threshold : threshold;
+
+        m_candidates.push_back(candidate);
+    }
+
+    // sort by threshold
+    std::sort(m_candidates.begin(), m_candidates.end());
+}
+
+void XLayoutSizeSolver::_initEqualCandidates(bool preserveMinSize)
+{
+    // reset lists
+    m_candidates.clear();
+    m_violators.clear();
+
+    for(size_t idx = 0; idx < m_items.size(); ++idx)
+    {
+        const _Item& item = m_items[idx];
+
+        // ignore items without constraint
+        if(!_isCandidate(item, preserveMinSize)) continue;
+
+        _Candidate candidate;
+        candidate.idx = (int)idx;
+
+        // NOTE: largest minimum sizes stop to fit first, smallest maximum sizes respectively
+        candidate.threshold = preserveMinSize ? -(double)item.minSize : (double)item.maxSize;
+
+        m_candidates.push_back(candidate);
+    }
+
+    // sort by threshold
+    std::sort(m_candidates.begin(), m_candidates.end());
+}
+
+bool XLayoutSizeSolver::_isCandidate(const _Item& item, bool preserveMinSize) const
+{
+    // ignore if ready
+    if(item.ready) return false;
+
+    // check if item has constraint
+    if(preserveMinSize)
+        return (item.policy == IXLayoutItem::eResizeMin || item.policy == IXLayoutItem::eResizeMinMax);
+    else
+        return (item.policy == IXLayoutItem::eResizeMax || item.policy == IXLayoutItem::eResizeMinMax);
+}
+
+float XLayoutSizeSolver::_stretchThreshold(const _Item& item, bool preserveMinSize) const
+{
+    // NOTE: threshold is estimated first and then moved by float steps to exact value,
+    //       so that it matches size computed from stretch factor exactly
+
+    if(preserveMinSize)
+    {
+        // item violates minimum size below threshold
+        float threshold = (float)item.minSize / (float)item.stretch;
+
+        while(_violatesStretch(item, threshold, true))
+            threshold = nextafterf(threshold, XLAYOUT_SOLVER_THRESHOLD_UP);
+
+        while(threshold > 0 && !_violatesStretch(item, nextafterf(threshold, 0), true))
+            threshold = nextafterf(threshold, 0);
+
+        return threshold;
+    }
+
+    // item violates maximum size starting from threshold
+    float threshold = ((float)item.maxSize + 1.0f) / (float)item.stretch;
+
+    while(!_violatesStretch(item, threshold, false))
+        threshold = nextafterf(threshold, XLAYOUT_SOLVER_THRESHOLD_UP);
+
+    while(threshold > 0 && _violatesStretch(item, nextafterf(threshold, 0), false))
+        threshold = nextafterf(threshold, 0);
+
+    return threshold;
+}
+
+bool XLayoutSizeSolver::_violatesStretch(const _Item& item, float stretchFactor, bool preserveMinSize) const
+{
+    // proposed size for item (NOTE: must be computed the same way as final size)
+    int proposedSize = (int)(item.stretch * stretchFactor);
+
+    // check constraint
+    return preserveMinSize ? (proposedSize < item.minSize) : (proposedSize > item.maxSize);
+}
+
+/////////////////////////////////////////////////////////////////////
+// violating items (lowest index first)
+/////////////////////////////////////////////////////////////////////
+void XLayoutSizeSolver::_pushViolator(int idx)
+{
+    m_violators.push_back(idx);
+    std::push_heap(m_violators.begin(), m_violators.end(), std::greater<int>());
+}
+
+int XLayoutSizeSolver::_popViolator()
+{
+    std::pop_heap(m_violators.begin(), m_violators.end(), std::greater<int>());
+
+    int idx = m_violators.back();
+    m_violators.pop_back();
+
+    return idx;
+}
+
+// XLayoutSizeSolver
+/////////////////////////////////////////////////////////////////////
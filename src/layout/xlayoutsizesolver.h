@@ -0,0 +1,84 @@
+// Layout size distribution solver
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XLAYOUTSIZESOLVER_H_
+#define _XLAYOUTSIZESOLVER_H_
+
+// NOTE: solver distributes size along one layout direction. Item constraints are
+//       copied to flat array once per layout update, items which don't fit proposed
+//       size are clamped to their minimum (then maximum) size and the rest of size
+//       is shared between other items by stretch factors (or equally).
+
+// NOTE: while items are clamped proposed size changes in one direction only, so items
+//       are sorted once by size (or stretch factor) at which they stop to fit and clamped
+//       in the same order as by iterative search (lowest index among items which don't
+//       fit first). This keeps results pixel exact and takes O(n log n).
+
+// NOTE: sizes and stretch factors are expected to be non-negative
+
+/////////////////////////////////////////////////////////////////////
+// XLayoutSizeSolver - layout size distribution solver
+
+class XLayoutSizeSolver
+{
+public: // construction/destruction
+    XLayoutSizeSolver();
+    ~XLayoutSizeSolver();
+
+public: // items
+    void    clear();
+    void    addItem(IXLayoutItem::TResizePolicy policy, int minSize, int maxSize, int stretch);
+    int     itemCount() const       { return (int)m_items.size(); }
+    int     itemSize(int idx) const { return m_items[idx].size; }
+
+public: // distribute size between items
+    void    solve(int size);
+
+private: // types
+    struct _Item
+    {
+        // constraints
+        IXLayoutItem::TResizePolicy policy;
+        int     minSize;
+        int     maxSize;
+        int     stretch;
+
+        // result
+        int     size;
+        bool    ready;
+    };
+
+    struct _Candidate
+    {
+        double  threshold;
+        int     idx;
+
+        // sort by threshold
+        bool operator<(const _Candidate& other) const { return threshold < other.threshold; }
+    };
+
+private: // worker methods
+    void    _clampItems(int& sizeLeft, int itemsLeft, int& stretchLeft, bool preserveMinSize);
+    void    _clampItem(int idx, bool preserveMinSize, int& sizeLeft, int& stretchLeft);
+    void    _initStretchCandidates(int sizeLeft, bool preserveMinSize);
+    void    _initEqualCandidates(bool preserveMinSize);
+    bool    _isCandidate(const _Item& item, bool preserveMinSize) const;
+    float   _stretchThreshold(const _Item& item, bool preserveMinSize) const;
+    bool    _violatesStretch(const _Item& item, float stretchFactor, bool preserveMinSize) const;
+
+private: // violating items (lowest index first)
+    void    _pushViolator(int idx);
+    int     _popViolator();
+
+private: // data
+    std::vector<_Item>          m_items;
+    std::vector<_Candidate>     m_candidates;
+    std::vector<int>            m_violators;
+    std::vector<int>            m_skipped;
+};
+
+// XLayoutSizeSolver
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XLAYOUTSIZESOLVER_H_
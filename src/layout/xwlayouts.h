@@ -9,6 +9,7 @@
 // layouts 
 #include "xlayoutitem.h"
 #include "xlayout.h"
+#include "xlayoutsizesolver.h"
 #include "xvboxlayout.h"
 #include "xhboxlayout.h"
 #include "xgridlayout.h"
@@ -117,8 +117,8 @@ void XWIECtrl::setAllowedKeys(unsigned short keys)
 
     if(m_allowedKeys != eAllowedKeyNone)
     {
-        // add itself as message hook
-        sXWUIAddMessageHook(this);
+        // add itself as message hook (only keyboard messages are translated)
+        sXWUIAddMessageHook(this, XWMessageHookFilter(WM_KEYFIRST, WM_KEYLAST));
 
     } else
     {
@@ -11,6 +11,7 @@
 #include "xwscrollviewwindow.h"
 #include "xwcustomwindow.h"
 #include "xwsplitterwindow.h"
+#include "xwgridcolumnstore.h"
 #include "xwgridwindow.h"
 
 /////////////////////////////////////////////////////////////////////
@@ -0,0 +1,294 @@
+// Grid column cell storage
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "../xwui_config.h"
+
+#include "xwgridcolumnstore.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// unused arena size which is always kept (arena is not compacted below it)
+#define XWGRID_TEXT_ARENA_MIN_UNUSED        4096
+
+// maximum measured size kept in cell
+#define XWGRID_EXTENT_MAX                   0xFFFF
+
+/////////////////////////////////////////////////////////////////////
+// XWGridColumnStore - grid column cell storage
+
+XWGridColumnStore::XWGridColumnStore() :
+    m_textUnused(0)
+{
+    // NOTE: first arena element is empty string shared by all empty cells
+    m_textArena.push_back(0);
+}
+
+XWGridColumnStore::~XWGridColumnStore()
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// cells
+/////////////////////////////////////////////////////////////////////
+void XWGridColumnStore::appendCell()
+{
+    // add empty cell
+    m_textOffsets.push_back(0);
+    m_textLengths.push_back(0);
+    m_flags.push_back(0);
+    m_types.push_back(0);
+    m_extentWidths.push_back(0);
+    m_extentHeights.push_back(0);
+}
+
+void XWGridColumnStore::insertCell(int idx)
+{
+    // check input
+    XWASSERT(idx >= 0 && idx <= count());
+    if(idx < 0 || idx > count()) return;
+
+    // move attributes of cells below
+    _shiftAttributes(idx, 1);
+
+    // insert empty cell
+    m_textOffsets.insert(m_textOffsets.begin() + idx, 0);
+    m_textLengths.insert(m_textLengths.begin() + idx, 0);
+    m_flags.insert(m_flags.begin() + idx, 0);
+    m_types.insert(m_types.begin() + idx, 0);
+    m_extentWidths.insert(m_extentWidths.begin() + idx, 0);
+    m_extentHeights.insert(m_extentHeights.begin() + idx, 0);
+}
+
+void XWGridColumnStore::removeCell(int idx)
+{
+    // check input
+    XWASSERT(idx >= 0 && idx < count());
+    if(idx < 0 || idx >= count()) return;
+
+    // release cell data
+    _releaseText(idx);
+    m_attributes.erase(idx);
+
+    // remove cell
+    m_textOffsets.erase(m_textOffsets.begin() + idx);
+    m_textLengths.erase(m_textLengths.begin() + idx);
+    m_flags.erase(m_flags.begin() + idx);
+    m_types.erase(m_types.begin() + idx);
+    m_extentWidths.erase(m_extentWidths.begin() + idx);
+    m_extentHeights.erase(m_extentHeights.begin() + idx);
+
+    // move attributes of cells below
+    _shiftAttributes(idx + 1, -1);
+}
+
+void XWGridColumnStore::resetCell(int idx)
+{
+    // check input
+    XWASSERT(idx >= 0 && idx < count());
+    if(idx < 0 || idx >= count()) return;
+
+    // release cell data
+    _releaseText(idx);
+    m_attributes.erase(idx);
+
+    // set default values
+    m_flags[idx] = 0;
+    m_types[idx] = 0;
+    m_extentWidths[idx] = 0;
+    m_extentHeights[idx] = 0;
+}
+
+void XWGridColumnStore::clear()
+{
+    // remove cells
+    m_textOffsets.clear();
+    m_textLengths.clear();
+    m_flags.clear();
+    m_types.clear();
+    m_extentWidths.clear();
+    m_extentHeights.clear();
+    m_attributes.clear();
+
+    // keep only empty string
+    m_textArena.assign(1, 0);
+    m_textUnused = 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// text
+/////////////////////////////////////////////////////////////////////
+void XWGridColumnStore::setText(int idx, const wchar_t* text)
+{
+    // check input
+    XWASSERT(idx >= 0 && idx < count());
+    if(idx < 0 || idx >= count()) return;
+
+    // NOTE: text may point to arena itself which may be moved below
+    if(text && text >= &m_textArena.front() && text <= &m_textArena.back())
+    {
+        std::wstring textCopy = text;
+        setText(idx, textCopy.c_str());
+        return;
+    }
+
+    unsigned int length = text ? (unsigned int)wcslen(text) : 0;
+
+    // write text in place if it fits
+    if(length > 0 && length <= m_textLengths[idx])
+    {
+        wchar_t* textPtr = &m_textArena[m_textOffsets[idx]];
+
+        // copy text with terminator
+        memcpy(textPtr, text, length * sizeof(wchar_t));
+        textPtr[length] = 0;
+
+        // rest of old text is not used anymore
+        m_textUnused += m_textLengths[idx] - length;
+        m_textLengths[idx] = length;
+
+        return;
+    }
+
+    // release old text
+    _releaseText(idx);
+
+    // empty cells use shared empty string
+    if(length == 0) return;
+
+    // append text with terminator to arena
+    m_textOffsets[idx] = (unsigned int)m_textArena.size();
+    m_textLengths[idx] = length;
+    m_textArena.insert(m_textArena.end(), text, text + length + 1);
+
+    // compact arena if most of it is not used
+    if(m_textUnused > XWGRID_TEXT_ARENA_MIN_UNUSED && m_textUnused * 2 > m_textArena.size())
+        _compactText();
+}
+
+/////////////////////////////////////////////////////////////////////
+// type and flags
+/////////////////////////////////////////////////////////////////////
+void XWGridColumnStore::setFlag(int idx, unsigned short flag, bool value)
+{
+    if(value)
+        m_flags[idx] |= flag;
+    else
+        m_flags[idx] &= ~flag;
+}
+
+/////////////////////////////////////////////////////////////////////
+// column-wide flags
+/////////////////////////////////////////////////////////////////////
+int XWGridColumnStore::findFlag(unsigned short flag, int fromIdx) const
+{
+    // scan packed flags
+    for(int idx = (fromIdx > 0) ? fromIdx : 0; idx < count(); ++idx)
+    {
+        if(m_flags[idx] & flag) return idx;
+    }
+
+    // not found
+    return -1;
+}
+
+void XWGridColumnStore::clearFlag(unsigned short flag)
+{
+    // reset flag in all cells
+    for(size_t idx = 0; idx < m_flags.size(); ++idx)
+    {
+        m_flags[idx] &= ~flag;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// measured size
+/////////////////////////////////////////////////////////////////////
+void XWGridColumnStore::setExtent(int idx, int width, int height)
+{
+    // NOTE: cell size is limited by storage type
+    m_extentWidths[idx] = (unsigned short)((width < 0) ? 0 : (width > XWGRID_EXTENT_MAX) ? XWGRID_EXTENT_MAX : width);
+    m_extentHeights[idx] = (unsigned short)((height < 0) ? 0 : (height > XWGRID_EXTENT_MAX) ? XWGRID_EXTENT_MAX : height);
+}
+
+/////////////////////////////////////////////////////////////////////
+// attributes
+/////////////////////////////////////////////////////////////////////
+const XWGridColumnStore::CellAttributes* XWGridColumnStore::attributes(int idx) const
+{
+    // most cells don't have attributes
+    if((m_flags[idx] & XWGRID_CELL_ATTRIBUTES) == 0) return 0;
+
+    _attributesT::const_iterator it = m_attributes.find(idx);
+    XWASSERT(it != m_attributes.end());
+
+    return (it != m_attributes.end()) ? &(it->second) : 0;
+}
+
+XWGridColumnStore::CellAttributes& XWGridColumnStore::editAttributes(int idx)
+{
+    // mark cell
+    m_flags[idx] |= XWGRID_CELL_ATTRIBUTES;
+
+    // create attributes if needed
+    return m_attributes[idx];
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XWGridColumnStore::_releaseText(int idx)
+{
+    // NOTE: text with terminator is not used anymore
+    if(m_textLengths[idx] > 0)
+        m_textUnused += m_textLengths[idx] + 1;
+
+    // use shared empty string
+    m_textOffsets[idx] = 0;
+    m_textLengths[idx] = 0;
+}
+
+void XWGridColumnStore::_compactText()
+{
+    std::vector<wchar_t> textArena;
+    textArena.reserve(m_textArena.size() - m_textUnused);
+
+    // shared empty string
+    textArena.push_back(0);
+
+    // copy used text in cell order
+    for(size_t idx = 0; idx < m_textOffsets.size(); ++idx)
+    {
+        if(m_textLengths[idx] == 0) continue;
+
+        const wchar_t* text = &m_textArena[m_textOffsets[idx]];
+
+        m_textOffsets[idx] = (unsigned int)textArena.size();
+        textArena.insert(textArena.end(), text, text + m_textLengths[idx] + 1);
+    }
+
+    // replace arena
+    m_textArena.swap(textArena);
+    m_textUnused = 0;
+}
+
+void XWGridColumnStore::_shiftAttributes(int fromIdx, int shift)
+{
+    // ignore if there is nothing to move
+    _attributesT::iterator it = m_attributes.lower_bound(fromIdx);
+    if(it == m_attributes.end()) return;
+
+    // NOTE: only cells which have attributes are moved
+    _attributesT movedAttributes;
+    for(_attributesT::iterator mit = it; mit != m_attributes.end(); ++mit)
+    {
+        movedAttributes.insert(movedAttributes.end(), std::make_pair(mit->first + shift, mit->second));
+    }
+
+    m_attributes.erase(it, m_attributes.end());
+    m_attributes.insert(movedAttributes.begin(), movedAttributes.end());
+}
+
+// XWGridColumnStore
+/////////////////////////////////////////////////////////////////////
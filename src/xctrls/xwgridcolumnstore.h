@@ -0,0 +1,113 @@
+// Grid column cell storage
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWGRIDCOLUMNSTORE_H_
+#define _XWGRIDCOLUMNSTORE_H_
+
+// NOTE: cells of one grid column are kept in parallel arrays. Text of all cells is
+//       kept in one arena, cell keeps only offset and length of its text. Changed
+//       text is written in place if it fits or appended to arena, unused space is
+//       reclaimed once it takes more than half of arena. Cell flags and type are
+//       packed in one word per cell. Rarely used attributes (hint, bitmaps, list,
+//       user data) are kept in side map only for cells that have them.
+
+// NOTE: text pointer is valid until text of any cell in the same column is changed
+
+/////////////////////////////////////////////////////////////////////
+// cell flags
+#define XWGRID_CELL_EDITABLE                    0x0001
+#define XWGRID_CELL_MODIFIED                    0x0002
+#define XWGRID_CELL_CLICKABLE                   0x0004
+#define XWGRID_CELL_SELECTABLE                  0x0008
+#define XWGRID_CELL_SELECTED                    0x0010
+#define XWGRID_CELL_MEASURED                    0x0020      // cell size is measured
+#define XWGRID_CELL_COUNTED                     0x0040      // cell width is counted in column
+#define XWGRID_CELL_ATTRIBUTES                  0x0080      // cell has attributes (set by store)
+
+/////////////////////////////////////////////////////////////////////
+// XWGridColumnStore - grid column cell storage
+
+class XWGridColumnStore
+{
+public: // construction/destruction
+    XWGridColumnStore();
+    ~XWGridColumnStore();
+
+public: // types
+    struct CellAttributes
+    {
+        std::wstring    hint;
+        HBITMAP         bitmap;
+        HBITMAP         bitmapHovered;
+        HBITMAP         bitmapClicked;
+        int             listIndex;
+        const wchar_t** listItems;
+        int             listItemCount;
+        LRESULT         userData;
+
+        // default values
+        CellAttributes() : bitmap(0), bitmapHovered(0), bitmapClicked(0), listIndex(-1),
+                           listItems(0), listItemCount(0), userData(0) {}
+    };
+
+public: // cells
+    int     count() const   { return (int)m_flags.size(); }
+    void    appendCell();
+    void    insertCell(int idx);
+    void    removeCell(int idx);
+    void    resetCell(int idx);
+    void    clear();
+
+public: // text
+    void            setText(int idx, const wchar_t* text);
+    const wchar_t*  text(int idx) const         { return &m_textArena[m_textOffsets[idx]]; }
+    int             textLength(int idx) const   { return (int)m_textLengths[idx]; }
+
+public: // type and flags
+    int     type(int idx) const                 { return m_types[idx]; }
+    void    setType(int idx, int type)          { m_types[idx] = (unsigned char)type; }
+    bool    flag(int idx, unsigned short flag) const { return (m_flags[idx] & flag) != 0; }
+    void    setFlag(int idx, unsigned short flag, bool value);
+
+public: // column-wide flags
+    int     findFlag(unsigned short flag, int fromIdx) const;
+    void    clearFlag(unsigned short flag);
+
+public: // measured size
+    int     extentWidth(int idx) const          { return m_extentWidths[idx]; }
+    int     extentHeight(int idx) const         { return m_extentHeights[idx]; }
+    void    setExtent(int idx, int width, int height);
+
+public: // attributes (0 if cell doesn't have them)
+    const CellAttributes*   attributes(int idx) const;
+    CellAttributes&         editAttributes(int idx);
+
+private: // types
+    typedef std::map<int, CellAttributes>   _attributesT;
+
+private: // worker methods
+    void    _releaseText(int idx);
+    void    _compactText();
+    void    _shiftAttributes(int fromIdx, int shift);
+
+private: // cell data
+    std::vector<unsigned int>       m_textOffsets;
+    std::vector<unsigned int>       m_textLengths;
+    std::vector<unsigned short>     m_flags;
+    std::vector<unsigned char>      m_types;
+    std::vector<unsigned short>     m_extentWidths;
+    std::vector<unsigned short>     m_extentHeights;
+
+private: // text arena
+    std::vector<wchar_t>            m_textArena;
+    size_t                          m_textUnused;
+
+private: // attributes
+    _attributesT                    m_attributes;
+};
+
+// XWGridColumnStore
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWGRIDCOLUMNSTORE_H_
@@ -10,6 +10,7 @@
 #include "../ctrls/xwcontrols.h"
 #include "../graphics/xwgraphics.h"
 
+#include "xwgridcolumnstore.h"
 #include "xwgridwindow.h"
 
 /////////////////////////////////////////////////////////////////////
@@ -18,6 +19,19 @@
 #define XWGRID_SUBCLASS_ID_COMBOBOX                 2
 #define XWGRID_SUBCLASS_ID_COMBOBOX_PARENT          3
 
+// maximum number of cached rows in virtual mode (if rows are read outside of visible area),
+// rows with text returned by cellText are kept until next paint
+#define XWGRID_VIRTUAL_CACHE_LIMIT                  1024
+
+// maximum number of changed rows moved in view (view is built again if more rows are changed)
+#define XWGRID_VIEW_INCREMENTAL_LIMIT               64
+
+// minimum number of rows sorted by several threads
+#define XWGRID_PARALLEL_SORT_MIN_ROWS               16384
+
+// maximum number of threads used for sorting
+#define XWGRID_PARALLEL_SORT_MAX_THREADS            8
+
 /////////////////////////////////////////////////////////////////////
 // XWGridWindow - grid window
 
@@ -26,6 +40,25 @@
 /////////////////////////////////////////////////////////////////////
 XWGridWindow::XWGridWindow(DWORD dwStyle, XWObject* parent, HWND hWndParent, DWORD dwExStyle) :
     XWindow(dwStyle, parent, hWndParent, dwExStyle),
+    m_rowOffsetsRebuildNeeded(false),
+    m_pDataSource(0),
+    m_virtualRowCount(0),
+    m_virtualRowHeight(0),
+    m_virtualFirstRow(0),
+    m_virtualLastRow(XWGRID_VALUE_NOT_SET),
+    m_sortColumn(XWGRID_VALUE_NOT_SET),
+    m_sortAscending(true),
+    m_pSortComparator(0),
+    m_pRowFilter(0),
+    m_viewUpdateNeeded(false),
+    m_viewRebuildNeeded(false),
+    m_viewNarrowNeeded(false),
+    m_updateLevel(0),
+    m_contentChangedNeeded(false),
+    m_pGDIResourcesCache(0),
+    m_paintFont(0),
+    m_paintBkColor(0),
+    m_repaintAllNeeded(false),
     m_textFont(0),
     m_modifiedFont(0),
     m_fontHeight(0),
@@ -65,6 +98,9 @@ XWGridWindow::~XWGridWindow()
 {
     // release content
     reset();
+
+    // release GDI resources
+    if(m_pGDIResourcesCache) m_pGDIResourcesCache->Release();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -92,14 +128,123 @@ void XWGridWindow::reset()
     _cancelEditing();
 
     // reset data
-    m_gridData.clear();
+    m_gridRows.clear();
     m_gridColumns.clear();
+    m_dirtyRows.clear();
+    m_rowOffsets.clear();
+    m_columnOffsets.clear();
+    m_rowOffsetsRebuildNeeded = false;
     m_columnCount = 0;
     m_contextRow = XWGRID_VALUE_NOT_SET;
     m_contextColumn = XWGRID_VALUE_NOT_SET;
 
+    // reset virtual mode
+    m_pDataSource = 0;
+    m_virtualRowCount = 0;
+    m_virtualRows.clear();
+    m_virtualFreeSlots.clear();
+    m_virtualTextRows.clear();
+    m_virtualSelection.clear();
+
+    // reset view
+    m_viewRows.clear();
+    m_dataViewRows.clear();
+    m_viewChangedRows.clear();
+    m_sortColumn = XWGRID_VALUE_NOT_SET;
+    m_sortAscending = true;
+    m_pSortComparator = 0;
+    m_pRowFilter = 0;
+    m_viewUpdateNeeded = false;
+    m_viewRebuildNeeded = false;
+    m_viewNarrowNeeded = false;
+
+    // request layout update
+    m_layoutUpdateNeeded = true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// virtual mode
+/////////////////////////////////////////////////////////////////////
+void XWGridWindow::setDataSource(IXWGridDataSource* pDataSource)
+{
+    // cancel editing if any
+    _cancelEditing();
+
+    // NOTE: columns are kept, cell data is removed as it is read from data source
+    m_gridRows.clear();
+    m_dirtyRows.clear();
+    m_rowOffsets.clear();
+    m_rowOffsetsRebuildNeeded = false;
+    _resetContentWidths();
+    _clearCells();
+    m_virtualSelection.clear();
+    m_contextRow = XWGRID_VALUE_NOT_SET;
+    m_contextColumn = XWGRID_VALUE_NOT_SET;
+
+    // view is built again (it is not used in virtual mode)
+    _invalidateView(true);
+
+    // set data source
+    m_pDataSource = pDataSource;
+
+    // read row count
+    m_virtualRowCount = m_pDataSource ? m_pDataSource->gridRowCount(this) : 0;
+    if(m_virtualRowCount < 0) m_virtualRowCount = 0;
+
+    // request layout update
+    m_layoutUpdateNeeded = true;
+
+    // repaint
+    _requestRepaint();
+}
+
+void XWGridWindow::reloadData()
+{
+    // ignore if not in virtual mode
+    if(!isVirtual()) return;
+
+    // cancel editing if any
+    _cancelEditing();
+
+    // read row count
+    m_virtualRowCount = m_pDataSource->gridRowCount(this);
+    if(m_virtualRowCount < 0) m_virtualRowCount = 0;
+
+    // remove cached rows
+    _clearCells();
+    _resetContentWidths();
+
+    // remove selection of rows that don't exist anymore
+    m_virtualSelection.erase(m_virtualSelection.lower_bound(std::make_pair(m_virtualRowCount, 0)), m_virtualSelection.end());
+
+    // request layout update
+    m_layoutUpdateNeeded = true;
+
+    // repaint
+    _requestRepaint();
+}
+
+void XWGridWindow::reloadRow(int row)
+{
+    // ignore if not in virtual mode
+    if(!isVirtual()) return;
+
+    // NOTE: edited row is kept until editing is done
+    if(m_gridEditor.editing && m_gridEditor.row == row) return;
+
+    // remove row from cache, it will be read again when painted
+    _gridRowCacheT::iterator it = m_virtualRows.find(row);
+    if(it != m_virtualRows.end())
+    {
+        _releaseVirtualSlot(it->second);
+        m_virtualRows.erase(it);
+    }
+
     // request layout update
     m_layoutUpdateNeeded = true;
+
+    // repaint
+    _requestRepaint();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -107,20 +252,67 @@ void XWGridWindow::reset()
 /////////////////////////////////////////////////////////////////////
 void XWGridWindow::appendRow()
 {
+    // only row count is kept in virtual mode
+    if(isVirtual())
+    {
+        m_virtualRowCount++;
+        m_layoutUpdateNeeded = true;
+
+        // NOTE: content height is changed, parent updates scroll range once bulk update is completed
+        if(m_updateLevel > 0)
+        {
+            m_contentChangedNeeded = true;
+            return;
+        }
+
+        handleContentChanged();
+
+        // paint new row if visible
+        _repaintRow(m_virtualRowCount - 1);
+        return;
+    }
+
     // append row with default values
-    m_gridData.push_back(GridRow(m_columnCount));
+    m_gridRows.push_back(GridRow());
 
-    // mark flag
-    m_layoutUpdateNeeded = true;
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
+    {
+        cit->cells.appendCell();
+    }
+
+    // measure row on next layout update
+    _invalidateRow((int)m_gridRows.size() - 1);
+
+    // NOTE: appended row doesn't move other rows, only its view position is needed
+    if(_isViewActive())
+        _invalidateViewRow((int)m_gridRows.size() - 1);
 }
 
 void XWGridWindow::insertRow(int rowAt)
 {
-    // check if row exists
-    if(rowAt >= 0 && rowAt < (int)m_gridData.size())
+    // only row count is kept in virtual mode
+    if(isVirtual() && rowAt >= 0 && rowAt < m_virtualRowCount)
+    {
+        // move rows
+        _shiftVirtualRows(rowAt, 1);
+        m_virtualRowCount++;
+
+    } else if(rowAt >= 0 && rowAt < (int)m_gridRows.size())
     {
         // insert
-        _gridRowsT::iterator it = m_gridData.insert(m_gridData.begin() + rowAt, GridRow(m_columnCount));
+        m_gridRows.insert(m_gridRows.begin() + rowAt, GridRow());
+
+        for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
+        {
+            cit->cells.insertCell(rowAt);
+        }
+
+        // update layout data
+        _insertRowLayout(rowAt);
+
+        // update view
+        if(_isViewActive())
+            _insertViewRow(rowAt);
 
     } else
     {
@@ -133,11 +325,29 @@ void XWGridWindow::insertRow(int rowAt)
 
 void XWGridWindow::removeRow(int rowAt)
 {
-    // check if row exists
-    if(rowAt >= 0 && rowAt < (int)m_gridData.size())
+    // only row count is kept in virtual mode
+    if(isVirtual() && rowAt >= 0 && rowAt < m_virtualRowCount)
     {
+        // move rows
+        _shiftVirtualRows(rowAt, -1);
+        m_virtualRowCount--;
+
+    } else if(rowAt >= 0 && rowAt < (int)m_gridRows.size())
+    {
+        // update layout data
+        _removeRowLayout(rowAt);
+
+        // update view
+        if(_isViewActive())
+            _removeViewRow(rowAt);
+
         // remove
-        m_gridData.erase(m_gridData.begin() + rowAt);
+        m_gridRows.erase(m_gridRows.begin() + rowAt);
+
+        for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
+        {
+            cit->cells.removeCell(rowAt);
+        }
 
     } else
     {
@@ -158,7 +368,152 @@ int XWGridWindow::columnCount()
 
 int XWGridWindow::rowCount()
 {
-    return (int)m_gridData.size();
+    // row count is kept separately in virtual mode
+    if(isVirtual()) return m_virtualRowCount;
+
+    return (int)m_gridRows.size();
+}
+
+/////////////////////////////////////////////////////////////////////
+// sorting and filtering
+/////////////////////////////////////////////////////////////////////
+void XWGridWindow::sortByColumn(int column, bool ascending, IXWGridSortComparator* pComparator)
+{
+    // validate column
+    if(!_validateColumn(column)) return;
+
+    // data source provides rows in order in virtual mode
+    XWASSERT1(!isVirtual(), "XWGridWindow: sorting is not supported in virtual mode");
+    if(isVirtual()) return;
+
+    // copy sort order
+    m_sortColumn = column;
+    m_sortAscending = ascending;
+    m_pSortComparator = pComparator;
+
+    // sort rows on next layout update
+    _invalidateView(true);
+
+    // repaint
+    _requestRepaint();
+}
+
+void XWGridWindow::resetSorting()
+{
+    // ignore if not sorted
+    if(m_sortColumn == XWGRID_VALUE_NOT_SET) return;
+
+    // reset sort order
+    m_sortColumn = XWGRID_VALUE_NOT_SET;
+    m_pSortComparator = 0;
+
+    // show rows in data order on next layout update
+    _invalidateView(true);
+
+    // repaint
+    _requestRepaint();
+}
+
+void XWGridWindow::setRowFilter(IXWGridRowFilter* pFilter)
+{
+    // data source provides only needed rows in virtual mode
+    XWASSERT1(!isVirtual() || pFilter == 0, "XWGridWindow: filtering is not supported in virtual mode");
+    if(isVirtual()) return;
+
+    // set filter
+    m_pRowFilter = pFilter;
+
+    // filter rows on next layout update
+    _invalidateView(true);
+
+    // repaint
+    _requestRepaint();
+}
+
+void XWGridWindow::updateRowFilter(bool narrowed)
+{
+    // ignore if filter is not set
+    if(m_pRowFilter == 0) return;
+
+    // NOTE: narrowed filter may only hide rows, so only shown rows are checked
+    if(narrowed)
+    {
+        m_viewNarrowNeeded = true;
+        _invalidateView(false);
+
+    } else
+    {
+        _invalidateView(true);
+    }
+
+    // repaint
+    _requestRepaint();
+}
+
+/////////////////////////////////////////////////////////////////////
+// view rows
+/////////////////////////////////////////////////////////////////////
+int XWGridWindow::viewRowCount()
+{
+    // update view if needed
+    if(m_viewUpdateNeeded) _updateView();
+
+    return _viewRowCount();
+}
+
+int XWGridWindow::viewRow(int row)
+{
+    // check input
+    if(row < 0 || row >= rowCount()) return XWGRID_VALUE_NOT_SET;
+
+    // update view if needed
+    if(m_viewUpdateNeeded) _updateView();
+
+    return _viewRow(row);
+}
+
+int XWGridWindow::viewDataRow(int viewRow)
+{
+    // update view if needed
+    if(m_viewUpdateNeeded) _updateView();
+
+    // check input
+    if(viewRow < 0 || viewRow >= _viewRowCount()) return XWGRID_VALUE_NOT_SET;
+
+    return _dataRow(viewRow);
+}
+
+/////////////////////////////////////////////////////////////////////
+// bulk update
+/////////////////////////////////////////////////////////////////////
+void XWGridWindow::beginUpdate()
+{
+    // NOTE: updates may be nested
+    m_updateLevel++;
+}
+
+void XWGridWindow::endUpdate()
+{
+    // check state
+    XWASSERT1(m_updateLevel > 0, "XWGridWindow: endUpdate called without beginUpdate");
+    if(m_updateLevel <= 0) return;
+
+    // wait for last update
+    if(--m_updateLevel > 0) return;
+
+    // update layout once for all changes
+    _updateLayoutIfNeeded();
+
+    // inform parent about changed content size
+    if(m_contentChangedNeeded)
+    {
+        m_contentChangedNeeded = false;
+        handleContentChanged();
+    }
+
+    // NOTE: repaint requested while updating or cells moved by layout update set the flag,
+    //       nothing is painted if grid has not been changed
+    if(m_repaintAllNeeded) repaint();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -180,31 +535,32 @@ void XWGridWindow::completeEditing()
 void XWGridWindow::setCellText(int row, int column, const wchar_t* text)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
+
+    XWGridColumnStore& cells = m_gridColumns.at(column).cells;
 
     // update cell type
-    m_gridData.at(row).cells.at(column).type = eCellTypeText;
+    cells.setType(row, eCellTypeText);
 
     // set text
-    if(text)
-        m_gridData.at(row).cells.at(column).text = text;
-    else
-        m_gridData.at(row).cells.at(column).text.clear();
+    cells.setText(row, text);
 
-    // mark flag
-    m_layoutUpdateNeeded = true;
+    // measure cell on next layout update
+    _invalidateCell(row, column, true);
 }
 
 void XWGridWindow::setCellTextHint(int row, int column, const wchar_t* hint)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
+
+    XWGridColumnStore& cells = m_gridColumns.at(column).cells;
 
     // set hint text
     if(hint)
-        m_gridData.at(row).cells.at(column).hint = hint;
-    else
-        m_gridData.at(row).cells.at(column).hint.clear();
+        cells.editAttributes(row).hint = hint;
+    else if(cells.attributes(row))
+        cells.editAttributes(row).hint.clear();
 }
 
 void XWGridWindow::setCellList(int row, int column, const wchar_t** listItems, int itemCount)
@@ -215,7 +571,7 @@ void XWGridWindow::setCellList(int row, int column, const wchar_t** listItems, i
     if(listItems == 0 || itemCount <= 0) return;
 
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
 
     // validate list items
     for(int idx = 0; idx < itemCount; ++idx)
@@ -224,19 +580,22 @@ void XWGridWindow::setCellList(int row, int column, const wchar_t** listItems, i
         if(listItems[idx] == 0) return;
     }
 
+    XWGridColumnStore& cells = m_gridColumns.at(column).cells;
+
     // update cell type
-    m_gridData.at(row).cells.at(column).type = eCellTypeList;
+    cells.setType(row, eCellTypeList);
 
     // set list data
-    m_gridData.at(row).cells.at(column).listIndex = XWGRID_VALUE_NOT_SET;
-    m_gridData.at(row).cells.at(column).listItems = listItems;
-    m_gridData.at(row).cells.at(column).listItemCount = itemCount;
+    XWGridColumnStore::CellAttributes& attributes = cells.editAttributes(row);
+    attributes.listIndex = XWGRID_VALUE_NOT_SET;
+    attributes.listItems = listItems;
+    attributes.listItemCount = itemCount;
 
     // list items are editable by default
-    m_gridData.at(row).cells.at(column).editable = true;
+    cells.setFlag(row, XWGRID_CELL_EDITABLE, true);
 
-    // mark flag
-    m_layoutUpdateNeeded = true;
+    // measure cell on next layout update
+    _invalidateCell(row, column, true);
 }
 
 void XWGridWindow::setCellListIndex(int row, int column, int index)
@@ -246,12 +605,15 @@ void XWGridWindow::setCellListIndex(int row, int column, int index)
     if(index < XWGRID_VALUE_NOT_SET) return;
 
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
+
+    XWGridColumnStore& cells = m_gridColumns.at(column).cells;
+    XWGridColumnStore::CellAttributes& attributes = cells.editAttributes(row);
 
     // validate list index
     if(index != XWGRID_VALUE_NOT_SET)
     {
-        if(index < 0 || index >= m_gridData.at(row).cells.at(column).listItemCount)
+        if(index < 0 || index >= attributes.listItemCount)
         {
             XWASSERT1(0, "XWGridWindow: list index is not valid");
             index = XWGRID_VALUE_NOT_SET;
@@ -259,94 +621,101 @@ void XWGridWindow::setCellListIndex(int row, int column, int index)
     }
 
     // set list index
-    m_gridData.at(row).cells.at(column).listIndex = index;
+    attributes.listIndex = index;
 
     // set text value from index
     if(index != XWGRID_VALUE_NOT_SET)
-    {
-        m_gridData.at(row).cells.at(column).text = 
-            m_gridData.at(row).cells.at(column).listItems[index];
-    } else
-    {
-        m_gridData.at(row).cells.at(column).text.clear();
-    }
+        cells.setText(row, attributes.listItems[index]);
+    else
+        cells.setText(row, 0);
 
-    // mark flag
-    m_layoutUpdateNeeded = true;
+    // measure cell on next layout update
+    _invalidateCell(row, column, true);
 }
 
 void XWGridWindow::setCellBitmap(int row, int column, HBITMAP bitmap)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
+
+    XWGridColumnStore& cells = m_gridColumns.at(column).cells;
 
     // NOTE: if bitmap is not set change cell type to text
 
     // update cell type
     if(bitmap)
-        m_gridData.at(row).cells.at(column).type = eCellTypeBitmap;
+        cells.setType(row, eCellTypeBitmap);
     else
-        m_gridData.at(row).cells.at(column).type = eCellTypeText; 
+        cells.setType(row, eCellTypeText); 
 
     // set bitmap
-    m_gridData.at(row).cells.at(column).bitmap = bitmap;
+    if(bitmap || cells.attributes(row))
+        cells.editAttributes(row).bitmap = bitmap;
 
-    // mark flag
-    m_layoutUpdateNeeded = true;
+    // measure cell on next layout update
+    _invalidateCell(row, column, true);
 }
 
 void XWGridWindow::setCellBitmapHovered(int row, int column, HBITMAP bitmap)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
 
     // set bitmap
-    m_gridData.at(row).cells.at(column).bitmapHovered = bitmap;
+    m_gridColumns.at(column).cells.editAttributes(row).bitmapHovered = bitmap;
 }
 
 void XWGridWindow::setCellBitmapClicked(int row, int column, HBITMAP bitmap)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
 
     // set bitmap
-    m_gridData.at(row).cells.at(column).bitmapCliked = bitmap;
+    m_gridColumns.at(column).cells.editAttributes(row).bitmapClicked = bitmap;
 }
 
 void XWGridWindow::setCellEditable(int row, int column, bool editable)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
 
     // set flag
-    m_gridData.at(row).cells.at(column).editable = editable;
+    m_gridColumns.at(column).cells.setFlag(row, XWGRID_CELL_EDITABLE, editable);
 }
 
 void XWGridWindow::setCellModified(int row, int column, bool modified)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
+
+    XWGridColumnStore& cells = m_gridColumns.at(column).cells;
+
+    // ignore if not changed
+    if(cells.flag(row, XWGRID_CELL_MODIFIED) == modified) return;
 
     // set flag
-    m_gridData.at(row).cells.at(column).modified = modified;
+    cells.setFlag(row, XWGRID_CELL_MODIFIED, modified);
+
+    // NOTE: modified cells use different font (value is not changed)
+    _invalidateCell(row, column, false);
 }
 
 void XWGridWindow::setCellClickable(int row, int column, bool clickable)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
 
     // set flag
-    m_gridData.at(row).cells.at(column).clickable = clickable;
+    m_gridColumns.at(column).cells.setFlag(row, XWGRID_CELL_CLICKABLE, clickable);
 }
 
 void XWGridWindow::setCellSelectable(int row, int column, bool selectable)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
 
     // set flag
-    m_gridData.at(row).cells.at(column).selectable = selectable;
+    m_gridColumns.at(column).cells.setFlag(row, XWGRID_CELL_SELECTABLE, selectable);
 }
 
 void XWGridWindow::setCellSelected(int row, int column, bool selected)
@@ -354,17 +723,41 @@ void XWGridWindow::setCellSelected(int row, int column, bool selected)
     // validate index
     if(!_validateIndex(row, column)) return;
 
+    // selection is kept separately in virtual mode
+    if(isVirtual())
+    {
+        if(selected)
+            m_virtualSelection.insert(std::make_pair(row, column));
+        else
+            m_virtualSelection.erase(std::make_pair(row, column));
+
+        // update cached row if any
+        _gridRowCacheT::iterator it = m_virtualRows.find(row);
+        if(it != m_virtualRows.end()) m_gridColumns.at(column).cells.setFlag(it->second, XWGRID_CELL_SELECTED, selected);
+
+        // repaint cell
+        _repaintCell(row, column);
+
+        return;
+    }
+
     // set flag
-    m_gridData.at(row).cells.at(column).selected = selected;
+    m_gridColumns.at(column).cells.setFlag(row, XWGRID_CELL_SELECTED, selected);
+
+    // repaint cell
+    _repaintCell(row, column);
 }
 
 void XWGridWindow::setCellUserData(int row, int column, LRESULT data)
 {
     // validate index
-    if(!_validateIndex(row, column)) return;
+    if(!_validateCellData(row, column)) return;
+
+    XWGridColumnStore& cells = m_gridColumns.at(column).cells;
 
     // set user data
-    m_gridData.at(row).cells.at(column).userData = data;
+    if(data || cells.attributes(row))
+        cells.editAttributes(row).userData = data;
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -375,8 +768,11 @@ const wchar_t* XWGridWindow::cellText(int row, int column)
     // validate index
     if(!_validateIndex(row, column)) return 0;
 
+    // NOTE: cached row is kept until next paint in virtual mode, returned text stays valid
+    if(isVirtual()) m_virtualTextRows.insert(row);
+
     // get text
-    return m_gridData.at(row).cells.at(column).text.c_str();
+    return m_gridColumns.at(column).cells.text(_cellIndex(row));
 }
 
 int XWGridWindow::cellTextLength(int row, int column)
@@ -385,7 +781,7 @@ int XWGridWindow::cellTextLength(int row, int column)
     if(!_validateIndex(row, column)) return 0;
 
     // get text length
-    return (int)m_gridData.at(row).cells.at(column).text.length();
+    return m_gridColumns.at(column).cells.textLength(_cellIndex(row));
 }
 
 int XWGridWindow::cellListIndex(int row, int column)
@@ -394,7 +790,9 @@ int XWGridWindow::cellListIndex(int row, int column)
     if(!_validateIndex(row, column)) return XWGRID_VALUE_NOT_SET;
 
     // get index
-    return m_gridData.at(row).cells.at(column).listIndex;
+    const XWGridColumnStore::CellAttributes* attributes = m_gridColumns.at(column).cells.attributes(_cellIndex(row));
+
+    return attributes ? attributes->listIndex : XWGRID_VALUE_NOT_SET;
 }
 
 LRESULT XWGridWindow::cellUserData(int row, int column)
@@ -403,7 +801,9 @@ LRESULT XWGridWindow::cellUserData(int row, int column)
     if(!_validateIndex(row, column)) return 0;
 
     // get data
-    return m_gridData.at(row).cells.at(column).userData;
+    const XWGridColumnStore::CellAttributes* attributes = m_gridColumns.at(column).cells.attributes(_cellIndex(row));
+
+    return attributes ? attributes->userData : 0;
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -415,7 +815,7 @@ XWGridWindow::TCellType XWGridWindow::cellType(int row, int column)
     if(!_validateIndex(row, column)) return eCellTypeText;
 
     // get type
-    return m_gridData.at(row).cells.at(column).type;
+    return (TCellType)m_gridColumns.at(column).cells.type(_cellIndex(row));
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -428,6 +828,12 @@ void XWGridWindow::setStyle(const GridStyle& style)
 
     // init style properties
     _initStyle();
+
+    // font may be changed, measure all cells
+    _invalidateAllRows(true);
+
+    // colors may be changed
+    _requestRepaint();
 }
 
 void XWGridWindow::getStyle(GridStyle& style)
@@ -524,8 +930,8 @@ void XWGridWindow::setRowMinMaxHeight(int minHeight, int maxHeight)
     m_rowMinHeight = minHeight;
     m_rowMaxHeight = maxHeight;
 
-    // require full layout update
-    m_layoutUpdateNeeded = true;
+    // update row heights (cells are not measured again)
+    _invalidateAllRows(false);
 }
 
 void XWGridWindow::setRowFixedHeight(int height)
@@ -539,8 +945,8 @@ void XWGridWindow::setRowFixedHeight(int height)
     // update flag
     m_fixedRowHeight = (height != XWGRID_VALUE_NOT_SET);
 
-    // require full layout update
-    m_layoutUpdateNeeded = true;
+    // update row heights (cells are not measured again)
+    _invalidateAllRows(false);
 }
 
 void XWGridWindow::reseRowFixedHeight()
@@ -551,8 +957,8 @@ void XWGridWindow::reseRowFixedHeight()
     // reset flag
     m_fixedRowHeight = false;
 
-    // require full layout update
-    m_layoutUpdateNeeded = true;
+    // update row heights (cells are not measured again)
+    _invalidateAllRows(false);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -561,7 +967,7 @@ void XWGridWindow::reseRowFixedHeight()
 bool XWGridWindow::getContextCell(int& row, int& column)
 {
     // check if context cell is set
-    if(m_contextRow >= 0 && m_contextRow < (int)m_gridData.size() &&
+    if(m_contextRow >= 0 && m_contextRow < rowCount() &&
        m_contextColumn >= 0 && m_contextColumn < m_columnCount)
     {
         // copy
@@ -575,6 +981,24 @@ bool XWGridWindow::getContextCell(int& row, int& column)
     return false;
 }
 
+/////////////////////////////////////////////////////////////////////
+// live resize (from XWHWND)
+/////////////////////////////////////////////////////////////////////
+void XWGridWindow::beginLiveResize()
+{
+    // NOTE: editor window is positioned on resize, grid is resized as usual while editing
+    if(_activeEditor()) return;
+
+    // grid layout is updated once live resize ends
+    beginLiveResizeSnapshot();
+}
+
+void XWGridWindow::endLiveResize()
+{
+    // update layout and repaint
+    endLiveResizeSnapshot();
+}
+
 /////////////////////////////////////////////////////////////////////
 // scrolling (from IXWScrollable)
 /////////////////////////////////////////////////////////////////////
@@ -602,26 +1026,34 @@ int XWGridWindow::contentHeight()
 
 void XWGridWindow::setScrollOffsetX(int scrollOffsetX)
 {
+    // scroll distance
+    int dX = XWindow::scrollOffsetX() - scrollOffsetX;
+    int dY = 0;
+
     // move editor if active
-    _moveEditor(XWindow::scrollOffsetX() - scrollOffsetX, 0);
+    _moveEditor(dX, dY);
 
     // pass to parent
     XWindow::setScrollOffsetX(scrollOffsetX);
 
-    // repaint
-    repaint();
+    // move painted content
+    _scrollContent(dX, dY);
 }
 
 void XWGridWindow::setScrollOffsetY(int scrollOffsetY)
 {
+    // scroll distance
+    int dX = 0;
+    int dY = XWindow::scrollOffsetY() - scrollOffsetY;
+
     // move editor if active
-    _moveEditor(0, XWindow::scrollOffsetY() - scrollOffsetY);
+    _moveEditor(dX, dY);
 
     // pass to parent
     XWindow::setScrollOffsetY(scrollOffsetY);
 
-    // repaint
-    repaint();
+    // move painted content
+    _scrollContent(dX, dY);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -629,94 +1061,105 @@ void XWGridWindow::setScrollOffsetY(int scrollOffsetY)
 /////////////////////////////////////////////////////////////////////
 void XWGridWindow::onPaint(HDC hdc, PAINTSTRUCT& ps)
 {
-    // check if layout update is needed
-    _updateLayoutIfNeeded();
+    // NOTE: layout must be valid for painting, even if bulk update is not completed
+    if(m_layoutUpdateNeeded) _updateLayout();
 
-    // select font
-    ::SelectObject(hdc, m_textFont);
+    // read visible rows from data source in virtual mode
+    if(isVirtual())
+    {
+        _loadVirtualRows();
 
-    // text color
-    if(isEnabled())
-        ::SetTextColor(hdc, m_gridStyle.textColor);
-    else
-        ::SetTextColor(hdc, m_gridStyle.disabledColor);        
+        // NOTE: new rows may need wider columns
+        if(m_layoutUpdateNeeded) _updateLayout();
+    }
 
-    // fill color
-    ::SetBkColor(hdc, m_gridStyle.fillColor);
-    ::SetBkMode(hdc, OPAQUE);
+    // ignore if there is nothing to paint
+    if(width() <= 0 || height() <= 0)
+    {
+        m_repaintAllNeeded = false;
+        return;
+    }
 
-    // select pen
-    HPEN hPen = ::CreatePen(PS_SOLID, m_gridStyle.lineWidth, m_gridStyle.borderColor);
-    HGDIOBJ oldPen = ::SelectObject(hdc, hPen);
+    RECT paintRect = ps.rcPaint;
+    HDC hScreenDC = hdc;
+    HDC hWindowDC = 0;
 
-    // loop over rows
-    int posY = 0;
-    for(_gridRowsT::const_iterator rit = m_gridData.begin(); rit != m_gridData.end(); ++rit)
+    // NOTE: cells may be moved if layout has been changed, whole window is painted then.
+    //       Paint DC is clipped to invalidated part, so window DC is used to show whole
+    //       window in the same pass (without invalidating it again)
+    if(m_repaintAllNeeded)
     {
-        int rowHeight = rit->height + 2 * m_gridStyle.spacing;
+        m_repaintAllNeeded = false;
 
-        // ignore not visible rows
-        if(posY + rit->height >= scrollOffsetY()) 
+        if(paintRect.left > 0 || paintRect.top > 0 || paintRect.right < width() || paintRect.bottom < height())
         {
-            // double check that data is correct
-            XWASSERT(rit->cells.size() == m_gridColumns.size());
-            if(rit->cells.size() != m_gridColumns.size()) continue;
+            hWindowDC = ::GetDC(hwnd());
 
-            // loop over columns
-            int posX = 0;
-            for(size_t columnIdx = 0; columnIdx < rit->cells.size(); ++columnIdx)
+            if(hWindowDC)
             {
-                // column width
-                int columnWidth = m_gridColumns.at(columnIdx).width + 2 * m_gridStyle.spacing;
-
-                // ignore not visible columns
-                if(posX + columnWidth >= scrollOffsetX()) 
-                {
-                    // get cell
-                    const GridCellData& cell = rit->cells.at(columnIdx);
-
-                    // paint cell
-                    _paintCell(hdc, posX - scrollOffsetX(), 
-                                    posY - scrollOffsetY(), 
-                                    columnWidth + 2 * m_gridStyle.lineWidth, 
-                                    rowHeight + 2 * m_gridStyle.lineWidth, 
-                                    cell);
-                }
-
-                // move position
-                posX += columnWidth + m_gridStyle.lineWidth;
+                hScreenDC = hWindowDC;
+                ::SetRect(&paintRect, 0, 0, width(), height());
             }
         }
-
-        // move position
-        posY += rowHeight + m_gridStyle.lineWidth;
     }
 
-    // fill the rest if needed
-    if(posY + m_gridStyle.lineWidth < height())
-    {
-        RECT fillRect;
-        fillRect.left = 0;
-        fillRect.right = width();
-        fillRect.top = posY + m_gridStyle.lineWidth;
-        fillRect.bottom = height();
+    // init cache (if not there already)
+    _initGDICache(hdc);
+
+    // get double buffering DC from cache (paint directly if not available)
+    HDC hDoubleBufferDC = m_pGDIResourcesCache ? m_pGDIResourcesCache->getDoubleBufferDC(hdc, width(), height()) : 0;
+    HDC hPaintDC = (hDoubleBufferDC != 0) ? hDoubleBufferDC : hScreenDC;
 
-        ::ExtTextOutW(hdc, 0, 0, ETO_OPAQUE, &fillRect, L"", 0, 0);
+    // paint invalidated part
+    _paintRect(hPaintDC, paintRect);
+
+    // copy painted part to screen
+    if(hDoubleBufferDC)
+    {
+        ::BitBlt(hScreenDC, paintRect.left, paintRect.top, 
+                            paintRect.right - paintRect.left, 
+                            paintRect.bottom - paintRect.top, 
+                            hDoubleBufferDC, paintRect.left, paintRect.top, SRCCOPY);
     }
 
-    // remove pen
-    ::SelectObject(hdc, oldPen);
-    ::DeleteObject(hPen);
+    // release window DC if used
+    if(hWindowDC) ::ReleaseDC(hwnd(), hWindowDC);
 }
 
-void XWGridWindow::onResize(int type, int width, int height)
+bool XWGridWindow::onPrintClient(HDC hdc, const RECT& rcClient)
 {
-    // update layout
-    _updateLayout();
+    // NOTE: layout must be valid for painting (same as onPaint)
+    if(m_layoutUpdateNeeded) _updateLayout();
 
-    // update editor if active
-    _updateEditor();
-}
+    // read visible rows from data source in virtual mode
+    if(isVirtual())
+    {
+        _loadVirtualRows();
+
+        // NOTE: new rows may need wider columns
+        if(m_layoutUpdateNeeded) _updateLayout();
+    }
+
+    // ignore if there is nothing to paint
+    if(width() <= 0 || height() <= 0) return false;
+
+    // init cache (if not there already)
+    _initGDICache(hdc);
+
+    // paint whole window (target DC is off screen already, no double buffering)
+    _paintRect(hdc, rcClient);
+
+    return true;
+}
+
+void XWGridWindow::onResize(int type, int width, int height)
+{
+    // update layout
+    _updateLayout();
+
+    // update editor if active
+    _updateEditor();
+}
 
 void XWGridWindow::onContentChanged()
 {
@@ -757,7 +1200,7 @@ bool XWGridWindow::onMouseClick(UINT uButtonMsg, int posX, int posY, WPARAM flag
         _updateEditing(m_contextRow, m_contextColumn);
 
         // report event if item is clickable
-        if(cellFound && m_gridData.at(m_contextRow).cells.at(m_contextColumn).clickable)
+        if(cellFound && m_gridColumns.at(m_contextColumn).cells.flag(_cellIndex(m_contextRow), XWGRID_CELL_CLICKABLE))
         {
             notifyParentWindow(XWGRID_NOTIFY_CELL_CLICKED);
         }
@@ -814,7 +1257,7 @@ bool XWGridWindow::_validateIndex(int row, int column)
     if(!_validateColumn(column)) return false;
 
     // validate row
-    if(row >= 0 && row < (int)m_gridData.size()) return true;
+    if(row >= 0 && row < rowCount()) return true;
 
     // index is not valid
     XWASSERT1(0, "XWGridWindow: row index is not valid");
@@ -824,7 +1267,49 @@ bool XWGridWindow::_validateIndex(int row, int column)
 bool XWGridWindow::_isValidIndex(int row, int column)
 {
     return (column >= 0 && column < m_columnCount) &&
-           (row >= 0 && row < (int)m_gridData.size());
+           (row >= 0 && row < rowCount());
+}
+
+bool XWGridWindow::_validateCellData(int row, int column)
+{
+    // NOTE: cell data is read from data source in virtual mode
+    if(isVirtual())
+    {
+        XWASSERT1(0, "XWGridWindow: cell data can't be set in virtual mode");
+        return false;
+    }
+
+    return _validateIndex(row, column);
+}
+
+int XWGridWindow::_cellIndex(int row)
+{
+    // read row from data source in virtual mode
+    if(isVirtual()) return _virtualSlot(row);
+
+    return row;
+}
+
+int XWGridWindow::_rowHeight(int row)
+{
+    // rows have the same height in virtual mode
+    if(isVirtual()) return m_virtualRowHeight;
+
+    return m_gridRows.at(row).height;
+}
+
+void XWGridWindow::_clearCells()
+{
+    // remove cells from columns
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
+    {
+        cit->cells.clear();
+    }
+
+    // remove cached rows
+    m_virtualRows.clear();
+    m_virtualFreeSlots.clear();
+    m_virtualTextRows.clear();
 }
 
 void XWGridWindow::_initStyle()
@@ -944,8 +1429,8 @@ void XWGridWindow::_fitColumns()
         m_gridColumns.back().width += fillSize;
     }
 
-    // update content size
-    m_contentWidth = width();
+    // update content size and column offsets
+    _updateContentSize();
 }
 
 void XWGridWindow::_updateLayout()
@@ -956,393 +1441,727 @@ void XWGridWindow::_updateLayout()
     // select font
     ::SelectObject(hdc, m_textFont);
 
-    // loop over all rows
-    for(_gridRowsT::iterator rit = m_gridData.begin(); rit != m_gridData.end(); ++rit)
-    {
-        // double check that data is correct
-        XWASSERT(rit->cells.size() == m_gridColumns.size());
-        if(rit->cells.size() != m_gridColumns.size()) continue;
-
-        // loop over columns
-        for(size_t columnIdx = 0; columnIdx < rit->cells.size(); ++columnIdx)
-        {
-            // active cell
-            GridCellData& cell = rit->cells.at(columnIdx);
-
-            int cellWidth = 0;
-            int cellHeight = 0;
-
-            // check cell type
-            if(cell.type == eCellTypeText || cell.type == eCellTypeList)
-            {
-                // check if cell is modified
-                if(cell.modified)
-                {
-                    // select modified font
-                    ::SelectObject(hdc, m_modifiedFont);
-                }
-
-                // text size
-                if(cell.text.length())
-                {
-                    // compute size rect
-                    SIZE size;
-                    ::GetTextExtentPoint32W(hdc, cell.text.c_str(), (int)cell.text.length(), &size);
+    // NOTE: keep column positions to find if painted cells are moved
+    std::vector<int> oldColumnOffsets(m_columnOffsets);
+    bool cellsMoved = false;
 
-                    cellWidth = size.cx;
-                    cellHeight = size.cy;
-                }
+    // check mode
+    if(isVirtual())
+    {
+        int oldRowHeight = m_virtualRowHeight;
 
-                // check if cell is modified
-                if(cell.modified)
-                {
-                    // select normal font back
-                    ::SelectObject(hdc, m_textFont);
-                }
+        // NOTE: all rows have the same height in virtual mode
+        m_virtualRowHeight = _fitRowHeight(m_fontHeight);
+        if(m_virtualRowHeight != oldRowHeight) cellsMoved = true;
 
-            } else if(cell.type == eCellTypeBitmap)
-            {
-                XWASSERT(cell.bitmap);
-                if(cell.bitmap)
-                {
-                    // NOTE: assume that bitmaps are of the same size
-                    XGdiHelpers::getBitmapSize(cell.bitmap, cellWidth, cellHeight);
-                }
+        // measure only cached rows
+        for(_gridRowCacheT::iterator rit = m_virtualRows.begin(); rit != m_virtualRows.end(); ++rit)
+        {
+            _measureCells(hdc, rit->second);
+        }
 
-            } else
-            {
-                XWASSERT1(0, "XWGridWindow: unknown cell type");
-                continue;
-            }
+    } else
+    {
+        // update view order if needed (offsets are rebuilt if it is changed)
+        if(m_viewUpdateNeeded)
+            _updateView();
 
-            // update row height 
-            if(m_fixedRowHeight)
-            {
-                rit->height = m_rowFixedHeight;
+        // rows are moved if offsets are rebuilt or rows are appended
+        if(m_rowOffsetsRebuildNeeded || m_rowOffsets.count() < _viewRowCount())
+            cellsMoved = true;
 
-            } else
-            {
-                // set row height
-                if(rit->height < cellHeight)
-                    rit->height = cellHeight;
+        // add appended rows to offsets (they are dirty and set below)
+        while(!m_rowOffsetsRebuildNeeded && m_rowOffsets.count() < _viewRowCount())
+            m_rowOffsets.appendValue(0);
 
-                // respect minimum 
-                if(m_rowMinHeight != XWGRID_VALUE_NOT_SET && m_rowMinHeight > rit->height)
-                    rit->height = m_rowMinHeight;
+        // NOTE: only rows with changed cells are measured
+        for(size_t idx = 0; idx < m_dirtyRows.size(); ++idx)
+        {
+            // ignore rows that don't exist anymore
+            if(m_dirtyRows[idx] < 0 || m_dirtyRows[idx] >= (int)m_gridRows.size()) continue;
 
-                // respect maximum
-                if(m_rowMaxHeight != XWGRID_VALUE_NOT_SET && m_rowMaxHeight < rit->height)
-                    rit->height = m_rowMaxHeight;
-            }
+            GridRow& row = m_gridRows.at(m_dirtyRows[idx]);
+            int oldRowHeight = row.height;
 
-            // active column
-            GridColumn& column = m_gridColumns.at(columnIdx);
+            // measure
+            row.height = _fitRowHeight(_measureCells(hdc, m_dirtyRows[idx]));
+            if(row.height != oldRowHeight) cellsMoved = true;
 
-            // update column width
-            if(!column.fixedWidth)
-            {
-                // update content size
-                if(column.maxContentWidth < cellWidth)
-                    column.maxContentWidth = cellWidth;
+            // reset flag
+            row.layoutDirty = false;
 
-                // set column width
-                column.width = column.maxContentWidth;
+            // update row offsets (rows filtered out are not shown)
+            if(!m_rowOffsetsRebuildNeeded && _viewRow(m_dirtyRows[idx]) != XWGRID_VALUE_NOT_SET)
+                m_rowOffsets.setValue(_viewRow(m_dirtyRows[idx]), row.height + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing);
+        }
 
-                // respect minimum
-                if(column.minWidth != XWGRID_VALUE_NOT_SET && column.minWidth > column.width)
-                    column.width = column.minWidth;
+        m_dirtyRows.clear();
 
-                // respect maximum
-                if(column.maxWidth != XWGRID_VALUE_NOT_SET && column.maxWidth < column.width)
-                    column.width = column.maxWidth;
-            }
-        }
+        // rebuild offsets if rows have been inserted or removed
+        if(m_rowOffsetsRebuildNeeded)
+            _rebuildRowOffsets();
     }
 
     // release device context
     ::ReleaseDC(hwnd(), hdc); 
 
+    // set column widths from content
+    _updateColumnWidths();
+
     // update content size
     _updateContentSize();
 
     // try to fit columns to size
     _fitColumns();
 
+    // check if columns are moved
+    if(m_columnOffsets != oldColumnOffsets) cellsMoved = true;
+
+    // NOTE: single cell repaint is not enough if cells are moved
+    if(cellsMoved) m_repaintAllNeeded = true;
+
     // reset flag
     m_layoutUpdateNeeded = false;
 }
 
 void XWGridWindow::_updateLayoutIfNeeded()
 {
-    if(m_layoutUpdateNeeded)
+    // NOTE: layout is updated once bulk update is completed
+    if(m_layoutUpdateNeeded && m_updateLevel == 0)
         _updateLayout();
 }
 
-void XWGridWindow::_updateContentSize()
+int XWGridWindow::_measureCells(HDC hdc, int cellIdx)
 {
-    // content width
-    m_contentWidth = m_gridStyle.lineWidth;
-    for(_gridColumnsT::const_iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
-    {
-        m_contentWidth += cit->width + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
-    }
+    int contentHeight = 0;
 
-    // content height
-    m_contentHeight = m_gridStyle.lineWidth;
-    for(_gridRowsT::const_iterator rit = m_gridData.begin(); rit != m_gridData.end(); ++rit)
+    // loop over columns
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
     {
-        m_contentHeight += rit->height + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
+        // measure cell if changed
+        if(!cit->cells.flag(cellIdx, XWGRID_CELL_MEASURED))
+            _measureCell(hdc, *cit, cellIdx);
+
+        // find highest cell
+        if(contentHeight < cit->cells.extentHeight(cellIdx))
+            contentHeight = cit->cells.extentHeight(cellIdx);
     }
+
+    return contentHeight;
 }
 
-bool XWGridWindow::_findIndex(int posX, int posY, int& row, int& column)
+void XWGridWindow::_measureCell(HDC hdc, GridColumn& column, int cellIdx)
 {
-    // reset output
-    row = XWGRID_VALUE_NOT_SET;
-    column = XWGRID_VALUE_NOT_SET;
+    XWGridColumnStore& cells = column.cells;
 
-    // find column
-    int findPosX = -1 * scrollOffsetX();
-    for(size_t columnIdx = 0; columnIdx < m_gridColumns.size(); ++columnIdx)
+    int cellWidth = 0;
+    int cellHeight = 0;
+
+    // check cell type
+    if(cells.type(cellIdx) == eCellTypeText || cells.type(cellIdx) == eCellTypeList)
     {
-        const GridColumn& columnRef = m_gridColumns.at(columnIdx);
+        bool modified = cells.flag(cellIdx, XWGRID_CELL_MODIFIED);
 
-        // match
-        if(posX > findPosX && posX < findPosX + columnRef.width + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing)
+        // check if cell is modified
+        if(modified)
         {
-            // column found
-            column = (int)columnIdx;
-            break;
+            // select modified font
+            ::SelectObject(hdc, m_modifiedFont);
         }
 
-        findPosX += columnRef.width + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
-    }
+        // text size
+        if(cells.textLength(cellIdx))
+        {
+            // compute size rect
+            SIZE size;
+            ::GetTextExtentPoint32W(hdc, cells.text(cellIdx), cells.textLength(cellIdx), &size);
 
-    // check if found
-    if(column == XWGRID_VALUE_NOT_SET) return false;
+            cellWidth = size.cx;
+            cellHeight = size.cy;
+        }
+
+        // check if cell is modified
+        if(modified)
+        {
+            // select normal font back
+            ::SelectObject(hdc, m_textFont);
+        }
 
-    // find row
-    int findPosY = -1 * scrollOffsetY();
-    for(size_t rowIdx = 0; rowIdx < m_gridData.size(); ++rowIdx)
+    } else if(cells.type(cellIdx) == eCellTypeBitmap)
     {
-        const GridRow& rowRef = m_gridData.at(rowIdx);
+        const XWGridColumnStore::CellAttributes* attributes = cells.attributes(cellIdx);
 
-        // match
-        if(posY > findPosY && posY < findPosY + rowRef.height + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing)
+        XWASSERT(attributes && attributes->bitmap);
+        if(attributes && attributes->bitmap)
         {
-            // row found
-            row = (int)rowIdx;
-            return true;
+            // NOTE: assume that bitmaps are of the same size
+            XGdiHelpers::getBitmapSize(attributes->bitmap, cellWidth, cellHeight);
         }
 
-        findPosY += rowRef.height + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
+    } else
+    {
+        XWASSERT1(0, "XWGridWindow: unknown cell type");
     }
 
-    // reset column
-    column = XWGRID_VALUE_NOT_SET;
+    // remove previous width from column
+    if(cells.flag(cellIdx, XWGRID_CELL_COUNTED))
+        _removeContentWidth(column, cells.extentWidth(cellIdx));
 
-    // cell not found
-    return false;
+    // keep size
+    cells.setExtent(cellIdx, cellWidth, cellHeight);
+    cells.setFlag(cellIdx, XWGRID_CELL_MEASURED, true);
+
+    // check mode
+    if(isVirtual())
+    {
+        // NOTE: only cached rows are known in virtual mode, keep widest cell seen so far
+        if(column.maxContentWidth < cells.extentWidth(cellIdx))
+            column.maxContentWidth = cells.extentWidth(cellIdx);
+
+        return;
+    }
+
+    // add new width to column
+    column.contentWidths[cells.extentWidth(cellIdx)]++;
+    cells.setFlag(cellIdx, XWGRID_CELL_COUNTED, true);
 }
 
-void XWGridWindow::_getCellPos(int row, int column, int& posX, int& posY)
+int XWGridWindow::_fitRowHeight(int contentHeight)
 {
-    // loop over rows
-    posY = -1 * scrollOffsetY();
-    for(size_t rowIdx = 0; rowIdx < m_gridData.size(); ++rowIdx)
-    {
-        const GridRow& rowRef = m_gridData.at(rowIdx);
+    // use fixed height if set
+    if(m_fixedRowHeight) return m_rowFixedHeight;
 
-        // double check that data is correct
-        XWASSERT(rowRef.cells.size() == m_gridColumns.size());
-        if(rowRef.cells.size() != m_gridColumns.size()) continue;
+    int rowHeight = contentHeight;
 
-        // loop over columns
-        posX =  -1 * scrollOffsetX();
-        for(size_t columnIdx = 0; columnIdx < rowRef.cells.size(); ++columnIdx)
-        {
-            // column width
-            int columnWidth = m_gridColumns.at(columnIdx).width;
+    // respect minimum 
+    if(m_rowMinHeight != XWGRID_VALUE_NOT_SET && m_rowMinHeight > rowHeight)
+        rowHeight = m_rowMinHeight;
 
-            // check cell index
-            if(rowIdx == row && columnIdx == column) return;
+    // respect maximum
+    if(m_rowMaxHeight != XWGRID_VALUE_NOT_SET && m_rowMaxHeight < rowHeight)
+        rowHeight = m_rowMaxHeight;
 
-            // move position
-            posX += columnWidth + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
-        }
+    return rowHeight;
+}
 
-        // move position
-        posY += rowRef.height + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
+void XWGridWindow::_updateColumnWidths()
+{
+    // loop over all columns
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
+    {
+        // widest cell in column (maximum is kept directly in virtual mode)
+        if(!isVirtual())
+            cit->maxContentWidth = cit->contentWidths.empty() ? XWGRID_VALUE_NOT_SET : cit->contentWidths.rbegin()->first;
+
+        // keep fixed width
+        if(cit->fixedWidth) continue;
+
+        // set column width
+        cit->width = (cit->maxContentWidth > 0) ? cit->maxContentWidth : 0;
+
+        // respect minimum
+        if(cit->minWidth != XWGRID_VALUE_NOT_SET && cit->minWidth > cit->width)
+            cit->width = cit->minWidth;
+
+        // respect maximum
+        if(cit->maxWidth != XWGRID_VALUE_NOT_SET && cit->maxWidth < cit->width)
+            cit->width = cit->maxWidth;
     }
 }
 
-void XWGridWindow::_findSelection(int& row, int& column)
+void XWGridWindow::_resetContentWidths()
 {
-    for(size_t rowIdx = 0; rowIdx != m_gridData.size(); ++rowIdx)
+    // NOTE: cells must be measured again after this call
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
     {
-        const GridRow& rowRef = m_gridData.at(rowIdx);
+        cit->contentWidths.clear();
+        cit->maxContentWidth = XWGRID_VALUE_NOT_SET;
+    }
+}
 
-        for(size_t columnIdx = 0; columnIdx != rowRef.cells.size(); ++columnIdx)
-        {
-            if(rowRef.cells.at(columnIdx).selected)
-            {
-                row = (int)rowIdx;
-                column = (int)columnIdx;
+void XWGridWindow::_removeContentWidth(GridColumn& column, int width)
+{
+    std::map<int, int>::iterator it = column.contentWidths.find(width);
 
-                // stop
-                return;
-            }
-        }
-    }
+    // double check that width is counted
+    XWASSERT(it != column.contentWidths.end());
+    if(it == column.contentWidths.end()) return;
 
-    // not found
-    row = XWGRID_VALUE_NOT_SET;
-    column = XWGRID_VALUE_NOT_SET;
+    // remove width if this is last cell with it
+    if(--it->second == 0)
+        column.contentWidths.erase(it);
 }
 
-void XWGridWindow::_updateSelection(int row, int column)
+void XWGridWindow::_invalidateCell(int row, int column, bool valueChanged)
 {
-    // reset selection if any
-    for(_gridRowsT::iterator rit = m_gridData.begin(); rit != m_gridData.end(); ++rit)
+    // request layout update
+    m_layoutUpdateNeeded = true;
+
+    // only cached rows are measured in virtual mode
+    if(isVirtual())
     {
-        for(std::vector<GridCellData>::iterator cit = rit->cells.begin(); cit != rit->cells.end(); ++cit)
-        {
-            // reset selection
-            cit->selected = false;
-        }
-    }
+        _gridRowCacheT::iterator it = m_virtualRows.find(row);
+        if(it != m_virtualRows.end()) m_gridColumns.at(column).cells.setFlag(it->second, XWGRID_CELL_MEASURED, false);
 
-    // select cell 
-    if(_isValidIndex(row, column))
-    {        
-        if(m_gridData.at(row).cells.at(column).selectable)
-            m_gridData.at(row).cells.at(column).selected = true;
+        // repaint cell
+        _repaintCell(row, column);
+
+        return;
     }
 
-    // repaint
-    repaint();
+    // mark cell
+    m_gridColumns.at(column).cells.setFlag(row, XWGRID_CELL_MEASURED, false);
+
+    // mark row
+    _invalidateRow(row);
+
+    // row may be moved or filtered out if value used by view has changed
+    if(valueChanged && _viewUsesColumn(column))
+        _invalidateViewRow(row);
+
+    // NOTE: whole window is repainted if cells are moved by layout update
+    _repaintCell(row, column);
 }
 
-void XWGridWindow::_createTextEditor()
+void XWGridWindow::_invalidateRow(int row)
 {
-    // ignore if already created
-    if(m_gridEditor.textEditor) return;
+    // request layout update
+    m_layoutUpdateNeeded = true;
 
-    // create editor
-    m_gridEditor.textEditor = new XLineEdit(hwnd(), this);
-    m_gridEditor.textEditor->setFont(m_textFont);
+    GridRow& rowRef = m_gridRows.at(row);
 
-    // subclass editor 
-    if(!::SetWindowSubclass(m_gridEditor.textEditor->hwnd(), _subclassProc, XWGRID_SUBCLASS_ID_EDITBOX, (DWORD_PTR)this))
+    // add row to dirty list once
+    if(!rowRef.layoutDirty)
     {
-        XWTRACE_WERR_LAST("XWGridWindow: failed to subclass editbox window");
+        rowRef.layoutDirty = true;
+        m_dirtyRows.push_back(row);
     }
 }
 
-void XWGridWindow::_createListEditor()
+void XWGridWindow::_invalidateAllRows(bool remeasure)
 {
-    // ignore if already created
-    if(m_gridEditor.listEditor) return;
+    // request layout update
+    m_layoutUpdateNeeded = true;
 
-    // create editor
-    m_gridEditor.listEditor = new XComboBox(hwnd(), this, false);
-    m_gridEditor.listEditor->setFont(m_textFont);
+    // remove counted widths if cells are measured again
+    if(remeasure) _resetContentWidths();
 
-    // subclass combobox
-    if(!::SetWindowSubclass(m_gridEditor.listEditor->hwnd(), _subclassProc, XWGRID_SUBCLASS_ID_COMBOBOX, (DWORD_PTR)this))
+    // mark cells (cached rows in virtual mode)
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end() && remeasure; ++cit)
     {
-        XWTRACE_WERR_LAST("XWGridWindow: failed to subclass combobox window");
+        cit->cells.clearFlag(XWGRID_CELL_MEASURED | XWGRID_CELL_COUNTED);
     }
 
-    // NOTE: we need to subclass also combobox parent window
-    HWND comboParent = ::GetParent(m_gridEditor.listEditor->hwnd());
-    if(comboParent && comboParent != hwnd())
+    // NOTE: row heights are common in virtual mode
+    if(isVirtual()) return;
+
+    // NOTE: all rows are added to dirty list, list is rebuilt to keep rows only once
+    m_dirtyRows.clear();
+    m_dirtyRows.reserve(m_gridRows.size());
+
+    for(size_t rowIdx = 0; rowIdx < m_gridRows.size(); ++rowIdx)
     {
-        if(!::SetWindowSubclass(m_gridEditor.listEditor->hwnd(), _subclassProc, XWGRID_SUBCLASS_ID_COMBOBOX_PARENT, (DWORD_PTR)this))
-        {
-            XWTRACE_WERR_LAST("XWGridWindow: failed to subclass combobox parent window");
-        }
+        // mark row
+        m_gridRows.at(rowIdx).layoutDirty = true;
+        m_dirtyRows.push_back((int)rowIdx);
     }
 }
 
-void XWGridWindow::_completeEditing()
+void XWGridWindow::_insertRowLayout(int rowAt)
 {
-    // ignore if not editing
-    if(!m_gridEditor.editing) return;
+    // move dirty rows below inserted one
+    for(size_t idx = 0; idx < m_dirtyRows.size(); ++idx)
+    {
+        if(m_dirtyRows[idx] >= rowAt) m_dirtyRows[idx]++;
+    }
 
-    bool isModified = false;
+    // NOTE: offsets of rows below are moved, rebuild them once on layout update
+    m_rowOffsetsRebuildNeeded = true;
 
-    XWASSERT(_isValidIndex(m_gridEditor.row, m_gridEditor.column));
-    GridCellData& cellRef = m_gridData.at(m_gridEditor.row).cells.at(m_gridEditor.column);
+    // measure new row
+    _invalidateRow(rowAt);
+}
 
-    // check edited cell type
-    if(cellRef.type == eCellTypeText)
+void XWGridWindow::_removeRowLayout(int rowAt)
+{
+    // remove cell widths from columns
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
     {
-        XWASSERT(m_gridEditor.textEditor);
-        if(m_gridEditor.textEditor)
+        if(cit->cells.flag(rowAt, XWGRID_CELL_COUNTED))
+            _removeContentWidth(*cit, cit->cells.extentWidth(rowAt));
+    }
+
+    // remove row from dirty rows and move rows below it
+    for(size_t idx = 0; idx < m_dirtyRows.size(); )
+    {
+        if(m_dirtyRows[idx] == rowAt)
         {
-            // read text from editor
-            m_strBuffer = m_gridEditor.textEditor->readText();
+            m_dirtyRows.erase(m_dirtyRows.begin() + idx);
+            continue;
+        }
 
-            // hide editor
-            m_gridEditor.textEditor->hide();
+        if(m_dirtyRows[idx] > rowAt) m_dirtyRows[idx]--;
+        ++idx;
+    }
 
-            // check if modified
-            isModified = (cellRef.text != m_strBuffer);
+    // NOTE: offsets of rows below are moved, rebuild them once on layout update
+    m_rowOffsetsRebuildNeeded = true;
 
-            // copy new value
-            cellRef.text = m_strBuffer;
-        }
+    // request layout update
+    m_layoutUpdateNeeded = true;
+}
+
+void XWGridWindow::_updateContentSize()
+{
+    // column offsets
+    m_columnOffsets.resize(m_gridColumns.size() + 1);
+    m_columnOffsets[0] = 0;
 
-    } else if(cellRef.type == eCellTypeList)
+    for(size_t columnIdx = 0; columnIdx < m_gridColumns.size(); ++columnIdx)
     {
-        XWASSERT(m_gridEditor.listEditor);
-        if(m_gridEditor.listEditor)
-        {
-            // check if item was selected
-            if(m_gridEditor.listEditor->hasSelectedItem())
-            {
-                // get index from editor
-                LRESULT selectedData = m_gridEditor.listEditor->selectedItemData();
+        m_columnOffsets[columnIdx + 1] = m_columnOffsets[columnIdx] + 
+            m_gridColumns.at(columnIdx).width + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
+    }
 
-                // validate
-                if(selectedData >= 0 && selectedData < cellRef.listItemCount)
-                {
-                    // check if modified
-                    isModified = (cellRef.listIndex != selectedData);
+    // content width
+    m_contentWidth = m_gridStyle.lineWidth + m_columnOffsets.back();
 
-                    // copy value
-                    cellRef.listIndex = (int)selectedData;
-                    cellRef.text = cellRef.listItems[cellRef.listIndex];
-                }
-            }
+    // content height
+    m_contentHeight = m_gridStyle.lineWidth + _rowOffset(_viewRowCount());
+}
 
-            // hide editor
-            m_gridEditor.listEditor->hide();
-        }
+void XWGridWindow::_rebuildRowOffsets()
+{
+    std::vector<int> rowSizes(_viewRowCount());
 
-    } else
+    // collect row sizes (in view order)
+    for(size_t viewIdx = 0; viewIdx < rowSizes.size(); ++viewIdx)
     {
-        XWASSERT1(0, "XWGridWindow: unsupported cell type");
+        rowSizes[viewIdx] = m_gridRows.at(_dataRow((int)viewIdx)).height + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
     }
 
-    // set modified flag
-    if(!cellRef.modified)
-        cellRef.modified = isModified;
+    // build tree in linear time
+    m_rowOffsets.assign(rowSizes);
 
-    // report if modified
-    if(isModified)
-    {
-        // set editor context
-        m_contextRow = m_gridEditor.row;
-        m_contextColumn = m_gridEditor.column;
+    // reset flag
+    m_rowOffsetsRebuildNeeded = false;
+}
 
-        // inform about new value
-        notifyParentWindow(XWGRID_NOTIFY_CELL_MODIFIED);
-    }
+int XWGridWindow::_rowOffset(int row)
+{
+    // rows have the same height in virtual mode
+    if(isVirtual()) return row * _virtualRowStep();
 
-    // reset editing flag
-    m_gridEditor.editing = false;
+    // NOTE: rows added after last layout update are not counted yet
+    if(row > m_rowOffsets.count()) row = m_rowOffsets.count();
+
+    return m_rowOffsets.prefixSum(row);
+}
+
+int XWGridWindow::_rowAtOffset(int offset)
+{
+    // NOTE: returns row covering offset, or row count if offset is after last row
+
+    // rows have the same height in virtual mode
+    if(isVirtual())
+    {
+        int row = (offset > 0) ? offset / _virtualRowStep() : 0;
+        return (row < m_virtualRowCount) ? row : m_virtualRowCount;
+    }
+
+    return m_rowOffsets.findIndex(offset);
+}
+
+int XWGridWindow::_columnAtOffset(int offset)
+{
+    // NOTE: returns column covering offset, or column count if offset is after last column
+
+    // ignore if there are no offsets yet
+    if(m_columnOffsets.size() < 2 || offset < 0) return 0;
+
+    // find first column which starts after offset
+    std::vector<int>::const_iterator it = std::upper_bound(m_columnOffsets.begin(), m_columnOffsets.end(), offset);
+
+    return (int)(it - m_columnOffsets.begin()) - 1;
+}
+
+bool XWGridWindow::_findIndex(int posX, int posY, int& row, int& column)
+{
+    // reset output
+    row = XWGRID_VALUE_NOT_SET;
+    column = XWGRID_VALUE_NOT_SET;
+
+    // position in content
+    int offsetX = posX + scrollOffsetX();
+    int offsetY = posY + scrollOffsetY();
+
+    // find cell
+    int columnIdx = _columnAtOffset(offsetX);
+    int rowIdx = _rowAtOffset(offsetY);
+
+    // check if found
+    if(columnIdx < 0 || columnIdx >= m_columnCount || columnIdx + 1 >= (int)m_columnOffsets.size()) return false;
+    if(rowIdx < 0 || rowIdx >= _viewRowCount()) return false;
+
+    // NOTE: cell borders don't belong to any cell
+    if(offsetX <= m_columnOffsets[columnIdx] || offsetY <= _rowOffset(rowIdx)) return false;
+
+    // cell found (row is found in view order)
+    row = _dataRow(rowIdx);
+    column = columnIdx;
+
+    return true;
+}
+
+void XWGridWindow::_getCellPos(int row, int column, int& posX, int& posY)
+{
+    // column position
+    posX = -1 * scrollOffsetX();
+    if(column > 0 && column < (int)m_columnOffsets.size()) posX += m_columnOffsets[column];
+
+    // row position (rows filtered out are not shown)
+    int viewRow = _viewRow(row);
+    posY = -1 * scrollOffsetY() + _rowOffset((viewRow > 0) ? viewRow : 0);
+}
+
+int XWGridWindow::_findFirstVisibleRow(int posTop, int& posY)
+{
+    // NOTE: row is returned in view order
+
+    // row at window position
+    int firstRow = _rowAtOffset(scrollOffsetY() + posTop);
+
+    // row position
+    posY = _rowOffset(firstRow);
+
+    return firstRow;
+}
+
+void XWGridWindow::_findSelection(int& row, int& column)
+{
+    // selection is kept separately in virtual mode
+    if(isVirtual())
+    {
+        if(!m_virtualSelection.empty())
+        {
+            row = m_virtualSelection.begin()->first;
+            column = m_virtualSelection.begin()->second;
+
+            // stop
+            return;
+        }
+
+        // not found
+        row = XWGRID_VALUE_NOT_SET;
+        column = XWGRID_VALUE_NOT_SET;
+
+        return;
+    }
+
+    // not found
+    row = XWGRID_VALUE_NOT_SET;
+    column = XWGRID_VALUE_NOT_SET;
+
+    // NOTE: selected cells are searched per column, first one in row order is used
+    for(size_t columnIdx = 0; columnIdx != m_gridColumns.size(); ++columnIdx)
+    {
+        int rowIdx = m_gridColumns.at(columnIdx).cells.findFlag(XWGRID_CELL_SELECTED, 0);
+
+        if(rowIdx >= 0 && (row == XWGRID_VALUE_NOT_SET || rowIdx < row))
+        {
+            row = rowIdx;
+            column = (int)columnIdx;
+        }
+    }
+}
+
+void XWGridWindow::_updateSelection(int row, int column)
+{
+    // repaint selected cells (selection is kept by grid in virtual mode)
+    if(isVirtual())
+    {
+        for(_gridSelectionT::const_iterator sit = m_virtualSelection.begin(); sit != m_virtualSelection.end(); ++sit)
+        {
+            _repaintCell(sit->first, sit->second);
+        }
+
+    } else
+    {
+        for(size_t columnIdx = 0; columnIdx != m_gridColumns.size(); ++columnIdx)
+        {
+            const XWGridColumnStore& cells = m_gridColumns.at(columnIdx).cells;
+
+            for(int rowIdx = cells.findFlag(XWGRID_CELL_SELECTED, 0); rowIdx >= 0; rowIdx = cells.findFlag(XWGRID_CELL_SELECTED, rowIdx + 1))
+            {
+                _repaintCell(rowIdx, (int)columnIdx);
+            }
+        }
+    }
+
+    // reset selection if any (cached rows only in virtual mode)
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
+    {
+        cit->cells.clearFlag(XWGRID_CELL_SELECTED);
+    }
+
+    m_virtualSelection.clear();
+
+    // select cell 
+    if(_isValidIndex(row, column))
+    {        
+        XWGridColumnStore& cells = m_gridColumns.at(column).cells;
+        int cellIdx = _cellIndex(row);
+
+        if(cells.flag(cellIdx, XWGRID_CELL_SELECTABLE))
+        {
+            cells.setFlag(cellIdx, XWGRID_CELL_SELECTED, true);
+
+            // keep selection in virtual mode
+            if(isVirtual()) m_virtualSelection.insert(std::make_pair(row, column));
+
+            // repaint selected cell
+            _repaintCell(row, column);
+        }
+    }
+}
+
+void XWGridWindow::_createTextEditor()
+{
+    // ignore if already created
+    if(m_gridEditor.textEditor) return;
+
+    // create editor
+    m_gridEditor.textEditor = new XLineEdit(hwnd(), this);
+    m_gridEditor.textEditor->setFont(m_textFont);
+
+    // subclass editor 
+    if(!::SetWindowSubclass(m_gridEditor.textEditor->hwnd(), _subclassProc, XWGRID_SUBCLASS_ID_EDITBOX, (DWORD_PTR)this))
+    {
+        XWTRACE_WERR_LAST("XWGridWindow: failed to subclass editbox window");
+    }
+}
+
+void XWGridWindow::_createListEditor()
+{
+    // ignore if already created
+    if(m_gridEditor.listEditor) return;
+
+    // create editor
+    m_gridEditor.listEditor = new XComboBox(hwnd(), this, false);
+    m_gridEditor.listEditor->setFont(m_textFont);
+
+    // subclass combobox
+    if(!::SetWindowSubclass(m_gridEditor.listEditor->hwnd(), _subclassProc, XWGRID_SUBCLASS_ID_COMBOBOX, (DWORD_PTR)this))
+    {
+        XWTRACE_WERR_LAST("XWGridWindow: failed to subclass combobox window");
+    }
+
+    // NOTE: we need to subclass also combobox parent window
+    HWND comboParent = ::GetParent(m_gridEditor.listEditor->hwnd());
+    if(comboParent && comboParent != hwnd())
+    {
+        if(!::SetWindowSubclass(m_gridEditor.listEditor->hwnd(), _subclassProc, XWGRID_SUBCLASS_ID_COMBOBOX_PARENT, (DWORD_PTR)this))
+        {
+            XWTRACE_WERR_LAST("XWGridWindow: failed to subclass combobox parent window");
+        }
+    }
+}
+
+void XWGridWindow::_completeEditing()
+{
+    // ignore if not editing
+    if(!m_gridEditor.editing) return;
+
+    bool isModified = false;
+
+    XWASSERT(_isValidIndex(m_gridEditor.row, m_gridEditor.column));
+    XWGridColumnStore& cells = m_gridColumns.at(m_gridEditor.column).cells;
+    int cellIdx = _cellIndex(m_gridEditor.row);
+
+    // check edited cell type
+    if(cells.type(cellIdx) == eCellTypeText)
+    {
+        XWASSERT(m_gridEditor.textEditor);
+        if(m_gridEditor.textEditor)
+        {
+            // read text from editor
+            m_strBuffer = m_gridEditor.textEditor->readText();
+
+            // hide editor
+            m_gridEditor.textEditor->hide();
+
+            // check if modified
+            isModified = (m_strBuffer != cells.text(cellIdx));
+
+            // copy new value
+            cells.setText(cellIdx, m_strBuffer.c_str());
+        }
+
+    } else if(cells.type(cellIdx) == eCellTypeList)
+    {
+        XWASSERT(m_gridEditor.listEditor);
+        if(m_gridEditor.listEditor)
+        {
+            // check if item was selected
+            if(m_gridEditor.listEditor->hasSelectedItem())
+            {
+                // get index from editor
+                LRESULT selectedData = m_gridEditor.listEditor->selectedItemData();
+
+                const XWGridColumnStore::CellAttributes* attributes = cells.attributes(cellIdx);
+
+                // validate
+                if(attributes && selectedData >= 0 && selectedData < attributes->listItemCount)
+                {
+                    // check if modified
+                    isModified = (attributes->listIndex != selectedData);
+
+                    // copy value
+                    XWGridColumnStore::CellAttributes& listAttributes = cells.editAttributes(cellIdx);
+                    listAttributes.listIndex = (int)selectedData;
+                    cells.setText(cellIdx, listAttributes.listItems[listAttributes.listIndex]);
+                }
+            }
+
+            // hide editor
+            m_gridEditor.listEditor->hide();
+        }
+
+    } else
+    {
+        XWASSERT1(0, "XWGridWindow: unsupported cell type");
+    }
+
+    // set modified flag
+    if(isModified)
+        cells.setFlag(cellIdx, XWGRID_CELL_MODIFIED, true);
+
+    // pass new value to data source in virtual mode
+    if(isModified && isVirtual())
+    {
+        if(cells.type(cellIdx) == eCellTypeList)
+            m_pDataSource->setGridCellListIndex(this, m_gridEditor.row, m_gridEditor.column, cells.attributes(cellIdx)->listIndex);
+        else
+            m_pDataSource->setGridCellText(this, m_gridEditor.row, m_gridEditor.column, cells.text(cellIdx));
+    }
+
+    // report if modified
+    if(isModified)
+    {
+        // set editor context
+        m_contextRow = m_gridEditor.row;
+        m_contextColumn = m_gridEditor.column;
+
+        // inform about new value
+        notifyParentWindow(XWGRID_NOTIFY_CELL_MODIFIED);
+    }
+
+    // measure edited cell on next layout update
+    if(isModified)
+        _invalidateCell(m_gridEditor.row, m_gridEditor.column, true);
+
+    // reset editing flag
+    m_gridEditor.editing = false;
 
     // layout update may be needed
     m_layoutUpdateNeeded = true;
@@ -1391,15 +2210,16 @@ void XWGridWindow::_updateEditing(int row, int column)
     _completeEditing();
 
     // start editing if possible
-    if(_isValidIndex(row, column) && m_gridData.at(row).cells.at(column).editable)
+    if(_isValidIndex(row, column) && m_gridColumns.at(column).cells.flag(_cellIndex(row), XWGRID_CELL_EDITABLE))
     {   
-        GridCellData& cellRef = m_gridData.at(row).cells.at(column);
+        const XWGridColumnStore& cells = m_gridColumns.at(column).cells;
+        int cellIdx = _cellIndex(row);
 
         // init editor state
         m_gridEditor.row = row;
         m_gridEditor.column = column;
         m_gridEditor.editing = true;
-        m_gridEditor.editorType = cellRef.type;
+        m_gridEditor.editorType = (TCellType)cells.type(cellIdx);
 
         int posX = 0;
         int posY = 0;
@@ -1408,7 +2228,7 @@ void XWGridWindow::_updateEditing(int row, int column)
         _getCellPos(row, column, posX, posY);
 
         // check edited cell type
-        if(cellRef.type == eCellTypeText)
+        if(cells.type(cellIdx) == eCellTypeText)
         {
             // create editor if needed
             _createTextEditor();
@@ -1417,19 +2237,19 @@ void XWGridWindow::_updateEditing(int row, int column)
             m_gridEditor.textEditor->update(posX + m_gridStyle.lineWidth, 
                                             posY + m_gridStyle.lineWidth, 
                                             m_gridColumns.at(column).width + 2 * m_gridStyle.spacing, 
-                                            m_gridData.at(row).height + 2 * m_gridStyle.spacing);
+                                            _rowHeight(row) + 2 * m_gridStyle.spacing);
 
             // set editor text
-            m_gridEditor.textEditor->setText(cellRef.text.c_str());
+            m_gridEditor.textEditor->setText(cells.text(cellIdx));
 
             // show editor
             m_gridEditor.textEditor->show();
             m_gridEditor.textEditor->setFocus();
 
             // move cursor at the end
-            m_gridEditor.textEditor->setCursorPos((int)cellRef.text.length());
+            m_gridEditor.textEditor->setCursorPos(cells.textLength(cellIdx));
 
-        } else if(cellRef.type == eCellTypeList)
+        } else if(cells.type(cellIdx) == eCellTypeList)
         {
             // create editor if needed
             _createListEditor();
@@ -1438,20 +2258,22 @@ void XWGridWindow::_updateEditing(int row, int column)
             m_gridEditor.listEditor->update(posX + m_gridStyle.lineWidth, 
                                             posY + m_gridStyle.lineWidth, 
                                             m_gridColumns.at(column).width + 2 * m_gridStyle.spacing, 
-                                            m_gridData.at(row).height + 2 * m_gridStyle.spacing);
+                                            _rowHeight(row) + 2 * m_gridStyle.spacing);
 
             // clear old values
             m_gridEditor.listEditor->resetContent();
 
+            const XWGridColumnStore::CellAttributes* attributes = cells.attributes(cellIdx);
+
             // set values
-            for(int idx = 0; idx < cellRef.listItemCount; ++idx)
+            for(int idx = 0; attributes && idx < attributes->listItemCount; ++idx)
             {
-                m_gridEditor.listEditor->addItem(cellRef.listItems[idx], idx);
+                m_gridEditor.listEditor->addItem(attributes->listItems[idx], idx);
             }
 
             // select current item
-            if(cellRef.listIndex != XWGRID_VALUE_NOT_SET)
-                m_gridEditor.listEditor->selectItem(cellRef.listIndex);
+            if(attributes && attributes->listIndex != XWGRID_VALUE_NOT_SET)
+                m_gridEditor.listEditor->selectItem(attributes->listIndex);
 
             // show editor
             m_gridEditor.listEditor->show();
@@ -1517,7 +2339,7 @@ void XWGridWindow::_updateEditor()
     editorWindow->update(posX + m_gridStyle.lineWidth, 
                          posY + m_gridStyle.lineWidth, 
                          m_gridColumns.at(m_gridEditor.column).width + 2 * m_gridStyle.spacing, 
-                         m_gridData.at(m_gridEditor.row).height + 2 * m_gridStyle.spacing);
+                         _rowHeight(m_gridEditor.row) + 2 * m_gridStyle.spacing);
 }
 
 bool XWGridWindow::_handleKeyPressed(WPARAM wParam, LPARAM lParam)
@@ -1535,10 +2357,16 @@ bool XWGridWindow::_handleKeyPressed(WPARAM wParam, LPARAM lParam)
         // find current selection if any
         _findSelection(row, column);
 
-        // if selection is not valid select first cell
-        if(!_isValidIndex(row, column)) 
+        // NOTE: selection is moved in view order
+        if(m_viewUpdateNeeded) _updateView();
+        int viewRow = _isValidIndex(row, column) ? _viewRow(row) : XWGRID_VALUE_NOT_SET;
+
+        // if selection is not valid or not shown select first cell
+        if(viewRow == XWGRID_VALUE_NOT_SET) 
         {
-             _updateSelection(0, 0);
+            if(_viewRowCount() > 0)
+                _updateSelection(_dataRow(0), 0);
+
             return true;
         }
 
@@ -1558,14 +2386,14 @@ bool XWGridWindow::_handleKeyPressed(WPARAM wParam, LPARAM lParam)
         } else if(wParam == VK_UP)
         {
             // move selection up if possible
-            if(row > 0)
-                _updateSelection(row - 1, column);
+            if(viewRow > 0)
+                _updateSelection(_dataRow(viewRow - 1), column);
 
         } else if(wParam == VK_DOWN)
         {
             // move selection down if possible
-            if(row + 1 < (int)m_gridData.size())
-                _updateSelection(row + 1, column);
+            if(viewRow + 1 < _viewRowCount())
+                _updateSelection(_dataRow(viewRow + 1), column);
 
         } else if(wParam == VK_LEFT)
         {
@@ -1588,16 +2416,21 @@ bool XWGridWindow::_handleKeyPressed(WPARAM wParam, LPARAM lParam)
         // check if selection exists
         if(_isValidIndex(row, column))
         {
-            GridCellData& cellRef = m_gridData.at(row).cells.at(column);
+            XWGridColumnStore& cells = m_gridColumns.at(column).cells;
+            int cellIdx = _cellIndex(row);
 
             // clear text value if cell is editable
-            if(cellRef.editable && cellRef.type == eCellTypeText)
+            if(cells.flag(cellIdx, XWGRID_CELL_EDITABLE) && cells.type(cellIdx) == eCellTypeText)
             {
                 // clear text value
-                cellRef.text.clear();
+                cells.setText(cellIdx, 0);
 
-                // update
-                repaint();
+                // pass new value to data source in virtual mode
+                if(isVirtual())
+                    m_pDataSource->setGridCellText(this, row, column, L"");
+
+                // measure and repaint cell
+                _invalidateCell(row, column, true);
             }
         }
 
@@ -1612,57 +2445,915 @@ bool XWGridWindow::_handleKeyPressed(WPARAM wParam, LPARAM lParam)
 }
 
 /////////////////////////////////////////////////////////////////////
-// paint methods
+// virtual mode worker methods
 /////////////////////////////////////////////////////////////////////
-void XWGridWindow::_paintCell(HDC hdc, int posX, int posY, int width, int height, const GridCellData& cell)
+int XWGridWindow::_virtualSlot(int row)
 {
-    // check type
-    if(cell.type == eCellTypeText || cell.type == eCellTypeList)
+    XWASSERT(m_pDataSource);
+
+    // check if row is cached already
+    _gridRowCacheT::iterator it = m_virtualRows.find(row);
+    if(it != m_virtualRows.end()) return it->second;
+
+    // NOTE: rows may be read outside of visible area (e.g. by cellText), keep cache limited
+    if((int)m_virtualRows.size() >= XWGRID_VIRTUAL_CACHE_LIMIT) _trimVirtualRows(m_virtualFirstRow, m_virtualLastRow);
+
+    int slot = 0;
+
+    // reuse released slot if any
+    if(!m_virtualFreeSlots.empty())
     {
-        // check if cell is modified
-        if(cell.modified)
-        {
-            // select modified font
-            ::SelectObject(hdc, m_modifiedFont);
-        }
+        slot = m_virtualFreeSlots.back();
+        m_virtualFreeSlots.pop_back();
+
+    } else
+    {
+        // add cell to each column
+        slot = m_gridColumns.empty() ? 0 : m_gridColumns.front().cells.count();
 
-        // check if cell is selected
-        if(cell.selected)
+        for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
         {
-            // selection color
-            ::SetBkColor(hdc, m_gridStyle.selectedColor);
+            cit->cells.appendCell();
         }
+    }
 
-        // paint rect
-        ::Rectangle(hdc, posX, posY, posX + width, posY + height);
+    // read cells from data source
+    for(int columnIdx = 0; columnIdx < m_columnCount; ++columnIdx)
+    {
+        XWGridColumnStore& cells = m_gridColumns.at(columnIdx).cells;
 
-        // clip rect
-        RECT clipRect;
-        clipRect.left = posX + m_gridStyle.lineWidth;
-        clipRect.top = posY + m_gridStyle.lineWidth;
-        clipRect.right = posX + width - m_gridStyle.lineWidth;
-        clipRect.bottom = posY + height - m_gridStyle.lineWidth;
+        // reset cell info
+        m_virtualCellInfo = GridCellInfo();
 
-        // text
-        ::ExtTextOutW(hdc, posX + m_gridStyle.lineWidth + m_gridStyle.spacing, 
-                           posY + m_gridStyle.lineWidth + m_gridStyle.spacing, 
-                           ETO_OPAQUE | ETO_CLIPPED, &clipRect, cell.text.c_str(), (UINT)cell.text.length(), 0);
+        // read cell
+        m_pDataSource->getGridCell(this, row, columnIdx, m_virtualCellInfo);
 
-        // check if cell is modified
-        if(cell.modified)
-        {
-            // select normal font back
-            ::SelectObject(hdc, m_textFont);
-        }
+        // copy cell data
+        cells.resetCell(slot);
+        cells.setType(slot, m_virtualCellInfo.type);
+        cells.setText(slot, m_virtualCellInfo.text.c_str());
+        cells.setFlag(slot, XWGRID_CELL_EDITABLE, m_virtualCellInfo.editable);
+        cells.setFlag(slot, XWGRID_CELL_MODIFIED, m_virtualCellInfo.modified);
+        cells.setFlag(slot, XWGRID_CELL_CLICKABLE, m_virtualCellInfo.clickable);
+        cells.setFlag(slot, XWGRID_CELL_SELECTABLE, m_virtualCellInfo.selectable);
 
-        // check if cell is selected
-        if(cell.selected)
+        // selection is kept by grid
+        cells.setFlag(slot, XWGRID_CELL_SELECTED, m_virtualSelection.count(std::make_pair(row, columnIdx)) != 0);
+
+        // keep attributes only if set
+        if(m_virtualCellInfo.bitmap || m_virtualCellInfo.listItems || 
+           m_virtualCellInfo.listIndex != XWGRID_VALUE_NOT_SET || m_virtualCellInfo.userData)
         {
-            // normal color
-            ::SetBkColor(hdc, m_gridStyle.fillColor);
+            XWGridColumnStore::CellAttributes& attributes = cells.editAttributes(slot);
+
+            attributes.bitmap = m_virtualCellInfo.bitmap;
+            attributes.listIndex = m_virtualCellInfo.listIndex;
+            attributes.listItems = m_virtualCellInfo.listItems;
+            attributes.listItemCount = m_virtualCellInfo.listItemCount;
+            attributes.userData = m_virtualCellInfo.userData;
         }
+    }
+
+    // add row
+    m_virtualRows[row] = slot;
+
+    // new row must be measured
+    m_layoutUpdateNeeded = true;
+
+    return slot;
+}
+
+void XWGridWindow::_releaseVirtualSlot(int slot)
+{
+    // release cell data
+    for(_gridColumnsT::iterator cit = m_gridColumns.begin(); cit != m_gridColumns.end(); ++cit)
+    {
+        cit->cells.resetCell(slot);
+    }
+
+    // slot may be used by other row
+    m_virtualFreeSlots.push_back(slot);
+}
+
+void XWGridWindow::_loadVirtualRows()
+{
+    int rowStep = _virtualRowStep();
+
+    // visible rows
+    m_virtualFirstRow = scrollOffsetY() / rowStep;
+    m_virtualLastRow = (scrollOffsetY() + height()) / rowStep;
+    if(m_virtualLastRow >= m_virtualRowCount) m_virtualLastRow = m_virtualRowCount - 1;
+
+    // remove rows that are not visible anymore (text returned before paint is not used anymore)
+    m_virtualTextRows.clear();
+    _trimVirtualRows(m_virtualFirstRow, m_virtualLastRow);
+
+    // read visible rows
+    for(int row = m_virtualFirstRow; row <= m_virtualLastRow; ++row)
+    {
+        _virtualSlot(row);
+    }
+}
+
+void XWGridWindow::_trimVirtualRows(int firstRow, int lastRow)
+{
+    _gridRowCacheT::iterator it = m_virtualRows.begin();
+
+    // remove rows outside of range
+    while(it != m_virtualRows.end())
+    {
+        // NOTE: keep edited row and rows with text returned by cellText
+        if((it->first < firstRow || it->first > lastRow) && 
+           !(m_gridEditor.editing && m_gridEditor.row == it->first) &&
+           m_virtualTextRows.count(it->first) == 0)
+        {
+            _releaseVirtualSlot(it->second);
+            it = m_virtualRows.erase(it);
+
+        } else
+        {
+            ++it;
+        }
+    }
+}
+
+void XWGridWindow::_shiftVirtualRows(int rowAt, int shift)
+{
+    // NOTE: edited row index is not valid anymore
+    _cancelEditing();
+
+    // row indexes has changed, read rows again
+    _clearCells();
+
+    // move selection
+    _gridSelectionT selection;
+    for(_gridSelectionT::const_iterator sit = m_virtualSelection.begin(); sit != m_virtualSelection.end(); ++sit)
+    {
+        // remove selection from removed row
+        if(shift < 0 && sit->first == rowAt) continue;
+
+        // move rows after changed one
+        if(sit->first >= rowAt)
+            selection.insert(std::make_pair(sit->first + shift, sit->second));
+        else
+            selection.insert(*sit);
+    }
+
+    m_virtualSelection.swap(selection);
+}
+
+int XWGridWindow::_virtualRowStep() const
+{
+    // row height with spacing and border
+    int rowStep = m_virtualRowHeight + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing;
+
+    // NOTE: row step is used as divider
+    return (rowStep > 0) ? rowStep : 1;
+}
+
+/////////////////////////////////////////////////////////////////////
+// view worker methods
+/////////////////////////////////////////////////////////////////////
+bool XWGridWindow::_isViewActive() const
+{
+    // NOTE: rows are shown in data order if they are not sorted or filtered
+    return !isVirtual() && (m_sortColumn != XWGRID_VALUE_NOT_SET || m_pRowFilter != 0);
+}
+
+int XWGridWindow::_viewRowCount()
+{
+    // row count is kept separately in virtual mode
+    if(isVirtual()) return m_virtualRowCount;
+
+    // shown rows
+    if(_isViewActive()) return (int)m_viewRows.size();
+
+    return (int)m_gridRows.size();
+}
+
+int XWGridWindow::_viewRow(int row)
+{
+    // same order if view is not used
+    if(!_isViewActive()) return row;
+
+    // NOTE: rows filtered out don't have view row
+    if(row < 0 || row >= (int)m_dataViewRows.size()) return XWGRID_VALUE_NOT_SET;
+
+    return m_dataViewRows[row];
+}
+
+int XWGridWindow::_dataRow(int viewRow)
+{
+    // same order if view is not used
+    if(!_isViewActive()) return viewRow;
+
+    // validate
+    if(viewRow < 0 || viewRow >= (int)m_viewRows.size()) return XWGRID_VALUE_NOT_SET;
+
+    return m_viewRows[viewRow];
+}
+
+void XWGridWindow::_invalidateView(bool rebuild)
+{
+    // build view from all rows if needed
+    if(rebuild) m_viewRebuildNeeded = true;
+
+    // update view with layout
+    m_viewUpdateNeeded = true;
+    m_layoutUpdateNeeded = true;
+}
+
+void XWGridWindow::_invalidateViewRow(int row)
+{
+    // ignore if view is built again anyway
+    if(!m_viewRebuildNeeded)
+    {
+        // NOTE: moving many rows one by one is slower than sorting all rows
+        if(m_viewChangedRows.size() < XWGRID_VIEW_INCREMENTAL_LIMIT)
+            m_viewChangedRows.push_back(row);
+        else
+            m_viewRebuildNeeded = true;
+    }
+
+    // update view with layout
+    _invalidateView(false);
+}
+
+bool XWGridWindow::_viewUsesColumn(int column)
+{
+    // ignore if rows are shown in data order
+    if(!_isViewActive()) return false;
+
+    // NOTE: rows are compared only by sort column (also by custom comparator)
+    if(column == m_sortColumn) return true;
+
+    return (m_pRowFilter != 0 && m_pRowFilter->usesGridColumn(this, column));
+}
+
+void XWGridWindow::_insertViewRow(int rowAt)
+{
+    // move data rows below inserted one
+    for(size_t idx = 0; idx < m_viewRows.size() && !m_viewRebuildNeeded; ++idx)
+    {
+        if(m_viewRows[idx] >= rowAt) m_viewRows[idx]++;
+    }
+
+    for(size_t idx = 0; idx < m_viewChangedRows.size(); ++idx)
+    {
+        if(m_viewChangedRows[idx] >= rowAt) m_viewChangedRows[idx]++;
+    }
+
+    // find view position of new row
+    _invalidateViewRow(rowAt);
+}
+
+void XWGridWindow::_removeViewRow(int rowAt)
+{
+    // remove data row from view and move rows below it
+    size_t viewIdx = 0;
+    for(size_t idx = 0; idx < m_viewRows.size() && !m_viewRebuildNeeded; ++idx)
+    {
+        if(m_viewRows[idx] == rowAt) continue;
+
+        m_viewRows[viewIdx++] = (m_viewRows[idx] > rowAt) ? m_viewRows[idx] - 1 : m_viewRows[idx];
+    }
+
+    if(!m_viewRebuildNeeded) m_viewRows.resize(viewIdx);
+
+    // same for changed rows
+    viewIdx = 0;
+    for(size_t idx = 0; idx < m_viewChangedRows.size(); ++idx)
+    {
+        if(m_viewChangedRows[idx] == rowAt) continue;
+
+        m_viewChangedRows[viewIdx++] = (m_viewChangedRows[idx] > rowAt) ? m_viewChangedRows[idx] - 1 : m_viewChangedRows[idx];
+    }
+
+    m_viewChangedRows.resize(viewIdx);
+
+    // NOTE: view rows below removed one are moved
+    _invalidateView(false);
+}
+
+void XWGridWindow::_updateView()
+{
+    // reset flag
+    m_viewUpdateNeeded = false;
+    m_layoutUpdateNeeded = true;
+
+    // show rows in data order if view is not used
+    if(!_isViewActive())
+    {
+        m_viewRows.clear();
+        m_dataViewRows.clear();
+        m_viewChangedRows.clear();
+        m_viewRebuildNeeded = false;
+        m_viewNarrowNeeded = false;
+
+        // NOTE: row offsets are kept in view order
+        m_rowOffsetsRebuildNeeded = true;
+
+        return;
+    }
+
+    // NOTE: if only changed rows are moved, row offsets and reverse mapping are patched
+    //       over moved range, this is possible only if they match view before update
+    bool patchView = !m_viewRebuildNeeded && !m_viewNarrowNeeded && !m_rowOffsetsRebuildNeeded &&
+                     m_rowOffsets.count() == (int)m_viewRows.size() && m_dataViewRows.size() <= m_gridRows.size();
+
+    // view rows moved by update (none by default)
+    int firstMoved = 0;
+    int lastMoved = -1;
+
+    // build view from all rows if needed
+    if(m_viewRebuildNeeded)
+    {
+        _buildView();
+
+    } else
+    {
+        // remove rows which don't pass narrowed filter (other rows keep their order)
+        if(m_viewNarrowNeeded)
+        {
+            size_t viewIdx = 0;
+            for(size_t idx = 0; idx < m_viewRows.size(); ++idx)
+            {
+                if(_acceptRow(m_viewRows[idx])) m_viewRows[viewIdx++] = m_viewRows[idx];
+            }
+
+            m_viewRows.resize(viewIdx);
+            m_viewNarrowNeeded = false;
+        }
+
+        // move changed rows
+        if(!m_viewChangedRows.empty())
+            _moveViewRows(patchView, firstMoved, lastMoved);
+    }
+
+    // update offsets and reverse mapping
+    if(patchView)
+    {
+        _patchViewRows(firstMoved, lastMoved);
+
+    } else
+    {
+        // NOTE: row offsets are kept in view order
+        m_rowOffsetsRebuildNeeded = true;
+
+        _updateDataViewRows();
+    }
+
+    m_viewChangedRows.clear();
+
+    // stop editing if edited row is not shown anymore
+    if(m_gridEditor.editing && _viewRow(m_gridEditor.row) == XWGRID_VALUE_NOT_SET)
+        _cancelEditing();
+}
+
+void XWGridWindow::_moveViewRows(bool dataViewRowsValid, int& firstMoved, int& lastMoved)
+{
+    // keep each row once
+    std::sort(m_viewChangedRows.begin(), m_viewChangedRows.end());
+    m_viewChangedRows.erase(std::unique(m_viewChangedRows.begin(), m_viewChangedRows.end()), m_viewChangedRows.end());
+
+    int oldCount = (int)m_viewRows.size();
+
+    // NOTE: rows above first changed row are not moved, its position is known from
+    //       reverse mapping if it is valid, otherwise whole view is checked
+    firstMoved = dataViewRowsValid ? oldCount : 0;
+    lastMoved = -1;
+
+    for(size_t idx = 0; idx < m_viewChangedRows.size() && dataViewRowsValid; ++idx)
+    {
+        int row = m_viewChangedRows[idx];
+
+        // ignore rows which have not been shown
+        if(row < 0 || row >= (int)m_dataViewRows.size() || m_dataViewRows[row] == XWGRID_VALUE_NOT_SET) continue;
+
+        if(m_dataViewRows[row] < firstMoved) firstMoved = m_dataViewRows[row];
+        if(m_dataViewRows[row] > lastMoved) lastMoved = m_dataViewRows[row];
+    }
+
+    // remove changed rows from view
+    size_t viewIdx = firstMoved;
+    for(size_t idx = firstMoved; idx < m_viewRows.size(); ++idx)
+    {
+        if(!std::binary_search(m_viewChangedRows.begin(), m_viewChangedRows.end(), m_viewRows[idx])) 
+            m_viewRows[viewIdx++] = m_viewRows[idx];
+    }
+
+    m_viewRows.resize(viewIdx);
+
+    _ViewComparator comparator;
+    _initViewComparator(comparator);
+
+    int insertedCount = 0;
+    int lastInserted = -1;
+
+    // insert changed rows at their position
+    for(size_t idx = 0; idx < m_viewChangedRows.size(); ++idx)
+    {
+        int row = m_viewChangedRows[idx];
+
+        // ignore rows which don't exist anymore or filtered out
+        if(row < 0 || row >= (int)m_gridRows.size() || !_acceptRow(row)) continue;
+
+        // find position (data order if not sorted)
+        std::vector<int>::iterator it = (m_sortColumn != XWGRID_VALUE_NOT_SET) ? 
+            std::lower_bound(m_viewRows.begin(), m_viewRows.end(), row, comparator) :
+            std::lower_bound(m_viewRows.begin(), m_viewRows.end(), row);
+
+        int position = (int)(it - m_viewRows.begin());
+        if(position < firstMoved) firstMoved = position;
+        if(position > lastInserted) lastInserted = position;
+
+        m_viewRows.insert(it, row);
+        insertedCount++;
+    }
+
+    // NOTE: inserted row is moved down only by rows inserted after it
+    if(insertedCount > 0 && lastInserted + insertedCount - 1 > lastMoved)
+        lastMoved = lastInserted + insertedCount - 1;
+
+    // all rows below are moved if row count has changed
+    if((int)m_viewRows.size() != oldCount)
+        lastMoved = ((int)m_viewRows.size() > oldCount) ? (int)m_viewRows.size() - 1 : oldCount - 1;
+}
+
+void XWGridWindow::_patchViewRows(int firstMoved, int lastMoved)
+{
+    int viewCount = (int)m_viewRows.size();
+
+    // rows appended since last update have no view row yet
+    m_dataViewRows.resize(m_gridRows.size(), XWGRID_VALUE_NOT_SET);
+
+    // ignore if nothing has been moved
+    if(lastMoved < firstMoved) return;
+
+    // NOTE: each patched offset costs O(log n), rebuild in linear time if most rows are moved
+    if(lastMoved - firstMoved + 1 > viewCount / 2)
+    {
+        m_rowOffsetsRebuildNeeded = true;
+
+        _updateDataViewRows();
+        return;
+    }
+
+    // offsets match new row count (values in moved range are set below)
+    while(m_rowOffsets.count() < viewCount) m_rowOffsets.appendValue(0);
+    while(m_rowOffsets.count() > viewCount) m_rowOffsets.removeLastValue();
+
+    // changed rows filtered out don't have view row
+    for(size_t idx = 0; idx < m_viewChangedRows.size(); ++idx)
+    {
+        int row = m_viewChangedRows[idx];
+        if(row >= 0 && row < (int)m_dataViewRows.size()) m_dataViewRows[row] = XWGRID_VALUE_NOT_SET;
+    }
+
+    // patch moved range
+    if(lastMoved >= viewCount) lastMoved = viewCount - 1;
+
+    for(int viewIdx = firstMoved; viewIdx <= lastMoved; ++viewIdx)
+    {
+        int row = m_viewRows[viewIdx];
+
+        m_dataViewRows[row] = viewIdx;
+        m_rowOffsets.setValue(viewIdx, m_gridRows.at(row).height + m_gridStyle.lineWidth + 2 * m_gridStyle.spacing);
+    }
+
+    // NOTE: painted rows have been moved
+    m_repaintAllNeeded = true;
+}
+
+void XWGridWindow::_buildView()
+{
+    // add rows which pass filter
+    m_viewRows.clear();
+    m_viewRows.reserve(m_gridRows.size());
+
+    for(int row = 0; row < (int)m_gridRows.size(); ++row)
+    {
+        if(_acceptRow(row)) m_viewRows.push_back(row);
+    }
+
+    // sort rows if needed
+    if(m_sortColumn != XWGRID_VALUE_NOT_SET)
+        _sortView();
+
+    // reset state
+    m_viewChangedRows.clear();
+    m_viewRebuildNeeded = false;
+    m_viewNarrowNeeded = false;
+}
+
+void XWGridWindow::_sortView()
+{
+    size_t rowCount = m_viewRows.size();
+
+    // number of threads
+    size_t threadCount = std::thread::hardware_concurrency();
+    if(threadCount > XWGRID_PARALLEL_SORT_MAX_THREADS) threadCount = XWGRID_PARALLEL_SORT_MAX_THREADS;
+
+    // NOTE: comparator set by user may access grid, it is called on this thread only
+    if(m_pSortComparator || rowCount < XWGRID_PARALLEL_SORT_MIN_ROWS || threadCount < 2)
+    {
+        _ViewComparator comparator;
+        _initViewComparator(comparator);
+
+        // NOTE: comparator keeps data order of equal rows, so sort result is stable
+        std::sort(m_viewRows.begin(), m_viewRows.end(), comparator);
+        return;
+    }
+
+    // read cell texts on this thread, worker threads sort keys only
+    const XWGridColumnStore& cells = m_gridColumns.at(m_sortColumn).cells;
+
+    std::vector<_SortKey> keys(rowCount);
+    for(size_t idx = 0; idx < rowCount; ++idx)
+    {
+        keys[idx].text = cells.text(m_viewRows[idx]);
+        keys[idx].row = m_viewRows[idx];
+    }
+
+    _SortKeyComparator comparator;
+    comparator.ascending = m_sortAscending;
+
+    // NOTE: keys are split to ranges which are sorted in parallel and merged afterwards
+    std::vector<size_t> bounds(threadCount + 1);
+    for(size_t idx = 0; idx <= threadCount; ++idx)
+    {
+        bounds[idx] = rowCount * idx / threadCount;
+    }
+
+    // sort ranges in worker threads (first range is sorted on this thread)
+    std::vector<std::thread> threads(threadCount);
+    for(size_t idx = 1; idx < threadCount; ++idx)
+    {
+        try
+        {
+            threads[idx] = std::thread(&XWGridWindow::_sortKeyRange, &keys, bounds[idx], bounds[idx + 1], &comparator);
+        }
+        catch(const std::system_error&)
+        {
+            // sort range on this thread
+            _sortKeyRange(&keys, bounds[idx], bounds[idx + 1], &comparator);
+        }
+    }
+
+    _sortKeyRange(&keys, bounds[0], bounds[1], &comparator);
+
+    // wait for worker threads
+    for(size_t idx = 1; idx < threadCount; ++idx)
+    {
+        if(threads[idx].joinable()) threads[idx].join();
+    }
+
+    // merge sorted ranges pairwise
+    for(size_t step = 1; step < threadCount; step *= 2)
+    {
+        for(size_t idx = 0; idx + step < threadCount; idx += 2 * step)
+        {
+            size_t lastIdx = (idx + 2 * step < threadCount) ? idx + 2 * step : threadCount;
+
+            std::inplace_merge(keys.begin() + bounds[idx], 
+                               keys.begin() + bounds[idx + step], 
+                               keys.begin() + bounds[lastIdx], comparator);
+        }
+    }
+
+    // copy sorted rows to view
+    for(size_t idx = 0; idx < rowCount; ++idx)
+    {
+        m_viewRows[idx] = keys[idx].row;
+    }
+}
+
+void XWGridWindow::_sortKeyRange(std::vector<_SortKey>* keys, size_t first, size_t last, const _SortKeyComparator* comparator)
+{
+    // NOTE: comparator keeps data order of equal rows, so sort result is stable
+    std::sort(keys->begin() + first, keys->begin() + last, *comparator);
+}
+
+void XWGridWindow::_updateDataViewRows()
+{
+    // NOTE: rows filtered out don't have view row
+    m_dataViewRows.assign(m_gridRows.size(), XWGRID_VALUE_NOT_SET);
+
+    for(size_t viewIdx = 0; viewIdx < m_viewRows.size(); ++viewIdx)
+    {
+        m_dataViewRows[m_viewRows[viewIdx]] = (int)viewIdx;
+    }
+}
+
+bool XWGridWindow::_acceptRow(int row)
+{
+    // all rows are shown if filter is not set
+    if(m_pRowFilter == 0) return true;
+
+    return m_pRowFilter->acceptGridRow(this, row);
+}
+
+void XWGridWindow::_initViewComparator(_ViewComparator& comparator)
+{
+    comparator.grid = this;
+    comparator.cells = (m_sortColumn != XWGRID_VALUE_NOT_SET) ? &(m_gridColumns.at(m_sortColumn).cells) : 0;
+    comparator.comparator = m_pSortComparator;
+    comparator.column = m_sortColumn;
+    comparator.ascending = m_sortAscending;
+}
+
+void XWGridWindow::_requestRepaint()
+{
+    // NOTE: grid is repainted once bulk update is completed
+    if(m_updateLevel > 0)
+    {
+        m_repaintAllNeeded = true;
+        return;
+    }
+
+    repaint();
+}
+
+bool XWGridWindow::_ViewComparator::operator()(int rowA, int rowB) const
+{
+    int result = 0;
+
+    // compare cells (text is compared by default)
+    if(comparator)
+        result = comparator->compareGridRows(grid, column, rowA, rowB);
+    else if(cells)
+        result = wcscmp(cells->text(rowA), cells->text(rowB));
+
+    // reverse order if needed
+    if(!ascending) result = -result;
+
+    // keep data order of equal rows
+    if(result == 0) return rowA < rowB;
+
+    return result < 0;
+}
+
+bool XWGridWindow::_SortKeyComparator::operator()(const _SortKey& keyA, const _SortKey& keyB) const
+{
+    // NOTE: the same order as _ViewComparator without comparator set
+    int result = wcscmp(keyA.text, keyB.text);
+
+    // reverse order if needed
+    if(!ascending) result = -result;
+
+    // keep data order of equal rows
+    if(result == 0) return keyA.row < keyB.row;
+
+    return result < 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// paint methods
+/////////////////////////////////////////////////////////////////////
+void XWGridWindow::_initGDICache(HDC hdc)
+{
+    // ignore if there is cache already
+    if(m_pGDIResourcesCache != 0) return;
+
+    // create resource cache 
+    m_pGDIResourcesCache = new XGdiResourcesCache;
+    m_pGDIResourcesCache->AddRef();
+
+    // init cache
+    m_pGDIResourcesCache->init(hdc);
+}
+
+void XWGridWindow::_paintRect(HDC hdc, const RECT& paintRect)
+{
+    // select font
+    HGDIOBJ oldFont = ::SelectObject(hdc, m_textFont);
+    m_paintFont = m_textFont;
+
+    // text color
+    if(isEnabled())
+        ::SetTextColor(hdc, m_gridStyle.textColor);
+    else
+        ::SetTextColor(hdc, m_gridStyle.disabledColor);        
+
+    // fill color
+    ::SetBkColor(hdc, m_gridStyle.fillColor);
+    ::SetBkMode(hdc, OPAQUE);
+    m_paintBkColor = m_gridStyle.fillColor;
+
+    // select cached pen and brush
+    HBRUSH hFillBrush = m_pGDIResourcesCache->getBrush(m_gridStyle.fillColor);
+    HGDIOBJ oldPen = ::SelectObject(hdc, m_pGDIResourcesCache->getPen(m_gridStyle.lineWidth, m_gridStyle.borderColor));
+    HGDIOBJ oldBrush = ::SelectObject(hdc, hFillBrush);
+
+    // first column in paint rect
+    size_t firstColumn = (size_t)_columnAtOffset(scrollOffsetX() + paintRect.left);
+
+    // loop over rows in paint rect (in view order)
+    int posY = 0;
+    for(int viewRow = _findFirstVisibleRow(paintRect.top, posY); viewRow < _viewRowCount(); ++viewRow)
+    {
+        // stop after last row in paint rect
+        if(posY - scrollOffsetY() >= paintRect.bottom) break;
+
+        int row = _dataRow(viewRow);
+        int cellIdx = _cellIndex(row);
+        int rowHeight = _rowHeight(row) + 2 * m_gridStyle.spacing;
+
+        // loop over columns in paint rect
+        for(size_t columnIdx = firstColumn; columnIdx < m_gridColumns.size(); ++columnIdx)
+        {
+            // column position
+            int posX = m_columnOffsets.at(columnIdx);
+
+            // stop after last column in paint rect
+            if(posX - scrollOffsetX() >= paintRect.right) break;
+
+            // column width
+            int columnWidth = m_gridColumns.at(columnIdx).width + 2 * m_gridStyle.spacing;
+
+            // paint cell
+            _paintCell(hdc, posX - scrollOffsetX(), 
+                            posY - scrollOffsetY(), 
+                            columnWidth + 2 * m_gridStyle.lineWidth, 
+                            rowHeight + 2 * m_gridStyle.lineWidth, 
+                            m_gridColumns.at(columnIdx).cells, cellIdx);
+        }
+
+        // move position
+        posY += rowHeight + m_gridStyle.lineWidth;
+    }
+
+    // NOTE: painting stops at last row and column, use content size to find where cells end
+    int contentRight = m_contentWidth - scrollOffsetX();
+    int contentBottom = m_contentHeight - scrollOffsetY();
+
+    // fill the rest on the right if needed
+    if(contentRight < paintRect.right)
+    {
+        RECT fillRect = paintRect;
+        if(fillRect.left < contentRight) fillRect.left = contentRight;
+
+        ::FillRect(hdc, &fillRect, hFillBrush);
+    }
+
+    // fill the rest below if needed
+    if(contentBottom < paintRect.bottom)
+    {
+        RECT fillRect = paintRect;
+        if(fillRect.top < contentBottom) fillRect.top = contentBottom;
+
+        ::FillRect(hdc, &fillRect, hFillBrush);
+    }
+
+    // restore objects (cached objects are not kept selected)
+    ::SelectObject(hdc, oldBrush);
+    ::SelectObject(hdc, oldPen);
+    ::SelectObject(hdc, oldFont);
+}
+
+void XWGridWindow::_repaintCell(int row, int column)
+{
+    // ignore if window is not created
+    if(hwnd() == 0) return;
+
+    // NOTE: grid is repainted once bulk update is completed
+    if(m_updateLevel > 0)
+    {
+        m_repaintAllNeeded = true;
+        return;
+    }
+
+    // NOTE: cell position is not known if rows are going to be moved, paint whole window
+    if(m_viewUpdateNeeded || m_rowOffsetsRebuildNeeded || (!isVirtual() && m_rowOffsets.count() < _viewRowCount()))
+    {
+        ::InvalidateRect(hwnd(), 0, FALSE);
+        return;
+    }
+
+    // ignore rows which are not shown
+    if(_viewRow(row) == XWGRID_VALUE_NOT_SET || column < 0 || column >= (int)m_gridColumns.size()) return;
+
+    int posX = 0;
+    int posY = 0;
+
+    // find position
+    _getCellPos(row, column, posX, posY);
+
+    // cell rect (with borders)
+    RECT cellRect;
+    cellRect.left = posX;
+    cellRect.top = posY;
+    cellRect.right = posX + m_gridColumns.at(column).width + 2 * m_gridStyle.spacing + 2 * m_gridStyle.lineWidth;
+    cellRect.bottom = posY + _rowHeight(row) + 2 * m_gridStyle.spacing + 2 * m_gridStyle.lineWidth;
+
+    // ignore cells outside of window
+    if(cellRect.right <= 0 || cellRect.bottom <= 0 || cellRect.left >= width() || cellRect.top >= height()) return;
+
+    // request WM_PAINT for cell only
+    ::InvalidateRect(hwnd(), &cellRect, FALSE);
+}
+
+void XWGridWindow::_repaintRow(int row)
+{
+    // ignore if window is not created or there are no columns
+    if(hwnd() == 0 || m_gridColumns.empty()) return;
+
+    // NOTE: grid is repainted once bulk update is completed
+    if(m_updateLevel > 0)
+    {
+        m_repaintAllNeeded = true;
+        return;
+    }
+
+    // NOTE: row position is not known if rows are going to be moved, paint whole window
+    if(m_viewUpdateNeeded || m_rowOffsetsRebuildNeeded || (!isVirtual() && m_rowOffsets.count() < _viewRowCount()))
+    {
+        ::InvalidateRect(hwnd(), 0, FALSE);
+        return;
+    }
+
+    // ignore rows which are not shown
+    if(_viewRow(row) == XWGRID_VALUE_NOT_SET) return;
+
+    int posX = 0;
+    int posY = 0;
+
+    // find position
+    _getCellPos(row, 0, posX, posY);
+
+    // row rect (with borders) over whole window width
+    RECT rowRect;
+    rowRect.left = 0;
+    rowRect.top = posY;
+    rowRect.right = width();
+    rowRect.bottom = posY + _rowHeight(row) + 2 * m_gridStyle.spacing + 2 * m_gridStyle.lineWidth;
+
+    // ignore rows outside of window
+    if(rowRect.bottom <= 0 || rowRect.top >= height()) return;
+
+    // request WM_PAINT for row only
+    ::InvalidateRect(hwnd(), &rowRect, FALSE);
+}
+
+void XWGridWindow::_scrollContent(int dX, int dY)
+{
+    // ignore if not moved
+    if(dX == 0 && dY == 0) return;
+
+    // NOTE: painted content is moved if it is still valid, otherwise whole window is painted
+    if(hwnd() == 0 || m_layoutUpdateNeeded || m_updateLevel > 0 || m_gridEditor.editing || 
+       abs(dX) >= width() || abs(dY) >= height())
+    {
+        repaint();
+        return;
+    }
+
+    // move content and request WM_PAINT for uncovered part
+    ::ScrollWindowEx(hwnd(), dX, dY, 0, 0, 0, 0, SW_INVALIDATE);
+}
+
+void XWGridWindow::_paintCell(HDC hdc, int posX, int posY, int width, int height, const XWGridColumnStore& cells, int cellIdx)
+{
+    bool modified = cells.flag(cellIdx, XWGRID_CELL_MODIFIED);
+    bool selected = cells.flag(cellIdx, XWGRID_CELL_SELECTED);
+
+    // check type
+    if(cells.type(cellIdx) == eCellTypeText || cells.type(cellIdx) == eCellTypeList)
+    {
+        // NOTE: font and color are changed only if they differ from previous cell
+
+        // modified cells use different font
+        HFONT cellFont = modified ? m_modifiedFont : m_textFont;
+        if(cellFont != m_paintFont)
+        {
+            ::SelectObject(hdc, cellFont);
+            m_paintFont = cellFont;
+        }
+
+        // selected cells use selection color
+        COLORREF cellBkColor = selected ? m_gridStyle.selectedColor : m_gridStyle.fillColor;
+        if(cellBkColor != m_paintBkColor)
+        {
+            ::SetBkColor(hdc, cellBkColor);
+            m_paintBkColor = cellBkColor;
+        }
+
+        // paint rect
+        ::Rectangle(hdc, posX, posY, posX + width, posY + height);
+
+        // clip rect
+        RECT clipRect;
+        clipRect.left = posX + m_gridStyle.lineWidth;
+        clipRect.top = posY + m_gridStyle.lineWidth;
+        clipRect.right = posX + width - m_gridStyle.lineWidth;
+        clipRect.bottom = posY + height - m_gridStyle.lineWidth;
+
+        // text
+        ::ExtTextOutW(hdc, posX + m_gridStyle.lineWidth + m_gridStyle.spacing, 
+                           posY + m_gridStyle.lineWidth + m_gridStyle.spacing, 
+                           ETO_OPAQUE | ETO_CLIPPED, &clipRect, cells.text(cellIdx), (UINT)cells.textLength(cellIdx), 0);
 
-    } else if(cell.type == eCellTypeBitmap)
+    } else if(cells.type(cellIdx) == eCellTypeBitmap)
     {
         // TODO:
     }
@@ -9,6 +9,10 @@
 // forward declarations
 class XLineEdit;
 class XComboBox;
+class IXWGridDataSource;
+class IXWGridSortComparator;
+class IXWGridRowFilter;
+class XGdiResourcesCache;
 
 /////////////////////////////////////////////////////////////////////
 // grid notification messages
@@ -23,6 +27,34 @@ class XComboBox;
 #define XWGRID_DEFAULT_MIN_SIZE                 10
 #define XWGRID_DEFAULT_MAX_SIZE                 1024
 
+// NOTE: in virtual mode cell data is not stored in grid, it is read from data source
+//       only for rows being painted, measured or edited, and only visible rows are
+//       cached. Row count and selection are kept by grid. All rows have the same
+//       height (fixed row height or text height), so row positions are computed.
+//       Text returned by cellText for rows outside of visible area stays valid until
+//       grid is painted, data is reloaded or rows are inserted or removed.
+
+// NOTE: cell data is kept per column (see XWGridColumnStore), in virtual mode column
+//       keeps cached rows in slots which are reused once rows are not visible.
+
+// NOTE: cell size is measured once and kept in cell, changing cell marks it and its
+//       row dirty so that layout update measures only changed cells. Column keeps
+//       count of measured widths, so its content width is known without reading all
+//       cells when widest cell is changed or removed.
+
+// NOTE: row offsets are kept in prefix sum tree and column offsets in array, so first
+//       visible row, cell position and cell at mouse position are found in O(log n).
+
+// NOTE: grid is painted through double buffer, only invalidated part of window is
+//       painted. Changed cell invalidates only its own rect unless layout is changed,
+//       scrolling moves painted content and paints only uncovered part.
+
+// NOTE: sorting and filtering don't move cell data, grid keeps view order of data rows
+//       and rows are shown in that order. Row indexes in grid interface and events are
+//       always data row indexes. View is updated with layout, changed rows are moved
+//       to their new position without sorting all rows again. Sorting and filtering
+//       are not supported in virtual mode (data source should provide rows in order).
+
 /////////////////////////////////////////////////////////////////////
 // XWGridWindow - grid window
 
@@ -36,6 +68,13 @@ public: // interface
     void    init(int columnCount);
     void    reset();
 
+public: // virtual mode (NOTE: grid does not take data source ownership)
+    void    setDataSource(IXWGridDataSource* pDataSource);
+    IXWGridDataSource*  dataSource() const { return m_pDataSource; }
+    bool    isVirtual() const { return m_pDataSource != 0; }
+    void    reloadData();
+    void    reloadRow(int row);
+
 public: // manage rows
     void    appendRow();
     void    insertRow(int rowAt);
@@ -45,6 +84,24 @@ public: // properties
     int     columnCount();
     int     rowCount();
 
+public: // sorting and filtering (NOTE: grid does not take comparator or filter ownership)
+    void    sortByColumn(int column, bool ascending = true, IXWGridSortComparator* pComparator = 0);
+    void    resetSorting();
+    int     sortColumn() const          { return m_sortColumn; }
+    bool    isSortAscending() const     { return m_sortAscending; }
+    void    setRowFilter(IXWGridRowFilter* pFilter);
+    void    updateRowFilter(bool narrowed = false);
+    IXWGridRowFilter*   rowFilter() const { return m_pRowFilter; }
+
+public: // view rows (shown rows in view order)
+    int     viewRowCount();
+    int     viewRow(int row);
+    int     viewDataRow(int viewRow);
+
+public: // bulk update (layout and repaint are deferred until last update ends)
+    void    beginUpdate();
+    void    endUpdate();
+
 public: // editing
     void    cancelEditing();
     void    completeEditing();
@@ -80,6 +137,26 @@ public: // cell type
 
     TCellType   cellType(int row, int column);
 
+public: // cell data (filled by data source in virtual mode)
+    struct GridCellInfo
+    {
+        TCellType       type;
+        std::wstring    text;
+        bool            editable;
+        bool            modified;
+        bool            clickable;
+        bool            selectable;
+        HBITMAP         bitmap;
+        int             listIndex;
+        const wchar_t** listItems;
+        int             listItemCount;
+        LRESULT         userData;
+
+        // default values
+        GridCellInfo() : type(eCellTypeText), editable(false), modified(false), clickable(false), selectable(false),
+                         bitmap(0), listIndex(-1), listItems(0), listItemCount(0), userData(0) {}
+    };
+
 public: // style
     struct GridStyle
     {
@@ -115,6 +192,10 @@ public: // events
 public: // event context cell
     bool    getContextCell(int& row, int& column);
 
+public: // live resize (from XWHWND, shows scaled snapshot if cell is not edited)
+    void    beginLiveResize();
+    void    endLiveResize();
+
 public: // scrolling (from IXWScrollable)
     bool    canScrollContent();
     int     contentWidth();
@@ -124,6 +205,7 @@ public: // scrolling (from IXWScrollable)
 
 protected: // events (from XWindow)
     void    onPaint(HDC hdc, PAINTSTRUCT& ps);
+    bool    onPrintClient(HDC hdc, const RECT& rcClient);
     void    onResize(int type, int width, int height);
     void    onContentChanged();
 
@@ -138,41 +220,13 @@ private: // process messages (from XWindow)
     LRESULT processMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
 private: // internal types
-    struct GridCellData
-    {
-        TCellType       type;
-        bool            editable;
-        bool            modified;
-        bool            clickable;
-        bool            selectable;
-        bool            hovered;
-        bool            clicked;
-        bool            selected;
-        std::wstring    text;
-        std::wstring    hint;
-        HBITMAP         bitmap;
-        HBITMAP         bitmapHovered;
-        HBITMAP         bitmapCliked;
-        int             listIndex;
-        const wchar_t** listItems;
-        int             listItemCount;
-        LRESULT         userData; 
-
-
-        // default values
-        GridCellData() : type(eCellTypeText), editable(false), modified(false), clickable(false), selectable(false),
-                         hovered(false), clicked(false), selected(false), bitmap(0), bitmapHovered(0), bitmapCliked(0),
-                         listIndex(-1), listItems(0), listItemCount(0), userData(0) {}
-    };
-
     struct GridRow
     {
-        int                             height;
-        std::vector<GridCellData>       cells;
+        int             height;
+        bool            layoutDirty;
 
         // default values
-        GridRow() : height(0) {}
-        GridRow(int columnCount) : height(0), cells(columnCount) { }
+        GridRow() : height(0), layoutDirty(false) {}
     };
 
     struct GridColumn
@@ -185,6 +239,12 @@ private: // internal types
         bool            fixedWidth;
         bool            fitContent;
 
+        // measured cell widths (width -> cell count), not used in virtual mode
+        std::map<int, int>  contentWidths;
+
+        // column cells (cached rows in virtual mode)
+        XWGridColumnStore   cells;
+
         // default values
         GridColumn() : width(0), stretch(0), minWidth(XWGRID_DEFAULT_MIN_SIZE), maxWidth(XWGRID_DEFAULT_MAX_SIZE),
                        maxContentWidth(XWGRID_VALUE_NOT_SET), fixedWidth(false), fitContent(false) {}
@@ -208,6 +268,34 @@ private: // internal types
 
     typedef std::vector<GridRow>        _gridRowsT;
     typedef std::vector<GridColumn>     _gridColumnsT;
+    typedef std::map<int, int>          _gridRowCacheT;
+    typedef std::set<std::pair<int, int> >  _gridSelectionT;
+
+    // view order of data rows
+    struct _ViewComparator
+    {
+        XWGridWindow*               grid;
+        const XWGridColumnStore*    cells;
+        IXWGridSortComparator*      comparator;
+        int                         column;
+        bool                        ascending;
+
+        bool operator()(int rowA, int rowB) const;
+    };
+
+    // sort key (cell text read before sorting, so it can be sorted by worker threads)
+    struct _SortKey
+    {
+        const wchar_t*  text;
+        int             row;
+    };
+
+    struct _SortKeyComparator
+    {
+        bool    ascending;
+
+        bool operator()(const _SortKey& keyA, const _SortKey& keyB) const;
+    };
 
 private: // worker methods
     bool        _validateColumn(int column);
@@ -218,11 +306,31 @@ private: // worker methods
     void        _fitColumns();
     void        _updateLayout();
     void        _updateLayoutIfNeeded();
+    int         _measureCells(HDC hdc, int cellIdx);
+    void        _measureCell(HDC hdc, GridColumn& column, int cellIdx);
+    int         _fitRowHeight(int contentHeight);
+    void        _updateColumnWidths();
+    void        _resetContentWidths();
+    void        _removeContentWidth(GridColumn& column, int width);
+    void        _invalidateCell(int row, int column, bool valueChanged);
+    void        _invalidateRow(int row);
+    void        _invalidateAllRows(bool remeasure);
+    void        _insertRowLayout(int rowAt);
+    void        _removeRowLayout(int rowAt);
     void        _updateContentSize();
+    void        _rebuildRowOffsets();
+    int         _rowOffset(int row);
+    int         _rowAtOffset(int offset);
+    int         _columnAtOffset(int offset);
     bool        _findIndex(int posX, int posY, int& row, int& column);
     void        _getCellPos(int row, int column, int& posX, int& posY);
+    int         _findFirstVisibleRow(int posTop, int& posY);
     void        _findSelection(int& row, int& column);
     void        _updateSelection(int row, int column);
+    int         _cellIndex(int row);
+    int         _rowHeight(int row);
+    void        _clearCells();
+    bool        _validateCellData(int row, int column);
     void        _createTextEditor();
     void        _createListEditor();
     void        _completeEditing();
@@ -233,15 +341,89 @@ private: // worker methods
     void        _updateEditor();
     bool        _handleKeyPressed(WPARAM wParam, LPARAM lParam);
 
+private: // virtual mode worker methods
+    int         _virtualSlot(int row);
+    void        _releaseVirtualSlot(int slot);
+    void        _loadVirtualRows();
+    void        _trimVirtualRows(int firstRow, int lastRow);
+    void        _shiftVirtualRows(int rowAt, int shift);
+    int         _virtualRowStep() const;
+
+private: // view worker methods
+    bool        _isViewActive() const;
+    int         _viewRowCount();
+    int         _viewRow(int row);
+    int         _dataRow(int viewRow);
+    void        _invalidateView(bool rebuild);
+    void        _invalidateViewRow(int row);
+    bool        _viewUsesColumn(int column);
+    void        _insertViewRow(int rowAt);
+    void        _removeViewRow(int rowAt);
+    void        _updateView();
+    void        _moveViewRows(bool dataViewRowsValid, int& firstMoved, int& lastMoved);
+    void        _patchViewRows(int firstMoved, int lastMoved);
+    void        _buildView();
+    void        _sortView();
+    void        _updateDataViewRows();
+    bool        _acceptRow(int row);
+    void        _initViewComparator(_ViewComparator& comparator);
+    static void _sortKeyRange(std::vector<_SortKey>* keys, size_t first, size_t last, const _SortKeyComparator* comparator);
+    void        _requestRepaint();
+
 private: // paint methods
-    void        _paintCell(HDC hdc, int posX, int posY, int width, int height, const GridCellData& cell);
+    void        _initGDICache(HDC hdc);
+    void        _paintRect(HDC hdc, const RECT& paintRect);
+    void        _repaintCell(int row, int column);
+    void        _repaintRow(int row);
+    void        _scrollContent(int dX, int dY);
+    void        _paintCell(HDC hdc, int posX, int posY, int width, int height, const XWGridColumnStore& cells, int cellIdx);
 
 private: // subclassing
     static LRESULT CALLBACK _subclassProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData);
 
 private: // grid data
-    _gridRowsT              m_gridData;
+    _gridRowsT              m_gridRows;
     _gridColumnsT           m_gridColumns;
+    std::vector<int>        m_dirtyRows;
+
+private: // offsets
+    XWFenwickTree           m_rowOffsets;
+    std::vector<int>        m_columnOffsets;
+    bool                    m_rowOffsetsRebuildNeeded;
+
+private: // virtual mode
+    IXWGridDataSource*      m_pDataSource;
+    int                     m_virtualRowCount;
+    int                     m_virtualRowHeight;
+    int                     m_virtualFirstRow;
+    int                     m_virtualLastRow;
+    _gridRowCacheT          m_virtualRows;
+    std::vector<int>        m_virtualFreeSlots;
+    _gridSelectionT         m_virtualSelection;
+    GridCellInfo            m_virtualCellInfo;
+    std::set<int>           m_virtualTextRows;
+
+private: // view
+    std::vector<int>        m_viewRows;
+    std::vector<int>        m_dataViewRows;
+    std::vector<int>        m_viewChangedRows;
+    int                     m_sortColumn;
+    bool                    m_sortAscending;
+    IXWGridSortComparator*  m_pSortComparator;
+    IXWGridRowFilter*       m_pRowFilter;
+    bool                    m_viewUpdateNeeded;
+    bool                    m_viewRebuildNeeded;
+    bool                    m_viewNarrowNeeded;
+
+private: // bulk update
+    int                     m_updateLevel;
+    bool                    m_contentChangedNeeded;
+
+private: // painting
+    XGdiResourcesCache*     m_pGDIResourcesCache;
+    HFONT                   m_paintFont;
+    COLORREF                m_paintBkColor;
+    bool                    m_repaintAllNeeded;
 
 private: // data
     GridStyle               m_gridStyle;
@@ -265,5 +447,66 @@ private: // data
 // XWGridWindow
 /////////////////////////////////////////////////////////////////////
 
+/////////////////////////////////////////////////////////////////////
+// IXWGridDataSource - grid data source interface (virtual mode)
+
+class IXWGridDataSource
+{
+public: // construction/destruction
+    IXWGridDataSource() {}
+    virtual ~IXWGridDataSource() {}
+
+public: // rows
+    virtual int     gridRowCount(XWGridWindow* grid) = 0;
+
+public: // cells (cell is reset to default values before call)
+    virtual void    getGridCell(XWGridWindow* grid, int row, int column, XWGridWindow::GridCellInfo& cellOut) = 0;
+
+public: // editing (called when user changes cell value)
+    virtual void    setGridCellText(XWGridWindow* grid, int row, int column, const wchar_t* text) {}
+    virtual void    setGridCellListIndex(XWGridWindow* grid, int row, int column, int index) {}
+};
+
+// IXWGridDataSource
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// IXWGridSortComparator - grid row comparator (sorting)
+
+// NOTE: comparator is called on window thread only. Large grids without comparator are
+//       sorted by several threads, cell texts are read before and threads don't use grid.
+
+class IXWGridSortComparator
+{
+public: // construction/destruction
+    IXWGridSortComparator() {}
+    virtual ~IXWGridSortComparator() {}
+
+public: // compare data rows by column (negative, zero or positive as wcscmp)
+    virtual int     compareGridRows(XWGridWindow* grid, int column, int rowA, int rowB) = 0;
+};
+
+// IXWGridSortComparator
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// IXWGridRowFilter - grid row filter
+
+class IXWGridRowFilter
+{
+public: // construction/destruction
+    IXWGridRowFilter() {}
+    virtual ~IXWGridRowFilter() {}
+
+public: // check if data row is shown
+    virtual bool    acceptGridRow(XWGridWindow* grid, int row) = 0;
+
+public: // check if filter reads column (NOTE: rows are filtered again only if such cell changes)
+    virtual bool    usesGridColumn(XWGridWindow* grid, int column) { return true; }
+};
+
+// IXWGridRowFilter
+/////////////////////////////////////////////////////////////////////
+
 #endif // _XWGRIDWINDOW_H_
 
@@ -11,6 +11,15 @@
 
 #include "xwsplitterwindow.h"
 
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// timer to move split windows while splitter is dragged
+#define XWSPLITTER_DRAG_TIMER_ID            1
+
+// drag frame interval (~60 fps, timer resolution is about 15 ms)
+#define XWSPLITTER_DRAG_FRAME_MS            16
+
 /////////////////////////////////////////////////////////////////////
 // XWSplitterWindow - splitter window
 
@@ -29,7 +38,8 @@ XWSplitterWindow::XWSplitterWindow(DWORD dwStyle, XWObject* parent, HWND hWndPar
     m_splitterWidth(5), // default width
     m_mouseMoveActive(false),
     m_mousePosX(0),
-    m_mousePosY(0)
+    m_mousePosY(0),
+    m_dragThrottle(XWSPLITTER_DRAG_FRAME_MS)
 {
 }
 
@@ -175,6 +185,18 @@ void XWSplitterWindow::onPaint(HDC hdc, PAINTSTRUCT& ps)
     onPaintSplitter(hdc, rcSplitter);
 }
 
+bool XWSplitterWindow::onTimer(WPARAM uIDEvent)
+{
+    // pass other timers to parent
+    if(uIDEvent != XWSPLITTER_DRAG_TIMER_ID) return XWindow::onTimer(uIDEvent);
+
+    // move split windows to last drag position if frame is due
+    int dragPos = 0;
+    if(m_dragThrottle.frame((long long)::GetTickCount64(), dragPos)) _applyDragPos(dragPos);
+
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////
 // mouse events (from XWindow)
 /////////////////////////////////////////////////////////////////////
@@ -193,31 +215,26 @@ void XWSplitterWindow::onMouseMove(int posX, int posY, WPARAM flags)
     // resize if in move mode
     if(m_mouseMoveActive)
     {
-        int newPos = m_splitterPos;
+        int newPos = m_dragThrottle.value();
         int validPos = 0;
 
         if(m_orientation == XWUI_SPLIT_VERTICALLY)
         {
             // move
-            newPos = m_splitterPos + (posY - m_mousePosY);
+            newPos = m_dragThrottle.value() + (posY - m_mousePosY);
 
         } else if(m_orientation == XWUI_SPLIT_HORIZONTALLY)
         {
             // move
-            newPos = m_splitterPos + (posX - m_mousePosX);
+            newPos = m_dragThrottle.value() + (posX - m_mousePosX);
         }
 
         // ignore movements that fail layout constraints
         if(!_validatePosition(newPos, validPos)) return;
 
-        // ignore if position is the same
-        if(newPos == m_splitterPos) return;
-
-        // move
-        _setSplitterPos(newPos);
-
-        // repaint splitter
-        _doPaintSplitter();
+        // NOTE: first move after idle frame is applied at once, others on next drag frame
+        int dragPos = 0;
+        if(m_dragThrottle.update(newPos, (long long)::GetTickCount64(), dragPos)) _applyDragPos(dragPos);
     }
 
     // save mouse position
@@ -233,8 +250,8 @@ bool XWSplitterWindow::onMouseClick(UINT uButtonMsg, int posX, int posY, WPARAM
         // start mouse move if not active
         if(!m_mouseMoveActive)
         {
-            // update flag
-            m_mouseMoveActive = true;
+            // start drag
+            _beginDrag();
 
             // start mouse capture
             ::SetCapture(hwnd());
@@ -245,8 +262,8 @@ bool XWSplitterWindow::onMouseClick(UINT uButtonMsg, int posX, int posY, WPARAM
         // top mouse move if active
         if(m_mouseMoveActive)
         {
-            // update flag
-            m_mouseMoveActive = false;
+            // finish drag
+            _endDrag();
 
             // stop mouse capture
             ::ReleaseCapture();
@@ -258,8 +275,8 @@ bool XWSplitterWindow::onMouseClick(UINT uButtonMsg, int posX, int posY, WPARAM
 
 bool XWSplitterWindow::onMouseCaptureChanged()
 {
-    // reset flag
-    m_mouseMoveActive = false;
+    // finish drag if capture has been lost
+    _endDrag();
 
     // reset cursor
     _resetCursor();
@@ -549,5 +566,56 @@ void XWSplitterWindow::_doPaintSplitter()
     ::ReleaseDC(hwnd(), hdc);
 }
 
+/////////////////////////////////////////////////////////////////////
+// splitter drag
+/////////////////////////////////////////////////////////////////////
+void XWSplitterWindow::_beginDrag()
+{
+    // update flag
+    m_mouseMoveActive = true;
+
+    // start from current position
+    m_dragThrottle.begin(m_splitterPos, (long long)::GetTickCount64());
+
+    // split windows may show provisional content while resizing
+    if(m_ltWindow) m_ltWindow->beginLiveResize();
+    if(m_rbWindow) m_rbWindow->beginLiveResize();
+
+    // move split windows once per frame
+    startTimer(XWSPLITTER_DRAG_TIMER_ID, XWSPLITTER_DRAG_FRAME_MS);
+}
+
+void XWSplitterWindow::_endDrag()
+{
+    // ignore if not active
+    if(!m_mouseMoveActive) return;
+
+    // update flag
+    m_mouseMoveActive = false;
+
+    // stop frame timer
+    stopTimer(XWSPLITTER_DRAG_TIMER_ID);
+
+    // move to last position if not done yet
+    int dragPos = 0;
+    if(m_dragThrottle.end(dragPos)) _applyDragPos(dragPos);
+
+    // full layout of split windows
+    if(m_ltWindow) m_ltWindow->endLiveResize();
+    if(m_rbWindow) m_rbWindow->endLiveResize();
+}
+
+void XWSplitterWindow::_applyDragPos(int dragPos)
+{
+    // ignore if position is the same
+    if(dragPos == m_splitterPos) return;
+
+    // move
+    _setSplitterPos(dragPos);
+
+    // repaint splitter
+    _doPaintSplitter();
+}
+
 // XWSplitterWindow
 /////////////////////////////////////////////////////////////////////
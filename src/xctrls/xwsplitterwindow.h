@@ -5,6 +5,11 @@
 #ifndef _XWSPLITTERWINDOW_H_
 #define _XWSPLITTERWINDOW_H_
 
+// NOTE: while splitter is dragged mouse moves are collected and split windows are moved
+//       once per frame only (see XWFrameThrottle). Split windows are in live resize mode
+//       during drag (see XWHWND::beginLiveResize), so they may show snapshot of their
+//       content until splitter is released.
+
 /////////////////////////////////////////////////////////////////////
 // splitter window orientation
 enum TXWSplitOrientation
@@ -38,6 +43,7 @@ protected: // splitter painting
 protected: // window events (from XWindow)
     void    onResize(int type, int width, int height);
     void    onPaint(HDC hdc, PAINTSTRUCT& ps);
+    bool    onTimer(WPARAM uIDEvent);
 
 protected: // mouse events (from XWindow)
     void    onMouseEnter(int posX, int posY);
@@ -61,6 +67,11 @@ private: // worker methods
     void    _getSplitterRect(RECT& rcSplitter);
     void    _doPaintSplitter();
 
+private: // splitter drag
+    void    _beginDrag();
+    void    _endDrag();
+    void    _applyDragPos(int dragPos);
+
 private: // data
     TXWSplitOrientation m_orientation;
     COLORREF            m_fillColor;
@@ -73,6 +84,9 @@ private: // data
     bool                m_mouseMoveActive;
     int                 m_mousePosX;
     int                 m_mousePosY;
+
+private: // splitter drag
+    XWFrameThrottle     m_dragThrottle;
 };
 
 // XWSplitterWindow
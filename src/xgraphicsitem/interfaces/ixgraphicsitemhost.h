@@ -0,0 +1,56 @@
+// Graphics item host interface
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _IXGRAPHICSITEMHOST_H_
+#define _IXGRAPHICSITEMHOST_H_
+
+// NOTE: by default graphics items talk to parent window with XWUI messages. If
+//       item host is set, all requests that item sends to its parent window are
+//       routed to host instead, so item tree (layout, hit-testing, focus and
+//       scrolling) may run without window, e.g. with input injected directly
+//       by calling item mouse and keyboard handlers.
+
+// NOTE: item timers are delivered by host calling onTimerEvent, timer must be
+//       stopped if it returns false (same as parent window does).
+
+/////////////////////////////////////////////////////////////////////
+// forward declarations
+class XGraphicsItem;
+
+/////////////////////////////////////////////////////////////////////
+// IXGraphicsItemHost - graphics item host interface
+
+class IXGraphicsItemHost
+{
+public: // construction/destruction
+    IXGraphicsItemHost() {}
+    virtual ~IXGraphicsItemHost() {}
+
+public: // mouse capture
+    virtual void    setMouseCapture(XGraphicsItem* item) = 0;
+    virtual void    resetMouseCapture() = 0;
+
+public: // mouse cursor (returns previous cursor)
+    virtual HCURSOR setCursor(HCURSOR cursor) { return 0; }
+
+public: // timers
+    virtual bool    startTimer(XGraphicsItem* item, unsigned int elapseMs) { return false; }
+    virtual bool    stopTimer(XGraphicsItem* item) { return false; }
+
+public: // popups
+    virtual void    showTooltip(const wchar_t* text) {}
+    virtual void    showContextMenu(XGraphicsItem* item, int posX, int posY) {}
+
+public: // painting (area is painted before return if paintNow is set)
+    virtual void    repaintRect(const RECT& rcPaint, bool paintNow) = 0;
+    virtual bool    scrollRect(const RECT& rcScroll, int offsetX, int offsetY) { return false; }
+
+public: // layout
+    virtual bool    requestLayout() = 0;
+};
+
+// IXGraphicsItemHost
+/////////////////////////////////////////////////////////////////////
+
+#endif // _IXGRAPHICSITEMHOST_H_
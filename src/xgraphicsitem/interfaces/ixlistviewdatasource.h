@@ -0,0 +1,35 @@
+// List view data source interface
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _IXLISTVIEWDATASOURCE_H_
+#define _IXLISTVIEWDATASOURCE_H_
+
+// NOTE: list view with data source creates items only for visible rows and reuses 
+//       them while scrolling. Items are created by data source, but owned by list 
+//       view. Bind should only set item content, list view measures row height 
+//       with contentHeightForWidth and positions items itself.
+
+/////////////////////////////////////////////////////////////////////
+// IXListViewDataSource - list view data source interface
+
+class IXListViewDataSource
+{
+public: // construction/destruction
+    IXListViewDataSource() {}
+    virtual ~IXListViewDataSource() {}
+
+public: // rows
+    virtual int     rowCount() = 0;
+    virtual int     rowHeightEstimate() = 0;
+
+public: // row items
+    virtual XGraphicsItem*  createRowItem() = 0;
+    virtual void    bindRowItem(int row, XGraphicsItem* item) = 0;
+    virtual void    unbindRowItem(int row, XGraphicsItem* item) {}
+};
+
+// IXListViewDataSource
+/////////////////////////////////////////////////////////////////////
+
+#endif // _IXLISTVIEWDATASOURCE_H_
@@ -6,12 +6,20 @@
 #include "../../graphics/xwgraphics.h"
 #include "../../layout/xlayoutitem.h"
 #include "../../layout/xlayout.h"
+#include "../../layout/xlayoutsizesolver.h"
 #include "../../layout/xvboxlayout.h"
 
 #include "../xgraphicsitem.h"
+#include "../interfaces/ixlistviewdatasource.h"
 
 #include "xlistviewitem.h"
 
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// default height of invisible area where rows are kept bound (in pixels)
+#define XWUI_LISTVIEW_DEFAULT_OVERSCAN      100
+
 /////////////////////////////////////////////////////////////////////
 // XListViewItem - list item
 
@@ -22,6 +30,14 @@ XListViewItem::XListViewItem(XGraphicsItem* parent) :
     m_itemsPosX(0),
     m_itemsWidth(0),
     m_itemsHeight(0),
+    m_paintedScrollOffsetX(0),
+    m_paintedScrollOffsetY(0),
+    m_itemsScrollOffsetX(0),
+    m_itemsScrollOffsetY(0),
+    m_pDataSource(0),
+    m_firstRowItem(0),
+    m_rowsWidth(0),
+    m_nOverscanHeight(XWUI_LISTVIEW_DEFAULT_OVERSCAN),
     m_nMarginLeft(0),
     m_nMarginTop(0),
     m_nMarginRight(0),
@@ -48,6 +64,14 @@ void XListViewItem::appendListItem(XGraphicsItem* item)
     XWASSERT(item);
     if(item == 0) return;
 
+    // items are created by data source in virtual mode
+    XWASSERT(m_pDataSource == 0);
+    if(m_pDataSource)
+    {
+        XWTRACE("XListViewItem: list items cannot be added in virtual mode, ignored");
+        return;
+    }
+
     // check if already added
     if(findListItem(item->xwoid()) != 0)
     {
@@ -73,6 +97,9 @@ void XListViewItem::deleteAllListItems()
 
 XGraphicsItem* XListViewItem::findListItem(unsigned long itemId)
 {
+    // make sure item position is up to date
+    _syncItemPositions();
+
     // find child item 
     return XGraphicsItem::findChildItem(itemId);
 }
@@ -80,12 +107,104 @@ XGraphicsItem* XListViewItem::findListItem(unsigned long itemId)
 /////////////////////////////////////////////////////////////////////
 // item list (NOTE: call handleContentChanged after updating list)
 /////////////////////////////////////////////////////////////////////
-std::list<XGraphicsItem*>& XListViewItem::items() 
+XGraphicsItem::XGraphicsItemList& XListViewItem::items() 
 { 
+    // make sure item positions are up to date
+    _syncItemPositions();
+
     // NOTE: return XGraphicsItem child list
     return m_childItems; 
 }
 
+/////////////////////////////////////////////////////////////////////
+// virtual mode
+/////////////////////////////////////////////////////////////////////
+void XListViewItem::setDataSource(IXListViewDataSource* pDataSource)
+{
+    // ignore if the same
+    if(m_pDataSource == pDataSource) return;
+
+    // remove items from previous mode
+    _recycleAllRowItems();
+    deleteAllListItems();
+    m_recycledItems.clear();
+    m_rowHeights.clear();
+
+    // copy reference
+    m_pDataSource = pDataSource;
+
+    // load rows
+    reloadData();
+}
+
+void XListViewItem::reloadData()
+{
+    // ignore if not in virtual mode
+    if(m_pDataSource == 0) return;
+
+    // release all rows
+    _recycleAllRowItems();
+
+    // reset row heights to estimate
+    _resetRowHeights();
+
+    // layout rows and update parent
+    handleContentChanged();
+}
+
+void XListViewItem::reloadRow(int row)
+{
+    // ignore if not in virtual mode
+    if(m_pDataSource == 0) return;
+
+    // check input
+    XWASSERT(row >= 0 && row < m_rowHeights.count());
+    if(row < 0 || row >= m_rowHeights.count()) return;
+
+    // get bound item
+    XGraphicsItem* item = rowItem(row);
+    if(item == 0) return;
+
+    // bind item again
+    m_pDataSource->unbindRowItem(row, item);
+    m_pDataSource->bindRowItem(row, item);
+
+    // measure row
+    int itemHeight = item->contentHeightForWidth(m_itemsWidth);
+
+    // check if height has been changed
+    if(itemHeight + m_nItemSpacing != m_rowHeights.value(row))
+    {
+        // update height
+        m_rowHeights.setValue(row, itemHeight + m_nItemSpacing);
+
+        // rows below have to be moved
+        handleContentChanged();
+
+    } else
+    {
+        // repaint row
+        item->repaint();
+    }
+}
+
+void XListViewItem::setOverscanHeight(int height)
+{
+    // check input
+    XWASSERT(height >= 0);
+    if(height < 0) return;
+
+    m_nOverscanHeight = height;
+}
+
+XGraphicsItem* XListViewItem::rowItem(int row)
+{
+    // check if row is bound
+    if(row < m_firstRowItem || row >= m_firstRowItem + (int)m_rowItems.size()) return 0;
+
+    return m_rowItems[row - m_firstRowItem];
+}
+
 /////////////////////////////////////////////////////////////////////
 // list item width constraints
 /////////////////////////////////////////////////////////////////////
@@ -115,18 +234,6 @@ void XListViewItem::setItemAlignment(TAlignment alignment)
     m_itemAlignment = alignment;
 }
 
-/////////////////////////////////////////////////////////////////////
-// content 
-/////////////////////////////////////////////////////////////////////
-void XListViewItem::handleContentChanged()
-{
-    // layout items
-    _layoutItems(m_itemRect.left, m_itemRect.top, width(), height());
-
-    // pass to parent
-    XGraphicsItem::handleContentChanged();
-}
-
 /////////////////////////////////////////////////////////////////////
 // content margins
 /////////////////////////////////////////////////////////////////////
@@ -207,6 +314,60 @@ void XListViewItem::setScrollOffsetY(int scrollOffsetY)
     _scrollItems();
 }
 
+/////////////////////////////////////////////////////////////////////
+// mouse events (from XGraphicsItem)
+/////////////////////////////////////////////////////////////////////
+void XListViewItem::onMouseEnter(int posX, int posY)
+{
+    // make sure item positions are up to date
+    _syncItemPositions();
+
+    // pass to parent
+    XGraphicsItem::onMouseEnter(posX, posY);
+}
+
+void XListViewItem::onMouseMove(int posX, int posY, WPARAM flags)
+{
+    // make sure item positions are up to date
+    _syncItemPositions();
+
+    // pass to parent
+    XGraphicsItem::onMouseMove(posX, posY, flags);
+}
+
+bool XListViewItem::onMouseClick(UINT uButtonMsg, int posX, int posY, WPARAM flags)
+{
+    // make sure item positions are up to date
+    _syncItemPositions();
+
+    // pass to parent
+    return XGraphicsItem::onMouseClick(uButtonMsg, posX, posY, flags);
+}
+
+/////////////////////////////////////////////////////////////////////
+// GDI painting (from XGraphicsItem)
+/////////////////////////////////////////////////////////////////////
+void XListViewItem::onPaintGDI(HDC hdc, const RECT& rcPaint)
+{
+    // make sure item positions are up to date
+    _syncItemPositions();
+
+    // pass to parent
+    XGraphicsItem::onPaintGDI(hdc, rcPaint);
+}
+
+/////////////////////////////////////////////////////////////////////
+// Direct2D painting (from XGraphicsItem)
+/////////////////////////////////////////////////////////////////////
+void XListViewItem::onPaintD2D(ID2D1RenderTarget* pTarget, const RECT& rcPaint)
+{
+    // make sure item positions are up to date
+    _syncItemPositions();
+
+    // pass to parent
+    XGraphicsItem::onPaintD2D(pTarget, rcPaint);
+}
+
 /////////////////////////////////////////////////////////////////////
 // worker methods
 /////////////////////////////////////////////////////////////////////
@@ -215,6 +376,9 @@ void XListViewItem::_layoutItems(int posX, int posY, int width, int height)
     // pass to parent first
     XGraphicsItem::update(posX, posY, width, height);
 
+    // current content height
+    int itemsHeight = m_itemsHeight;
+
     // update layout data
     m_itemsWidth = width - m_nMarginLeft - m_nMarginRight;
     m_itemsPosX = posX + m_nMarginLeft;
@@ -239,36 +403,95 @@ void XListViewItem::_layoutItems(int posX, int posY, int width, int height)
         }
     }
 
-    // item position (including scrolling)
-    int itemPosX = m_itemsPosX  - scrollOffsetX();
-    int itemPosY = posY + m_nMarginTop - scrollOffsetY();
+    // check if list is in virtual mode
+    if(m_pDataSource)
+    {
+        // measured heights are not valid for new width
+        if(m_rowsWidth != m_itemsWidth) _resetRowHeights();
 
-    // layout items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); 
-        it != m_childItems.end(); ++it)
+        // layout visible rows only
+        _layoutRows(true);
+
+    } else
     {
-        // get content width for item height
-        int itemHeight = (*it)->contentHeightForWidth(m_itemsWidth);
+        // item position (including scrolling)
+        int itemPosX = m_itemsPosX  - scrollOffsetX();
+        int itemPosY = posY + m_nMarginTop - scrollOffsetY();
 
-        // layout item
-        (*it)->update(m_itemsPosX, itemPosY, m_itemsWidth, itemHeight);
+        // layout items
+        for(XGraphicsItemList::iterator it = m_childItems.begin(); 
+            it != m_childItems.end(); ++it)
+        {
+            // get content width for item height
+            int itemHeight = (*it)->contentHeightForWidth(m_itemsWidth);
 
-        // update position
-        itemPosY += (*it)->height() + m_nItemSpacing;
+            // layout item
+            (*it)->update(m_itemsPosX, itemPosY, m_itemsWidth, itemHeight);
+
+            // update position
+            itemPosY += (*it)->height() + m_nItemSpacing;
+        }
+
+        // update items height
+        m_itemsHeight = itemPosY - posY - m_nMarginTop + scrollOffsetY() - m_nItemSpacing;
+
+        // items are positioned for current scroll offset
+        m_itemsScrollOffsetX = m_paintedScrollOffsetX = scrollOffsetX();
+        m_itemsScrollOffsetY = m_paintedScrollOffsetY = scrollOffsetY();
     }
 
-    // update items height
-    m_itemsHeight = itemPosY - posY - m_nMarginTop + scrollOffsetY() - m_nItemSpacing;
+    // parent has to update scrolling if content height has been changed
+    if(m_itemsHeight != itemsHeight) invalidateParentLayout();
 }
 
 void XListViewItem::_scrollItems()
 {
+    // offset from already painted content
+    int offsetX = m_paintedScrollOffsetX - scrollOffsetX();
+    int offsetY = m_paintedScrollOffsetY - scrollOffsetY();
+
+    // ignore if not changed
+    if(offsetX == 0 && offsetY == 0) return;
+
+    // copy new offsets
+    m_paintedScrollOffsetX = scrollOffsetX();
+    m_paintedScrollOffsetY = scrollOffsetY();
+
+    // move painted content (only exposed area is repainted)
+    scrollRect(m_itemRect, offsetX, offsetY);
+
+    // NOTE: items are moved in the same step as painted content, so item rectangles 
+    //       (and child windows attached to items) are never out of sync with screen
+    _syncItemPositions();
+
+    // check if list is in virtual mode
+    if(m_pDataSource)
+    {
+        // NOTE: rows have to be bound right away as binding may repaint items
+
+        // bind exposed rows (repaint all if rows above have changed height)
+        if(_layoutRows(false)) repaint();
+    }
+}
+
+void XListViewItem::_syncItemPositions()
+{
+    // ignore if items are positioned already
+    if(m_itemsScrollOffsetX == scrollOffsetX() && m_itemsScrollOffsetY == scrollOffsetY()) return;
+
+    // NOTE: rows are positioned while scrolling in virtual mode
+    if(m_pDataSource) return;
+
+    // copy offsets
+    m_itemsScrollOffsetX = scrollOffsetX();
+    m_itemsScrollOffsetY = scrollOffsetY();
+
     // item position (including scrolling)
     int itemPosX = m_itemsPosX  - scrollOffsetX();
     int itemPosY = rect().top + m_nMarginTop - scrollOffsetY();
 
     // reposition items (do not layout)
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); 
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); 
         it != m_childItems.end(); ++it)
     {
         // move items
@@ -277,9 +500,197 @@ void XListViewItem::_scrollItems()
         // update position
         itemPosY += (*it)->height() + m_nItemSpacing;
     }
+}
+
+/////////////////////////////////////////////////////////////////////
+// events
+/////////////////////////////////////////////////////////////////////
+void XListViewItem::onChildObjectRemoved(XWObject* child)
+{
+    // remove references to row item if any
+    if(child && m_pDataSource)
+    {
+        // bound rows
+        for(size_t idx = 0; idx < m_rowItems.size(); ++idx)
+        {
+            if(m_rowItems[idx] && m_rowItems[idx]->xwoid() == child->xwoid()) m_rowItems[idx] = 0;
+        }
 
-    // force repaint for performance
-    repaint(true);
+        // recycled items
+        for(std::vector<XGraphicsItem*>::iterator it = m_recycledItems.begin(); it != m_recycledItems.end(); ++it)
+        {
+            if((*it)->xwoid() == child->xwoid())
+            {
+                m_recycledItems.erase(it);
+                break;
+            }
+        }
+    }
+
+    // pass to parent
+    XGraphicsItem::onChildObjectRemoved(child);
+}
+
+/////////////////////////////////////////////////////////////////////
+// virtual mode worker methods
+/////////////////////////////////////////////////////////////////////
+bool XListViewItem::_layoutRows(bool measureRows)
+{
+    XWASSERT(m_pDataSource);
+
+    int rowCount = m_rowHeights.count();
+
+    // visible area in content coordinates (including overscan)
+    int viewTop = scrollOffsetY() - m_nMarginTop - m_nOverscanHeight;
+    int viewBottom = scrollOffsetY() - m_nMarginTop + height() + m_nOverscanHeight;
+
+    // visible rows
+    int firstRow = m_rowHeights.findIndex(viewTop);
+    int lastRow = (viewBottom > 0) ? m_rowHeights.findIndex(viewBottom) + 1 : 0;
+    if(lastRow > rowCount) lastRow = rowCount;
+    if(firstRow > lastRow) firstRow = lastRow;
+
+    // last row bound before update (rows above it are visible on screen)
+    int prevLastRow = m_firstRowItem + (int)m_rowItems.size();
+
+    // keep bound rows which are still visible, recycle others
+    m_rowItemsUpdate.assign(lastRow - firstRow, 0);
+    for(int idx = 0; idx < (int)m_rowItems.size(); ++idx)
+    {
+        int row = m_firstRowItem + idx;
+
+        if(row >= firstRow && row < lastRow)
+            m_rowItemsUpdate[row - firstRow] = m_rowItems[idx];
+        else
+            _recycleRowItem(row, m_rowItems[idx]);
+    }
+
+    // update bound rows
+    m_rowItems.swap(m_rowItemsUpdate);
+    m_rowItemsUpdate.clear();
+    m_firstRowItem = firstRow;
+
+    // item position (including scrolling)
+    int itemPosX = m_itemsPosX - scrollOffsetX();
+    int itemPosY = m_itemRect.top + m_nMarginTop - scrollOffsetY() + m_rowHeights.prefixSum(firstRow);
+
+    bool heightChanged = false;
+
+    // layout visible rows
+    for(int row = firstRow; row < lastRow; ++row)
+    {
+        XGraphicsItem* item = m_rowItems[row - firstRow];
+
+        // bind new rows
+        bool rowBound = false;
+        if(item == 0)
+        {
+            item = _bindRowItem(row, itemPosX, itemPosY);
+            m_rowItems[row - firstRow] = item;
+            rowBound = true;
+        }
+
+        // measure rows (only new rows while scrolling)
+        if(item && (rowBound || measureRows))
+        {
+            int rowHeight = item->contentHeightForWidth(m_itemsWidth) + m_nItemSpacing;
+
+            // update height if needed
+            if(rowHeight != m_rowHeights.value(row))
+            {
+                m_rowHeights.setValue(row, rowHeight);
+
+                // rows on screen are moved if changed row is above them
+                if(row < prevLastRow) heightChanged = true;
+            }
+        }
+
+        // layout item
+        if(item) item->update(itemPosX, itemPosY, m_itemsWidth, m_rowHeights.value(row) - m_nItemSpacing);
+
+        // update position
+        itemPosY += m_rowHeights.value(row);
+    }
+
+    // update items height
+    m_itemsHeight = (rowCount > 0) ? m_rowHeights.totalSum() - m_nItemSpacing : 0;
+
+    // items are positioned for current scroll offset
+    m_itemsScrollOffsetX = m_paintedScrollOffsetX = scrollOffsetX();
+    m_itemsScrollOffsetY = m_paintedScrollOffsetY = scrollOffsetY();
+
+    return heightChanged;
+}
+
+XGraphicsItem* XListViewItem::_bindRowItem(int row, int posX, int posY)
+{
+    XGraphicsItem* item = 0;
+
+    // reuse recycled item if any
+    if(m_recycledItems.size())
+    {
+        item = m_recycledItems.back();
+        m_recycledItems.pop_back();
+
+    } else
+    {
+        // create new item
+        item = m_pDataSource->createRowItem();
+        XWASSERT(item);
+        if(item == 0) return 0;
+
+        // take ownership
+        XGraphicsItem::addChildItem(item);
+    }
+
+    // NOTE: move item before binding so that repaint from item is done at new position
+    item->move(posX, posY);
+    item->setVisible(true);
+
+    // bind
+    m_pDataSource->bindRowItem(row, item);
+
+    return item;
+}
+
+void XListViewItem::_recycleRowItem(int row, XGraphicsItem* item)
+{
+    // ignore empty rows
+    if(item == 0) return;
+
+    // unbind
+    m_pDataSource->unbindRowItem(row, item);
+
+    // hide and keep for reuse
+    item->setVisible(false);
+    m_recycledItems.push_back(item);
+}
+
+void XListViewItem::_recycleAllRowItems()
+{
+    // recycle bound rows
+    for(int idx = 0; idx < (int)m_rowItems.size(); ++idx)
+    {
+        _recycleRowItem(m_firstRowItem + idx, m_rowItems[idx]);
+    }
+
+    // reset bound rows
+    m_rowItems.clear();
+    m_firstRowItem = 0;
+}
+
+void XListViewItem::_resetRowHeights()
+{
+    XWASSERT(m_pDataSource);
+
+    // NOTE: rows are measured only when bound, estimate is used for other rows
+    m_rowHeights.reset(m_pDataSource->rowCount(), m_pDataSource->rowHeightEstimate() + m_nItemSpacing);
+
+    // width rows are measured for
+    m_rowsWidth = m_itemsWidth;
+
+    // update items height
+    m_itemsHeight = (m_rowHeights.count() > 0) ? m_rowHeights.totalSum() - m_nItemSpacing : 0;
 }
 
 // XListViewItem
@@ -8,6 +8,7 @@
 /////////////////////////////////////////////////////////////////////
 // forward declarations
 class XVBoxLayout;
+class IXListViewDataSource;
 
 /////////////////////////////////////////////////////////////////////
 // XListViewItem - list item
@@ -25,7 +26,15 @@ public: // items (list takes ownership)
     XGraphicsItem*  findListItem(unsigned long itemId);
 
 public: // item list (NOTE: call handleContentChanged after updating list)
-    std::list<XGraphicsItem*>&   items();
+    XGraphicsItemList&  items();
+
+public: // virtual mode (NOTE: list does not take data source ownership)
+    void    setDataSource(IXListViewDataSource* pDataSource);
+    IXListViewDataSource*   dataSource() const { return m_pDataSource; }
+    void    reloadData();
+    void    reloadRow(int row);
+    void    setOverscanHeight(int height);
+    XGraphicsItem*  rowItem(int row);
 
 public: // list item width constraints
     void    setMaxItemWidth(int width);
@@ -41,9 +50,6 @@ public: // alignment
 
     void    setItemAlignment(TAlignment alignment);
 
-public: // content 
-    void    handleContentChanged(); 
-
 public: // content margins
     void    setContentMargins(int left, int top, int right, int bottom);
     void    setItemSpacing(int spacing);
@@ -58,9 +64,31 @@ public: // scrolling interface (from IXWScrollable)
     void    setScrollOffsetX(int scrollOffsetX);
     void    setScrollOffsetY(int scrollOffsetY);
 
+public: // mouse events (from XGraphicsItem)
+    void    onMouseEnter(int posX, int posY);
+    void    onMouseMove(int posX, int posY, WPARAM flags);
+    bool    onMouseClick(UINT uButtonMsg, int posX, int posY, WPARAM flags);
+
+public: // GDI painting (from XGraphicsItem)
+    void    onPaintGDI(HDC hdc, const RECT& rcPaint);   
+
+public: // Direct2D painting (from XGraphicsItem)
+    void    onPaintD2D(ID2D1RenderTarget* pTarget, const RECT& rcPaint); 
+
+private: // events
+    void    onChildObjectRemoved(XWObject* child);
+
 private: // worker methods
     void    _layoutItems(int posX, int posY, int width, int height);
     void    _scrollItems();
+    void    _syncItemPositions();
+
+private: // virtual mode worker methods
+    bool    _layoutRows(bool measureRows);
+    XGraphicsItem*  _bindRowItem(int row, int posX, int posY);
+    void    _recycleRowItem(int row, XGraphicsItem* item);
+    void    _recycleAllRowItems();
+    void    _resetRowHeights();
 
 private: // data
     TAlignment  m_itemAlignment;
@@ -70,6 +98,22 @@ private: // data
     int         m_itemsWidth;
     int         m_itemsHeight;
 
+private: // scrolling (NOTE: items are moved only when needed)
+    int         m_paintedScrollOffsetX;
+    int         m_paintedScrollOffsetY;
+    int         m_itemsScrollOffsetX;
+    int         m_itemsScrollOffsetY;
+
+private: // virtual mode
+    IXListViewDataSource*       m_pDataSource;
+    XWFenwickTree               m_rowHeights;
+    std::vector<XGraphicsItem*> m_rowItems;
+    std::vector<XGraphicsItem*> m_rowItemsUpdate;
+    std::vector<XGraphicsItem*> m_recycledItems;
+    int                         m_firstRowItem;
+    int                         m_rowsWidth;
+    int                         m_nOverscanHeight;
+
 private: // content margins
     int         m_nMarginLeft;
     int         m_nMarginTop;
@@ -212,7 +212,7 @@ void XScrollViewItem::setScrollOffsetX(int scrollOffsetX)
     else
     {
         // scroll item
-        _doScrollItem(scrollOffsetX, 0);
+        _doScrollItem(scrollOffsetX, m_scrollOffsetY);
     }
 }
 
@@ -226,7 +226,7 @@ void XScrollViewItem::setScrollOffsetY(int scrollOffsetY)
     else
     {
         // scroll item
-        _doScrollItem(0, scrollOffsetY);
+        _doScrollItem(m_scrollOffsetX, scrollOffsetY);
     }
 }
 
@@ -312,6 +312,9 @@ bool XScrollViewItem::isFocusable() const
 /////////////////////////////////////////////////////////////////////
 void XScrollViewItem::onMouseEnter(int posX, int posY)
 {
+    // make sure scrolled item position is up to date
+    _syncScrollItemPosition();
+
     // check if mouse drag is enabled
     if(m_bMouseDragScrollEnabled)
     {
@@ -326,6 +329,9 @@ void XScrollViewItem::onMouseEnter(int posX, int posY)
 
 void XScrollViewItem::onMouseMove(int posX, int posY, WPARAM flags)
 {
+    // make sure scrolled item position is up to date
+    _syncScrollItemPosition();
+
     // check if mouse drag is enabled
     if(m_bMouseDragScrollEnabled)
     {
@@ -340,6 +346,9 @@ void XScrollViewItem::onMouseMove(int posX, int posY, WPARAM flags)
 
 bool XScrollViewItem::onMouseClick(UINT uButtonMsg, int posX, int posY, WPARAM flags)
 {
+    // make sure scrolled item position is up to date
+    _syncScrollItemPosition();
+
     // check if mouse drag is enabled
     if(m_bMouseDragScrollEnabled)
     {
@@ -412,6 +421,9 @@ bool XScrollViewItem::onCharEvent(WPARAM charCode, LPARAM flags)
 /////////////////////////////////////////////////////////////////////
 void XScrollViewItem::onPaintGDI(HDC hdc, const RECT& rcPaint)
 {
+    // make sure scrolled item position is up to date
+    _syncScrollItemPosition();
+
     // check if both scrollbars are active
     if(m_verticalScrollBar && m_verticalScrollBar->isVisible() &&
         m_horizontalScrollBar && m_horizontalScrollBar->isVisible())
@@ -433,6 +445,9 @@ void XScrollViewItem::onPaintGDI(HDC hdc, const RECT& rcPaint)
 /////////////////////////////////////////////////////////////////////
 void XScrollViewItem::onPaintD2D(ID2D1RenderTarget* pTarget, const RECT& rcPaint)
 {
+    // make sure scrolled item position is up to date
+    _syncScrollItemPosition();
+
     // check if both scrollbars are active
     if(m_verticalScrollBar->isVisible() && m_horizontalScrollBar->isVisible())
     {
@@ -588,12 +603,40 @@ void XScrollViewItem::_doScrollItem(int scrollOffsetX, int scrollOffsetY)
     // ignore if item is not set 
     if(m_scrollGraphicsItem == 0) return;
 
-    // update offset
-    XGraphicsItem::setScrollOffsetX(scrollOffsetX);
-    XGraphicsItem::setScrollOffsetY(scrollOffsetY);
+    // offset from already painted content
+    int offsetX = m_scrollOffsetX - scrollOffsetX;
+    int offsetY = m_scrollOffsetY - scrollOffsetY;
+
+    // ignore if not changed
+    if(offsetX == 0 && offsetY == 0) return;
+
+    // update offset (NOTE: scrollbars are not affected)
+    m_scrollOffsetX = scrollOffsetX;
+    m_scrollOffsetY = scrollOffsetY;
+
+    // visible area (without scrollbars)
+    RECT rcView = rect();
+    if(m_verticalScrollBar->isVisible()) rcView.right -= m_verticalScrollBar->width();
+    if(m_horizontalScrollBar->isVisible()) rcView.bottom -= m_horizontalScrollBar->height();
 
-    // scroll
-    m_scrollGraphicsItem->move(-scrollOffsetX, -scrollOffsetY);
+    // move painted content (only exposed area is repainted)
+    scrollRect(rcView, offsetX, offsetY);
+
+    // NOTE: item is moved in the same step as painted content, so item rectangles 
+    //       (and child windows attached to items) are never out of sync with screen
+    _syncScrollItemPosition();
+}
+
+void XScrollViewItem::_syncScrollItemPosition()
+{
+    // ignore if item is not set or scrolling itself
+    if(m_scrollGraphicsItem == 0 || m_scrollGraphicsItem->canScrollContent()) return;
+
+    // move item if needed
+    if(m_scrollGraphicsItem->rect().left != -m_scrollOffsetX || m_scrollGraphicsItem->rect().top != -m_scrollOffsetY)
+    {
+        m_scrollGraphicsItem->move(-m_scrollOffsetX, -m_scrollOffsetY);
+    }
 }
 
 // XScrollViewItem
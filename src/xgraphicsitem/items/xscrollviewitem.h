@@ -88,6 +88,7 @@ private: // events
 
 private: // worker methods
     void    _doScrollItem(int scrollOffsetX, int scrollOffsetY);
+    void    _syncScrollItemPosition();
 
 private: // data
     XGraphicsItem*      m_scrollGraphicsItem;
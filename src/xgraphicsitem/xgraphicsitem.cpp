@@ -5,15 +5,23 @@
 #include "../xwui_config.h"
 #include "../layout/xlayoutitem.h"
 #include "../layout/xlayout.h"
+#include "../layout/xlayoutsizesolver.h"
 #include "../layout/xvboxlayout.h"
 #include "../layout/xhboxlayout.h"
 
-#include "../ctrls/xpopupmenu.h"
-
 #include "../graphics/xwgraphics.h"
 
+#include "interfaces/ixgraphicsitemhost.h"
+
 #include "xgraphicsitem.h"
 
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// maximum number of layout passes done at once (layout may request new pass 
+// if item content size has been changed)
+#define XWUI_LAYOUT_MAX_PASSES          4
+
 /////////////////////////////////////////////////////////////////////
 // XGraphicsItem - graphics item
 
@@ -23,8 +31,14 @@ XGraphicsItem::XGraphicsItem(XGraphicsItem* parent) :
     m_fillBackground(false),
     m_pXGdiResourcesCache(0),
     m_pXD2DResourcesCache(0),
+    m_childItems(XWPoolAllocator<XGraphicsItem*>(XWObjectPool::current())),
+    m_itemAnimations(XWPoolAllocator<DWORD>(XWObjectPool::current())),
+    m_itemContentIds(XWPoolAllocator<DWORD>(XWObjectPool::current())),
     m_hwndParent(0),
+    m_pItemHost(0),
+    m_parentItem(0),
     m_pLayout(0),
+    m_layoutFlags(0),
     m_contextMenu(0),
     m_contextMenuEnabled(true),
     m_visible(true),
@@ -52,6 +66,9 @@ XGraphicsItem::XGraphicsItem(XGraphicsItem* parent) :
     m_itemRect.top = 0;
     m_itemRect.bottom = 0;
 
+    // empty layout statistics
+    resetLayoutStats();
+
     // init default painter type
     if(sXWUIDefaultPainter() == XWUI_PAINTER_D2D)
         m_graphicsPainter = XWUI_PAINTER_D2D;
@@ -73,15 +90,8 @@ XGraphicsItem::~XGraphicsItem()
     // delete layout if any
     delete m_pLayout;
 
-    // reset caches if any
-    onResetGDIResources();
-    onResetD2DTarget();
-
-    // release caches if any
-    if(m_pXGdiResourcesCache) 
-        m_pXGdiResourcesCache->Release();
-    if(m_pXD2DResourcesCache)
-        m_pXD2DResourcesCache->Release();
+    // reset and release caches if any
+    _releaseResourceCaches();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -98,61 +108,44 @@ void XGraphicsItem::setParentWindow(HWND hwndParent)
     m_hwndParent = hwndParent;
 
     // set also to child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // init
         (*it)->setParentWindow(hwndParent);
     }
+
+    // layout invalidated while detached has not been requested from window yet
+    if(m_parentItem == 0)
+    {
+        // pass requested from previous window (if any) will not be done
+        m_layoutFlags &= ~LAYOUT_FLAG_PASS_REQUESTED;
+
+        _requestPendingLayout();
+    }
 }
 
 /////////////////////////////////////////////////////////////////////
-// message processing
+// item host
 /////////////////////////////////////////////////////////////////////
-LRESULT XGraphicsItem::processWindowMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, bool& messageProcessed)
+void XGraphicsItem::setItemHost(IXGraphicsItemHost* itemHost)
 {
-    // reset flag by default
-    messageProcessed = false;
-
-    // ignore if processing is not needed
-    if(!m_messageProcessing) return 0;
+    m_pItemHost = itemHost;
 
-    // check message
-    switch(uMsg)
+    // set also to child items
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
-    // mouse messages
-    case WM_MOUSEMOVE:
-    case WM_MOUSEHOVER:
-    case WM_MOUSEWHEEL:
-    case WM_LBUTTONDOWN:
-    case WM_MBUTTONDOWN:
-    case WM_RBUTTONDOWN:
-    case WM_XBUTTONDOWN:
-    case WM_LBUTTONUP:
-    case WM_MBUTTONUP:
-    case WM_RBUTTONUP:
-    case WM_XBUTTONUP:
-    case WM_LBUTTONDBLCLK:
-    case WM_MBUTTONDBLCLK:
-    case WM_RBUTTONDBLCLK:
-    case WM_XBUTTONDBLCLK:
-        {
-            // find item for mouse event
-            XGraphicsItem* item = _findItem(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
-            if(item)
-            {
-                // pass to item
-                return item->processWindowMessage(hwnd, uMsg, wParam, lParam, messageProcessed);
-            }
-        }
-        break;
-
+        // init
+        (*it)->setItemHost(itemHost);
     }
 
-    // pass the rest to focused item if any
-    if(m_focusItem)
-        return m_focusItem->processWindowMessage(hwnd, uMsg, wParam, lParam, messageProcessed);
+    // layout invalidated while detached has not been requested from host yet
+    if(m_parentItem == 0)
+    {
+        // pass requested from previous host (if any) will not be done
+        m_layoutFlags &= ~LAYOUT_FLAG_PASS_REQUESTED;
 
-    return 0;
+        _requestPendingLayout();
+    }
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -173,6 +166,12 @@ void XGraphicsItem::setLayout(IXLayout* layout)
 
     // copy layout reference
     m_pLayout = layout;
+
+    // layout informs item about its changes
+    if(m_pLayout) m_pLayout->setParentLayoutItem(this);
+
+    // item size constraints depend on layout
+    invalidateResizePolicies();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -183,18 +182,16 @@ void XGraphicsItem::addChildItem(XGraphicsItem* childItem)
     XWASSERT(childItem);
     if(childItem == 0) return;
 
-    // check if we already have this item
-    if(_findItem(childItem->xwoid()) != 0)
-    {
-        // ignore if we already have this
-        return;
-    }
+    // ignore if we already have this item (NOTE: parent is checked, not searched from child items)
+    if(childItem->m_parentItem == this) return;
 
     // take ownership
     childItem->setParentObject(this);
+    childItem->m_parentItem = this;
 
-    // set same parent window
+    // set same parent window and host
     childItem->setParentWindow(m_hwndParent);
+    childItem->setItemHost(m_pItemHost);
 
     // set caches 
     childItem->setGDIResourcesCache(m_pXGdiResourcesCache);
@@ -206,25 +203,8 @@ void XGraphicsItem::addChildItem(XGraphicsItem* childItem)
         childItem->setPainterType(painterType());
     }
 
-    // init GDI resources if set
-    if(m_pXGdiResourcesCache && m_hwndParent)
-    {
-        // window DC
-        HDC hdc = ::GetDC(m_hwndParent);
-
-        // init resources
-        childItem->onInitGDIResources(hdc);
-
-        // release DC
-        ::ReleaseDC(m_hwndParent, hdc);
-    }
-
-    // init D2D resources if set
-    if(m_pXD2DResourcesCache && m_pXD2DResourcesCache->renderTarget())
-    {
-        // init resources
-        childItem->onInitD2DTarget(m_pXD2DResourcesCache->renderTarget());
-    }
+    // init GDI and D2D resources if set
+    _initChildResources(childItem);
 
     // add to list
     m_childItems.push_back(childItem);
@@ -235,12 +215,15 @@ void XGraphicsItem::addChildItem(XGraphicsItem* childItem)
         // set flag to parent as well
         m_messageProcessing = true;
     }
+
+    // NOTE: layout invalidated before item was attached has to be done by new parent
+    if(childItem->isLayoutPending()) childItem->invalidateParentLayout();
 }
 
 void XGraphicsItem::deleteChildItem(unsigned long itemId)
 {
     // find item
-    std::list<XGraphicsItem*>::iterator it = _findItemIt(itemId);
+    XGraphicsItemList::iterator it = _findItemIt(itemId);
     if(it != m_childItems.end())
     {
         // delete item (will trigger onChildObjectRemoved)
@@ -250,17 +233,40 @@ void XGraphicsItem::deleteChildItem(unsigned long itemId)
 
 void XGraphicsItem::deleteAllChildItems()
 {
-    // NOTE: deleting items will trigger onChildObjectRemoved that will properly clean
-    //       internal references. It will also remove item from m_childItems array. So
-    //       we make a copy and remove items one by one.
+    // NOTE: child items are detached all at once before they are deleted, so that 
+    //       deleting them doesn't search and remove each item from child lists (see
+    //       onChildObjectRemoved). Pooled items and their nodes return to pool.
+    if(m_childItems.size() == 0) return;
+
+    // take child items
+    XGraphicsItemList childItems(m_childItems.get_allocator());
+    childItems.swap(m_childItems);
 
-    // make a copy
-    std::list<XGraphicsItem*> childItems = m_childItems;
+    // reset item references
+    m_mouseItem = 0;
+    m_focusItem = 0;
+
+    for(XGraphicsItemList::iterator it = childItems.begin(); it != childItems.end(); ++it)
+    {
+        // reset parent references (object destructor will not remove item from parent)
+        (*it)->m_parentItem = 0;
+        (*it)->m_parentObject = 0;
+    }
+
+    // remove detached items from child objects in one pass
+    for(XWObjectList::iterator objIt = m_childObjects.begin(); objIt != m_childObjects.end();)
+    {
+        if((*objIt)->parentObject() != this)
+            objIt = m_childObjects.erase(objIt);
+        else
+            ++objIt;
+    }
 
-    // delete items one by one
-    for(std::list<XGraphicsItem*>::iterator it = childItems.begin(); it != childItems.end(); ++it)
+    // NOTE: deleted items remove themselves from layout, constraints are updated by next
+    //       layout pass. Last items are deleted first, so that layout removes them from back.
+    for(XGraphicsItemList::reverse_iterator rit = childItems.rbegin(); rit != childItems.rend(); ++rit)
     {
-        deleteChildItem((*it)->xwoid());
+        delete (*rit);
     }
 }
 
@@ -273,11 +279,11 @@ XGraphicsItem* XGraphicsItem::findChildItem(unsigned long itemId)
 XGraphicsItem* XGraphicsItem::findAnimationItem(DWORD animationId)
 {
     // check from item animations
-    std::vector<DWORD>::iterator it = std::find(m_itemAnimations.begin(), m_itemAnimations.end(), animationId);
+    XItemIdArray::iterator it = std::find(m_itemAnimations.begin(), m_itemAnimations.end(), animationId);
     if(it != m_itemAnimations.end()) return this;
 
     // check from child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         XGraphicsItem* item = (*it)->findAnimationItem(animationId);
         if(item != 0) return item;
@@ -290,11 +296,11 @@ XGraphicsItem* XGraphicsItem::findAnimationItem(DWORD animationId)
 XGraphicsItem* XGraphicsItem::findContentItem(DWORD contentId)
 {
     // check from item animations
-    std::vector<DWORD>::iterator it = std::find(m_itemContentIds.begin(), m_itemContentIds.end(), contentId);
+    XItemIdArray::iterator it = std::find(m_itemContentIds.begin(), m_itemContentIds.end(), contentId);
     if(it != m_itemContentIds.end()) return this;
 
     // check from child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         XGraphicsItem* item = (*it)->findContentItem(contentId);
         if(item != 0) return item;
@@ -323,7 +329,7 @@ void XGraphicsItem::moveItemOnTop(XGraphicsItem* childItem)
     // NOTE: last item added is top item, move this to the list end
 
     // find item
-    std::list<XGraphicsItem*>::iterator it = _findItemIt(childItem->xwoid());
+    XGraphicsItemList::iterator it = _findItemIt(childItem->xwoid());
 
     // ignore if item not found
     XWASSERT1(it != m_childItems.end(), "XGraphicsItem: child item not found by id, data might be corrupted");
@@ -350,14 +356,14 @@ void XGraphicsItem::moveItemUp(XGraphicsItem* childItem)
     }
 
     // find item
-    std::list<XGraphicsItem*>::iterator it = _findItemIt(childItem->xwoid());
+    XGraphicsItemList::iterator it = _findItemIt(childItem->xwoid());
 
     // ignore if item not found
     XWASSERT1(it != m_childItems.end(), "XGraphicsItem: child item not found by id, data might be corrupted");
     if(it == m_childItems.end()) return;
 
     // next item
-    std::list<XGraphicsItem*>::iterator nextIt = it;
+    XGraphicsItemList::iterator nextIt = it;
     ++nextIt;
 
     // check if there is item after this
@@ -382,7 +388,7 @@ void XGraphicsItem::moveItemDown(XGraphicsItem* childItem)
     }
 
     // find item
-    std::list<XGraphicsItem*>::iterator it = _findItemIt(childItem->xwoid());
+    XGraphicsItemList::iterator it = _findItemIt(childItem->xwoid());
 
     // ignore if item not found
     XWASSERT1(it != m_childItems.end(), "XGraphicsItem: child item not found by id, data might be corrupted");
@@ -392,7 +398,7 @@ void XGraphicsItem::moveItemDown(XGraphicsItem* childItem)
     if(it != m_childItems.begin())
     {
         // previous item
-        std::list<XGraphicsItem*>::iterator prevIt = it;
+        XGraphicsItemList::iterator prevIt = it;
         --prevIt;
 
         // swap items
@@ -450,7 +456,7 @@ void XGraphicsItem::move(int posX, int posY)
     m_itemRect.bottom += offsetY;
 
     // move child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         (*it)->move((*it)->rect().left + offsetX, (*it)->rect().top + offsetY);
     }
@@ -461,6 +467,9 @@ void XGraphicsItem::move(int posX, int posY)
 /////////////////////////////////////////////////////////////////////
 void XGraphicsItem::update(int posX, int posY, int width, int height)
 {
+    // item is laid out
+    m_layoutFlags &= ~LAYOUT_FLAG_DIRTY;
+
     // copy new size
     m_itemRect.left = posX;
     m_itemRect.top = posY;
@@ -486,7 +495,7 @@ void XGraphicsItem::setMouseCursor(HCURSOR cursor)
     // set previous cursor if any
     if(m_originalCursor)
     {
-        ::SetCursor(m_originalCursor);
+        _setCursor(m_originalCursor);
         m_originalCursor = 0;
     }
 
@@ -496,7 +505,7 @@ void XGraphicsItem::setMouseCursor(HCURSOR cursor)
     // set new cursor
     if(m_itemCursor)
     {
-        m_originalCursor = ::SetCursor(m_itemCursor);
+        m_originalCursor = _setCursor(m_itemCursor);
     }
 }
 
@@ -505,7 +514,7 @@ void XGraphicsItem::resetMouseCursor()
     // set previous cursor if any
     if(m_originalCursor)
     {
-        ::SetCursor(m_originalCursor);
+        _setCursor(m_originalCursor);
     }
 
     // reset cursors
@@ -518,11 +527,19 @@ void XGraphicsItem::resetMouseCursor()
 /////////////////////////////////////////////////////////////////////
 void XGraphicsItem::setMouseCapture()
 {
-    // send message to parent window if set
-    if(m_hwndParent)
+    // pass to item host if set
+    if(m_pItemHost)
+    {
+        // route all mouse traffic to this item
+        m_pItemHost->setMouseCapture(this);
+
+        // set state flag
+        setStateFlag(STATE_FLAG_MOUSECAPTURE, true);
+
+    } else if(m_hwndParent)
     {
         // inform parent window to start mouse capture and route all mouse traffic to this item
-        ::SendMessageW(m_hwndParent, WM_XWUI_GITEM_SET_MOUSE_CAPTURE, xwoid(), 0); 
+        _sendWindowMessage(WM_XWUI_GITEM_SET_MOUSE_CAPTURE, xwoid(), 0); 
 
         // set state flag
         setStateFlag(STATE_FLAG_MOUSECAPTURE, true);
@@ -531,11 +548,19 @@ void XGraphicsItem::setMouseCapture()
 
 void XGraphicsItem::resetMouseCapture()
 {
-    // send message to parent window if set
-    if(m_hwndParent)
+    // pass to item host if set
+    if(m_pItemHost)
+    {
+        // stop mouse capture
+        m_pItemHost->resetMouseCapture();
+
+        // reset state flag
+        setStateFlag(STATE_FLAG_MOUSECAPTURE, false);
+
+    } else if(m_hwndParent)
     {
         // inform parent window to stop mouse capture
-        ::SendMessageW(m_hwndParent, WM_XWUI_GITEM_RESET_MOUSE_CAPTURE, 0, 0); 
+        _sendWindowMessage(WM_XWUI_GITEM_RESET_MOUSE_CAPTURE, 0, 0); 
         
         // reset state flag
         setStateFlag(STATE_FLAG_MOUSECAPTURE, false);
@@ -556,30 +581,70 @@ void XGraphicsItem::setHintText(const wchar_t* text)
 /////////////////////////////////////////////////////////////////////
 // context menu
 /////////////////////////////////////////////////////////////////////
-void XGraphicsItem::setContextMenu(XPopupMenu* contextMenu)
+void XGraphicsItem::enableContextMenu(bool enable)
+{
+    m_contextMenuEnabled = enable;
+}
+
+XPopupMenu* XGraphicsItem::contextMenu()
+{
+    return m_contextMenu;
+}
+
+/////////////////////////////////////////////////////////////////////
+// deferred layout
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::invalidateLayout()
 {
-    // delete old menu if any
-    if(m_contextMenu) delete m_contextMenu;
+    // update statistics
+    _rootItem()->m_layoutStats.invalidations++;
+
+    // item has to be laid out
+    m_layoutFlags |= LAYOUT_FLAG_DIRTY;
 
-    // copy menu (may be null)
-    m_contextMenu = contextMenu;
+    // parent items as well
+    invalidateParentLayout();
+}
+
+void XGraphicsItem::flushLayout()
+{
+    // NOTE: statistics are kept by root item, pass may be started from any item
+    XLayoutStats& stats = _rootItem()->m_layoutStats;
 
-    // init menu
-    if(m_contextMenu)
+    // update statistics
+    stats.passes++;
+
+    // NOTE: layout may change item content size and request layout again (e.g. list
+    //       view informs scroll view about new height), such requests are handled
+    //       in the same pass, but number of iterations is limited 
+    for(int pass = 0; pass < XWUI_LAYOUT_MAX_PASSES && isLayoutPending(); ++pass)
     {
-        // update parent object
-        m_contextMenu->setParentObject(this);
+        _flushLayout(stats);
     }
+
+    // new layout pass can be requested
+    m_layoutFlags &= ~LAYOUT_FLAG_PASS_REQUESTED;
 }
 
-void XGraphicsItem::enableContextMenu(bool enable)
+void XGraphicsItem::getLayoutStats(XLayoutStats& statsOut)
 {
-    m_contextMenuEnabled = enable;
+    // copy statistics of item tree
+    const XLayoutStats& stats = _rootItem()->m_layoutStats;
+    statsOut = stats;
+
+    // requests handled by the same layout
+    statsOut.avoidedRelayouts = (stats.invalidations > stats.relayouts) ?
+        stats.invalidations - stats.relayouts : 0;
 }
 
-XPopupMenu* XGraphicsItem::contextMenu()
+void XGraphicsItem::resetLayoutStats()
 {
-    return m_contextMenu;
+    // reset statistics of item tree
+    XLayoutStats& stats = _rootItem()->m_layoutStats;
+    stats.invalidations = 0;
+    stats.passes = 0;
+    stats.relayouts = 0;
+    stats.avoidedRelayouts = 0;
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -587,16 +652,14 @@ XPopupMenu* XGraphicsItem::contextMenu()
 /////////////////////////////////////////////////////////////////////
 void XGraphicsItem::handleContentChanged()
 {
-    // post message to parent window if set
-    if(m_hwndParent)
-    {
-        // NOTE: post message here, not send, as this will cause parent window
-        //       to update graphics item in order for layout to re-position children
-        //       and possible scrollbars to update size (or show/hide)
+    // NOTE: layout is not updated immediately, parent window will do layout pass
+    //       for all items changed during current frame at once
 
-        // inform parent that item content has changed
-        ::PostMessageW(m_hwndParent, WM_XWUI_GITEM_CONTENT_CHANGED, 0, 0); 
-    }
+    // content may change size constraints
+    invalidateResizePolicies();
+
+    // request layout
+    invalidateLayout();
 }
 
 int XGraphicsItem::contentWidthForHeight(int height)
@@ -627,7 +690,7 @@ int XGraphicsItem::contentWidth()
         // compute content width from child items
         int leftPos = 0;
         int rightPos = 0;
-        for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); 
+        for(XGraphicsItemList::iterator it = m_childItems.begin(); 
             it != m_childItems.end(); ++it)
         {
             // update top left position
@@ -657,7 +720,7 @@ int XGraphicsItem::contentHeight()
         int topPos = 0;
         int bottomPos = 0;
         int itemHeight = 0;
-        for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); 
+        for(XGraphicsItemList::iterator it = m_childItems.begin(); 
             it != m_childItems.end(); ++it)
         {
             // update top position
@@ -698,14 +761,14 @@ void XGraphicsItem::setScrollOffsetX(int scrollOffsetX)
     } else
     {
         // move child items
-        for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+        for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
         {
             (*it)->move((*it)->rect().left - scrollOffsetX, (*it)->rect().top);
         }
     }
 
-    // force repaint during scrolling
-    repaint(true);
+    // repaint (coalesced with other changes in the same frame)
+    repaint();
 }
 
 void XGraphicsItem::setScrollOffsetY(int scrollOffsetY)
@@ -725,14 +788,14 @@ void XGraphicsItem::setScrollOffsetY(int scrollOffsetY)
     } else
     {
         // move child items
-        for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+        for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
         {
             (*it)->move((*it)->rect().left, (*it)->rect().top - scrollOffsetY);
         }
     }
 
-    // force repaint during scrolling
-    repaint(true);
+    // repaint (coalesced with other changes in the same frame)
+    repaint();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -750,7 +813,7 @@ void XGraphicsItem::setEnabled(bool bEnabled)
     setStateFlag(STATE_FLAG_DISABLED, !bEnabled);
 
     // set also to child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // init
         (*it)->setStateFlag(STATE_FLAG_DISABLED, !bEnabled);
@@ -772,6 +835,9 @@ void XGraphicsItem::setVisible(bool bVisible)
 
     // copy flag
     m_visible = bVisible;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XGraphicsItem::setObscured(bool bObscured)
@@ -795,7 +861,7 @@ void XGraphicsItem::setObscured(bool bObscured)
     m_obscured = bObscured;
 
     // set also to child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // init
         (*it)->setObscured(bObscured);
@@ -826,7 +892,7 @@ void XGraphicsItem::setPainterType(XWUIGraphicsPainter type)
     m_graphicsPainter = (type != XWUI_PAINTER_AUTOMATIC) ? type : sXWUIDefaultPainter();
 
     // set also to child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // init
         (*it)->setPainterType(type);
@@ -842,7 +908,7 @@ bool XGraphicsItem::isFocusable() const
     if(!isVisible() || !isEnabled()) return false;
 
     // check if any child item is focusable
-    for(std::list<XGraphicsItem*>::const_iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::const_iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // check item
         if((*it)->isFocusable()) return true;
@@ -905,10 +971,10 @@ void XGraphicsItem::onMouseEnter(int posX, int posY)
     {
         // reset original cursor if any
         if(m_originalCursor)
-            ::SetCursor(m_originalCursor);
+            _setCursor(m_originalCursor);
 
         // set new cursor
-        m_originalCursor = ::SetCursor(m_itemCursor);
+        m_originalCursor = _setCursor(m_itemCursor);
     }
 
     // update style property
@@ -968,7 +1034,10 @@ bool XGraphicsItem::onMouseHover(int posX, int posY)
     if(m_hintText.length() > 0)
     {
         // show tooltip
-        ::SendMessageW(m_hwndParent, WM_XWUI_GITEM_SHOW_TOOLTIP, 0, (LPARAM)m_hintText.c_str()); 
+        if(m_pItemHost)
+            m_pItemHost->showTooltip(m_hintText.c_str());
+        else
+            _sendWindowMessage(WM_XWUI_GITEM_SHOW_TOOLTIP, 0, (LPARAM)m_hintText.c_str()); 
 
         // mark as consumed
         return true;
@@ -1060,7 +1129,7 @@ void XGraphicsItem::onMouseLeave()
     // reset cursor if needed
     if(m_originalCursor)
     {
-        ::SetCursor(m_originalCursor);
+        _setCursor(m_originalCursor);
         m_originalCursor = 0;
     }
 
@@ -1126,7 +1195,10 @@ bool XGraphicsItem::onContextMenu(int posX, int posY)
     if(m_contextMenuEnabled && m_contextMenu)
     {
         // show context menu
-        ::SendMessageW(m_hwndParent, WM_XWUI_GITEM_SHOW_CONTEXT_MENU, xwoid(), MAKELPARAM(posX, posY)); 
+        if(m_pItemHost)
+            m_pItemHost->showContextMenu(this, posX, posY);
+        else
+            _sendWindowMessage(WM_XWUI_GITEM_SHOW_CONTEXT_MENU, xwoid(), MAKELPARAM(posX, posY)); 
 
         // mark as consumed
         return true;
@@ -1203,7 +1275,7 @@ void XGraphicsItem::onBroadcastEvent(LPARAM param)
     onItemEvent(param);
 
     // pass to all child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); 
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); 
         it != m_childItems.end(); ++it)
     {
         (*it)->onBroadcastEvent(param);
@@ -1226,7 +1298,7 @@ void XGraphicsItem::onAnimationValue(DWORD id, float value)
 void XGraphicsItem::onAnimationCompleted(DWORD id)
 {
     // find from animations
-    std::vector<DWORD>::iterator it = std::find(m_itemAnimations.begin(), m_itemAnimations.end(), id);
+    XItemIdArray::iterator it = std::find(m_itemAnimations.begin(), m_itemAnimations.end(), id);
     if(it != m_itemAnimations.end())
     {
         // remove from list
@@ -1250,7 +1322,7 @@ void XGraphicsItem::onUrlContentLoadFailed(DWORD id, DWORD reason)
 void XGraphicsItem::onUrlContentCompleted(DWORD id)
 {
     // find from conten ids
-    std::vector<DWORD>::iterator it = std::find(m_itemContentIds.begin(), m_itemContentIds.end(), id);
+    XItemIdArray::iterator it = std::find(m_itemContentIds.begin(), m_itemContentIds.end(), id);
     if(it != m_itemContentIds.end())
     {
         // remove from list
@@ -1288,7 +1360,7 @@ void XGraphicsItem::onPaintGDI(HDC hdc, const RECT& rcPaint)
     }
 
     // paint child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // ignore not visible items
         if(!(*it)->isVisible()) continue;
@@ -1304,182 +1376,6 @@ void XGraphicsItem::onPaintGDI(HDC hdc, const RECT& rcPaint)
     }
 }
 
-/////////////////////////////////////////////////////////////////////
-// GDI resource caching
-/////////////////////////////////////////////////////////////////////
-void XGraphicsItem::onInitGDIResources(HDC hdc)
-{
-    // release previous resources if any
-    onResetGDIResources();
-
-    // make sure we always have GDI cache
-    _checkGdiCacheReady(hdc);
-
-    // init resources for child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
-    {
-        // init
-        (*it)->onInitGDIResources(hdc);
-    }
-}
-
-void XGraphicsItem::onResetGDIResources()
-{
-    // reset cache for child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
-    {
-        // reset
-        (*it)->onResetGDIResources();
-    }
-}
-
-void XGraphicsItem::setGDIResourcesCache(XGdiResourcesCache* pXGdiResourcesCache)
-{
-    // release previous instance if any
-    if(m_pXGdiResourcesCache)
-    {
-        // reset resources as they might be using cache
-        onResetGDIResources();
-
-        // release
-        m_pXGdiResourcesCache->Release();
-    }
-
-    // copy reference
-    m_pXGdiResourcesCache = pXGdiResourcesCache;
-
-    // add reference if needed
-    if(m_pXGdiResourcesCache)
-        m_pXGdiResourcesCache->AddRef();
-
-    // set cache for child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
-    {
-        // set
-        (*it)->setGDIResourcesCache(m_pXGdiResourcesCache);
-    }
-}
-
-/////////////////////////////////////////////////////////////////////
-// Direct2D painting
-/////////////////////////////////////////////////////////////////////
-void XGraphicsItem::onPaintD2D(ID2D1RenderTarget* pTarget, const RECT& rcPaint)
-{
-    // ignore if not visible
-    if(!isVisible()) return;
-
-    // convert rect
-    D2D1_RECT_F d2dRect;
-    XD2DHelpers::gdiRectToD2dRect(rcPaint, d2dRect);
-
-    // NOTE: do not clip regions here as some items may use GDI ineroperability
-
-    // Quote from MSDN: http://msdn.microsoft.com/en-us/library/windows/desktop/dd371323(v=vs.85).aspx
-    // "Note  In Windows 7 and earlier, you should not call GetDC between PushAxisAlignedClip/PopAxisAlignedClip commands 
-    //  or between PushLayer/PopLayer. However, this restriction does not apply to Windows 8 and later."
-
-    // NOTE: do not clip region
-    //  pTarget->PushAxisAlignedClip(d2dRect, D2D1_ANTIALIAS_MODE_ALIASED);
-
-    // fill background first if needed
-    if(m_fillBackground)
-    {
-        // convert color
-        D2D1_COLOR_F d2dBackgroundFillColor;
-        XD2DHelpers::colorrefToD2dColor(m_bgColor, d2dBackgroundFillColor);
-
-        // get brush from cache and fill
-        ID2D1Brush* backgroundFillBrush = createD2DBrush(pTarget, d2dBackgroundFillColor);
-        if(backgroundFillBrush)
-        {
-            pTarget->FillRectangle(d2dRect, backgroundFillBrush);
-            backgroundFillBrush->Release();
-        }
-    }
-
-    // paint child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
-    {
-        // ignore not visible items
-        if(!(*it)->isVisible()) continue;
-
-        // compute paint rectangle for item
-        RECT rcItemPaint;
-
-        // ignore if update rectangle doesn't overlap
-        if(!XWUtils::rectIntersect((*it)->rect(), rcPaint, rcItemPaint)) continue;
-
-        // paint
-        (*it)->onPaintD2D(pTarget, rcItemPaint);
-    }
-
-    // NOTE: do not clip
-    // pTarget->PopAxisAlignedClip();
-}
-
-/////////////////////////////////////////////////////////////////////
-// Direct2D resource caching
-/////////////////////////////////////////////////////////////////////
-void XGraphicsItem::onInitD2DTarget(ID2D1RenderTarget* pTarget)
-{
-    // reset previous target if any
-    onResetD2DTarget();
-
-    // make sure we always have D2D cache
-    _checkD2DCacheReady(pTarget);
-
-    // init target for child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
-    {
-        // init
-        (*it)->onInitD2DTarget(pTarget);
-    }
-}
-
-void XGraphicsItem::onResetD2DTarget()
-{
-    // reset target for child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
-    {
-        // reset
-        (*it)->onResetD2DTarget();
-    }
-
-    // release GDI render target if any
-    if(m_pGDIRenderTarget) 
-    { 
-        m_pGDIRenderTarget->Release();
-        m_pGDIRenderTarget = 0;
-    }
-}
-
-void XGraphicsItem::setD2DResourcesCache(XD2DResourcesCache* pXD2DResourcesCache)
-{
-    // release previous instance if any
-    if(m_pXD2DResourcesCache)
-    {
-        // reset previous resources
-        onResetD2DTarget();
-
-        // release cache
-        m_pXD2DResourcesCache->Release();
-    }
-
-    // copy reference
-    m_pXD2DResourcesCache = pXD2DResourcesCache;
-
-    // add reference if needed
-    if(m_pXD2DResourcesCache)
-        m_pXD2DResourcesCache->AddRef();
-
-    // init cache for child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
-    {
-        // init
-        (*it)->setD2DResourcesCache(m_pXD2DResourcesCache);
-    }
-}
-
 /////////////////////////////////////////////////////////////////////
 // item state
 /////////////////////////////////////////////////////////////////////
@@ -1518,60 +1414,42 @@ void XGraphicsItem::repaint(bool paintNow)
 
 void XGraphicsItem::repaint(const RECT& rcPaint, bool paintNow)
 {
+    // NOTE: item host decides itself when area is painted
+    if(m_pItemHost)
+    {
+        m_pItemHost->repaintRect(rcPaint, paintNow);
+        return;
+    }
+
     // ignore if parent is not set
     if(m_hwndParent == 0) return;
 
-    bool paintDone = false;
+    // repaint using parent window
+    _repaintWindow(rcPaint, paintNow);
+}
 
-    // check if we need to repaint immediately
-    if(paintNow)
-    {
-        // check painter type
-        if(painterType() == XWUI_PAINTER_GDI)
-        {
-            // repaint
-            HDC hdc = ::GetDC(m_hwndParent);
-            onPaintGDI(hdc, m_itemRect);
-            ::ReleaseDC(m_hwndParent, hdc);
+void XGraphicsItem::scrollRect(const RECT& rcScroll, int offsetX, int offsetY)
+{
+    // ignore if parent is not set or not visible
+    if((m_hwndParent == 0 && m_pItemHost == 0) || !isVisible()) return;
 
-            // mark flag
-            paintDone = true;
+    // ignore if nothing has been moved
+    if(offsetX == 0 && offsetY == 0) return;
 
-        } else if(painterType() == XWUI_PAINTER_D2D)
+    // check if any painted content is still visible after scrolling
+    if(abs(offsetX) < rcScroll.right - rcScroll.left && abs(offsetY) < rcScroll.bottom - rcScroll.top)
+    {
+        // NOTE: parent window moves painted content and repaints only exposed area
+        if(m_pItemHost)
         {
-            // check if we have target set already
-            if(m_pXD2DResourcesCache->renderTarget() != 0)
-            {
-                // repaint
-                m_pXD2DResourcesCache->renderTarget()->BeginDraw();
-                onPaintD2D(m_pXD2DResourcesCache->renderTarget(), m_itemRect);
-                m_pXD2DResourcesCache->renderTarget()->EndDraw();
-
-                // mark flag
-                paintDone = true;
-            }
-        }
-    }
+            if(m_pItemHost->scrollRect(rcScroll, offsetX, offsetY)) return;
 
-    // inform parent window that repaint is needed
-    if(!paintDone)
-    {
-        ::InvalidateRect(m_hwndParent, &rcPaint, FALSE);
+        } else if(_sendWindowMessage(WM_XWUI_GITEM_SCROLL_RECT, 
+            MAKEWPARAM((WORD)(short)offsetX, (WORD)(short)offsetY), (LPARAM)&rcScroll) == TRUE) return;
     }
-}
 
-void XGraphicsItem::repaint(HRGN hrgn)
-{
-    XWASSERT(hrgn);
-    if(hrgn == 0) return;
-
-    RECT rcPaint;
-
-    // get bounding rectangle
-    ::GetRgnBox(hrgn, &rcPaint);
-    
-    // repaint area
-    repaint(rcPaint);
+    // repaint whole area
+    repaint(rcScroll);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -1586,6 +1464,9 @@ void XGraphicsItem::setMinWidth(int minWidth)
 
     // update policy
     m_rpHorizontal = (m_rpHorizontal == eResizeMax) ? eResizeMinMax : eResizeMin;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XGraphicsItem::setMinHeight(int minHeight)
@@ -1597,6 +1478,9 @@ void XGraphicsItem::setMinHeight(int minHeight)
 
     // update policy
     m_rpVertical = (m_rpVertical == eResizeMax) ? eResizeMinMax : eResizeMin;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XGraphicsItem::setMaxWidth(int maxWidth)
@@ -1608,6 +1492,9 @@ void XGraphicsItem::setMaxWidth(int maxWidth)
 
     // update policy
     m_rpHorizontal = (m_rpHorizontal == eResizeMin) ? eResizeMinMax : eResizeMax;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XGraphicsItem::setMaxHeight(int maxHeight)
@@ -1619,6 +1506,9 @@ void XGraphicsItem::setMaxHeight(int maxHeight)
 
     // update policy
     m_rpVertical = (m_rpVertical == eResizeMin) ? eResizeMinMax : eResizeMax;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -1634,6 +1524,9 @@ void XGraphicsItem::setFixedWidth(int width)
 
     // update policy
     m_rpHorizontal = eResizeMinMax;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XGraphicsItem::setFixedHeight(int height)
@@ -1646,6 +1539,9 @@ void XGraphicsItem::setFixedHeight(int height)
 
     // update policy
     m_rpVertical = eResizeMinMax;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XGraphicsItem::setFixedSize(int width, int height)
@@ -1662,6 +1558,9 @@ void XGraphicsItem::setFixedSize(int width, int height)
     // update policy
     m_rpHorizontal = eResizeMinMax;
     m_rpVertical = eResizeMinMax;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -1671,6 +1570,9 @@ void XGraphicsItem::resetSizePolicy()
 {
     m_rpHorizontal = eResizeAny;
     m_rpVertical = eResizeAny;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -1709,6 +1611,18 @@ void XGraphicsItem::updateResizePolicies()
     }
 }
 
+/////////////////////////////////////////////////////////////////////
+// constraints change notification (from IXLayoutItem)
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::resetResizePolicies()
+{
+    // pass to layout if set
+    if(m_pLayout)
+    {
+        m_pLayout->resetResizePolicies();
+    }
+}
+
 /////////////////////////////////////////////////////////////////////
 // size constraints (from IXLayoutItem)
 /////////////////////////////////////////////////////////////////////
@@ -1787,247 +1701,86 @@ void XGraphicsItem::clearBackgroundFill()
 /////////////////////////////////////////////////////////////////////
 // enable default content scrolling
 /////////////////////////////////////////////////////////////////////
-void XGraphicsItem::enableContentScrolling(bool bEnable)
-{
-    // copy flag
-    m_scrollingEnabled = bEnable;
-}
-
-/////////////////////////////////////////////////////////////////////
-// timer methods
-/////////////////////////////////////////////////////////////////////
-bool XGraphicsItem::startTimer(UINT uElapseMs)
-{
-    // ignore if window not set
-    if(m_hwndParent == 0) return false;
-
-    if(::SetTimer(m_hwndParent, xwoid(), uElapseMs, 0) == 0)
-    {
-        XWTRACE_WERR_LAST("XGraphicsItem: failed to start timer");
-        return false;
-    }
-
-    return true;
-}
-
-bool XGraphicsItem::stopTimer()
-{
-    // ignore if window not set
-    if(m_hwndParent == 0) return false;
-
-    if(::KillTimer(m_hwndParent, xwoid()) == 0)
-    {
-        XWTRACE_WERR_LAST("XGraphicsItem: failed to stop timer");
-        return false;
-    }
-
-    return true;
-}
-
-/////////////////////////////////////////////////////////////////////
-// animation methods
-/////////////////////////////////////////////////////////////////////
-bool XGraphicsItem::startTimerAnimation(UINT intervalMs, DWORD& idOut)
+void XGraphicsItem::invalidateParentLayout()
 {
-    // ignore if window not set
-    XWASSERT(m_hwndParent);
-    if(m_hwndParent == 0) return false;
+    // NOTE: parent positions item and has to be laid out as well, if parent size
+    //       constraints depend on its child items the same applies to its parent
+    bool layoutParent = true;
 
-    // remove not active animations just in case
-    validateAnimations();
-
-    // start animation
-    if(XWAnimationTimer::instance()->startTimerAnimation(intervalMs, m_hwndParent, idOut))
+    // mark parent items
+    XGraphicsItem* item = this;
+    while(item->m_parentItem)
     {
-        // add to item animations
-        m_itemAnimations.push_back(idOut);
+        XGraphicsItem* parent = item->m_parentItem;
 
-        return true;
-    }
-
-    return false;
-}
-
-bool XGraphicsItem::startValueAnimation(UINT intervalMs, const XWAnimationTimer::ValueAnimation& animation, DWORD& idOut)
-{
-    // ignore if window not set
-    XWASSERT(m_hwndParent);
-    if(m_hwndParent == 0) return false;
-
-    // remove not active animations just in case
-    validateAnimations();
+        // layout parent if needed
+        if(layoutParent)
+        {
+            parent->m_layoutFlags |= LAYOUT_FLAG_DIRTY;
+            layoutParent = parent->_layoutDependsOnChildren();
+        }
 
-    // start animation
-    if(XWAnimationTimer::instance()->startValueAnimation(intervalMs, animation, m_hwndParent, idOut))
-    {
-        // add to item animations
-        m_itemAnimations.push_back(idOut);
+        // path to changed item
+        parent->m_layoutFlags |= LAYOUT_FLAG_CHILD_DIRTY;
 
-        return true;
+        // next parent
+        item = parent;
     }
 
-    return false;
-}
-
-void XGraphicsItem::stopAnimation(DWORD id)
-{
-    // find from animations
-    std::vector<DWORD>::iterator it = std::find(m_itemAnimations.begin(), m_itemAnimations.end(), id);
-
-    // check if found
-    XWASSERT1(it != m_itemAnimations.end(), "XGraphicsItem: trying to stop uknown animation");
-    if(it == m_itemAnimations.end()) return;
-
-    // stop animation
-    XWAnimationTimer::instance()->stopAnimation(id);
-
-    // remove from list
-    m_itemAnimations.erase(it);
-}
-
-void XGraphicsItem::validateAnimations()
-{
-    // loop over all animations
-    for(std::vector<DWORD>::iterator it = m_itemAnimations.begin();
-        it != m_itemAnimations.end();)
+    // request layout pass from item host if set
+    if(item->m_pItemHost && (item->m_layoutFlags & LAYOUT_FLAG_PASS_REQUESTED) == 0)
     {
-        // check if still exists
-        if(XWAnimationTimer::instance()->hasAnimation(*it))
+        // NOTE: host must call flushLayout later, same as parent window does
+        if(item->m_pItemHost->requestLayout())
         {
-            // next
-            ++it;
-
-        } else
-        {
-            XWASSERT1(0, "XGraphicsItem: item contains not active animation");
-
-            // remove
-            it = m_itemAnimations.erase(it);
+            item->m_layoutFlags |= LAYOUT_FLAG_PASS_REQUESTED;
         }
-    }
-}
 
-void XGraphicsItem::pauseAnimations()
-{
-    // loop over all animations
-    for(std::vector<DWORD>::iterator it = m_itemAnimations.begin(); 
-        it != m_itemAnimations.end(); ++it)
+    } else if(item->m_hwndParent && (item->m_layoutFlags & LAYOUT_FLAG_PASS_REQUESTED) == 0)
     {
-        XWAnimationTimer::instance()->pauseAnimation(*it);
-    }
-}
+        // request layout pass from parent window if not done yet
 
-void XGraphicsItem::resumeAnimations()
-{
-    // ingore if item is not visible or obscured
-    if(!m_visible || m_obscured) return;
+        // NOTE: post message here, not send, as this will cause parent window
+        //       to update graphics item in order for layout to re-position children
+        //       and possible scrollbars to update size (or show/hide)
 
-    // loop over all animations
-    for(std::vector<DWORD>::iterator it = m_itemAnimations.begin(); 
-        it != m_itemAnimations.end(); ++it)
-    {
-        XWAnimationTimer::instance()->resumeAnimation(*it);
+        // inform parent that item content has changed
+        if(item->_postWindowMessage(WM_XWUI_GITEM_CONTENT_CHANGED, 0, 0))
+        {
+            item->m_layoutFlags |= LAYOUT_FLAG_PASS_REQUESTED;
+        }
     }
 }
 
-void XGraphicsItem::stopAllAnimations()
+void XGraphicsItem::enableContentScrolling(bool bEnable)
 {
-    // loop over all animations
-    for(std::vector<DWORD>::iterator it = m_itemAnimations.begin();
-        it != m_itemAnimations.end(); ++it)
-    {
-        // stop animation
-        XWAnimationTimer::instance()->stopAnimation(*it);
-    }
-
-    // reset list
-    m_itemAnimations.clear();
+    // copy flag
+    m_scrollingEnabled = bEnable;
 }
 
 /////////////////////////////////////////////////////////////////////
-// content loading
+// timer methods
 /////////////////////////////////////////////////////////////////////
-bool XGraphicsItem::isUrlContentLoaded(const WCHAR* url, XMediaSource& srcOut)
-{
-    // check from content provider
-    return XWContentProvider::instance()->isUrlContentLoaded(url, srcOut);
-}
-
-bool XGraphicsItem::loadUrlContent(const WCHAR* url, DWORD& idOut)
-{
-    // start loading
-    if(XWContentProvider::instance()->loadUrlContent(url, m_hwndParent, idOut))
-    {
-        m_itemContentIds.push_back(idOut);
-        return true;
-    }
-
-    return false;
-}
-
-void XGraphicsItem::cancelContentLoad(DWORD id)
+bool XGraphicsItem::startTimer(UINT uElapseMs)
 {
-    // find content id
-    std::vector<DWORD>::iterator it = std::find(m_itemContentIds.begin(), m_itemContentIds.end(), id);
+    // pass to item host if set
+    if(m_pItemHost) return m_pItemHost->startTimer(this, uElapseMs);
 
-    // check if found
-    XWASSERT1(it != m_itemContentIds.end(), "XGraphicsItem: trying to cancel uknown content");
-    if(it == m_itemContentIds.end()) return;
-
-    // cancel 
-    XWContentProvider::instance()->cancelContentLoad(id);
-
-    // remove from list
-    m_itemContentIds.erase(it);
-}
-
-void XGraphicsItem::cancelAllContent()
-{
-    // loop over all content ids
-    for(std::vector<DWORD>::iterator it = m_itemContentIds.begin();
-        it != m_itemContentIds.end(); ++it)
-    {
-        // cancel loading
-        XWContentProvider::instance()->cancelContentLoad(*it);
-    }
+    // ignore if window not set
+    if(m_hwndParent == 0) return false;
 
-    // reset list
-    m_itemContentIds.clear();
+    return _setWindowTimer(uElapseMs);
 }
 
-/////////////////////////////////////////////////////////////////////
-// helper methods
-/////////////////////////////////////////////////////////////////////
-void XGraphicsItem::onPaintD2DFromGDI(ID2D1RenderTarget* pTarget, const RECT& rcPaint)
+bool XGraphicsItem::stopTimer()
 {
-    // NOTE: create GDI target only if this method is called
-    if(m_pGDIRenderTarget == 0)
-    {
-        // get GDI render target (NOTE: ignore return code)
-        pTarget->QueryInterface(__uuidof(ID2D1GdiInteropRenderTarget), (void**)&m_pGDIRenderTarget);
-    }
+    // pass to item host if set
+    if(m_pItemHost) return m_pItemHost->stopTimer(this);
 
-    // render using GDI
-    if(m_pGDIRenderTarget) 
-    { 
-        // init render target
-        HDC hdc = 0;
-        HRESULT hr = m_pGDIRenderTarget->GetDC(D2D1_DC_INITIALIZE_MODE_COPY, &hdc);
-
-        // render item using GDI method
-        if(SUCCEEDED(hr))
-        {
-            // render item 
-            onPaintGDI(hdc, rcPaint);
-
-            // reset render target
-            m_pGDIRenderTarget->ReleaseDC(NULL);
+    // ignore if window not set
+    if(m_hwndParent == 0) return false;
 
-        } else
-        {
-            XWTRACE_HRES("XGraphicsItem: failed to get DC for GDI compatible paint", hr);
-        }
-    }
+    return _killWindowTimer();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -2051,162 +1804,6 @@ void XGraphicsItem::setFocusProperty(bool hasFocus)
     setStateFlag(STATE_FLAG_FOCUSED, hasFocus);
 }
 
-/////////////////////////////////////////////////////////////////////
-// GDI resource cashing
-/////////////////////////////////////////////////////////////////////
-XGdiResourcesCache* XGraphicsItem::getGdiResourcesCache(HDC hdc)
-{
-    // make sure we always have GDI cache
-    _checkGdiCacheReady(hdc);
-    
-    return m_pXGdiResourcesCache;
-}
-
-/////////////////////////////////////////////////////////////////////
-// Direct2D resource cashing
-/////////////////////////////////////////////////////////////////////
-XD2DResourcesCache* XGraphicsItem::getD2DResourcesCache(ID2D1RenderTarget* pTarget)
-{
-    // make sure we always have D2D cache
-    _checkD2DCacheReady(pTarget);
-
-    return m_pXD2DResourcesCache;
-}
-
-ID2D1Brush* XGraphicsItem::createD2DBrush(ID2D1RenderTarget* pTarget, const D2D1_COLOR_F& color)
-{
-    XWASSERT(pTarget);
-    if(pTarget == 0) return 0;
-
-    // make sure we always have D2D cache
-    _checkD2DCacheReady(pTarget);
-
-    // check if we have cache
-    XWASSERT(m_pXD2DResourcesCache);
-    if(m_pXD2DResourcesCache) return m_pXD2DResourcesCache->getBrush(color);
-
-    // create brush without cache
-    ID2D1SolidColorBrush* brush = 0;
-
-    // create brush
-    HRESULT hr = pTarget->CreateSolidColorBrush(color, &brush);
-    if(FAILED(hr))
-    {
-        XWTRACE_HRES("XGraphicsItem::createD2DBrush failed to create brush", hr);
-        return 0;
-    }
-
-    return brush;
-}
-
-ID2D1Brush* XGraphicsItem::createD2DBrush(ID2D1RenderTarget* pTarget, const COLORREF& color)
-{
-    // convert color
-    D2D1_COLOR_F d2dColor;
-    XD2DHelpers::colorrefToD2dColor(color, d2dColor);
-
-    // create brush
-    return createD2DBrush(pTarget, d2dColor);
-}
-
-/////////////////////////////////////////////////////////////////////
-// resource management
-/////////////////////////////////////////////////////////////////////
-bool XGraphicsItem::hasResourceCache()
-{
-    // check if cache is set
-    return  ( (painterType() == XWUI_PAINTER_GDI && m_pXGdiResourcesCache != 0) ||
-              (painterType() == XWUI_PAINTER_D2D && m_pXD2DResourcesCache != 0 && m_pXD2DResourcesCache->renderTarget() != 0) );
-}
-
-void XGraphicsItem::reloadResources()
-{
-    // check painter type
-    if(painterType() == XWUI_PAINTER_GDI)
-    {
-        // check if resources have been initialized
-        if(m_pXGdiResourcesCache && m_hwndParent)
-        {
-            // reset previous resources
-            onResetGDIResources();
-
-            // window DC
-            HDC hdc = ::GetDC(m_hwndParent);
-
-            // re-init resources
-            onInitGDIResources(hdc);
-
-            // release DC
-            ::ReleaseDC(m_hwndParent, hdc);
-        }
-
-    } else if(painterType() == XWUI_PAINTER_D2D)
-    {
-        // check if resources have been initialized
-        if(m_pXD2DResourcesCache && m_pXD2DResourcesCache->renderTarget())
-        {
-            // reset previous resources
-            onResetD2DTarget();
-
-            // re-load resources
-            onInitD2DTarget(m_pXD2DResourcesCache->renderTarget());
-        }
-    }
-}
-
-/////////////////////////////////////////////////////////////////////
-// load images to cache
-/////////////////////////////////////////////////////////////////////
-bool XGraphicsItem::loadBitmap(const XMediaSource& source, std::wstring& hashOut)
-{
-    // use scaling version
-    return loadBitmap(source, 0, 0, hashOut);
-}
-
-bool XGraphicsItem::loadBitmap(const XMediaSource& source, int width, int height, std::wstring& hashOut)
-{
-    // check painter type
-    if(painterType() == XWUI_PAINTER_GDI)
-    {
-        // load bitmap
-        if(m_pXGdiResourcesCache)
-            return m_pXGdiResourcesCache->loadBitmap(source, width, height, hashOut);
-
-    } else if(painterType() == XWUI_PAINTER_D2D)
-    {
-        // load bitmap
-        if(m_pXD2DResourcesCache)
-            return m_pXD2DResourcesCache->loadBitmap(source, width, height, hashOut);
-    }
-
-    return false;
-}
-
-bool XGraphicsItem::releaseBitmap(std::wstring& bitmapHash)
-{
-    // check painter type
-    if(painterType() == XWUI_PAINTER_GDI)
-    {
-        // release image
-        if(m_pXGdiResourcesCache)
-        {
-            m_pXGdiResourcesCache->releaseBitmap(bitmapHash);
-            return true;
-        }
-
-    } else if(painterType() == XWUI_PAINTER_D2D)
-    {
-        // release image
-        if(m_pXD2DResourcesCache)
-        {
-            m_pXD2DResourcesCache->releaseBitmap(bitmapHash);
-            return true;
-        }
-    }
-
-    return false;
-}
-
 /////////////////////////////////////////////////////////////////////
 // item state
 /////////////////////////////////////////////////////////////////////
@@ -2244,7 +1841,7 @@ void XGraphicsItem::onChildObjectRemoved(XWObject* child)
     if(child == 0) return;
 
     // find item
-    std::list<XGraphicsItem*>::iterator it = _findItemIt(child->xwoid());
+    XGraphicsItemList::iterator it = _findItemIt(child->xwoid());
 
     // ignore if item not found
     if(it == m_childItems.end()) return;
@@ -2253,6 +1850,9 @@ void XGraphicsItem::onChildObjectRemoved(XWObject* child)
     if(m_pLayout)
         m_pLayout->removelayoutItem(child->xwoid());
 
+    // reset parent reference
+    (*it)->m_parentItem = 0;
+
     // remove from child items list
     m_childItems.erase(it);
 
@@ -2272,6 +1872,73 @@ void XGraphicsItem::onChildObjectRemoved(XWObject* child)
 /////////////////////////////////////////////////////////////////////
 // worker methods
 /////////////////////////////////////////////////////////////////////
+void XGraphicsItem::_flushLayout(XLayoutStats& stats)
+{
+    // layout item if needed
+    if(m_layoutFlags & LAYOUT_FLAG_DIRTY)
+    {
+        // update statistics
+        stats.relayouts++;
+
+        // reset flag first (may be set again during layout)
+        m_layoutFlags &= ~LAYOUT_FLAG_DIRTY;
+
+        // layout with the same size (resets flag for all child items laid out)
+        update(m_itemRect.left, m_itemRect.top, width(), height());
+
+        // repaint changed area
+        repaint();
+    }
+
+    // pass to child items which are still not laid out
+    if(m_layoutFlags & LAYOUT_FLAG_CHILD_DIRTY)
+    {
+        // reset flag first (may be set again by child items)
+        m_layoutFlags &= ~LAYOUT_FLAG_CHILD_DIRTY;
+
+        for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+        {
+            if((*it)->isLayoutPending()) (*it)->_flushLayout(stats);
+        }
+    }
+}
+
+void XGraphicsItem::_requestPendingLayout()
+{
+    // ignore if nothing to lay out or pass has been requested already
+    if(!isLayoutPending() || (m_layoutFlags & LAYOUT_FLAG_PASS_REQUESTED)) return;
+
+    // ignore if item is still detached
+    if(m_hwndParent == 0 && m_pItemHost == 0) return;
+
+    // request layout pass from window or host
+    invalidateParentLayout();
+}
+
+XGraphicsItem* XGraphicsItem::_rootItem()
+{
+    // top item in tree
+    XGraphicsItem* item = this;
+    while(item->m_parentItem) item = item->m_parentItem;
+
+    return item;
+}
+
+HCURSOR XGraphicsItem::_setCursor(HCURSOR cursor)
+{
+    // NOTE: item host owns cursor if set, system cursor is not changed then
+    if(m_pItemHost) return m_pItemHost->setCursor(cursor);
+
+    return _setSystemCursor(cursor);
+}
+
+bool XGraphicsItem::_layoutDependsOnChildren() const
+{
+    // NOTE: item size constraints are computed from child items if item has layout
+    //       and size is not fixed in both directions
+    return (m_pLayout != 0 && (m_rpHorizontal != eResizeMinMax || m_rpVertical != eResizeMinMax));
+}
+
 void XGraphicsItem::_setVisibleImpl(bool bVisible)
 {
     // reset properties
@@ -2293,48 +1960,20 @@ void XGraphicsItem::_setVisibleImpl(bool bVisible)
     }
 
     // set to child items
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // update state
         (*it)->_setVisibleImpl(bVisible);
     }
 }
 
-void XGraphicsItem::_checkGdiCacheReady(HDC hdc)
-{
-    // make sure we always have GDI cache
-    if(m_pXGdiResourcesCache == 0)
-    {
-        // create own cache
-        XGdiResourcesCache* gdiCache = new XGdiResourcesCache;
-        gdiCache->init(hdc);
-
-        // set cache
-        setGDIResourcesCache(gdiCache);
-    }
-}
-
-void XGraphicsItem::_checkD2DCacheReady(ID2D1RenderTarget* pTarget)
-{
-    // make sure we always have D2D cache
-    if(m_pXD2DResourcesCache == 0)
-    {
-        // create own cache
-        XD2DResourcesCache* d2dCache = new XD2DResourcesCache;
-        d2dCache->init(pTarget);
-
-        // set cache
-        setD2DResourcesCache(d2dCache);
-    }
-}
-
 void XGraphicsItem::_focusNextItem()
 {
     // ignore if no items
     if(m_childItems.size() == 0) return;
 
     // find current focus item if any
-    std::list<XGraphicsItem*>::iterator it = m_childItems.end();
+    XGraphicsItemList::iterator it = m_childItems.end();
     if(m_focusItem)
     {
         // find focus item reference
@@ -2344,7 +1983,7 @@ void XGraphicsItem::_focusNextItem()
     // check if focus item has been found
     if(it != m_childItems.end())
     {
-        std::list<XGraphicsItem*>::iterator findIt = it;
+        XGraphicsItemList::iterator findIt = it;
 
         // start from the end if we are at the beginning
         if(findIt == m_childItems.begin()) findIt = m_childItems.end();
@@ -2375,7 +2014,7 @@ void XGraphicsItem::_focusNextItem()
     else
     {
         // no active focus item, just search in reverse order
-        for(std::list<XGraphicsItem*>::reverse_iterator rit = m_childItems.rbegin(); rit != m_childItems.rend(); ++rit)
+        for(XGraphicsItemList::reverse_iterator rit = m_childItems.rbegin(); rit != m_childItems.rend(); ++rit)
         {
             // check if item is focusable
             if((*rit)->isFocusable() && (*rit)->isEnabled())
@@ -2408,7 +2047,7 @@ void XGraphicsItem::_focusItem(XGraphicsItem* pItem)
 XGraphicsItem* XGraphicsItem::_findItem(int posX, int posY)
 {
     // loop over all items in list (in z-order)
-    for(std::list<XGraphicsItem*>::reverse_iterator rit = m_childItems.rbegin(); rit != m_childItems.rend(); ++rit)
+    for(XGraphicsItemList::reverse_iterator rit = m_childItems.rbegin(); rit != m_childItems.rend(); ++rit)
     {
         // ignore not visible or not enabled items
         if(!(*rit)->isVisible() || !(*rit)->isEnabled()) continue;
@@ -2424,7 +2063,7 @@ XGraphicsItem* XGraphicsItem::_findItem(int posX, int posY)
 XGraphicsItem* XGraphicsItem::_findItem(unsigned long itemId)
 {
     // loop over all items in list 
-    for(std::list<XGraphicsItem*>::const_iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::const_iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // check id
         if((*it)->xwoid() == itemId) return (*it);
@@ -2438,10 +2077,10 @@ XGraphicsItem* XGraphicsItem::_findItem(unsigned long itemId)
     return 0;
 }
 
-std::list<XGraphicsItem*>::iterator XGraphicsItem::_findItemIt(unsigned long itemId)
+XGraphicsItem::XGraphicsItemList::iterator XGraphicsItem::_findItemIt(unsigned long itemId)
 {
     // find item by id
-    for(std::list<XGraphicsItem*>::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
     {
         // check id
         if((*it)->xwoid() == itemId) return it;
@@ -18,6 +18,7 @@ struct ID2D1GdiInteropRenderTarget;
 class XGraphicsItemLayout;
 class XD2DResourcesCache;
 class XPopupMenu;
+class IXGraphicsItemHost;
 
 /////////////////////////////////////////////////////////////////////
 // graphics item events
@@ -40,10 +41,17 @@ public: // construction/destruction
     XGraphicsItem(XGraphicsItem* parent = 0);
     virtual ~XGraphicsItem();
 
+public: // child item list (nodes use pool of item if any, see XWObjectPool)
+    typedef std::list<XGraphicsItem*, XWPoolAllocator<XGraphicsItem*> >  XGraphicsItemList;
+
 public: // parent window
     virtual void    setParentWindow(HWND hwndParent);
     HWND    parentWindow() const { return m_hwndParent; }
 
+public: // item host (replaces parent window if set, not owned)
+    virtual void    setItemHost(IXGraphicsItemHost* itemHost);
+    IXGraphicsItemHost* itemHost() const { return m_pItemHost; }
+
 public: // message processing
     bool    processingMessages() const { return m_messageProcessing; }
     virtual LRESULT processWindowMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, bool& messageProcessed);
@@ -62,6 +70,7 @@ public: // child items (item takes ownership)
     XGraphicsItem*  findChildItem(unsigned long itemId);
     XGraphicsItem*  findAnimationItem(DWORD animationId);
     XGraphicsItem*  findContentItem(DWORD contentId);
+    XGraphicsItem*  parentItem() const { return m_parentItem; }
 
 public: // Z-ordering (item must be child item)
     void    moveItemOnTop(XGraphicsItem* childItem);
@@ -92,6 +101,23 @@ public: // context menu
     void    enableContextMenu(bool enable);
     XPopupMenu* contextMenu();
 
+public: // deferred layout (NOTE: layout is done once per frame by parent window)
+    void    invalidateLayout();
+    void    flushLayout();
+    bool    isLayoutPending() const { return (m_layoutFlags & (LAYOUT_FLAG_DIRTY | LAYOUT_FLAG_CHILD_DIRTY)) != 0; }
+
+public: // layout statistics (NOTE: kept by root item for whole item tree, i.e. per window)
+    struct XLayoutStats
+    {
+        unsigned long   invalidations;      // layout requests
+        unsigned long   passes;             // layout passes 
+        unsigned long   relayouts;          // items laid out by layout passes
+        unsigned long   avoidedRelayouts;   // requests which did not need own layout
+    };
+
+    void    getLayoutStats(XLayoutStats& statsOut);
+    void    resetLayoutStats();
+
 public: // content 
     virtual void    handleContentChanged();
     virtual int     contentWidthForHeight(int height);
@@ -204,6 +230,7 @@ public: // paint helpers
     void    repaint(bool paintNow = false);
     void    repaint(const RECT& rcPaint, bool paintNow = false);
     void    repaint(HRGN hrgn);
+    void    scrollRect(const RECT& rcScroll, int offsetX, int offsetY);
 
 public: // set size constraints
     void    setMinWidth(int width);
@@ -224,6 +251,9 @@ public: // resize policy (from IXLayoutItem)
     TResizePolicy   verticalPolicy() const;
     void            updateResizePolicies();
 
+public: // constraints change notification (from IXLayoutItem)
+    void    resetResizePolicies();
+
 public: // size constraints (from IXLayoutItem)
     int     minWidth()  const;
     int     minHeight() const;
@@ -242,13 +272,16 @@ public: // background fill (NOTE: in GDI mode use only if double buffer is enabl
 protected: // enable default content scrolling
     void    enableContentScrolling(bool bEnable);
 
+protected: // deferred layout
+    void    invalidateParentLayout();
+
 protected: // timer methods
     bool    startTimer(UINT uElapseMs);
     bool    stopTimer();
 
 protected: // animation methods
     bool    startTimerAnimation(UINT intervalMs, DWORD& idOut);
-    bool    startValueAnimation(UINT intervalMs, const XWAnimationTimer::ValueAnimation& animation, DWORD& idOut);
+    bool    startValueAnimation(UINT intervalMs, const XWAnimationScheduler::ValueAnimation& animation, DWORD& idOut);
     void    stopAnimation(DWORD id);
     void    validateAnimations();
     void    pauseAnimations();
@@ -302,7 +335,22 @@ protected: // worker methods
     void    _focusItem(XGraphicsItem* pItem);
     XGraphicsItem*  _findItem(int posX, int posY);
     XGraphicsItem*  _findItem(unsigned long itemId);
-    std::list<XGraphicsItem*>::iterator _findItemIt(unsigned long itemId);
+    XGraphicsItemList::iterator _findItemIt(unsigned long itemId);
+    void    _flushLayout(XLayoutStats& stats);
+    void    _requestPendingLayout();
+    XGraphicsItem*  _rootItem();
+    HCURSOR _setCursor(HCURSOR cursor);
+    bool    _layoutDependsOnChildren() const;
+
+private: // window methods (NOTE: not used if item host is set, see xgraphicsitemwin32.cpp)
+    LRESULT _sendWindowMessage(UINT uMsg, WPARAM wParam, LPARAM lParam);
+    bool    _postWindowMessage(UINT uMsg, WPARAM wParam, LPARAM lParam);
+    void    _repaintWindow(const RECT& rcPaint, bool paintNow);
+    bool    _setWindowTimer(UINT uElapseMs);
+    bool    _killWindowTimer();
+    HCURSOR _setSystemCursor(HCURSOR cursor);
+    void    _initChildResources(XGraphicsItem* childItem);
+    void    _releaseResourceCaches();
 
 protected: // item data
     RECT            m_itemRect;
@@ -317,15 +365,29 @@ protected: // caching
     XD2DResourcesCache* m_pXD2DResourcesCache;
 
 protected: // child items
-    std::list<XGraphicsItem*>   m_childItems;
+    XGraphicsItemList   m_childItems;
+
+private: // animations and content ids (use pool of item if any)
+    typedef std::vector<DWORD, XWPoolAllocator<DWORD> >  XItemIdArray;
 
-private: // animations
-    std::vector<DWORD>          m_itemAnimations;
-    std::vector<DWORD>          m_itemContentIds;
+    XItemIdArray        m_itemAnimations;
+    XItemIdArray        m_itemContentIds;
+
+private: // layout flags
+    enum TLayoutFlag
+    {
+        LAYOUT_FLAG_DIRTY           = 0x00000001,   // item has to be laid out
+        LAYOUT_FLAG_CHILD_DIRTY     = 0x00000002,   // some child items have to be laid out
+        LAYOUT_FLAG_PASS_REQUESTED  = 0x00000004    // layout pass requested from parent window
+    };
 
 private: // data
     HWND            m_hwndParent;
+    IXGraphicsItemHost* m_pItemHost;
+    XGraphicsItem*  m_parentItem;
     IXLayout*       m_pLayout;
+    unsigned long   m_layoutFlags;
+    XLayoutStats    m_layoutStats;
     std::wstring    m_hintText;
     XPopupMenu*     m_contextMenu;
     bool            m_contextMenuEnabled;
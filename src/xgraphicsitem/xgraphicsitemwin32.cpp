@@ -0,0 +1,807 @@
+// Graphics item functionality depending on Windows (window messages, GDI and 
+// Direct2D resources, animations and content loading)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "../xwui_config.h"
+
+#include "../ctrls/xpopupmenu.h"
+
+#include "../graphics/xwgraphics.h"
+
+#include "xgraphicsitem.h"
+
+// NOTE: platform independent part of graphics item is in xgraphicsitem.cpp, methods
+//       below talk to parent window and graphics resources directly
+
+/////////////////////////////////////////////////////////////////////
+// XGraphicsItem - graphics item (Windows part)
+
+/////////////////////////////////////////////////////////////////////
+// message processing
+/////////////////////////////////////////////////////////////////////
+LRESULT XGraphicsItem::processWindowMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, bool& messageProcessed)
+{
+    // reset flag by default
+    messageProcessed = false;
+
+    // ignore if processing is not needed
+    if(!m_messageProcessing) return 0;
+
+    // check message
+    switch(uMsg)
+    {
+    // mouse messages
+    case WM_MOUSEMOVE:
+    case WM_MOUSEHOVER:
+    case WM_MOUSEWHEEL:
+    case WM_LBUTTONDOWN:
+    case WM_MBUTTONDOWN:
+    case WM_RBUTTONDOWN:
+    case WM_XBUTTONDOWN:
+    case WM_LBUTTONUP:
+    case WM_MBUTTONUP:
+    case WM_RBUTTONUP:
+    case WM_XBUTTONUP:
+    case WM_LBUTTONDBLCLK:
+    case WM_MBUTTONDBLCLK:
+    case WM_RBUTTONDBLCLK:
+    case WM_XBUTTONDBLCLK:
+        {
+            // find item for mouse event
+            XGraphicsItem* item = _findItem(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
+            if(item)
+            {
+                // pass to item
+                return item->processWindowMessage(hwnd, uMsg, wParam, lParam, messageProcessed);
+            }
+        }
+        break;
+
+    }
+
+    // pass the rest to focused item if any
+    if(m_focusItem)
+        return m_focusItem->processWindowMessage(hwnd, uMsg, wParam, lParam, messageProcessed);
+
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// context menu
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::setContextMenu(XPopupMenu* contextMenu)
+{
+    // delete old menu if any
+    if(m_contextMenu) delete m_contextMenu;
+
+    // copy menu (may be null)
+    m_contextMenu = contextMenu;
+
+    // init menu
+    if(m_contextMenu)
+    {
+        // update parent object
+        m_contextMenu->setParentObject(this);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// GDI resource caching
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::onInitGDIResources(HDC hdc)
+{
+    // release previous resources if any
+    onResetGDIResources();
+
+    // make sure we always have GDI cache
+    _checkGdiCacheReady(hdc);
+
+    // init resources for child items
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    {
+        // init
+        (*it)->onInitGDIResources(hdc);
+    }
+}
+
+void XGraphicsItem::onResetGDIResources()
+{
+    // reset cache for child items
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    {
+        // reset
+        (*it)->onResetGDIResources();
+    }
+}
+
+void XGraphicsItem::setGDIResourcesCache(XGdiResourcesCache* pXGdiResourcesCache)
+{
+    // release previous instance if any
+    if(m_pXGdiResourcesCache)
+    {
+        // reset resources as they might be using cache
+        onResetGDIResources();
+
+        // release
+        m_pXGdiResourcesCache->Release();
+    }
+
+    // copy reference
+    m_pXGdiResourcesCache = pXGdiResourcesCache;
+
+    // add reference if needed
+    if(m_pXGdiResourcesCache)
+        m_pXGdiResourcesCache->AddRef();
+
+    // set cache for child items
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    {
+        // set
+        (*it)->setGDIResourcesCache(m_pXGdiResourcesCache);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// Direct2D painting
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::onPaintD2D(ID2D1RenderTarget* pTarget, const RECT& rcPaint)
+{
+    // ignore if not visible
+    if(!isVisible()) return;
+
+    // convert rect
+    D2D1_RECT_F d2dRect;
+    XD2DHelpers::gdiRectToD2dRect(rcPaint, d2dRect);
+
+    // NOTE: do not clip regions here as some items may use GDI ineroperability
+
+    // Quote from MSDN: http://msdn.microsoft.com/en-us/library/windows/desktop/dd371323(v=vs.85).aspx
+    // "Note  In Windows 7 and earlier, you should not call GetDC between PushAxisAlignedClip/PopAxisAlignedClip commands 
+    //  or between PushLayer/PopLayer. However, this restriction does not apply to Windows 8 and later."
+
+    // NOTE: do not clip region
+    //  pTarget->PushAxisAlignedClip(d2dRect, D2D1_ANTIALIAS_MODE_ALIASED);
+
+    // fill background first if needed
+    if(m_fillBackground)
+    {
+        // convert color
+        D2D1_COLOR_F d2dBackgroundFillColor;
+        XD2DHelpers::colorrefToD2dColor(m_bgColor, d2dBackgroundFillColor);
+
+        // get brush from cache and fill
+        ID2D1Brush* backgroundFillBrush = createD2DBrush(pTarget, d2dBackgroundFillColor);
+        if(backgroundFillBrush)
+        {
+            pTarget->FillRectangle(d2dRect, backgroundFillBrush);
+            backgroundFillBrush->Release();
+        }
+    }
+
+    // paint child items
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    {
+        // ignore not visible items
+        if(!(*it)->isVisible()) continue;
+
+        // compute paint rectangle for item
+        RECT rcItemPaint;
+
+        // ignore if update rectangle doesn't overlap
+        if(!XWUtils::rectIntersect((*it)->rect(), rcPaint, rcItemPaint)) continue;
+
+        // paint
+        (*it)->onPaintD2D(pTarget, rcItemPaint);
+    }
+
+    // NOTE: do not clip
+    // pTarget->PopAxisAlignedClip();
+}
+
+/////////////////////////////////////////////////////////////////////
+// Direct2D resource caching
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::onInitD2DTarget(ID2D1RenderTarget* pTarget)
+{
+    // reset previous target if any
+    onResetD2DTarget();
+
+    // make sure we always have D2D cache
+    _checkD2DCacheReady(pTarget);
+
+    // init target for child items
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    {
+        // init
+        (*it)->onInitD2DTarget(pTarget);
+    }
+}
+
+void XGraphicsItem::onResetD2DTarget()
+{
+    // reset target for child items
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    {
+        // reset
+        (*it)->onResetD2DTarget();
+    }
+
+    // release GDI render target if any
+    if(m_pGDIRenderTarget) 
+    { 
+        m_pGDIRenderTarget->Release();
+        m_pGDIRenderTarget = 0;
+    }
+}
+
+void XGraphicsItem::setD2DResourcesCache(XD2DResourcesCache* pXD2DResourcesCache)
+{
+    // release previous instance if any
+    if(m_pXD2DResourcesCache)
+    {
+        // reset previous resources
+        onResetD2DTarget();
+
+        // release cache
+        m_pXD2DResourcesCache->Release();
+    }
+
+    // copy reference
+    m_pXD2DResourcesCache = pXD2DResourcesCache;
+
+    // add reference if needed
+    if(m_pXD2DResourcesCache)
+        m_pXD2DResourcesCache->AddRef();
+
+    // init cache for child items
+    for(XGraphicsItemList::iterator it = m_childItems.begin(); it != m_childItems.end(); ++it)
+    {
+        // init
+        (*it)->setD2DResourcesCache(m_pXD2DResourcesCache);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// paint helpers
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::repaint(HRGN hrgn)
+{
+    XWASSERT(hrgn);
+    if(hrgn == 0) return;
+
+    RECT rcPaint;
+
+    // get bounding rectangle
+    ::GetRgnBox(hrgn, &rcPaint);
+    
+    // repaint area
+    repaint(rcPaint);
+}
+
+/////////////////////////////////////////////////////////////////////
+// animation methods
+/////////////////////////////////////////////////////////////////////
+bool XGraphicsItem::startTimerAnimation(UINT intervalMs, DWORD& idOut)
+{
+    // ignore if window not set
+    XWASSERT(m_hwndParent);
+    if(m_hwndParent == 0) return false;
+
+    // remove not active animations just in case
+    validateAnimations();
+
+    // start animation
+    if(XWAnimationTimer::instance()->startTimerAnimation(intervalMs, m_hwndParent, idOut))
+    {
+        // add to item animations
+        m_itemAnimations.push_back(idOut);
+
+        return true;
+    }
+
+    return false;
+}
+
+bool XGraphicsItem::startValueAnimation(UINT intervalMs, const XWAnimationScheduler::ValueAnimation& animation, DWORD& idOut)
+{
+    // ignore if window not set
+    XWASSERT(m_hwndParent);
+    if(m_hwndParent == 0) return false;
+
+    // remove not active animations just in case
+    validateAnimations();
+
+    // start animation
+    if(XWAnimationTimer::instance()->startValueAnimation(intervalMs, animation, m_hwndParent, idOut))
+    {
+        // add to item animations
+        m_itemAnimations.push_back(idOut);
+
+        return true;
+    }
+
+    return false;
+}
+
+void XGraphicsItem::stopAnimation(DWORD id)
+{
+    // find from animations
+    XItemIdArray::iterator it = std::find(m_itemAnimations.begin(), m_itemAnimations.end(), id);
+
+    // check if found
+    XWASSERT1(it != m_itemAnimations.end(), "XGraphicsItem: trying to stop uknown animation");
+    if(it == m_itemAnimations.end()) return;
+
+    // stop animation
+    XWAnimationTimer::instance()->stopAnimation(id);
+
+    // remove from list
+    m_itemAnimations.erase(it);
+}
+
+void XGraphicsItem::validateAnimations()
+{
+    // loop over all animations
+    for(XItemIdArray::iterator it = m_itemAnimations.begin();
+        it != m_itemAnimations.end();)
+    {
+        // check if still exists
+        if(XWAnimationTimer::instance()->hasAnimation(*it))
+        {
+            // next
+            ++it;
+
+        } else
+        {
+            XWASSERT1(0, "XGraphicsItem: item contains not active animation");
+
+            // remove
+            it = m_itemAnimations.erase(it);
+        }
+    }
+}
+
+void XGraphicsItem::pauseAnimations()
+{
+    // loop over all animations
+    for(XItemIdArray::iterator it = m_itemAnimations.begin(); 
+        it != m_itemAnimations.end(); ++it)
+    {
+        XWAnimationTimer::instance()->pauseAnimation(*it);
+    }
+}
+
+void XGraphicsItem::resumeAnimations()
+{
+    // ingore if item is not visible or obscured
+    if(!m_visible || m_obscured) return;
+
+    // loop over all animations
+    for(XItemIdArray::iterator it = m_itemAnimations.begin(); 
+        it != m_itemAnimations.end(); ++it)
+    {
+        XWAnimationTimer::instance()->resumeAnimation(*it);
+    }
+}
+
+void XGraphicsItem::stopAllAnimations()
+{
+    // loop over all animations
+    for(XItemIdArray::iterator it = m_itemAnimations.begin();
+        it != m_itemAnimations.end(); ++it)
+    {
+        // stop animation
+        XWAnimationTimer::instance()->stopAnimation(*it);
+    }
+
+    // reset list
+    m_itemAnimations.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// content loading
+/////////////////////////////////////////////////////////////////////
+bool XGraphicsItem::isUrlContentLoaded(const WCHAR* url, XMediaSource& srcOut)
+{
+    // check from content provider
+    return XWContentProvider::instance()->isUrlContentLoaded(url, srcOut);
+}
+
+bool XGraphicsItem::loadUrlContent(const WCHAR* url, DWORD& idOut)
+{
+    // start loading
+    if(XWContentProvider::instance()->loadUrlContent(url, m_hwndParent, idOut))
+    {
+        m_itemContentIds.push_back(idOut);
+        return true;
+    }
+
+    return false;
+}
+
+void XGraphicsItem::cancelContentLoad(DWORD id)
+{
+    // find content id
+    XItemIdArray::iterator it = std::find(m_itemContentIds.begin(), m_itemContentIds.end(), id);
+
+    // check if found
+    XWASSERT1(it != m_itemContentIds.end(), "XGraphicsItem: trying to cancel uknown content");
+    if(it == m_itemContentIds.end()) return;
+
+    // cancel 
+    XWContentProvider::instance()->cancelContentLoad(id);
+
+    // remove from list
+    m_itemContentIds.erase(it);
+}
+
+void XGraphicsItem::cancelAllContent()
+{
+    // loop over all content ids
+    for(XItemIdArray::iterator it = m_itemContentIds.begin();
+        it != m_itemContentIds.end(); ++it)
+    {
+        // cancel loading
+        XWContentProvider::instance()->cancelContentLoad(*it);
+    }
+
+    // reset list
+    m_itemContentIds.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// helper methods
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::onPaintD2DFromGDI(ID2D1RenderTarget* pTarget, const RECT& rcPaint)
+{
+    // NOTE: create GDI target only if this method is called
+    if(m_pGDIRenderTarget == 0)
+    {
+        // get GDI render target (NOTE: ignore return code)
+        pTarget->QueryInterface(__uuidof(ID2D1GdiInteropRenderTarget), (void**)&m_pGDIRenderTarget);
+    }
+
+    // render using GDI
+    if(m_pGDIRenderTarget) 
+    { 
+        // init render target
+        HDC hdc = 0;
+        HRESULT hr = m_pGDIRenderTarget->GetDC(D2D1_DC_INITIALIZE_MODE_COPY, &hdc);
+
+        // render item using GDI method
+        if(SUCCEEDED(hr))
+        {
+            // render item 
+            onPaintGDI(hdc, rcPaint);
+
+            // reset render target
+            m_pGDIRenderTarget->ReleaseDC(NULL);
+
+        } else
+        {
+            XWTRACE_HRES("XGraphicsItem: failed to get DC for GDI compatible paint", hr);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// GDI resource cashing
+/////////////////////////////////////////////////////////////////////
+XGdiResourcesCache* XGraphicsItem::getGdiResourcesCache(HDC hdc)
+{
+    // make sure we always have GDI cache
+    _checkGdiCacheReady(hdc);
+    
+    return m_pXGdiResourcesCache;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Direct2D resource cashing
+/////////////////////////////////////////////////////////////////////
+XD2DResourcesCache* XGraphicsItem::getD2DResourcesCache(ID2D1RenderTarget* pTarget)
+{
+    // make sure we always have D2D cache
+    _checkD2DCacheReady(pTarget);
+
+    return m_pXD2DResourcesCache;
+}
+
+ID2D1Brush* XGraphicsItem::createD2DBrush(ID2D1RenderTarget* pTarget, const D2D1_COLOR_F& color)
+{
+    XWASSERT(pTarget);
+    if(pTarget == 0) return 0;
+
+    // make sure we always have D2D cache
+    _checkD2DCacheReady(pTarget);
+
+    // check if we have cache
+    XWASSERT(m_pXD2DResourcesCache);
+    if(m_pXD2DResourcesCache) return m_pXD2DResourcesCache->getBrush(color);
+
+    // create brush without cache
+    ID2D1SolidColorBrush* brush = 0;
+
+    // create brush
+    HRESULT hr = pTarget->CreateSolidColorBrush(color, &brush);
+    if(FAILED(hr))
+    {
+        XWTRACE_HRES("XGraphicsItem::createD2DBrush failed to create brush", hr);
+        return 0;
+    }
+
+    return brush;
+}
+
+ID2D1Brush* XGraphicsItem::createD2DBrush(ID2D1RenderTarget* pTarget, const COLORREF& color)
+{
+    // convert color
+    D2D1_COLOR_F d2dColor;
+    XD2DHelpers::colorrefToD2dColor(color, d2dColor);
+
+    // create brush
+    return createD2DBrush(pTarget, d2dColor);
+}
+
+/////////////////////////////////////////////////////////////////////
+// resource management
+/////////////////////////////////////////////////////////////////////
+bool XGraphicsItem::hasResourceCache()
+{
+    // check if cache is set
+    return  ( (painterType() == XWUI_PAINTER_GDI && m_pXGdiResourcesCache != 0) ||
+              (painterType() == XWUI_PAINTER_D2D && m_pXD2DResourcesCache != 0 && m_pXD2DResourcesCache->renderTarget() != 0) );
+}
+
+void XGraphicsItem::reloadResources()
+{
+    // check painter type
+    if(painterType() == XWUI_PAINTER_GDI)
+    {
+        // check if resources have been initialized
+        if(m_pXGdiResourcesCache && m_hwndParent)
+        {
+            // reset previous resources
+            onResetGDIResources();
+
+            // window DC
+            HDC hdc = ::GetDC(m_hwndParent);
+
+            // re-init resources
+            onInitGDIResources(hdc);
+
+            // release DC
+            ::ReleaseDC(m_hwndParent, hdc);
+        }
+
+    } else if(painterType() == XWUI_PAINTER_D2D)
+    {
+        // check if resources have been initialized
+        if(m_pXD2DResourcesCache && m_pXD2DResourcesCache->renderTarget())
+        {
+            // reset previous resources
+            onResetD2DTarget();
+
+            // re-load resources
+            onInitD2DTarget(m_pXD2DResourcesCache->renderTarget());
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// load images to cache
+/////////////////////////////////////////////////////////////////////
+bool XGraphicsItem::loadBitmap(const XMediaSource& source, std::wstring& hashOut)
+{
+    // use scaling version
+    return loadBitmap(source, 0, 0, hashOut);
+}
+
+bool XGraphicsItem::loadBitmap(const XMediaSource& source, int width, int height, std::wstring& hashOut)
+{
+    // check painter type
+    if(painterType() == XWUI_PAINTER_GDI)
+    {
+        // load bitmap
+        if(m_pXGdiResourcesCache)
+            return m_pXGdiResourcesCache->loadBitmap(source, width, height, hashOut);
+
+    } else if(painterType() == XWUI_PAINTER_D2D)
+    {
+        // load bitmap
+        if(m_pXD2DResourcesCache)
+            return m_pXD2DResourcesCache->loadBitmap(source, width, height, hashOut);
+    }
+
+    return false;
+}
+
+bool XGraphicsItem::releaseBitmap(std::wstring& bitmapHash)
+{
+    // check painter type
+    if(painterType() == XWUI_PAINTER_GDI)
+    {
+        // release image
+        if(m_pXGdiResourcesCache)
+        {
+            m_pXGdiResourcesCache->releaseBitmap(bitmapHash);
+            return true;
+        }
+
+    } else if(painterType() == XWUI_PAINTER_D2D)
+    {
+        // release image
+        if(m_pXD2DResourcesCache)
+        {
+            m_pXD2DResourcesCache->releaseBitmap(bitmapHash);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::_checkGdiCacheReady(HDC hdc)
+{
+    // make sure we always have GDI cache
+    if(m_pXGdiResourcesCache == 0)
+    {
+        // create own cache
+        XGdiResourcesCache* gdiCache = new XGdiResourcesCache;
+        gdiCache->init(hdc);
+
+        // set cache
+        setGDIResourcesCache(gdiCache);
+    }
+}
+
+void XGraphicsItem::_checkD2DCacheReady(ID2D1RenderTarget* pTarget)
+{
+    // make sure we always have D2D cache
+    if(m_pXD2DResourcesCache == 0)
+    {
+        // create own cache
+        XD2DResourcesCache* d2dCache = new XD2DResourcesCache;
+        d2dCache->init(pTarget);
+
+        // set cache
+        setD2DResourcesCache(d2dCache);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// window methods (NOTE: not used if item host is set)
+/////////////////////////////////////////////////////////////////////
+LRESULT XGraphicsItem::_sendWindowMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+    // ignore if window not set
+    if(m_hwndParent == 0) return 0;
+
+    return ::SendMessageW(m_hwndParent, uMsg, wParam, lParam);
+}
+
+bool XGraphicsItem::_postWindowMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+    // ignore if window not set
+    if(m_hwndParent == 0) return false;
+
+    return (::PostMessageW(m_hwndParent, uMsg, wParam, lParam) != 0);
+}
+
+void XGraphicsItem::_repaintWindow(const RECT& rcPaint, bool paintNow)
+{
+    // NOTE: parent window collects damaged areas from all items and repaints them
+    //       once per frame, immediate repaint makes it paint damaged areas right away
+    if(::SendMessageW(m_hwndParent, WM_XWUI_GITEM_REPAINT, paintNow ? TRUE : FALSE, (LPARAM)&rcPaint) == TRUE) return;
+
+    bool paintDone = false;
+
+    // check if we need to repaint immediately
+    if(paintNow)
+    {
+        // check painter type
+        if(painterType() == XWUI_PAINTER_GDI)
+        {
+            // repaint
+            HDC hdc = ::GetDC(m_hwndParent);
+            onPaintGDI(hdc, m_itemRect);
+            ::ReleaseDC(m_hwndParent, hdc);
+
+            // mark flag
+            paintDone = true;
+
+        } else if(painterType() == XWUI_PAINTER_D2D)
+        {
+            // check if we have target set already
+            if(m_pXD2DResourcesCache->renderTarget() != 0)
+            {
+                // repaint
+                m_pXD2DResourcesCache->renderTarget()->BeginDraw();
+                onPaintD2D(m_pXD2DResourcesCache->renderTarget(), m_itemRect);
+                m_pXD2DResourcesCache->renderTarget()->EndDraw();
+
+                // mark flag
+                paintDone = true;
+            }
+        }
+    }
+
+    // inform parent window that repaint is needed
+    if(!paintDone)
+    {
+        ::InvalidateRect(m_hwndParent, &rcPaint, FALSE);
+    }
+    }
+}
+
+bool XGraphicsItem::_setWindowTimer(UINT uElapseMs)
+{
+    if(::SetTimer(m_hwndParent, xwoid(), uElapseMs, 0) == 0)
+    {
+        XWTRACE_WERR_LAST("XGraphicsItem: failed to start timer");
+        return false;
+    }
+
+    return true;
+}
+
+bool XGraphicsItem::_killWindowTimer()
+{
+    if(::KillTimer(m_hwndParent, xwoid()) == 0)
+    {
+        XWTRACE_WERR_LAST("XGraphicsItem: failed to stop timer");
+        return false;
+    }
+
+    return true;
+}
+
+HCURSOR XGraphicsItem::_setSystemCursor(HCURSOR cursor)
+{
+    return ::SetCursor(cursor);
+}
+
+void XGraphicsItem::_initChildResources(XGraphicsItem* childItem)
+{
+    // init GDI resources if set
+    if(m_pXGdiResourcesCache && m_hwndParent)
+    {
+        // window DC
+        HDC hdc = ::GetDC(m_hwndParent);
+
+        // init resources
+        childItem->onInitGDIResources(hdc);
+
+        // release DC
+        ::ReleaseDC(m_hwndParent, hdc);
+    }
+
+    // init D2D resources if set
+    if(m_pXD2DResourcesCache && m_pXD2DResourcesCache->renderTarget())
+    {
+        // init resources
+        childItem->onInitD2DTarget(m_pXD2DResourcesCache->renderTarget());
+    }
+}
+
+void XGraphicsItem::_releaseResourceCaches()
+{
+    // reset caches if any
+    onResetGDIResources();
+    onResetD2DTarget();
+
+    // release caches if any
+    if(m_pXGdiResourcesCache) 
+        m_pXGdiResourcesCache->Release();
+    if(m_pXD2DResourcesCache)
+        m_pXD2DResourcesCache->Release();
+
+    m_pXGdiResourcesCache = 0;
+    m_pXD2DResourcesCache = 0;
+}
+
+// XGraphicsItem
+/////////////////////////////////////////////////////////////////////
@@ -6,6 +6,7 @@
 
 #include "../layout/xlayoutitem.h"
 #include "../layout/xlayout.h"
+#include "../layout/xlayoutsizesolver.h"
 #include "../layout/xvboxlayout.h"
 #include "../layout/xhboxlayout.h"
 
@@ -31,7 +32,11 @@ XGraphicsItemWindow::XGraphicsItemWindow(XWObject* parent) :
     m_bDirect2DPaint(false),
     m_bGDIDoubleBuffering(false),
     m_bContentScrolling(true),
-    m_pRenderTarget(0)
+    m_bBlitScrolling(true),
+    m_pObjectPool(0),
+    m_bDamageFlushPending(false),
+    m_pRenderTarget(0),
+    m_pScrollBitmap(0)
 {
     // check default painter type
     m_bDirect2DPaint = (sXWUIDefaultPainter() == XWUI_PAINTER_D2D);
@@ -48,7 +53,11 @@ XGraphicsItemWindow::XGraphicsItemWindow(DWORD dwStyle, XWObject* parent, HWND h
     m_bDirect2DPaint(false),
     m_bGDIDoubleBuffering(false),
     m_bContentScrolling(true),
-    m_pRenderTarget(0)
+    m_bBlitScrolling(true),
+    m_pObjectPool(0),
+    m_bDamageFlushPending(false),
+    m_pRenderTarget(0),
+    m_pScrollBitmap(0)
 {
     // check default painter type
     m_bDirect2DPaint = (sXWUIDefaultPainter() == XWUI_PAINTER_D2D);
@@ -61,6 +70,11 @@ XGraphicsItemWindow::~XGraphicsItemWindow()
 {
     // close all resources if any
     _closeResources();
+
+    // NOTE: pool is deleted once objects still using it (e.g. child objects deleted
+    //       later by XWObject destructor) release their memory
+    if(m_pObjectPool) m_pObjectPool->release();
+    m_pObjectPool = 0;
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -75,8 +89,14 @@ void XGraphicsItemWindow::setGraphicsItem(XGraphicsItem* pXGraphicsItem)
     m_pXGraphicsItem = pXGraphicsItem;
     m_pXGraphicsItem->setParentObject(this);
 
+    // item informs window about its size constraints changes
+    m_pXGraphicsItem->setParentLayoutItem(this);
+
     // init item
     _initGraphicsItem(m_pXGraphicsItem, hwnd());
+
+    // window size constraints depend on item
+    invalidateResizePolicies();
 }
 
 XGraphicsItem* XGraphicsItemWindow::releaseGraphicsItem()
@@ -87,11 +107,17 @@ XGraphicsItem* XGraphicsItemWindow::releaseGraphicsItem()
     if(m_pXGraphicsItem)
     {
         _closeGraphicsItem(m_pXGraphicsItem);
+
+        // detach from window
+        m_pXGraphicsItem->setParentLayoutItem(0);
     }
 
     // reset reference
     m_pXGraphicsItem = 0;
 
+    // window size constraints depend on item
+    invalidateResizePolicies();
+
     return item;
 }
 
@@ -142,6 +168,24 @@ void XGraphicsItemWindow::enableContentScrolling(bool bEnable)
     m_bContentScrolling = bEnable;
 }
 
+void XGraphicsItemWindow::enableBlitScrolling(bool bEnable)
+{
+    // NOTE: disable if items are painted on top of scrolled items (content
+    //       moved from the screen would include such items as well)
+    m_bBlitScrolling = bEnable;
+}
+
+/////////////////////////////////////////////////////////////////////
+// object pool
+/////////////////////////////////////////////////////////////////////
+XWObjectPool* XGraphicsItemWindow::objectPool()
+{
+    // create pool on first use
+    if(m_pObjectPool == 0) m_pObjectPool = new XWObjectPool();
+
+    return m_pObjectPool;
+}
+
 /////////////////////////////////////////////////////////////////////
 // shared caches
 /////////////////////////////////////////////////////////////////////
@@ -190,6 +234,21 @@ int XGraphicsItemWindow::getSharedGDICache(XGdiResourcesCache** pSharedGDICache)
     return ERROR_NOT_FOUND;
 }
 
+/////////////////////////////////////////////////////////////////////
+// live resize (from XWHWND)
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItemWindow::beginLiveResize()
+{
+    // NOTE: item layout is updated once live resize ends
+    beginLiveResizeSnapshot();
+}
+
+void XGraphicsItemWindow::endLiveResize()
+{
+    // update item layout and repaint
+    endLiveResizeSnapshot();
+}
+
 /////////////////////////////////////////////////////////////////////
 // state (from XWHWND)
 /////////////////////////////////////////////////////////////////////
@@ -411,6 +470,9 @@ int XGraphicsItemWindow::maxHeight() const
 /////////////////////////////////////////////////////////////////////
 void XGraphicsItemWindow::onCreate(HWND hwnd, const CREATESTRUCT* pCreateStruct)
 {
+    // receive item animation events once per frame
+    XWAnimationTimer::instance()->enableFrameDelivery(hwnd, true);
+
     // init graphics item if set
     _initGraphicsItem(m_pXGraphicsItem, hwnd);
 }
@@ -436,6 +498,9 @@ void XGraphicsItemWindow::onDestroy()
     // close all resources if any
     _closeResources();
 
+    // drop animation events not delivered yet
+    if(hwnd()) XWAnimationTimer::instance()->enableFrameDelivery(hwnd(), false);
+
     // pass to parent
     XWindow::onDestroy();
 }
@@ -685,28 +750,45 @@ LRESULT XGraphicsItemWindow::processMessage(HWND hwnd, UINT uMsg, WPARAM wParam,
 
     ///// XWUI messages
     case WM_XWUI_ANIMATION_TIMER_EVENT:
+        // queue latency (if profiler enabled)
+        XWPROFILE_QUEUE_LATENCY(uMsg, lParam);
+
         // process event
         _onAnimationTimerEvent((DWORD)wParam);
         break;
 
     case WM_XWUI_ANIMATION_VALUE_EVENT:
+        // queue latency (if profiler enabled)
+        XWPROFILE_QUEUE_LATENCY(uMsg, lParam);
+
         // process event
         _onAnimationValueEvent((DWORD)wParam);
         break;
 
     case WM_XWUI_ANIMATION_COMPLETED:
+        // queue latency (if profiler enabled)
+        XWPROFILE_QUEUE_LATENCY(uMsg, lParam);
+
         // process event
-        _onContentLoaded((DWORD)wParam, (const WCHAR*)lParam);
+        _onAnimationCompleted((DWORD)wParam);
+        break;
+
+    case WM_XWUI_ANIMATION_FRAME:
+        // queue latency (if profiler enabled)
+        XWPROFILE_QUEUE_LATENCY(uMsg, lParam);
+
+        // process all events of current frame
+        _onAnimationFrame();
         break;
 
     case WM_XWUI_URL_CONTENT_LOADED:
         // process event
-        _onContentLoadFailed((DWORD)wParam, (DWORD)lParam);
+        _onContentLoaded((DWORD)wParam, (const WCHAR*)lParam);
         break;
 
     case WM_XWUI_URL_CONTENT_LOAD_FAILED:
         // process event
-        _onAnimationCompleted((DWORD)wParam);
+        _onContentLoadFailed((DWORD)wParam, (DWORD)lParam);
         break;
 
     ///// special graphics item messages
@@ -730,11 +812,8 @@ LRESULT XGraphicsItemWindow::processMessage(HWND hwnd, UINT uMsg, WPARAM wParam,
         break;
 
     case WM_XWUI_GITEM_CONTENT_CHANGED:
-        // update item layout
-        _updateGraphicsItem();
-
-        // request repaint
-        repaint();
+        // layout changed items (they will be repainted as well)
+        if(m_pXGraphicsItem) m_pXGraphicsItem->flushLayout();
         break;
 
     case WM_XWUI_GITEM_SET_SHARED_GDI_CACHE:
@@ -761,6 +840,28 @@ LRESULT XGraphicsItemWindow::processMessage(HWND hwnd, UINT uMsg, WPARAM wParam,
 
         return 0;
         break;
+
+    case WM_XWUI_GITEM_REPAINT:
+        // add to damage region
+        if(lParam) _addDamageRect(*((const RECT*)lParam), wParam != FALSE);
+
+        return TRUE;
+        break;
+
+    case WM_XWUI_GITEM_FLUSH_DAMAGE:
+        // repaint damaged areas
+        _flushDamageRegion();
+
+        return 0;
+        break;
+
+    case WM_XWUI_GITEM_SCROLL_RECT:
+        // move painted content
+        if(lParam && _scrollDamageRect(*((const RECT*)lParam), (short)LOWORD(wParam), (short)HIWORD(wParam)))
+            return TRUE;
+
+        return FALSE;
+        break;
     }
 
     // check if graphics item needs raw message processing
@@ -786,6 +887,9 @@ void XGraphicsItemWindow::onPaint(HDC hdc, PAINTSTRUCT& ps)
     // ignore if item not set or not visible
     if(m_pXGraphicsItem == 0 || !m_pXGraphicsItem->isVisible()) return;
 
+    // profile paint (if profiler enabled)
+    XWPROFILE_PAINT(WM_PAINT);
+
     // check what render method is in use
     if(m_bDirect2DPaint)
     {
@@ -797,6 +901,26 @@ void XGraphicsItemWindow::onPaint(HDC hdc, PAINTSTRUCT& ps)
         // GDI rendering
         _onPaintWindowGDI(hdc, ps);
     }
+
+    // damaged areas inside paint rectangle are repainted already
+    m_damageRegion.validateRect(ps.rcPaint);
+}
+
+bool XGraphicsItemWindow::onPrintClient(HDC hdc, const RECT& rcClient)
+{
+    // ignore if item not set or not visible
+    if(m_pXGraphicsItem == 0 || !m_pXGraphicsItem->isVisible()) return false;
+
+    // NOTE: Direct2D content is copied from target back buffer (see _printClientD2D)
+    if(m_bDirect2DPaint) return _printClientD2D(hdc, rcClient);
+
+    // init cache (if not there already)
+    _initGDICache(hdc);
+
+    // paint graphics (target DC is off screen already, no double buffering)
+    m_pXGraphicsItem->onPaintGDI(hdc, rcClient);
+
+    return true;
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -831,8 +955,14 @@ void XGraphicsItemWindow::onChildObjectRemoved(XWObject* child)
     // check if graphics item has been removed
     if(m_pXGraphicsItem && child && m_pXGraphicsItem->xwoid() == child->xwoid())
     {
+        // detach from window
+        m_pXGraphicsItem->setParentLayoutItem(0);
+
         // reset reference
         m_pXGraphicsItem = 0;
+
+        // window size constraints depend on item
+        invalidateResizePolicies();
     }
 
     // pass to parent
@@ -962,6 +1092,45 @@ void XGraphicsItemWindow::_onPaintWindowD2D(const RECT& rcPaint)
     }
 }
 
+bool XGraphicsItemWindow::_printClientD2D(HDC hdc, const RECT& rcClient)
+{
+    // NOTE: target is created with D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS, so its back
+    //       buffer keeps presented content, items are not repainted. There is nothing
+    //       to copy if window has not been painted yet.
+    if(m_pRenderTarget == 0) return false;
+
+    // get GDI interop target (target is GDI compatible)
+    ID2D1GdiInteropRenderTarget* pGDIRenderTarget = 0;
+    HRESULT hr = m_pRenderTarget->QueryInterface(__uuidof(ID2D1GdiInteropRenderTarget), (void**)&pGDIRenderTarget);
+    if(FAILED(hr) || pGDIRenderTarget == 0) return false;
+
+    m_pRenderTarget->BeginDraw();
+
+    // copy back buffer
+    HDC hTargetDC = 0;
+    hr = pGDIRenderTarget->GetDC(D2D1_DC_INITIALIZE_MODE_COPY, &hTargetDC);
+    if(SUCCEEDED(hr))
+    {
+        ::BitBlt(hdc, rcClient.left, rcClient.top, rcClient.right - rcClient.left, rcClient.bottom - rcClient.top,
+            hTargetDC, rcClient.left, rcClient.top, SRCCOPY);
+
+        // content is not changed
+        pGDIRenderTarget->ReleaseDC(NULL);
+    }
+
+    pGDIRenderTarget->Release();
+
+    // check if target has to be reset
+    if(D2DERR_RECREATE_TARGET == m_pRenderTarget->EndDraw())
+    {
+        _resetD2DTarget();
+
+        return false;
+    }
+
+    return SUCCEEDED(hr);
+}
+
 bool XGraphicsItemWindow::_initD2DTarget()
 {
     // ignore if there is target already
@@ -993,7 +1162,7 @@ bool XGraphicsItemWindow::_initD2DTarget()
     
     // create render target
     HRESULT hr = pID2D1Factory->CreateHwndRenderTarget(rtProps,
-        D2D1::HwndRenderTargetProperties(hwnd(), size), &m_pRenderTarget);
+        D2D1::HwndRenderTargetProperties(hwnd(), size, D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS), &m_pRenderTarget);
 
     if(SUCCEEDED(hr))
     {
@@ -1035,6 +1204,13 @@ void XGraphicsItemWindow::_resetD2DTarget()
         m_pD2DResourcesCache = 0;
     }
 
+    // release scroll bitmap
+    if(m_pScrollBitmap)
+    {
+        m_pScrollBitmap->Release();
+        m_pScrollBitmap = 0;
+    }
+
     // release target
     if(m_pRenderTarget)
     {
@@ -1086,6 +1262,349 @@ void XGraphicsItemWindow::_getSharedGDICacheFromParent()
     }
 }
 
+/////////////////////////////////////////////////////////////////////
+// damage region
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItemWindow::_addDamageRect(const RECT& rect, bool paintNow)
+{
+    // add to damage region
+    m_damageRegion.addRect(rect);
+
+    // NOTE: immediate repaint (e.g. drag feedback) paints whole damage region now,
+    //       flush message queued before (if any) finds it empty then
+    if(paintNow)
+    {
+        _flushDamageRegion();
+        return;
+    }
+
+    // schedule repaint if not done yet
+    if(!m_bDamageFlushPending && hwnd())
+    {
+        // NOTE: animation timer posts all events for the same tick at once, so flush
+        //       message gets queued after them and damage from all animations in this
+        //       frame is repainted together. The same applies to input messages.
+        if(::PostMessageW(hwnd(), WM_XWUI_GITEM_FLUSH_DAMAGE, 0, 0))
+        {
+            m_bDamageFlushPending = true;
+
+        } else
+        {
+            XWTRACE_WERR_LAST("XGraphicsItemWindow: failed to schedule repaint, using WM_PAINT instead");
+
+            // fallback to default repaint
+            ::InvalidateRect(hwnd(), &rect, FALSE);
+        }
+    }
+}
+
+void XGraphicsItemWindow::_flushDamageRegion()
+{
+    // reset flag
+    m_bDamageFlushPending = false;
+
+    // NOTE: window shows scaled snapshot while live resize is active, whole window
+    //       is repainted once resize ends (damage is validated by WM_PAINT)
+    if(isLiveResizeActive()) return;
+
+    // make sure layout is done before painting
+    if(m_pXGraphicsItem && m_pXGraphicsItem->isLayoutPending()) m_pXGraphicsItem->flushLayout();
+
+    // ignore if there is nothing to paint (e.g. painted by WM_PAINT already)
+    if(m_damageRegion.isEmpty()) return;
+
+    // ignore if item is not set or not visible
+    if(m_pXGraphicsItem == 0 || !m_pXGraphicsItem->isVisible() || hwnd() == 0)
+    {
+        m_damageRegion.clear();
+        return;
+    }
+
+    // profile paint (if profiler enabled)
+    XWPROFILE_PAINT(WM_XWUI_GITEM_FLUSH_DAMAGE);
+
+    // check what render method is in use
+    if(m_bDirect2DPaint)
+    {
+        // Direct2D rendering
+        _paintDamageRegionD2D();
+
+    } else
+    {
+        // GDI rendering
+        _paintDamageRegionGDI();
+    }
+
+    // remove damaged areas from update region as they are repainted already
+    for(int idx = 0; idx < m_damageRegion.rectCount(); ++idx)
+    {
+        ::ValidateRect(hwnd(), &m_damageRegion.rectAt(idx));
+    }
+
+    // reset region
+    m_damageRegion.clear();
+}
+
+void XGraphicsItemWindow::_paintDamageRegionGDI()
+{
+    // window DC
+    HDC hdc = ::GetDC(hwnd());
+    if(hdc == 0)
+    {
+        XWTRACE_WERR_LAST("XGraphicsItemWindow: failed to get window DC for repaint");
+        return;
+    }
+
+    // init cache (if not there already)
+    _initGDICache(hdc);
+
+    // client area size
+    RECT rcClient;
+    ::GetClientRect(hwnd(), &rcClient);
+
+    // create double buffering DC if needed
+    HDC hDoubleBufferDC = 0;
+    if(m_bGDIDoubleBuffering && m_pGDIResourcesCache)
+    {
+        // get double buffering DC from cache (or create new)
+        hDoubleBufferDC = m_pGDIResourcesCache->getDoubleBufferDC(hdc, 
+            rcClient.right - rcClient.left, rcClient.bottom - rcClient.top);
+    }
+
+    // check what DC to use
+    HDC hPaintDC = (hDoubleBufferDC != 0) ? hDoubleBufferDC: hdc;
+
+    // paint damaged areas
+    for(int idx = 0; idx < m_damageRegion.rectCount() && m_pXGraphicsItem; ++idx)
+    {
+        RECT rcPaint;
+
+        // ignore areas outside of window
+        if(!XWUtils::rectIntersect(m_damageRegion.rectAt(idx), rcClient, rcPaint)) continue;
+
+        // clip to damaged area 
+        int savedDC = ::SaveDC(hPaintDC);
+        ::IntersectClipRect(hPaintDC, rcPaint.left, rcPaint.top, rcPaint.right, rcPaint.bottom);
+
+        // paint graphics
+        m_pXGraphicsItem->onPaintGDI(hPaintDC, rcPaint);
+
+        // restore clipping
+        ::RestoreDC(hPaintDC, savedDC);
+
+        // copy double buffer to screen
+        if(hDoubleBufferDC)
+        {
+            ::BitBlt(hdc, rcPaint.left, rcPaint.top, rcPaint.right - rcPaint.left, rcPaint.bottom - rcPaint.top, 
+                hDoubleBufferDC, rcPaint.left, rcPaint.top, SRCCOPY);
+        }
+    }
+
+    // release DC
+    ::ReleaseDC(hwnd(), hdc);
+}
+
+void XGraphicsItemWindow::_paintDamageRegionD2D()
+{
+    // init target
+    if(!_initD2DTarget()) return;
+
+    // ignore if window is not visible
+    if(D2D1_WINDOW_STATE_OCCLUDED & m_pRenderTarget->CheckWindowState()) return;
+
+    // NOTE: all damaged areas are painted in one draw call
+    m_pRenderTarget->BeginDraw();
+
+    // paint damaged areas
+    for(int idx = 0; idx < m_damageRegion.rectCount() && m_pXGraphicsItem; ++idx)
+    {
+        m_pXGraphicsItem->onPaintD2D(m_pRenderTarget, m_damageRegion.rectAt(idx));
+    }
+
+    // check if target has to be reset
+    if(D2DERR_RECREATE_TARGET == m_pRenderTarget->EndDraw())
+    {
+        _resetD2DTarget();
+
+        // repaint using WM_PAINT
+        for(int idx = 0; idx < m_damageRegion.rectCount(); ++idx)
+        {
+            ::InvalidateRect(hwnd(), &m_damageRegion.rectAt(idx), FALSE);
+        }
+    }
+}
+
+bool XGraphicsItemWindow::_scrollDamageRect(const RECT& rcScroll, int offsetX, int offsetY)
+{
+    // check if enabled
+    if(!m_bBlitScrolling || hwnd() == 0) return false;
+
+    // ignore if item is not visible
+    if(m_pXGraphicsItem == 0 || !m_pXGraphicsItem->isVisible()) return false;
+
+    // client area size
+    RECT rcClient;
+    ::GetClientRect(hwnd(), &rcClient);
+
+    // only visible part can be moved
+    RECT rcVisible;
+    if(!XWUtils::rectIntersect(rcScroll, rcClient, rcVisible)) return false;
+
+    // check if there is content to reuse
+    if(offsetX >= rcVisible.right - rcVisible.left || -offsetX >= rcVisible.right - rcVisible.left ||
+       offsetY >= rcVisible.bottom - rcVisible.top || -offsetY >= rcVisible.bottom - rcVisible.top) return false;
+
+    // NOTE: area waiting for WM_PAINT is not valid on screen and cannot be moved
+    RECT rcUpdate;
+    if(::GetUpdateRect(hwnd(), &rcUpdate, FALSE) && XWUtils::rectOverlap(rcUpdate, rcVisible)) return false;
+
+    // damaged content is moved as well
+    m_damageRegion.scrollRect(rcVisible, offsetX, offsetY);
+
+    // move content on screen
+    bool contentMoved = m_bDirect2DPaint ? 
+        _scrollContentD2D(rcVisible, offsetX, offsetY) : 
+        _scrollContentGDI(rcVisible, offsetX, offsetY);
+
+    if(!contentMoved) return false;
+
+    // exposed area (vertical strip)
+    RECT rcExposed = rcVisible;
+    if(offsetX > 0)
+    {
+        rcExposed.right = rcVisible.left + offsetX;
+        _addDamageRect(rcExposed, false);
+
+    } else if(offsetX < 0)
+    {
+        rcExposed.left = rcVisible.right + offsetX;
+        _addDamageRect(rcExposed, false);
+    }
+
+    // exposed area (horizontal strip)
+    rcExposed = rcVisible;
+    if(offsetY > 0)
+    {
+        rcExposed.bottom = rcVisible.top + offsetY;
+        _addDamageRect(rcExposed, false);
+
+    } else if(offsetY < 0)
+    {
+        rcExposed.top = rcVisible.bottom + offsetY;
+        _addDamageRect(rcExposed, false);
+    }
+
+    return true;
+}
+
+bool XGraphicsItemWindow::_scrollContentGDI(const RECT& rcScroll, int offsetX, int offsetY)
+{
+    RECT rcInvalid;
+
+    // NOTE: double buffer is not moved as only painted areas are copied from it
+
+    // move content (exposed area is not invalidated and will be painted with damage region)
+    if(ERROR == ::ScrollWindowEx(hwnd(), offsetX, offsetY, &rcScroll, &rcScroll, 0, &rcInvalid, 0))
+    {
+        XWTRACE_WERR_LAST("XGraphicsItemWindow: failed to scroll window content");
+        return false;
+    }
+
+    // add areas system was not able to copy (e.g. covered by other windows)
+    if(!::IsRectEmpty(&rcInvalid))
+    {
+        _addDamageRect(rcInvalid, false);
+    }
+
+    return true;
+}
+
+bool XGraphicsItemWindow::_scrollContentD2D(const RECT& rcScroll, int offsetX, int offsetY)
+{
+    // init target and bitmap
+    if(!_initD2DTarget() || !_initD2DScrollBitmap()) return false;
+
+    // ignore if window is not visible
+    if(D2D1_WINDOW_STATE_OCCLUDED & m_pRenderTarget->CheckWindowState()) return false;
+
+    // NOTE: content is copied from target to bitmap and drawn back with offset, target
+    //       is created with D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS so presented pixels 
+    //       are still valid in its back buffer
+    m_pRenderTarget->BeginDraw();
+
+    // copy content (in pixels)
+    D2D1_POINT_2U ptCopy = D2D1::Point2U(0, 0);
+    D2D1_RECT_U rcCopy = D2D1::RectU(rcScroll.left, rcScroll.top, rcScroll.right, rcScroll.bottom);
+    HRESULT hr = m_pScrollBitmap->CopyFromRenderTarget(&ptCopy, m_pRenderTarget, &rcCopy);
+
+    if(SUCCEEDED(hr))
+    {
+        // source and destination rectangles
+        RECT rcSource = {0, 0, rcScroll.right - rcScroll.left, rcScroll.bottom - rcScroll.top};
+        RECT rcDest = rcScroll;
+        ::OffsetRect(&rcDest, offsetX, offsetY);
+
+        // convert to DIPs
+        D2D1_RECT_F d2dClipRect, d2dSourceRect, d2dDestRect;
+        XD2DHelpers::gdiRectToD2dRect(rcScroll, d2dClipRect);
+        XD2DHelpers::gdiRectToD2dRect(rcSource, d2dSourceRect);
+        XD2DHelpers::gdiRectToD2dRect(rcDest, d2dDestRect);
+
+        // draw moved content inside scrolled area only
+        m_pRenderTarget->PushAxisAlignedClip(d2dClipRect, D2D1_ANTIALIAS_MODE_ALIASED);
+        m_pRenderTarget->DrawBitmap(m_pScrollBitmap, d2dDestRect, 1.0f, 
+            D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, d2dSourceRect);
+        m_pRenderTarget->PopAxisAlignedClip();
+    }
+
+    // check if target has to be reset
+    if(D2DERR_RECREATE_TARGET == m_pRenderTarget->EndDraw())
+    {
+        _resetD2DTarget();
+
+        return false;
+    }
+
+    return SUCCEEDED(hr);
+}
+
+bool XGraphicsItemWindow::_initD2DScrollBitmap()
+{
+    // client area size
+    RECT rcClient;
+    ::GetClientRect(hwnd(), &rcClient);
+
+    UINT32 width = (UINT32)(rcClient.right - rcClient.left);
+    UINT32 height = (UINT32)(rcClient.bottom - rcClient.top);
+
+    // check if existing bitmap is large enough
+    if(m_pScrollBitmap)
+    {
+        D2D1_SIZE_U bitmapSize = m_pScrollBitmap->GetPixelSize();
+        if(bitmapSize.width >= width && bitmapSize.height >= height) return true;
+
+        // release old bitmap
+        m_pScrollBitmap->Release();
+        m_pScrollBitmap = 0;
+    }
+
+    // use the same format as target 
+    FLOAT dpiX, dpiY;
+    m_pRenderTarget->GetDpi(&dpiX, &dpiY);
+    D2D1_BITMAP_PROPERTIES bitmapProps = D2D1::BitmapProperties(m_pRenderTarget->GetPixelFormat(), dpiX, dpiY);
+
+    // create bitmap
+    HRESULT hr = m_pRenderTarget->CreateBitmap(D2D1::SizeU(width, height), bitmapProps, &m_pScrollBitmap);
+    if(FAILED(hr))
+    {
+        XWTRACE_HRES("XGraphicsItemWindow: failed to create scroll bitmap", hr);
+        m_pScrollBitmap = 0;
+        return false;
+    }
+
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////
 // worker methods
 /////////////////////////////////////////////////////////////////////
@@ -1093,6 +1612,9 @@ void XGraphicsItemWindow::_closeResources()
 {
     // close graphics resources
     _closeGraphicsItem(m_pXGraphicsItem);
+
+    // detach from window
+    if(m_pXGraphicsItem) m_pXGraphicsItem->setParentLayoutItem(0);
     
     // delete graphic item
     delete m_pXGraphicsItem;
@@ -1105,6 +1627,9 @@ void XGraphicsItemWindow::_closeResources()
     // reset shared caches if any
     if(m_pSharedGDIResourcesCache) m_pSharedGDIResourcesCache->Release();
     m_pSharedGDIResourcesCache = 0;
+
+    // reset damage region
+    m_damageRegion.clear();
 }
 
 void XGraphicsItemWindow::_initGraphicsItem(XGraphicsItem* pItem, HWND hwnd)
@@ -1306,6 +1831,51 @@ void XGraphicsItemWindow::_onAnimationCompleted(DWORD id)
         animationItem->onAnimationCompleted(id);
 }
 
+void XGraphicsItemWindow::_onAnimationFrame()
+{
+    std::vector<XWAnimationTimer::AnimationEvent> frameEvents;
+
+    // NOTE: use local list in case if message loop is entered from event handler
+    frameEvents.swap(m_animationEvents);
+
+    // take all events of current frame at once
+    XWAnimationTimer::instance()->takeFrameEvents(hwnd(), frameEvents);
+
+    // NOTE: values are passed with events, no need to read them from animation timer
+    for(size_t idx = 0; idx < frameEvents.size(); ++idx)
+    {
+        const XWAnimationTimer::AnimationEvent& frameEvent = frameEvents[idx];
+
+        XGraphicsItem* animationItem = 0;
+
+        // find animation item
+        if(m_pXGraphicsItem)
+            animationItem = m_pXGraphicsItem->findAnimationItem(frameEvent.id);
+
+        // report event if found
+        if(animationItem)
+        {
+            if(frameEvent.type == XWAnimationScheduler::eAnimationTimerEvent)
+                animationItem->onAnimationTimer(frameEvent.id);
+            else if(frameEvent.type == XWAnimationScheduler::eAnimationValueEvent)
+                animationItem->onAnimationValue(frameEvent.id, frameEvent.value);
+            else
+                animationItem->onAnimationCompleted(frameEvent.id);
+
+        } else if(frameEvent.type != XWAnimationScheduler::eAnimationCompletedEvent)
+        {
+            XWTRACE("XGraphicsItemWindow: unknown animation stopped");
+
+            // stop unknown animation
+            XWAnimationTimer::instance()->stopAnimation(frameEvent.id);
+        }
+    }
+
+    // NOTE: keep list memory for next frame
+    frameEvents.clear();
+    m_animationEvents.swap(frameEvents);
+}
+
 void XGraphicsItemWindow::_onContentLoaded(DWORD id, const WCHAR* path)
 {
     XGraphicsItem* contentItem = 0;
@@ -23,11 +23,23 @@ public: // options
     void    enableGDIDoubleBuffering(bool bEnable);
     void    forceGDIRendering(bool bForce);
     void    enableContentScrolling(bool bEnable);
+    void    enableBlitScrolling(bool bEnable);
+
+public: // object pool
+
+    // NOTE: items created in XWObjectPoolScope of window pool are allocated from it, 
+    //       pool is created on first call and released with window. Pool memory is freed
+    //       at once after last object allocated from it is deleted.
+    XWObjectPool*   objectPool();
 
 public: // shared caches
     void    setSharedGDICache(XGdiResourcesCache* pSharedGDICache);
     int     getSharedGDICache(XGdiResourcesCache** pSharedGDICache);
 
+public: // live resize (from XWHWND, shows scaled snapshot and keeps item layout)
+    void    beginLiveResize();
+    void    endLiveResize();
+
 public: // state (from XWHWND)
     void    enable(BOOL bEnable);
     bool    isEnabled();
@@ -80,6 +92,7 @@ protected: // message processing
 
 private: // paint events (from XWindow)
     void    onPaint(HDC hdc, PAINTSTRUCT& ps);
+    bool    onPrintClient(HDC hdc, const RECT& rcClient);
 
 private: // hide background settings (from XWindow)
     void    enableEraseBackground(bool bEnable);
@@ -96,11 +109,22 @@ private: // paint methods
     void    _initGDICache(HDC hdc);
     void    _resetGDICache();
     void    _onPaintWindowD2D(const RECT& rcPaint);
+    bool    _printClientD2D(HDC hdc, const RECT& rcClient);
     bool    _initD2DTarget();
     void    _resetD2DTarget();
     void    _setSharedGDICacheToChildren();
     void    _getSharedGDICacheFromParent();
 
+private: // damage region
+    void    _addDamageRect(const RECT& rect, bool paintNow);
+    void    _flushDamageRegion();
+    void    _paintDamageRegionGDI();
+    void    _paintDamageRegionD2D();
+    bool    _scrollDamageRect(const RECT& rcScroll, int offsetX, int offsetY);
+    bool    _scrollContentGDI(const RECT& rcScroll, int offsetX, int offsetY);
+    bool    _scrollContentD2D(const RECT& rcScroll, int offsetX, int offsetY);
+    bool    _initD2DScrollBitmap();
+
 private: // worker methods
     void    _closeResources();
     void    _initGraphicsItem(XGraphicsItem* pXGraphicsItem, HWND hwnd);
@@ -111,6 +135,7 @@ private: // worker methods
     void    _onAnimationTimerEvent(DWORD id);
     void    _onAnimationValueEvent(DWORD id);
     void    _onAnimationCompleted(DWORD id);
+    void    _onAnimationFrame();
     void    _onContentLoaded(DWORD id, const WCHAR* path);
     void    _onContentLoadFailed(DWORD id, DWORD reason);
     void    _setMouseCapture(HWND hwnd, XGraphicsItem* pXGraphicsItem);
@@ -130,9 +155,21 @@ private: //  data
     bool                m_bDirect2DPaint;
     bool                m_bGDIDoubleBuffering;
     bool                m_bContentScrolling;
+    bool                m_bBlitScrolling;
+
+private: //  animation events of current frame
+    std::vector<XWAnimationTimer::AnimationEvent>   m_animationEvents;
+
+private: //  object pool
+    XWObjectPool*       m_pObjectPool;
+
+private: //  damage region
+    XWDamageRegion      m_damageRegion;
+    bool                m_bDamageFlushPending;
 
 private: //  Direct2D data
     ID2D1HwndRenderTarget*  m_pRenderTarget;
+    ID2D1Bitmap*            m_pScrollBitmap;
 };
 
 // XGraphicsItemWindow
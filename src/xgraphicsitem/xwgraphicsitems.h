@@ -12,6 +12,8 @@
 
 // interfaces
 #include "interfaces/ixscrollbaritem.h"
+#include "interfaces/ixgraphicsitemhost.h"
+#include "interfaces/ixlistviewdatasource.h"
 
 // common items
 #include "items/xtextitem.h"
@@ -58,12 +58,18 @@ void XWHWND::show(int nCmdShow)
 {
     // show window
     ::ShowWindow(m_hWnd, nCmdShow);
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XWHWND::hide()
 {
     // hide window
     ::ShowWindow(m_hWnd, SW_HIDE);
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -243,6 +249,9 @@ void XWHWND::setMinWidth(int minWidth)
 
     // update policy
     m_rpHorizontal = (m_rpHorizontal == eResizeMax) ? eResizeMinMax : eResizeMin;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XWHWND::setMinHeight(int minHeight)
@@ -261,6 +270,9 @@ void XWHWND::setMinHeight(int minHeight)
 
     // update policy
     m_rpVertical = (m_rpVertical == eResizeMax) ? eResizeMinMax : eResizeMin;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XWHWND::setMaxWidth(int maxWidth)
@@ -279,6 +291,9 @@ void XWHWND::setMaxWidth(int maxWidth)
 
     // update policy
     m_rpHorizontal = (m_rpHorizontal == eResizeMin) ? eResizeMinMax : eResizeMax;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 void XWHWND::setMaxHeight(int maxHeight)
@@ -297,6 +312,9 @@ void XWHWND::setMaxHeight(int maxHeight)
 
     // update policy
     m_rpVertical = (m_rpVertical == eResizeMin) ? eResizeMinMax : eResizeMax;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -311,6 +329,9 @@ void XWHWND::setFixedWidth(int width)
     // update policy
     m_rpHorizontal = eResizeMinMax;
 
+    // inform parent layout
+    invalidateResizePolicies();
+
     // resize window
     resize(width, height());
 }
@@ -324,6 +345,9 @@ void XWHWND::setFixedHeight(int height)
     // update policy
     m_rpVertical = eResizeMinMax;
 
+    // inform parent layout
+    invalidateResizePolicies();
+
     // resize window
     resize(width(), height);
 }
@@ -340,6 +364,9 @@ void XWHWND::setFixedSize(int width, int height)
     m_rpHorizontal = eResizeMinMax;
     m_rpVertical = eResizeMinMax;
 
+    // inform parent layout
+    invalidateResizePolicies();
+
     // resize window
     resize(width, height);
 }
@@ -351,6 +378,9 @@ void XWHWND::resetSizePolicy()
 {
     m_rpHorizontal = eResizeAny;
     m_rpVertical = eResizeAny;
+
+    // inform parent layout
+    invalidateResizePolicies();
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -625,6 +655,19 @@ void XWHWND::repaint(BOOL paintNow)
     }
 }
 
+/////////////////////////////////////////////////////////////////////
+// live resize
+/////////////////////////////////////////////////////////////////////
+void XWHWND::beginLiveResize()
+{
+    // do nothing in default implementation (window is resized as usual)
+}
+
+void XWHWND::endLiveResize()
+{
+    // do nothing in default implementation
+}
+
 /////////////////////////////////////////////////////////////////////
 // scrolling
 /////////////////////////////////////////////////////////////////////
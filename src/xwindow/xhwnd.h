@@ -91,6 +91,10 @@ public: // window methods
     void    move(int posX, int posY);
     void    repaint(BOOL paintNow = FALSE);
 
+public: // live resize (size is changed often until resize ends, e.g. splitter is dragged)
+    virtual void    beginLiveResize();
+    virtual void    endLiveResize();
+
 public: // scrolling (from IXWScrollable)
     virtual int     contentWidth();
     virtual int     contentHeight();
@@ -37,7 +37,12 @@ XWindow::XWindow(XWObject* parent) :
     m_bMouseOver(false),
     m_bMouseTracking(false),
     m_mouseHoverX(0),
-    m_mouseHoverY(0)
+    m_mouseHoverY(0),
+    m_hLiveResizeDC(0),
+    m_hLiveResizeBitmap(0),
+    m_hLiveResizeOldBitmap(0),
+    m_nLiveResizeWidth(0),
+    m_nLiveResizeHeight(0)
 {
     // do nothing in default constructor
 }
@@ -57,7 +62,12 @@ XWindow::XWindow(DWORD dwStyle, XWObject* parent, HWND hWndParent, DWORD dwExSty
     m_bMouseOver(false),
     m_bMouseTracking(false),
     m_mouseHoverX(0),
-    m_mouseHoverY(0)
+    m_mouseHoverY(0),
+    m_hLiveResizeDC(0),
+    m_hLiveResizeBitmap(0),
+    m_hLiveResizeOldBitmap(0),
+    m_nLiveResizeWidth(0),
+    m_nLiveResizeHeight(0)
 {
     // create window
     create(dwStyle, hWndParent, dwExStyle);
@@ -133,6 +143,12 @@ void XWindow::setLayout(IXLayout* pLayout)
     // set new layout
     m_pLayout = pLayout;
 
+    // layout informs window about its changes
+    if(m_pLayout) m_pLayout->setParentLayoutItem(this);
+
+    // window size constraints depend on layout
+    invalidateResizePolicies();
+
     // layout items
     onContentChanged();
 }
@@ -241,6 +257,54 @@ void XWindow::show(int nCmdShow)
     repaint(FALSE);
 }
 
+/////////////////////////////////////////////////////////////////////
+// live resize snapshot
+/////////////////////////////////////////////////////////////////////
+bool XWindow::beginLiveResizeSnapshot()
+{
+    // ignore if active already or window not set
+    if(m_liveResize.isActive() || m_hWnd == 0) return false;
+
+    // keep current content to show it while resizing
+    _captureLiveResizeSnapshot();
+
+    // NOTE: window is resized as usual if snapshot is not there
+    return m_liveResize.begin(m_hLiveResizeDC != 0);
+}
+
+void XWindow::endLiveResizeSnapshot()
+{
+    // ignore if not active
+    if(!m_liveResize.isActive()) return;
+
+    // check if size has been changed while snapshot was shown
+    bool resizePending = m_liveResize.end();
+
+    // snapshot is not needed anymore
+    _releaseLiveResizeSnapshot();
+
+    // resize window content if size has been changed
+    if(resizePending)
+    {
+        // get current size
+        RECT rec;
+        if(::GetClientRect(m_hWnd, &rec))
+        {
+            // pass event
+            onResize(SIZE_RESTORED, rec.right - rec.left, rec.bottom - rec.top);
+        }
+    }
+
+    // paint actual content
+    repaint(FALSE);
+}
+
+bool XWindow::onPrintClient(HDC hdc, const RECT& rcClient)
+{
+    // NOTE: window can't paint its content to other DC by default (no snapshot)
+    return false;
+}
+
 /////////////////////////////////////////////////////////////////////
 // context menu
 /////////////////////////////////////////////////////////////////////
@@ -332,6 +396,18 @@ void XWindow::updateResizePolicies()
     }
 }
 
+/////////////////////////////////////////////////////////////////////
+// constraints change notification (from XWHWND)
+/////////////////////////////////////////////////////////////////////
+void XWindow::resetResizePolicies()
+{
+    // pass to layout if set
+    if(m_pLayout)
+    {
+        m_pLayout->resetResizePolicies();
+    }
+}
+
 /////////////////////////////////////////////////////////////////////
 // size constraints (from XWHWND)
 /////////////////////////////////////////////////////////////////////
@@ -462,6 +538,9 @@ void XWindow::onContentChanged()
         RECT rec;
         if(::GetClientRect(m_hWnd, &rec))
         {
+            // NOTE: content may be changed without notification, query all constraints again
+            m_pLayout->resetResizePolicies();
+
             // adjust child windows 
             m_pLayout->update(0, 0, rec.right - rec.left, rec.bottom - rec.top);
         }
@@ -836,6 +915,10 @@ void XWindow::_closeResources()
     // destroy layout
     delete m_pLayout;
     m_pLayout = 0;
+
+    // release live resize snapshot if any
+    _releaseLiveResizeSnapshot();
+    m_liveResize.reset();
 }
 
 void XWindow::_updateSystemsMargins()
@@ -929,6 +1012,101 @@ void XWindow::_startMouseTracking()
     m_bMouseTracking = true;
 }
 
+void XWindow::_captureLiveResizeSnapshot()
+{
+    // release previous if any
+    _releaseLiveResizeSnapshot();
+
+    // get current size
+    RECT rec;
+    if(!::GetClientRect(m_hWnd, &rec) || rec.right <= rec.left || rec.bottom <= rec.top) return;
+
+    int width = rec.right - rec.left;
+    int height = rec.bottom - rec.top;
+
+    // get window DC
+    HDC hdc = ::GetDC(m_hWnd);
+    if(hdc == 0) return;
+
+    // create snapshot bitmap
+    m_hLiveResizeDC = ::CreateCompatibleDC(hdc);
+    m_hLiveResizeBitmap = ::CreateCompatibleBitmap(hdc, width, height);
+
+    // release DC
+    ::ReleaseDC(m_hWnd, hdc);
+
+    if(m_hLiveResizeDC == 0 || m_hLiveResizeBitmap == 0)
+    {
+        XWTRACE("XWindow: failed to create live resize snapshot");
+
+        // window will be painted as usual
+        _releaseLiveResizeSnapshot();
+        return;
+    }
+
+    // select bitmap
+    m_hLiveResizeOldBitmap = ::SelectObject(m_hLiveResizeDC, m_hLiveResizeBitmap);
+
+    // NOTE: window paints its content to snapshot itself instead of copying it from
+    //       screen, so that parts covered by other windows or off screen are not copied
+    if(!onPrintClient(m_hLiveResizeDC, rec))
+    {
+        // window will be painted as usual
+        _releaseLiveResizeSnapshot();
+        return;
+    }
+
+    // keep size
+    m_nLiveResizeWidth = width;
+    m_nLiveResizeHeight = height;
+}
+
+void XWindow::_releaseLiveResizeSnapshot()
+{
+    // release DC
+    if(m_hLiveResizeDC)
+    {
+        // restore old bitmap
+        if(m_hLiveResizeOldBitmap) ::SelectObject(m_hLiveResizeDC, m_hLiveResizeOldBitmap);
+
+        ::DeleteDC(m_hLiveResizeDC);
+    }
+
+    // release bitmap
+    if(m_hLiveResizeBitmap) ::DeleteObject(m_hLiveResizeBitmap);
+
+    // reset data
+    m_hLiveResizeDC = 0;
+    m_hLiveResizeBitmap = 0;
+    m_hLiveResizeOldBitmap = 0;
+    m_nLiveResizeWidth = 0;
+    m_nLiveResizeHeight = 0;
+}
+
+void XWindow::_paintLiveResizeSnapshot()
+{
+    // init painting
+    PAINTSTRUCT  ps;
+    HDC hdc = ::BeginPaint(m_hWnd, &ps);
+
+    // get current size
+    RECT rec;
+    if(::GetClientRect(m_hWnd, &rec))
+    {
+        // NOTE: fast scaling is used as snapshot is shown only until resize ends
+        int oldMode = ::SetStretchBltMode(hdc, COLORONCOLOR);
+
+        // scale snapshot to window size
+        ::StretchBlt(hdc, 0, 0, rec.right - rec.left, rec.bottom - rec.top, 
+            m_hLiveResizeDC, 0, 0, m_nLiveResizeWidth, m_nLiveResizeHeight, SRCCOPY);
+
+        // restore mode
+        if(oldMode) ::SetStretchBltMode(hdc, oldMode);
+    }
+
+    ::EndPaint(m_hWnd, &ps);
+}
+
 LRESULT XWindow::_doProcessMessageHandlers(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
     // reset flag
@@ -937,26 +1115,8 @@ LRESULT XWindow::_doProcessMessageHandlers(HWND hwnd, UINT uMsg, WPARAM wParam,
     // message event
     XWEvent xwEvent(hwnd, uMsg, wParam, lParam);
 
-    // check if we have any events for this message
-    std::vector<XWEventDelegate> handlers = m_xEventMap.findHandlers(xwEvent);
-
-    // process events if any
-    if(handlers.size())
-    {
-        // process all handlers
-        LRESULT retVal = 0;
-        for(unsigned int idx = 0; idx < handlers.size(); ++idx)
-        {
-            // call handler
-            retVal = handlers.at(idx)(xwEvent);
-            
-            // block other handlers if message has been processed
-            if(m_bMessageHandled) return retVal;
-        }
-    }
-
-    // if message is not marked as processed return value will be ignored anyway
-    return 0;
+    // NOTE: handlers are called in place, dispatch stops once message is marked as processed
+    return m_xEventMap.dispatchEvent(xwEvent, m_bMessageHandled);
 }
 
 LRESULT XWindow::_windowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
@@ -981,6 +1141,14 @@ LRESULT XWindow::_windowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         // update layout items first
         _onWindowResized(LOWORD(lParam), HIWORD(lParam));
 
+        // check if live resize snapshot is shown (content is resized once it ends)
+        if(m_liveResize.deferResize())
+        {
+            // scale snapshot to new size
+            ::InvalidateRect(hwnd, 0, FALSE);
+            break;
+        }
+
         onResize((int)wParam, LOWORD(lParam), HIWORD(lParam));
         break;
 
@@ -1006,10 +1174,22 @@ LRESULT XWindow::_windowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         break;
 
     case WM_PAINT:
-        onPaint();
+        // paint content snapshot while live resize is active
+        if(isLiveResizeActive())
+            _paintLiveResizeSnapshot();
+        else
+            onPaint();
         return 0;
         break;
 
+    case WM_PRINTCLIENT:
+        // paint client area to given DC (e.g. PrintWindow) if window supports it
+        {
+            RECT rec;
+            if(::GetClientRect(hwnd, &rec) && onPrintClient((HDC)wParam, rec)) return 0;
+        }
+        break;
+
     default:
         // process message handlers if any
         res = _doProcessMessageHandlers(hwnd, uMsg, wParam, lParam);
@@ -1093,6 +1273,9 @@ LRESULT CALLBACK XWindow::sXWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPAR
         return ::DefWindowProcW(hwnd, uMsg, wParam, lParam);
     }
 
+    // profile message processing (if profiler enabled)
+    XWPROFILE_MESSAGE(uMsg);
+
     // process message
     return pWnd->_windowProc(hwnd, uMsg, wParam, lParam);
 }
@@ -48,6 +48,9 @@ public: // scrolling (from IXWScrollable)
 public: // visibility (from XWHWND)
     void    show(int nCmdShow = SW_SHOW);
 
+public: // live resize snapshot state
+    bool    isLiveResizeActive() const  { return m_liveResize.isActive(); }
+
 public: // context menu
     void    setContextMenu(XPopupMenu* contextMenu);
     void    enableContextMenu(bool enable);
@@ -62,6 +65,9 @@ public: // resize policy (from XWHWND)
     TResizePolicy   verticalPolicy() const;
     void            updateResizePolicies();
 
+public: // constraints change notification (from XWHWND)
+    void    resetResizePolicies();
+
 public: // size constraints (from XWHWND)
     int     minWidth()  const;
     int     minHeight() const;
@@ -107,6 +113,19 @@ protected: // context menu
     virtual bool    onContextMenu(HWND hwndContext, int posX, int posY);
     virtual void    doShowContextMenu(XPopupMenu* contextMenu, int posX, int posY);
 
+protected: // live resize snapshot (for derived windows overriding XWHWND live resize)
+
+    // NOTE: while snapshot is shown layout of child windows is updated as usual, but
+    //       onResize is delayed until snapshot ends and window shows its content scaled
+    //       to current size, so that derived window keeps its content layout (e.g. text
+    //       line breaks) and doesn't repaint on each size change. Use it only if window
+    //       doesn't position child windows in onResize. Snapshot is painted by window
+    //       itself with onPrintClient (also used for WM_PRINTCLIENT), it is not started
+    //       if window can't paint to bitmap (window is resized as usual then).
+    bool    beginLiveResizeSnapshot();
+    void    endLiveResizeSnapshot();
+    virtual bool    onPrintClient(HDC hdc, const RECT& rcClient);
+
 protected: // timers
     bool    startTimer(WPARAM uIDEvent, UINT uElapseMs);
     bool    stopTimer(WPARAM uIDEvent);
@@ -127,6 +146,9 @@ private: // worker methods
     void    _onWindowResized(int width, int height);
     void    _onMinMaxInfoRequested(WPARAM wParam, LPARAM lParam);
     void    _startMouseTracking();
+    void    _captureLiveResizeSnapshot();
+    void    _releaseLiveResizeSnapshot();
+    void    _paintLiveResizeSnapshot();
     LRESULT _doProcessMessageHandlers(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
     LRESULT _windowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
@@ -160,6 +182,14 @@ private: // data
     bool        m_bMouseTracking;
     int         m_mouseHoverX;
     int         m_mouseHoverY;
+
+private: // live resize
+    XWLiveResizeState   m_liveResize;
+    HDC         m_hLiveResizeDC;
+    HBITMAP     m_hLiveResizeBitmap;
+    HGDIOBJ     m_hLiveResizeOldBitmap;
+    int         m_nLiveResizeWidth;
+    int         m_nLiveResizeHeight;
 };
 
 // XWindow
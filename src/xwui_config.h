@@ -16,6 +16,7 @@
 #include <tchar.h>
 #include <commctrl.h>
 #include <limits.h>
+#include <math.h>
 #include <crtdbg.h>
 #include <comdef.h>
 
@@ -25,24 +26,15 @@
 #include <d2d1helper.h>
 
 /////////////////////////////////////////////////////////////////////
-// standard library
-#include <string>
-#include <vector>
-#include <list>
-#include <map>
-#include <unordered_map>
-#include <algorithm>
-#include <set>
+// standard library and platform independent core
+#include "core/xwcore_config.h"
 
 /////////////////////////////////////////////////////////////////////
 // core
-#include "core/xwdebug.h"
+#include "core/xwprofiler.h"
 #include "core/xweventmap.h"
-#include "core/xwobjecteventmap.h"
-#include "core/xwobject.h"
 #include "core/xwkeys.h"
-#include "core/xwscrollable.h"
-#include "core/xwscrollviewlogic.h"
+#include "core/xwdamageregion.h"
 #include "core/xwmessagehook.h"
 #include "core/xwmessages.h"
 #include "core/xtextstyle.h"
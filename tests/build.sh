@@ -0,0 +1,116 @@
+#!/bin/sh
+# xWUI - headless core tests and benchmarks
+#
+# Builds platform independent core sources (see src/core/xwcore_config.h) together
+# with tests and benchmarks from this directory, no Windows headers are needed.
+#
+# usage: ./build.sh [test|bench]
+#   no argument     build all binaries into tests/bin
+#   test            build and run tests (*_test)
+#   bench           build and run benchmarks (*_bench)
+#
+# compiler and flags may be changed with CXX and CXXFLAGS
+#
+#####################################################################
+
+set -e
+
+cd "$(dirname "$0")"
+
+CXX=${CXX:-g++}
+
+# NOTE: sources don't keep member initialization order (MSVC doesn't warn about it)
+CXXFLAGS=${CXXFLAGS:-"-std=c++14 -O2 -Wall -Wno-reorder"}
+
+SRC=../src
+BIN=bin
+
+mkdir -p $BIN
+
+# build <name> <options and core sources...>
+build()
+{
+    name=$1
+    shift
+
+    echo "building $name"
+    $CXX $CXXFLAGS -I$SRC -o $BIN/$name $name.cpp "$@" -pthread
+}
+
+#####################################################################
+# sources
+
+SCHEDULER_SRC="$SRC/core/xwanimationscheduler.cpp $SRC/core/xweasingcurve.cpp"
+
+OBJECT_SRC="$SRC/core/xwobject.cpp $SRC/core/xwobjectpool.cpp $SRC/core/xwobjecteventmap.cpp"
+
+FENWICK_SRC="$SRC/core/xwfenwicktree.cpp"
+
+SCROLL_SRC="$SRC/core/xwscrollable.cpp $SRC/core/xwscrollviewlogic.cpp"
+
+LAYOUT_SRC="$SRC/layout/xlayoutitem.cpp $SRC/layout/xlayout.cpp $SRC/layout/xlayoutsizesolver.cpp \
+            $SRC/layout/xhboxlayout.cpp $SRC/layout/xvboxlayout.cpp $SRC/layout/xgridlayout.cpp"
+
+# NOTE: graphics item is built with shim, its Windows part is replaced by xwheadlessitem.cpp
+HEADLESS_SRC="-include xwwinshim.h xwheadless.cpp xwheadlessitem.cpp $SRC/xgraphicsitem/xgraphicsitem.cpp \
+              $OBJECT_SRC $SCROLL_SRC $LAYOUT_SRC"
+
+# box layouts with previous algorithm as reference
+BOXLAYOUT_SRC="xboxlayout_reference.cpp $OBJECT_SRC $LAYOUT_SRC"
+
+GRIDLAYOUT_SRC="$OBJECT_SRC $LAYOUT_SRC"
+
+# box layouts before constraint cache as reference
+LAYOUTCACHE_SRC="xboxlayout_uncached.cpp $OBJECT_SRC $LAYOUT_SRC"
+
+# NOTE: sources below include xwui_config.h, shim replaces it with Win32 types subset
+EVENTMAP_SRC="-include xwwinshim.h $SRC/core/xweventmap.cpp"
+
+HOOK_SRC="-include xwwinshim.h $SRC/core/xwmessagehook.cpp xwtestheap.cpp"
+
+GRID_SRC="-include xwwinshim.h $SRC/xctrls/xwgridcolumnstore.cpp xwtestheap.cpp"
+
+POOL_SRC="$OBJECT_SRC xwtestheap.cpp"
+
+# graphics item tree with and without pool
+POOL_BENCH_SRC="$HEADLESS_SRC xwtestheap.cpp"
+
+DAMAGE_SRC="-include xwwinshim.h $SRC/core/xwdamageregion.cpp"
+
+LIVERESIZE_SRC="$SRC/core/xwliveresize.cpp"
+
+# splitter drag over graphics item tree
+LIVERESIZE_BENCH_SRC="$HEADLESS_SRC $LIVERESIZE_SRC"
+
+#####################################################################
+# targets
+
+build xwanimationscheduler_test $SCHEDULER_SRC
+build xwanimationscheduler_bench $SCHEDULER_SRC
+build xweasingcurve_bench $SCHEDULER_SRC
+build xwfenwicktree_test $FENWICK_SRC
+build xwheadless_test $HEADLESS_SRC
+build xwheadless_bench $HEADLESS_SRC
+build xweventmap_bench $EVENTMAP_SRC
+build xwmessagehook_test $HOOK_SRC
+build xwgridcolumnstore_bench $GRID_SRC
+build xwdamageregion_test $DAMAGE_SRC
+build xwobjectpool_test $POOL_SRC
+build xwobjectpool_bench $POOL_BENCH_SRC
+build xwliveresize_test $LIVERESIZE_SRC
+build xwliveresize_bench $LIVERESIZE_BENCH_SRC
+build xboxlayout_test $BOXLAYOUT_SRC
+build xboxlayout_bench $BOXLAYOUT_SRC
+build xgridlayout_test $GRIDLAYOUT_SRC
+build xgridlayout_bench $GRIDLAYOUT_SRC
+build xlayoutcache_bench $LAYOUTCACHE_SRC
+
+#####################################################################
+# run
+
+if [ "$1" = "test" ] || [ "$1" = "bench" ]; then
+    for target in $BIN/*_$1; do
+        echo "running $target"
+        ./$target
+    done
+fi
@@ -0,0 +1,84 @@
+// Box layouts benchmarks (XLayoutSizeSolver based layouts vs previous algorithm)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "layout/xlayoutitem.h"
+#include "layout/xlayout.h"
+#include "layout/xlayoutsizesolver.h"
+#include "layout/xhboxlayout.h"
+#include "layout/xvboxlayout.h"
+
+#include "xboxlayout_reference.h"
+
+#include "xwtest.h"
+
+// NOTE: stretched items with growing minimum sizes, layout width is set so that about
+//       half of items are clamped to minimum size. Previous algorithm restarts its scan
+//       on each clamped item.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_UPDATES           5
+
+/////////////////////////////////////////////////////////////////////
+// layout item with minimum width
+
+class XBenchLayoutItem : public IXLayoutItem
+{
+public: // construction/destruction
+    XBenchLayoutItem() : minW(0) {}
+
+public: // IXLayoutItem
+    TResizePolicy   horizontalPolicy() const    { return eResizeMin; }
+    int             minWidth() const            { return minW; }
+    int             maxWidth() const            { return 100000; }
+
+public: // data
+    int     minW;
+};
+
+/////////////////////////////////////////////////////////////////////
+// benchmarks
+
+template <class _HBoxLayout>
+static double benchUpdate(int itemCount)
+{
+    _HBoxLayout layout;
+    std::vector<XBenchLayoutItem> items(itemCount);
+
+    for(int idx = 0; idx < itemCount; ++idx)
+    {
+        items[idx].minW = idx;
+        layout.addItem(&items[idx], 1);
+    }
+
+    XWTestTimer timer;
+    for(int update = 0; update < BENCH_UPDATES; ++update)
+    {
+        layout.update(0, 0, itemCount * itemCount / 2 + update * 1000, 100);
+    }
+
+    return (double)timer.elapsedUs() / (1000.0 * BENCH_UPDATES);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    static const int itemCounts[] = {500, 2000, 8000};
+
+    for(int idx = 0; idx < 3; ++idx)
+    {
+        double refMs = benchUpdate<XRefHBoxLayout>(itemCounts[idx]);
+        double solverMs = benchUpdate<XHBoxLayout>(itemCounts[idx]);
+
+        printf("%5d stretched items: previous %8.2f ms, solver %6.2f ms per update (%.0fx)\n",
+               itemCounts[idx], refMs, solverMs, refMs / solverMs);
+    }
+
+    return 0;
+}
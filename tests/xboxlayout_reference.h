@@ -0,0 +1,215 @@
+// Reference box layouts (previous layout algorithm, used by differential tests)
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XBOXLAYOUT_REFERENCE_H_
+#define _XBOXLAYOUT_REFERENCE_H_
+
+// NOTE: XRefHBoxLayout and XRefVBoxLayout are XHBoxLayout and XVBoxLayout as they were
+//       before size distribution was moved to XLayoutSizeSolver, only classes are
+//       renamed. They distribute size iteratively and read constraints of items on
+//       each update, so nested layouts need second update after constraints change.
+//       Do not fix them, they define expected results.
+
+#include "core/xwcore_config.h"
+
+#include "layout/xlayoutitem.h"
+#include "layout/xlayout.h"
+
+/////////////////////////////////////////////////////////////////////
+// XRefHBoxLayout - horizontal box layout engine 
+
+class XRefHBoxLayout : public IXLayout,
+                       public XWObject
+{
+public: // construction/destruction
+    XRefHBoxLayout(XWObject* parent = 0);
+    virtual ~XRefHBoxLayout();
+
+public: // alignment
+    enum TAlignment
+    {
+        eAlignTop,
+        eAlignBottom,
+        eAlignCenter
+    };
+
+public: // add items
+    void    addItem(IXLayoutItem* item, int stretch = 0, TAlignment alignment = eAlignCenter);
+
+public: // extra items
+    void    addSpaceItem(int size);
+    void    addStretchItem(int stretch);
+
+public: // item spacing
+    void    setSpacing(int spacing);
+    int     spacing() const     { return m_nSpacing; }
+
+public: // enum layout items (from IXLayout)
+    int             layoutItemCount() const;
+    void            removelayoutItemAt(int idx);
+    IXLayoutItem*   layoutItemAt(int idx) const;
+
+public: // layout items by id (from IXLayout)
+    void            removelayoutItem(unsigned long itemId);
+    IXLayoutItem*   layoutItem(unsigned long itemId) const;
+
+public: // manipulations (from IXLayout)
+    void    update(int posX, int posY, int width, int height);
+
+public: // resize policy (from IXLayout)
+    TResizePolicy   horizontalPolicy() const;
+    TResizePolicy   verticalPolicy() const;
+    void            updateResizePolicies();
+
+public: // size constraints (from IXLayout)
+    int     minWidth()  const;
+    int     minHeight() const;
+    int     maxWidth()  const;
+    int     maxHeight() const;
+
+private: // worker methods
+    void    _onItemAdded(IXLayoutItem* item);
+    void    _onItemRemoved(IXLayoutItem* item);
+    void    _updateResizePolicy();
+
+private: // layout methods
+    void    _updateVisibleCount();
+    void    _updateVerticalLayout(int posY, int height);
+    void    _initLayoutCache(int& fixedSize, int& freeItems, int& totalStretch);
+    void    _findItemSize(int& sizeLeft, int& itemsLeft, int& stretchItems, bool preserveMinSize);
+    void    _updateHorizontalLayout(int posX, int width);
+
+private: // item reference
+    struct _ItemRef
+    {
+        // layout data
+        IXLayoutItem*   item;
+        TAlignment      alignment;
+        int             stretch;
+
+        // resizing cache
+        int     posX, posY;
+        int     width, height;
+        bool    ready;
+    };
+
+private: // items
+    std::vector<_ItemRef>       m_layoutItems;
+    std::vector<IXLayoutItem*>  m_spaceItems;
+    int                         m_visibleCount;
+
+private: // policy
+    TResizePolicy   m_rpHorizontal;
+    TResizePolicy   m_rpVertical;
+
+private: // data
+    int     m_nSpacing;
+    int     m_nMinWidth;
+    int     m_nMinHeight;
+    int     m_nMaxWidth;
+    int     m_nMaxHeight;
+};
+
+// XRefHBoxLayout
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XRefVBoxLayout - vertical layout manager 
+
+class XRefVBoxLayout : public IXLayout,
+                       public XWObject
+{
+public: // construction/destruction
+    XRefVBoxLayout(XWObject* parent = 0);
+    virtual ~XRefVBoxLayout();
+
+public: // alignment
+    enum TAlignment
+    {
+        eAlignLeft,
+        eAlignRight,
+        eAlignCenter
+    };
+
+public: // add items
+    void    addItem(IXLayoutItem* item, int stretch = 0, TAlignment alignment = eAlignLeft);
+
+public: // extra items
+    void    addSpaceItem(int size);
+    void    addStretchItem(int stretch);
+
+public: // item spacing
+    void    setSpacing(int spacing);
+    int     spacing() const     { return m_nSpacing; }
+
+public: // enum layout items (from IXLayout)
+    int             layoutItemCount() const;
+    void            removelayoutItemAt(int idx);
+    IXLayoutItem*   layoutItemAt(int idx) const;
+
+public: // layout items by id (from IXLayout)
+    void            removelayoutItem(unsigned long itemId);
+    IXLayoutItem*   layoutItem(unsigned long itemId) const;
+
+public: // manipulations (from IXLayout)
+    void    update(int posX, int posY, int width, int height);
+
+public: // resize policy (from IXLayout)
+    TResizePolicy   horizontalPolicy() const;
+    TResizePolicy   verticalPolicy() const;
+    void            updateResizePolicies();
+
+public: // size constraints (from IXLayout)
+    int     minWidth()  const;
+    int     minHeight() const;
+    int     maxWidth()  const;
+    int     maxHeight() const;
+
+private: // worker methods
+    void    _onItemAdded(IXLayoutItem* item);
+    void    _onItemRemoved(IXLayoutItem* item);
+    void    _updateResizePolicy();
+
+private: // layout methods
+    void    _updateVisibleCount();
+    void    _updateHorizontalLayout(int posX, int width);
+    void    _initLayoutCache(int& fixedSize, int& freeItems, int& totalStretch);
+    void    _findItemSize(int& sizeLeft, int& itemsLeft, int& stretchItems, bool preserveMinSize);
+    void    _updateVerticalLayout(int posY, int height);
+
+private: // item reference
+    struct _ItemRef
+    {
+        // layout data
+        IXLayoutItem*   item;
+        TAlignment      alignment;
+        int             stretch;
+
+        // resizing cache
+        int     posX, posY;
+        int     width, height;
+        bool    ready;
+    };
+
+private: // items
+    std::vector<_ItemRef>       m_layoutItems;
+    std::vector<IXLayoutItem*>  m_spaceItems;
+    int                         m_visibleCount;
+
+private: // policy
+    TResizePolicy   m_rpHorizontal;
+    TResizePolicy   m_rpVertical;
+
+private: // data
+    int     m_nSpacing;
+    int     m_nMinWidth;
+    int     m_nMinHeight;
+    int     m_nMaxWidth;
+    int     m_nMaxHeight;
+};
+
+// XRefVBoxLayout
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XBOXLAYOUT_REFERENCE_H_
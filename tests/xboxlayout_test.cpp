@@ -0,0 +1,375 @@
+// Box layouts differential test (XLayoutSizeSolver based layouts vs previous algorithm)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "layout/xlayoutitem.h"
+#include "layout/xlayout.h"
+#include "layout/xlayoutsizesolver.h"
+#include "layout/xhboxlayout.h"
+#include "layout/xvboxlayout.h"
+
+#include "xboxlayout_reference.h"
+
+#include "xwtest.h"
+
+// NOTE: the same random nested layout is built twice, from current box layouts and
+//       from reference layouts (see xboxlayout_reference.h), then both are updated with
+//       random sizes while constraints of random items change. All item rectangles and
+//       root constraints must be equal. Reference layouts are updated twice, as nested
+//       reference layouts see changed constraints only on second update. Some visibility
+//       changes are not notified, current layouts must pick them on next update.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define TEST_LAYOUTS_DEFAULT    10000       // may be changed by first argument (120000 takes ~2 minutes)
+#define TEST_UPDATES            6           // updates of each layout
+#define TEST_MAX_FAILURES       10          // failures reported
+
+/////////////////////////////////////////////////////////////////////
+// layout item with constraints set by test
+
+struct XTestRect
+{
+    int     posX;
+    int     posY;
+    int     width;
+    int     height;
+
+    bool operator!=(const XTestRect& other) const
+    {
+        return posX != other.posX || posY != other.posY || width != other.width || height != other.height;
+    }
+};
+
+class XTestLayoutItem : public IXLayoutItem
+{
+public: // construction/destruction
+    XTestLayoutItem(std::vector<XTestRect>* rects) :
+        visible(true), hPolicy(eResizeAny), vPolicy(eResizeAny),
+        minW(0), maxW(0), minH(0), maxH(0), m_rects(rects), m_index((int)rects->size())
+    {
+        XTestRect rect = {0, 0, 0, 0};
+        m_rects->push_back(rect);
+    }
+
+public: // IXLayoutItem
+    bool            isVisible() const           { return visible; }
+    TResizePolicy   horizontalPolicy() const    { return hPolicy; }
+    TResizePolicy   verticalPolicy() const      { return vPolicy; }
+    int             minWidth() const            { return minW; }
+    int             maxWidth() const            { return maxW; }
+    int             minHeight() const           { return minH; }
+    int             maxHeight() const           { return maxH; }
+
+    void update(int posX, int posY, int width, int height)
+    {
+        XTestRect rect = {posX, posY, width, height};
+        (*m_rects)[m_index] = rect;
+    }
+
+public: // constraints
+    bool            visible;
+    TResizePolicy   hPolicy;
+    TResizePolicy   vPolicy;
+    int             minW;
+    int             maxW;
+    int             minH;
+    int             maxH;
+
+private: // data
+    std::vector<XTestRect>*     m_rects;
+    int                         m_index;
+};
+
+/////////////////////////////////////////////////////////////////////
+// random layout description
+
+struct XTestLayoutSpec
+{
+    int     kind;           // 0 - item, 1 - horizontal box, 2 - vertical box
+    bool    visible;
+    int     hPolicy;
+    int     vPolicy;
+    int     minW, maxW;
+    int     minH, maxH;
+    int     stretch;
+    int     alignment;
+    int     spacing;
+    int     margins[4];
+
+    std::vector<XTestLayoutSpec>    childs;
+};
+
+static XTestLayoutSpec createSpec(XWTestRandom& random, int depth, int scale)
+{
+    XTestLayoutSpec spec;
+
+    // some items are nested layouts
+    spec.kind = (depth > 0 && random.range(0, 4) == 0) ? random.range(1, 2) : 0;
+    spec.visible = (random.range(0, 9) != 0);
+
+    // any policy, maximum size may be below minimum size
+    spec.hPolicy = random.range(0, 3);
+    spec.vPolicy = random.range(0, 3);
+    spec.minW = random.range(0, scale);
+    spec.maxW = random.range(0, 1) ? spec.minW + random.range(0, scale) : random.range(0, scale);
+    spec.minH = random.range(0, scale);
+    spec.maxH = random.range(0, 1) ? spec.minH + random.range(0, scale) : random.range(0, scale);
+
+    // fixed size items
+    if(random.range(0, 5) == 0) spec.maxW = spec.minW;
+    if(random.range(0, 5) == 0) spec.maxH = spec.minH;
+
+    // small and large stretch factors
+    spec.stretch = random.range(0, 2) ? 0 : random.range(0, random.range(0, 1) ? 5 : 1000);
+    spec.alignment = random.range(0, 2);
+
+    // layout properties
+    spec.spacing = random.range(0, 8);
+    for(int idx = 0; idx < 4; ++idx)
+    {
+        spec.margins[idx] = random.range(0, 6);
+    }
+
+    // child items (many items at lower levels only)
+    if(spec.kind)
+    {
+        int childCount = random.range(0, depth > 1 ? 6 : 40);
+        for(int idx = 0; idx < childCount; ++idx)
+        {
+            spec.childs.push_back(createSpec(random, depth - 1, scale));
+        }
+    }
+
+    return spec;
+}
+
+/////////////////////////////////////////////////////////////////////
+// layout built from description
+
+template <class _BoxLayout, class _HBoxLayout, class _VBoxLayout>
+static void addChildItems(_BoxLayout* layout, const XTestLayoutSpec& spec, XWTestRandom& random,
+                          std::vector<XTestRect>& rects, std::vector<XTestLayoutItem*>& items, std::vector<IXLayoutItem*>& owned);
+
+template <class _HBoxLayout, class _VBoxLayout>
+static IXLayoutItem* createLayout(const XTestLayoutSpec& spec, XWTestRandom& random,
+                                  std::vector<XTestRect>& rects, std::vector<XTestLayoutItem*>& items, std::vector<IXLayoutItem*>& owned)
+{
+    IXLayoutItem* layoutItem = 0;
+
+    if(spec.kind == 0)
+    {
+        XTestLayoutItem* item = new XTestLayoutItem(&rects);
+        item->visible = spec.visible;
+        item->hPolicy = (IXLayoutItem::TResizePolicy)spec.hPolicy;
+        item->vPolicy = (IXLayoutItem::TResizePolicy)spec.vPolicy;
+        item->minW = spec.minW;
+        item->maxW = spec.maxW;
+        item->minH = spec.minH;
+        item->maxH = spec.maxH;
+
+        items.push_back(item);
+        layoutItem = item;
+
+    } else if(spec.kind == 1)
+    {
+        _HBoxLayout* layout = new _HBoxLayout;
+        addChildItems<_HBoxLayout, _HBoxLayout, _VBoxLayout>(layout, spec, random, rects, items, owned);
+        layoutItem = layout;
+
+    } else
+    {
+        _VBoxLayout* layout = new _VBoxLayout;
+        addChildItems<_VBoxLayout, _HBoxLayout, _VBoxLayout>(layout, spec, random, rects, items, owned);
+        layoutItem = layout;
+    }
+
+    // NOTE: child items are added before parent, so they are deleted first
+    owned.push_back(layoutItem);
+
+    return layoutItem;
+}
+
+template <class _BoxLayout, class _HBoxLayout, class _VBoxLayout>
+static void addChildItems(_BoxLayout* layout, const XTestLayoutSpec& spec, XWTestRandom& random,
+                          std::vector<XTestRect>& rects, std::vector<XTestLayoutItem*>& items, std::vector<IXLayoutItem*>& owned)
+{
+    layout->setSpacing(spec.spacing);
+    layout->setContentMargins(spec.margins[0], spec.margins[1], spec.margins[2], spec.margins[3]);
+
+    for(size_t idx = 0; idx < spec.childs.size(); ++idx)
+    {
+        const XTestLayoutSpec& child = spec.childs[idx];
+
+        // some items are replaced by space or stretch items
+        if(child.kind == 0 && random.range(0, 9) == 0)
+        {
+            if(random.range(0, 1))
+                layout->addSpaceItem(child.minW);
+            else
+                layout->addStretchItem(child.stretch);
+
+            continue;
+        }
+
+        IXLayoutItem* childItem = createLayout<_HBoxLayout, _VBoxLayout>(child, random, rects, items, owned);
+        layout->addItem(childItem, child.stretch, (typename _BoxLayout::TAlignment)child.alignment);
+    }
+}
+
+static void deleteLayout(std::vector<IXLayoutItem*>& owned)
+{
+    for(size_t idx = 0; idx < owned.size(); ++idx)
+    {
+        delete owned[idx];
+    }
+
+    owned.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testRandomLayouts(int layoutCount)
+{
+    long long cases = 0;
+    int failures = 0;
+
+    for(int layoutIdx = 0; layoutIdx < layoutCount && failures < TEST_MAX_FAILURES; ++layoutIdx)
+    {
+        XWTestRandom random(layoutIdx + 1);
+
+        // small, medium and large sizes
+        int scale = (layoutIdx % 3 == 0) ? 20 : (layoutIdx % 3 == 1) ? 300 : 30000;
+
+        // root layout, sometimes with many items
+        XTestLayoutSpec spec = createSpec(random, 3, scale);
+        spec.kind = random.range(1, 2);
+        spec.childs.clear();
+
+        int childCount = random.range(1, (layoutIdx % 7 == 0) ? 400 : 30);
+        for(int idx = 0; idx < childCount; ++idx)
+        {
+            spec.childs.push_back(createSpec(random, 2, scale));
+        }
+
+        // build both layouts with the same random choices
+        unsigned int buildSeed = random.next();
+
+        std::vector<XTestRect> refRects, rects;
+        std::vector<XTestLayoutItem*> refItems, items;
+        std::vector<IXLayoutItem*> refOwned, owned;
+
+        XWTestRandom refBuildRandom(buildSeed);
+        IXLayoutItem* refLayout = createLayout<XRefHBoxLayout, XRefVBoxLayout>(spec, refBuildRandom, refRects, refItems, refOwned);
+
+        XWTestRandom buildRandom(buildSeed);
+        IXLayoutItem* layout = createLayout<XHBoxLayout, XVBoxLayout>(spec, buildRandom, rects, items, owned);
+
+        for(int update = 0; update < TEST_UPDATES && failures < TEST_MAX_FAILURES; ++update)
+        {
+            bool notNotified = false;
+
+            // change constraints of few items
+            if(update > 0 && !items.empty() && random.range(0, 1))
+            {
+                int changes = random.range(1, 3);
+                for(int change = 0; change < changes; ++change)
+                {
+                    int idx = random.range(0, (int)items.size() - 1);
+                    int what = random.range(0, 3);
+                    int value = random.range(0, scale);
+
+                    XTestLayoutItem* changed[2] = {refItems[idx], items[idx]};
+                    for(int side = 0; side < 2; ++side)
+                    {
+                        XTestLayoutItem* item = changed[side];
+
+                        if(what == 0)
+                        {
+                            item->visible = !item->visible;
+
+                        } else if(what == 1)
+                        {
+                            item->minW = value;
+                            item->hPolicy = IXLayoutItem::eResizeMin;
+
+                        } else if(what == 2)
+                        {
+                            item->maxH = value;
+                            item->vPolicy = IXLayoutItem::eResizeMax;
+
+                        } else
+                        {
+                            item->minH = value;
+                            item->maxH = value;
+                            item->vPolicy = IXLayoutItem::eResizeMinMax;
+                        }
+                    }
+
+                    // visibility change is sometimes not notified
+                    if(what != 0 || random.range(0, 1))
+                        items[idx]->invalidateResizePolicies();
+                    else
+                        notNotified = true;
+                }
+            }
+
+            // negative and very large sizes too
+            int width = random.range(-10, scale * 30);
+            int height = random.range(-10, scale * 30);
+
+            refLayout->update(3, 5, width, height);
+            refLayout->update(3, 5, width, height);
+
+            layout->update(3, 5, width, height);
+            if(notNotified) layout->update(3, 5, width, height);
+
+            ++cases;
+
+            // root constraints
+            if(refLayout->minWidth() != layout->minWidth() || refLayout->maxHeight() != layout->maxHeight())
+            {
+                printf("layout %d update %d: constraints differ, reference %d %d, solver %d %d\n", layoutIdx, update,
+                       refLayout->minWidth(), refLayout->maxHeight(), layout->minWidth(), layout->maxHeight());
+                ++failures;
+                break;
+            }
+
+            // item rectangles
+            for(size_t idx = 0; idx < refRects.size(); ++idx)
+            {
+                if(refRects[idx] != rects[idx])
+                {
+                    printf("layout %d update %d item %zu: reference %d,%d %dx%d, solver %d,%d %dx%d\n", layoutIdx, update, idx,
+                           refRects[idx].posX, refRects[idx].posY, refRects[idx].width, refRects[idx].height,
+                           rects[idx].posX, rects[idx].posY, rects[idx].width, rects[idx].height);
+                    ++failures;
+                    break;
+                }
+            }
+        }
+
+        deleteLayout(refOwned);
+        deleteLayout(owned);
+    }
+
+    XWTEST_CHECK(failures == 0);
+
+    printf("%d random layouts, %lld updates compared\n", layoutCount, cases);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main(int argc, char** argv)
+{
+    int layoutCount = (argc > 1) ? atoi(argv[1]) : TEST_LAYOUTS_DEFAULT;
+
+    testRandomLayouts(layoutCount);
+
+    return xwtestResult("xboxlayout_test");
+}
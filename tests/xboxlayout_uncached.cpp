@@ -0,0 +1,905 @@
+// Reference box layouts without constraint cache (used by benchmarks)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xboxlayout_uncached.h"
+
+/////////////////////////////////////////////////////////////////////
+// XUncachedHSpaceItem - horizontal space layout item 
+
+class XUncachedHSpaceItem : public IXLayoutItem
+{
+public: // construction/destruction
+    XUncachedHSpaceItem(int width) : m_nWidth(width) {}
+    virtual ~XUncachedHSpaceItem(){}
+
+public: // resize policy
+    TResizePolicy   horizontalPolicy() const
+    {
+        // size is fixed
+        return eResizeMinMax;
+    }
+
+public: // size constraints
+    virtual int minWidth() const   { return m_nWidth; }
+    virtual int maxWidth() const   { return m_nWidth; }
+
+private: // data
+    int     m_nWidth;
+};
+
+// XUncachedHSpaceItem
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XUncachedHBoxLayout - horizontal layout manager 
+XUncachedHBoxLayout::XUncachedHBoxLayout(XWObject* parent) :
+    XWObject(parent),
+    m_nSpacing(0),
+    m_visibleCount(0),
+    m_rpHorizontal(eResizeAny),
+    m_rpVertical(eResizeAny),
+    m_nMinWidth(0),
+    m_nMinHeight(0),
+    m_nMaxWidth(0),
+    m_nMaxHeight(0)
+{
+}
+
+XUncachedHBoxLayout::~XUncachedHBoxLayout()
+{
+    // delete all space items
+    for(size_t idx = 0; idx < m_spaceItems.size(); ++idx)
+    {
+        delete m_spaceItems.at(idx);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// add items (NOTE: layout takes ownership)
+/////////////////////////////////////////////////////////////////////
+void XUncachedHBoxLayout::addItem(IXLayoutItem* item, int stretch, TAlignment alignment)
+{
+    _ItemRef itemRef;
+
+    // fill item
+    itemRef.item = item;
+    itemRef.stretch = stretch;
+    itemRef.alignment = alignment;
+
+    // add to index
+    m_layoutItems.push_back(itemRef);
+
+    // process item
+    _onItemAdded(item);
+}
+
+/////////////////////////////////////////////////////////////////////
+// extra items
+/////////////////////////////////////////////////////////////////////
+void XUncachedHBoxLayout::addSpaceItem(int size)
+{
+    // create new space item
+    XUncachedHSpaceItem* item = new XUncachedHSpaceItem(size);
+
+    // add to space items list
+    m_spaceItems.push_back(item);
+
+    // add to layout
+    addItem(item);
+}
+
+void XUncachedHBoxLayout::addStretchItem(int stretch)
+{
+    // create dummy item
+    IXLayoutItem* item = new IXLayoutItem;
+
+    // add to space items list
+    m_spaceItems.push_back(item);
+
+    // add to layout
+    addItem(item, stretch);
+}
+
+/////////////////////////////////////////////////////////////////////
+// item spacing
+/////////////////////////////////////////////////////////////////////
+void XUncachedHBoxLayout::setSpacing(int spacing)
+{
+    m_nSpacing = spacing;
+}
+
+/////////////////////////////////////////////////////////////////////
+// enum layout items (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+int XUncachedHBoxLayout::layoutItemCount() const
+{
+    return (int)m_layoutItems.size();
+}
+
+void XUncachedHBoxLayout::removelayoutItemAt(int idx)
+{
+    if(idx >= 0 && idx < (int) m_layoutItems.size())
+    {
+        // remove from index
+        m_layoutItems.erase(m_layoutItems.begin() + idx);
+
+    } else
+    {
+        XWASSERT1(0, "XUncachedHBoxLayout::removelayoutItemAt index is out of range");
+    }
+}
+
+IXLayoutItem* XUncachedHBoxLayout::layoutItemAt(int idx) const
+{
+    if(idx >= 0 && idx < (int) m_layoutItems.size())
+    {
+        // return item
+        return m_layoutItems.at(idx).item;
+
+    } else
+    {
+        XWASSERT1(0, "XUncachedHBoxLayout::layoutItemAt index is out of range");
+        return 0;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// layout items by id (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XUncachedHBoxLayout::removelayoutItem(unsigned long itemId)
+{
+    // find item by id
+    for(std::vector<_ItemRef>::const_iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    {
+        if(it->item->layoutItemId() == itemId)
+        {
+            // remove item
+            m_layoutItems.erase(it);
+
+            // stop
+            break;
+        }
+    }
+}
+
+IXLayoutItem* XUncachedHBoxLayout::layoutItem(unsigned long itemId) const
+{
+    // find item by id
+    for(std::vector<_ItemRef>::const_iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    {
+        if(it->item->layoutItemId() == itemId)
+        {
+            // found 
+            return it->item;
+        }
+    }
+
+    // not found
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// manipulations (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XUncachedHBoxLayout::update(int posX, int posY, int width, int height)
+{
+    // check if there are any items
+    if(m_layoutItems.size() == 0) return;
+
+    // update resize policies in case some items have changed (keeps item constraints)
+    updateResizePolicies();
+
+    // update visible items count
+    _updateVisibleCount();
+
+    // position items vertically
+    _updateVerticalLayout(posY, height);
+
+    // position items horizontally
+    _updateHorizontalLayout(posX, width);
+
+    // update final positions
+    posX += marginLeft();
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        m_layoutItems[idx].posX = posX;
+        posX += m_layoutItems[idx].width + m_nSpacing;
+    }
+
+    // update items
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        m_layoutItems[idx].item->update(m_layoutItems[idx].posX, m_layoutItems[idx].posY,
+            m_layoutItems[idx].width, m_layoutItems[idx].height);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// resize policy (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+IXLayoutItem::TResizePolicy XUncachedHBoxLayout::horizontalPolicy() const
+{
+    return m_rpHorizontal;
+}
+
+IXLayoutItem::TResizePolicy XUncachedHBoxLayout::verticalPolicy() const
+{
+    return m_rpVertical;
+}
+
+void XUncachedHBoxLayout::updateResizePolicies()
+{
+    // reset policy
+    m_rpHorizontal = eResizeAny;
+    m_rpVertical = eResizeAny;
+    m_nMinWidth = 0;
+    m_nMinHeight = 0;
+    m_nMaxWidth = 0;
+    m_nMaxHeight = 0;
+
+    // 1. Horizontal policy
+    // if any item has min size then whole layout has min size (sum of those)
+    // if all items have max size then whole layout has max size (sum of those)
+
+    // 2. Vertical policy
+    // if any item has min size then whole layout has min size (maximum of those)
+    // if any item has max size then whole layout has max size (maximum of those)
+
+    bool hMinSize = false;
+    bool hMaxSize = true;
+    bool vMinSize = false;
+    bool vMaxSize = false;
+    
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        _ItemRef& itemRef = m_layoutItems[idx];
+
+        // ignore not visible items
+        itemRef.visible = itemRef.item->isVisible();
+        if(!itemRef.visible) continue;
+
+        // update policies for item first
+        itemRef.item->updateResizePolicies();
+
+        // NOTE: item constraints are kept for layout update, so that they are queried only once
+        itemRef.hPolicy = itemRef.item->horizontalPolicy();
+        itemRef.vPolicy = itemRef.item->verticalPolicy();
+        itemRef.minWidth = itemRef.item->minWidth();
+        itemRef.maxWidth = itemRef.item->maxWidth();
+        itemRef.minHeight = itemRef.item->minHeight();
+        itemRef.maxHeight = itemRef.item->maxHeight();
+
+        // horizontal
+        if(itemRef.hPolicy == eResizeMin || itemRef.hPolicy == eResizeMinMax) hMinSize = true;
+        if(itemRef.hPolicy == eResizeAny || itemRef.hPolicy == eResizeMin) hMaxSize = false;
+
+        // vertical
+        if(itemRef.vPolicy == eResizeMin || itemRef.vPolicy == eResizeMinMax) vMinSize = true;
+        if(itemRef.vPolicy == eResizeMax || itemRef.vPolicy == eResizeMinMax) vMaxSize = true;
+
+        // sum widths
+        m_nMinWidth += itemRef.minWidth;
+        m_nMaxWidth += itemRef.maxWidth;
+
+        // maximum for heights
+        if(itemRef.minHeight > m_nMinHeight) m_nMinHeight = itemRef.minHeight;
+        if(itemRef.maxHeight > m_nMaxHeight) m_nMaxHeight = itemRef.maxHeight;
+    }
+
+    // horizontal
+    if(hMinSize && hMaxSize)
+        m_rpHorizontal = eResizeMinMax;
+    else if(hMinSize)
+        m_rpHorizontal = eResizeMin;
+    else if(hMaxSize)
+        m_rpHorizontal = eResizeMax;
+
+    // vertical
+    if(vMinSize && vMaxSize)
+        m_rpVertical = eResizeMinMax;
+    else if(vMinSize)
+        m_rpVertical = eResizeMin;
+    else if(vMaxSize)
+        m_rpVertical = eResizeMax;
+}
+
+/////////////////////////////////////////////////////////////////////
+// size constraints (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+int XUncachedHBoxLayout::minWidth()  const
+{
+    if(m_visibleCount > 1)
+        return m_nMinWidth + marginLeft() + marginRight() + (m_visibleCount - 1) * m_nSpacing;
+    else
+        return m_nMinWidth + marginLeft() + marginRight();
+}
+
+int XUncachedHBoxLayout::minHeight() const
+{
+    return m_nMinHeight + marginTop() + marginBottom();
+}
+
+int XUncachedHBoxLayout::maxWidth()  const
+{
+    if(m_visibleCount > 1)
+        return m_nMaxWidth + marginLeft() + marginRight() + (m_visibleCount - 1) * m_nSpacing;
+    else
+        return m_nMaxWidth + marginLeft() + marginRight();
+}
+
+int XUncachedHBoxLayout::maxHeight() const
+{
+    return m_nMaxHeight + marginTop() + marginBottom();
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XUncachedHBoxLayout::_onItemAdded(IXLayoutItem* item)
+{
+    // update policy
+    updateResizePolicies();
+}
+
+void XUncachedHBoxLayout::_onItemRemoved(IXLayoutItem* item)
+{
+    // update policy
+    updateResizePolicies();
+}
+
+/////////////////////////////////////////////////////////////////////
+// layout methods
+/////////////////////////////////////////////////////////////////////
+void XUncachedHBoxLayout::_updateVisibleCount()
+{
+    // count visible items
+    m_visibleCount = 0;
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        if(m_layoutItems.at(idx).visible) m_visibleCount++;
+    }
+}
+
+void XUncachedHBoxLayout::_updateVerticalLayout(int posY, int height)
+{
+    // count available size
+    int heightLeft = height - (marginTop() + marginBottom());
+
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        // get item resize constraints
+        IXLayoutItem::TResizePolicy policy = m_layoutItems[idx].vPolicy;
+        int minHeight = m_layoutItems[idx].minHeight;
+        int maxHeight = m_layoutItems[idx].maxHeight;
+
+        // check if item can use full height
+        if( (policy == IXLayoutItem::eResizeAny) ||
+            (policy == IXLayoutItem::eResizeMin && minHeight <= heightLeft) ||
+            (policy == IXLayoutItem::eResizeMax && maxHeight >= heightLeft) ||
+            (policy == IXLayoutItem::eResizeMinMax && minHeight <= heightLeft && maxHeight >= heightLeft)
+            )
+        {
+            m_layoutItems[idx].height = heightLeft;
+
+        } else if( (policy == IXLayoutItem::eResizeMin || 
+			policy == IXLayoutItem::eResizeMinMax) && minHeight > heightLeft)
+        {
+			m_layoutItems[idx].height = minHeight;
+
+        } else if( (policy == IXLayoutItem::eResizeMax ||
+            policy == IXLayoutItem::eResizeMinMax) && maxHeight < heightLeft)
+        {
+            m_layoutItems[idx].height = maxHeight;
+		}
+
+        // check if item needs to be aligned
+        if(m_layoutItems[idx].height == heightLeft || m_layoutItems[idx].alignment == eAlignTop)
+        {
+            m_layoutItems[idx].posY = posY + marginTop();
+
+        } else if(m_layoutItems[idx].alignment == eAlignBottom)
+        {
+            m_layoutItems[idx].posY = posY + marginTop() + (heightLeft - m_layoutItems[idx].height);
+
+        } else if(m_layoutItems[idx].alignment == eAlignCenter)
+        {
+            m_layoutItems[idx].posY = posY + marginTop() + ((heightLeft - m_layoutItems[idx].height) / 2);
+        }
+    }
+}
+
+void XUncachedHBoxLayout::_updateHorizontalLayout(int posX, int width)
+{
+    // total margins
+    int marginX = marginLeft() + marginRight();
+
+    // count spacing needed for all items
+    int spacing = m_visibleCount > 0 ? (m_visibleCount - 1) * m_nSpacing : 0;
+
+    // copy constraints of visible items to solver
+    m_sizeSolver.clear();
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        m_sizeSolver.addItem(m_layoutItems[idx].hPolicy, m_layoutItems[idx].minWidth, 
+                             m_layoutItems[idx].maxWidth, m_layoutItems[idx].stretch);
+    }
+
+    // distribute width between items
+    m_sizeSolver.solve(width - (marginX + spacing));
+
+    // set item widths
+    int solverIdx = 0;
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        m_layoutItems[idx].width = m_sizeSolver.itemSize(solverIdx++);
+    }
+}
+
+// XUncachedHBoxLayout
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XUncachedVSpaceItem - vertical space layout item 
+
+class XUncachedVSpaceItem : public IXLayoutItem
+{
+public: // construction/destruction
+    XUncachedVSpaceItem(int height) : m_nHeight(height) {}
+    virtual ~XUncachedVSpaceItem(){}
+
+public: // resize policy
+    TResizePolicy   verticalPolicy() const
+    {
+        // size is fixed
+        return eResizeMinMax;
+    }
+
+public: // size constraints
+    virtual int minHeight() const   { return m_nHeight; }
+    virtual int maxHeight() const   { return m_nHeight; }
+
+private: // data
+    int     m_nHeight;
+};
+
+// XUncachedVSpaceItem
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XUncachedVBoxLayout - vertical layout manager 
+XUncachedVBoxLayout::XUncachedVBoxLayout(XWObject* parent) :
+    XWObject(parent),
+    m_nSpacing(0),
+    m_visibleCount(0),
+    m_rpHorizontal(eResizeAny),
+    m_rpVertical(eResizeAny),
+    m_nMinWidth(0),
+    m_nMinHeight(0),
+    m_nMaxWidth(0),
+    m_nMaxHeight(0)
+{
+}
+
+XUncachedVBoxLayout::~XUncachedVBoxLayout()
+{
+    // delete all space items
+    for(size_t idx = 0; idx < m_spaceItems.size(); ++idx)
+    {
+        delete m_spaceItems.at(idx);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// add items
+/////////////////////////////////////////////////////////////////////
+void XUncachedVBoxLayout::addItem(IXLayoutItem* item, int stretch, TAlignment alignment)
+{
+    _ItemRef itemRef;
+
+    // fill item
+    itemRef.item = item;
+    itemRef.stretch = stretch;
+    itemRef.alignment = alignment;
+
+    // add to index
+    m_layoutItems.push_back(itemRef);
+
+    // process item
+    _onItemAdded(item);
+}
+
+/////////////////////////////////////////////////////////////////////
+// extra items
+/////////////////////////////////////////////////////////////////////
+void XUncachedVBoxLayout::addSpaceItem(int size)
+{
+    // create new space item
+    XUncachedVSpaceItem* item = new XUncachedVSpaceItem(size);
+
+    // add to space items list
+    m_spaceItems.push_back(item);
+
+    // add to layout
+    addItem(item);
+}
+
+void XUncachedVBoxLayout::addStretchItem(int stretch)
+{
+    // create dummy item
+    IXLayoutItem* item = new IXLayoutItem;
+
+    // add to space items list
+    m_spaceItems.push_back(item);
+
+    // add to layout
+    addItem(item, stretch);
+}
+
+/////////////////////////////////////////////////////////////////////
+// item spacing
+/////////////////////////////////////////////////////////////////////
+void XUncachedVBoxLayout::setSpacing(int spacing)
+{
+    m_nSpacing = spacing;
+}
+
+/////////////////////////////////////////////////////////////////////
+// enum layout items (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+int XUncachedVBoxLayout::layoutItemCount() const
+{
+    return (int)m_layoutItems.size();
+}
+
+void XUncachedVBoxLayout::removelayoutItemAt(int idx)
+{
+    if(idx >= 0 && idx < (int) m_layoutItems.size())
+    {
+        // remove from index
+        m_layoutItems.erase(m_layoutItems.begin() + idx);
+
+    } else
+    {
+        XWASSERT1(0, "XUncachedVBoxLayout::removelayoutItemAt index is out of range");
+    }
+}
+
+IXLayoutItem* XUncachedVBoxLayout::layoutItemAt(int idx) const
+{
+    if(idx >= 0 && idx < (int) m_layoutItems.size())
+    {
+        // return item
+        return m_layoutItems.at(idx).item;
+
+    } else
+    {
+        XWASSERT1(0, "XUncachedVBoxLayout::layoutItemAt index is out of range");
+        return 0;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// layout items by id (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XUncachedVBoxLayout::removelayoutItem(unsigned long itemId)
+{
+    // find item by id
+    for(std::vector<_ItemRef>::iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    {
+        if(it->item->layoutItemId() == itemId)
+        {
+            // remove item
+            m_layoutItems.erase(it);
+
+            // stop
+            break;
+        }
+    }
+}
+
+IXLayoutItem* XUncachedVBoxLayout::layoutItem(unsigned long itemId) const
+{
+    // find item by id
+    for(std::vector<_ItemRef>::const_iterator it = m_layoutItems.begin(); it != m_layoutItems.end(); ++it)
+    {
+        if(it->item->layoutItemId() == itemId)
+        {
+            // found 
+            return it->item;
+        }
+    }
+
+    // not found
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// manipulations (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+void XUncachedVBoxLayout::update(int posX, int posY, int width, int height)
+{
+    // check if there are any items
+    if(m_layoutItems.size() == 0) return;
+
+    // update resize policies in case some items have changed (keeps item constraints)
+    updateResizePolicies();
+
+    // update visible items count
+    _updateVisibleCount();
+
+    // position items horizontally
+    _updateHorizontalLayout(posX, width);
+
+    // position items vertically
+    _updateVerticalLayout(posY, height);
+
+    // update final positions
+    posY += marginTop();
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        m_layoutItems[idx].posY = posY;
+        posY += m_layoutItems[idx].height + m_nSpacing;
+    }
+
+    // update items
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        m_layoutItems[idx].item->update(m_layoutItems[idx].posX, m_layoutItems[idx].posY,
+            m_layoutItems[idx].width, m_layoutItems[idx].height);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// resize policy (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+IXLayoutItem::TResizePolicy XUncachedVBoxLayout::horizontalPolicy() const
+{
+    return m_rpHorizontal;
+}
+
+IXLayoutItem::TResizePolicy XUncachedVBoxLayout::verticalPolicy() const
+{
+    return m_rpVertical;
+}
+
+void XUncachedVBoxLayout::updateResizePolicies()
+{
+    // reset policy
+    m_rpHorizontal = eResizeAny;
+    m_rpVertical = eResizeAny;
+    m_nMinWidth = 0;
+    m_nMinHeight = 0;
+    m_nMaxWidth = 0;
+    m_nMaxHeight = 0;
+
+    // 1. Horizontal policy
+    // if any item has min size then whole layout has min size (maximum of those)
+    // if any item has max size then whole layout has max size (maximum of those)
+
+    // 2. Vertical policy
+    // if any item has min size then whole layout has min size (sum of those)
+    // if all items have max size then whole layout has max size (sum of those)
+
+    bool hMinSize = false;
+    bool hMaxSize = false;
+    bool vMinSize = false;
+    bool vMaxSize = true;
+    
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        _ItemRef& itemRef = m_layoutItems[idx];
+
+        // ignore not visible items
+        itemRef.visible = itemRef.item->isVisible();
+        if(!itemRef.visible) continue;
+
+        // update policies for item first
+        itemRef.item->updateResizePolicies();
+
+        // NOTE: item constraints are kept for layout update, so that they are queried only once
+        itemRef.hPolicy = itemRef.item->horizontalPolicy();
+        itemRef.vPolicy = itemRef.item->verticalPolicy();
+        itemRef.minWidth = itemRef.item->minWidth();
+        itemRef.maxWidth = itemRef.item->maxWidth();
+        itemRef.minHeight = itemRef.item->minHeight();
+        itemRef.maxHeight = itemRef.item->maxHeight();
+
+        // horizontal
+        if(itemRef.hPolicy == eResizeMin || itemRef.hPolicy == eResizeMinMax) hMinSize = true;
+        if(itemRef.hPolicy == eResizeMax || itemRef.hPolicy == eResizeMinMax) hMaxSize = true;
+
+        // vertical
+        if(itemRef.vPolicy == eResizeMin || itemRef.vPolicy == eResizeMinMax) vMinSize = true;
+        if(itemRef.vPolicy == eResizeAny || itemRef.vPolicy == eResizeMin) vMaxSize = false;
+
+        // sum heights
+        m_nMinHeight += itemRef.minHeight;
+        m_nMaxHeight += itemRef.maxHeight;
+
+        // maximum for widths
+        if(itemRef.minWidth > m_nMinWidth) m_nMinWidth = itemRef.minWidth;
+        if(itemRef.maxWidth > m_nMaxWidth) m_nMaxWidth = itemRef.maxWidth;
+    }
+
+    // horizontal
+    if(hMinSize && hMaxSize)
+        m_rpHorizontal = eResizeMinMax;
+    else if(hMinSize)
+        m_rpHorizontal = eResizeMin;
+    else if(hMaxSize)
+        m_rpHorizontal = eResizeMax;
+
+    // vertical
+    if(vMinSize && vMaxSize)
+        m_rpVertical = eResizeMinMax;
+    else if(vMinSize)
+        m_rpVertical = eResizeMin;
+    else if(vMaxSize)
+        m_rpVertical = eResizeMax;
+}
+
+/////////////////////////////////////////////////////////////////////
+// size constraints (from IXLayout)
+/////////////////////////////////////////////////////////////////////
+int XUncachedVBoxLayout::minWidth()  const
+{
+    return m_nMinWidth + marginLeft() + marginRight();
+}
+
+int XUncachedVBoxLayout::minHeight() const
+{
+    if(m_visibleCount > 1)
+        return m_nMinHeight + marginTop() + marginBottom() + (m_visibleCount - 1) * m_nSpacing;
+    else
+        return m_nMinHeight + marginTop() + marginBottom();
+}
+
+int XUncachedVBoxLayout::maxWidth()  const
+{
+    return m_nMaxWidth + marginLeft() + marginRight();
+}
+
+int XUncachedVBoxLayout::maxHeight() const
+{
+    if(m_visibleCount > 1)
+        return m_nMaxHeight + marginTop() + marginBottom() + (m_visibleCount - 1) * m_nSpacing;
+    else
+        return m_nMaxHeight + marginTop() + marginBottom();
+}
+
+/////////////////////////////////////////////////////////////////////
+// worker methods
+/////////////////////////////////////////////////////////////////////
+void XUncachedVBoxLayout::_onItemAdded(IXLayoutItem* item)
+{
+    // update policy
+    updateResizePolicies();
+}
+
+void XUncachedVBoxLayout::_onItemRemoved(IXLayoutItem* item)
+{
+    // update policy
+    updateResizePolicies();
+}
+
+/////////////////////////////////////////////////////////////////////
+// layout methods
+/////////////////////////////////////////////////////////////////////
+void XUncachedVBoxLayout::_updateVisibleCount()
+{
+    // count visible items
+    m_visibleCount = 0;
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        if(m_layoutItems.at(idx).visible) m_visibleCount++;
+    }
+}
+
+void XUncachedVBoxLayout::_updateHorizontalLayout(int posX, int width)
+{
+    // count available size
+    int widthLeft = width - (marginLeft() + marginRight());
+
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        // get item resize constraints
+        IXLayoutItem::TResizePolicy policy = m_layoutItems[idx].hPolicy;
+        int minWidth = m_layoutItems[idx].minWidth;
+        int maxWidth = m_layoutItems[idx].maxWidth;
+
+        // check if item can use full width
+        if( (policy == IXLayoutItem::eResizeAny) ||
+            (policy == IXLayoutItem::eResizeMin && minWidth <= widthLeft) ||
+            (policy == IXLayoutItem::eResizeMax && maxWidth >= widthLeft) ||
+            (policy == IXLayoutItem::eResizeMinMax && minWidth <= widthLeft && maxWidth >= widthLeft)
+            )
+        {
+            m_layoutItems[idx].width = widthLeft;
+
+        } else if( (policy == IXLayoutItem::eResizeMin || 
+            policy == IXLayoutItem::eResizeMinMax) && minWidth > widthLeft)
+        {
+            m_layoutItems[idx].width = minWidth;
+
+        } else if( (policy == IXLayoutItem::eResizeMax ||
+            policy == IXLayoutItem::eResizeMinMax) && maxWidth < widthLeft)
+        {
+            m_layoutItems[idx].width = maxWidth;
+        }
+
+        // check if item needs to be aligned
+        if(m_layoutItems[idx].width == widthLeft || m_layoutItems[idx].alignment == eAlignLeft)
+        {
+            m_layoutItems[idx].posX = posX + marginLeft();
+
+        } else if(m_layoutItems[idx].alignment == eAlignRight)
+        {
+            m_layoutItems[idx].posX = posX + marginLeft() + (widthLeft - m_layoutItems[idx].width);
+
+        } else if(m_layoutItems[idx].alignment == eAlignCenter)
+        {
+            m_layoutItems[idx].posX = posX + marginLeft() + ((widthLeft - m_layoutItems[idx].width) / 2);
+        }
+    }
+}
+
+void XUncachedVBoxLayout::_updateVerticalLayout(int posY, int height)
+{
+    // total margins
+    int marginY = marginTop() + marginBottom();
+
+    // count spacing needed for all items
+    int spacing = m_visibleCount > 0 ? (m_visibleCount - 1) * m_nSpacing : 0;
+
+    // copy constraints of visible items to solver
+    m_sizeSolver.clear();
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        m_sizeSolver.addItem(m_layoutItems[idx].vPolicy, m_layoutItems[idx].minHeight, 
+                             m_layoutItems[idx].maxHeight, m_layoutItems[idx].stretch);
+    }
+
+    // distribute height between items
+    m_sizeSolver.solve(height - (marginY + spacing));
+
+    // set item heights
+    int solverIdx = 0;
+    for(size_t idx = 0; idx < m_layoutItems.size(); ++idx)
+    {
+        // ignore not visible items
+        if(!m_layoutItems[idx].visible) continue;
+
+        m_layoutItems[idx].height = m_sizeSolver.itemSize(solverIdx++);
+    }
+}
+
+// XUncachedVBoxLayout
+/////////////////////////////////////////////////////////////////////
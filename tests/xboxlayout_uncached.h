@@ -0,0 +1,227 @@
+// Reference box layouts without constraint cache (used by benchmarks)
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XBOXLAYOUT_UNCACHED_H_
+#define _XBOXLAYOUT_UNCACHED_H_
+
+// NOTE: XUncachedHBoxLayout and XUncachedVBoxLayout are XHBoxLayout and XVBoxLayout as
+//       they were before layout constraints were cached, only classes are renamed.
+//       They use XLayoutSizeSolver, but query constraints of all items on each update
+//       and nested layouts query their items again for each parent level.
+
+#include "core/xwcore_config.h"
+
+#include "layout/xlayoutitem.h"
+#include "layout/xlayout.h"
+#include "layout/xlayoutsizesolver.h"
+
+/////////////////////////////////////////////////////////////////////
+// XUncachedHBoxLayout - horizontal box layout engine 
+
+class XUncachedHBoxLayout : public IXLayout,
+                            public XWObject
+{
+public: // construction/destruction
+    XUncachedHBoxLayout(XWObject* parent = 0);
+    virtual ~XUncachedHBoxLayout();
+
+public: // alignment
+    enum TAlignment
+    {
+        eAlignTop,
+        eAlignBottom,
+        eAlignCenter
+    };
+
+public: // add items
+    void    addItem(IXLayoutItem* item, int stretch = 0, TAlignment alignment = eAlignCenter);
+
+public: // extra items
+    void    addSpaceItem(int size);
+    void    addStretchItem(int stretch);
+
+public: // item spacing
+    void    setSpacing(int spacing);
+    int     spacing() const     { return m_nSpacing; }
+
+public: // enum layout items (from IXLayout)
+    int             layoutItemCount() const;
+    void            removelayoutItemAt(int idx);
+    IXLayoutItem*   layoutItemAt(int idx) const;
+
+public: // layout items by id (from IXLayout)
+    void            removelayoutItem(unsigned long itemId);
+    IXLayoutItem*   layoutItem(unsigned long itemId) const;
+
+public: // manipulations (from IXLayout)
+    void    update(int posX, int posY, int width, int height);
+
+public: // resize policy (from IXLayout)
+    TResizePolicy   horizontalPolicy() const;
+    TResizePolicy   verticalPolicy() const;
+    void            updateResizePolicies();
+
+public: // size constraints (from IXLayout)
+    int     minWidth()  const;
+    int     minHeight() const;
+    int     maxWidth()  const;
+    int     maxHeight() const;
+
+private: // worker methods
+    void    _onItemAdded(IXLayoutItem* item);
+    void    _onItemRemoved(IXLayoutItem* item);
+    void    _updateResizePolicy();
+
+private: // layout methods
+    void    _updateVisibleCount();
+    void    _updateVerticalLayout(int posY, int height);
+    void    _updateHorizontalLayout(int posX, int width);
+
+private: // item reference
+    struct _ItemRef
+    {
+        // layout data
+        IXLayoutItem*   item;
+        TAlignment      alignment;
+        int             stretch;
+
+        // constraints (kept by updateResizePolicies)
+        bool            visible;
+        TResizePolicy   hPolicy, vPolicy;
+        int             minWidth, maxWidth;
+        int             minHeight, maxHeight;
+
+        // resizing cache
+        int     posX, posY;
+        int     width, height;
+    };
+
+private: // items
+    std::vector<_ItemRef>       m_layoutItems;
+    std::vector<IXLayoutItem*>  m_spaceItems;
+    int                         m_visibleCount;
+
+private: // size solver
+    XLayoutSizeSolver           m_sizeSolver;
+
+private: // policy
+    TResizePolicy   m_rpHorizontal;
+    TResizePolicy   m_rpVertical;
+
+private: // data
+    int     m_nSpacing;
+    int     m_nMinWidth;
+    int     m_nMinHeight;
+    int     m_nMaxWidth;
+    int     m_nMaxHeight;
+};
+
+// XUncachedHBoxLayout
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// XUncachedVBoxLayout - vertical layout manager 
+
+class XUncachedVBoxLayout : public IXLayout,
+                            public XWObject
+{
+public: // construction/destruction
+    XUncachedVBoxLayout(XWObject* parent = 0);
+    virtual ~XUncachedVBoxLayout();
+
+public: // alignment
+    enum TAlignment
+    {
+        eAlignLeft,
+        eAlignRight,
+        eAlignCenter
+    };
+
+public: // add items
+    void    addItem(IXLayoutItem* item, int stretch = 0, TAlignment alignment = eAlignLeft);
+
+public: // extra items
+    void    addSpaceItem(int size);
+    void    addStretchItem(int stretch);
+
+public: // item spacing
+    void    setSpacing(int spacing);
+    int     spacing() const     { return m_nSpacing; }
+
+public: // enum layout items (from IXLayout)
+    int             layoutItemCount() const;
+    void            removelayoutItemAt(int idx);
+    IXLayoutItem*   layoutItemAt(int idx) const;
+
+public: // layout items by id (from IXLayout)
+    void            removelayoutItem(unsigned long itemId);
+    IXLayoutItem*   layoutItem(unsigned long itemId) const;
+
+public: // manipulations (from IXLayout)
+    void    update(int posX, int posY, int width, int height);
+
+public: // resize policy (from IXLayout)
+    TResizePolicy   horizontalPolicy() const;
+    TResizePolicy   verticalPolicy() const;
+    void            updateResizePolicies();
+
+public: // size constraints (from IXLayout)
+    int     minWidth()  const;
+    int     minHeight() const;
+    int     maxWidth()  const;
+    int     maxHeight() const;
+
+private: // worker methods
+    void    _onItemAdded(IXLayoutItem* item);
+    void    _onItemRemoved(IXLayoutItem* item);
+    void    _updateResizePolicy();
+
+private: // layout methods
+    void    _updateVisibleCount();
+    void    _updateHorizontalLayout(int posX, int width);
+    void    _updateVerticalLayout(int posY, int height);
+
+private: // item reference
+    struct _ItemRef
+    {
+        // layout data
+        IXLayoutItem*   item;
+        TAlignment      alignment;
+        int             stretch;
+
+        // constraints (kept by updateResizePolicies)
+        bool            visible;
+        TResizePolicy   hPolicy, vPolicy;
+        int             minWidth, maxWidth;
+        int             minHeight, maxHeight;
+
+        // resizing cache
+        int     posX, posY;
+        int     width, height;
+    };
+
+private: // items
+    std::vector<_ItemRef>       m_layoutItems;
+    std::vector<IXLayoutItem*>  m_spaceItems;
+    int                         m_visibleCount;
+
+private: // size solver
+    XLayoutSizeSolver           m_sizeSolver;
+
+private: // policy
+    TResizePolicy   m_rpHorizontal;
+    TResizePolicy   m_rpVertical;
+
+private: // data
+    int     m_nSpacing;
+    int     m_nMinWidth;
+    int     m_nMinHeight;
+    int     m_nMaxWidth;
+    int     m_nMaxHeight;
+};
+
+// XUncachedVBoxLayout
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XBOXLAYOUT_UNCACHED_H_
@@ -0,0 +1,159 @@
+// Grid layout benchmarks (form grid vs nested box layouts)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "layout/xlayoutitem.h"
+#include "layout/xlayout.h"
+#include "layout/xlayoutsizesolver.h"
+#include "layout/xhboxlayout.h"
+#include "layout/xvboxlayout.h"
+#include "layout/xgridlayout.h"
+
+#include "xwtest.h"
+
+// NOTE: form of label and edit columns (labels have fixed width, edits grow), laid
+//       out by one grid or by vertical box of horizontal boxes. Resize doesn't change
+//       constraints, constraint change of one item per update is measured apart.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_ROWS              40
+#define BENCH_COLUMNS           4
+#define BENCH_UPDATES           20000
+
+/////////////////////////////////////////////////////////////////////
+// form item
+
+static long long g_constraintQueries = 0;
+
+class XBenchFormItem : public IXLayoutItem
+{
+public: // construction/destruction
+    XBenchFormItem() : hPolicy(eResizeAny), minW(0), maxW(0) {}
+
+public: // IXLayoutItem
+    TResizePolicy   horizontalPolicy() const    { ++g_constraintQueries; return hPolicy; }
+    TResizePolicy   verticalPolicy() const      { ++g_constraintQueries; return eResizeMinMax; }
+    int             minWidth() const            { ++g_constraintQueries; return minW; }
+    int             maxWidth() const            { ++g_constraintQueries; return maxW; }
+    int             minHeight() const           { ++g_constraintQueries; return 22; }
+    int             maxHeight() const           { ++g_constraintQueries; return 22; }
+
+public: // constraints
+    TResizePolicy   hPolicy;
+    int             minW;
+    int             maxW;
+};
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static void initFormItems(std::vector<XBenchFormItem>& items)
+{
+    items.resize(BENCH_ROWS * BENCH_COLUMNS);
+
+    for(size_t idx = 0; idx < items.size(); ++idx)
+    {
+        if((idx % BENCH_COLUMNS) % 2 == 0)
+        {
+            // label
+            items[idx].hPolicy = IXLayoutItem::eResizeMinMax;
+            items[idx].minW = 80;
+            items[idx].maxW = 80;
+
+        } else
+        {
+            // edit
+            items[idx].hPolicy = IXLayoutItem::eResizeMin;
+            items[idx].minW = 100;
+        }
+    }
+}
+
+// us and constraint queries per update
+static void benchResize(IXLayoutItem* layout, std::vector<XBenchFormItem>& items, bool changeItem,
+                        double& usOut, long long& queriesOut)
+{
+    // settle caches
+    layout->update(0, 0, 500, 1200);
+
+    long long queries = g_constraintQueries;
+    XWTestTimer timer;
+
+    for(int update = 0; update < BENCH_UPDATES; ++update)
+    {
+        if(changeItem)
+        {
+            XBenchFormItem& item = items[(update * 7) % items.size()];
+            item.minW += (update % 2) ? -1 : 1;
+            item.invalidateResizePolicies();
+        }
+
+        layout->update(0, 0, 500 + (update % 300), 1200);
+    }
+
+    usOut = (double)timer.elapsedUs() / BENCH_UPDATES;
+    queriesOut = (g_constraintQueries - queries) / BENCH_UPDATES;
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    std::vector<XBenchFormItem> gridItems;
+    std::vector<XBenchFormItem> boxItems;
+    initFormItems(gridItems);
+    initFormItems(boxItems);
+
+    // grid
+    XGridLayout grid;
+    grid.setSpacing(4);
+
+    for(size_t idx = 0; idx < gridItems.size(); ++idx)
+    {
+        grid.addItem(&gridItems[idx], (int)idx / BENCH_COLUMNS, (int)idx % BENCH_COLUMNS);
+    }
+
+    // vertical box of horizontal boxes
+    XVBoxLayout vbox;
+    vbox.setSpacing(4);
+
+    std::vector<XHBoxLayout*> rows;
+    for(int row = 0; row < BENCH_ROWS; ++row)
+    {
+        XHBoxLayout* hbox = new XHBoxLayout;
+        hbox->setSpacing(4);
+
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            hbox->addItem(&boxItems[row * BENCH_COLUMNS + column]);
+        }
+
+        vbox.addItem(hbox);
+        rows.push_back(hbox);
+    }
+
+    for(int changeItem = 0; changeItem < 2; ++changeItem)
+    {
+        double gridUs, boxUs;
+        long long gridQueries, boxQueries;
+
+        benchResize(&grid, gridItems, changeItem != 0, gridUs, gridQueries);
+        benchResize(&vbox, boxItems, changeItem != 0, boxUs, boxQueries);
+
+        printf("%dx%d form, %-22s: grid %5.2f us (%4lld queries), nested boxes %5.2f us (%4lld queries) per update\n",
+               BENCH_ROWS, BENCH_COLUMNS, changeItem ? "one item changed" : "resize only",
+               gridUs, gridQueries, boxUs, boxQueries);
+    }
+
+    for(size_t idx = 0; idx < rows.size(); ++idx)
+    {
+        delete rows[idx];
+    }
+
+    return 0;
+}
@@ -0,0 +1,426 @@
+// Grid layout tests (one row grid vs horizontal box, invariants of random grids, incremental updates)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "layout/xlayoutitem.h"
+#include "layout/xlayout.h"
+#include "layout/xlayoutsizesolver.h"
+#include "layout/xhboxlayout.h"
+#include "layout/xgridlayout.h"
+
+#include "xwtest.h"
+
+// NOTE: one row grid with column stretch factors must place items as horizontal box
+//       does. Box may give item size outside its own minimum or maximum size (when
+//       layout is too small or too large), grid doesn't follow box there, so such
+//       cases are skipped and counted.
+
+// NOTE: grid changed item by item must place items as grid built from scratch with the
+//       same items, while changed item is the only one queried again.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define TEST_ROW_GRIDS          20000
+#define TEST_RANDOM_GRIDS       20000
+#define TEST_UPDATES            4
+#define TEST_CHANGED_GRIDS      3000
+#define TEST_CHANGES            12
+
+/////////////////////////////////////////////////////////////////////
+// layout item with constraints set by test
+
+static long long g_constraintQueries = 0;
+
+class XTestLayoutItem : public IXLayoutItem
+{
+public: // construction/destruction
+    XTestLayoutItem() :
+        visible(true), hPolicy(eResizeAny), vPolicy(eResizeAny),
+        minW(0), maxW(0), minH(0), maxH(0), posX(0), posY(0), width(0), height(0) {}
+
+public: // IXLayoutItem
+    bool            isVisible() const           { return visible; }
+    TResizePolicy   horizontalPolicy() const    { ++g_constraintQueries; return hPolicy; }
+    TResizePolicy   verticalPolicy() const      { ++g_constraintQueries; return vPolicy; }
+    int             minWidth() const            { ++g_constraintQueries; return minW; }
+    int             maxWidth() const            { ++g_constraintQueries; return maxW; }
+    int             minHeight() const           { ++g_constraintQueries; return minH; }
+    int             maxHeight() const           { ++g_constraintQueries; return maxH; }
+
+    void update(int x, int y, int w, int h)
+    {
+        posX = x;
+        posY = y;
+        width = w;
+        height = h;
+    }
+
+public: // helpers
+    bool    hasMinWidth() const     { return hPolicy == eResizeMin || hPolicy == eResizeMinMax; }
+    bool    hasMaxWidth() const     { return hPolicy == eResizeMax || hPolicy == eResizeMinMax; }
+    bool    hasMinHeight() const    { return vPolicy == eResizeMin || vPolicy == eResizeMinMax; }
+
+public: // constraints
+    bool            visible;
+    TResizePolicy   hPolicy;
+    TResizePolicy   vPolicy;
+    int             minW;
+    int             maxW;
+    int             minH;
+    int             maxH;
+
+public: // placement
+    int     posX;
+    int     posY;
+    int     width;
+    int     height;
+};
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+// item placed in grid
+struct XTestGridCell
+{
+    int row;
+    int column;
+    int rowSpan;
+    int columnSpan;
+    int alignment;
+};
+
+static void randomConstraints(XWTestRandom& random, XTestLayoutItem& item)
+{
+    item.hPolicy = (IXLayoutItem::TResizePolicy)random.range(0, 3);
+    item.vPolicy = (IXLayoutItem::TResizePolicy)random.range(0, 3);
+    item.minW = random.range(0, 80);
+    item.maxW = item.minW + random.range(0, 80);
+    item.minH = random.range(0, 40);
+    item.maxH = item.minH + random.range(0, 40);
+}
+
+// compare grid with grid built from scratch from the same items
+static bool compareWithNewGrid(XGridLayout& grid, std::vector<XTestLayoutItem>& items,
+                               const std::vector<XTestGridCell>& cells, int itemCount, int spacing, int width, int height)
+{
+    XGridLayout newGrid;
+    newGrid.setSpacing(spacing);
+
+    std::vector<XTestLayoutItem> newItems(itemCount);
+    for(int idx = 0; idx < itemCount; ++idx)
+    {
+        const XTestLayoutItem& item = items[idx];
+        XTestLayoutItem& newItem = newItems[idx];
+
+        newItem.visible = item.visible;
+        newItem.hPolicy = item.hPolicy;
+        newItem.vPolicy = item.vPolicy;
+        newItem.minW = item.minW;
+        newItem.maxW = item.maxW;
+        newItem.minH = item.minH;
+        newItem.maxH = item.maxH;
+
+        const XTestGridCell& cell = cells[idx];
+        newGrid.addItem(&newItem, cell.row, cell.column, cell.rowSpan, cell.columnSpan, cell.alignment);
+    }
+
+    grid.update(0, 0, width, height);
+    newGrid.update(0, 0, width, height);
+
+    if(grid.minWidth() != newGrid.minWidth() || grid.maxWidth() != newGrid.maxWidth()) return false;
+    if(grid.minHeight() != newGrid.minHeight() || grid.maxHeight() != newGrid.maxHeight()) return false;
+    if(grid.horizontalPolicy() != newGrid.horizontalPolicy() || grid.verticalPolicy() != newGrid.verticalPolicy()) return false;
+
+    for(int idx = 0; idx < itemCount; ++idx)
+    {
+        if(!items[idx].visible) continue;
+
+        if(items[idx].posX != newItems[idx].posX || items[idx].posY != newItems[idx].posY) return false;
+        if(items[idx].width != newItems[idx].width || items[idx].height != newItems[idx].height) return false;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testRowGridAsBox()
+{
+    int compared = 0;
+    int skipped = 0;
+    int failures = 0;
+
+    for(int gridIdx = 0; gridIdx < TEST_ROW_GRIDS; ++gridIdx)
+    {
+        XWTestRandom random(gridIdx + 1);
+
+        int itemCount = random.range(1, 30);
+        int scale = random.range(0, 1) ? 50 : 3000;
+
+        std::vector<XTestLayoutItem> boxItems(itemCount);
+        std::vector<XTestLayoutItem> gridItems(itemCount);
+        std::vector<int> stretches(itemCount);
+
+        XHBoxLayout box;
+        XGridLayout grid;
+
+        // the same spacing and horizontal margins
+        int spacing = random.range(0, 8);
+        int marginLeft = random.range(0, 5);
+        int marginRight = random.range(0, 5);
+
+        box.setSpacing(spacing);
+        box.setContentMargins(marginLeft, 0, marginRight, 0);
+        grid.setHorizontalSpacing(spacing);
+        grid.setContentMargins(marginLeft, 0, marginRight, 0);
+
+        for(int idx = 0; idx < itemCount; ++idx)
+        {
+            XTestLayoutItem item;
+            item.visible = (random.range(0, 6) != 0);
+            item.hPolicy = (IXLayoutItem::TResizePolicy)random.range(0, 3);
+            item.minW = item.hasMinWidth() ? random.range(0, scale) : 0;
+            item.maxW = item.minW + random.range(item.hPolicy == IXLayoutItem::eResizeMin ? 1 : 0, scale);
+
+            boxItems[idx] = item;
+            gridItems[idx] = item;
+            stretches[idx] = random.range(0, 1) ? 0 : random.range(0, 10);
+
+            // hidden column must not stretch
+            box.addItem(&boxItems[idx], stretches[idx]);
+            grid.addItem(&gridItems[idx], 0, idx);
+            grid.setColumnStretch(idx, item.visible ? stretches[idx] : 0);
+        }
+
+        for(int update = 0; update < TEST_UPDATES; ++update)
+        {
+            int width = random.range(0, scale * itemCount);
+
+            // visibility change in the middle
+            if(update == 2)
+            {
+                int idx = random.range(0, itemCount - 1);
+                boxItems[idx].visible = !boxItems[idx].visible;
+                gridItems[idx].visible = boxItems[idx].visible;
+                grid.setColumnStretch(idx, boxItems[idx].visible ? stretches[idx] : 0);
+            }
+
+            box.update(3, 4, width, 100);
+            grid.update(3, 4, width, 100);
+
+            // skip cases where box breaks item constraints
+            bool boxQuirk = false;
+            for(int idx = 0; idx < itemCount; ++idx)
+            {
+                const XTestLayoutItem& item = boxItems[idx];
+                if(!item.visible) continue;
+
+                if((item.hasMinWidth() && item.width < item.minW) || (item.hasMaxWidth() && item.width > item.maxW))
+                    boxQuirk = true;
+            }
+
+            if(boxQuirk)
+            {
+                ++skipped;
+                continue;
+            }
+
+            ++compared;
+
+            // horizontal geometry of visible items
+            for(int idx = 0; idx < itemCount; ++idx)
+            {
+                if(!boxItems[idx].visible) continue;
+
+                if(boxItems[idx].posX != gridItems[idx].posX || boxItems[idx].width != gridItems[idx].width)
+                {
+                    if(failures++ < 10)
+                        printf("grid %d update %d item %d: box %d %d, grid %d %d\n", gridIdx, update, idx,
+                               boxItems[idx].posX, boxItems[idx].width, gridItems[idx].posX, gridItems[idx].width);
+                    break;
+                }
+            }
+        }
+    }
+
+    XWTEST_CHECK(failures == 0);
+
+    printf("one row grid vs box: %d cases compared, %d skipped\n", compared, skipped);
+}
+
+static void testRandomGrids()
+{
+    int failures = 0;
+
+    for(int gridIdx = 0; gridIdx < TEST_RANDOM_GRIDS; ++gridIdx)
+    {
+        XWTestRandom random(1000000 + gridIdx);
+
+        int rowCount = random.range(1, 8);
+        int columnCount = random.range(1, 6);
+
+        XGridLayout grid;
+        grid.setSpacing(random.range(0, 5));
+
+        std::vector<XTestLayoutItem> items(rowCount * columnCount);
+        int itemCount = 0;
+
+        // some cells are empty, items may span several tracks
+        for(int row = 0; row < rowCount; ++row)
+        {
+            for(int column = 0; column < columnCount; ++column)
+            {
+                if(random.range(0, 3) == 0) continue;
+
+                XTestLayoutItem& item = items[itemCount++];
+                item.hPolicy = (IXLayoutItem::TResizePolicy)random.range(0, 3);
+                item.vPolicy = (IXLayoutItem::TResizePolicy)random.range(0, 3);
+                item.minW = random.range(0, 80);
+                item.maxW = item.minW + random.range(0, 80);
+                item.minH = random.range(0, 40);
+                item.maxH = item.minH + random.range(0, 40);
+
+                grid.addItem(&item, row, column, random.range(1, 2), random.range(1, 3), random.range(0, 0x77));
+            }
+        }
+
+        if(itemCount == 0) continue;
+
+        // layout of minimum size keeps minimum sizes of items and stays in bounds
+        int minWidth = grid.minWidth();
+        int minHeight = grid.minHeight();
+        grid.update(0, 0, minWidth, minHeight);
+
+        bool valid = true;
+        for(int idx = 0; idx < itemCount; ++idx)
+        {
+            const XTestLayoutItem& item = items[idx];
+
+            if(item.hasMinWidth() && item.width < item.minW) valid = false;
+            if(item.hasMinHeight() && item.height < item.minH) valid = false;
+            if(item.posX < 0 || item.posX + item.width > minWidth) valid = false;
+            if(item.posY < 0 || item.posY + item.height > minHeight) valid = false;
+        }
+
+        // resize doesn't query item constraints
+        long long queries = g_constraintQueries;
+        grid.update(0, 0, minWidth + 50, minHeight + 50);
+        grid.update(0, 0, minWidth + 60, minHeight + 50);
+        if(g_constraintQueries != queries) valid = false;
+
+        if(!valid && failures++ < 10) printf("grid %d: invariant failed\n", gridIdx);
+    }
+
+    XWTEST_CHECK(failures == 0);
+
+    printf("random grids with spans: %d grids checked\n", TEST_RANDOM_GRIDS);
+}
+
+static void testIncrementalChanges()
+{
+    int failures = 0;
+    int queryFailures = 0;
+
+    for(int gridIdx = 0; gridIdx < TEST_CHANGED_GRIDS; ++gridIdx)
+    {
+        XWTestRandom random(2000000 + gridIdx);
+
+        int rowCount = random.range(1, 8);
+        int columnCount = random.range(1, 6);
+        int spacing = random.range(0, 5);
+        int maxItems = rowCount * columnCount + TEST_CHANGES;
+
+        XGridLayout grid;
+        grid.setSpacing(spacing);
+
+        // NOTE: items are not moved in memory after they are added
+        std::vector<XTestLayoutItem> items(maxItems);
+        std::vector<XTestGridCell> cells(maxItems);
+        int itemCount = 0;
+
+        for(int row = 0; row < rowCount; ++row)
+        {
+            for(int column = 0; column < columnCount; ++column)
+            {
+                if(random.range(0, 3) == 0) continue;
+
+                XTestGridCell cell = {row, column, random.range(1, 2), random.range(1, 3), random.range(0, 0x77)};
+                cells[itemCount] = cell;
+                randomConstraints(random, items[itemCount]);
+
+                grid.addItem(&items[itemCount], cell.row, cell.column, cell.rowSpan, cell.columnSpan, cell.alignment);
+                ++itemCount;
+            }
+        }
+
+        if(itemCount == 0) continue;
+
+        int width = grid.minWidth() + random.range(0, 100);
+        int height = grid.minHeight() + random.range(0, 100);
+        bool valid = compareWithNewGrid(grid, items, cells, itemCount, spacing, width, height);
+
+        for(int change = 0; change < TEST_CHANGES && valid; ++change)
+        {
+            int operation = random.range(0, 9);
+
+            if(operation < 6)
+            {
+                // item reports changed constraints, only it is queried again
+                XTestLayoutItem& item = items[random.range(0, itemCount - 1)];
+                randomConstraints(random, item);
+                item.invalidateResizePolicies();
+
+                long long queries = g_constraintQueries;
+                grid.updateResizePolicies();
+
+                long long expected = item.visible ? 6 : 0;
+                if(g_constraintQueries - queries != expected && queryFailures++ < 10)
+                    printf("grid %d change %d: %lld queries\n", gridIdx, change, g_constraintQueries - queries);
+
+            } else if(operation < 8)
+            {
+                // item is shown or hidden without notification
+                XTestLayoutItem& item = items[random.range(0, itemCount - 1)];
+                item.visible = !item.visible;
+
+            } else
+            {
+                // new item, possibly in new tracks
+                XTestGridCell cell = {random.range(0, rowCount), random.range(0, columnCount),
+                                      random.range(1, 2), random.range(1, 3), random.range(0, 0x77)};
+                cells[itemCount] = cell;
+                randomConstraints(random, items[itemCount]);
+
+                grid.addItem(&items[itemCount], cell.row, cell.column, cell.rowSpan, cell.columnSpan, cell.alignment);
+                ++itemCount;
+            }
+
+            width = grid.minWidth() + random.range(0, 100);
+            height = grid.minHeight() + random.range(0, 100);
+            valid = compareWithNewGrid(grid, items, cells, itemCount, spacing, width, height);
+        }
+
+        if(!valid && failures++ < 10) printf("grid %d: differs from new grid\n", gridIdx);
+    }
+
+    XWTEST_CHECK(failures == 0);
+    XWTEST_CHECK(queryFailures == 0);
+
+    printf("incremental changes: %d grids of %d changes checked\n", TEST_CHANGED_GRIDS, TEST_CHANGES);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    testRowGridAsBox();
+    testRandomGrids();
+    testIncrementalChanges();
+
+    return xwtestResult("xgridlayout_test");
+}
@@ -0,0 +1,151 @@
+// Layout constraint cache benchmarks (deep layout tree resize)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "layout/xlayoutitem.h"
+#include "layout/xlayout.h"
+#include "layout/xlayoutsizesolver.h"
+#include "layout/xhboxlayout.h"
+#include "layout/xvboxlayout.h"
+
+#include "xboxlayout_uncached.h"
+
+#include "xwtest.h"
+
+// NOTE: tree is vertical box of rows, each row is horizontal box of columns and each
+//       column is vertical box of items (depth 3). Layouts without cache (see
+//       xboxlayout_uncached.h) are compared with current layouts on plain resize, on
+//       resize after one item reported change and after deep reset of whole tree.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_ROWS              50
+#define BENCH_COLUMNS           4
+#define BENCH_COLUMN_ITEMS      5
+#define BENCH_UPDATES           2000
+
+/////////////////////////////////////////////////////////////////////
+// layout item
+
+static long long g_constraintQueries = 0;
+
+class XBenchLayoutItem : public IXLayoutItem
+{
+public: // IXLayoutItem
+    TResizePolicy   horizontalPolicy() const    { ++g_constraintQueries; return eResizeMin; }
+    TResizePolicy   verticalPolicy() const      { ++g_constraintQueries; return eResizeMinMax; }
+    int             minWidth() const            { ++g_constraintQueries; return 40; }
+    int             maxWidth() const            { ++g_constraintQueries; return 0; }
+    int             minHeight() const           { ++g_constraintQueries; return 20; }
+    int             maxHeight() const           { ++g_constraintQueries; return 20; }
+};
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+template <class _HBoxLayout, class _VBoxLayout>
+static _VBoxLayout* createTree(std::vector<XBenchLayoutItem>& items, std::vector<IXLayoutItem*>& layoutsOut)
+{
+    items.resize(BENCH_ROWS * BENCH_COLUMNS * BENCH_COLUMN_ITEMS);
+
+    _VBoxLayout* root = new _VBoxLayout;
+    root->setSpacing(2);
+
+    int itemIdx = 0;
+    for(int row = 0; row < BENCH_ROWS; ++row)
+    {
+        _HBoxLayout* rowLayout = new _HBoxLayout;
+        rowLayout->setSpacing(2);
+
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            _VBoxLayout* columnLayout = new _VBoxLayout;
+            columnLayout->setSpacing(2);
+
+            for(int idx = 0; idx < BENCH_COLUMN_ITEMS; ++idx)
+            {
+                columnLayout->addItem(&items[itemIdx++]);
+            }
+
+            rowLayout->addItem(columnLayout);
+            layoutsOut.push_back(columnLayout);
+        }
+
+        root->addItem(rowLayout);
+        layoutsOut.push_back(rowLayout);
+    }
+
+    // NOTE: child layouts are deleted before parent
+    layoutsOut.push_back(root);
+
+    return root;
+}
+
+static void deleteTree(std::vector<IXLayoutItem*>& layouts)
+{
+    for(size_t idx = 0; idx < layouts.size(); ++idx)
+    {
+        delete layouts[idx];
+    }
+
+    layouts.clear();
+}
+
+// change of constraints before each update
+enum TBenchChange
+{
+    eChangeNone,        // resize only
+    eChangeItem,        // one item reports change
+    eChangeDeepReset    // whole tree is reset (content changed)
+};
+
+static void benchResize(const char* name, IXLayoutItem* root, std::vector<XBenchLayoutItem>& items, TBenchChange change)
+{
+    // settle caches
+    root->update(0, 0, 800, 6000);
+
+    long long queries = g_constraintQueries;
+    XWTestTimer timer;
+
+    for(int update = 0; update < BENCH_UPDATES; ++update)
+    {
+        if(change == eChangeItem)
+            items[(update * 7) % items.size()].invalidateResizePolicies();
+        else if(change == eChangeDeepReset)
+            root->resetResizePolicies();
+
+        root->update(0, 0, 800 + (update % 300), 6000 + (update % 100));
+    }
+
+    double us = (double)timer.elapsedUs() / BENCH_UPDATES;
+
+    printf("%d items, depth 3, %-26s: %6.1f us/resize, %6lld constraint queries/resize\n", (int)items.size(), name, us,
+           (g_constraintQueries - queries) / BENCH_UPDATES);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    std::vector<XBenchLayoutItem> uncachedItems;
+    std::vector<IXLayoutItem*> uncachedLayouts;
+    IXLayoutItem* uncachedRoot = createTree<XUncachedHBoxLayout, XUncachedVBoxLayout>(uncachedItems, uncachedLayouts);
+
+    benchResize("without cache", uncachedRoot, uncachedItems, eChangeNone);
+    deleteTree(uncachedLayouts);
+
+    std::vector<XBenchLayoutItem> items;
+    std::vector<IXLayoutItem*> layouts;
+    IXLayoutItem* root = createTree<XHBoxLayout, XVBoxLayout>(items, layouts);
+
+    benchResize("cached", root, items, eChangeNone);
+    benchResize("cached, one item changed", root, items, eChangeItem);
+    benchResize("cached, deep reset", root, items, eChangeDeepReset);
+    deleteTree(layouts);
+
+    return 0;
+}
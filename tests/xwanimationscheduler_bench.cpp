@@ -0,0 +1,237 @@
+// Animation scheduler benchmarks (wake-up cost, jitter, command throughput)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "xwtest.h"
+
+// NOTE: processing cost is measured with virtual clock so that only scheduler work
+//       is counted. Jitter is measured with real clock and scheduler thread, it
+//       depends on system timer resolution and load.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_TIMERS            10000
+#define BENCH_JITTER_RUN_MS     3000
+#define BENCH_COMMANDS          1000000
+
+/////////////////////////////////////////////////////////////////////
+// clocks
+
+class XBenchVirtualClock : public IXWAnimationClock
+{
+public: // construction/destruction
+    XBenchVirtualClock() : m_timeMs(0) {}
+
+public: // IXWAnimationClock
+    long long   timeMs() { return m_timeMs; }
+
+public: // interface
+    void    advance(long long deltaMs) { m_timeMs += deltaMs; }
+
+private: // data
+    std::atomic<long long>  m_timeMs;
+};
+
+class XBenchSteadyClock : public IXWAnimationClock
+{
+public: // IXWAnimationClock
+    long long   timeMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/////////////////////////////////////////////////////////////////////
+// sinks
+
+class XBenchCountingSink : public IXWAnimationSink
+{
+public: // construction/destruction
+    XBenchCountingSink() : m_events(0) {}
+
+public: // IXWAnimationSink
+    void    deliverEvent(const XWAnimationScheduler::AnimationEvent& animationEvent, void* target, size_t& sinkData)
+    {
+        m_events++;
+    }
+
+public: // data
+    std::atomic<unsigned long>  m_events;
+};
+
+// NOTE: sink data keeps time of previous event (in microseconds), target is interval
+class XBenchJitterSink : public IXWAnimationSink
+{
+public: // construction/destruction
+    XBenchJitterSink() : m_recording(false) {}
+
+public: // IXWAnimationSink
+    void    deliverEvent(const XWAnimationScheduler::AnimationEvent& animationEvent, void* target, size_t& sinkData)
+    {
+        long long timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        // deviation of actual interval from requested one
+        if(sinkData && m_recording)
+        {
+            long long intervalUs = (long long)(size_t)target * 1000;
+            long long deviation = (timeUs - (long long)sinkData) - intervalUs;
+
+            m_deviationsUs.push_back(deviation < 0 ? -deviation : deviation);
+        }
+
+        sinkData = (size_t)timeUs;
+    }
+
+public: // data
+    std::vector<long long>  m_deviationsUs;
+    std::atomic<bool>       m_recording;
+};
+
+/////////////////////////////////////////////////////////////////////
+// benchmarks
+
+// cost of processing pass with given number of active timers
+static void benchProcessing(int timerCount)
+{
+    XBenchVirtualClock clock;
+    XBenchCountingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+    XWTestRandom random(timerCount);
+
+    std::vector<XWAnimationScheduler::ValueSlot*> slots;
+
+    // timers with intervals from 10 to 1000 ms
+    for(int idx = 0; idx < timerCount; ++idx)
+    {
+        slots.push_back(scheduler.startAnimation(idx + 1, false, random.range(1, 100) * 10, 0, false, 0));
+    }
+
+    scheduler.processDue();
+
+    // 10 seconds of virtual time in 1 ms steps
+    XWTestTimer timer;
+    long long maxPassUs = 0;
+
+    for(int step = 0; step < 10000; ++step)
+    {
+        clock.advance(1);
+
+        XWTestTimer passTimer;
+        scheduler.processDue();
+
+        long long passUs = passTimer.elapsedUs();
+        if(passUs > maxPassUs) maxPassUs = passUs;
+    }
+
+    long long totalUs = timer.elapsedUs();
+
+    XWAnimationScheduler::XSchedulerStats stats;
+    scheduler.getStats(stats);
+
+    printf("processing %6d timers: %8lu events, %7.1f us/pass, max %5lld us, %6.3f us/event\n",
+           timerCount, stats.events, (double)totalUs / 10000.0, maxPassUs,
+           stats.events ? (double)totalUs / (double)stats.events : 0.0);
+
+    for(size_t idx = 0; idx < slots.size(); ++idx)
+    {
+        scheduler.stopAnimation((unsigned long)idx + 1, slots[idx]);
+    }
+}
+
+// wake-up jitter of concurrent timers with scheduler thread
+static void benchJitter(int timerCount)
+{
+    XBenchSteadyClock clock;
+    XBenchJitterSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+    XWTestRandom random(timerCount);
+
+    scheduler.startThread();
+
+    std::vector<XWAnimationScheduler::ValueSlot*> slots;
+
+    // timers with intervals from 10 to 100 ms
+    for(int idx = 0; idx < timerCount; ++idx)
+    {
+        size_t interval = random.range(1, 10) * 10;
+        slots.push_back(scheduler.startAnimation(idx + 1, false, (unsigned int)interval, 0, false, (void*)interval));
+    }
+
+    // skip start up, deviations are read only after thread is stopped
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    sink.m_recording = true;
+    scheduler.resetStats();
+    std::this_thread::sleep_for(std::chrono::milliseconds(BENCH_JITTER_RUN_MS));
+
+    XWAnimationScheduler::XSchedulerStats stats;
+    scheduler.getStats(stats);
+
+    for(size_t idx = 0; idx < slots.size(); ++idx)
+    {
+        scheduler.stopAnimation((unsigned long)idx + 1, slots[idx]);
+    }
+
+    scheduler.stopThread();
+
+    std::vector<long long>& deviations = sink.m_deviationsUs;
+    std::sort(deviations.begin(), deviations.end());
+
+    if(deviations.size() == 0) return;
+
+    printf("jitter %6d timers: %8lu events, %5lu wakeups, interval deviation p50 %5lld us, p99 %5lld us, max %6lld us, "
+           "missed ticks %lu, max lateness %lld ms\n",
+           timerCount, stats.events, stats.wakeups,
+           deviations[deviations.size() / 2], deviations[deviations.size() * 99 / 100], deviations.back(),
+           stats.missedTicks, stats.maxLatenessMs);
+}
+
+// start/stop command throughput with scheduler thread
+static void benchCommands()
+{
+    XBenchSteadyClock clock;
+    XBenchCountingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    scheduler.startThread();
+
+    XWTestTimer timer;
+
+    for(unsigned long id = 1; id <= BENCH_COMMANDS / 2; ++id)
+    {
+        XWAnimationScheduler::ValueSlot* slot = scheduler.startAnimation(id, false, 1000, 0, false, 0);
+        scheduler.stopAnimation(id, slot);
+    }
+
+    long long totalUs = timer.elapsedUs();
+
+    XWAnimationScheduler::XSchedulerStats stats;
+    scheduler.getStats(stats);
+
+    scheduler.stopThread();
+
+    printf("commands: %lu in %lld ms, %.2f M/s, %lu wakeups, %lu queue full, %lu lock waits\n",
+           stats.commands, totalUs / 1000, (double)stats.commands / (double)totalUs,
+           stats.wakeups, stats.commandQueueFull, stats.lockWaits);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    benchProcessing(1000);
+    benchProcessing(BENCH_TIMERS);
+    benchProcessing(BENCH_TIMERS * 10);
+
+    benchJitter(1000);
+    benchJitter(BENCH_TIMERS);
+
+    benchCommands();
+
+    return 0;
+}
+
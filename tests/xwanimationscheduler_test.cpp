@@ -0,0 +1,439 @@
+// Animation scheduler tests with virtual clock
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "xwtest.h"
+
+// NOTE: scheduler thread is not started in deterministic tests, processDue is
+//       called directly after virtual time is moved, so results don't depend on
+//       system load. Only wake up test uses real thread and real clock.
+
+/////////////////////////////////////////////////////////////////////
+// virtual clock
+
+class XTestVirtualClock : public IXWAnimationClock
+{
+public: // construction/destruction
+    XTestVirtualClock() : m_timeMs(1000) {}
+
+public: // IXWAnimationClock
+    long long   timeMs() { return m_timeMs; }
+
+public: // interface
+    void    advance(long long deltaMs) { m_timeMs += deltaMs; }
+
+private: // data
+    std::atomic<long long>  m_timeMs;
+};
+
+/////////////////////////////////////////////////////////////////////
+// real clock
+
+class XTestSteadyClock : public IXWAnimationClock
+{
+public: // IXWAnimationClock
+    long long   timeMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/////////////////////////////////////////////////////////////////////
+// recording sink
+
+class XTestRecordingSink : public IXWAnimationSink
+{
+public: // types
+    struct Record
+    {
+        unsigned long   id;
+        XWAnimationScheduler::TAnimationEvent type;
+        float           value;
+        int             delivery;
+    };
+
+public: // construction/destruction
+    XTestRecordingSink() : m_deliveries(0), m_inDelivery(false), m_completed(0) {}
+
+public: // IXWAnimationSink
+    void    beginDelivery()
+    {
+        XWTEST_CHECK(!m_inDelivery);
+        m_inDelivery = true;
+        m_deliveries++;
+    }
+
+    void    deliverEvent(const XWAnimationScheduler::AnimationEvent& animationEvent, void* target, size_t& sinkData)
+    {
+        XWTEST_CHECK(m_inDelivery);
+
+        // sink data is kept per animation
+        sinkData++;
+
+        Record record = {animationEvent.id, animationEvent.type, animationEvent.value, m_deliveries};
+        m_records.push_back(record);
+
+        if(animationEvent.type == XWAnimationScheduler::eAnimationCompletedEvent) m_completed++;
+    }
+
+    void    endDelivery()
+    {
+        XWTEST_CHECK(m_inDelivery);
+        m_inDelivery = false;
+    }
+
+public: // interface
+    void    clear() { m_records.clear(); }
+    int     count(XWAnimationScheduler::TAnimationEvent type) const
+    {
+        int result = 0;
+        for(size_t idx = 0; idx < m_records.size(); ++idx)
+        {
+            if(m_records[idx].type == type) result++;
+        }
+        return result;
+    }
+
+public: // data
+    std::vector<Record> m_records;
+    int                 m_deliveries;
+    bool                m_inDelivery;
+    std::atomic<int>    m_completed;
+};
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testTimerDeadlines()
+{
+    XTestVirtualClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    // interval is rounded to tens of milliseconds
+    XWAnimationScheduler::ValueSlot* slot = scheduler.startAnimation(1, false, 25, 0, false, 0);
+
+    // nothing is due before first deadline
+    XWTEST_CHECK(scheduler.processDue() == 20);
+    clock.advance(19);
+    XWTEST_CHECK(scheduler.processDue() == 1);
+    XWTEST_CHECK(sink.m_records.size() == 0);
+
+    // one event per interval if processed in time
+    for(int tick = 0; tick < 10; ++tick)
+    {
+        clock.advance(tick == 0 ? 1 : 20);
+        XWTEST_CHECK(scheduler.processDue() == 20);
+    }
+
+    XWTEST_CHECK(sink.count(XWAnimationScheduler::eAnimationTimerEvent) == 10);
+    XWTEST_CHECK(sink.m_deliveries == 10);
+
+    XWAnimationScheduler::XSchedulerStats stats;
+    scheduler.getStats(stats);
+    XWTEST_CHECK(stats.events == 10);
+    XWTEST_CHECK(stats.maxLatenessMs == 0);
+    XWTEST_CHECK(stats.missedTicks == 0);
+
+    scheduler.stopAnimation(1, slot);
+    XWTEST_CHECK(scheduler.processDue() == -1);
+}
+
+static void testMissedTicks()
+{
+    XTestVirtualClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    XWAnimationScheduler::ValueSlot* slot = scheduler.startAnimation(1, false, 10, 0, false, 0);
+
+    // late by 35 ms: one event, three ticks skipped, next deadline stays on grid
+    clock.advance(45);
+    XWTEST_CHECK(scheduler.processDue() == 5);
+    XWTEST_CHECK(sink.m_records.size() == 1);
+
+    XWAnimationScheduler::XSchedulerStats stats;
+    scheduler.getStats(stats);
+    XWTEST_CHECK(stats.missedTicks == 3);
+    XWTEST_CHECK(stats.maxLatenessMs == 35);
+
+    scheduler.stopAnimation(1, slot);
+}
+
+static void testSingleTimeAndOrder()
+{
+    XTestVirtualClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    // started in reverse deadline order
+    XWAnimationScheduler::ValueSlot* slot3 = scheduler.startAnimation(3, false, 30, 0, true, 0);
+    XWAnimationScheduler::ValueSlot* slot2 = scheduler.startAnimation(2, false, 20, 0, true, 0);
+    XWAnimationScheduler::ValueSlot* slot1 = scheduler.startAnimation(1, false, 10, 0, true, 0);
+
+    // all due in one pass, delivered by deadline in one delivery
+    clock.advance(30);
+    XWTEST_CHECK(scheduler.processDue() == -1);
+    XWTEST_CHECK(sink.m_deliveries == 1);
+    XWTEST_CHECK(sink.m_records.size() == 6);
+
+    if(sink.m_records.size() == 6)
+    {
+        for(int idx = 0; idx < 3; ++idx)
+        {
+            XWTEST_CHECK(sink.m_records[idx * 2].id == (unsigned long)(idx + 1));
+            XWTEST_CHECK(sink.m_records[idx * 2].type == XWAnimationScheduler::eAnimationTimerEvent);
+            XWTEST_CHECK(sink.m_records[idx * 2 + 1].type == XWAnimationScheduler::eAnimationCompletedEvent);
+        }
+    }
+
+    // value slots are released by producer once completed
+    XWAnimationScheduler::releaseValueSlot(slot1);
+    XWAnimationScheduler::releaseValueSlot(slot2);
+    XWAnimationScheduler::releaseValueSlot(slot3);
+}
+
+static void testPauseResume()
+{
+    XTestVirtualClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    XWEasingCurve linear = XWEasingCurve::linear();
+    XWAnimationScheduler::ValueAnimation animation(0.0f, 100.0f, 100, linear, false);
+    XWAnimationScheduler::ValueSlot* slot = scheduler.startAnimation(1, true, 10, &animation, false, 0);
+
+    // pause 3 ms before second tick (value follows time, not ticks)
+    clock.advance(17);
+    scheduler.processDue();
+    scheduler.pauseAnimation(1);
+    XWTEST_CHECK(scheduler.processDue() == -1);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(slot), 17.0f, 0.001f);
+
+    // time spent in pause is not counted
+    clock.advance(500);
+    XWTEST_CHECK(scheduler.processDue() == -1);
+    scheduler.resumeAnimation(1);
+    XWTEST_CHECK(scheduler.processDue() == 3);
+    clock.advance(3);
+    scheduler.processDue();
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(slot), 20.0f, 0.001f);
+
+    // completes after remaining 80 ms
+    clock.advance(80);
+    scheduler.processDue();
+    XWTEST_CHECK(sink.m_completed == 1);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(slot), 100.0f, 0.001f);
+
+    XWAnimationScheduler::releaseValueSlot(slot);
+}
+
+static void testValueAnimations()
+{
+    XTestVirtualClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    // duration based value with easing
+    XWEasingCurve ease = XWEasingCurve::easeInOut();
+    XWAnimationScheduler::ValueAnimation eased(10.0f, 20.0f, 200, ease, false);
+    XWAnimationScheduler::ValueSlot* easedSlot = scheduler.startAnimation(1, true, 10, &eased, false, 0);
+
+    // keyframes
+    XWKeyframeTrack track;
+    track.addKeyframe(0.0f, 0.0f);
+    track.addKeyframe(0.5f, 50.0f);
+    track.addKeyframe(1.0f, 0.0f);
+    XWAnimationScheduler::ValueAnimation keyframed(track, 100, false);
+    XWAnimationScheduler::ValueSlot* keyframedSlot = scheduler.startAnimation(2, true, 10, &keyframed, false, 0);
+
+    // periodic duration based value
+    XWEasingCurve linear = XWEasingCurve::linear();
+    XWAnimationScheduler::ValueAnimation periodic(0.0f, 1.0f, 100, linear, true);
+    XWAnimationScheduler::ValueSlot* periodicSlot = scheduler.startAnimation(3, true, 10, &periodic, false, 0);
+
+    // step based value
+    XWAnimationScheduler::ValueAnimation stepped(0.0f, 1.0f, 0.25f, false);
+    XWAnimationScheduler::ValueSlot* steppedSlot = scheduler.startAnimation(4, true, 10, &stepped, false, 0);
+
+    // half way
+    for(int tick = 0; tick < 5; ++tick)
+    {
+        clock.advance(10);
+        scheduler.processDue();
+    }
+
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(easedSlot), 10.0f + 10.0f * ease.valueAt(0.25f), 0.001f);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(keyframedSlot), 50.0f, 0.001f);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(periodicSlot), 0.5f, 0.001f);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(steppedSlot), 1.0f, 0.001f);
+
+    // step based value completes once it goes over limit
+    XWTEST_CHECK(sink.m_completed == 1);
+
+    // keyframes completed, periodic value starts over
+    for(int tick = 0; tick < 7; ++tick)
+    {
+        clock.advance(10);
+        scheduler.processDue();
+    }
+
+    XWTEST_CHECK(sink.m_completed == 2);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(keyframedSlot), 0.0f, 0.001f);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(periodicSlot), 0.2f, 0.001f);
+
+    // eased value completes at end value
+    for(int tick = 0; tick < 8; ++tick)
+    {
+        clock.advance(10);
+        scheduler.processDue();
+    }
+
+    XWTEST_CHECK(sink.m_completed == 3);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(easedSlot), 20.0f, 0.001f);
+
+    scheduler.stopAnimation(3, periodicSlot);
+    XWTEST_CHECK(scheduler.processDue() == -1);
+
+    XWAnimationScheduler::releaseValueSlot(easedSlot);
+    XWAnimationScheduler::releaseValueSlot(keyframedSlot);
+    XWAnimationScheduler::releaseValueSlot(steppedSlot);
+}
+
+static void testInstantValues()
+{
+    XTestVirtualClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    // keyframes without duration jump to last value with first processing
+    XWKeyframeTrack track;
+    track.addKeyframe(0.0f, 1.0f);
+    track.addKeyframe(1.0f, 7.0f);
+    XWAnimationScheduler::ValueAnimation keyframed(track, 0, false);
+    XWAnimationScheduler::ValueSlot* keyframedSlot = scheduler.startAnimation(1, true, 100, &keyframed, false, 0);
+
+    // value with zero step
+    XWAnimationScheduler::ValueAnimation zeroStep(0.0f, 5.0f, 0.0f, false);
+    XWAnimationScheduler::ValueSlot* zeroStepSlot = scheduler.startAnimation(2, true, 100, &zeroStep, false, 0);
+
+    XWTEST_CHECK(scheduler.processDue() == -1);
+    XWTEST_CHECK(sink.m_completed == 2);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(keyframedSlot), 7.0f, 0.001f);
+    XWTEST_CHECK_NEAR(XWAnimationScheduler::readValue(zeroStepSlot), 5.0f, 0.001f);
+
+    XWAnimationScheduler::releaseValueSlot(keyframedSlot);
+    XWAnimationScheduler::releaseValueSlot(zeroStepSlot);
+}
+
+static void testRestartAndStop()
+{
+    XTestVirtualClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    // stop before first deadline delivers nothing
+    XWAnimationScheduler::ValueSlot* slot = scheduler.startAnimation(1, false, 10, 0, false, 0);
+    scheduler.stopAnimation(1, slot);
+    clock.advance(100);
+    XWTEST_CHECK(scheduler.processDue() == -1);
+    XWTEST_CHECK(sink.m_records.size() == 0);
+
+    // paused and resumed many times, outdated heap entries are ignored
+    slot = scheduler.startAnimation(1, false, 10, 0, false, 0);
+    for(int idx = 0; idx < 100; ++idx)
+    {
+        scheduler.pauseAnimation(1);
+        scheduler.resumeAnimation(1);
+    }
+
+    clock.advance(10);
+    XWTEST_CHECK(scheduler.processDue() == 10);
+    XWTEST_CHECK(sink.m_records.size() == 1);
+    XWTEST_CHECK(sink.m_records.size() && sink.m_records[0].id == 1);
+
+    scheduler.stopAnimation(1, slot);
+}
+
+static void testCommandQueueFull()
+{
+    XTestVirtualClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    std::vector<XWAnimationScheduler::ValueSlot*> slots;
+
+    // more commands than queue size, producer processes them itself without thread
+    for(unsigned long id = 1; id <= 5000; ++id)
+    {
+        slots.push_back(scheduler.startAnimation(id, false, 10, 0, true, 0));
+    }
+
+    clock.advance(10);
+    scheduler.processDue();
+    XWTEST_CHECK(sink.m_completed == 5000);
+
+    XWAnimationScheduler::XSchedulerStats stats;
+    scheduler.getStats(stats);
+    XWTEST_CHECK(stats.commands == 5000);
+    XWTEST_CHECK(stats.commandQueueFull > 0);
+
+    for(size_t idx = 0; idx < slots.size(); ++idx)
+    {
+        XWAnimationScheduler::releaseValueSlot(slots[idx]);
+    }
+}
+
+static void testThreadWakeUp()
+{
+    XTestSteadyClock clock;
+    XTestRecordingSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+
+    XWTEST_CHECK(scheduler.startThread());
+
+    std::vector<XWAnimationScheduler::ValueSlot*> slots;
+
+    // NOTE: each timer is started while thread sleeps without deadline, lost wake up
+    //       would leave it waiting forever
+    for(int idx = 0; idx < 100; ++idx)
+    {
+        slots.push_back(scheduler.startAnimation(idx + 1, false, 10, 0, true, 0));
+
+        XWTestTimer timer;
+        while(sink.m_completed < idx + 1 && timer.elapsedUs() < 1000000)
+        {
+            std::this_thread::yield();
+        }
+
+        if(!XWTEST_CHECK(sink.m_completed == idx + 1)) break;
+    }
+
+    scheduler.stopThread();
+
+    for(size_t idx = 0; idx < slots.size(); ++idx)
+    {
+        XWAnimationScheduler::releaseValueSlot(slots[idx]);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    testTimerDeadlines();
+    testMissedTicks();
+    testSingleTimeAndOrder();
+    testPauseResume();
+    testValueAnimations();
+    testInstantValues();
+    testRestartAndStop();
+    testCommandQueueFull();
+    testThreadWakeUp();
+
+    return xwtestResult("xwanimationscheduler_test");
+}
+
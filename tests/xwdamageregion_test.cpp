@@ -0,0 +1,289 @@
+// Damage region tests (merge heuristic, rectangle limit, validation and scrolling)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwwinshim.h"
+
+#include "core/xwdamageregion.h"
+
+#include "xwtest.h"
+
+// NOTE: two rectangles are merged if area painted without need (bounding box minus
+//       covered area) is not above 50% of covered area, at most 8 rectangles are
+//       kept. Random test checks that merged region still covers every pixel added
+//       and that merging never drops damage, on a small pixel grid.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define TEST_GRID_SIZE          64
+#define TEST_RANDOM_REGIONS     2000
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static RECT testRect(int left, int top, int right, int bottom)
+{
+    RECT rect = {left, top, right, bottom};
+    return rect;
+}
+
+static bool testRectEqual(const RECT& rect, int left, int top, int right, int bottom)
+{
+    return rect.left == left && rect.top == top && rect.right == right && rect.bottom == bottom;
+}
+
+static bool testRegionCovers(const XWDamageRegion& region, int posX, int posY)
+{
+    for(int idx = 0; idx < region.rectCount(); ++idx)
+    {
+        const RECT& rect = region.rectAt(idx);
+        if(posX >= rect.left && posX < rect.right && posY >= rect.top && posY < rect.bottom) return true;
+    }
+
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testMerge()
+{
+    XWDamageRegion region;
+
+    // empty rectangles are ignored
+    region.addRect(testRect(10, 10, 10, 20));
+    region.addRect(testRect(10, 10, 20, 5));
+    XWTEST_CHECK(region.isEmpty());
+
+    // overlapping rectangles are merged
+    region.addRect(testRect(0, 0, 10, 10));
+    region.addRect(testRect(5, 0, 15, 10));
+    XWTEST_CHECK(region.rectCount() == 1);
+    XWTEST_CHECK(testRectEqual(region.rectAt(0), 0, 0, 15, 10));
+
+    // rectangle inside is merged without growing
+    region.addRect(testRect(2, 2, 4, 4));
+    XWTEST_CHECK(region.rectCount() == 1);
+    XWTEST_CHECK(testRectEqual(region.rectAt(0), 0, 0, 15, 10));
+
+    // far rectangle is kept apart
+    region.addRect(testRect(100, 100, 110, 110));
+    XWTEST_CHECK(region.rectCount() == 2);
+
+    RECT rcBounds;
+    region.boundingRect(rcBounds);
+    XWTEST_CHECK(testRectEqual(rcBounds, 0, 0, 110, 110));
+
+    // rectangle between both joins them only if waste stays small
+    region.addRect(testRect(15, 0, 100, 110));
+    XWTEST_CHECK(region.rectCount() == 1);
+    XWTEST_CHECK(testRectEqual(region.rectAt(0), 0, 0, 110, 110));
+
+    region.clear();
+    XWTEST_CHECK(region.isEmpty());
+    region.boundingRect(rcBounds);
+    XWTEST_CHECK(testRectEqual(rcBounds, 0, 0, 0, 0));
+}
+
+static void testWasteLimit()
+{
+    // 100 wasted of 200 covered is exactly 50%, merged
+    XWDamageRegion region;
+    region.addRect(testRect(0, 0, 10, 10));
+    region.addRect(testRect(20, 0, 30, 10));
+    XWTEST_CHECK(region.rectCount() == 1);
+    XWTEST_CHECK(testRectEqual(region.rectAt(0), 0, 0, 30, 10));
+
+    // 110 wasted of 200 covered is above limit
+    region.clear();
+    region.addRect(testRect(0, 0, 10, 10));
+    region.addRect(testRect(21, 0, 31, 10));
+    XWTEST_CHECK(region.rectCount() == 2);
+
+    // diagonal rectangles waste half of bounding box
+    region.clear();
+    region.addRect(testRect(0, 0, 10, 10));
+    region.addRect(testRect(10, 10, 20, 20));
+    XWTEST_CHECK(region.rectCount() == 2);
+
+    // no waste allowed, only adjacent rectangles forming rectangle are merged
+    region.clear();
+    region.setMaxWastedArea(0);
+    region.addRect(testRect(0, 0, 10, 10));
+    region.addRect(testRect(10, 0, 20, 10));
+    region.addRect(testRect(0, 11, 20, 12));
+    XWTEST_CHECK(region.rectCount() == 2);
+    XWTEST_CHECK(testRectEqual(region.rectAt(0), 0, 0, 20, 10));
+
+    // merged rectangle may now merge with others (chain)
+    region.clear();
+    region.setMaxWastedArea(50);
+    region.addRect(testRect(0, 0, 10, 10));
+    region.addRect(testRect(40, 0, 50, 10));
+    XWTEST_CHECK(region.rectCount() == 2);
+    region.addRect(testRect(10, 0, 40, 10));
+    XWTEST_CHECK(region.rectCount() == 1);
+    XWTEST_CHECK(testRectEqual(region.rectAt(0), 0, 0, 50, 10));
+}
+
+static void testRectLimit()
+{
+    XWDamageRegion region;
+
+    // 9 separate rectangles, pair wasting least area is merged to keep 8
+    for(int idx = 0; idx < 8; ++idx)
+    {
+        region.addRect(testRect(idx * 100, 0, idx * 100 + 10, 10));
+    }
+    XWTEST_CHECK(region.rectCount() == 8);
+
+    region.addRect(testRect(730, 0, 740, 10));
+    XWTEST_CHECK(region.rectCount() == 8);
+
+    bool merged = false;
+    for(int idx = 0; idx < region.rectCount(); ++idx)
+    {
+        if(testRectEqual(region.rectAt(idx), 700, 0, 740, 10)) merged = true;
+    }
+    XWTEST_CHECK(merged);
+
+    // lower limit is applied at once
+    region.setMaxRectCount(3);
+    XWTEST_CHECK(region.rectCount() == 3);
+
+    RECT rcBounds;
+    region.boundingRect(rcBounds);
+    XWTEST_CHECK(testRectEqual(rcBounds, 0, 0, 740, 10));
+
+    region.setMaxRectCount(1);
+    XWTEST_CHECK(region.rectCount() == 1);
+    XWTEST_CHECK(testRectEqual(region.rectAt(0), 0, 0, 740, 10));
+}
+
+static void testValidate()
+{
+    XWDamageRegion region;
+    region.addRect(testRect(0, 0, 10, 10));
+    region.addRect(testRect(100, 0, 110, 10));
+
+    // partly covered rectangle is kept
+    region.validateRect(testRect(0, 0, 50, 5));
+    XWTEST_CHECK(region.rectCount() == 2);
+
+    // fully covered rectangle is removed
+    region.validateRect(testRect(0, 0, 50, 50));
+    XWTEST_CHECK(region.rectCount() == 1);
+    XWTEST_CHECK(testRectEqual(region.rectAt(0), 100, 0, 110, 10));
+
+    region.validateRect(testRect(100, 0, 110, 10));
+    XWTEST_CHECK(region.isEmpty());
+}
+
+static void testScroll()
+{
+    XWDamageRegion region;
+
+    // scroll up by 20, damage inside scrolled area moves with content
+    region.addRect(testRect(0, 50, 100, 55));
+    region.scrollRect(testRect(0, 0, 100, 100), 0, -20);
+
+    XWTEST_CHECK(region.rectCount() == 2);
+    XWTEST_CHECK(testRegionCovers(region, 0, 32));
+    XWTEST_CHECK(testRegionCovers(region, 0, 52));
+    XWTEST_CHECK(!testRegionCovers(region, 0, 45));
+
+    // damage moved out of scrolled area is dropped, outside damage is not moved
+    region.clear();
+    region.addRect(testRect(0, 0, 100, 10));
+    region.addRect(testRect(0, 200, 100, 210));
+    region.scrollRect(testRect(0, 0, 100, 100), 0, -20);
+
+    XWTEST_CHECK(region.rectCount() == 2);
+    XWTEST_CHECK(testRegionCovers(region, 0, 5));
+    XWTEST_CHECK(testRegionCovers(region, 0, 205));
+    XWTEST_CHECK(!testRegionCovers(region, 0, 185));
+
+    // empty region stays empty
+    region.clear();
+    region.scrollRect(testRect(0, 0, 100, 100), 10, 10);
+    XWTEST_CHECK(region.isEmpty());
+}
+
+static void testRandomCoverage()
+{
+    int failures = 0;
+
+    for(int regionIdx = 0; regionIdx < TEST_RANDOM_REGIONS; ++regionIdx)
+    {
+        XWTestRandom random(regionIdx + 1);
+        XWDamageRegion region;
+
+        int maxRects = random.range(1, 8);
+        region.setMaxRectCount(maxRects);
+        region.setMaxWastedArea(random.range(0, 1) ? 50 : random.range(0, 200));
+
+        std::vector<char> damaged(TEST_GRID_SIZE * TEST_GRID_SIZE, 0);
+
+        int rectCount = random.range(1, 30);
+        for(int idx = 0; idx < rectCount; ++idx)
+        {
+            int left = random.range(0, TEST_GRID_SIZE - 1);
+            int top = random.range(0, TEST_GRID_SIZE - 1);
+            int right = left + random.range(0, 12);
+            int bottom = top + random.range(0, 12);
+            if(right > TEST_GRID_SIZE) right = TEST_GRID_SIZE;
+            if(bottom > TEST_GRID_SIZE) bottom = TEST_GRID_SIZE;
+
+            region.addRect(testRect(left, top, right, bottom));
+
+            for(int posY = top; posY < bottom; ++posY)
+            {
+                for(int posX = left; posX < right; ++posX)
+                {
+                    damaged[posY * TEST_GRID_SIZE + posX] = 1;
+                }
+            }
+        }
+
+        // every damaged pixel is covered, rectangles stay inside grid
+        bool valid = (region.rectCount() <= maxRects);
+        for(int posY = 0; posY < TEST_GRID_SIZE && valid; ++posY)
+        {
+            for(int posX = 0; posX < TEST_GRID_SIZE; ++posX)
+            {
+                if(damaged[posY * TEST_GRID_SIZE + posX] && !testRegionCovers(region, posX, posY))
+                {
+                    valid = false;
+                    break;
+                }
+            }
+        }
+
+        for(int idx = 0; idx < region.rectCount(); ++idx)
+        {
+            const RECT& rect = region.rectAt(idx);
+            if(rect.left < 0 || rect.top < 0 || rect.right > TEST_GRID_SIZE || rect.bottom > TEST_GRID_SIZE) valid = false;
+            if(rect.right <= rect.left || rect.bottom <= rect.top) valid = false;
+        }
+
+        if(!valid && failures++ < 10) printf("region %d: damage not covered\n", regionIdx);
+    }
+
+    XWTEST_CHECK(failures == 0);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    testMerge();
+    testWasteLimit();
+    testRectLimit();
+    testValidate();
+    testScroll();
+    testRandomCoverage();
+
+    return xwtestResult("xwdamageregion_test");
+}
@@ -0,0 +1,194 @@
+// Easing curve and keyframe track evaluation benchmarks
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "xwtest.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_TRACKS            10000
+#define BENCH_FRAMES            200
+
+/////////////////////////////////////////////////////////////////////
+// virtual clock and sink
+
+class XBenchVirtualClock : public IXWAnimationClock
+{
+public: // construction/destruction
+    XBenchVirtualClock() : m_timeMs(0) {}
+
+public: // IXWAnimationClock
+    long long   timeMs() { return m_timeMs; }
+
+public: // interface
+    void    advance(long long deltaMs) { m_timeMs += deltaMs; }
+
+private: // data
+    std::atomic<long long>  m_timeMs;
+};
+
+class XBenchValueSink : public IXWAnimationSink
+{
+public: // construction/destruction
+    XBenchValueSink() : m_sum(0.0f) {}
+
+public: // IXWAnimationSink
+    void    deliverEvent(const XWAnimationScheduler::AnimationEvent& animationEvent, void* target, size_t& sinkData)
+    {
+        m_sum += animationEvent.value;
+    }
+
+public: // data
+    float   m_sum;
+};
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static XWEasingCurve benchCurve(int curveType)
+{
+    switch(curveType % 4)
+    {
+    case 0: return XWEasingCurve::linear();
+    case 1: return XWEasingCurve::easeInOut();
+    case 2: return XWEasingCurve::spring(170.0f, 26.0f);
+    default: return XWEasingCurve::steps(5);
+    }
+}
+
+static void benchTrack(XWKeyframeTrack& track, XWTestRandom& random)
+{
+    // four keyframes with mixed easing
+    track.addKeyframe(0.0f, (float)random.range(0, 100));
+    track.addKeyframe(0.3f, (float)random.range(0, 100), benchCurve(random.range(0, 3)));
+    track.addKeyframe(0.7f, (float)random.range(0, 100), benchCurve(random.range(0, 3)));
+    track.addKeyframe(1.0f, (float)random.range(0, 100), benchCurve(random.range(0, 3)));
+}
+
+/////////////////////////////////////////////////////////////////////
+// benchmarks
+
+// single curve evaluation cost
+static void benchCurves()
+{
+    static const char* curveNames[] = {"linear", "cubic-bezier", "spring", "steps"};
+
+    for(int curveType = 0; curveType < 4; ++curveType)
+    {
+        XWEasingCurve curve = benchCurve(curveType);
+        float sum = 0.0f;
+
+        XWTestTimer timer;
+
+        for(int frame = 0; frame < BENCH_FRAMES; ++frame)
+        {
+            for(int idx = 0; idx < BENCH_TRACKS; ++idx)
+            {
+                sum += curve.valueAt((float)((idx + frame) % 1000) / 1000.0f);
+            }
+        }
+
+        long long totalUs = timer.elapsedUs();
+
+        printf("curve %-12s: %6.1f us per %d values, %5.1f ns/value (%g)\n", curveNames[curveType],
+               (double)totalUs / BENCH_FRAMES, BENCH_TRACKS,
+               (double)totalUs * 1000.0 / ((double)BENCH_FRAMES * BENCH_TRACKS), sum);
+    }
+}
+
+// keyframe track evaluation cost per frame
+static void benchTracks()
+{
+    XWTestRandom random(BENCH_TRACKS);
+    std::vector<XWKeyframeTrack> tracks(BENCH_TRACKS);
+
+    for(size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        benchTrack(tracks[idx], random);
+    }
+
+    float sum = 0.0f;
+
+    XWTestTimer timer;
+
+    for(int frame = 0; frame < BENCH_FRAMES; ++frame)
+    {
+        float progress = (float)frame / (float)BENCH_FRAMES;
+
+        for(size_t idx = 0; idx < tracks.size(); ++idx)
+        {
+            sum += tracks[idx].valueAt(progress);
+        }
+    }
+
+    long long totalUs = timer.elapsedUs();
+
+    printf("tracks %d: %6.1f us/frame, %5.1f ns/track (%g)\n", BENCH_TRACKS,
+           (double)totalUs / BENCH_FRAMES, (double)totalUs * 1000.0 / ((double)BENCH_FRAMES * BENCH_TRACKS), sum);
+}
+
+// scheduler frame with all tracks due at once (evaluation and delivery)
+static void benchSchedulerFrame()
+{
+    XBenchVirtualClock clock;
+    XBenchValueSink sink;
+    XWAnimationScheduler scheduler(&clock, &sink);
+    XWTestRandom random(BENCH_TRACKS);
+
+    std::vector<XWAnimationScheduler::ValueSlot*> slots;
+
+    // periodic keyframe animations with the same interval
+    for(int idx = 0; idx < BENCH_TRACKS; ++idx)
+    {
+        XWKeyframeTrack track;
+        benchTrack(track, random);
+
+        XWAnimationScheduler::ValueAnimation animation(track, 1000 + random.range(0, 1000), true);
+        slots.push_back(scheduler.startAnimation(idx + 1, true, 10, &animation, false, 0));
+    }
+
+    scheduler.processDue();
+
+    XWTestTimer timer;
+    long long maxFrameUs = 0;
+
+    for(int frame = 0; frame < BENCH_FRAMES; ++frame)
+    {
+        clock.advance(10);
+
+        XWTestTimer frameTimer;
+        scheduler.processDue();
+
+        long long frameUs = frameTimer.elapsedUs();
+        if(frameUs > maxFrameUs) maxFrameUs = frameUs;
+    }
+
+    long long totalUs = timer.elapsedUs();
+
+    XWAnimationScheduler::XSchedulerStats stats;
+    scheduler.getStats(stats);
+
+    printf("scheduler %d tracks: %6.1f us/frame, max %5lld us, %lu events (%g)\n", BENCH_TRACKS,
+           (double)totalUs / BENCH_FRAMES, maxFrameUs, stats.events, sink.m_sum);
+
+    for(size_t idx = 0; idx < slots.size(); ++idx)
+    {
+        scheduler.stopAnimation((unsigned long)idx + 1, slots[idx]);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    benchCurves();
+    benchTracks();
+    benchSchedulerFrame();
+
+    return 0;
+}
+
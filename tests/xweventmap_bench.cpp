@@ -0,0 +1,319 @@
+// Window message dispatch benchmarks (flat handler table vs map lookup)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwwinshim.h"
+
+#include "xwtest.h"
+
+// NOTE: XBenchMapEventMap is previous XWEventMap implementation (handlers in std::map by
+//       message id), it is dispatched the way XWindow did it before: handlers found for
+//       each message are copied to new vector and called until message is processed.
+//       All dispatch variants must call the same number of handlers.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_MESSAGES          1000000
+#define BENCH_TIMERS            8           // half of timers have handlers
+#define BENCH_USER_MESSAGES     10
+#define BENCH_CHILD_WINDOWS     4
+
+/////////////////////////////////////////////////////////////////////
+// XBenchMapEventMap - previous event map (reference)
+
+class XBenchMapEventMap
+{
+public: // add handlers
+    void addEventHandler(const XWEventMask& mask, const XWEventDelegate& handler)
+    {
+        _HandlerRef ref;
+        ref.xwEventMask = mask;
+        ref.xwEventHandler = handler;
+
+        m_vEventHandlers[mask.m_uMsg].push_back(ref);
+    }
+
+public: // find handlers for events
+    std::vector<XWEventDelegate> findHandlers(const XWEvent& xwEvent)
+    {
+        std::vector<XWEventDelegate> result;
+
+        std::map<UINT, _HandlerRefVect>::iterator it = m_vEventHandlers.find(xwEvent.uMsg);
+        if(it != m_vEventHandlers.end())
+        {
+            _HandlerRefVect& handlers = it->second;
+
+            for(unsigned int idx = 0; idx < handlers.size(); ++idx)
+            {
+                if(handlers.at(idx).xwEventMask.matchEvent(xwEvent))
+                {
+                    result.push_back(handlers.at(idx).xwEventHandler);
+                }
+            }
+        }
+
+        return result;
+    }
+
+private: // handler data
+    struct _HandlerRef
+    {
+        XWEventMask     xwEventMask;
+        XWEventDelegate xwEventHandler;
+    };
+
+    typedef std::vector<_HandlerRef>    _HandlerRefVect;
+
+private: // data
+    std::map<UINT, _HandlerRefVect>     m_vEventHandlers;
+};
+
+/////////////////////////////////////////////////////////////////////
+// XBenchWindow - handler target
+
+class XBenchWindow
+{
+public: // construction/destruction
+    XBenchWindow() : handled(false), calls(0) {}
+
+public: // handlers
+    LRESULT onMessage(const XWEvent& xwEvent)
+    {
+        ++calls;
+        return 0;
+    }
+
+    LRESULT onProcessed(const XWEvent& xwEvent)
+    {
+        ++calls;
+        handled = true;
+        return 1;
+    }
+
+public: // data
+    bool            handled;
+    unsigned long   calls;
+};
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static HWND benchWindowHandle(int idx)
+{
+    static HWND__ windows[1 + BENCH_CHILD_WINDOWS];
+    return &windows[idx];
+}
+
+// handlers of typical window with child controls
+template <class _EventMap>
+static void benchAddHandlers(_EventMap& eventMap, XBenchWindow& window, int commandCount)
+{
+    XWEventDelegate onMessage = XWEventDelegate::createDelegate<XBenchWindow, &XBenchWindow::onMessage>(&window);
+    XWEventDelegate onProcessed = XWEventDelegate::createDelegate<XBenchWindow, &XBenchWindow::onProcessed>(&window);
+
+    // window messages
+    eventMap.addEventHandler(XWEventMask(WM_PAINT), onProcessed);
+    eventMap.addEventHandler(XWEventMask(WM_ERASEBKGND), onProcessed);
+    eventMap.addEventHandler(XWEventMask(WM_SIZE), onMessage);
+    eventMap.addEventHandler(XWEventMask(WM_KEYDOWN), onMessage);
+    eventMap.addEventHandler(XWEventMask(WM_CHAR), onMessage);
+    eventMap.addEventHandler(XWEventMask(WM_NOTIFY), onMessage);
+
+    // mouse, window itself and child windows
+    eventMap.addEventHandler(XWEventMask(WM_MOUSEMOVE), onMessage);
+    eventMap.addEventHandler(XWEventMask(WM_LBUTTONDOWN), onMessage);
+    eventMap.addEventHandler(XWEventMask(WM_LBUTTONUP), onMessage);
+    eventMap.addEventHandler(XWEventMask(WM_MOUSEWHEEL), onProcessed);
+    for(int idx = 1; idx <= BENCH_CHILD_WINDOWS; ++idx)
+    {
+        eventMap.addEventHandler(XWEventMask(benchWindowHandle(idx), WM_MOUSEMOVE), onMessage);
+    }
+
+    // timers by id
+    for(int idx = 0; idx < BENCH_TIMERS; idx += 2)
+    {
+        XWEventMask mask(WM_TIMER);
+        mask.setWParam(idx + 1);
+        eventMap.addEventHandler(mask, onProcessed);
+    }
+
+    // commands by control id
+    for(int idx = 0; idx < commandCount; ++idx)
+    {
+        XWEventMask mask(WM_COMMAND);
+        mask.setWParamLoWord((WORD)(1000 + idx));
+        eventMap.addEventHandler(mask, onProcessed);
+    }
+
+    // user messages
+    for(int idx = 0; idx < BENCH_USER_MESSAGES; ++idx)
+    {
+        eventMap.addEventHandler(XWEventMask(WM_USER + idx), onMessage);
+    }
+}
+
+// synthetic message streams
+enum TBenchStream
+{
+    eStreamMouse,       // mouse moves over window and child windows, hit-testing and cursor
+    eStreamTimers,      // timers with and without handlers, painting
+    eStreamCommands,    // commands from controls with notifications
+    eStreamMixed        // any message, including ones without handlers
+};
+
+static void benchCreateStream(TBenchStream streamType, int commandCount, std::vector<XWEvent>& streamOut)
+{
+    static const UINT mixedMessages[] = {WM_SIZE, WM_PAINT, WM_ERASEBKGND, WM_SETCURSOR, WM_NOTIFY, WM_NCHITTEST,
+                                         WM_KEYDOWN, WM_CHAR, WM_COMMAND, WM_TIMER, WM_MOUSEMOVE, WM_LBUTTONDOWN,
+                                         WM_LBUTTONUP, WM_MOUSEWHEEL, WM_USER, WM_USER + 2 * BENCH_USER_MESSAGES};
+
+    XWTestRandom random(streamType + 1);
+    streamOut.resize(BENCH_MESSAGES);
+
+    for(int idx = 0; idx < BENCH_MESSAGES; ++idx)
+    {
+        XWEvent& xwEvent = streamOut[idx];
+        xwEvent.hWnd = benchWindowHandle(random.range(0, BENCH_CHILD_WINDOWS));
+        xwEvent.lParam = MAKELPARAM(random.range(0, 800), random.range(0, 600));
+        xwEvent.wParam = 0;
+
+        if(streamType == eStreamMouse)
+        {
+            int type = random.range(0, 9);
+            xwEvent.uMsg = (type < 8) ? WM_MOUSEMOVE : ((type == 8) ? WM_SETCURSOR : WM_NCHITTEST);
+
+        } else if(streamType == eStreamTimers)
+        {
+            int type = random.range(0, 9);
+            xwEvent.uMsg = (type < 8) ? WM_TIMER : ((type == 8) ? WM_PAINT : WM_ERASEBKGND);
+            xwEvent.wParam = random.range(1, BENCH_TIMERS);
+
+        } else if(streamType == eStreamCommands)
+        {
+            xwEvent.uMsg = random.chance(70) ? WM_COMMAND : WM_NOTIFY;
+            xwEvent.wParam = MAKEWPARAM(1000 + random.range(0, commandCount - 1), random.range(0, 1));
+
+        } else
+        {
+            xwEvent.uMsg = mixedMessages[random.range(0, sizeof(mixedMessages) / sizeof(mixedMessages[0]) - 1)];
+            if(xwEvent.uMsg == WM_COMMAND) xwEvent.wParam = MAKEWPARAM(1000 + random.range(0, commandCount - 1), 0);
+            if(xwEvent.uMsg == WM_TIMER) xwEvent.wParam = random.range(1, BENCH_TIMERS);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// benchmarks
+
+static bool benchDispatch(TBenchStream streamType, int commandCount)
+{
+    static const char* streamNames[] = {"mouse", "timers", "commands", "mixed"};
+
+    std::vector<XWEvent> stream;
+    benchCreateStream(streamType, commandCount, stream);
+
+    XBenchWindow mapWindow;
+    XBenchMapEventMap mapEventMap;
+    benchAddHandlers(mapEventMap, mapWindow, commandCount);
+
+    XBenchWindow flatWindow;
+    XWEventMap flatEventMap;
+    benchAddHandlers(flatEventMap, flatWindow, commandCount);
+
+    XBenchWindow findWindow;
+    XWEventMap findEventMap;
+    benchAddHandlers(findEventMap, findWindow, commandCount);
+
+    LRESULT checksum = 0;
+
+    // map lookup, handlers copied to vector (previous XWindow dispatch)
+    XWTestTimer timer;
+    for(size_t idx = 0; idx < stream.size(); ++idx)
+    {
+        mapWindow.handled = false;
+
+        std::vector<XWEventDelegate> handlers = mapEventMap.findHandlers(stream[idx]);
+        for(unsigned int hidx = 0; hidx < handlers.size(); ++hidx)
+        {
+            LRESULT retVal = handlers.at(hidx)(stream[idx]);
+            if(mapWindow.handled)
+            {
+                checksum += retVal;
+                break;
+            }
+        }
+    }
+    double mapNs = (double)timer.elapsedUs() * 1000.0 / stream.size();
+
+    // flat table, handlers called in place
+    timer.restart();
+    for(size_t idx = 0; idx < stream.size(); ++idx)
+    {
+        flatWindow.handled = false;
+        checksum -= flatEventMap.dispatchEvent(stream[idx], flatWindow.handled);
+    }
+    double flatNs = (double)timer.elapsedUs() * 1000.0 / stream.size();
+
+    // findHandlers kept for existing callers
+    timer.restart();
+    for(size_t idx = 0; idx < stream.size(); ++idx)
+    {
+        findWindow.handled = false;
+
+        std::vector<XWEventDelegate> handlers = findEventMap.findHandlers(stream[idx]);
+        for(unsigned int hidx = 0; hidx < handlers.size(); ++hidx)
+        {
+            handlers.at(hidx)(stream[idx]);
+            if(findWindow.handled) break;
+        }
+    }
+    double findNs = (double)timer.elapsedUs() * 1000.0 / stream.size();
+
+    bool same = (mapWindow.calls == flatWindow.calls && mapWindow.calls == findWindow.calls && checksum == 0);
+
+    printf("%-8s %3d commands: map %6.1f ns/msg, flat table %5.1f ns/msg (%4.1fx), findHandlers %6.1f ns/msg, %lu calls%s\n",
+           streamNames[streamType], commandCount, mapNs, flatNs, mapNs / flatNs, findNs, flatWindow.calls,
+           same ? "" : " MISMATCH");
+
+    return same;
+}
+
+// table rebuild cost (paid once after handlers change)
+static void benchRebuild(int commandCount)
+{
+    XBenchWindow window;
+    XWEvent xwEvent(benchWindowHandle(0), WM_PAINT, 0, 0);
+    int repeats = 2000;
+
+    XWTestTimer timer;
+    for(int idx = 0; idx < repeats; ++idx)
+    {
+        XWEventMap eventMap;
+        benchAddHandlers(eventMap, window, commandCount);
+
+        window.handled = false;
+        eventMap.dispatchEvent(xwEvent, window.handled);
+    }
+
+    printf("add handlers and build table, %3d commands: %6.1f us\n", commandCount, (double)timer.elapsedUs() / repeats);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    bool same = true;
+
+    for(int commandCount = 10; commandCount <= 100; commandCount *= 10)
+    {
+        same &= benchDispatch(eStreamMouse, commandCount);
+        same &= benchDispatch(eStreamTimers, commandCount);
+        same &= benchDispatch(eStreamCommands, commandCount);
+        same &= benchDispatch(eStreamMixed, commandCount);
+        benchRebuild(commandCount);
+    }
+
+    return same ? 0 : 1;
+}
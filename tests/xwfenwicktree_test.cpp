@@ -0,0 +1,251 @@
+// Prefix sum tree tests (against naive prefix sums)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "core/xwfenwicktree.h"
+
+#include "xwtest.h"
+
+// NOTE: every operation is repeated on plain array of values, all prefix sums and
+//       index searches of tree must match the array after each step. Sizes cross
+//       powers of two both ways, as appendValue builds new node from partial sums
+//       and findIndex step depends on largest power of two not above count.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define TEST_RANDOM_RUNS        100
+#define TEST_RANDOM_STEPS       400
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+// largest index with prefix sum not above offset
+static int naiveFindIndex(const std::vector<int>& values, int offset)
+{
+    if(offset < 0) return 0;
+
+    int idx = 0;
+    int sum = 0;
+    for(size_t pos = 0; pos < values.size(); ++pos)
+    {
+        sum += values[pos];
+        if(sum > offset) break;
+        idx = (int)pos + 1;
+    }
+
+    return idx;
+}
+
+// compare all sums and searches, returns false on first difference
+static bool compareTree(const XWFenwickTree& tree, const std::vector<int>& values)
+{
+    if(tree.count() != (int)values.size()) return false;
+
+    int sum = 0;
+    for(int idx = 0; idx <= tree.count(); ++idx)
+    {
+        if(tree.prefixSum(idx) != sum) return false;
+        if(idx < tree.count())
+        {
+            if(tree.value(idx) != values[idx]) return false;
+            sum += values[idx];
+        }
+    }
+
+    if(tree.totalSum() != sum) return false;
+
+    // every offset up to total and few after it
+    for(int offset = -2; offset <= sum + 2; ++offset)
+    {
+        if(tree.findIndex(offset) != naiveFindIndex(values, offset)) return false;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testEmpty()
+{
+    XWFenwickTree tree;
+    XWTEST_CHECK(tree.count() == 0);
+    XWTEST_CHECK(tree.totalSum() == 0);
+    XWTEST_CHECK(tree.findIndex(0) == 0);
+    XWTEST_CHECK(tree.findIndex(100) == 0);
+
+    tree.reset(0, 10);
+    XWTEST_CHECK(tree.count() == 0);
+    XWTEST_CHECK(tree.findIndex(5) == 0);
+}
+
+static void testFixedValues()
+{
+    // rows of the same height
+    XWFenwickTree tree;
+    tree.reset(100, 20);
+
+    XWTEST_CHECK(tree.totalSum() == 2000);
+    XWTEST_CHECK(tree.prefixSum(37) == 740);
+    XWTEST_CHECK(tree.findIndex(0) == 0);
+    XWTEST_CHECK(tree.findIndex(19) == 0);
+    XWTEST_CHECK(tree.findIndex(20) == 1);
+    XWTEST_CHECK(tree.findIndex(1999) == 99);
+    XWTEST_CHECK(tree.findIndex(2000) == 100);
+
+    // single row grows
+    tree.setValue(50, 120);
+    XWTEST_CHECK(tree.totalSum() == 2100);
+    XWTEST_CHECK(tree.prefixSum(51) == 1120);
+    XWTEST_CHECK(tree.findIndex(1000) == 50);
+    XWTEST_CHECK(tree.findIndex(1119) == 50);
+    XWTEST_CHECK(tree.findIndex(1120) == 51);
+
+    // zero sized values are skipped by search
+    std::vector<int> values;
+    values.push_back(5);
+    values.push_back(0);
+    values.push_back(0);
+    values.push_back(3);
+    tree.assign(values);
+    XWTEST_CHECK(tree.findIndex(4) == 0);
+    XWTEST_CHECK(tree.findIndex(5) == 3);
+    XWTEST_CHECK(tree.findIndex(8) == 4);
+    XWTEST_CHECK(compareTree(tree, values));
+
+    tree.clear();
+    XWTEST_CHECK(tree.count() == 0);
+    XWTEST_CHECK(tree.totalSum() == 0);
+}
+
+static void testAppendRemove()
+{
+    // grow over powers of two one value at a time, then shrink back
+    XWFenwickTree tree;
+    std::vector<int> values;
+
+    bool valid = true;
+    for(int idx = 0; idx < 260; ++idx)
+    {
+        int value = (idx * 7) % 13;
+        tree.appendValue(value);
+        values.push_back(value);
+
+        if(!compareTree(tree, values))
+        {
+            printf("append: sums differ at count %d\n", tree.count());
+            valid = false;
+            break;
+        }
+    }
+
+    while(valid && tree.count() > 0)
+    {
+        tree.removeLastValue();
+        values.pop_back();
+
+        if(!compareTree(tree, values))
+        {
+            printf("remove: sums differ at count %d\n", tree.count());
+            valid = false;
+        }
+    }
+
+    XWTEST_CHECK(valid);
+
+    // appending after tree was built at once and after it was emptied
+    tree.reset(64, 3);
+    values.assign(64, 3);
+    for(int idx = 0; idx < 70; ++idx)
+    {
+        tree.appendValue(idx);
+        values.push_back(idx);
+    }
+    XWTEST_CHECK(compareTree(tree, values));
+
+    for(int idx = 0; idx < 6; ++idx)
+    {
+        tree.removeLastValue();
+        values.pop_back();
+    }
+    tree.setValue(127, 1000);
+    values[127] = 1000;
+    XWTEST_CHECK(compareTree(tree, values));
+}
+
+static void testRandomOperations()
+{
+    int failures = 0;
+
+    for(int run = 0; run < TEST_RANDOM_RUNS; ++run)
+    {
+        XWTestRandom random(run + 1);
+        XWFenwickTree tree;
+        std::vector<int> values;
+
+        int maxValue = random.range(0, 1) ? 3 : 50;
+
+        for(int step = 0; step < TEST_RANDOM_STEPS; ++step)
+        {
+            int operation = random.range(0, 99);
+
+            if(operation < 40)
+            {
+                int value = random.range(0, maxValue);
+                tree.appendValue(value);
+                values.push_back(value);
+
+            } else if(operation < 60)
+            {
+                if(values.empty()) continue;
+                tree.removeLastValue();
+                values.pop_back();
+
+            } else if(operation < 95)
+            {
+                if(values.empty()) continue;
+                int idx = random.range(0, (int)values.size() - 1);
+                int value = random.range(0, maxValue);
+                tree.setValue(idx, value);
+                values[idx] = value;
+
+            } else if(operation < 98)
+            {
+                int count = random.range(0, 140);
+                int value = random.range(0, maxValue);
+                tree.reset(count, value);
+                values.assign(count, value);
+
+            } else
+            {
+                tree.assign(values);
+            }
+
+            if(!compareTree(tree, values))
+            {
+                if(failures++ < 10) printf("run %d step %d: sums differ at count %d\n", run, step, tree.count());
+                break;
+            }
+        }
+    }
+
+    XWTEST_CHECK(failures == 0);
+
+    printf("random operations: %d runs of %d steps checked\n", TEST_RANDOM_RUNS, TEST_RANDOM_STEPS);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    testEmpty();
+    testFixedValues();
+    testAppendRemove();
+    testRandomOperations();
+
+    return xwtestResult("xwfenwicktree_test");
+}
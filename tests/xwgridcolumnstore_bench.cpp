@@ -0,0 +1,355 @@
+// Grid cell storage benchmarks (column store vs rows of cell structures)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwwinshim.h"
+
+#include "xctrls/xwgridcolumnstore.h"
+
+#include "xwtest.h"
+
+// NOTE: XBenchGridCell and XBenchGridRow repeat previous XWGridWindow storage (row of
+//       full cell structures with std::wstring text and hint). Memory is counted by
+//       heap counter (xwtestheap.cpp), so it includes heap allocations only (requested
+//       bytes). Text itself takes the same memory in both storages, it is reported apart.
+//       wchar_t takes 4 bytes here and 2 bytes on Windows, std::wstring keeps short
+//       text inline on Windows (up to 7 characters), so absolute numbers differ there.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_ROWS              100000
+#define BENCH_COLUMNS           10
+#define BENCH_HINT_PERCENT      1
+#define BENCH_SELECT_PERCENT    10
+#define BENCH_REWRITE_PERCENT   10
+#define BENCH_SCAN_REPEATS      20
+
+/////////////////////////////////////////////////////////////////////
+// previous storage (reference)
+
+struct XBenchGridCell
+{
+    int             type;
+    bool            editable;
+    bool            modified;
+    bool            clickable;
+    bool            selectable;
+    bool            hovered;
+    bool            clicked;
+    bool            selected;
+    std::wstring    text;
+    std::wstring    hint;
+    HBITMAP         bitmap;
+    HBITMAP         bitmapHovered;
+    HBITMAP         bitmapCliked;
+    int             listIndex;
+    const wchar_t** listItems;
+    int             listItemCount;
+    LRESULT         userData;
+    int             extentWidth;
+    int             extentHeight;
+    bool            measured;
+
+    XBenchGridCell() : type(0), editable(false), modified(false), clickable(false), selectable(false),
+                       hovered(false), clicked(false), selected(false), bitmap(0), bitmapHovered(0), bitmapCliked(0),
+                       listIndex(-1), listItems(0), listItemCount(0), userData(0),
+                       extentWidth(-1), extentHeight(0), measured(false) {}
+};
+
+struct XBenchGridRow
+{
+    int                             height;
+    bool                            layoutDirty;
+    std::vector<XBenchGridCell>     cells;
+
+    XBenchGridRow(int columnCount) : height(0), layoutDirty(false), cells(columnCount) {}
+};
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+// cell text, numbers in most columns and longer names in some
+static void benchCellText(XWTestRandom& random, int column, wchar_t* textOut, size_t textSize)
+{
+    if(column % 3 == 0)
+        swprintf(textOut, textSize, L"Customer name %d", random.range(0, 999999));
+    else if(column % 3 == 1)
+        swprintf(textOut, textSize, L"%d.%02d", random.range(0, 99999), random.range(0, 99));
+    else
+        swprintf(textOut, textSize, L"%d", random.range(0, 9999));
+}
+
+struct XBenchResult
+{
+    double      fillMs;
+    size_t      textBytes;
+    size_t      heapBytes;
+    size_t      heapBlocks;
+    double      hintMs;
+    double      clearSelectionUs;
+    double      fitContentUs;
+    double      rewriteMs;
+    long long   checksum;
+};
+
+static void benchPrint(const char* name, const XBenchResult& result)
+{
+    int cells = BENCH_ROWS * BENCH_COLUMNS;
+
+    printf("%-12s: fill %6.1f ms, %6.1f MB (%5.1f bytes/cell, %5.1f over text, %7zu blocks), hints %5.1f ms, "
+           "clear selection %7.1f us, fit content %7.1f us, rewrite %5.1f ms\n",
+           name, result.fillMs, (double)result.heapBytes / (1024.0 * 1024.0), (double)result.heapBytes / cells,
+           (double)(result.heapBytes - result.textBytes) / cells, result.heapBlocks,
+           result.hintMs, result.clearSelectionUs, result.fitContentUs, result.rewriteMs);
+}
+
+/////////////////////////////////////////////////////////////////////
+// benchmarks
+
+static XBenchResult benchRows()
+{
+    XBenchResult result;
+    XWTestRandom random(1);
+    wchar_t text[64];
+
+    size_t heapBefore = xwtestHeapBytes();
+    size_t blocksBefore = xwtestHeapBlocks();
+
+    std::vector<XBenchGridRow>* rows = new std::vector<XBenchGridRow>;
+
+    // fill rows
+    result.textBytes = 0;
+    XWTestTimer timer;
+    for(int row = 0; row < BENCH_ROWS; ++row)
+    {
+        rows->push_back(XBenchGridRow(BENCH_COLUMNS));
+
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            benchCellText(random, column, text, 64);
+            result.textBytes += (wcslen(text) + 1) * sizeof(wchar_t);
+
+            XBenchGridCell& cell = rows->back().cells[column];
+            cell.text = text;
+            cell.selectable = true;
+            cell.extentWidth = (int)cell.text.length() * 7;
+            cell.measured = true;
+        }
+    }
+    result.fillMs = (double)timer.elapsedUs() / 1000.0;
+
+    // few cells with hint
+    timer.restart();
+    for(int row = 0; row < BENCH_ROWS; ++row)
+    {
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            if(random.chance(BENCH_HINT_PERCENT)) (*rows)[row].cells[column].hint = L"Cell hint text shown in tooltip";
+        }
+    }
+    result.hintMs = (double)timer.elapsedUs() / 1000.0;
+
+    result.heapBytes = xwtestHeapBytes() - heapBefore;
+    result.heapBlocks = xwtestHeapBlocks() - blocksBefore;
+
+    // clear selection over grid
+    timer.restart();
+    for(int repeat = 0; repeat < BENCH_SCAN_REPEATS; ++repeat)
+    {
+        for(int row = 0; row < BENCH_ROWS; row += 100 / BENCH_SELECT_PERCENT)
+        {
+            (*rows)[row].cells[row % BENCH_COLUMNS].selected = true;
+        }
+
+        for(size_t row = 0; row < rows->size(); ++row)
+        {
+            for(int column = 0; column < BENCH_COLUMNS; ++column)
+            {
+                (*rows)[row].cells[column].selected = false;
+            }
+        }
+    }
+    result.clearSelectionUs = (double)timer.elapsedUs() / BENCH_SCAN_REPEATS;
+
+    // widest measured cell of each column
+    result.checksum = 0;
+    timer.restart();
+    for(int repeat = 0; repeat < BENCH_SCAN_REPEATS; ++repeat)
+    {
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            int maxWidth = 0;
+            for(size_t row = 0; row < rows->size(); ++row)
+            {
+                const XBenchGridCell& cell = (*rows)[row].cells[column];
+                if(cell.measured && cell.extentWidth > maxWidth) maxWidth = cell.extentWidth;
+            }
+
+            result.checksum += maxWidth;
+        }
+    }
+    result.fitContentUs = (double)timer.elapsedUs() / BENCH_SCAN_REPEATS;
+
+    // rewrite part of cells with new text
+    timer.restart();
+    for(int row = 0; row < BENCH_ROWS; ++row)
+    {
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            if(!random.chance(BENCH_REWRITE_PERCENT)) continue;
+
+            benchCellText(random, column, text, 64);
+            (*rows)[row].cells[column].text = text;
+        }
+    }
+    result.rewriteMs = (double)timer.elapsedUs() / 1000.0;
+
+    // text checksum
+    for(size_t row = 0; row < rows->size(); ++row)
+    {
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            result.checksum += (*rows)[row].cells[column].text.length();
+        }
+    }
+
+    delete rows;
+
+    return result;
+}
+
+static XBenchResult benchColumns()
+{
+    XBenchResult result;
+    XWTestRandom random(1);
+    wchar_t text[64];
+
+    size_t heapBefore = xwtestHeapBytes();
+    size_t blocksBefore = xwtestHeapBlocks();
+
+    std::vector<XWGridColumnStore>* columns = new std::vector<XWGridColumnStore>(BENCH_COLUMNS);
+
+    // fill rows
+    result.textBytes = 0;
+    XWTestTimer timer;
+    for(int row = 0; row < BENCH_ROWS; ++row)
+    {
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            benchCellText(random, column, text, 64);
+            result.textBytes += (wcslen(text) + 1) * sizeof(wchar_t);
+
+            XWGridColumnStore& store = (*columns)[column];
+            store.appendCell();
+            store.setText(row, text);
+            store.setFlag(row, XWGRID_CELL_SELECTABLE, true);
+            store.setExtent(row, store.textLength(row) * 7, 0);
+            store.setFlag(row, XWGRID_CELL_MEASURED, true);
+        }
+    }
+    result.fillMs = (double)timer.elapsedUs() / 1000.0;
+
+    // few cells with hint
+    timer.restart();
+    for(int row = 0; row < BENCH_ROWS; ++row)
+    {
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            if(random.chance(BENCH_HINT_PERCENT)) (*columns)[column].editAttributes(row).hint = L"Cell hint text shown in tooltip";
+        }
+    }
+    result.hintMs = (double)timer.elapsedUs() / 1000.0;
+
+    result.heapBytes = xwtestHeapBytes() - heapBefore;
+    result.heapBlocks = xwtestHeapBlocks() - blocksBefore;
+
+    // clear selection over grid
+    timer.restart();
+    for(int repeat = 0; repeat < BENCH_SCAN_REPEATS; ++repeat)
+    {
+        for(int row = 0; row < BENCH_ROWS; row += 100 / BENCH_SELECT_PERCENT)
+        {
+            (*columns)[row % BENCH_COLUMNS].setFlag(row, XWGRID_CELL_SELECTED, true);
+        }
+
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            (*columns)[column].clearFlag(XWGRID_CELL_SELECTED);
+        }
+    }
+    result.clearSelectionUs = (double)timer.elapsedUs() / BENCH_SCAN_REPEATS;
+
+    // widest measured cell of each column
+    result.checksum = 0;
+    timer.restart();
+    for(int repeat = 0; repeat < BENCH_SCAN_REPEATS; ++repeat)
+    {
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            const XWGridColumnStore& store = (*columns)[column];
+
+            int maxWidth = 0;
+            for(int row = 0; row < store.count(); ++row)
+            {
+                if(store.flag(row, XWGRID_CELL_MEASURED) && store.extentWidth(row) > maxWidth) maxWidth = store.extentWidth(row);
+            }
+
+            result.checksum += maxWidth;
+        }
+    }
+    result.fitContentUs = (double)timer.elapsedUs() / BENCH_SCAN_REPEATS;
+
+    // rewrite part of cells with new text
+    timer.restart();
+    for(int row = 0; row < BENCH_ROWS; ++row)
+    {
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            if(!random.chance(BENCH_REWRITE_PERCENT)) continue;
+
+            benchCellText(random, column, text, 64);
+            (*columns)[column].setText(row, text);
+        }
+    }
+    result.rewriteMs = (double)timer.elapsedUs() / 1000.0;
+
+    // text checksum
+    for(int column = 0; column < BENCH_COLUMNS; ++column)
+    {
+        for(int row = 0; row < (*columns)[column].count(); ++row)
+        {
+            result.checksum += (*columns)[column].textLength(row);
+        }
+    }
+
+    delete columns;
+
+    return result;
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    printf("grid %d rows x %d columns, cell structure %zu bytes\n", BENCH_ROWS, BENCH_COLUMNS, sizeof(XBenchGridCell));
+
+    XBenchResult rowsResult = benchRows();
+    benchPrint("rows", rowsResult);
+
+    XBenchResult columnsResult = benchColumns();
+    benchPrint("column store", columnsResult);
+
+    printf("memory %.1fx smaller, %.1fx smaller over text\n", (double)rowsResult.heapBytes / columnsResult.heapBytes,
+           (double)(rowsResult.heapBytes - rowsResult.textBytes) / (columnsResult.heapBytes - columnsResult.textBytes));
+
+    // both storages must end with the same content
+    if(rowsResult.checksum != columnsResult.checksum)
+    {
+        printf("checksum MISMATCH\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,276 @@
+// Headless item host: fake window, input injector and null/software painter
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwheadless.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// scrollbar width of fake window
+#define XHEADLESS_SCROLLBAR     12
+
+/////////////////////////////////////////////////////////////////////
+// XHeadlessPainter - null or software painter
+/////////////////////////////////////////////////////////////////////
+XHeadlessPainter::XHeadlessPainter(int width, int height, bool software) :
+    fills(0),
+    filledArea(0),
+    m_width(width),
+    m_height(height)
+{
+    // software painter keeps pixels, null painter only counts
+    if(software) m_pixels.resize((size_t)width * height, 0);
+}
+
+XHeadlessPainter::~XHeadlessPainter()
+{
+}
+
+void XHeadlessPainter::fillRect(const RECT& rect, COLORREF color)
+{
+    RECT surface = {0, 0, m_width, m_height};
+    RECT fill;
+
+    // clip to surface
+    if(!::IntersectRect(&fill, &rect, &surface)) return;
+
+    fills++;
+    filledArea += (unsigned long long)(fill.right - fill.left) * (fill.bottom - fill.top);
+
+    // ignore pixels for null painter
+    if(m_pixels.size() == 0) return;
+
+    for(int row = fill.top; row < fill.bottom; ++row)
+    {
+        COLORREF* line = &m_pixels[(size_t)row * m_width];
+        std::fill(line + fill.left, line + fill.right, color);
+    }
+}
+
+COLORREF XHeadlessPainter::pixel(int posX, int posY) const
+{
+    if(m_pixels.size() == 0 || posX < 0 || posY < 0 || posX >= m_width || posY >= m_height) return 0;
+
+    return m_pixels[(size_t)posY * m_width + posX];
+}
+
+/////////////////////////////////////////////////////////////////////
+// XHeadlessItem - graphics item with test access and event counters
+/////////////////////////////////////////////////////////////////////
+XHeadlessItem::XHeadlessItem(XGraphicsItem* parent) :
+    XGraphicsItem(parent),
+    mouseEnters(0),
+    clicks(0)
+{
+    // count own clicked events
+    addClickedHandler(XWObjectEventDelegate::createDelegate<XHeadlessItem, &XHeadlessItem::_onClicked>(this));
+}
+
+XHeadlessItem::~XHeadlessItem()
+{
+}
+
+void XHeadlessItem::onMouseEnter(int posX, int posY)
+{
+    mouseEnters++;
+
+    XGraphicsItem::onMouseEnter(posX, posY);
+}
+
+bool XHeadlessItem::_onClicked(unsigned long eventId, XWObject* source)
+{
+    clicks++;
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////
+// XHeadlessWindow - fake window with scroll view over root item
+/////////////////////////////////////////////////////////////////////
+XHeadlessWindow::XHeadlessWindow(int width, int height) :
+    m_rootItem(0),
+    m_mouseCaptureItem(0),
+    m_width(width),
+    m_height(height),
+    m_verticalScrollBar(false),
+    m_layoutRequested(false),
+    m_repaintRequests(0)
+{
+    setShowVerticalScrollBar(eScrollBarShowAuto);
+}
+
+XHeadlessWindow::~XHeadlessWindow()
+{
+    delete m_rootItem;
+}
+
+void XHeadlessWindow::setRootItem(XGraphicsItem* rootItem)
+{
+    delete m_rootItem;
+    m_mouseCaptureItem = 0;
+
+    // NOTE: requests from all items in tree come to window (same as parent window)
+    m_rootItem = rootItem;
+    m_rootItem->setItemHost(this);
+    setScrollableItem(m_rootItem);
+
+    layout();
+}
+
+void XHeadlessWindow::resize(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+
+    layout();
+}
+
+void XHeadlessWindow::layout()
+{
+    // deferred layout requested by items
+    if(m_layoutRequested)
+    {
+        m_layoutRequested = false;
+        m_rootItem->flushLayout();
+    }
+
+    // same as window size change
+    updateScrollView(0, 0, m_width, m_height);
+}
+
+void XHeadlessWindow::paint(XHeadlessPainter& painter)
+{
+    RECT rcPaint = {0, 0, m_width, m_height};
+    paint(painter, rcPaint);
+}
+
+void XHeadlessWindow::paint(XHeadlessPainter& painter, const RECT& rcPaint)
+{
+    RECT rcItemPaint;
+
+    if(m_rootItem && XWUtils::rectIntersect(m_rootItem->rect(), rcPaint, rcItemPaint)) 
+        m_rootItem->onPaintGDI(painter.hdc(), rcItemPaint);
+}
+
+void XHeadlessWindow::setFocus()
+{
+    // same as window receiving focus
+    if(m_rootItem) m_rootItem->setFocus(true);
+}
+
+void XHeadlessWindow::onMouseMove(int posX, int posY)
+{
+    if(_mouseItem()) _mouseItem()->onMouseMove(posX, posY, 0);
+}
+
+bool XHeadlessWindow::onMouseClick(int posX, int posY)
+{
+    if(m_rootItem == 0) return false;
+
+    // NOTE: mouse is moved to click position first, items find clicked item from mouse item
+    onMouseMove(posX, posY);
+
+    bool pressed = _mouseItem()->onMouseClick(WM_LBUTTONDOWN, posX, posY, 0);
+    bool released = _mouseItem()->onMouseClick(WM_LBUTTONUP, posX, posY, 0);
+
+    return pressed || released;
+}
+
+void XHeadlessWindow::onMouseWheel(int wheelDelta)
+{
+    if(m_rootItem == 0) return;
+
+    // keep content inside view
+    int maxOffset = std::max(0, m_rootItem->contentHeight() - m_rootItem->height());
+    int offset = m_rootItem->scrollOffsetY() - m_rootItem->scrollOffsetForWheel(wheelDelta);
+
+    m_rootItem->setScrollOffsetY(std::min(std::max(offset, 0), maxOffset));
+
+    layout();
+}
+
+void XHeadlessWindow::onTabKey()
+{
+    if(m_rootItem) m_rootItem->onCharEvent(VK_TAB, 0);
+}
+
+void XHeadlessWindow::setMouseCapture(XGraphicsItem* item)
+{
+    // mouse events go to item until capture is reset
+    m_mouseCaptureItem = item;
+}
+
+void XHeadlessWindow::resetMouseCapture()
+{
+    m_mouseCaptureItem = 0;
+}
+
+void XHeadlessWindow::repaintRect(const RECT& rcPaint, bool paintNow)
+{
+    // NOTE: nothing is painted until paint is called
+    m_repaintRequests++;
+}
+
+bool XHeadlessWindow::requestLayout()
+{
+    // NOTE: pass is done by next layout call
+    m_layoutRequested = true;
+
+    return true;
+}
+
+void XHeadlessWindow::updateScrollItem(int posX, int posY, int width, int height)
+{
+    m_rootItem->update(posX, posY, width, height);
+}
+
+void XHeadlessWindow::updateScrollBar(TScrollOrientation scrollOrient, int posX, int posY, int width, int height)
+{
+    // nothing to position
+}
+
+void XHeadlessWindow::showScrollBar(TScrollOrientation scrollOrient, bool bShow)
+{
+    if(scrollOrient == eVerticalScrollBar) m_verticalScrollBar = bShow;
+}
+
+bool XHeadlessWindow::isScrollBarVisible(TScrollOrientation scrollOrient)
+{
+    return (scrollOrient == eVerticalScrollBar) ? m_verticalScrollBar : false;
+}
+
+int XHeadlessWindow::scrollBarWidth(TScrollOrientation scrollOrient)
+{
+    return XHEADLESS_SCROLLBAR;
+}
+
+/////////////////////////////////////////////////////////////////////
+// XHeadlessInputInjector - synthetic input
+/////////////////////////////////////////////////////////////////////
+XHeadlessInputInjector::XHeadlessInputInjector(XHeadlessWindow* window, unsigned long long seed) :
+    m_window(window),
+    m_random(seed)
+{
+}
+
+void XHeadlessInputInjector::randomMouseMoves(int count)
+{
+    for(int idx = 0; idx < count; ++idx)
+    {
+        mouseMove(m_random.range(0, m_window->width() - 1), m_random.range(0, m_window->height() - 1));
+    }
+}
+
+int XHeadlessInputInjector::randomClicks(int count)
+{
+    int consumed = 0;
+
+    for(int idx = 0; idx < count; ++idx)
+    {
+        if(mouseClick(m_random.range(0, m_window->width() - 1), m_random.range(0, m_window->height() - 1))) consumed++;
+    }
+
+    return consumed;
+}
+
@@ -0,0 +1,170 @@
+// Headless item host: fake window, input injector and null/software painter
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWHEADLESS_H_
+#define _XWHEADLESS_H_
+
+// NOTE: item tree is made of real XGraphicsItem built against xwwinshim.h. Its
+//       Windows part (xgraphicsitemwin32.cpp) is replaced by xwheadlessitem.cpp,
+//       requests which item sends to parent window go to XHeadlessWindow set as
+//       item host instead. HDC passed to onPaintGDI is headless painter.
+
+#include "xwwinshim.h"
+
+#include "layout/xlayoutitem.h"
+#include "layout/xlayout.h"
+#include "layout/xlayoutsizesolver.h"
+#include "layout/xvboxlayout.h"
+#include "layout/xhboxlayout.h"
+#include "layout/xgridlayout.h"
+
+#include "xgraphicsitem/xgraphicsitem.h"
+#include "xgraphicsitem/interfaces/ixgraphicsitemhost.h"
+
+#include "xwtest.h"
+
+/////////////////////////////////////////////////////////////////////
+// XHeadlessPainter - null or software painter
+
+class XHeadlessPainter
+{
+public: // construction/destruction
+    XHeadlessPainter(int width, int height, bool software);
+    ~XHeadlessPainter();
+
+public: // painting device for onPaintGDI
+    HDC     hdc() { return reinterpret_cast<HDC>(this); }
+
+public: // painting
+    void    fillRect(const RECT& rect, COLORREF color);
+
+public: // properties
+    COLORREF        pixel(int posX, int posY) const;
+    bool            isSoftware() const  { return m_pixels.size() != 0; }
+
+public: // statistics
+    unsigned long       fills;
+    unsigned long long  filledArea;
+
+private: // data
+    int                     m_width;
+    int                     m_height;
+    std::vector<COLORREF>   m_pixels;
+};
+
+/////////////////////////////////////////////////////////////////////
+// XHeadlessItem - graphics item with test access and event counters
+
+class XHeadlessItem : public XGraphicsItem
+{
+public: // construction/destruction
+    XHeadlessItem(XGraphicsItem* parent = 0);
+    ~XHeadlessItem();
+
+public: // protected properties
+    void    setFocusable(bool focusable)    { XGraphicsItem::setFocusable(focusable); }
+
+public: // hit testing (child item at position)
+    XGraphicsItem*  findItem(int posX, int posY) { return _findItem(posX, posY); }
+
+public: // mouse events
+    void    onMouseEnter(int posX, int posY);
+
+public: // event counters
+    unsigned long   mouseEnters;
+    unsigned long   clicks;
+
+private: // event handlers
+    bool    _onClicked(unsigned long eventId, XWObject* source);
+};
+
+/////////////////////////////////////////////////////////////////////
+// XHeadlessWindow - fake window with scroll view over root item
+
+class XHeadlessWindow : public XWScrollViewLogic,
+                        public IXGraphicsItemHost
+{
+public: // construction/destruction
+    XHeadlessWindow(int width, int height);
+    ~XHeadlessWindow();
+
+public: // root item (window takes ownership)
+    void    setRootItem(XGraphicsItem* rootItem);
+    XGraphicsItem*  rootItem() const { return m_rootItem; }
+
+public: // size and layout pass
+    void    resize(int width, int height);
+    void    layout();
+    int     width() const   { return m_width; }
+    int     height() const  { return m_height; }
+
+public: // painting
+    void    paint(XHeadlessPainter& painter);
+    void    paint(XHeadlessPainter& painter, const RECT& rcPaint);
+
+public: // input (see XHeadlessInputInjector)
+    void    setFocus();
+    void    onMouseMove(int posX, int posY);
+    bool    onMouseClick(int posX, int posY);
+    void    onMouseWheel(int wheelDelta);
+    void    onTabKey();
+
+public: // state
+    XGraphicsItem*  mouseCaptureItem() const { return m_mouseCaptureItem; }
+    unsigned long   repaintRequests() const { return m_repaintRequests; }
+
+public: // mouse capture (from IXGraphicsItemHost)
+    void    setMouseCapture(XGraphicsItem* item);
+    void    resetMouseCapture();
+
+public: // painting (from IXGraphicsItemHost)
+    void    repaintRect(const RECT& rcPaint, bool paintNow);
+
+public: // layout (from IXGraphicsItemHost)
+    bool    requestLayout();
+
+protected: // worker methods (from XWScrollViewLogic)
+    void    updateScrollItem(int posX, int posY, int width, int height);
+    void    updateScrollBar(TScrollOrientation scrollOrient, int posX, int posY, int width, int height);
+    void    showScrollBar(TScrollOrientation scrollOrient, bool bShow);
+    bool    isScrollBarVisible(TScrollOrientation scrollOrient);
+    int     scrollBarWidth(TScrollOrientation scrollOrient);
+
+private: // worker methods
+    XGraphicsItem*  _mouseItem() const { return m_mouseCaptureItem ? m_mouseCaptureItem : m_rootItem; }
+
+private: // data
+    XGraphicsItem*  m_rootItem;
+    XGraphicsItem*  m_mouseCaptureItem;
+    int             m_width;
+    int             m_height;
+    bool            m_verticalScrollBar;
+    bool            m_layoutRequested;
+    unsigned long   m_repaintRequests;
+};
+
+/////////////////////////////////////////////////////////////////////
+// XHeadlessInputInjector - synthetic input
+
+class XHeadlessInputInjector
+{
+public: // construction/destruction
+    XHeadlessInputInjector(XHeadlessWindow* window, unsigned long long seed);
+
+public: // single events
+    void    mouseMove(int posX, int posY)   { m_window->onMouseMove(posX, posY); }
+    bool    mouseClick(int posX, int posY)  { return m_window->onMouseClick(posX, posY); }
+    void    mouseWheel(int wheelDelta)      { m_window->onMouseWheel(wheelDelta); }
+    void    tabKey()                        { m_window->onTabKey(); }
+
+public: // random streams
+    void    randomMouseMoves(int count);
+    int     randomClicks(int count);
+
+private: // data
+    XHeadlessWindow*    m_window;
+    XWTestRandom        m_random;
+};
+
+#endif // _XWHEADLESS_H_
@@ -0,0 +1,143 @@
+// Headless item tree benchmarks (layout, hit-test and paint traversal cost)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwheadless.h"
+
+// NOTE: tree is a scrolled form of rows, each row lays out fixed size leaves with
+//       horizontal box, rows are stacked by vertical box of root item. Window shows
+//       only part of content, so paint traversal skips rows outside dirty area.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_COLUMNS           10
+#define BENCH_WINDOW_WIDTH      800
+#define BENCH_WINDOW_HEIGHT     600
+#define BENCH_MOUSE_MOVES       2000000     // split by item count
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static XHeadlessItem* createTree(int rowCount, std::vector<XHeadlessItem*>& leavesOut)
+{
+    XHeadlessItem* root = new XHeadlessItem;
+    XVBoxLayout* rootLayout = new XVBoxLayout;
+    rootLayout->setSpacing(2);
+
+    for(int row = 0; row < rowCount; ++row)
+    {
+        XHeadlessItem* rowItem = new XHeadlessItem(root);
+        XHBoxLayout* rowLayout = new XHBoxLayout;
+        rowLayout->setSpacing(2);
+
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            XHeadlessItem* leaf = new XHeadlessItem(rowItem);
+            leaf->setMinWidth(40);
+            leaf->setMinHeight(20);
+            leaf->setBackgroundFill(0x100 + column);
+
+            rowLayout->addItem(leaf, 1);
+            leavesOut.push_back(leaf);
+        }
+
+        rowItem->setLayout(rowLayout);
+        rowItem->setBackgroundFill(0x80);
+        rootLayout->addItem(rowItem);
+    }
+
+    root->setLayout(rootLayout);
+    root->setBackgroundFill(1);
+
+    return root;
+}
+
+/////////////////////////////////////////////////////////////////////
+// benchmarks
+
+static void benchTree(int rowCount)
+{
+    XWTestTimer timer;
+
+    // build
+    std::vector<XHeadlessItem*> leaves;
+    XHeadlessWindow window(BENCH_WINDOW_WIDTH, BENCH_WINDOW_HEIGHT);
+    window.setRootItem(createTree(rowCount, leaves));
+
+    long long buildUs = timer.elapsedUs();
+    int itemCount = 1 + rowCount + (int)leaves.size();
+    int repeats = std::max(1, 200000 / itemCount);
+    int mouseMoves = std::max(1000, BENCH_MOUSE_MOVES / itemCount);
+
+    // full layout pass on window resize
+    timer.restart();
+    for(int idx = 0; idx < repeats; ++idx)
+    {
+        window.resize(BENCH_WINDOW_WIDTH + (idx % 100), BENCH_WINDOW_HEIGHT);
+    }
+    double resizeUs = (double)timer.elapsedUs() / repeats;
+
+    // layout pass after constraint change of one leaf
+    timer.restart();
+    for(int idx = 0; idx < repeats; ++idx)
+    {
+        leaves[(idx * 7919) % leaves.size()]->setMinWidth(40 + (idx % 2));
+        window.layout();
+    }
+    double relayoutUs = (double)timer.elapsedUs() / repeats;
+
+    // hit-test with synthetic mouse moves
+    XHeadlessInputInjector injector(&window, rowCount);
+    timer.restart();
+    injector.randomMouseMoves(mouseMoves);
+    double moveNs = (double)timer.elapsedUs() * 1000.0 / mouseMoves;
+
+    // paint traversal of window area (null painter)
+    XHeadlessPainter nullPainter(BENCH_WINDOW_WIDTH, BENCH_WINDOW_HEIGHT, false);
+    timer.restart();
+    for(int idx = 0; idx < repeats; ++idx)
+    {
+        window.paint(nullPainter);
+    }
+    double paintUs = (double)timer.elapsedUs() / repeats;
+    unsigned long fillsPerPaint = nullPainter.fills / repeats;
+
+    // paint traversal of small dirty rectangle
+    RECT rcDirty = {100, 100, 132, 132};
+    timer.restart();
+    for(int idx = 0; idx < repeats; ++idx)
+    {
+        window.paint(nullPainter, rcDirty);
+    }
+    double dirtyPaintUs = (double)timer.elapsedUs() / repeats;
+
+    // software painter (pixels are filled)
+    XHeadlessPainter softwarePainter(BENCH_WINDOW_WIDTH, BENCH_WINDOW_HEIGHT, true);
+    int softwareRepeats = std::max(1, repeats / 10);
+    timer.restart();
+    for(int idx = 0; idx < softwareRepeats; ++idx)
+    {
+        window.paint(softwarePainter);
+    }
+    double softwarePaintUs = (double)timer.elapsedUs() / softwareRepeats;
+
+    printf("%6d items: build %7lld us, resize %8.1f us, relayout %8.1f us, mouse move %6.0f ns, "
+           "paint %6.1f us (%lu fills), dirty paint %5.2f us, software paint %7.1f us\n",
+           itemCount, buildUs, resizeUs, relayoutUs, moveNs,
+           paintUs, fillsPerPaint, dirtyPaintUs, softwarePaintUs);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    benchTree(10);
+    benchTree(100);
+    benchTree(1000);
+    benchTree(10000);
+
+    return 0;
+}
+
@@ -0,0 +1,296 @@
+// Headless item host tests (layout, hit-testing, z-order, focus, scrolling, painting)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwheadless.h"
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define TEST_ROWS           20
+#define TEST_COLUMNS        5
+#define TEST_ITEM_WIDTH     40
+#define TEST_ITEM_HEIGHT    20
+#define TEST_SPACING        4
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+// form with rows of fixed size items, leaves are returned in row order
+static XHeadlessItem* createForm(std::vector<XHeadlessItem*>& leavesOut)
+{
+    XHeadlessItem* root = new XHeadlessItem;
+    XVBoxLayout* rootLayout = new XVBoxLayout;
+    rootLayout->setSpacing(TEST_SPACING);
+
+    for(int row = 0; row < TEST_ROWS; ++row)
+    {
+        XHeadlessItem* rowItem = new XHeadlessItem(root);
+        XHBoxLayout* rowLayout = new XHBoxLayout;
+        rowLayout->setSpacing(TEST_SPACING);
+
+        for(int column = 0; column < TEST_COLUMNS; ++column)
+        {
+            XHeadlessItem* leaf = new XHeadlessItem(rowItem);
+            leaf->setFixedSize(TEST_ITEM_WIDTH, TEST_ITEM_HEIGHT);
+            leaf->setBackgroundFill(0x100 + row * TEST_COLUMNS + column);
+            leaf->setFocusable(true);
+
+            rowLayout->addItem(leaf);
+            leavesOut.push_back(leaf);
+        }
+
+        rowItem->setLayout(rowLayout);
+        rootLayout->addItem(rowItem);
+    }
+
+    root->setLayout(rootLayout);
+    root->setBackgroundFill(1);
+
+    return root;
+}
+
+// deepest visible item at position
+static XGraphicsItem* itemAt(XGraphicsItem* root, int posX, int posY)
+{
+    XHeadlessItem* item = static_cast<XHeadlessItem*>(root);
+
+    for(XGraphicsItem* child = item->findItem(posX, posY); child; child = item->findItem(posX, posY))
+    {
+        item = static_cast<XHeadlessItem*>(child);
+    }
+
+    return item;
+}
+
+static int centerX(XGraphicsItem* item) { return (item->rect().left + item->rect().right) / 2; }
+static int centerY(XGraphicsItem* item) { return (item->rect().top + item->rect().bottom) / 2; }
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testLayoutAndHitTest()
+{
+    std::vector<XHeadlessItem*> leaves;
+    XHeadlessWindow window(400, 2000);
+    window.setRootItem(createForm(leaves));
+
+    // leaves keep fixed size, rows are stacked with spacing
+    for(int idx = 0; idx < (int)leaves.size(); ++idx)
+    {
+        XWTEST_CHECK(leaves[idx]->width() == TEST_ITEM_WIDTH && leaves[idx]->height() == TEST_ITEM_HEIGHT);
+
+        const RECT rect = leaves[idx]->rect();
+
+        if(idx % TEST_COLUMNS)
+            XWTEST_CHECK(rect.left == leaves[idx - 1]->rect().right + TEST_SPACING);
+        if(idx >= TEST_COLUMNS)
+            XWTEST_CHECK(rect.top == leaves[idx - TEST_COLUMNS]->rect().bottom + TEST_SPACING);
+
+        // hit-test finds leaf at its center
+        XWTEST_CHECK(itemAt(window.rootItem(), centerX(leaves[idx]), centerY(leaves[idx])) == leaves[idx]);
+    }
+
+    // spacing belongs to parent (right edge is still inside item)
+    XWTEST_CHECK(itemAt(window.rootItem(), leaves[0]->rect().right, centerY(leaves[0])) == leaves[0]);
+    XGraphicsItem* gapItem = itemAt(window.rootItem(), leaves[0]->rect().right + 1, centerY(leaves[0]));
+    XWTEST_CHECK(gapItem == leaves[0]->parentItem());
+
+    // constraint change is picked by next layout pass
+    leaves[0]->setFixedSize(TEST_ITEM_WIDTH * 2, TEST_ITEM_HEIGHT);
+    window.layout();
+    XWTEST_CHECK(leaves[0]->width() == TEST_ITEM_WIDTH * 2);
+    XWTEST_CHECK(leaves[1]->rect().left == leaves[0]->rect().right + TEST_SPACING);
+    XWTEST_CHECK(window.rootItem()->minWidth() == (TEST_COLUMNS + 1) * TEST_ITEM_WIDTH + (TEST_COLUMNS - 1) * TEST_SPACING);
+
+    // hidden item is skipped by layout and hit-testing
+    leaves[1]->setVisible(false);
+    window.layout();
+    XWTEST_CHECK(leaves[2]->rect().left == leaves[0]->rect().right + TEST_SPACING);
+    XWTEST_CHECK(itemAt(window.rootItem(), centerX(leaves[2]), centerY(leaves[2])) == leaves[2]);
+}
+
+static void testZOrder()
+{
+    XHeadlessWindow window(100, 100);
+    XHeadlessItem* root = new XHeadlessItem;
+    window.setRootItem(root);
+
+    // overlapping items without layout, last added is on top
+    XHeadlessItem* bottom = new XHeadlessItem(root);
+    XHeadlessItem* top = new XHeadlessItem(root);
+    bottom->update(0, 0, 60, 60);
+    bottom->setBackgroundFill(2);
+    top->update(40, 40, 60, 60);
+    top->setBackgroundFill(3);
+
+    XWTEST_CHECK(root->findItem(50, 50) == top);
+
+    XHeadlessPainter painter(100, 100, true);
+    window.paint(painter);
+    XWTEST_CHECK(painter.pixel(50, 50) == 3);
+
+    // bottom item moved on top
+    root->moveItemOnTop(bottom);
+    XWTEST_CHECK(root->findItem(50, 50) == bottom);
+
+    window.paint(painter);
+    XWTEST_CHECK(painter.pixel(50, 50) == 2);
+    XWTEST_CHECK(painter.pixel(90, 90) == 3);
+}
+
+static void testInput()
+{
+    std::vector<XHeadlessItem*> leaves;
+    XHeadlessWindow window(400, 2000);
+    window.setRootItem(createForm(leaves));
+    XHeadlessInputInjector injector(&window, 1);
+
+    // mouse moved over all leaves enters each once
+    for(size_t idx = 0; idx < leaves.size(); ++idx)
+    {
+        injector.mouseMove(centerX(leaves[idx]), centerY(leaves[idx]));
+        injector.mouseMove(centerX(leaves[idx]) + 1, centerY(leaves[idx]));
+    }
+
+    for(size_t idx = 0; idx < leaves.size(); ++idx)
+    {
+        XWTEST_CHECK(leaves[idx]->mouseEnters == 1);
+    }
+
+    // click focuses leaf, previous focus is reset (not clickable leaf doesn't consume it)
+    XWTEST_CHECK(!injector.mouseClick(centerX(leaves[0]), centerY(leaves[0])));
+    XWTEST_CHECK(!injector.mouseClick(centerX(leaves[1]), centerY(leaves[1])));
+    XWTEST_CHECK(!leaves[0]->hasFocus() && leaves[1]->hasFocus());
+    XWTEST_CHECK(leaves[1]->parentItem()->hasFocus() && !leaves[TEST_COLUMNS]->parentItem()->hasFocus());
+    XWTEST_CHECK(!injector.mouseClick(0, 1999));
+
+    // clickable item consumes click, mouse is captured while pressed
+    leaves[2]->setClickable(true);
+    XWTEST_CHECK(injector.mouseClick(centerX(leaves[2]), centerY(leaves[2])));
+    XWTEST_CHECK(leaves[2]->clicks == 1 && leaves[1]->clicks == 0);
+    XWTEST_CHECK(window.mouseCaptureItem() == 0);
+
+    // tab moves focus to previous focusable item in z-order and wraps around
+    window.setFocus();
+    injector.tabKey();
+    XWTEST_CHECK(leaves[0]->hasFocus() && !leaves[1]->hasFocus());
+    injector.tabKey();
+    XWTEST_CHECK(leaves[TEST_COLUMNS - 1]->hasFocus() && !leaves[0]->hasFocus());
+}
+
+static void testScrolling()
+{
+    std::vector<XHeadlessItem*> leaves;
+    XHeadlessWindow window(400, 100);
+    window.setRootItem(createForm(leaves));
+
+    // content is taller than window, scroll view logic shows scrollbar
+    XWTEST_CHECK(window.rootItem()->width() == 400 - 12);
+    XWTEST_CHECK(window.rootItem()->contentHeight() > 100);
+
+    int topBefore = leaves[0]->rect().top;
+    unsigned long repaintsBefore = window.repaintRequests();
+
+    // wheel down moves content up (half of delta by default), item asks host to repaint
+    window.onMouseWheel(-120);
+    XWTEST_CHECK(window.repaintRequests() > repaintsBefore);
+    XWTEST_CHECK(window.rootItem()->scrollOffsetY() == 60);
+    XWTEST_CHECK(leaves[0]->rect().top == topBefore - 60);
+
+    // offset is limited by content size
+    for(int idx = 0; idx < 100; ++idx) window.onMouseWheel(-120);
+    XWTEST_CHECK(window.rootItem()->scrollOffsetY() == window.rootItem()->contentHeight() - 100);
+
+    // window made large enough hides scrollbar
+    window.onMouseWheel(100000);
+    window.resize(400, 2000);
+    XWTEST_CHECK(window.rootItem()->width() == 400);
+}
+
+static void testPainting()
+{
+    std::vector<XHeadlessItem*> leaves;
+    XHeadlessWindow window(400, 200);
+    window.setRootItem(createForm(leaves));
+
+    // software painter shows leaves inside window only
+    XHeadlessPainter painter(400, 200, true);
+    window.paint(painter);
+
+    for(size_t idx = 0; idx < leaves.size(); ++idx)
+    {
+        if(centerY(leaves[idx]) >= 200) continue;
+        XWTEST_CHECK(painter.pixel(centerX(leaves[idx]), centerY(leaves[idx])) == 0x100 + idx);
+    }
+
+    // null painter visits only items overlapping dirty rectangle
+    XHeadlessPainter nullPainter(400, 200, false);
+    RECT rcPaint = {centerX(leaves[0]), centerY(leaves[0]), centerX(leaves[0]) + 1, centerY(leaves[0]) + 1};
+    window.paint(nullPainter, rcPaint);
+    XWTEST_CHECK(nullPainter.fills == 2);
+    XWTEST_CHECK(nullPainter.filledArea == 2);
+}
+
+static void testPooledTeardown()
+{
+    XWObjectPool* pool = new XWObjectPool;
+    XWObjectPool::XPoolStats stats;
+    std::vector<XHeadlessItem*> leaves;
+    XHeadlessWindow window(400, 2000);
+
+    // form, its layouts and bookkeeping nodes are allocated from pool
+    {
+        XWObjectPoolScope scope(pool);
+        window.setRootItem(createForm(leaves));
+    }
+
+    XHeadlessItem* root = static_cast<XHeadlessItem*>(window.rootItem());
+    pool->getStats(stats);
+    unsigned long formBlocks = stats.blocksInUse;
+    XWTEST_CHECK(formBlocks > leaves.size());
+
+    // focus and mouse item are reset by bulk delete
+    window.setFocus();
+    window.onMouseMove(centerX(leaves[0]), centerY(leaves[0]));
+    root->deleteAllChildItems();
+
+    XWTEST_CHECK(root->findItem(centerX(leaves[0]), centerY(leaves[0])) == 0);
+    XWTEST_CHECK(root->layout()->layoutItemCount() == 0);
+    pool->getStats(stats);
+    XWTEST_CHECK(stats.blocksInUse < formBlocks / 10);
+
+    // item is usable after bulk delete
+    XHeadlessItem* child = new XHeadlessItem(root);
+    child->setFixedSize(TEST_ITEM_WIDTH, TEST_ITEM_HEIGHT);
+    child->setBackgroundFill(5);
+    static_cast<XVBoxLayout*>(root->layout())->addItem(child);
+    window.layout();
+
+    XHeadlessPainter painter(400, 200, true);
+    window.paint(painter);
+    XWTEST_CHECK(root->findItem(centerX(child), centerY(child)) == child);
+    XWTEST_CHECK(painter.pixel(centerX(child), centerY(child)) == 5);
+    XWTEST_CHECK(painter.pixel(centerX(child), child->rect().bottom + 10) == 1);
+
+    window.onTabKey();
+
+    // NOTE: pool is released before items, it is deleted with window root item
+    pool->release();
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    testLayoutAndHitTest();
+    testZOrder();
+    testInput();
+    testScrolling();
+    testPainting();
+    testPooledTeardown();
+
+    return xwtestResult("xwheadless_test");
+}
+
@@ -0,0 +1,161 @@
+// Headless part of graphics item (replaces xgraphicsitemwin32.cpp)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwheadless.h"
+
+// NOTE: items are hosted by XHeadlessWindow, so window methods are never used and
+//       there are no window messages, timers, animations or content loading. GDI
+//       and Direct2D resource caches are not created, headless painter needs none.
+
+/////////////////////////////////////////////////////////////////////
+// platform functions used by graphics item (see xwwinshim.h)
+/////////////////////////////////////////////////////////////////////
+XWUIGraphicsPainter sXWUIDefaultPainter()
+{
+    // headless painter is GDI painter
+    return XWUI_PAINTER_GDI;
+}
+
+bool XWUtils::rectIsInside(const RECT& rect, int posX, int posY)
+{
+    // same as xwutils.cpp (right and bottom edges are inside)
+    return (posX >= rect.left && posX <= rect.right) &&
+           (posY >= rect.top && posY <= rect.bottom);
+}
+
+bool XWUtils::rectOverlap(const RECT& rect1, const RECT& rect2)
+{
+    // same as xwutils.cpp
+    return (rect1.left <= rect2.right && rect1.right >= rect2.left &&
+            rect1.top <= rect2.bottom && rect1.bottom >= rect2.top);
+}
+
+bool XWUtils::rectIntersect(const RECT& rect1, const RECT& rect2, RECT& rectOut)
+{
+    return (::IntersectRect(&rectOut, &rect1, &rect2) != 0);
+}
+
+void XGdiHelpers::fillRect(HDC hdc, const RECT& rcPaint, COLORREF fillColor)
+{
+    // NOTE: headless painting device is painter itself
+    reinterpret_cast<XHeadlessPainter*>(hdc)->fillRect(rcPaint, fillColor);
+}
+
+/////////////////////////////////////////////////////////////////////
+// XGraphicsItem - graphics item (headless part)
+
+/////////////////////////////////////////////////////////////////////
+// message processing
+/////////////////////////////////////////////////////////////////////
+LRESULT XGraphicsItem::processWindowMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, bool& messageProcessed)
+{
+    messageProcessed = false;
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// GDI resource caching
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::onInitGDIResources(HDC hdc)
+{
+}
+
+void XGraphicsItem::onResetGDIResources()
+{
+}
+
+void XGraphicsItem::setGDIResourcesCache(XGdiResourcesCache* pXGdiResourcesCache)
+{
+    XWASSERT(pXGdiResourcesCache == 0);
+}
+
+/////////////////////////////////////////////////////////////////////
+// Direct2D painting
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::onPaintD2D(ID2D1RenderTarget* pTarget, const RECT& rcPaint)
+{
+}
+
+/////////////////////////////////////////////////////////////////////
+// Direct2D resource caching
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::onInitD2DTarget(ID2D1RenderTarget* pTarget)
+{
+}
+
+void XGraphicsItem::onResetD2DTarget()
+{
+}
+
+void XGraphicsItem::setD2DResourcesCache(XD2DResourcesCache* pXD2DResourcesCache)
+{
+    XWASSERT(pXD2DResourcesCache == 0);
+}
+
+/////////////////////////////////////////////////////////////////////
+// animation methods
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::pauseAnimations()
+{
+}
+
+void XGraphicsItem::resumeAnimations()
+{
+}
+
+void XGraphicsItem::stopAllAnimations()
+{
+    m_itemAnimations.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// content loading
+/////////////////////////////////////////////////////////////////////
+void XGraphicsItem::cancelAllContent()
+{
+    m_itemContentIds.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+// window methods (not used if item host is set)
+/////////////////////////////////////////////////////////////////////
+LRESULT XGraphicsItem::_sendWindowMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+    return 0;
+}
+
+bool XGraphicsItem::_postWindowMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+    return false;
+}
+
+void XGraphicsItem::_repaintWindow(const RECT& rcPaint, bool paintNow)
+{
+}
+
+bool XGraphicsItem::_setWindowTimer(UINT uElapseMs)
+{
+    return false;
+}
+
+bool XGraphicsItem::_killWindowTimer()
+{
+    return false;
+}
+
+HCURSOR XGraphicsItem::_setSystemCursor(HCURSOR cursor)
+{
+    return 0;
+}
+
+void XGraphicsItem::_initChildResources(XGraphicsItem* childItem)
+{
+}
+
+void XGraphicsItem::_releaseResourceCaches()
+{
+}
+
+// XGraphicsItem
+/////////////////////////////////////////////////////////////////////
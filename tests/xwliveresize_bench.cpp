@@ -0,0 +1,141 @@
+// Live resize benchmarks (splitter drag with and without frame throttle and snapshot)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwheadless.h"
+
+// NOTE: pane is headless window with the same form of rows as in xwheadless_bench.cpp,
+//       splitter is dragged for one second with mouse moves at 1 kHz. Pane is resized
+//       and laid out on each move (no throttle), on each drag frame (snapshot fallback)
+//       or once when drag ends (snapshot shown, scaling it is done by GDI and is not
+//       measured here). Frame cost shows if pane keeps up with 60 fps.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_COLUMNS           10
+#define BENCH_PANE_WIDTH        800
+#define BENCH_PANE_HEIGHT       600
+#define BENCH_DRAG_MS           1000
+#define BENCH_FRAME_MS          16
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static XHeadlessItem* createTree(int rowCount)
+{
+    XHeadlessItem* root = new XHeadlessItem;
+    XVBoxLayout* rootLayout = new XVBoxLayout;
+    rootLayout->setSpacing(2);
+
+    for(int row = 0; row < rowCount; ++row)
+    {
+        XHeadlessItem* rowItem = new XHeadlessItem(root);
+        XHBoxLayout* rowLayout = new XHBoxLayout;
+        rowLayout->setSpacing(2);
+
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            XHeadlessItem* leaf = new XHeadlessItem(rowItem);
+            leaf->setMinWidth(20);
+            leaf->setMinHeight(20);
+
+            rowLayout->addItem(leaf, 1);
+        }
+
+        rowItem->setLayout(rowLayout);
+        rootLayout->addItem(rowItem);
+    }
+
+    root->setLayout(rootLayout);
+
+    return root;
+}
+
+/////////////////////////////////////////////////////////////////////
+// benchmarks
+
+enum TBenchMode
+{
+    BENCH_EVERY_MOVE,
+    BENCH_THROTTLED,
+    BENCH_SNAPSHOT
+};
+
+static void benchDrag(int rowCount, TBenchMode mode)
+{
+    static const char* modeNames[] = {"every move", "throttled", "snapshot"};
+
+    XHeadlessWindow window(BENCH_PANE_WIDTH, BENCH_PANE_HEIGHT);
+    window.setRootItem(createTree(rowCount));
+    window.layout();
+
+    XWFrameThrottle throttle(BENCH_FRAME_MS);
+    XWLiveResizeState liveResize;
+
+    int layouts = 0;
+    long long workUs = 0;
+    long long maxFrameUs = 0;
+
+    // start drag (pane shows snapshot in snapshot mode)
+    throttle.begin(BENCH_PANE_WIDTH, 0);
+    liveResize.begin(mode == BENCH_SNAPSHOT);
+
+    for(int timeMs = 1; timeMs <= BENCH_DRAG_MS; ++timeMs)
+    {
+        // pane width follows mouse (one pixel per move)
+        int paneWidth = BENCH_PANE_WIDTH - timeMs / 4;
+
+        // check if pane is resized now
+        int applyWidth = paneWidth;
+        if(mode != BENCH_EVERY_MOVE && !throttle.update(paneWidth, timeMs, applyWidth)) continue;
+
+        // resize pane (content layout is delayed if snapshot is shown)
+        XWTestTimer timer;
+        if(!liveResize.deferResize())
+        {
+            window.resize(applyWidth, BENCH_PANE_HEIGHT);
+            layouts++;
+        }
+
+        long long frameUs = timer.elapsedUs();
+        workUs += frameUs;
+        if(frameUs > maxFrameUs) maxFrameUs = frameUs;
+    }
+
+    // end drag, pane gets final size
+    int finalWidth = 0;
+    bool resizeNeeded = throttle.end(finalWidth);
+
+    XWTestTimer timer;
+    if(liveResize.end() || (resizeNeeded && mode != BENCH_SNAPSHOT))
+    {
+        window.resize(finalWidth, BENCH_PANE_HEIGHT);
+        layouts++;
+    }
+    long long endUs = timer.elapsedUs();
+
+    XWTEST_CHECK(window.width() == BENCH_PANE_WIDTH - BENCH_DRAG_MS / 4);
+
+    // NOTE: pane keeps up with 60 fps if slowest frame fits frame interval
+    double frameBudget = 100.0 * maxFrameUs / (BENCH_FRAME_MS * 1000.0);
+    printf("%6d items, %-10s: layouts %5d, work %7lld us/s, max frame %6lld us (%5.1f%% of frame), end %6lld us\n",
+           1 + rowCount * (1 + BENCH_COLUMNS), modeNames[mode], layouts, workUs, maxFrameUs, frameBudget, endUs);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    int rowCounts[] = {10, 100, 500, 2000};
+
+    for(size_t idx = 0; idx < sizeof(rowCounts) / sizeof(rowCounts[0]); ++idx)
+    {
+        benchDrag(rowCounts[idx], BENCH_EVERY_MOVE);
+        benchDrag(rowCounts[idx], BENCH_THROTTLED);
+        benchDrag(rowCounts[idx], BENCH_SNAPSHOT);
+    }
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+// Live resize tests (frame throttle rate and snapshot fallback)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "xwtest.h"
+
+// NOTE: clock is simulated in milliseconds. Mouse moves come at 1 kHz (fast mouse),
+//       drag frame timer ticks with system timer resolution (15.625 ms), same as
+//       splitter drag in XWSplitterWindow.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define TEST_FRAME_MS           16
+#define TEST_DRAG_MS            1000
+#define TEST_TIMER_TICK_US      15625
+#define TEST_START_MS           100000
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testThrottleFrameRate()
+{
+    XWFrameThrottle throttle(TEST_FRAME_MS);
+    throttle.begin(0, TEST_START_MS);
+
+    int appliedValue = 0;
+    int appliedFrames = 0;
+    long long lastFrameMs = -1;
+    long long minIntervalMs = TEST_DRAG_MS;
+    long long nextTickUs = TEST_TIMER_TICK_US;
+    bool increasing = true;
+
+    for(int timeMs = 1; timeMs <= TEST_DRAG_MS; ++timeMs)
+    {
+        long long nowMs = TEST_START_MS + timeMs;
+        int value = 0;
+
+        // mouse move (position follows time)
+        bool applied = throttle.update(timeMs, nowMs, value);
+
+        // frame timer
+        if(!applied && (long long)timeMs * 1000 >= nextTickUs)
+            applied = throttle.frame(nowMs, value);
+
+        while((long long)timeMs * 1000 >= nextTickUs) nextTickUs += TEST_TIMER_TICK_US;
+
+        if(!applied) continue;
+
+        // every applied value is new
+        if(value <= appliedValue) increasing = false;
+        appliedValue = value;
+        appliedFrames++;
+
+        if(lastFrameMs >= 0 && nowMs - lastFrameMs < minIntervalMs) minIntervalMs = nowMs - lastFrameMs;
+        lastFrameMs = nowMs;
+    }
+
+    // about 60 frames per second, not once per mouse move
+    XWTEST_CHECK(appliedFrames >= 55 && appliedFrames <= 70);
+    XWTEST_CHECK(minIntervalMs >= 12);
+    XWTEST_CHECK(increasing);
+    XWTEST_CHECK(throttle.updates() == TEST_DRAG_MS);
+    XWTEST_CHECK(throttle.frames() == (unsigned long)appliedFrames);
+
+    // last position is applied once drag ends
+    int value = 0;
+    if(appliedValue != TEST_DRAG_MS)
+    {
+        XWTEST_CHECK(throttle.end(value));
+        XWTEST_CHECK(value == TEST_DRAG_MS);
+
+    } else
+    {
+        XWTEST_CHECK(!throttle.end(value));
+    }
+
+    XWTEST_CHECK(!throttle.isActive());
+}
+
+static void testThrottleIdle()
+{
+    XWFrameThrottle throttle(TEST_FRAME_MS);
+    int value = 0;
+
+    // not active
+    XWTEST_CHECK(!throttle.update(10, TEST_START_MS, value));
+    XWTEST_CHECK(!throttle.frame(TEST_START_MS, value));
+
+    // first move is applied at once
+    throttle.begin(5, TEST_START_MS);
+    XWTEST_CHECK(throttle.update(6, TEST_START_MS, value) && value == 6);
+
+    // next moves wait for frame
+    XWTEST_CHECK(!throttle.update(7, TEST_START_MS + 1, value));
+    XWTEST_CHECK(!throttle.update(8, TEST_START_MS + 2, value));
+    XWTEST_CHECK(!throttle.frame(TEST_START_MS + 10, value));
+    XWTEST_CHECK(throttle.frame(TEST_START_MS + 13, value) && value == 8);
+
+    // timer tick without new position does nothing
+    XWTEST_CHECK(!throttle.frame(TEST_START_MS + 40, value));
+
+    // position back to applied one is not applied again
+    XWTEST_CHECK(!throttle.update(8, TEST_START_MS + 100, value));
+
+    // first move after idle frame is applied at once
+    XWTEST_CHECK(throttle.update(9, TEST_START_MS + 101, value) && value == 9);
+
+    // nothing left for end
+    XWTEST_CHECK(!throttle.end(value));
+    XWTEST_CHECK(throttle.frames() == 3);
+
+    // drag without moves
+    throttle.begin(20, TEST_START_MS + 200);
+    XWTEST_CHECK(!throttle.end(value));
+    XWTEST_CHECK(throttle.frames() == 0);
+}
+
+static void testSnapshotFallback()
+{
+    XWLiveResizeState state;
+
+    // snapshot could not be captured, window is resized as usual
+    XWTEST_CHECK(!state.begin(false));
+    XWTEST_CHECK(!state.isActive());
+    XWTEST_CHECK(!state.deferResize());
+    XWTEST_CHECK(!state.end());
+    XWTEST_CHECK(state.deferredResizes() == 0);
+
+    // snapshot is shown, resizes are coalesced until live resize ends
+    XWTEST_CHECK(state.begin(true));
+    XWTEST_CHECK(!state.begin(true));
+    for(int idx = 0; idx < 100; ++idx) XWTEST_CHECK(state.deferResize());
+    XWTEST_CHECK(state.deferredResizes() == 100);
+
+    XWTEST_CHECK(state.end());
+    XWTEST_CHECK(!state.isActive());
+    XWTEST_CHECK(!state.end());
+    XWTEST_CHECK(!state.deferResize());
+
+    // no resize while snapshot was shown
+    XWTEST_CHECK(state.begin(true));
+    XWTEST_CHECK(!state.end());
+
+    // window closed while snapshot is shown
+    XWTEST_CHECK(state.begin(true));
+    XWTEST_CHECK(state.deferResize());
+    state.reset();
+    XWTEST_CHECK(!state.isActive());
+    XWTEST_CHECK(!state.end());
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    testThrottleFrameRate();
+    testThrottleIdle();
+    testSnapshotFallback();
+
+    return xwtestResult("xwliveresize_test");
+}
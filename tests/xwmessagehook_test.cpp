@@ -0,0 +1,433 @@
+// Message hook tests (filters, hook lists by message, changes while dispatching)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwwinshim.h"
+
+#include "core/xwmessagehook.h"
+
+#include "xwtest.h"
+
+// NOTE: hooks record calls to shared log, dispatch result is compared with plain
+//       scan of registered hooks (last added first, stop at consumed message).
+//       Registry must be freed with last hook, this is checked with heap counter
+//       from xwtestheap.cpp.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define TEST_RANDOM_SETS        300
+#define TEST_MAX_MESSAGE        0x300
+
+/////////////////////////////////////////////////////////////////////
+// test hook
+
+static std::vector<unsigned long> g_hookCalls;
+
+class XTestHook : public IXWMessageHook
+{
+public: // construction/destruction
+    XTestHook(unsigned long id) : hookId(id), action(eActionNone), target(0), targetHook(0), nestedMessage(0) {}
+
+public: // IXWMessageHook
+    bool processHookMessage(MSG* pmsg)
+    {
+        g_hookCalls.push_back(hookId);
+
+        switch(action)
+        {
+        case eActionConsume:
+            return true;
+
+        case eActionRemoveHook:
+            sXWUIRemoveMessageHook(target);
+            break;
+
+        case eActionAddHook:
+            sXWUIAddMessageHook(targetHook);
+            break;
+
+        case eActionNested:
+            {
+                // dispatch once, nested hook calls must not repeat it
+                TAction nestedAction = action;
+                action = eActionNone;
+
+                MSG msg = *pmsg;
+                msg.message = nestedMessage;
+                sXWUIProcessMessageHooks(&msg);
+
+                action = nestedAction;
+            }
+            break;
+
+        case eActionClear:
+            sXWUIClearMessageHooks();
+            break;
+
+        default:
+            break;
+        }
+
+        return false;
+    }
+
+    unsigned long messageHookId() const { return hookId; }
+
+public: // actions
+    enum TAction
+    {
+        eActionNone,
+        eActionConsume,
+        eActionRemoveHook,      // remove hook with target id
+        eActionAddHook,         // add target hook for all messages
+        eActionNested,          // dispatch nested message
+        eActionClear            // clear all hooks
+    };
+
+public: // data
+    unsigned long   hookId;
+    TAction         action;
+    unsigned long   target;
+    XTestHook*      targetHook;
+    UINT            nestedMessage;
+};
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static bool testDispatch(UINT message)
+{
+    MSG msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.message = message;
+
+    g_hookCalls.clear();
+    return sXWUIProcessMessageHooks(&msg);
+}
+
+static bool testCalls(unsigned long first, unsigned long second = 0, unsigned long third = 0)
+{
+    std::vector<unsigned long> expected;
+    if(first) expected.push_back(first);
+    if(second) expected.push_back(second);
+    if(third) expected.push_back(third);
+
+    return g_hookCalls == expected;
+}
+
+static unsigned long testInvocations(UINT message)
+{
+    std::vector<XWMessageHookStats> stats;
+    sXWUIGetMessageHookStats(stats);
+
+    for(size_t idx = 0; idx < stats.size(); ++idx)
+    {
+        if(stats[idx].message == message) return stats[idx].invocations;
+    }
+
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testFilter()
+{
+    XWMessageHookFilter filter;
+    XWTEST_CHECK(!filter.isAllMessages());
+    XWTEST_CHECK(!filter.hasMessage(0));
+
+    // range includes both ends
+    filter.addRange(0x100, 0x10F);
+    filter.addMessage(0x20);
+    XWTEST_CHECK(!filter.hasMessage(0xFF));
+    XWTEST_CHECK(filter.hasMessage(0x100));
+    XWTEST_CHECK(filter.hasMessage(0x10F));
+    XWTEST_CHECK(!filter.hasMessage(0x110));
+    XWTEST_CHECK(filter.hasMessage(0x20));
+    XWTEST_CHECK(!filter.hasMessage(0x21));
+
+    // ranges above 0xFFFF are clamped or ignored
+    filter.addRange(0xFFF0, 0x1FFFF);
+    filter.addRange(0x10000, 0x10005);
+    XWTEST_CHECK(filter.ranges().size() == 3);
+    XWTEST_CHECK(filter.ranges()[2].lastMessage == 0xFFFF);
+    XWTEST_CHECK(filter.hasMessage(0xFFFF));
+    XWTEST_CHECK(!filter.hasMessage(0x10000));
+
+    filter.setAllMessages();
+    XWTEST_CHECK(filter.hasMessage(0x10000));
+
+    XWMessageHookFilter single(0x200, 0x200);
+    XWTEST_CHECK(single.hasMessage(0x200));
+    XWTEST_CHECK(!single.hasMessage(0x201));
+}
+
+static void testHookLists()
+{
+    XTestHook hook1(1);
+    XTestHook hook2(2);
+    XTestHook hook3(3);
+
+    // overlapping ranges, hook for all messages added last
+    sXWUIAddMessageHook(&hook1, XWMessageHookFilter(0x100, 0x10F));
+    sXWUIAddMessageHook(&hook2, XWMessageHookFilter(0x108, 0x200));
+    sXWUIAddMessageHook(&hook3);
+
+    // segment boundaries, last added hook first
+    testDispatch(0xFF);     XWTEST_CHECK(testCalls(3));
+    testDispatch(0x100);    XWTEST_CHECK(testCalls(3, 1));
+    testDispatch(0x107);    XWTEST_CHECK(testCalls(3, 1));
+    testDispatch(0x108);    XWTEST_CHECK(testCalls(3, 2, 1));
+    testDispatch(0x10F);    XWTEST_CHECK(testCalls(3, 2, 1));
+    testDispatch(0x110);    XWTEST_CHECK(testCalls(3, 2));
+    testDispatch(0x200);    XWTEST_CHECK(testCalls(3, 2));
+    testDispatch(0x201);    XWTEST_CHECK(testCalls(3));
+
+    // messages above table and reserved messages get default list
+    testDispatch(0xFFFF);   XWTEST_CHECK(testCalls(3));
+    testDispatch(0x10000);  XWTEST_CHECK(testCalls(3));
+
+    // consumed message stops other hooks
+    hook2.action = XTestHook::eActionConsume;
+    XWTEST_CHECK(testDispatch(0x108));
+    XWTEST_CHECK(testCalls(3, 2));
+    XWTEST_CHECK(!testDispatch(0x100));
+
+    // adding hook again moves it to front
+    sXWUIAddMessageHook(&hook1, XWMessageHookFilter(0x100, 0x10F));
+    testDispatch(0x108);
+    XWTEST_CHECK(testCalls(1, 3, 2));
+
+    sXWUIClearMessageHooks();
+    XWTEST_CHECK(!testDispatch(0x108));
+    XWTEST_CHECK(g_hookCalls.empty());
+}
+
+static void testDefaultList()
+{
+    XTestHook hook1(1);
+    XTestHook hook2(2);
+
+    // only filtered hooks, messages between ranges have no hooks
+    XWMessageHookFilter filter;
+    filter.addRange(0x10, 0x1F);
+    filter.addRange(0x30, 0x3F);
+    sXWUIAddMessageHook(&hook1, filter);
+
+    XWTEST_CHECK(!testDispatch(0x25));
+    XWTEST_CHECK(g_hookCalls.empty());
+    testDispatch(0x30);
+    XWTEST_CHECK(testCalls(1));
+
+    // hook for all messages, default list is used for gaps between ranges too
+    sXWUIAddMessageHook(&hook2);
+    testDispatch(0x25);     XWTEST_CHECK(testCalls(2));
+    testDispatch(0x1F);     XWTEST_CHECK(testCalls(2, 1));
+    testDispatch(0x40);     XWTEST_CHECK(testCalls(2));
+    testDispatch(0x00);     XWTEST_CHECK(testCalls(2));
+
+    // statistics count hook calls
+    sXWUIResetMessageHookStats();
+    testDispatch(0x1F);
+    testDispatch(0x1F);
+    testDispatch(0x25);
+    XWTEST_CHECK(testInvocations(0x1F) == 4);
+    XWTEST_CHECK(testInvocations(0x25) == 1);
+    XWTEST_CHECK(testInvocations(0x26) == 0);
+
+    sXWUIClearMessageHooks();
+}
+
+static void testRandomFilters()
+{
+    int failures = 0;
+
+    for(int setIdx = 0; setIdx < TEST_RANDOM_SETS; ++setIdx)
+    {
+        XWTestRandom random(setIdx + 1);
+
+        int hookCount = random.range(1, 8);
+        std::vector<XTestHook> hooks;
+        std::vector<XWMessageHookFilter> filters(hookCount);
+
+        for(int idx = 0; idx < hookCount; ++idx)
+        {
+            hooks.push_back(XTestHook(idx + 1));
+            if(random.chance(10)) hooks.back().action = XTestHook::eActionConsume;
+
+            if(random.chance(20))
+            {
+                filters[idx].setAllMessages();
+                continue;
+            }
+
+            int rangeCount = random.range(1, 4);
+            for(int rangeIdx = 0; rangeIdx < rangeCount; ++rangeIdx)
+            {
+                UINT first = random.range(0, TEST_MAX_MESSAGE);
+                filters[idx].addRange(first, first + random.range(0, 40));
+            }
+        }
+
+        for(int idx = 0; idx < hookCount; ++idx)
+        {
+            sXWUIAddMessageHook(&hooks[idx], filters[idx]);
+        }
+
+        // plain scan of filters for every message
+        bool valid = true;
+        for(UINT message = 0; message <= TEST_MAX_MESSAGE + 50 && valid; ++message)
+        {
+            std::vector<unsigned long> expected;
+            bool expectedConsumed = false;
+            for(int idx = hookCount - 1; idx >= 0; --idx)
+            {
+                if(!filters[idx].hasMessage(message)) continue;
+
+                expected.push_back(hooks[idx].hookId);
+                if(hooks[idx].action == XTestHook::eActionConsume)
+                {
+                    expectedConsumed = true;
+                    break;
+                }
+            }
+
+            bool consumed = testDispatch(message);
+            if(consumed != expectedConsumed || g_hookCalls != expected) valid = false;
+        }
+
+        sXWUIClearMessageHooks();
+
+        if(!valid && failures++ < 10) printf("set %d: hook calls differ\n", setIdx);
+    }
+
+    XWTEST_CHECK(failures == 0);
+
+    printf("random filters: %d hook sets checked\n", TEST_RANDOM_SETS);
+}
+
+static void testRemoveWhileDispatching()
+{
+    XTestHook hook1(1);
+    XTestHook hook2(2);
+    XTestHook hook3(3);
+    XTestHook hook4(4);
+
+    sXWUIAddMessageHook(&hook1);
+    sXWUIAddMessageHook(&hook2);
+    sXWUIAddMessageHook(&hook3);
+
+    // hook removes hook called after it, removed hook is skipped at once
+    hook3.action = XTestHook::eActionRemoveHook;
+    hook3.target = 1;
+    testDispatch(0x10);
+    XWTEST_CHECK(testCalls(3, 2));
+    testDispatch(0x10);
+    XWTEST_CHECK(testCalls(3, 2));
+
+    // hook removes itself
+    hook3.target = 3;
+    testDispatch(0x10);
+    XWTEST_CHECK(testCalls(3, 2));
+    testDispatch(0x10);
+    XWTEST_CHECK(testCalls(2));
+
+    // hook added while dispatching is called from next message
+    hook2.action = XTestHook::eActionAddHook;
+    hook2.targetHook = &hook4;
+    testDispatch(0x10);
+    XWTEST_CHECK(testCalls(2));
+    hook2.action = XTestHook::eActionNone;
+    testDispatch(0x10);
+    XWTEST_CHECK(testCalls(4, 2));
+
+    sXWUIClearMessageHooks();
+}
+
+static void testClearWhileNested()
+{
+    size_t heapBlocks = xwtestHeapBlocks();
+
+    XTestHook hook1(1);
+    XTestHook hook2(2);
+    XTestHook hook3(3);
+
+    sXWUIAddMessageHook(&hook1);
+    sXWUIAddMessageHook(&hook2, XWMessageHookFilter(0x20, 0x20));
+    sXWUIAddMessageHook(&hook3, XWMessageHookFilter(0x10, 0x10));
+
+    // hook 3 dispatches nested message, hook 2 clears hooks inside of it
+    hook3.action = XTestHook::eActionNested;
+    hook3.nestedMessage = 0x20;
+    hook2.action = XTestHook::eActionClear;
+
+    XWTEST_CHECK(!testDispatch(0x10));
+
+    // outer dispatch skips hook 1 removed by nested clear
+    XWTEST_CHECK(g_hookCalls.size() == 2 && g_hookCalls[0] == 3 && g_hookCalls[1] == 2);
+
+    // registry is freed once outer dispatch ends
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+
+    XWTEST_CHECK(!testDispatch(0x10));
+    XWTEST_CHECK(g_hookCalls.empty());
+
+    // hooks may be added again
+    hook2.action = XTestHook::eActionNone;
+    sXWUIAddMessageHook(&hook2);
+    testDispatch(0x10);
+    XWTEST_CHECK(testCalls(2));
+
+    sXWUIClearMessageHooks();
+}
+
+static void testRegistryFreed()
+{
+    size_t heapBlocks = xwtestHeapBlocks();
+
+    XTestHook hook1(1);
+    XTestHook hook2(2);
+
+    sXWUIAddMessageHook(&hook1, XWMessageHookFilter(0x100, 0x1FF));
+    sXWUIAddMessageHook(&hook2);
+    testDispatch(0x150);
+    XWTEST_CHECK(testInvocations(0x150) == 2);
+    XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+
+    // registry and statistics are freed with last hook
+    sXWUIRemoveMessageHook(1);
+    XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+    sXWUIRemoveMessageHook(2);
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+    XWTEST_CHECK(testInvocations(0x150) == 0);
+
+    // last hook removed by itself while dispatching
+    hook1.action = XTestHook::eActionRemoveHook;
+    hook1.target = 1;
+    sXWUIAddMessageHook(&hook1);
+    testDispatch(0x150);
+    XWTEST_CHECK(testCalls(1));
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+
+    // removing unknown hook without registry does nothing
+    sXWUIRemoveMessageHook(5);
+    XWTEST_CHECK(!testDispatch(0x150));
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    testFilter();
+    testHookLists();
+    testDefaultList();
+    testRandomFilters();
+    testRemoveWhileDispatching();
+    testClearWhileNested();
+    testRegistryFreed();
+
+    return xwtestResult("xwmessagehook_test");
+}
@@ -0,0 +1,113 @@
+// Object pool benchmarks (graphics item tree construction and teardown with and without pool)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwheadless.h"
+
+// NOTE: tree is same form of rows as in xwheadless_bench.cpp. Heap blocks are
+//       counted by xwtestheap.cpp, with pool most of item and node memory comes
+//       from pool chunks (shown as pool blocks). Teardown deletes root item, or
+//       deletes all rows at once with deleteAllChildItems (bulk path).
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define BENCH_COLUMNS           10
+#define BENCH_REPEATS           5
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+static XHeadlessItem* createTree(int rowCount)
+{
+    XHeadlessItem* root = new XHeadlessItem;
+    XVBoxLayout* rootLayout = new XVBoxLayout;
+
+    for(int row = 0; row < rowCount; ++row)
+    {
+        XHeadlessItem* rowItem = new XHeadlessItem(root);
+        XHBoxLayout* rowLayout = new XHBoxLayout;
+
+        for(int column = 0; column < BENCH_COLUMNS; ++column)
+        {
+            XHeadlessItem* leaf = new XHeadlessItem(rowItem);
+            leaf->setMinWidth(40);
+            leaf->setMinHeight(20);
+
+            rowLayout->addItem(leaf, 1);
+        }
+
+        rowItem->setLayout(rowLayout);
+        rootLayout->addItem(rowItem);
+    }
+
+    root->setLayout(rootLayout);
+
+    return root;
+}
+
+/////////////////////////////////////////////////////////////////////
+// benchmarks
+
+static void benchTree(int rowCount, bool usePool, bool bulkDelete)
+{
+    long long buildUs = 0;
+    long long deleteUs = 0;
+    size_t heapBlocks = 0;
+    unsigned long poolBlocks = 0;
+    size_t heapBefore = xwtestHeapBlocks();
+
+    for(int repeat = 0; repeat < BENCH_REPEATS; ++repeat)
+    {
+        XWObjectPool* pool = usePool ? new XWObjectPool : 0;
+        XHeadlessItem* root = 0;
+
+        // build (items, layouts and their nodes come from current pool)
+        XWTestTimer timer;
+        {
+            XWObjectPoolScope scope(pool);
+            root = createTree(rowCount);
+        }
+        buildUs += timer.elapsedUs();
+
+        heapBlocks = xwtestHeapBlocks() - heapBefore;
+        if(pool)
+        {
+            XWObjectPool::XPoolStats stats;
+            pool->getStats(stats);
+            poolBlocks = stats.blocksInUse;
+        }
+
+        // teardown (pool is released first, it goes with last block)
+        if(pool) pool->release();
+
+        timer.restart();
+        if(bulkDelete) root->deleteAllChildItems();
+        delete root;
+        deleteUs += timer.elapsedUs();
+    }
+
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBefore);
+
+    printf("%6d items, %-4s %-11s: build %7lld us, delete %7lld us, heap blocks %6lu, pool blocks %6lu\n",
+           1 + rowCount * (1 + BENCH_COLUMNS), usePool ? "pool" : "heap", bulkDelete ? "bulk delete" : "delete root",
+           buildUs / BENCH_REPEATS, deleteUs / BENCH_REPEATS, (unsigned long)heapBlocks, poolBlocks);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    int rowCounts[] = {10, 100, 500, 2000};
+
+    for(size_t idx = 0; idx < sizeof(rowCounts) / sizeof(rowCounts[0]); ++idx)
+    {
+        benchTree(rowCounts[idx], false, false);
+        benchTree(rowCounts[idx], true, false);
+        benchTree(rowCounts[idx], false, true);
+        benchTree(rowCounts[idx], true, true);
+    }
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+// Object pool tests (size classes, reference counting, objects outliving pool owner)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "core/xwcore_config.h"
+
+#include "xwtest.h"
+
+// NOTE: pool chunks and pool itself come from heap, so heap counter from
+//       xwtestheap.cpp shows when pool has been deleted. Freed memory has to be
+//       back in heap once last reference and last block are released, in any order.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+#define TEST_CLASS_STEP         16
+#define TEST_MAX_POOLED_SIZE    2048
+#define TEST_TREE_CHILDREN      200
+
+/////////////////////////////////////////////////////////////////////
+// helpers
+
+typedef std::list<int, XWPoolAllocator<int> >   XTestList;
+
+static unsigned long poolBlocksInUse(XWObjectPool* pool)
+{
+    XWObjectPool::XPoolStats stats;
+    pool->getStats(stats);
+
+    return stats.blocksInUse;
+}
+
+/////////////////////////////////////////////////////////////////////
+// tests
+
+static void testSizeClasses()
+{
+    size_t heapBlocks = xwtestHeapBlocks();
+    XWObjectPool* pool = new XWObjectPool;
+    XWObjectPool::XPoolStats stats;
+
+    // sizes of one class share free list (freed block is reused first)
+    void* block1 = pool->allocate(17);
+    pool->deallocate(block1, 17);
+    void* block2 = pool->allocate(TEST_CLASS_STEP * 2);
+    XWTEST_CHECK(block1 == block2);
+
+    // next class takes own chunk
+    void* block3 = pool->allocate(TEST_CLASS_STEP);
+    XWTEST_CHECK(block3 != block2);
+    pool->getStats(stats);
+    XWTEST_CHECK(stats.chunks == 2);
+    XWTEST_CHECK(stats.allocations == 3 && stats.frees == 1 && stats.blocksInUse == 2);
+
+    // blocks of class are aligned and don't overlap
+    char* blocks[100];
+    for(int idx = 0; idx < 100; ++idx)
+    {
+        blocks[idx] = (char*)pool->allocate(40);
+        XWTEST_CHECK(((uintptr_t)blocks[idx] % TEST_CLASS_STEP) == 0);
+        memset(blocks[idx], idx, 40);
+    }
+
+    for(int idx = 0; idx < 100; ++idx)
+    {
+        XWTEST_CHECK(blocks[idx][0] == (char)idx && blocks[idx][39] == (char)idx);
+        pool->deallocate(blocks[idx], 40);
+    }
+
+    // largest pooled size and blocks above it
+    void* pooled = pool->allocate(TEST_MAX_POOLED_SIZE);
+    void* large = pool->allocate(TEST_MAX_POOLED_SIZE + 1);
+    pool->getStats(stats);
+    XWTEST_CHECK(stats.heapAllocations == 1);
+    XWTEST_CHECK(stats.blocksInUse == 3);
+    XWTEST_CHECK(stats.peakBlocksInUse == 102);
+
+    pool->deallocate(large, TEST_MAX_POOLED_SIZE + 1);
+    pool->deallocate(pooled, TEST_MAX_POOLED_SIZE);
+    pool->deallocate(block3, TEST_CLASS_STEP);
+    pool->deallocate(block2, TEST_CLASS_STEP * 2);
+    XWTEST_CHECK(poolBlocksInUse(pool) == 0);
+
+    // chunks are freed with pool
+    pool->release();
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+}
+
+static void testRefCount()
+{
+    size_t heapBlocks = xwtestHeapBlocks();
+
+    // unused pool is deleted by last release
+    XWObjectPool* pool = new XWObjectPool;
+    pool->addRef();
+    pool->release();
+    XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+    pool->release();
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+
+    // pool is kept until last block is freed (pooled and large blocks)
+    pool = new XWObjectPool;
+    void* block = pool->allocate(64);
+    void* large = pool->allocate(TEST_MAX_POOLED_SIZE * 2);
+    pool->release();
+    XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+    pool->deallocate(block, 64);
+    XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+    pool->deallocate(large, TEST_MAX_POOLED_SIZE * 2);
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+
+    // scope keeps reference and restores previous pool
+    pool = new XWObjectPool;
+    {
+        XWObjectPoolScope scope(pool);
+        XWTEST_CHECK(XWObjectPool::current() == pool);
+
+        pool->release();
+        XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+    }
+    XWTEST_CHECK(XWObjectPool::current() == 0);
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+}
+
+static void testAllocatorReference()
+{
+    size_t heapBlocks = xwtestHeapBlocks();
+    XWObjectPool* pool = new XWObjectPool;
+
+    // empty container outlives pool owner and inserts later
+    XTestList* list = new XTestList(XWPoolAllocator<int>(pool));
+    pool->release();
+    for(int idx = 0; idx < 1000; ++idx) list->push_back(idx);
+    XWTEST_CHECK(poolBlocksInUse(pool) == 1000);
+
+    // copies and rebound allocators keep reference as well
+    XWPoolAllocator<int> copied(list->get_allocator());
+    XWPoolAllocator<double> rebound(copied);
+    XWPoolAllocator<int> assigned;
+    assigned = copied;
+    XWTEST_CHECK(assigned == list->get_allocator() && rebound == copied);
+
+    delete list;
+    XWTEST_CHECK(poolBlocksInUse(rebound.pool()) == 0);
+
+    // pool is deleted with last allocator
+    copied = XWPoolAllocator<int>();
+    assigned = copied;
+    XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+
+    double* value = rebound.allocate(1);
+    *value = 1.0;
+    rebound.deallocate(value, 1);
+    rebound = XWPoolAllocator<double>();
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+
+    // allocator without pool uses heap
+    XTestList heapList;
+    heapList.push_back(1);
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks + 1);
+}
+
+static void testObjectsOutlivePool()
+{
+    size_t heapBlocks = xwtestHeapBlocks();
+    XWObjectPool* pool = new XWObjectPool;
+    XWObject* root = 0;
+
+    // object tree and its nodes are allocated from pool
+    {
+        XWObjectPoolScope scope(pool);
+
+        root = new XWObject;
+        for(int idx = 0; idx < TEST_TREE_CHILDREN; ++idx)
+        {
+            XWObject* child = new XWObject(root);
+            new XWObject(child);
+        }
+    }
+
+    // objects + child list nodes
+    XWTEST_CHECK(poolBlocksInUse(pool) == (1 + TEST_TREE_CHILDREN * 2) + TEST_TREE_CHILDREN * 2);
+
+    // owner releases pool first, tree is deleted later (e.g. by XWObject destructor)
+    pool->release();
+    XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+
+    delete root;
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+
+    // objects allocated without pool use heap
+    XWObjectPool::XPoolStats before;
+    XWObjectPool::XPoolStats after;
+    XWObjectPool::getHeapStats(before);
+
+    XWObject* heapObject = new XWObject;
+    delete heapObject;
+
+    XWObjectPool::getHeapStats(after);
+    XWTEST_CHECK(after.allocations == before.allocations + 1 && after.frees == before.frees + 1);
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+}
+
+static void testObjectMovedFromPool()
+{
+    size_t heapBlocks = xwtestHeapBlocks();
+    XWObjectPool* pool = new XWObjectPool;
+    XWObject* heapParent = new XWObject;
+    XWObject* pooledChild = 0;
+
+    // pooled object is moved under heap object, then pool owner goes away
+    {
+        XWObjectPoolScope scope(pool);
+        pooledChild = new XWObject;
+        new XWObject(pooledChild);
+    }
+
+    pooledChild->setParentObject(heapParent);
+    pool->release();
+    XWTEST_CHECK(xwtestHeapBlocks() > heapBlocks);
+
+    // memory is returned to pool it comes from, pool goes with it
+    delete heapParent;
+    XWTEST_CHECK(xwtestHeapBlocks() == heapBlocks);
+}
+
+/////////////////////////////////////////////////////////////////////
+// main
+
+int main()
+{
+    testSizeClasses();
+    testRefCount();
+    testAllocatorReference();
+    testObjectsOutlivePool();
+    testObjectMovedFromPool();
+
+    return xwtestResult("xwobjectpool_test");
+}
@@ -0,0 +1,114 @@
+// Helpers for headless core tests and benchmarks
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWTEST_H_
+#define _XWTEST_H_
+
+// NOTE: tests are plain programs built by build.sh, they return non-zero exit code
+//       if any check fails. Benchmarks only print results, numbers depend on machine.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+/////////////////////////////////////////////////////////////////////
+// checks
+
+// check condition, failure is reported but test continues
+#define XWTEST_CHECK(expr)              _xwtestCheck((expr), #expr, __FILE__, __LINE__)
+
+// check that two floats are close enough
+#define XWTEST_CHECK_NEAR(a, b, eps)    _xwtestCheck(fabs((double)(a) - (double)(b)) <= (eps), #a " ~ " #b, __FILE__, __LINE__)
+
+inline int& _xwtestFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline bool _xwtestCheck(bool result, const char* expr, const char* file, int line)
+{
+    // report and count failure
+    if(!result)
+    {
+        fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expr);
+        _xwtestFailures()++;
+    }
+
+    return result;
+}
+
+// print test result and return exit code
+inline int xwtestResult(const char* testName)
+{
+    if(_xwtestFailures())
+    {
+        printf("%s: FAILED (%d checks)\n", testName, _xwtestFailures());
+        return 1;
+    }
+
+    printf("%s: OK\n", testName);
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// XWTestTimer - wall clock timer
+
+class XWTestTimer
+{
+public: // construction/destruction
+    XWTestTimer() { restart(); }
+
+public: // interface
+    void        restart()   { m_start = std::chrono::steady_clock::now(); }
+    long long   elapsedUs() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private: // data
+    std::chrono::steady_clock::time_point  m_start;
+};
+
+// XWTestTimer
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+// heap counter (global operator new and delete from xwtestheap.cpp, link it to use)
+
+// requested bytes and blocks allocated and not freed yet
+size_t  xwtestHeapBytes();
+size_t  xwtestHeapBlocks();
+
+/////////////////////////////////////////////////////////////////////
+// XWTestRandom - deterministic random numbers (xorshift), runs are reproducible
+
+class XWTestRandom
+{
+public: // construction/destruction
+    XWTestRandom(unsigned long long seed) : m_state(seed ? seed : 1) {}
+
+public: // interface
+    unsigned int    next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return (unsigned int)(m_state >> 32);
+    }
+
+    // value in [minValue, maxValue] range
+    int     range(int minValue, int maxValue)   { return minValue + (int)(next() % (unsigned int)(maxValue - minValue + 1)); }
+    bool    chance(int percent)                 { return (int)(next() % 100) < percent; }
+
+private: // data
+    unsigned long long  m_state;
+};
+
+// XWTestRandom
+/////////////////////////////////////////////////////////////////////
+
+#endif // _XWTEST_H_
+
@@ -0,0 +1,73 @@
+// Heap counter for tests and benchmarks (replaces global operator new and delete)
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "xwtest.h"
+
+#include <new>
+
+// NOTE: kept in separate file, so that replaced operators are not inlined into
+//       allocating code. Counters are not thread safe, use from one thread only.
+
+/////////////////////////////////////////////////////////////////////
+// constants
+
+// block size is kept in front of block (aligned for any type)
+#define XWTEST_HEAP_HEADER      16
+
+/////////////////////////////////////////////////////////////////////
+// counters
+
+static size_t g_heapBytes = 0;
+static size_t g_heapBlocks = 0;
+
+size_t xwtestHeapBytes()    { return g_heapBytes; }
+size_t xwtestHeapBlocks()   { return g_heapBlocks; }
+
+/////////////////////////////////////////////////////////////////////
+// operators
+
+void* operator new(size_t size)
+{
+    char* block = (char*)malloc(size + XWTEST_HEAP_HEADER);
+    if(block == 0) throw std::bad_alloc();
+
+    // keep size and count block
+    *(size_t*)block = size;
+    g_heapBytes += size;
+    g_heapBlocks++;
+
+    return block + XWTEST_HEAP_HEADER;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if(ptr == 0) return;
+
+    // release counted block
+    char* block = (char*)ptr - XWTEST_HEAP_HEADER;
+    g_heapBytes -= *(size_t*)block;
+    g_heapBlocks--;
+
+    free(block);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t size) noexcept
+{
+    operator delete(ptr);
+}
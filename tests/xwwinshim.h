@@ -0,0 +1,204 @@
+// Minimal Win32 types for building window message code without Windows headers
+//
+/////////////////////////////////////////////////////////////////////
+
+#ifndef _XWWINSHIM_H_
+#define _XWWINSHIM_H_
+
+// NOTE: header is force included (see build.sh) before sources that include
+//       xwui_config.h. Its include guard is defined here, so Windows, Direct2D and
+//       style headers are skipped and only types and message ids below are used.
+//       Only what event map, message hooks, grid column store, damage region and
+//       graphics item need is declared.
+
+// NOTE: graphics item includes xwgraphics.h for GDI helpers, it is skipped as well.
+//       Rectangle and GDI helpers declared below are implemented by tests (see
+//       xwheadless.cpp), painting device there is headless painter.
+
+#define _XWUI_CONFIG_H_
+#define _XGRAPHICS_H_
+
+#include <stdint.h>
+#include <wchar.h>
+
+#include "core/xwcore_config.h"
+
+/////////////////////////////////////////////////////////////////////
+// types
+
+struct HWND__ { int unused; };
+struct HBITMAP__ { int unused; };
+struct HCURSOR__ { int unused; };
+struct HDC__ { int unused; };
+struct HRGN__ { int unused; };
+struct HMODULE__ { int unused; };
+
+typedef HWND__*         HWND;
+typedef HBITMAP__*      HBITMAP;
+typedef HCURSOR__*      HCURSOR;
+typedef HDC__*          HDC;
+typedef HRGN__*         HRGN;
+typedef HMODULE__*      HMODULE;
+typedef unsigned int    UINT;
+typedef unsigned short  WORD;
+typedef uintptr_t       WPARAM;
+typedef intptr_t        LPARAM;
+typedef intptr_t        LRESULT;
+typedef int32_t         LONG;
+typedef long long       LONGLONG;
+typedef int             BOOL;
+typedef unsigned long   DWORD;
+typedef DWORD           COLORREF;
+typedef wchar_t         WCHAR;
+
+#define TRUE                1
+#define FALSE               0
+
+// COM style interface keyword
+#define interface           struct
+
+struct RECT
+{
+    LONG    left;
+    LONG    top;
+    LONG    right;
+    LONG    bottom;
+};
+
+struct POINT
+{
+    LONG    x;
+    LONG    y;
+};
+
+struct MSG
+{
+    HWND    hwnd;
+    UINT    message;
+    WPARAM  wParam;
+    LPARAM  lParam;
+    DWORD   time;
+    POINT   pt;
+};
+
+/////////////////////////////////////////////////////////////////////
+// rectangles (same results as Win32 functions)
+
+inline BOOL SetRectEmpty(RECT* rect)
+{
+    rect->left = rect->top = rect->right = rect->bottom = 0;
+    return TRUE;
+}
+
+inline BOOL OffsetRect(RECT* rect, int offsetX, int offsetY)
+{
+    rect->left += offsetX;
+    rect->right += offsetX;
+    rect->top += offsetY;
+    rect->bottom += offsetY;
+    return TRUE;
+}
+
+inline BOOL IntersectRect(RECT* rectOut, const RECT* rect1, const RECT* rect2)
+{
+    RECT rect;
+    rect.left = (rect1->left > rect2->left) ? rect1->left : rect2->left;
+    rect.top = (rect1->top > rect2->top) ? rect1->top : rect2->top;
+    rect.right = (rect1->right < rect2->right) ? rect1->right : rect2->right;
+    rect.bottom = (rect1->bottom < rect2->bottom) ? rect1->bottom : rect2->bottom;
+
+    // empty result is reset
+    if(rect.right <= rect.left || rect.bottom <= rect.top)
+    {
+        SetRectEmpty(rectOut);
+        return FALSE;
+    }
+
+    *rectOut = rect;
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////
+// Direct2D (only passed by pointer or reference)
+
+struct ID2D1RenderTarget;
+struct ID2D1Brush;
+
+struct D2D1_COLOR_F
+{
+    float   r;
+    float   g;
+    float   b;
+    float   a;
+};
+
+/////////////////////////////////////////////////////////////////////
+// parameter words
+
+#define LOWORD(l)           ((WORD)(((uintptr_t)(l)) & 0xffff))
+#define HIWORD(l)           ((WORD)((((uintptr_t)(l)) >> 16) & 0xffff))
+#define MAKEWPARAM(l, h)    ((WPARAM)(uint32_t)(((WORD)(l)) | ((uint32_t)((WORD)(h))) << 16))
+#define MAKELPARAM(l, h)    ((LPARAM)(uint32_t)(((WORD)(l)) | ((uint32_t)((WORD)(h))) << 16))
+
+/////////////////////////////////////////////////////////////////////
+// window messages
+
+#define WM_SIZE             0x0005
+#define WM_PAINT            0x000F
+#define WM_ERASEBKGND       0x0014
+#define WM_SETCURSOR        0x0020
+#define WM_NOTIFY           0x004E
+#define WM_NCHITTEST        0x0084
+#define WM_KEYDOWN          0x0100
+#define WM_CHAR             0x0102
+#define WM_COMMAND          0x0111
+#define WM_TIMER            0x0113
+#define WM_MOUSEMOVE        0x0200
+#define WM_LBUTTONDOWN      0x0201
+#define WM_LBUTTONUP        0x0202
+#define WM_MOUSEWHEEL       0x020A
+#define WM_USER             0x0400
+
+/////////////////////////////////////////////////////////////////////
+// virtual keys
+
+#define VK_TAB              0x09
+
+/////////////////////////////////////////////////////////////////////
+// painter types (same as xwui_config.h)
+
+enum XWUIGraphicsPainter
+{
+    XWUI_PAINTER_AUTOMATIC = 0,     // select best available painter automatically
+    XWUI_PAINTER_GDI,               // use GDI painter
+    XWUI_PAINTER_D2D                // use Direct2D painter
+};
+
+XWUIGraphicsPainter sXWUIDefaultPainter();
+
+/////////////////////////////////////////////////////////////////////
+// utilities (same declarations as xwutils.h and xgdihelpres.h)
+
+class XGdiResourcesCache;
+
+namespace XWUtils
+{
+    bool        rectIsInside(const RECT& rect, int posX, int posY);
+    bool        rectOverlap(const RECT& rect1, const RECT& rect2);
+    bool        rectIntersect(const RECT& rect1, const RECT& rect2, RECT& rectOut);
+}
+
+namespace XGdiHelpers
+{
+    void        fillRect(HDC hdc, const RECT& rcPaint, COLORREF fillColor);
+}
+
+/////////////////////////////////////////////////////////////////////
+// core and style
+#include "core/xweventmap.h"
+#include "core/xwmessages.h"
+#include "core/xtextstyle.h"
+#include "core/xmediasource.h"
+#include "style/xwuistyle.h"
+
+#endif // _XWWINSHIM_H_